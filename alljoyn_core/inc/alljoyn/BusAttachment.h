@@ -319,6 +319,52 @@ class BusAttachment : public MessageReceiver {
      */
     QStatus CreateInterfacesFromXml(const char* xml);
 
+    /**
+     * Enable or disable the introspection cache. When enabled, proxy objects built from
+     * introspection XML that was already parsed for another proxy object, for example the XML
+     * returned by many devices running the same application, reuse the result of parsing it.
+     * ProxyBusObject::IntrospectRemoteObject() does not call a peer that sent the same About
+     * announcement as a peer whose object at the same path was introspected before.
+     * The cache is enabled by default.
+     *
+     * @param enable  true to enable the introspection cache, false to disable it.
+     */
+    void EnableIntrospectionCache(bool enable);
+
+    /**
+     * Get the number of times introspection XML was and was not found in the introspection cache.
+     *
+     * @param[out] hits    Number of times the XML was found in the cache.
+     * @param[out] misses  Number of times the XML was parsed.
+     */
+    void GetIntrospectionCacheStats(size_t& hits, size_t& misses) const;
+
+    /**
+     * Save the introspection cache to a file so it can be loaded by LoadIntrospectionCache()
+     * when the application is restarted.
+     *
+     * @param fileName  Name of the file to save the cache to.
+     *
+     * @return
+     *      - #ER_OK if the cache was saved.
+     *      - An error status otherwise.
+     */
+    QStatus SaveIntrospectionCache(const char* fileName) const;
+
+    /**
+     * Load an introspection cache saved by SaveIntrospectionCache(). The interfaces used by the
+     * cache are registered with the bus attachment. Cache entries that use an interface that is
+     * already registered with a different definition are not loaded.
+     *
+     * @param fileName  Name of the file to load the cache from.
+     *
+     * @return
+     *      - #ER_OK if the cache was loaded.
+     *      - #ER_INVALID_DATA if the file is not a saved introspection cache.
+     *      - An error status otherwise.
+     */
+    QStatus LoadIntrospectionCache(const char* fileName);
+
     /**
      * Returns the existing activated InterfaceDescriptions.
      *
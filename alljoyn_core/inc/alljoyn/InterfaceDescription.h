@@ -58,6 +58,7 @@ static const uint8_t MEMBER_ANNOTATE_SESSIONCAST      = 4; /**< Sessioncast anno
 static const uint8_t MEMBER_ANNOTATE_SESSIONLESS      = 8; /**< Sessionless annotate flag */
 static const uint8_t MEMBER_ANNOTATE_UNICAST          = 16; /**< Unicast annotate flag */
 static const uint8_t MEMBER_ANNOTATE_GLOBAL_BROADCAST = 32; /**< Global broadcast annotate flag */
+static const uint8_t MEMBER_ANNOTATE_ARG_VIEW         = 64; /**< Arguments are read with a MsgArgView flag (local only, not introspected) */
 // @}
 
 /**
@@ -129,6 +130,7 @@ class InterfaceDescription {
         bool isSessionlessSignal;                   /**< True if this is described as a sessionless signal */
         bool isUnicastSignal;                       /**< True if this is described as a unicast signal */
         bool isGlobalBroadcastSignal;               /**< True if this is described as a global broadcast signal */
+        bool isArgView;                             /**< True if the receiver reads the arguments with a MsgArgView */
         ArgumentAnnotations* argumentAnnotations;   /**< Map of argument annotations */
 
         /**
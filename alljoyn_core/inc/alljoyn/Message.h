@@ -30,9 +30,15 @@
 #include <qcc/ManagedObj.h>
 
 #include <alljoyn/MsgArg.h>
+#include <alljoyn/MsgArgView.h>
 #include <alljoyn/Session.h>
 #include <alljoyn/Status.h>
 
+namespace qcc {
+/** @internal Forward references */
+class Source;
+}
+
 namespace ajn {
 
 static const size_t ALLJOYN_MAX_NAME_LEN   =     255;  /*!<  The maximum length of certain bus names */
@@ -114,6 +120,21 @@ typedef enum {
     MESSAGE_COMPLETE
 }AllJoynMessageState;
 
+/**
+ * @internal
+ * Write position of a marshaled message that is being delivered to a remote endpoint. The
+ * position is kept outside of the message so that a single marshaled message can be queued
+ * on, and written by, several endpoints at the same time without being copied.
+ */
+struct MessageWriteCursor {
+    AllJoynMessageState state;  ///< The current state of the message during write.
+    const uint8_t* ptr;         ///< Pointer to the current write position in the buffer.
+    size_t count;               ///< Number of bytes remaining to write for completion of the message.
+
+    /** Constructor for a cursor positioned at the start of a message */
+    MessageWriteCursor() : state(MESSAGE_NEW), ptr(NULL), count(0) { }
+};
+
 
 /** AllJoyn header fields */
 class HeaderFields {
@@ -204,6 +225,7 @@ class _Message {
     friend class _PeerState;
     friend class PermissionMgmtObj;
     friend class _Manifest;
+    friend class HeaderDictionary;
     friend struct Rule;
 
   public:
@@ -292,7 +314,7 @@ class _Message {
      * @param[out] args  Returns the arguments
      * @param[out] numArgs The number of arguments
      */
-    void GetArgs(size_t& numArgs, const MsgArg*& args) { args = msgArgs; numArgs = numMsgArgs; }
+    void GetArgs(size_t& numArgs, const MsgArg*& args) { args = ParsedArgs(); numArgs = args ? numMsgArgs : 0; }
 
     /**
      * Return the reference arguments for this message.  These arguments are copied when the message is marshalled.
@@ -311,7 +333,11 @@ class _Message {
      *      - The argument
      *      - NULL if unmarshal failed or there is not such argument.
      */
-    const MsgArg* GetArg(size_t argN = 0) { return (argN < numMsgArgs) ? &msgArgs[argN] : NULL; }
+    const MsgArg* GetArg(size_t argN = 0)
+    {
+        const MsgArg* args = ParsedArgs();
+        return (args && (argN < numMsgArgs)) ? &args[argN] : NULL;
+    }
 
     /**
      * Unpack and return the arguments for this message. This method uses the functionality from
@@ -323,6 +349,22 @@ class _Message {
      */
     QStatus GetArgs(const char* signature, ...);
 
+    /**
+     * Get a read-only view of the arguments for this message. The view visits the values in the
+     * message buffer in place rather than through the MsgArgs returned by GetArgs(). The MsgArgs
+     * of method calls, signals and method replies for interface members added with the
+     * #MEMBER_ANNOTATE_ARG_VIEW flag are only built if GetArgs() is called, so reading such a
+     * message from a MessageReceiver handler or a method reply returned by
+     * ProxyBusObject::MethodCall() does not allocate. See MsgArgView.h for documentation.
+     *
+     * @param[out] view  Returns a view of the arguments.
+     *
+     * @return
+     *      - #ER_OK if successful.
+     *      - #ER_FAIL if the message arguments have not been unmarshaled.
+     */
+    QStatus GetArgView(MsgArgView& view) const;
+
     /**
      * Accessor function to get serial number for the message. Usually only important for
      * #MESSAGE_METHOD_CALL for matching up the reply to the call.
@@ -853,13 +895,16 @@ class _Message {
      * @param expectedSignature       The expected signature for this message.
      * @param expectedReplySignature  The expected reply signature for this message if it is a
      *                                method call message or NULL otherwise.
+     * @param deferArgs               If true the body is only checked and the MsgArgs are built
+     *                                the first time they are asked for.
      *
      * @return
      *         - #ER_OK if the message was unmarshaled
      *         - Error status indicating why the unmarshal failed.
      */
     QStatus UnmarshalArgs(const qcc::String& expectedSignature,
-                          const char* expectedReplySignature = NULL);
+                          const char* expectedReplySignature = NULL,
+                          bool deferArgs = false);
 
     /**
      * @internal
@@ -869,12 +914,15 @@ class _Message {
      * @param expectedSignature       The expected signature for this message.
      * @param expectedReplySignature  The expected reply signature for this message if it is a
      *                                method call message or NULL otherwise.
+     * @param deferArgs               If true the body is only checked and the MsgArgs are built
+     *                                the first time they are asked for.
      *
      * @return
      *         - #ER_OK if the message was unmarshaled
      *         - Error status indicating why the unmarshal failed.
      */
-    QStatus UnmarshalArgs(PeerStateTable* peerStateTable, const qcc::String& expectedSignature, const char* expectedReplySignature = NULL);
+    QStatus UnmarshalArgs(PeerStateTable* peerStateTable, const qcc::String& expectedSignature, const char* expectedReplySignature = NULL,
+                          bool deferArgs = false);
 
     /**
      * @internal
@@ -966,12 +1014,32 @@ class _Message {
      * @internal
      * Deliver a marshaled message to a remote endpoint. Non-blocking
      *
+     * The message itself is not modified by the delivery unless it must be encrypted so an
+     * unencrypted message can be delivered to several endpoints concurrently, each with its
+     * own write cursor.
+     *
      * @param endpoint   Endpoint to receive marshaled message.
+     * @param cursor     Write position of this message on the endpoint.
      * @return
      *      - #ER_OK if successful
      *      - An error status otherwise
      */
-    QStatus DeliverNonBlocking(RemoteEndpoint& endpoint);
+    QStatus DeliverNonBlocking(RemoteEndpoint& endpoint, MessageWriteCursor& cursor);
+
+    /**
+     * @internal
+     * Get the bytes of a marshaled message that remain to be written so they can be gathered
+     * into a single write with other queued messages. A message that has not started to be
+     * written is only returned if it can be sent as is, i.e. it carries no handles, does not
+     * need to be encrypted, and has no time to live. Other messages must be started with
+     * DeliverNonBlocking.
+     *
+     * @param cursor     Write position of this message on the endpoint.
+     * @param buf        [OUT] First byte that remains to be written.
+     * @param len        [OUT] Number of bytes that remain to be written.
+     * @return  true if the remaining bytes can be gathered, false otherwise.
+     */
+    bool GetUnwrittenBytes(const MessageWriteCursor& cursor, const uint8_t*& buf, size_t& len) const;
     /**
      * @internal
      * Marshal the message again with the new sender name if one was provided.
@@ -1125,6 +1193,8 @@ class _Message {
     uint64_t* msgBuf;            ///< Pointer to the current msg buffer (8 byte aligned pointer into _msgBuf).
     MsgArg* msgArgs;             ///< Pointer to the unmarshaled arguments.
     uint8_t numMsgArgs;          ///< Number of message args (signature cannot be longer than 255 chars).
+    bool argsDeferred;           ///< true if the body has been checked but msgArgs is built on first use.
+    bool argsEndianSwap;         ///< true if the unmarshaled body is not in the native byte order.
 
     MsgArg* refMsgArgs;             ///< Pointer to the copy of the marshalled arguments.
     uint8_t numRefMsgArgs;          ///< size of the copy of the marshalled arguments
@@ -1152,10 +1222,6 @@ class _Message {
     size_t countRead;               ///< Number of bytes remaining to read for completion of the message.
     size_t maxFds;                  ///< Store the number of max FDs for the endpoint, so it doesnt need to be calculated each time.
 
-    AllJoynMessageState writeState; ///< The current state of the message during write.
-    uint8_t* writePtr;              ///< Pointer to the current write position in the buffer.
-    size_t countWrite;              ///< Number of bytes remaining to write for completion of the message.
-
     /**
      * The header fields for this message. Which header fields are present depends on the message
      * type defined in the message header.
@@ -1200,11 +1266,28 @@ class _Message {
      */
     void ClearHeader();
 
+    /**
+     * Get the unmarshaled arguments building them first if they were deferred by UnmarshalArgs.
+     *
+     * @return The arguments or NULL if the arguments have not been unmarshaled.
+     */
+    const MsgArg* ParsedArgs() const { return (msgArgs || !argsDeferred) ? msgArgs : ParseDeferredArgs(); }
+
+    /**
+     * Build the arguments that were checked but not parsed by UnmarshalArgs. This does not take
+     * any lock, if several threads build the arguments at the same time the first one to finish
+     * wins and the others discard theirs.
+     *
+     * @return The arguments or NULL if they could not be parsed.
+     */
+    const MsgArg* ParseDeferredArgs() const;
+
     /**
      * Parse the MsgArg value from the AllJoyn Message
      *
      * @param[out] arg MsgArg that will hold the value from the AllJoyn Message
      * @param[in]  sigPtr the signature of the MsgArg
+     * @param[in,out] pos the position of the value in the message buffer
      * @param[in]  arrayElem true if the value being parsed is an array element
      *
      * @see Unmarshal
@@ -1217,13 +1300,14 @@ class _Message {
      *      - #ER_BUS_BAD_SIGNATURE signature does not match value type
      *      - An error status otherwise
      */
-    QStatus ParseValue(MsgArg* arg, const char*& sigPtr, bool arrayElem = false);
+    QStatus ParseValue(MsgArg* arg, const char*& sigPtr, uint8_t*& pos, bool arrayElem = false) const;
 
     /**
      * Parse a Struct from the AllJoyn Message
      *
      * @param[out] arg MsgArg that will hold the value from the AllJoyn Message
      * @param[in]  sigPtr the signature of the MsgArg
+     * @param[in,out] pos the position of the value in the message buffer
      *
      * @see Unmarshal
      * @see UnmarshalArgs
@@ -1233,13 +1317,14 @@ class _Message {
      *      - #ER_BUS_BAD_SIGNATURE signature does not match value type
      *      - An error status otherwise
      */
-    QStatus ParseStruct(MsgArg* arg, const char*& sigPtr);
+    QStatus ParseStruct(MsgArg* arg, const char*& sigPtr, uint8_t*& pos) const;
 
     /**
      * Parse a single dictionary entry from the AllJoyn Message
      *
      * @param[out] arg MsgArg that will hold the value from the AllJoyn Message
      * @param[in]  sigPtr the signature of the MsgArg
+     * @param[in,out] pos the position of the value in the message buffer
      *
      * @see Unmarshal
      * @see UnmarshalArgs
@@ -1249,13 +1334,14 @@ class _Message {
      *      - #ER_BUS_BAD_SIGNATURE signature does not match value type
      *      - An error status otherwise
      */
-    QStatus ParseDictEntry(MsgArg* arg, const char*& sigPtr);
+    QStatus ParseDictEntry(MsgArg* arg, const char*& sigPtr, uint8_t*& pos) const;
 
     /**
      * Parse an array from the AllJoyn Message
      *
      * @param[out] arg MsgArg that will hold the value from the AllJoyn Message
      * @param[in]  sigPtr the signature of the MsgArg
+     * @param[in,out] pos the position of the value in the message buffer
      *
      * @see Unmarshal
      * @see UnmarshalArgs
@@ -1265,23 +1351,25 @@ class _Message {
      *      - #ER_BUS_BAD_SIGNATURE signature does not match value type
      *      - An error status otherwise
      */
-    QStatus ParseArray(MsgArg* arg, const char*& sigPtr);
+    QStatus ParseArray(MsgArg* arg, const char*& sigPtr, uint8_t*& pos) const;
 
     /**
      * Parse the MsgArg signature from the AllJoyn Message
      *
      * @param[out] arg assign the message arg signature to this MsgArg
+     * @param[in,out] pos the position of the signature in the message buffer
      *
      * @return
      *      - #ER_OK if successful
      *      - An error status otherwise
      */
-    QStatus ParseSignature(MsgArg* arg);
+    QStatus ParseSignature(MsgArg* arg, uint8_t*& pos) const;
 
     /**
      * Parse a variant MsgArg from an AllJoyn Message
      *
      * @param[out] arg assign the variant to this MsgArg
+     * @param[in,out] pos the position of the variant in the message buffer
      *
      * @see Unmarshal
      * @see UnmarshalArgs
@@ -1290,7 +1378,7 @@ class _Message {
      *      - #ER_OK if successful
      *      - An error status otherwise
      */
-    QStatus ParseVariant(MsgArg* arg);
+    QStatus ParseVariant(MsgArg* arg, uint8_t*& pos) const;
 
     /**
      * Check that the header fields are valid. This check is automatically performed when a header
@@ -1416,13 +1504,18 @@ class _Message {
      *    - #ER_BUS_BAD_HEADER_FIELD if the Message header has invalid endian flag
      *    - #ER_BUS_BAD_HEADER_LEN if the Message header length is invalid
      *    - #ER_BUS_BAD_BODY_LEN if the Message body length is invalid
+     *
+     * @param adopted       If not NULL, a buffer from AllocAdoptableBuffer() to
+     *                      use as the message buffer instead of allocating one.
+     * @param adoptedSize   The usable size of the adopted buffer.
      */
-    inline QStatus InterpretHeader();
+    inline QStatus InterpretHeader(uint8_t* adopted = NULL, size_t adoptedSize = 0);
 
     /**
      * Read a Message from a RemoteEndpoint
      *
      * @param endpoint      The endpoint the message will be read from
+     * @param source        The source to pull the bytes from
      * @param checkSender   True if message's sender field should be validated
      *                      against the endpoint's unique name.
      * @param pedantic      Perform detailed checks on the header fields.
@@ -1436,7 +1529,7 @@ class _Message {
      *      - #ER_OK if successful
      *      - An error status otherwise
      */
-    QStatus PullBytes(RemoteEndpoint& endpoint, bool checkSender, bool pedantic = true, uint32_t timeout = 0);
+    QStatus PullBytes(RemoteEndpoint& endpoint, qcc::Source& source, bool checkSender, bool pedantic = true, uint32_t timeout = 0);
 
     /**
      * Load a Message from a Buffer
@@ -1450,6 +1543,32 @@ class _Message {
      */
     QStatus LoadBytes(uint8_t* buf, size_t buflen);
 
+    /**
+     * Allocate a buffer that a Message can take over with AdoptBytes().  This
+     * lets a transport that reassembles a message from fragments copy them
+     * straight into the buffer the message will be unmarshaled from.
+     *
+     * @param buflen     The length of the message data.
+     * @param[out] data  Where the buflen bytes of message data must be written.
+     *
+     * @return  The buffer, to be passed to AdoptBytes() or freed with delete[].
+     */
+    static uint8_t* AllocAdoptableBuffer(size_t buflen, uint8_t*& data);
+
+    /**
+     * Load a Message from a buffer allocated by AllocAdoptableBuffer() without
+     * copying the data.  The message takes ownership of the buffer whether or
+     * not this succeeds.
+     *
+     * @param buf     The buffer returned by AllocAdoptableBuffer().
+     * @param buflen  The length of the message data in the buffer.
+     *
+     * @return
+     *      - #ER_OK if successful
+     *      - An error status otherwise
+     */
+    QStatus AdoptBytes(uint8_t* buf, size_t buflen);
+
     /// @}
     // end internal_methods_message_read
 
@@ -0,0 +1,259 @@
+#ifndef _ALLJOYN_MSGARGVIEW_H
+#define _ALLJOYN_MSGARGVIEW_H
+/**
+ * @file
+ * This file defines a read-only view of marshaled message arguments
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#error Only include MsgArgView.h in C++ code.
+#endif
+
+#include <qcc/platform.h>
+#include <alljoyn/MsgArg.h>
+#include <alljoyn/Status.h>
+
+namespace ajn {
+
+/**
+ * Forward definitions
+ */
+class _Message;
+
+/**
+ * A %MsgArgView iterates over the values of a marshaled message body in place. Unlike the MsgArg
+ * tree returned by Message::GetArgs() a view never allocates memory: strings, object paths,
+ * signatures and arrays of scalars are returned as pointers into the message buffer, and arrays,
+ * structs, dictionary entries and variants are visited with a sub-view obtained by calling
+ * Recurse().
+ *
+ * The values are visited in signature order. Each Get method checks that the type of the current
+ * value matches and advances the view to the next value if it does. For example a message handler
+ * receiving an @c a{sv} property dictionary could be written as:
+ *
+ * @code
+ * MsgArgView args, dict;
+ * msg->GetArgView(args);
+ * args.Recurse(dict);
+ * while (!dict.AtEnd()) {
+ *     MsgArgView entry, val;
+ *     const char* name;
+ *     dict.Recurse(entry);
+ *     entry.GetString(name);
+ *     entry.Recurse(val);
+ *     ...
+ * }
+ * @endcode
+ *
+ * A view refers to the message buffer so it must not be used after the message has been destroyed.
+ */
+class MsgArgView {
+    friend class _Message;
+
+  public:
+
+    /**
+     * Constructor for a view that has no values.
+     */
+    MsgArgView();
+
+    /**
+     * Constructor for a view of a marshaled message body. The values in the body are checked as
+     * they are visited.
+     *
+     * @param signature   The signature of the values in the body.
+     * @param body        The marshaled body. This must be 8 byte aligned.
+     * @param bodyLen     The length of the marshaled body.
+     * @param endianSwap  true if the body is not in the native byte order.
+     * @param handles     The handles referenced by handle values in the body.
+     * @param numHandles  The number of entries in handles.
+     */
+    MsgArgView(const char* signature, const void* body, size_t bodyLen, bool endianSwap = false,
+               const qcc::SocketFd* handles = NULL, size_t numHandles = 0);
+
+    /**
+     * Test if all of the values in the view have been visited.
+     *
+     * @return true if there are no more values in the view.
+     */
+    bool AtEnd() const;
+
+    /**
+     * Get the type of the current value. Arrays of scalars are reported with the same type ids as
+     * MsgArg uses, for example #ALLJOYN_INT32_ARRAY for an array of 32 bit integers.
+     *
+     * @return The type of the current value or #ALLJOYN_INVALID if the view is at the end.
+     */
+    AllJoynTypeId GetTypeId() const;
+
+    /**
+     * Skip over the current value.
+     *
+     * @return
+     *      - #ER_OK if the view was advanced to the next value.
+     *      - #ER_BUS_SIGNATURE_MISMATCH if the view is at the end.
+     *      - An error status if the current value is not valid.
+     */
+    QStatus Next();
+
+    /**
+     * Get a sub-view of the current array, struct, dictionary entry or variant value and advance
+     * this view to the next value. The sub-view visits the elements of an array, the members of a
+     * struct or dictionary entry, or the single value of a variant.
+     *
+     * @param[out] sub  Returns the sub-view.
+     *
+     * @return
+     *      - #ER_OK if successful.
+     *      - #ER_BUS_SIGNATURE_MISMATCH if the current value is not a container.
+     *      - An error status if the current value is not valid.
+     */
+    QStatus Recurse(MsgArgView& sub);
+
+    /**
+     * @name Basic values
+     * Get the current value and advance to the next value.
+     *
+     * @param[out] val  Returns the value.
+     *
+     * @return
+     *      - #ER_OK if successful.
+     *      - #ER_BUS_SIGNATURE_MISMATCH if the current value has a different type.
+     *      - An error status if the current value is not valid.
+     * @{
+     */
+    QStatus GetByte(uint8_t& val);
+    QStatus GetBool(bool& val);
+    QStatus GetInt16(int16_t& val);
+    QStatus GetUint16(uint16_t& val);
+    QStatus GetInt32(int32_t& val);
+    QStatus GetUint32(uint32_t& val);
+    QStatus GetInt64(int64_t& val);
+    QStatus GetUint64(uint64_t& val);
+    QStatus GetDouble(double& val);
+    QStatus GetHandle(qcc::SocketFd& val);
+    /** @} */
+
+    /**
+     * @name String values
+     * Get the current string, object path or signature value and advance to the next value. The
+     * returned string points into the message buffer and is NUL terminated.
+     *
+     * @param[out] str  Returns the string.
+     * @param[out] len  If not NULL returns the length of the string.
+     *
+     * @return
+     *      - #ER_OK if successful.
+     *      - #ER_BUS_SIGNATURE_MISMATCH if the current value has a different type.
+     *      - An error status if the current value is not valid.
+     * @{
+     */
+    QStatus GetString(const char*& str, size_t* len = NULL);
+    QStatus GetObjectPath(const char*& str, size_t* len = NULL);
+    QStatus GetSignature(const char*& str, size_t* len = NULL);
+    /** @} */
+
+    /**
+     * @name Arrays of scalars
+     * Get the current array of scalars and advance to the next value. The returned elements point
+     * into the message buffer. Arrays of booleans have a different representation on the wire and
+     * must be visited with Recurse().
+     *
+     * @param[out] elements     Returns the array elements.
+     * @param[out] numElements  Returns the number of elements in the array.
+     *
+     * @return
+     *      - #ER_OK if successful.
+     *      - #ER_BUS_SIGNATURE_MISMATCH if the current value has a different type.
+     *      - #ER_NOT_IMPLEMENTED if the elements are not in the native byte order. Use Recurse()
+     *        to visit the elements instead.
+     *      - An error status if the current value is not valid.
+     * @{
+     */
+    QStatus GetArray(const uint8_t*& elements, size_t& numElements);
+    QStatus GetArray(const int16_t*& elements, size_t& numElements);
+    QStatus GetArray(const uint16_t*& elements, size_t& numElements);
+    QStatus GetArray(const int32_t*& elements, size_t& numElements);
+    QStatus GetArray(const uint32_t*& elements, size_t& numElements);
+    QStatus GetArray(const int64_t*& elements, size_t& numElements);
+    QStatus GetArray(const uint64_t*& elements, size_t& numElements);
+    QStatus GetArray(const double*& elements, size_t& numElements);
+    /** @} */
+
+  private:
+
+    /**
+     * Check and skip over a value.
+     *
+     * @param sigPtr      The signature of the value, advanced past the value on success.
+     * @param pos         The position of the value, advanced past the value on success.
+     * @param limit       End of the data containing the value.
+     * @param arrayElem   true if the value is an array element.
+     * @param sigChecked  true if container signatures have already been checked.
+     */
+    QStatus Skip(const char*& sigPtr, const uint8_t*& pos, const uint8_t* limit, bool arrayElem, bool sigChecked) const;
+
+    /**
+     * Get the position of the current value if it has the expected type and advance the view.
+     */
+    QStatus GetValue(char typeId, size_t alignment, const uint8_t*& val);
+
+    /**
+     * Get the elements of the current array of scalars and advance the view.
+     */
+    QStatus GetScalarArray(char elemTypeId, size_t elemSize, const void*& elements, size_t& numElements);
+
+    /**
+     * Get a string, object path or signature and advance the view.
+     */
+    QStatus GetStringValue(char typeId, const char*& str, size_t* len);
+
+    /**
+     * Move the view to the value that follows the current value.
+     */
+    void Advance(const char* nextSig, const uint8_t* nextPos)
+    {
+        if (!inArray) {
+            sig = nextSig;
+        }
+        pos = nextPos;
+    }
+
+    /**
+     * Round a position up to an alignment boundary relative to the start of the body.
+     */
+    const uint8_t* Align(const uint8_t* p, size_t alignment) const
+    {
+        return base + (((p - base) + alignment - 1) & ~(alignment - 1));
+    }
+
+    const char* sig;                ///< Signature of the current value
+    const uint8_t* base;            ///< Start of the marshaled body, used for alignment
+    const uint8_t* pos;             ///< Position of the current value
+    const uint8_t* end;             ///< End of the data visited by this view
+    const qcc::SocketFd* handles;   ///< Handles referenced by the body
+    size_t numHandles;              ///< Number of handles
+    bool endianSwap;                ///< true if the body is not in the native byte order
+    bool inArray;                   ///< true if this view visits array elements
+    bool sigChecked;                ///< true if container signatures have been checked
+};
+
+}
+
+#endif
@@ -961,6 +961,28 @@ class ProxyBusObject : public MessageReceiver {
      */
     void SyncReplyHandler(Message& msg, void* context);
 
+    /**
+     * @internal
+     * Build this proxy object from the introspection cache if the peer
+     * announced the same application as a peer introspected before.
+     *
+     * @return true if the proxy object was built from the cache.
+     */
+    bool IntrospectFromCache();
+
+    /**
+     * @internal
+     * Parse the introspection XML returned by a peer and record it in the
+     * introspection cache as the XML of this object of the peer.
+     *
+     * @param xml     The introspection XML.
+     * @param sender  Unique name of the peer.
+     * @param ident   Identifying string to include in error logging messages.
+     *
+     * @return ER_OK if parsing is completely successful, an error status otherwise.
+     */
+    QStatus ParseIntrospection(const char* xml, const qcc::String& sender, const char* ident);
+
     /**
      * @internal
      * Introspection method_reply handler. (Internal use only)
@@ -34,6 +34,7 @@
 #include "AllJoynDebugObj.h"
 #include "Bus.h"
 #include "BusController.h"
+#include "DaemonRouter.h"
 
 using namespace ajn;
 using namespace debug;
@@ -141,6 +142,17 @@ exit:
 
 QStatus AllJoynDebugObj::Get(const char* ifcName, const char* propName, MsgArg& val)
 {
+    if (strcmp(ifcName, org::alljoyn::Daemon::Debug::InterfaceName) == 0) {
+        uint64_t txSaved;
+        uint64_t rxSaved;
+        reinterpret_cast<DaemonRouter&>(busController->GetBus().GetInternal().GetRouter()).GetHeaderCompressionStats(txSaved, rxSaved);
+        if (strcmp(propName, "TxHeaderBytesSaved") == 0) {
+            return val.Set("t", txSaved);
+        } else if (strcmp(propName, "RxHeaderBytesSaved") == 0) {
+            return val.Set("t", rxSaved);
+        }
+        return ER_BUS_NO_SUCH_PROPERTY;
+    }
     PropertyStore::const_iterator it = properties.find(ifcName);
     if (it == properties.end()) {
         return ER_BUS_NO_SUCH_PROPERTY;
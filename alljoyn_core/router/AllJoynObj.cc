@@ -3805,6 +3805,9 @@ void AllJoynObj::ProcFindAdvertisement(QStatus status, Message& msg, const qcc::
                  * the calls to the transports are complete.
                  */
                 discoverMap.insert(std::make_pair(matchingStr, DiscoverMapEntry(transports, sender, matching, namePrefix == matching.end())));
+                if (namePrefix != matching.end()) {
+                    discoverNames.Insert(namePrefix->second, matchingStr);
+                }
             }
         } else {
             replyCode = ALLJOYN_FINDADVERTISEDNAME_REPLY_TRANSPORT_NOT_AVAILABLE;
@@ -3979,6 +3982,10 @@ QStatus AllJoynObj::ProcCancelFindAdvertisement(const qcc::String& sender, const
             origMask = it->second.transportMask;
             it->second.transportMask &= ~transports;
             if (it->second.transportMask == 0) {
+                MatchMap::const_iterator namePrefix = it->second.matching.find("name");
+                if (namePrefix != it->second.matching.end()) {
+                    discoverNames.Erase(namePrefix->second, matchingStr);
+                }
                 discoverMap.erase(it++);
                 continue;
             }
@@ -5139,8 +5146,11 @@ void AllJoynObj::FoundNames(const qcc::String& busAddr,
                     }
                     /* Send FoundAdvertisedName to anyone who is discovering *nit */
                     if (sendSignal) {
-                        if (0 < discoverMap.size()) {
-                            for (DiscoverMapType::const_iterator dit = discoverMap.begin(); dit != discoverMap.end(); ++dit) {
+                        set<String> matchingStrs;
+                        discoverNames.MatchName(*nit, matchingStrs);
+                        for (set<String>::const_iterator mit = matchingStrs.begin(); mit != matchingStrs.end(); ++mit) {
+                            DiscoverMapType::const_iterator dit = discoverMap.lower_bound(*mit);
+                            for (; (dit != discoverMap.end()) && (dit->first == *mit); ++dit) {
                                 MatchMap::const_iterator namePrefix = dit->second.matching.find("name");
                                 if (namePrefix == dit->second.matching.end()) {
                                     continue;
@@ -5150,7 +5160,7 @@ void AllJoynObj::FoundNames(const qcc::String& busAddr,
                                     continue;
                                 }
 
-                                if (!WildcardMatch(*nit, namePrefix->second) && (transport & dit->second.transportMask)) {
+                                if (transport & dit->second.transportMask) {
                                     foundNameSet.insert(FoundNameEntry(*nit, namePrefix->second, dit->second.sender));
                                 }
                             }
@@ -5314,13 +5324,16 @@ QStatus AllJoynObj::SendLostAdvertisedName(const String& name, TransportMask tra
     /* Send LostAdvertisedName to anyone who is discovering name */
     AcquireLocks();
     vector<pair<String, String> > sigVec;
-    if (0 < discoverMap.size()) {
-        for (DiscoverMapType::const_iterator dit = discoverMap.begin(); dit != discoverMap.end(); ++dit) {
+    set<String> matchingStrs;
+    discoverNames.MatchName(name, matchingStrs);
+    for (set<String>::const_iterator mit = matchingStrs.begin(); mit != matchingStrs.end(); ++mit) {
+        DiscoverMapType::const_iterator dit = discoverMap.lower_bound(*mit);
+        for (; (dit != discoverMap.end()) && (dit->first == *mit); ++dit) {
             MatchMap::const_iterator namePrefix = dit->second.matching.find("name");
             if (namePrefix == dit->second.matching.end()) {
                 continue;
             }
-            if (!WildcardMatch(name, namePrefix->second) && (dit->second.transportMask & transport)) {
+            if (dit->second.transportMask & transport) {
                 sigVec.push_back(pair<String, String>(namePrefix->second, dit->second.sender));
             }
         }
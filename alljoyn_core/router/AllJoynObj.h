@@ -44,6 +44,7 @@
 #include "RemoteEndpoint.h"
 #include "Transport.h"
 #include "VirtualEndpoint.h"
+#include "WildcardTrie.h"
 #include "PermissionMgr.h"
 #include "ns/IpNameService.h"
 
@@ -828,6 +829,9 @@ class AllJoynObj : public BusObject, public NameListener, public TransportListen
     typedef std::multimap<qcc::String, DiscoverMapEntry> DiscoverMapType;
     DiscoverMapType discoverMap;
 
+    /** Name prefixes of the discoverMap entries, each mapped to the key of its entry */
+    WildcardTrie<qcc::String> discoverNames;
+
     /** Map of discovered bus names (protected by discoverMapLock) */
     struct NameMapEntry {
         qcc::String busAddr;
@@ -21,6 +21,13 @@
 
 
 #include <qcc/platform.h>
+
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include <qcc/IPAddress.h>
 #include <qcc/Socket.h>
 #include <qcc/SocketTypes.h>
@@ -113,8 +120,27 @@ typedef struct ARDP_TIMER {
     uint32_t delta;
     uint32_t when;
     uint32_t retry;
+    uint32_t scheduled;     /* Time of the current retransmit heap entry for this timer */
 } ArdpTimer;
 
+/*
+ * Entry of a timer heap. Entries are never removed from the middle of a heap; an entry whose
+ * time no longer matches the deadline it was pushed for is stale and is dropped when popped.
+ */
+struct ArdpTimerEntry {
+    uint32_t when;          /* Deadline this entry was scheduled for */
+    ArdpConnRecord* conn;   /* Connection the deadline belongs to */
+    uint32_t connId;        /* Id of the connection, to detect a conn record reused after free */
+    ArdpTimer* timer;       /* Retransmit timer, or NULL for an entry covering all timers of the connection */
+
+    ArdpTimerEntry(uint32_t when, ArdpConnRecord* conn, uint32_t connId, ArdpTimer* timer) :
+        when(when), conn(conn), connId(connId), timer(timer) { }
+
+    bool operator>(const ArdpTimerEntry& other) const { return when > other.when; }
+};
+
+typedef std::priority_queue<ArdpTimerEntry, std::vector<ArdpTimerEntry>, std::greater<ArdpTimerEntry> > ArdpTimerHeap;
+
 /* Structure encapsulating the information about segments on SEND side */
 typedef struct ARDP_SEND_BUF {
     uint8_t* data;
@@ -260,6 +286,7 @@ struct ARDP_CONN_RECORD {
     ArdpTimer probeTimer;   /* Probe (link timeout) timer */
     ArdpTimer ackTimer;     /* Delayed ACK timer */
     ArdpTimer persistTimer; /* Persist (frozen window) timer */
+    uint32_t deadline;      /* Time of the current connection timer heap entry for this connection */
     uint32_t ackPending;    /* Number of received segments pending acknowledgement */
     bool modeSimple;        /* Simple mode connection. No EACKs. */
     void* context;          /* A client-defined context pointer */
@@ -277,10 +304,25 @@ struct ARDP_HANDLE {
 #endif
     bool accepting;          /* If true the ArdpProtocol is accepting inbound connections */
     ListNode conns;          /* List of currently active connections */
+    std::unordered_set<ArdpConnRecord*> connSet;                   /* Currently active connections, for validity checks */
+    std::unordered_multimap<uint32_t, ArdpConnRecord*> connIndex;  /* Currently active connections keyed by (local, foreign) port pair */
     qcc::Timespec<qcc::MonotonicTime> tbase; /* Baseline time */
     ListNode dataTimers;     /* List of currently scheduled retransmit timers */
+    ArdpTimerHeap connTimers;  /* Earliest deadline of the connect, probe, ACK and persist timers of each connection */
+    ArdpTimerHeap dataTimerHeap; /* Deadlines of the scheduled retransmit timers */
     uint32_t msnext;         /* To inform upper layer when to call into the protocol next time */
     bool trafficJam;         /* "Socket Write Block" indicator */
+    uint16_t portShard;      /* Local ports of new connections are congruent to portShard modulo portShards */
+    uint16_t portShards;     /* Number of handles sharing one UDP port (see ARDP_SetPortPartition) */
+    uint16_t batch;          /* Datagrams moved per system call by ARDP_Run (see ARDP_SetBatchSize) */
+    std::vector<uint8_t> rcvBatchBuf;     /* Receive buffers of the datagrams in rcvBatch */
+    std::vector<qcc::Datagram> rcvBatch;  /* Datagrams of a batched read */
+    bool sndBatching;        /* If true, outbound datagrams are staged in sndBatch instead of being sent */
+    qcc::SocketFd sndBatchSock;           /* The socket all datagrams in sndBatch go out on */
+    qcc::SendMsgFlags sndBatchFlags;      /* The flags all datagrams in sndBatch go out with */
+    std::vector<qcc::Datagram> sndBatch;  /* Staged outbound datagrams */
+    std::vector<uint8_t> sndBatchBuf;     /* Copies of the staged outbound datagrams */
+    size_t sndBatchUsed;     /* Octets of sndBatchBuf in use */
     void* context;           /* A client-defined context pointer */
 };
 
@@ -304,6 +346,9 @@ struct ARDP_HANDLE {
 static ArdpConnRecord* FindConn(ArdpHandle* handle, uint16_t local, uint16_t foreign);
 static QStatus DoSendSyn(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf, uint16_t len);
 
+/* A UDP datagram can be up to 64K long */
+static const size_t ARDP_DATAGRAM_MAX = 65536;
+
 /**************
  * End of definitions
  */
@@ -412,40 +457,106 @@ static uint32_t TimeNow(qcc::Timespec<qcc::MonotonicTime> base)
     return 1000 * (now.seconds - base.seconds) + (now.mseconds - base.mseconds);
 }
 
-static bool IsConnValid(ArdpHandle* handle, ArdpConnRecord* conn)
+static inline uint32_t ConnKey(uint16_t local, uint16_t foreign)
 {
-    if (conn == NULL) {
-        return false;
-    }
+    return (static_cast<uint32_t>(local) << 16) | foreign;
+}
 
-    if (IsEmpty(&handle->conns)) {
-        return false;
-    }
+static void AddConn(ArdpHandle* handle, ArdpConnRecord* conn)
+{
+    EnList(handle->conns.bwd, (ListNode*)conn);
+    handle->connSet.insert(conn);
+    handle->connIndex.insert(std::make_pair(ConnKey(conn->local, conn->foreign), conn));
+}
 
-    for (ListNode* ln = &handle->conns; (ln = ln->fwd) != &handle->conns;) {
-        if (conn == (ArdpConnRecord*)ln) {
+static bool UnindexConn(ArdpHandle* handle, ArdpConnRecord* conn)
+{
+    typedef std::unordered_multimap<uint32_t, ArdpConnRecord*>::iterator ConnIterator;
+    std::pair<ConnIterator, ConnIterator> range = handle->connIndex.equal_range(ConnKey(conn->local, conn->foreign));
+    for (ConnIterator it = range.first; it != range.second; ++it) {
+        if (it->second == conn) {
+            handle->connIndex.erase(it);
             return true;
         }
     }
     return false;
 }
 
-static bool IsConnValid(ArdpHandle* handle, ArdpConnRecord* conn, uint32_t connId)
+static void RemoveConn(ArdpHandle* handle, ArdpConnRecord* conn)
+{
+    UnindexConn(handle, conn);
+    handle->connSet.erase(conn);
+    DeList((ListNode*)conn);
+}
+
+/*
+ * The foreign port of a passive connection is only learned from the SYN, so the
+ * connection has to be moved in the index when it changes.
+ */
+static void SetForeignPort(ArdpHandle* handle, ArdpConnRecord* conn, uint16_t foreign)
+{
+    if (conn->foreign != foreign) {
+        bool indexed = UnindexConn(handle, conn);
+        conn->foreign = foreign;
+        if (indexed) {
+            handle->connIndex.insert(std::make_pair(ConnKey(conn->local, conn->foreign), conn));
+        }
+    }
+}
+
+static bool IsConnValid(ArdpHandle* handle, ArdpConnRecord* conn)
 {
     if (conn == NULL) {
         return false;
     }
 
-    if (IsEmpty(&handle->conns)) {
-        return false;
+#if ARDP_STATS
+    ++handle->stats.connLookups;
+#endif
+    return handle->connSet.find(conn) != handle->connSet.end();
+}
+
+static bool IsConnValid(ArdpHandle* handle, ArdpConnRecord* conn, uint32_t connId)
+{
+    return IsConnValid(handle, conn) && (conn->id == connId);
+}
+
+/*
+ * Make sure the timers of a connection are looked at no later than "when". Entries are
+ * only pushed when they move the deadline of the connection earlier; entries left behind
+ * by an earlier deadline are discarded when they reach the top of the heap.
+ */
+static void ScheduleConnTimers(ArdpHandle* handle, ArdpConnRecord* conn, uint32_t when)
+{
+    if (when < conn->deadline) {
+        conn->deadline = when;
+        handle->connTimers.push(ArdpTimerEntry(when, conn, conn->id, NULL));
     }
+}
 
-    for (ListNode* ln = &handle->conns; (ln = ln->fwd) != &handle->conns;) {
-        if (conn == (ArdpConnRecord*)ln && (conn->id == connId)) {
-            return true;
-        }
+static void ScheduleDataTimer(ArdpHandle* handle, ArdpConnRecord* conn, ArdpTimer* timer)
+{
+    if (timer->when != timer->scheduled) {
+        timer->scheduled = timer->when;
+        handle->dataTimerHeap.push(ArdpTimerEntry(timer->when, conn, conn->id, timer));
     }
-    return false;
+}
+
+static bool IsCurrentTimerEntry(ArdpHandle* handle, const ArdpTimerEntry& entry)
+{
+    if (!IsConnValid(handle, entry.conn, entry.connId)) {
+        return false;
+    }
+    if (entry.timer == NULL) {
+        return entry.when == entry.conn->deadline;
+    }
+    return entry.when == entry.timer->scheduled;
+}
+
+static inline bool IsConnTimer(ArdpConnRecord* conn, ArdpTimer* timer)
+{
+    return (timer == &conn->connectTimer) || (timer == &conn->probeTimer) ||
+           (timer == &conn->ackTimer) || (timer == &conn->persistTimer);
 }
 
 static void moveAhead(ArdpHandle* handle, ArdpConnRecord* conn)
@@ -470,6 +581,10 @@ static void InitTimer(ArdpHandle* handle, ArdpConnRecord* conn, ArdpTimer* timer
     timer->delta = timeout;
     timer->when = TimeNow(handle->tbase) + timeout;
     timer->retry = retry;
+    timer->scheduled = ARDP_NO_TIMEOUT;
+    if (IsConnTimer(conn, timer)) {
+        ScheduleConnTimers(handle, conn, timer->when);
+    }
     /* Update "call-me-back" value */
     if ((retry != 0) && (timeout < handle->msnext)) {
         moveAhead(handle, conn);
@@ -483,6 +598,9 @@ static void UpdateTimer(ArdpHandle* handle, ArdpConnRecord* conn, ArdpTimer* tim
     timer->delta = timeout;
     timer->when = TimeNow(handle->tbase) + timeout;
     timer->retry = retry;
+    if (IsConnTimer(conn, timer)) {
+        ScheduleConnTimers(handle, conn, timer->when);
+    }
     if ((retry != 0) && (timeout < handle->msnext)) {
         moveAhead(handle, conn);
         handle->msnext = timeout;
@@ -583,6 +701,56 @@ static bool IsValidRetransmit(ArdpConnRecord* conn, ArdpSndBuf* sBuf)
     }
 }
 
+/*
+ * Earliest time at which CheckConnTimers() has something to do for the connection
+ */
+static uint32_t GetConnDeadline(ArdpConnRecord* conn)
+{
+    if (conn->connectTimer.retry != 0) {
+        return conn->connectTimer.when;
+    }
+
+    if (conn->state != OPEN) {
+        return ARDP_NO_TIMEOUT;
+    }
+
+    uint32_t deadline = conn->probeTimer.when;
+    if (conn->ackTimer.retry != 0) {
+        deadline = MIN(deadline, conn->ackTimer.when);
+    }
+    if (conn->persistTimer.retry != 0) {
+        deadline = MIN(deadline, conn->persistTimer.when);
+    }
+    return deadline;
+}
+
+/*
+ * Pop the entries of a timer heap that are due, skipping stale ones. The deadline of
+ * each entry returned is cleared so that timers rearmed while handlers run push new entries.
+ */
+static void PopDueTimers(ArdpHandle* handle, ArdpTimerHeap& heap, uint32_t now, std::vector<ArdpTimerEntry>& due)
+{
+    while (!heap.empty() && (heap.top().when <= now)) {
+        ArdpTimerEntry entry = heap.top();
+        heap.pop();
+#if ARDP_STATS
+        ++handle->stats.timerChecks;
+#endif
+        if (!IsCurrentTimerEntry(handle, entry)) {
+#if ARDP_STATS
+            ++handle->stats.staleTimers;
+#endif
+            continue;
+        }
+        if (entry.timer == NULL) {
+            entry.conn->deadline = ARDP_NO_TIMEOUT;
+        } else {
+            entry.timer->scheduled = ARDP_NO_TIMEOUT;
+        }
+        due.push_back(entry);
+    }
+}
+
 /*
  * Fire expired ones and return the next one
  */
@@ -590,61 +758,107 @@ static uint32_t CheckTimers(ArdpHandle* handle)
 {
     uint32_t nextTime = ARDP_NO_TIMEOUT;
     uint32_t now = TimeNow(handle->tbase);
-    ListNode* ln = &handle->conns;
+    std::vector<ArdpTimerEntry> due;
 
-    if (IsEmpty(ln)) {
-        return nextTime;
+    PopDueTimers(handle, handle->connTimers, now, due);
+    for (std::vector<ArdpTimerEntry>::iterator it = due.begin(); it != due.end(); ++it) {
+        /* Handlers may have removed the connection */
+        if (IsConnValid(handle, it->conn, it->connId)) {
+            CheckConnTimers(handle, it->conn, ARDP_NO_TIMEOUT, now);
+        }
+        if (IsConnValid(handle, it->conn, it->connId)) {
+            ScheduleConnTimers(handle, it->conn, GetConnDeadline(it->conn));
+        }
     }
 
-    for (; (ln = ln->fwd) != &handle->conns;) {
-        ListNode* temp = ln->bwd;
-
-        nextTime = CheckConnTimers(handle, (ArdpConnRecord* ) ln, nextTime, now);
+    while (!handle->connTimers.empty() && !IsCurrentTimerEntry(handle, handle->connTimers.top())) {
+#if ARDP_STATS
+        ++handle->stats.staleTimers;
+#endif
+        handle->connTimers.pop();
+    }
+    if (!handle->connTimers.empty()) {
+        nextTime = handle->connTimers.top().when;
+    }
 
-        /* Check if connection record has been removed due to expiring connect/disconnect timers */
-        if (IsEmpty(&handle->conns)) {
-            break;
-        } else if (!IsConnValid(handle, (ArdpConnRecord*) ln)) {
-            ln = temp;
-        }
+    if (handle->trafficJam) {
+        return (nextTime != ARDP_NO_TIMEOUT) ? ((nextTime > now) ? nextTime - now : 0) : ARDP_NO_TIMEOUT;
     }
 
-    ln = &handle->dataTimers;
+    due.clear();
+    PopDueTimers(handle, handle->dataTimerHeap, now, due);
+    for (std::vector<ArdpTimerEntry>::iterator it = due.begin(); it != due.end(); ++it) {
+        ArdpTimer* timer = it->timer;
 
-    if (!handle->trafficJam && !IsEmpty(ln)) {
-        for (; (ln = ln->fwd) != &handle->dataTimers;) {
-            ArdpTimer* timer = (ArdpTimer*)ln;
+        if (!IsConnValid(handle, it->conn, it->connId) || IsEmpty(&timer->list)) {
+            continue;
+        }
 
-            if ((timer->when <= now) && (timer->retry > 0)) {
-                QCC_DbgPrintf(("CheckTimers: conn %p, fire retransmit timer %p at %u (now=%u)",
-                               timer->conn, timer, timer->when, now));
+        if (handle->trafficJam) {
+            /* The socket blocked, leave the rest for the next round */
+            ScheduleDataTimer(handle, it->conn, timer);
+            continue;
+        }
+
+        if (timer->retry > 0) {
+            QCC_DbgPrintf(("CheckTimers: conn %p, fire retransmit timer %p at %u (now=%u)",
+                           timer->conn, timer, timer->when, now));
 
-                (timer->handler)(handle, timer->conn, timer->context);
-                timer->when = now + timer->delta;
+            (timer->handler)(handle, timer->conn, timer->context);
+            if (!IsConnValid(handle, it->conn, it->connId)) {
+                continue;
             }
+            timer->when = now + timer->delta;
+        }
+
+        if (timer->retry == 0) {
+            /* We either hit the retransmit limit or the message's TTL has expired. */
+            DeList((ListNode*)timer);
+        } else if (!IsEmpty(&timer->list)) {
+            ScheduleDataTimer(handle, it->conn, timer);
+        }
+    }
+
+    /*
+     * Retransmits that are held back by the simple mode window do not count towards the
+     * next wake up; set them aside while looking for the earliest one that does.
+     */
+    std::vector<ArdpTimerEntry> held;
+    while (!handle->trafficJam && !handle->dataTimerHeap.empty()) {
+        ArdpTimerEntry entry = handle->dataTimerHeap.top();
+        ArdpTimer* timer = entry.timer;
 
-            if (timer->retry == 0) {
-                /* We either hit the retransmit limit or the message's TTL has expired. */
-                ln = ln->bwd;
+        if (!IsCurrentTimerEntry(handle, entry) || IsEmpty(&timer->list) || (timer->retry == 0)) {
+#if ARDP_STATS
+            ++handle->stats.staleTimers;
+#endif
+            handle->dataTimerHeap.pop();
+            if (IsCurrentTimerEntry(handle, entry)) {
+                timer->scheduled = ARDP_NO_TIMEOUT;
                 DeList((ListNode*)timer);
-                break;
-            } else if (timer->when < nextTime && IsValidRetransmit(timer->conn, (ArdpSndBuf*) timer->context)) {
-                /* Update "call-me-next-ms" value */
-                nextTime = timer->when;
             }
+            continue;
+        }
 
-            if (handle->trafficJam) {
-                break;
-            }
+        if (!IsValidRetransmit(entry.conn, (ArdpSndBuf*) timer->context)) {
+            held.push_back(entry);
+            handle->dataTimerHeap.pop();
+            continue;
         }
+
+        /* Update "call-me-next-ms" value */
+        nextTime = MIN(nextTime, entry.when);
+        break;
+    }
+    for (std::vector<ArdpTimerEntry>::iterator it = held.begin(); it != held.end(); ++it) {
+        handle->dataTimerHeap.push(*it);
     }
 
-    return (nextTime != ARDP_NO_TIMEOUT) ? nextTime - now : ARDP_NO_TIMEOUT;
+    return (nextTime != ARDP_NO_TIMEOUT) ? ((nextTime > now) ? nextTime - now : 0) : ARDP_NO_TIMEOUT;
 }
 
 static void DelConnRecord(ArdpHandle* handle, ArdpConnRecord* conn, bool forced)
 {
-    QCC_UNUSED(handle);
     QCC_DbgTrace(("DelConnRecord(handle=%p conn=%p forced=%s state=%s)",
                   handle, conn, forced ? "true" : "false", State2Text(conn->state)));
 
@@ -670,7 +884,7 @@ static void DelConnRecord(ArdpHandle* handle, ArdpConnRecord* conn, bool forced)
         free(conn->rcv.buf);
     }
 
-    DeList((ListNode*)conn);
+    RemoveConn(handle, conn);
 
     if (conn->synData.buf != NULL) {
         free(conn->synData.buf);
@@ -779,10 +993,73 @@ static void MarshalSynHeader(uint32_t* buf32, ArdpSynHeader* h)
     *reinterpret_cast<uint16_t*>(txbuf + SYN_RSRV_OFFSET) = 0;
 }
 
+/*
+ * Send all datagrams staged by SendDatagram() with as few system calls as the
+ * platform allows.  A datagram that does not make it out because the socket
+ * buffer is full is treated like any other lost datagram, so the usual
+ * retransmission takes care of it.
+ */
+static void FlushSendBatch(ArdpHandle* handle)
+{
+    if (handle->sndBatch.empty()) {
+        return;
+    }
+
+    size_t sent;
+    QStatus status = qcc::SendToBatch(handle->sndBatchSock, &handle->sndBatch[0], handle->sndBatch.size(), sent, handle->sndBatchFlags);
+    if (status == ER_WOULDBLOCK) {
+        QCC_DbgHLPrintf(("FlushSendBatch(): ER_WOULDBLOCK after %u of %u datagrams", sent, handle->sndBatch.size()));
+        handle->trafficJam = true;
+    }
+
+    handle->sndBatch.clear();
+    handle->sndBatchUsed = 0;
+}
+
+/*
+ * Send a datagram, or, while ARDP_Run() is coalescing outbound traffic, stage
+ * a copy of it to go out with the next FlushSendBatch().
+ */
+static QStatus SendDatagram(ArdpHandle* handle, qcc::SocketFd sock, qcc::IPAddress& ipAddr, uint16_t ipPort,
+                            const qcc::ScatterGatherList& msgSG, qcc::SendMsgFlags flags)
+{
+    if (!handle->sndBatching) {
+        size_t sent;
+        return qcc::SendToSG(sock, ipAddr, ipPort, msgSG, sent, flags);
+    }
+
+    size_t len = msgSG.MaxDataSize();
+    QCC_ASSERT(len <= handle->sndBatchBuf.size());
+
+    if (!handle->sndBatch.empty() &&
+        (sock != handle->sndBatchSock || flags != handle->sndBatchFlags ||
+         handle->sndBatch.size() == handle->batch || handle->sndBatchUsed + len > handle->sndBatchBuf.size())) {
+        FlushSendBatch(handle);
+    }
+
+    qcc::Datagram dgram;
+    dgram.addr = ipAddr;
+    dgram.port = ipPort;
+    dgram.buf = &handle->sndBatchBuf[handle->sndBatchUsed];
+    dgram.size = len;
+    dgram.len = len;
+
+    uint8_t* pos = static_cast<uint8_t*>(dgram.buf);
+    for (qcc::ScatterGatherList::const_iterator iter = msgSG.Begin(); iter != msgSG.End(); ++iter) {
+        memcpy(pos, iter->buf, iter->len);
+        pos += iter->len;
+    }
+
+    handle->sndBatchUsed += len;
+    handle->sndBatchSock = sock;
+    handle->sndBatchFlags = flags;
+    handle->sndBatch.push_back(dgram);
+    return ER_OK;
+}
+
 static QStatus SendMsgHeader(ArdpHandle* handle, ArdpConnRecord* conn, ArdpHeader* h)
 {
     qcc::ScatterGatherList msgSG;
-    size_t sent;
     QStatus status;
     uint32_t buf32[ARDP_FIXED_HEADER_LEN >> 2];
     uint32_t len;
@@ -816,7 +1093,7 @@ static QStatus SendMsgHeader(ArdpHandle* handle, ArdpConnRecord* conn, ArdpHeade
     }
 #endif
 
-    status = SendToSG(conn->sock, conn->ipAddr, conn->ipPort, msgSG, sent, conn->sndFlags);
+    status = SendDatagram(handle, conn->sock, conn->ipAddr, conn->ipPort, msgSG, conn->sndFlags);
     if (status == ER_WOULDBLOCK) {
         QCC_DbgHLPrintf(("SendMsgHeader: ER_WOULDBLOCK"));
         handle->trafficJam = true;
@@ -853,11 +1130,11 @@ static QStatus Send(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t flags, uin
 }
 
 
-static void UnmarshalSynSegment(ArdpConnRecord* conn, uint8_t* buf, ArdpSeg* seg)
+static void UnmarshalSynSegment(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf, ArdpSeg* seg)
 {
     uint16_t options = ntohs(*reinterpret_cast<uint16_t*>(buf + OPTIONS_OFFSET));
     conn->modeSimple = (options & ARDP_FLAG_SIMPLE_MODE);
-    conn->foreign = ntohs(*reinterpret_cast<uint16_t*>(buf + SRC_OFFSET)); /* The source ARDP port */
+    SetForeignPort(handle, conn, ntohs(*reinterpret_cast<uint16_t*>(buf + SRC_OFFSET))); /* The source ARDP port */
     conn->snd.SEGMAX = ntohs(*reinterpret_cast<uint16_t*>(buf + SEGMAX_OFFSET));     /* Max number of unacknowledged packets other side can buffer */
     conn->snd.SEGBMAX = ntohs(*reinterpret_cast<uint16_t*>(buf + SEGBMAX_OFFSET));   /* Max size segment the other side can handle */
     conn->snd.DACKT = ntohl(*reinterpret_cast<uint32_t*>(buf + DACKT_OFFSET));       /* Delayed ACK timeout from the other side.  */
@@ -1021,7 +1298,6 @@ static QStatus SendMsgData(ArdpHandle* handle, ArdpConnRecord* conn, ArdpSndBuf*
     qcc::ScatterGatherList msgSG;
     uint32_t buf32[ARDP_FIXED_HEADER_LEN >> 2];
     uint32_t len;
-    size_t sent;
     QStatus status;
 
     QCC_DbgTrace(("SendMsgData(): handle=%p, conn=%p, hdr=%p, data=%p, datalen=%d, ttl=%u, tStart=%u",
@@ -1065,7 +1341,7 @@ static QStatus SendMsgData(ArdpHandle* handle, ArdpConnRecord* conn, ArdpSndBuf*
     }
 #endif
 
-    status = qcc::SendToSG(conn->sock, conn->ipAddr, conn->ipPort, msgSG, sent, conn->sndFlags);
+    status = SendDatagram(handle, conn->sock, conn->ipAddr, conn->ipPort, msgSG, conn->sndFlags);
 
     if (status == ER_OK) {
         /* Piggyback ACKs with data. Cancel ACK timer. */
@@ -1364,12 +1640,18 @@ ArdpHandle* ARDP_AllocHandle(ArdpGlobalConfig* config)
 
     srand(qcc::Rand32());
 
-    ArdpHandle* handle = new ArdpHandle;
-    memset(handle, 0, sizeof(ArdpHandle));
+    ArdpHandle* handle = new ArdpHandle();
     SetEmpty(&handle->conns);
     SetEmpty(&handle->dataTimers);
     GetTimeNow(&handle->tbase);
     handle->msnext = ARDP_NO_TIMEOUT;
+    handle->portShard = 0;
+    handle->portShards = 1;
+    handle->batch = 1;
+    handle->sndBatching = false;
+    handle->sndBatchSock = qcc::INVALID_SOCKET_FD;
+    handle->sndBatchFlags = qcc::QCC_MSG_NONE;
+    handle->sndBatchUsed = 0;
     memcpy(&handle->config, config, sizeof(ArdpGlobalConfig));
     return handle;
 }
@@ -1481,6 +1763,33 @@ void* ARDP_GetHandleContext(ArdpHandle* handle)
     return handle->context;
 }
 
+void ARDP_SetPortPartition(ArdpHandle* handle, uint16_t index, uint16_t count)
+{
+    QCC_DbgTrace(("ARDP_SetPortPartition(handle=%p, index=%u., count=%u.)", handle, index, count));
+    QCC_ASSERT(count != 0 && index < count);
+    handle->portShard = index;
+    handle->portShards = count;
+}
+
+void ARDP_SetBatchSize(ArdpHandle* handle, uint16_t batch)
+{
+    QCC_DbgTrace(("ARDP_SetBatchSize(handle=%p, batch=%u.)", handle, batch));
+    handle->batch = (uint16_t)MIN(MAX(batch, 1), qcc::DATAGRAM_BATCH_MAX);
+    handle->rcvBatch.clear();
+    handle->rcvBatchBuf.clear();
+    handle->sndBatchBuf.clear();
+    if (handle->batch > 1) {
+        handle->rcvBatchBuf.resize(handle->batch * ARDP_DATAGRAM_MAX);
+        handle->rcvBatch.resize(handle->batch);
+        for (uint16_t i = 0; i < handle->batch; ++i) {
+            handle->rcvBatch[i].buf = &handle->rcvBatchBuf[i * ARDP_DATAGRAM_MAX];
+            handle->rcvBatch[i].size = ARDP_DATAGRAM_MAX;
+        }
+        handle->sndBatch.reserve(handle->batch);
+        handle->sndBatchBuf.resize(ARDP_DATAGRAM_MAX);
+    }
+}
+
 bool ARDP_IsConnValid(ArdpHandle* handle, ArdpConnRecord* conn, uint32_t connId)
 {
     QCC_DbgTrace(("ARDP_IsConnValid(handle=%p, conn=%p)", handle, conn));
@@ -1589,6 +1898,7 @@ static ArdpConnRecord* NewConnRecord(void)
     } while (conn->id == ARDP_CONN_ID_INVALID);
     QCC_DbgTrace(("NewConnRecord(): conn %p, id %u", conn, conn->id));
     SetEmpty(&conn->list);
+    conn->deadline = ARDP_NO_TIMEOUT;
     return conn;
 }
 
@@ -1627,13 +1937,23 @@ static QStatus InitConnRecord(ArdpHandle* handle, ArdpConnRecord* conn, qcc::Soc
     uint32_t count = 0;
 
     conn->state = CLOSED;                 /* Starting state is always CLOSED */
-    local = (qcc::Rand32() % 65534) + 1;  /* Allocate an "ephemeral" source port */
 
-    /* Make sure this is a unique combiation of foreign/local */
-    while (FindConn(handle, local, foreign) != NULL) {
-        local++;
+    /*
+     * Allocate an "ephemeral" source port.  If several handles share a UDP
+     * port, each one only hands out local ports in its own residue class so
+     * that the socket layer can steer inbound segments by destination port.
+     */
+    uint32_t shards = handle->portShards;
+    uint32_t slots = (65535 - handle->portShard) / shards + 1;
+    uint32_t slot = qcc::Rand32() % slots;
+    local = static_cast<uint16_t>(slot * shards + handle->portShard);
+
+    /* Make sure this is a unique combiation of foreign/local (and never zero) */
+    while (local == 0 || FindConn(handle, local, foreign) != NULL) {
+        slot = (slot + 1) % slots;
+        local = static_cast<uint16_t>(slot * shards + handle->portShard);
         count++;
-        if (count == 65535) {
+        if (count == slots) {
             /* Really? We exhausted all the connections?! */
             QCC_LogError(ER_FAIL, ("InitConnRecord: Cannot get a new connection record. Too many connections?"));
             return ER_FAIL;
@@ -1679,15 +1999,15 @@ static ArdpConnRecord* FindConn(ArdpHandle* handle, uint16_t local, uint16_t for
 {
     QCC_DbgTrace(("FindConn(handle=%p, local=%d, foreign=%d)", handle, local, foreign));
 
-    for (ListNode* ln = &handle->conns; (ln = ln->fwd) != &handle->conns;) {
-        ArdpConnRecord* conn = (ArdpConnRecord*)ln;
-        QCC_DbgPrintf(("FindConn(): conn %p local = %d, foreign = %d", conn, conn->local, conn->foreign));
-        if (conn->local == local && conn->foreign == foreign) {
-            QCC_DbgPrintf(("FindConn(): Found conn %p", conn));
-            return conn;
-        }
+#if ARDP_STATS
+    ++handle->stats.connLookups;
+#endif
+    std::unordered_multimap<uint32_t, ArdpConnRecord*>::const_iterator it = handle->connIndex.find(ConnKey(local, foreign));
+    if (it == handle->connIndex.end()) {
+        return NULL;
     }
-    return NULL;
+    QCC_DbgPrintf(("FindConn(): Found conn %p", it->second));
+    return it->second;
 }
 
 static QStatus SendData(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf, uint32_t len, uint32_t ttl)
@@ -1833,6 +2153,7 @@ static QStatus SendData(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf,
             }
 
             EnList(handle->dataTimers.bwd, (ListNode*) &sBuf->timer);
+            ScheduleDataTimer(handle, conn, &sBuf->timer);
             conn->snd.pending++;
             QCC_ASSERT(((conn->snd.pending) <= conn->snd.SEGMAX) && "Number of pending segments in send queue exceeds MAX!");
             conn->snd.NXT++;
@@ -1855,7 +2176,6 @@ static QStatus DoSendSyn(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf,
     ArdpSynHeader hSyn;
     qcc::ScatterGatherList msgSG;
     uint32_t buf32[(ARDP_SYN_HEADER_SIZE + 3) >> 2];
-    size_t sent;
 
     QCC_DbgTrace(("DoSendSyn(handle=%p, conn=%p, buf=%p, len = %d)", handle, conn, buf, len));
 
@@ -1903,7 +2223,7 @@ static QStatus DoSendSyn(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf,
     ++handle->stats.synSends;
 #endif
 
-    return qcc::SendToSG(conn->sock, conn->ipAddr, conn->ipPort, msgSG, sent);
+    return SendDatagram(handle, conn->sock, conn->ipAddr, conn->ipPort, msgSG, qcc::QCC_MSG_NONE);
 }
 
 static QStatus SendSyn(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf, uint16_t len)
@@ -2058,7 +2378,6 @@ static QStatus UpdateSndSegments(ArdpHandle* handle, ArdpConnRecord* conn, uint3
 
 static void FastRetransmit(ArdpHandle* handle, ArdpConnRecord* conn, ArdpSndBuf* sBuf)
 {
-    QCC_UNUSED(conn);
     /*
      * Fast retransmit to fill the gap. Schedule only for those segments that haven't been
      * tried for retransmission yet.
@@ -2066,6 +2385,9 @@ static void FastRetransmit(ArdpHandle* handle, ArdpConnRecord* conn, ArdpSndBuf*
     if ((sBuf->fastRT == handle->config.fastRetransmitAckCounter) && (sBuf->retransmits == 0)) {
         QCC_DbgPrintf(("FastRetransmit(): priority re-send %u", ntohl(((ArdpHeader*)sBuf->hdr)->seq)));
         sBuf->timer.when = TimeNow(handle->tbase);
+        if (!IsEmpty(&sBuf->timer.list)) {
+            ScheduleDataTimer(handle, conn, &sBuf->timer);
+        }
     }
     sBuf->fastRT++;
 }
@@ -2660,7 +2982,7 @@ static void ArdpMachine(ArdpHandle* handle, ArdpConnRecord* conn, ArdpSeg* seg,
                 ++handle->stats.synRecvs;
 #endif
 
-                UnmarshalSynSegment(conn, buf, seg);
+                UnmarshalSynSegment(handle, conn, buf, seg);
 
                 QCC_DbgPrintf(("ArdpMachine(): LISTEN: SYN received: the other side can receive max %d bytes", conn->snd.SEGBMAX));
                 if (handle->cb.AcceptCb != NULL) {
@@ -2712,7 +3034,7 @@ static void ArdpMachine(ArdpHandle* handle, ArdpConnRecord* conn, ArdpSeg* seg,
 #if ARDP_STATS
                 ++handle->stats.synRecvs;
 #endif
-                UnmarshalSynSegment(conn, buf, seg);
+                UnmarshalSynSegment(handle, conn, buf, seg);
 
                 status = InitSnd(handle, conn);
 
@@ -3105,7 +3427,7 @@ QStatus ARDP_Connect(ArdpHandle* handle, qcc::SocketFd sock, qcc::IPAddress ipAd
     if (status == ER_OK) {
         conn->context = context;
         conn->passive = false;
-        EnList(handle->conns.bwd, (ListNode*)conn);
+        AddConn(handle, conn);
         status = SendSyn(handle, conn, buf, len);
     }
 
@@ -3358,14 +3680,75 @@ static bool IsDuplicateConnRequest(ArdpHandle* handle, uint16_t foreign, qcc::IP
     return false;
 }
 
+/*
+ * Process one datagram read from sock by ARDP_Run().
+ */
+static QStatus RunDatagram(ArdpHandle* handle, qcc::SocketFd sock, qcc::IPAddress& address, uint16_t port, uint8_t* buf, size_t nbytes)
+{
+    QStatus status = ER_OK;
+    uint16_t local, foreign;
+    ProtocolDemux(buf, nbytes, &local, &foreign);
+    if (local == 0) {
+        if (handle->accepting && handle->cb.AcceptCb) {
+            if (!IsDuplicateConnRequest(handle, foreign, address)) {
+                ArdpConnRecord* conn = NewConnRecord();
+                status = InitConnRecord(handle, conn, sock, address, port, foreign);
+                if (status == ER_OK) {
+                    AddConn(handle, conn);
+                    status = Accept(handle, conn, buf, nbytes);
+                }
+                if (status != ER_OK) {
+                    SetState(conn, CLOSED);
+                    DelConnRecord(handle, conn, false);
+                }
+            } /*
+               * Else the remote most likely timed out waiting for our SYN_ACK.
+               * We should rely on local connection retry mechanism to kick in
+               * and eventually establish the connection.
+               */
+
+        } else {
+            status = ER_ARDP_INVALID_STATE;
+        }
+        if (status != ER_OK) {
+            QCC_LogError(status, ("Failed to accept incoming connection request from %s (ARDP port %u)", address.ToString().c_str(), foreign));
+            SendRst(handle, sock, address, port, local, foreign);
+        }
+    } else {
+        /* Is there an open connection? */
+        ArdpConnRecord* conn = FindConn(handle, local, foreign);
+        if (!conn) {
+            /* Is there a half open connection? */
+            conn = FindConn(handle, local, 0);
+        }
+
+        if (conn) {
+            if ((conn->state != CLOSED) && (conn->state != CLOSE_WAIT)) {
+                QCC_DbgHLPrintf(("ARDP_Run conn state %s", State2Text(conn->state)));
+                conn->lastSeen = TimeNow(handle->tbase);
+                conn->probeTimer.retry = handle->config.keepaliveRetries;
+                status = Receive(handle, conn, buf, nbytes);
+                if (status == ER_ARDP_INVALID_RESPONSE) {
+                    Disconnect(handle, conn, status);
+                }
+            } else {
+                uint8_t flags = *reinterpret_cast<uint8_t*>(buf + FLAGS_OFFSET);
+                /* Only send repeat RST if this is a NUL segment.
+                 * This is done to alleviate a situation when original RST has not reached
+                 * the remote. This can potentially cause the remote to keep the link
+                 * alive (sending pings and retransmit data) until it hits probe timeout
+                 */
+                if (flags & ARDP_FLAG_NUL) {
+                    SendRst(handle, sock, address, port, local, foreign);
+                }
+            }
+        }
+    }
+    return status;
+}
+
 QStatus ARDP_Run(ArdpHandle* handle, qcc::SocketFd sock, bool sockRead, bool sockWrite, uint32_t* ms)
 {
-    const size_t bufferSize = 65536;      /* UDP packet can be up to 64K long */
-    uint32_t buf32[bufferSize >> 2];
-    uint8_t* buf = reinterpret_cast<uint8_t*>(buf32);
-    qcc::IPAddress address;               /* The IP address of the foreign side */
-    uint16_t port;                        /* Will be the UDP port of the foreign side */
-    size_t nbytes;                        /* The number of bytes actually received */
     QStatus status = ER_OK;
 
     //QCC_DbgTrace(("ARDP_Run(handle=%p, sock=%d., socketRead=%d., socketWrite=%d., ms=%p)", handle, sock, sockRead, sockWrite, ms));
@@ -3373,8 +3756,45 @@ QStatus ARDP_Run(ArdpHandle* handle, qcc::SocketFd sock, bool sockRead, bool soc
         handle->trafficJam = false;
     }
 
-    if (sockRead) {
-        while ((status = qcc::RecvFrom(sock, address, port, buf, bufferSize, nbytes)) == ER_OK) {
+    /*
+     * In batched mode everything we send during this pass, for whichever
+     * connection, is staged and goes out in as few system calls as possible
+     * when the pass is done.
+     */
+    handle->sndBatching = (handle->batch > 1);
+
+    if (sockRead && handle->batch > 1) {
+        size_t received;
+        do {
+            status = qcc::RecvFromBatch(sock, &handle->rcvBatch[0], handle->batch, received);
+            for (size_t i = 0; i < received; ++i) {
+                qcc::Datagram& dgram = handle->rcvBatch[i];
+                uint8_t* buf = static_cast<uint8_t*>(dgram.buf);
+#if ARDP_TESTHOOKS
+                /*
+                 * Call the inbound testhook in case the test team needs to munge the
+                 * inbound data.
+                 */
+                if (handle->th.RecvFrom) {
+                    handle->th.RecvFrom(handle, NULL, ARDP_RUN, buf, dgram.len);
+                }
+#endif
+                if (dgram.len > 0 && dgram.len < ARDP_DATAGRAM_MAX) {
+                    status = RunDatagram(handle, sock, dgram.addr, dgram.port, buf, dgram.len);
+                } else {
+                    QCC_DbgHLPrintf(("ARDP_Run(): Dropping datagram (nbytes = %d)", dgram.len));
+                }
+            }
+            /* A short batch means the socket has been drained */
+        } while (received == handle->batch);
+    } else if (sockRead) {
+        uint32_t buf32[ARDP_DATAGRAM_MAX >> 2];
+        uint8_t* buf = reinterpret_cast<uint8_t*>(buf32);
+        qcc::IPAddress address;               /* The IP address of the foreign side */
+        uint16_t port;                        /* Will be the UDP port of the foreign side */
+        size_t nbytes;                        /* The number of bytes actually received */
+
+        while ((status = qcc::RecvFrom(sock, address, port, buf, ARDP_DATAGRAM_MAX, nbytes)) == ER_OK) {
 #if ARDP_TESTHOOKS
             /*
              * Call the inbound testhook in case the test team needs to munge the
@@ -3385,65 +3805,8 @@ QStatus ARDP_Run(ArdpHandle* handle, qcc::SocketFd sock, bool sockRead, bool soc
             }
 #endif
 
-            if (nbytes > 0 && nbytes < 65536) {
-                uint16_t local, foreign;
-                ProtocolDemux(buf, nbytes, &local, &foreign);
-                if (local == 0) {
-                    if (handle->accepting && handle->cb.AcceptCb) {
-                        if (!IsDuplicateConnRequest(handle, foreign, address)) {
-                            ArdpConnRecord* conn = NewConnRecord();
-                            status = InitConnRecord(handle, conn, sock, address, port, foreign);
-                            if (status == ER_OK) {
-                                EnList(handle->conns.bwd, (ListNode*)conn);
-                                status = Accept(handle, conn, buf, nbytes);
-                            }
-                            if (status != ER_OK) {
-                                SetState(conn, CLOSED);
-                                DelConnRecord(handle, conn, false);
-                            }
-                        } /*
-                           * Else the remote most likely timed out waiting for our SYN_ACK.
-                           * We should rely on local connection retry mechanism to kick in
-                           * and eventually establish the connection.
-                           */
-
-                    } else {
-                        status = ER_ARDP_INVALID_STATE;
-                    }
-                    if (status != ER_OK) {
-                        QCC_LogError(status, ("Failed to accept incoming connection request from %s (ARDP port %u)", address.ToString().c_str(), foreign));
-                        SendRst(handle, sock, address, port, local, foreign);
-                    }
-                } else {
-                    /* Is there an open connection? */
-                    ArdpConnRecord* conn = FindConn(handle, local, foreign);
-                    if (!conn) {
-                        /* Is there a half open connection? */
-                        conn = FindConn(handle, local, 0);
-                    }
-
-                    if (conn) {
-                        if ((conn->state != CLOSED) && (conn->state != CLOSE_WAIT)) {
-                            QCC_DbgHLPrintf(("ARDP_Run conn state %s", State2Text(conn->state)));
-                            conn->lastSeen = TimeNow(handle->tbase);
-                            conn->probeTimer.retry = handle->config.keepaliveRetries;
-                            status = Receive(handle, conn, buf, nbytes);
-                            if (status == ER_ARDP_INVALID_RESPONSE) {
-                                Disconnect(handle, conn, status);
-                            }
-                        } else {
-                            uint8_t flags = *reinterpret_cast<uint8_t*>(buf + FLAGS_OFFSET);
-                            /* Only send repeat RST if this is a NUL segment.
-                             * This is done to alleviate a situation when original RST has not reached
-                             * the remote. This can potentially cause the remote to keep the link
-                             * alive (sending pings and retransmit data) until it hits probe timeout
-                             */
-                            if (flags & ARDP_FLAG_NUL) {
-                                SendRst(handle, sock, address, port, local, foreign);
-                            }
-                        }
-                    }
-                }
+            if (nbytes > 0 && nbytes < ARDP_DATAGRAM_MAX) {
+                status = RunDatagram(handle, sock, address, port, buf, nbytes);
             } else {
                 QCC_DbgHLPrintf(("ARDP_Run(): Socket read failed (nbytes = %d)", nbytes));
                 break;
@@ -3453,6 +3816,9 @@ QStatus ARDP_Run(ArdpHandle* handle, qcc::SocketFd sock, bool sockRead, bool soc
 
     handle->msnext = CheckTimers(handle);
 
+    FlushSendBatch(handle);
+    handle->sndBatching = false;
+
     /*  Tell the higher levels when to call back next (timer expiration) */
     *ms = handle->msnext;
 
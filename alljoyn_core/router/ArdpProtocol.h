@@ -207,6 +207,8 @@ ArdpHandle* ARDP_AllocHandle(ArdpGlobalConfig* config);
 void ARDP_FreeHandle(ArdpHandle* handle);
 void ARDP_SetHandleContext(ArdpHandle* handle, void* context);
 void* ARDP_GetHandleContext(ArdpHandle* handle);
+void ARDP_SetPortPartition(ArdpHandle* handle, uint16_t index, uint16_t count);
+void ARDP_SetBatchSize(ArdpHandle* handle, uint16_t batch);
 bool ARDP_IsConnValid(ArdpHandle* handle, ArdpConnRecord* conn, uint32_t connId);
 void ARDP_ReleaseConn(ArdpHandle* handle, ArdpConnRecord* conn);
 QStatus ARDP_SetConnContext(ArdpHandle* handle, ArdpConnRecord* conn, void* context);
@@ -259,6 +261,9 @@ typedef struct {
     uint32_t rstRecvs;        /**< The number of RST packets we have received */
     uint32_t nulSends;        /**< The number of NUL packets we have sent */
     uint32_t nulRecvs;        /**< The number of NUL packets we have received */
+    uint32_t connLookups;     /**< The number of connection lookups by port pair or connection record */
+    uint32_t timerChecks;     /**< The number of timer heap entries examined while running timers */
+    uint32_t staleTimers;     /**< The number of timer heap entries discarded because they were out of date */
 } ArdpStats;
 
 ArdpStats* ARDP_GetStats(ArdpHandle* handle);
@@ -24,6 +24,7 @@
 #include <qcc/String.h>
 
 #include "Bus.h"
+#include "ConfigDB.h"
 #include "DaemonRouter.h"
 #include "TransportList.h"
 
@@ -39,11 +40,28 @@ using namespace std;
  */
 const uint32_t EP_CONCURRENCY = 4;
 
+/*
+ * Default and maximum number of iodispatch reactors servicing remote endpoints.
+ */
+const uint32_t IO_REACTORS_DEFAULT = 1;
+const uint32_t IO_REACTORS_MAX = 64;
+
 Bus::Bus(const char* applicationName, TransportFactoryContainer& factories, const char* listenSpecs) :
     BusAttachment(new Internal(applicationName, *this, factories, new DaemonRouter, true, listenSpecs, EP_CONCURRENCY), EP_CONCURRENCY),
     listenersLock(LOCK_LEVEL_BUS_LISTENERSLOCK)
 {
     GetInternal().GetRouter().SetGlobalGUID(GetInternal().GetGlobalGUID());
+
+    /*
+     * Spread the remote endpoint streams of the router across the configured
+     * number of iodispatch reactors.
+     */
+    uint32_t ioReactors = ConfigDB::GetConfigDB()->GetLimit("io_reactors", IO_REACTORS_DEFAULT);
+    if (ioReactors > IO_REACTORS_MAX) {
+        QCC_LogError(ER_INVALID_DATA, ("io_reactors limit %u exceeds %u", ioReactors, IO_REACTORS_MAX));
+        ioReactors = IO_REACTORS_MAX;
+    }
+    GetInternal().SetIODispatchCount(ioReactors);
 }
 
 Bus::~Bus()
@@ -54,7 +54,8 @@ namespace ajn {
 
 DaemonRouter::DaemonRouter()
     : ruleTable(), nameTable(), busController(NULL), alljoynObj(NULL), sessionlessObj(NULL),
-    m_Lock(LOCK_LEVEL_DAEMONROUTER_MLOCK)
+    m_Lock(LOCK_LEVEL_DAEMONROUTER_MLOCK), broadcastMessages(0), broadcastCandidates(0),
+    closedTxSaved(0), closedRxSaved(0)
 {
 #ifdef ENABLE_POLICYDB
     AddBusNameListener(ConfigDB::GetConfigDB());
@@ -328,6 +329,9 @@ QStatus DaemonRouter::PushMessage(Message& msg, BusEndpoint& src)
     vector<BusEndpoint> allEps;
     deque<BusEndpoint> destEps;
 
+    /* Resolve all names against a single snapshot of the name table without taking its lock */
+    std::shared_ptr<const NameTable::Snapshot> names = nameTable.GetSnapshot();
+
     bool blocked = false;
     bool blockedReply = false;
     bool policyRejected = false;
@@ -343,19 +347,46 @@ QStatus DaemonRouter::PushMessage(Message& msg, BusEndpoint& src)
          * allEps for processing.  NOTE: If the destination is a Bus-to-bus
          * endpoint we must fallback to iterating over those endpoints.
          */
-        BusEndpoint ep = nameTable.FindEndpoint(destination);
+        BusEndpoint ep = names->FindEndpoint(destination);
         if (ep->IsValid()) {
             allEps.push_back(ep);
         }
+#ifndef ENABLE_POLICYDB
+    } else if (isBroadcast) {
+        /*
+         * Only endpoints that have a match rule that could match the message
+         * can receive a broadcast message, so rather than checking the rules
+         * of every known endpoint, get the candidates from the rule table's
+         * index.  Global broadcast messages additionally go to all the
+         * Bus-to-bus endpoints.  (The policy rules need to see every endpoint
+         * so this shortcut is not taken when PolicyDB is enabled.)
+         */
+        set<BusEndpoint> candidates;
+        ruleTable.GetCandidateEndpoints(msg, candidates);
+        if (msgIsGlobalBroadcast) {
+            m_Lock.Lock(MUTEX_CONTEXT);
+            for (set<RemoteEndpoint>::iterator it = m_b2bEndpoints.begin(); it != m_b2bEndpoints.end(); ++it) {
+                RemoteEndpoint rep = *it;
+                candidates.insert(BusEndpoint::cast(rep));
+            }
+            m_Lock.Unlock(MUTEX_CONTEXT);
+        }
+        allEps.assign(candidates.begin(), candidates.end());
+#endif
     } else {
         /*
          * Here we get a list of all the known non-Bus-to-bus endpoints in the
          * system.
          */
-        nameTable.GetAllBusEndpoints(allEps);
+        allEps = names->GetAllBusEndpoints();
     }
 
-    if (!isUnicast || allEps.empty()) {
+#ifndef ENABLE_POLICYDB
+    const bool needB2bEps = isSessioncast || (isUnicast && allEps.empty());
+#else
+    const bool needB2bEps = !isUnicast || allEps.empty();
+#endif
+    if (needB2bEps) {
         /*
          * Here we get a list of all the known Bus-to-bus endpoints in the
          * system.  Oddly, Bus2Bus endpoints are not in the Name Table but
@@ -381,13 +412,18 @@ QStatus DaemonRouter::PushMessage(Message& msg, BusEndpoint& src)
         m_Lock.Unlock();
     }
 
+    if (isBroadcast) {
+        broadcastMessages++;
+        broadcastCandidates += allEps.size();
+    }
+
     /*
      * Here is where we iterate over all the known endpoints to determine which
      * ones will receive the message.
      */
     for (vector<BusEndpoint>::const_iterator it = allEps.begin(); it != allEps.end(); ++it) {
         BusEndpoint dest = *it;
-        const bool destIsDirect =     (isUnicast && nameTable.IsAlias(dest->GetUniqueName(), destination));
+        const bool destIsDirect =     (isUnicast && names->IsAlias(dest->GetUniqueName(), destination));
         // Is dest directly connected to this router?
         const bool destIsOurEp =      ((dest->GetEndpointType() == ENDPOINT_TYPE_LOCAL) ||
                                        (dest->GetEndpointType() == ENDPOINT_TYPE_NULL) ||
@@ -602,6 +638,21 @@ void DaemonRouter::GetBusNames(vector<qcc::String>& names) const
     nameTable.GetBusNames(names);
 }
 
+void DaemonRouter::GetHeaderCompressionStats(uint64_t& txSaved, uint64_t& rxSaved) const
+{
+    m_Lock.Lock(MUTEX_CONTEXT);
+    txSaved = closedTxSaved;
+    rxSaved = closedRxSaved;
+    for (set<RemoteEndpoint>::const_iterator it = m_b2bEndpoints.begin(); it != m_b2bEndpoints.end(); ++it) {
+        uint64_t tx;
+        uint64_t rx;
+        (*it)->GetHeaderCompressionStats(tx, rx);
+        txSaved += tx;
+        rxSaved += rx;
+    }
+    m_Lock.Unlock(MUTEX_CONTEXT);
+}
+
 BusEndpoint DaemonRouter::FindEndpoint(const qcc::String& busName)
 {
     BusEndpoint ep = nameTable.FindEndpoint(busName);
@@ -702,6 +753,13 @@ void DaemonRouter::UnregisterEndpoint(const qcc::String& epName, EndpointType ep
         while (it != m_b2bEndpoints.end()) {
             RemoteEndpoint rep = *it;
             if (rep == busToBusEndpoint) {
+                uint64_t txSaved;
+                uint64_t rxSaved;
+                rep->GetHeaderCompressionStats(txSaved, rxSaved);
+                QCC_DbgHLPrintf(("Bus-to-bus endpoint %s saved %llu header bytes sent, %llu received",
+                                 rep->GetUniqueName().c_str(), (unsigned long long)txSaved, (unsigned long long)rxSaved));
+                closedTxSaved += txSaved;
+                closedRxSaved += rxSaved;
                 m_b2bEndpoints.erase(it);
                 break;
             }
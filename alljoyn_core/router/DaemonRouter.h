@@ -367,6 +367,32 @@ class DaemonRouter : public Router {
      */
     RuleTable& GetRuleTable() { return ruleTable; }
 
+    /**
+     * Get the broadcast routing counters.  Dividing the number of candidate
+     * endpoints by the number of broadcast messages gives the average number
+     * of endpoints checked per broadcast message.  Like qcc::s_PerfCounters,
+     * the counters are not updated atomically so they are approximate when
+     * several threads route broadcast messages at the same time.
+     *
+     * @param[out] messages     Number of broadcast messages routed.
+     * @param[out] candidates   Total number of candidate endpoints checked for those messages.
+     */
+    void GetBroadcastStats(uint64_t& messages, uint64_t& candidates) const
+    {
+        messages = broadcastMessages;
+        candidates = broadcastCandidates;
+    }
+
+    /**
+     * Get the header compression counters of the bus-to-bus links of this
+     * routing node.  The counters include the links that have already been
+     * closed.
+     *
+     * @param[out] txSaved  Bytes saved by compressing the headers of messages sent to other routing nodes.
+     * @param[out] rxSaved  Bytes saved by compressing the headers of messages received from other routing nodes.
+     */
+    void GetHeaderCompressionStats(uint64_t& txSaved, uint64_t& rxSaved) const;
+
 
     void RegisterSelfJoin(qcc::String epName, SessionId id) {
         m_Lock.Lock(MUTEX_CONTEXT);
@@ -395,6 +421,11 @@ class DaemonRouter : public Router {
     std::set<std::pair<qcc::String, SessionId> > selfJoinEps;  /**< set of EPs that "self joined" */
     mutable qcc::Mutex m_Lock;           /**< Lock that protects internals of the DaemonRouter */
 
+    volatile uint64_t broadcastMessages;   /**< Number of broadcast messages routed */
+    volatile uint64_t broadcastCandidates; /**< Number of candidate endpoints checked for broadcast messages */
+    uint64_t closedTxSaved;                /**< Header bytes saved on sent messages by closed bus-to-bus links */
+    uint64_t closedRxSaved;                /**< Header bytes saved on received messages by closed bus-to-bus links */
+
     /**
      * Helper function to determine if a message can be delivered over a given
      * session from the source to the destination.
@@ -94,6 +94,7 @@ void NameTable::AddUniqueName(BusEndpoint& endpoint)
     lock.Lock(MUTEX_CONTEXT);
     UniqueNameEntry entry = { endpoint, nameTransfer };
     uniqueNames[uniqueName] = entry;
+    PublishSnapshot();
     lock.Unlock(MUTEX_CONTEXT);
 
     /* Notify listeners */
@@ -158,6 +159,7 @@ void NameTable::RemoveUniqueName(const qcc::String& uniqueName)
             uniqueNames.erase(it);
             QCC_DbgPrintf(("Removed ep=%s from name table", uniqueName.c_str()));
         }
+        PublishSnapshot();
 
         lock.Unlock(MUTEX_CONTEXT);
         /* Notify listeners */
@@ -228,6 +230,10 @@ QStatus NameTable::AddAlias(const qcc::String& aliasName,
                 origOwnerNameTransfer = vit->second.nameTransfer;
             }
         }
+        /* Only a change of primary owner affects the snapshot */
+        if (newOwner) {
+            PublishSnapshot();
+        }
         lock.Unlock(MUTEX_CONTEXT);
 
         if (listener) {
@@ -294,6 +300,9 @@ void NameTable::RemoveAlias(const qcc::String& aliasName,
     } else {
         disposition = DBUS_RELEASE_NAME_REPLY_NON_EXISTENT;
     }
+    if (!oldOwner.empty()) {
+        PublishSnapshot();
+    }
 
     lock.Unlock(MUTEX_CONTEXT);
 
@@ -331,31 +340,16 @@ bool NameTable::IsValidLocalUniqueName(const qcc::String& uniqueName) const
 
 BusEndpoint NameTable::FindEndpoint(const qcc::String& busName) const
 {
-    BusEndpoint ep;
+    return GetSnapshot()->FindEndpoint(busName);
+}
 
-    lock.Lock(MUTEX_CONTEXT);
-    if (busName[0] == ':') {
-        UniqueNameMap::const_iterator it = uniqueNames.find(busName);
-        if (it != uniqueNames.end()) {
-            ep = it->second.endpoint;
-        }
-    } else {
-        unordered_map<string, deque<NameQueueEntry> >::const_iterator it = aliasNames.find(busName);
-        if (it != aliasNames.end()) {
-            QCC_ASSERT(!it->second.empty());
-            ep = FindEndpoint(it->second[0].endpointName);
-        }
-        /* Fallback to virtual (remote) aliases if a suitable local one cannot be found */
-        if (!ep->IsValid()) {
-            map<std::string, VirtualAliasEntry>::const_iterator vit = virtualAliasNames.find(busName);
-            if (vit != virtualAliasNames.end()) {
-                VirtualEndpoint vep = vit->second.endpoint;
-                ep = BusEndpoint::cast(vep);
-            }
-        }
+BusEndpoint NameTable::Snapshot::FindEndpoint(const qcc::String& busName) const
+{
+    unordered_map<string, BusEndpoint>::const_iterator it = routes.find(busName);
+    if (it != routes.end()) {
+        return it->second;
     }
-    lock.Unlock(MUTEX_CONTEXT);
-    return ep;
+    return BusEndpoint();
 }
 
 void NameTable::GetBusNames(vector<qcc::String>& names) const
@@ -434,70 +428,63 @@ void NameTable::GetUniqueNamesAndAliases(vector<pair<qcc::String, vector<qcc::St
 
 void NameTable::GetAllBusEndpoints(vector<BusEndpoint>& eps) const
 {
-    lock.Lock(MUTEX_CONTEXT);
-    eps.clear();
-    eps.reserve(uniqueNames.size());
-    UniqueNameMap::const_iterator it = uniqueNames.begin();
-    while (it != uniqueNames.end()) {
-        const UniqueNameEntry& entry = it->second;
-        eps.push_back(entry.endpoint);
-        ++it;
-    }
-    lock.Unlock(MUTEX_CONTEXT);
+    eps = GetSnapshot()->GetAllBusEndpoints();
 }
 
-String NameTable::GetNameOwner(const String& name) const
+const qcc::String* NameTable::Snapshot::GetNameOwner(const qcc::String& name) const
 {
-    String un;
-    lock.Lock(MUTEX_CONTEXT);
-    AliasMap::const_iterator aliasit = aliasNames.find(name);
-    if (aliasit != aliasNames.end()) {
-        if (aliasit->second.begin() != aliasit->second.end()) {
-            // current owner is at the front of the deque
-            un = aliasit->second.begin()->endpointName;
-        }
-    } else {
-        // virtual alias maybe??
-        map<std::string, VirtualAliasEntry>::const_iterator valiasit = virtualAliasNames.find(name);
-        if (valiasit != virtualAliasNames.end()) {
-            un = valiasit->second.endpoint->GetUniqueName();
-        }
+    if (name[0] == ':') {
+        /* name is already a unique name */
+        return &name;
     }
-    lock.Unlock(MUTEX_CONTEXT);
-    return un;
+    unordered_map<string, qcc::String>::const_iterator it = owners.find(name);
+    return (it != owners.end()) ? &it->second : NULL;
 }
 
+bool NameTable::IsAlias(const String& name1, const String& name2) const
+{
+    return GetSnapshot()->IsAlias(name1, name2);
+}
 
-bool NameTable::IsAlias(const String name1, const String name2) const
+bool NameTable::Snapshot::IsAlias(const String& name1, const String& name2) const
 {
     QCC_DbgTrace(("NameTable::IsAlias(name1 = '%s', name2 = '%s')", name1.c_str(), name2.c_str()));
 
-    String un1;
-    String un2;
-    if (name1[0] == ':') {
-        // name1 is already a unique name
-        un1 = name1;
-    } else {
-        un1 = GetNameOwner(name1);
-        if (un1.empty()) {
-            // No owner found.  Use value guaranteed to no match.
-            un1 = "1";
-        }
-    }
+    /* Names without an owner never match */
+    const String* un1 = GetNameOwner(name1);
+    const String* un2 = GetNameOwner(name2);
+    bool isAlias = un1 && un2 && (*un1 == *un2);
 
-    if (name2[0] == ':') {
-        // name2 is already a unique name
-        un2 = name2;
-    } else {
-        un2 = GetNameOwner(name2);
-        if (un2.empty()) {
-            // No owner found.  Use value guaranteed to no match.
-            un2 = "2";
+    QCC_DbgTrace(("     '%s' == '%s' => %u", un1 ? un1->c_str() : "", un2 ? un2->c_str() : "", isAlias));
+    return isAlias;
+}
+
+void NameTable::PublishSnapshot()
+{
+    std::shared_ptr<Snapshot> next = std::make_shared<Snapshot>();
+
+    next->endpoints.reserve(uniqueNames.size());
+    for (UniqueNameMap::const_iterator it = uniqueNames.begin(); it != uniqueNames.end(); ++it) {
+        next->routes[it->first] = it->second.endpoint;
+        next->endpoints.push_back(it->second.endpoint);
+    }
+    /* Locally requested aliases mask virtual (remote) aliases of the same name */
+    for (map<std::string, VirtualAliasEntry>::const_iterator vit = virtualAliasNames.begin(); vit != virtualAliasNames.end(); ++vit) {
+        VirtualEndpoint vep = vit->second.endpoint;
+        next->routes[vit->first] = BusEndpoint::cast(vep);
+        next->owners[vit->first] = vep->GetUniqueName();
+    }
+    for (AliasMap::const_iterator ait = aliasNames.begin(); ait != aliasNames.end(); ++ait) {
+        QCC_ASSERT(!ait->second.empty());
+        const String& primary = ait->second.front().endpointName;
+        next->owners[ait->first] = primary;
+        UniqueNameMap::const_iterator uit = uniqueNames.find(primary);
+        if (uit != uniqueNames.end()) {
+            next->routes[ait->first] = uit->second.endpoint;
         }
     }
 
-    QCC_DbgTrace(("     '%s' == '%s' => %u", un1.c_str(), un2.c_str(), un1 == un2));
-    return un1 == un2;
+    std::atomic_store(&snapshot, std::shared_ptr<const Snapshot>(next));
 }
 
 void NameTable::GetQueuedNames(const qcc::String& busName, std::vector<qcc::String>& names)
@@ -581,6 +568,7 @@ void NameTable::RemoveVirtualAliases(const qcc::String& epName)
                 String alias = vit->first.c_str();
                 SessionOpts::NameTransferType nameTransfer = vit->second.nameTransfer;
                 virtualAliasNames.erase(vit++);
+                PublishSnapshot();
                 if (aliasNames.find(alias) == aliasNames.end()) {
                     lock.Unlock(MUTEX_CONTEXT);
                     CallListeners(alias,
@@ -650,6 +638,7 @@ bool NameTable::SetVirtualAlias(const qcc::String& alias,
     if (newOwner && (*newOwner)->IsValid()) {
         newName = (*newOwner)->GetUniqueName();
     }
+    PublishSnapshot();
 
     lock.Unlock(MUTEX_CONTEXT);
 
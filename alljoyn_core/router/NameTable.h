@@ -25,6 +25,7 @@
 #include <qcc/platform.h>
 
 #include <deque>
+#include <memory>
 #include <vector>
 #include <set>
 
@@ -64,10 +65,61 @@ class NameTable {
      */
     typedef void (*RemoveAliasComplete)(qcc::String& busName, uint32_t disposition, void* context);
 
+    /**
+     * Immutable view of the names in the table and the endpoints they resolve to.
+     * A new snapshot is published whenever the table changes so that readers on the
+     * routing path never need to take the name table lock.
+     */
+    class Snapshot {
+      public:
+
+        /**
+         * Find an endpoint for a given unique or alias bus name.
+         *
+         * @param busName   Name of bus.
+         * @return  Returns the endpoint if it was found or an invalid endpoint if not found
+         */
+        BusEndpoint FindEndpoint(const qcc::String& busName) const;
+
+        /**
+         * Determine if 2 bus names are aliases for the same endpoint.
+         *
+         * @param       name1   Bus name for alias check
+         * @param       name2   Bus name for alias check
+         *
+         * @return  true if name1 and name2 are aliases of each other, false otherwise
+         */
+        bool IsAlias(const qcc::String& name1, const qcc::String& name2) const;
+
+        /**
+         * Get all the bus endpoints in the snapshot.
+         *
+         * @return  Vector of BusEndpoints.
+         */
+        const std::vector<BusEndpoint>& GetAllBusEndpoints() const { return endpoints; }
+
+      private:
+        friend class NameTable;
+
+        const qcc::String* GetNameOwner(const qcc::String& name) const;
+
+        std::unordered_map<std::string, BusEndpoint> routes;    /**< Unique and alias names mapped to the endpoint they route to */
+        std::unordered_map<std::string, qcc::String> owners;    /**< Alias names mapped to the unique name of their owner */
+        std::vector<BusEndpoint> endpoints;                     /**< Endpoints of all unique names */
+    };
+
     /**
      * Constructor
      */
-    NameTable() : lock(qcc::LOCK_LEVEL_NAMETABLE_LOCK), uniqueId(0), uniquePrefix(":1.") { }
+    NameTable() : lock(qcc::LOCK_LEVEL_NAMETABLE_LOCK), uniqueId(0), uniquePrefix(":1."), snapshot(std::make_shared<Snapshot>()) { }
+
+    /**
+     * Get the current snapshot of the name table. The snapshot stays valid for as long as
+     * the caller holds it but does not reflect later changes to the table.
+     *
+     * @return  The current snapshot.
+     */
+    std::shared_ptr<const Snapshot> GetSnapshot() const { return std::atomic_load(&snapshot); }
 
     /**
      * Set the GUID of the bus.
@@ -222,7 +274,7 @@ class NameTable {
      *
      * @return  true if name1 and name2 are aliases of each other, false otherwise
      */
-    bool IsAlias(const qcc::String name1, const qcc::String name2) const;
+    bool IsAlias(const qcc::String& name1, const qcc::String& name2) const;
 
     /**
      * Get all the unique names that are in queue for the same alias (well-known) name
@@ -267,6 +319,8 @@ class NameTable {
     uint32_t uniqueId;
     qcc::String uniquePrefix;
 
+    std::shared_ptr<const Snapshot> snapshot;   /**< Current snapshot of the name tables */
+
     typedef qcc::ManagedObj<NameListener*> ProtectedNameListener;
     std::set<ProtectedNameListener> listeners;                         /**< Listeners regsitered with name table */
     std::map<std::string, VirtualAliasEntry> virtualAliasNames;    /**< map of virtual aliases to virtual endpts */
@@ -300,7 +354,11 @@ class NameTable {
                        const qcc::String* oldOwner, SessionOpts::NameTransferType oldOwnerNameTransfer,
                        const qcc::String* newOwner, SessionOpts::NameTransferType newOwnerNameTransfer);
 
-    qcc::String GetNameOwner(const qcc::String& name) const;
+    /**
+     * Publish a new snapshot of the name tables. Must be called with the lock held
+     * after every change that affects the snapshot.
+     */
+    void PublishSnapshot();
 };
 
 /**
@@ -41,6 +41,7 @@ QStatus RuleTable::AddRule(BusEndpoint& endpoint, const Rule& rule)
     QCC_DbgPrintf(("AddRule for endpoint %s\n  %s", endpoint->GetUniqueName().c_str(), rule.ToString().c_str()));
     lock.Lock(MUTEX_CONTEXT);
     rules.insert(std::pair<BusEndpoint, Rule>(endpoint, rule));
+    IndexRule(endpoint, rule);
     lock.Unlock(MUTEX_CONTEXT);
     return ER_OK;
 }
@@ -52,6 +53,8 @@ QStatus RuleTable::RemoveRule(BusEndpoint& endpoint, Rule& rule)
     std::pair<RuleIterator, RuleIterator> range = rules.equal_range(endpoint);
     while (range.first != range.second) {
         if (range.first->second == rule) {
+            /* Unindex the stored rule since Rule::operator== ignores some fields */
+            UnindexRule(range.first->first, range.first->second);
             const RuleIterator begin = range.first;
             const RuleIterator end = ++range.first;
             rules.erase(begin, end);
@@ -69,6 +72,9 @@ QStatus RuleTable::RemoveAllRules(BusEndpoint& endpoint)
     lock.Lock(MUTEX_CONTEXT);
     std::pair<RuleIterator, RuleIterator> range = rules.equal_range(endpoint);
     if (range.first != rules.end()) {
+        for (RuleIterator it = range.first; it != range.second; ++it) {
+            UnindexRule(it->first, it->second);
+        }
         rules.erase(range.first, range.second);
     }
     lock.Unlock(MUTEX_CONTEXT);
@@ -106,5 +112,89 @@ bool RuleTable::OkToSend(const Message& msg, BusEndpoint& endpoint) const
     return match;
 }
 
+void RuleTable::AddCandidates(const RuleIndex& index, const char* key, set<BusEndpoint>& candidates)
+{
+    if (key && (*key != '\0')) {
+        RuleIndex::const_iterator it = index.find(key);
+        if (it != index.end()) {
+            for (EndpointRuleCount::const_iterator eit = it->second.begin(); eit != it->second.end(); ++eit) {
+                candidates.insert(eit->first);
+            }
+        }
+    }
+}
+
+void RuleTable::GetCandidateEndpoints(const Message& msg, set<BusEndpoint>& candidates) const
+{
+    lock.Lock(MUTEX_CONTEXT);
+    AddCandidates(ifaceIndex, msg->GetInterface(), candidates);
+    AddCandidates(memberIndex, msg->GetMemberName(), candidates);
+    AddCandidates(pathIndex, msg->GetObjectPath(), candidates);
+    AddCandidates(senderIndex, msg->GetSender(), candidates);
+    for (EndpointRuleCount::const_iterator it = wildcardRules.begin(); it != wildcardRules.end(); ++it) {
+        candidates.insert(it->first);
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+RuleTable::RuleIndex* RuleTable::SelectIndex(const Rule& rule, const qcc::String*& key)
+{
+    if (!rule.iface.empty()) {
+        key = &rule.iface;
+        return &ifaceIndex;
+    } else if (!rule.member.empty()) {
+        key = &rule.member;
+        return &memberIndex;
+    } else if (!rule.path.empty()) {
+        key = &rule.path;
+        return &pathIndex;
+    } else if (!rule.sender.empty()) {
+        key = &rule.sender;
+        return &senderIndex;
+    }
+    key = NULL;
+    return NULL;
+}
+
+void RuleTable::IndexRule(const BusEndpoint& endpoint, const Rule& rule)
+{
+    /* Rules for sessionless signals never allow delivery through OkToSend() */
+    if (rule.sessionless == Rule::SESSIONLESS_TRUE) {
+        return;
+    }
+    const qcc::String* key;
+    RuleIndex* index = SelectIndex(rule, key);
+    if (index) {
+        ++(*index)[*key][endpoint];
+    } else {
+        ++wildcardRules[endpoint];
+    }
+}
+
+void RuleTable::UnindexRule(const BusEndpoint& endpoint, const Rule& rule)
+{
+    if (rule.sessionless == Rule::SESSIONLESS_TRUE) {
+        return;
+    }
+    const qcc::String* key;
+    RuleIndex* index = SelectIndex(rule, key);
+    EndpointRuleCount* counts = &wildcardRules;
+    RuleIndex::iterator iit;
+    if (index) {
+        iit = index->find(*key);
+        if (iit == index->end()) {
+            return;
+        }
+        counts = &iit->second;
+    }
+    EndpointRuleCount::iterator cit = counts->find(endpoint);
+    if ((cit != counts->end()) && (--cit->second == 0)) {
+        counts->erase(cit);
+        if (index && counts->empty()) {
+            index->erase(iit);
+        }
+    }
+}
+
 
 }
@@ -25,8 +25,14 @@
 #define _ALLJOYN_RULETABLE_H
 
 #include <qcc/platform.h>
+
+#include <map>
+#include <set>
+#include <string>
+
 #include <qcc/Mutex.h>
 #include <qcc/LockLevel.h>
+#include <qcc/STLContainer.h>
 
 #include "BusEndpoint.h"
 #include "Rule.h"
@@ -138,9 +144,61 @@ class RuleTable {
      */
     bool OkToSend(const Message& msg, BusEndpoint& endpoint) const;
 
+    /**
+     * Get the endpoints that have at least one rule that could match the
+     * given message.  The lookup is done through an index of the rules by
+     * interface, member, object path and sender so its cost is proportional
+     * to the number of candidates rather than the number of rules.  The result
+     * is a superset of the endpoints for which OkToSend() returns true so the
+     * caller must still call OkToSend() on each candidate.
+     *
+     * @param   msg         Message that may be delivered.
+     * @param   candidates  [OUT] Endpoints with potentially matching rules.
+     */
+    void GetCandidateEndpoints(const Message& msg, std::set<BusEndpoint>& candidates) const;
+
   private:
+    /** Number of rules an endpoint has filed under the same index key */
+    typedef std::map<BusEndpoint, uint32_t> EndpointRuleCount;
+
+    /** Index of rule keys to the endpoints with rules filed under that key */
+    typedef std::unordered_map<std::string, EndpointRuleCount> RuleIndex;
+
+    /**
+     * Select the index and key a rule is filed under.  Each rule is filed
+     * under exactly one key, taken from the most selective field the rule
+     * specifies.  Rules that specify none of the indexed fields are filed
+     * under the wildcard entry.
+     *
+     * @param rule   Rule to file.
+     * @param key    [OUT] Key of the rule in the returned index.
+     * @return  The index for the rule or NULL for the wildcard entry.
+     */
+    RuleIndex* SelectIndex(const Rule& rule, const qcc::String*& key);
+
+    /**
+     * Add a rule to the index.  Caller must hold the lock.
+     */
+    void IndexRule(const BusEndpoint& endpoint, const Rule& rule);
+
+    /**
+     * Remove a rule from the index.  Caller must hold the lock.
+     */
+    void UnindexRule(const BusEndpoint& endpoint, const Rule& rule);
+
+    /**
+     * Add the endpoints filed under a key of an index to a candidate set.
+     */
+    static void AddCandidates(const RuleIndex& index, const char* key, std::set<BusEndpoint>& candidates);
+
     mutable qcc::Mutex lock;                   /**< Lock protecting rule table */
     std::multimap<BusEndpoint, Rule> rules;    /**< Rule table */
+
+    RuleIndex ifaceIndex;                      /**< Rules filed by interface */
+    RuleIndex memberIndex;                     /**< Rules filed by member (no interface) */
+    RuleIndex pathIndex;                       /**< Rules filed by object path (no interface or member) */
+    RuleIndex senderIndex;                     /**< Rules filed by sender (no interface, member or path) */
+    EndpointRuleCount wildcardRules;           /**< Rules that specify none of the indexed fields */
 };
 
 }
@@ -450,12 +450,7 @@ void SessionlessObj::PushMessageWork::Run()
     String key = MakeSessionlessMessageKey(msg->GetSender(), msg->GetInterface(), msg->GetMemberName(), msg->GetObjectPath());
     slObj.advanceChangeId = true;
     slm->changeId = slObj.curChangeId;
-    LocalCache::iterator it = slObj.localCache.find(key);
-    if (it == slObj.localCache.end()) {
-        slObj.localCache.insert(pair<String, SessionlessMessage>(key, slm));
-    } else {
-        it->second = slm;
-    }
+    slObj.AddToLocalCache(key, slm);
 
     slObj.lock.Unlock();
     slObj.router.UnlockNameTable();
@@ -605,7 +600,7 @@ void SessionlessObj::CancelMessageWork::Run()
             if (!it->second->msg->IsExpired()) {
                 status = ER_OK;
             }
-            slObj.localCache.erase(it);
+            slObj.EraseFromLocalCache(it);
             break;
         }
         ++it;
@@ -660,7 +655,7 @@ void SessionlessObj::NameOwnerChangedWork::Run()
     String key = MakeSessionlessMessageKey(oldOwner.c_str(), "", "", "");
     LocalCache::iterator mit = slObj.localCache.lower_bound(key);
     while ((mit != slObj.localCache.end()) && (::strcmp(oldOwner.c_str(), mit->second->msg->GetSender()) == 0)) {
-        slObj.localCache.erase(mit++);
+        slObj.EraseFromLocalCache(mit++);
     }
 
     /* Stop discovery if nobody is looking for sessionless signals */
@@ -873,7 +868,6 @@ void SessionlessObj::HandleRangeRequest(const char* sender, SessionId sid,
                                         std::vector<qcc::String> remoteRules)
 {
     QStatus status = ER_OK;
-    bool messageErased = false;
     QCC_DbgTrace(("SessionlessObj::HandleControlSignal(%d, %d)", fromChangeId, toChangeId));
 
     /* Advance the curChangeId */
@@ -884,47 +878,51 @@ void SessionlessObj::HandleRangeRequest(const char* sender, SessionId sid,
         advanceChangeId = false;
     }
 
-    /* Send all messages in local cache in range [fromChangeId, toChangeId) */
-    LocalCache::iterator it = localCache.begin();
-    uint32_t rangeLen = toChangeId - fromChangeId;
-    while (it != localCache.end()) {
-        SessionlessMessage slm = it->second;
-        if (IN_WINDOW(uint32_t, fromChangeId, rangeLen, slm->changeId)) {
-            String key = it->first;
-            if (slm->msg->IsExpired()) {
-                /* Remove expired message without sending */
-                localCache.erase(it++);
-                messageErased = true;
-            } else if (sid != 0) {
-                /* Send message to remote destination */
-                bool isMatch = remoteRules.empty();
-                for (vector<String>::iterator rit = remoteRules.begin(); !isMatch && (rit != remoteRules.end()); ++rit) {
-                    Rule rule(rit->c_str());
-                    isMatch = rule.IsMatch(slm->msg) || (rule == legacyRule);
+    /* Get the messages in local cache in range [fromChangeId, toChangeId) */
+    vector<SessionlessMessage> messages;
+    bool messageErased = GetLocalCacheRange(fromChangeId, toChangeId, messages);
+
+    if (sid != 0) {
+        /* Parse the remote rules once for all of the messages */
+        vector<Rule> remoteMatchRules;
+        bool matchAll = remoteRules.empty();
+        for (vector<String>::iterator rit = remoteRules.begin(); !matchAll && (rit != remoteRules.end()); ++rit) {
+            Rule rule(rit->c_str());
+            if (rule == legacyRule) {
+                matchAll = true;
+            } else {
+                remoteMatchRules.push_back(rule);
+            }
+        }
+
+        /* Send the matching messages to the remote destination */
+        vector<SessionlessMessage> matching;
+        BusEndpoint ep = router.FindEndpoint(sender);
+        if (ep->IsValid()) {
+            for (vector<SessionlessMessage>::iterator mit = messages.begin(); mit != messages.end(); ++mit) {
+                bool isMatch = matchAll;
+                for (vector<Rule>::iterator rit = remoteMatchRules.begin(); !isMatch && (rit != remoteMatchRules.end()); ++rit) {
+                    isMatch = rit->IsMatch((*mit)->msg, (*mit)->cachedWhoImplements);
                 }
                 if (isMatch) {
-                    BusEndpoint ep = router.FindEndpoint(sender);
-                    if (ep->IsValid()) {
-                        lock.Unlock();
-                        router.UnlockNameTable();
-                        QCC_DbgPrintf(("Send cid=%u,serialNum=%u to sid=%u", slm->changeId, slm->msg->GetCallSerial(), sid));
-                        SendThroughEndpoint(slm->msg, ep, sid);
-                        router.LockNameTable();
-                        lock.Lock();
-                    }
+                    matching.push_back(*mit);
                 }
-                it = localCache.upper_bound(key);
-            } else {
-                /* Send message to local destination */
-                SendMatchingThroughEndpoint(sid, slm, fromLocalRulesId, toLocalRulesId);
-                it = localCache.upper_bound(key);
             }
-        } else {
-            ++it;
         }
+        lock.Unlock();
+        router.UnlockNameTable();
+        for (vector<SessionlessMessage>::iterator mit = matching.begin(); mit != matching.end(); ++mit) {
+            QCC_DbgPrintf(("Send cid=%u,serialNum=%u to sid=%u", (*mit)->changeId, (*mit)->msg->GetCallSerial(), sid));
+            SendThroughEndpoint((*mit)->msg, ep, sid);
+        }
+    } else {
+        /* Send the messages to local destinations */
+        for (vector<SessionlessMessage>::iterator mit = messages.begin(); mit != messages.end(); ++mit) {
+            SendMatchingThroughEndpoint(sid, *mit, fromLocalRulesId, toLocalRulesId);
+        }
+        lock.Unlock();
+        router.UnlockNameTable();
     }
-    lock.Unlock();
-    router.UnlockNameTable();
 
     /* Alert the advertiser worker */
     if (messageErased) {
@@ -944,6 +942,60 @@ void SessionlessObj::HandleRangeRequest(const char* sender, SessionId sid,
     }
 }
 
+void SessionlessObj::AddToLocalCache(const String& key, SessionlessMessage& slm)
+{
+    LocalCache::iterator it = localCache.find(key);
+    if (it == localCache.end()) {
+        localCache.insert(pair<String, SessionlessMessage>(key, slm));
+    } else {
+        changeIdIndex.erase(pair<uint32_t, String>(it->second->changeId, key));
+        it->second = slm;
+    }
+    changeIdIndex.insert(pair<uint32_t, String>(slm->changeId, key));
+}
+
+void SessionlessObj::EraseFromLocalCache(LocalCache::iterator it)
+{
+    changeIdIndex.erase(pair<uint32_t, String>(it->second->changeId, it->first));
+    localCache.erase(it);
+}
+
+bool SessionlessObj::GetLocalCacheRange(uint32_t fromId, uint32_t toId, vector<SessionlessMessage>& messages)
+{
+    /*
+     * The range may wrap around, in which case it is the two ranges [fromId, max]
+     * and [0, toId).  An empty range is indicated by fromId == toId.
+     */
+    vector<String> keys;
+    if (fromId != toId) {
+        ChangeIdIndex::iterator it = changeIdIndex.lower_bound(pair<uint32_t, String>(fromId, String()));
+        ChangeIdIndex::iterator end = changeIdIndex.lower_bound(pair<uint32_t, String>(toId, String()));
+        if (toId < fromId) {
+            for (; it != changeIdIndex.end(); ++it) {
+                keys.push_back(it->second);
+            }
+            it = changeIdIndex.begin();
+        }
+        for (; it != end; ++it) {
+            keys.push_back(it->second);
+        }
+    }
+
+    bool messageErased = false;
+    messages.reserve(keys.size());
+    for (vector<String>::iterator kit = keys.begin(); kit != keys.end(); ++kit) {
+        LocalCache::iterator it = localCache.find(*kit);
+        if (it->second->msg->IsExpired()) {
+            /* Remove expired message without sending */
+            EraseFromLocalCache(it);
+            messageErased = true;
+        } else {
+            messages.push_back(it->second);
+        }
+    }
+    return messageErased;
+}
+
 void SessionlessObj::AlarmTriggered(const Alarm& alarm, QStatus reason)
 {
     QCC_DbgTrace(("SessionlessObj::AlarmTriggered(alarm, %s)", QCC_StatusText(reason)));
@@ -966,7 +1018,7 @@ void SessionlessObj::AlarmTriggered(const Alarm& alarm, QStatus reason)
         LocalCache::iterator it = localCache.begin();
         while (it != localCache.end()) {
             if (it->second->msg->IsExpired(&expire)) {
-                localCache.erase(it++);
+                EraseFromLocalCache(it++);
             } else {
                 ++it;
             }
@@ -26,6 +26,7 @@
 #include <map>
 #include <set>
 #include <queue>
+#include <vector>
 
 #include <qcc/String.h>
 #include <qcc/Timer.h>
@@ -394,6 +395,37 @@ class SessionlessObj : public BusObject, public NameListener, public SessionList
     /** Storage for sessionless messages waiting to be delivered */
     LocalCache localCache;
 
+    typedef std::set<std::pair<uint32_t, qcc::String> > ChangeIdIndex;
+    /** The keys of the messages in localCache ordered by changeId */
+    ChangeIdIndex changeIdIndex;
+
+    /**
+     * Add a message to the local cache, replacing any message with the same key.
+     *
+     * @param key  The key of the message.
+     * @param slm  The message, with its changeId set.
+     */
+    void AddToLocalCache(const qcc::String& key, SessionlessMessage& slm);
+
+    /**
+     * Remove a message from the local cache.
+     *
+     * @param it  The message to remove.
+     */
+    void EraseFromLocalCache(LocalCache::iterator it);
+
+    /**
+     * Get the cached messages with a changeId in the range [fromId, toId).
+     * Expired messages in the range are removed from the cache instead.
+     *
+     * @param fromId         Beginning of changeId range (inclusive)
+     * @param toId           End of changeId range (exclusive)
+     * @param[out] messages  The unexpired messages in the range, ordered by changeId.
+     *
+     * @return true if any expired messages were removed.
+     */
+    bool GetLocalCacheRange(uint32_t fromId, uint32_t toId, std::vector<SessionlessMessage>& messages);
+
     struct RoutedMessage {
         RoutedMessage(const Message& msg) : sender(msg->GetSender()), serial(msg->GetCallSerial()) { }
         qcc::String sender;
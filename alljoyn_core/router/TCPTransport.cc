@@ -283,26 +283,36 @@
  * that an endpoint is not brought up immediately, but an authentication step
  * must be performed.  The server accept loop starts this process by placing the
  * new TCPEndpoint on an authList, or list of authenticating endpoints.
- * It then calls the endpoint Authenticate() method which spins up an
- * authentication thread and returns immediately.  This process transfers the
- * responsibility for the connection and its resources to the authentication
- * thread.  Authentication can succeed, fail, or take to long and be aborted.
+ * It then calls the endpoint Authenticate() method which registers the
+ * endpoint stream with the authentication IODispatch and returns immediately.
+ * This process transfers the responsibility for the connection and its
+ * resources to the authentication dispatcher.  Authentication can succeed,
+ * fail, or take to long and be aborted.
  *
- * If authentication succeeds, the authentication thread calls back into the
- * TCPTransport's Authenticated() method.  Along with indicating that
- * authentication has completed successfully, this transfers ownership of the
- * TCPEndpoint back to the TCPTransport from the authentication
- * thread.  At this time, the TCPEndpoint is Start()ed which spins up
- * the transmit and receive threads and enables Message routing across the
- * transport.
+ * There is no thread per authenticating connection.  The SASL and Hello
+ * exchange is run as a non-blocking state machine (see
+ * _RemoteEndpoint::EstablishNonBlocking()) that is advanced from the read
+ * callbacks of the authentication IODispatch whenever bytes arrive.  That
+ * IODispatch runs its callbacks on a fixed pool of "tcp_auth_workers"
+ * threads, so a storm of incoming connections costs sockets and memory but
+ * not threads.  The blocking work left in the handshake (short writes of
+ * SASL lines and the Hello reply, and starting the endpoint once it is
+ * authenticated) is done on that same bounded pool.
+ *
+ * When the handshake finishes, one way or the other, the read callback stops
+ * the stream on the authentication IODispatch.  Its exit callback is the
+ * single place the outcome is acted on.  If authentication succeeded it calls
+ * back into the TCPTransport's Authenticated() method.  Along with indicating
+ * that authentication has completed successfully, this transfers ownership of
+ * the TCPEndpoint back to the TCPTransport.  At this time, the TCPEndpoint is
+ * Start()ed which hands the stream to the bus IODispatch and enables Message
+ * routing across the transport.
  *
- * If the authentication fails, the authentication thread simply sets a the
- * TCPEndpoint state to FAILED and exits.  The server accept loop looks at
- * authenticating endpoints (those on the authList)each time through its loop.
- * If an endpoint has failed authentication, and its thread has actually gone
- * away (or more precisely is at least going away in such a way that it will
- * never touch the endpoint data structure again).  This means that the endpoint
- * can be deleted.
+ * If the authentication fails, the exit callback simply sets the TCPEndpoint
+ * state to FAILED.  The server accept loop looks at authenticating endpoints
+ * (those on the authList) each time through its loop.  If an endpoint has
+ * failed authentication it is joined (which waits for the authentication
+ * IODispatch to forget the stream) and the endpoint can be deleted.
  *
  * If the authentication takes "too long" we assume that a denial of service
  * attack in in progress.  We call AuthStop() on such an endpoint which will most
@@ -411,22 +421,21 @@ class _TCPEndpoint : public _RemoteEndpoint {
   public:
     friend class TCPTransport;
     /**
-     * There are three threads that can be running around in this data
-     * structure.  An auth thread is run before the endpoint is started in order
-     * to handle the security stuff that must be taken care of before messages
-     * can start passing.  This enum reflects the states of the authentication
-     * process and the state can be found in m_authState.  Once authentication
-     * is complete, the auth thread must go away, but it must also be joined,
-     * which is indicated by the AUTH_DONE state.  The state of Read and Write
-     * callbacks is dealt with by the EndpointState.
+     * Before the endpoint is started, the authentication IODispatch drives
+     * the security stuff that must be taken care of before messages can start
+     * passing.  This enum reflects the states of the authentication process
+     * and the state can be found in m_authState.  Once authentication is
+     * complete, the stream must be released by the authentication IODispatch
+     * and joined, which is indicated by the AUTH_DONE state.  The state of
+     * Read and Write callbacks is dealt with by the EndpointState.
      */
     enum AuthState {
         AUTH_ILLEGAL = 0,
-        AUTH_INITIALIZED,    /**< This endpoint structure has been allocated but no auth thread has been run */
-        AUTH_AUTHENTICATING, /**< We have spun up an authentication thread and it has begun running our user function */
-        AUTH_FAILED,         /**< The authentication has failed and the authentication thread is exiting immidiately */
+        AUTH_INITIALIZED,    /**< This endpoint structure has been allocated but authentication has not started */
+        AUTH_AUTHENTICATING, /**< The stream is registered with the authentication IODispatch */
+        AUTH_FAILED,         /**< The authentication has failed and the authentication IODispatch is done with the endpoint */
         AUTH_SUCCEEDED,      /**< The auth process (Establish) has succeeded and the connection is ready to be started */
-        AUTH_DONE,           /**< The auth thread has been successfully shut down and joined */
+        AUTH_DONE,           /**< The authentication IODispatch has released the stream and been joined */
     };
 
     /**
@@ -435,8 +444,8 @@ class _TCPEndpoint : public _RemoteEndpoint {
      * Read and Write callbacks are used to pump
      * messages through an endpoint.  These callbacks cannot be run until the
      * authentication process has completed.  This enum reflects the states of
-     * the endpoint Read and WriteCallbacks and can be found in m_epState.  The auth
-     * thread is dealt with by the AuthState enum above.  These callbacks must cease
+     * the endpoint Read and WriteCallbacks and can be found in m_epState.  The
+     * authentication is dealt with by the AuthState enum above.  These callbacks must cease
      * to occur once the endpoint has completely exited, which is indicated by the EP_DONE state.
      */
     enum EndpointState {
@@ -476,7 +485,9 @@ class _TCPEndpoint : public _RemoteEndpoint {
         m_authState(AUTH_INITIALIZED),
         m_epState(EP_INITIALIZED),
         m_tStart(qcc::Timespec<qcc::MonotonicTime>(0)),
-        m_authThread(this),
+        m_authHandler(this),
+        m_authStatus(ER_TIMEOUT),
+        m_authFirstByte(false),
         m_stream(sock),
         m_ipAddr(ipAddr),
         m_port(port) { }
@@ -493,7 +504,9 @@ class _TCPEndpoint : public _RemoteEndpoint {
         m_authState(AUTH_INITIALIZED),
         m_epState(EP_INITIALIZED),
         m_tStart(qcc::Timespec<qcc::MonotonicTime>(0)),
-        m_authThread(this),
+        m_authHandler(this),
+        m_authStatus(ER_TIMEOUT),
+        m_authFirstByte(false),
         m_stream(family, type),
         m_ipAddr(ipAddr),
         m_port(port) { }
@@ -517,7 +530,7 @@ class _TCPEndpoint : public _RemoteEndpoint {
 
     void SetStartTime(qcc::Timespec<qcc::MonotonicTime> tStart) { m_tStart = tStart; }
     qcc::Timespec<qcc::MonotonicTime> GetStartTime(void) { return m_tStart; }
-    QStatus Authenticate(void);
+    QStatus Authenticate(uint32_t authTimeout);
     void AuthStop(void);
     void AuthJoin(void);
     const qcc::IPAddress& GetIPAddress() { return m_ipAddr; }
@@ -622,26 +635,17 @@ class _TCPEndpoint : public _RemoteEndpoint {
         return _RemoteEndpoint::SetIdleTimeouts(reqIdleTimeout, reqProbeTimeout, maxIdleProbes);
     }
 
+  private:
     /*
-     * Return true if the auth thread is STARTED, RUNNING or STOPPING.  A true
-     * response means the authentication thread is in a state that indicates
-     * a possibility it might touch the endpoint data structure.  This means
-     * don't delete the endpoint if this method returns true.  This method
-     * indicates nothing about endpoint Read and WriteCallback state.
+     * The endpoint itself is the IODispatch listener of its running stream,
+     * so the authentication callbacks are delivered to this helper instead.
      */
-    bool IsAuthThreadRunning(void)
-    {
-        return m_authThread.IsRunning();
-    }
-    virtual void ThreadExit(qcc::Thread* thread);
-
-  private:
-    class AuthThread : public qcc::Thread {
+    class AuthHandler : public qcc::IOReadListener, public qcc::IOExitListener {
       public:
-        AuthThread(_TCPEndpoint* ep) : Thread("auth"), m_endpoint(ep)  { }
+        AuthHandler(_TCPEndpoint* ep) : m_endpoint(ep)  { }
+        QStatus ReadCallback(qcc::Source& source, bool isTimedOut);
+        void ExitCallback();
       private:
-        virtual qcc::ThreadReturn STDCALL Run(void* arg);
-
         _TCPEndpoint* m_endpoint;
     };
 
@@ -650,31 +654,43 @@ class _TCPEndpoint : public _RemoteEndpoint {
     volatile AuthState m_authState;   /**< The state of the endpoint authentication process */
     volatile EndpointState m_epState; /**< The state of the endpoint authentication process */
     qcc::Timespec<qcc::MonotonicTime> m_tStart; /**< Timestamp indicating when the authentication process started */
-    AuthThread m_authThread;          /**< Thread used to do blocking calls during startup */
+    AuthHandler m_authHandler;        /**< Receives authentication IODispatch callbacks */
+    QStatus m_authStatus;             /**< Outcome of the authentication, ER_TIMEOUT while it is in progress */
+    bool m_authFirstByte;             /**< True once the leading nul byte has been consumed */
     qcc::SocketStream m_stream;       /**< Stream used by authentication code */
     qcc::IPAddress m_ipAddr;          /**< Remote IP address. */
     uint16_t m_port;                  /**< Remote port. */
 };
 
-void _TCPEndpoint::ThreadExit(qcc::Thread* thread)
-{
-    /* If the auth thread exits before it even enters the AuthThread::Run() function, set the state to AUTH_FAILED. */
-    if (thread == &m_authThread) {
-        if (m_authState == AUTH_INITIALIZED) {
-            m_authState = AUTH_FAILED;
-        }
-        m_transport->Alert();
-    }
-    _RemoteEndpoint::ThreadExit(thread);
-}
-
-QStatus _TCPEndpoint::Authenticate(void)
+QStatus _TCPEndpoint::Authenticate(uint32_t authTimeout)
 {
     QCC_DbgTrace(("TCPEndpoint::Authenticate()"));
     /*
-     * Start the authentication thread.
+     * The SASL responses and the Hello reply are written from the read
+     * callbacks on one of the few authentication IODispatch threads.  Bound
+     * those writes by the auth timeout so a peer that never reads cannot
+     * hold on to a thread; AuthStop() cannot interrupt a blocked write.
+     * RemoteEndpoint::Start() makes the stream non-blocking again once the
+     * connection is authenticated.
      */
-    QStatus status = m_authThread.Start(this, this);
+    m_stream.SetSendTimeout(authTimeout);
+
+    /*
+     * Hand the stream to the authentication IODispatch.  From here on the
+     * handshake is advanced from its read callbacks and the outcome is
+     * reported from its exit callback.
+     */
+    IODispatch* dispatch = m_transport->m_authDispatch;
+    m_authStatus = ER_TIMEOUT;
+    m_authState = AUTH_AUTHENTICATING;
+    QStatus status = dispatch ? dispatch->StartStream(&m_stream, &m_authHandler, NULL, &m_authHandler, false, false) : ER_BUS_TRANSPORT_NOT_STARTED;
+    if (status == ER_OK) {
+        status = dispatch->EnableReadCallback(&m_stream);
+        if (status != ER_OK) {
+            dispatch->StopStream(&m_stream);
+            return status;
+        }
+    }
     if (status != ER_OK) {
         m_authState = AUTH_FAILED;
     }
@@ -686,16 +702,19 @@ void _TCPEndpoint::AuthStop(void)
     QCC_DbgTrace(("TCPEndpoint::AuthStop()"));
 
     /*
-     * Ask the auth thread to stop executing.  The only ways out of the thread
-     * run function will set the state to either AUTH_SUCCEEDED or AUTH_FAILED.
-     * There is a very small chance that we will send a stop to the thread after
-     * it has successfully authenticated, but we expect that this will result in
-     * an AUTH_FAILED state for the vast majority of cases.  In this case, we
-     * notice that the thread failed the next time through the main server run
-     * loop, join the thread via AuthJoin below and delete the endpoint.  Note
-     * that this is a lazy cleanup of the endpoint.
+     * Ask the authentication IODispatch to let go of the stream.  The only
+     * way out is through AuthHandler::ExitCallback(), which will set the
+     * state to either AUTH_SUCCEEDED or AUTH_FAILED.  There is a very small
+     * chance that we stop the stream just after it has successfully
+     * authenticated, but we expect that this will result in an AUTH_FAILED
+     * state for the vast majority of cases.  In this case, we notice that the
+     * authentication failed the next time through the main server run loop,
+     * join the stream via AuthJoin below and delete the endpoint.  Note that
+     * this is a lazy cleanup of the endpoint.
      */
-    m_authThread.Stop();
+    if (m_transport->m_authDispatch) {
+        m_transport->m_authDispatch->StopStream(&m_stream);
+    }
 }
 
 void _TCPEndpoint::AuthJoin(void)
@@ -703,172 +722,149 @@ void _TCPEndpoint::AuthJoin(void)
     QCC_DbgTrace(("TCPEndpoint::AuthJoin()"));
 
     /*
-     * Join the auth thread to stop executing.  All threads must be joined in
-     * order to communicate their return status.  The auth thread is no exception.
-     * This is done in a lazy fashion from the main server accept loop, where we
-     * cleanup every time through the loop.
+     * Wait until the authentication IODispatch has completely forgotten about
+     * the stream (which is immediate if it never knew it, as is the case for
+     * active connections).  This is done in a lazy fashion from the main
+     * server accept loop, where we cleanup every time through the loop.
      */
-    m_authThread.Join();
+    if (m_transport->m_authDispatch) {
+        m_transport->m_authDispatch->JoinStream(&m_stream);
+    }
 }
 
-void* _TCPEndpoint::AuthThread::Run(void* arg)
+QStatus _TCPEndpoint::AuthHandler::ReadCallback(qcc::Source& source, bool isTimedOut)
 {
-    QCC_UNUSED(arg);
+    QCC_UNUSED(source);
+    QCC_UNUSED(isTimedOut);
 
-    QCC_DbgTrace(("TCPEndpoint::AuthThread::Run()"));
-
-    m_endpoint->m_authState = AUTH_AUTHENTICATING;
+    QCC_DbgTrace(("TCPEndpoint::AuthHandler::ReadCallback()"));
 
     /*
-     * We're running an authentication process here and we are cooperating with
-     * the main server thread.  This thread is running in an object that is
-     * allocated on the heap, and the server is managing these objects so we
-     * need to coordinate getting all of this cleaned up.
-     *
-     * There is a state variable that only we write.  The server thread only
-     * reads this variable, so there are no data sharing issues.  If there is an
-     * authentication failure, this thread sets that state variable to
-     * AUTH_FAILED and then exits.  The server holds a list of currently
-     * authenticating connections and will look for AUTH_FAILED connections when
-     * it runs its Accept loop.  If it finds one, it will AuthJoin() this
-     * thread.  Since we set AUTH_FAILED immediately before exiting, there will
-     * be no problem having the server block waiting for the Join() to complete.
-     * We fail authentication here and let the server clean up after us, lazily.
+     * We're running an authentication step here, on one of the threads of the
+     * authentication IODispatch, and we are cooperating with the main server
+     * thread.  Read callbacks for a stream are never run concurrently and the
+     * exit callback is only made once any read callback has returned, so the
+     * authentication state is only ever touched by one thread at a time.
      *
-     * If we succeed in the authentication process, we set the state variable
-     * to AUTH_SUCEEDED and then call back into the server telling it that we are
-     * up and running.  It needs to take us off of the list of authenticating
-     * connections and put us on the list of running connections.  This thread
-     * will quickly go away and will be replaced by the Read and WriteCallbacks of
-     * the running RemoteEndpoint.
+     * Every read below has a zero timeout: we consume what has arrived and, if
+     * the handshake needs more, re-enable the read callback and return.  When
+     * the handshake completes (or fails) we stop the stream and leave the rest
+     * to ExitCallback().
      *
-     * If we are running an authentication process, we are probably ultimately
-     * blocked on a socket.  We expect that if the server is asked to shut
-     * down, it will run through its list of authenticating connections and
-     * AuthStop() each one.  That will cause a thread Stop() which should unblock
-     * all of the reads and return an error which will eventually pop out here
-     * with an authentication failure.
-     *
-     * Finally, if the server decides we've spent too much time here and we are
+     * If the server decides we've spent too much time here and we are
      * actually a denial of service attack, it can close us down by doing an
-     * AuthStop() on the authenticating endpoint.  This will do a thread Stop()
-     * on the auth thread of the endpoint which will pop out of here as an
-     * authentication failure as well.  The only ways out of this method must be
-     * with state = AUTH_FAILED or state = AUTH_SUCCEEDED.
+     * AuthStop() on the authenticating endpoint, which also ends up in
+     * ExitCallback() as an authentication failure.
      */
-    uint8_t byte;
-    size_t nbytes;
-
-    /*
-     * Eat the first byte of the stream.  This is required to be zero by the
-     * DBus protocol.  It is used in the Unix socket implementation to carry
-     * out-of-band capabilities, but is discarded here.  We do this here since
-     * it involves a read that can block.
-     */
-    QStatus status = m_endpoint->m_stream.PullBytes(&byte, 1, nbytes);
-    if ((status != ER_OK) || (nbytes != 1) || (byte != 0)) {
-        QCC_LogError(status, ("Failed to read first byte from stream"));
+    TCPEndpoint tcpEp = TCPEndpoint::wrap(m_endpoint);
+    IODispatch* dispatch = m_endpoint->m_transport->m_authDispatch;
+    QStatus status = ER_OK;
 
+    if (!m_endpoint->m_authFirstByte) {
         /*
-         * Management of the resources used by the authentication thread is done
-         * in one place, by the server Accept loop.  The authentication thread
-         * writes its state into the connection and the server Accept loop reads
-         * this state.  As soon as we set this state to AUTH_FAILED, we are
-         * telling the Accept loop that we are done with the conn data
-         * structure.  That thread is then free to do anything it wants with the
-         * connection, including deleting it, so we are not allowed to touch
-         * conn after setting this state.
-         *
-         * In addition to releasing responsibility for the conn data structure,
-         * when we set the state to AUTH_SUCCEEDED we are telling the server
-         * accept loop that we are exiting now and so it can Join() on us (the
-         * authentication thread) without being worried about blocking since the
-         * next thing we do is exit.
+         * Eat the first byte of the stream.  This is required to be zero by the
+         * DBus protocol.  It is used in the Unix socket implementation to carry
+         * out-of-band capabilities, but is discarded here.
          */
-        m_endpoint->m_authState = AUTH_FAILED;
-        return (void*)ER_FAIL;
-    }
+        uint8_t byte;
+        size_t nbytes;
+        status = m_endpoint->m_stream.PullBytes(&byte, 1, nbytes, 0);
+        if (status == ER_TIMEOUT) {
+            dispatch->EnableReadCallback(&m_endpoint->m_stream);
+            return ER_OK;
+        }
+        if ((status != ER_OK) || (nbytes != 1) || (byte != 0)) {
+            QCC_LogError(status, ("Failed to read first byte from stream"));
+            m_endpoint->m_authStatus = (status == ER_OK) ? ER_FAIL : status;
+            dispatch->StopStream(&m_endpoint->m_stream);
+            return ER_OK;
+        }
+        m_endpoint->m_authFirstByte = true;
 
-    /* Initialize the features for this endpoint */
-    m_endpoint->GetFeatures().isBusToBus = false;
-    m_endpoint->GetFeatures().isBusToBus = false;
-    m_endpoint->GetFeatures().handlePassing = false;
+        /* Initialize the features for this endpoint */
+        m_endpoint->GetFeatures().isBusToBus = false;
+        m_endpoint->GetFeatures().handlePassing = false;
 
-    /*
-     * Check any application connecting over TCP to see if it is running on the same machine and
-     * set the group ID appropriately if so.
-     */
-    TCPEndpoint tcpEp = TCPEndpoint::wrap(m_endpoint);
-    TCPTransport::CheckEndpointLocalMachine(tcpEp);
+        /*
+         * Check any application connecting over TCP to see if it is running on the same machine and
+         * set the group ID appropriately if so.
+         */
+        TCPTransport::CheckEndpointLocalMachine(tcpEp);
+
+        /* Since the TCPTransport allows untrusted clients, it must implement UntrustedClientStart and
+         * UntrustedClientExit.
+         * As a part of Establish, the endpoint can call the Transport's UntrustedClientStart method if
+         * it is an untrusted client, so the transport MUST call m_endpoint->SetListener before calling Establish
+         * Note: This is only required on the accepting end i.e. for incoming endpoints.
+         * Thin Client 14.06 or higher uses ANONYMOUS to connect to routing nodes.
+         */
+        m_endpoint->SetListener(m_endpoint->m_transport);
+    }
 
-    /* Run the actual connection authentication code. */
+    /* Run as much of the actual connection authentication code as we have data for. */
     qcc::String authName;
     qcc::String redirection;
     DaemonRouter& router = reinterpret_cast<DaemonRouter&>(m_endpoint->m_transport->m_bus.GetInternal().GetRouter());
     AuthListener* authListener = router.GetBusController()->GetAuthListener();
-    /* Since the TCPTransport allows untrusted clients, it must implement UntrustedClientStart and
-     * UntrustedClientExit.
-     * As a part of Establish, the endpoint can call the Transport's UntrustedClientStart method if
-     * it is an untrusted client, so the transport MUST call m_endpoint->SetListener before calling Establish
-     * Note: This is only required on the accepting end i.e. for incoming endpoints.
-     * Thin Client 14.06 or higher uses ANONYMOUS to connect to routing nodes.
-     */
-    m_endpoint->SetListener(m_endpoint->m_transport);
-    status = m_endpoint->Establish("ANONYMOUS", authName, redirection, authListener);
+    status = m_endpoint->EstablishNonBlocking("ANONYMOUS", authName, redirection, authListener);
+    if (status == ER_TIMEOUT) {
+        dispatch->EnableReadCallback(&m_endpoint->m_stream);
+        return ER_OK;
+    }
     if (status != ER_OK) {
         QCC_LogError(status, ("Failed to establish TCP endpoint"));
+    }
+    m_endpoint->m_authStatus = status;
+    dispatch->StopStream(&m_endpoint->m_stream);
+    return ER_OK;
+}
+
+void _TCPEndpoint::AuthHandler::ExitCallback()
+{
+    QCC_DbgTrace(("TCPEndpoint::AuthHandler::ExitCallback()"));
 
+    TCPEndpoint tcpEp = TCPEndpoint::wrap(m_endpoint);
+
+    if (m_endpoint->m_authStatus != ER_OK) {
         /*
-         * Management of the resources used by the authentication thread is done
-         * in one place, by the server Accept loop.  The authentication thread
-         * writes its state into the connection and the server Accept loop reads
-         * this state.  As soon as we set this state to AUTH_FAILED, we are
-         * telling the Accept loop that we are done with the conn data
-         * structure.  That thread is then free to do anything it wants with the
-         * connection, including deleting it, so we are not allowed to touch
-         * conn after setting this state.
-         *
-         * In addition to releasing responsibility for the conn data structure,
-         * when we set the state to AUTH_SUCCEEDED we are telling the server
-         * accept loop that we are exiting now and so it can Join() on us (the
-         * authentication thread) without being worried about blocking since the
-         * next thing we do is exit.
+         * Management of the resources used by the authentication is done in
+         * one place, by the server Accept loop.  We write the outcome into the
+         * connection and the server Accept loop reads this state.  As soon as
+         * we set this state to AUTH_FAILED, we are telling the Accept loop
+         * that we are done with the conn data structure (AuthJoin() covers the
+         * little the IODispatch does after we return).
          */
+        m_endpoint->AbortEstablish();
         m_endpoint->m_authState = AUTH_FAILED;
-        return (void*)status;
+        m_endpoint->m_transport->Alert();
+        return;
     }
 
     /*
      * Tell the transport that the authentication has succeeded and that it can
-     * now bring the connection up.
+     * now bring the connection up.  The authentication IODispatch has already
+     * stopped watching the stream, so it is free to be handed to the bus
+     * IODispatch by the endpoint Start().
      */
     m_endpoint->m_transport->Authenticated(tcpEp);
 
-    QCC_DbgTrace(("TCPEndpoint::AuthThread::Run(): Returning"));
+    QCC_DbgTrace(("TCPEndpoint::AuthHandler::ExitCallback(): Returning"));
 
     /*
      * We are now done with the authentication process.  We have succeeded doing
      * the authentication and we may or may not have succeeded in starting the
-     * endpoint TX and RX threads depending on what happened down in
-     * Authenticated().  What concerns us here is that we are done with this
-     * thread (the authentication thread) and we are about to exit.  Before
-     * exiting, we must tell server accept loop that we are done with this data
-     * structure.  As soon as we set this state to AUTH_SUCCEEDED that thread is
-     * then free to do anything it wants with the connection, including deleting
-     * it, so we are not allowed to touch conn after setting this state.
-     *
-     * In addition to releasing responsibility for the conn data structure, when
-     * we set the state to AUTH_SUCCEEDED we are telling the server accept loop
-     * that we are exiting now and so it can Join() the authentication thread
-     * without being worried about blocking since the next thing we do is exit.
+     * endpoint Read and WriteCallbacks depending on what happened down in
+     * Authenticated().  As soon as we set this state to AUTH_SUCCEEDED the
+     * server accept loop is free to do anything it wants with the connection,
+     * including deleting it once it has been joined.
      */
     m_endpoint->m_authState = AUTH_SUCCEEDED;
-    return (void*)status;
+    m_endpoint->m_transport->Alert();
 }
 
 TCPTransport::TCPTransport(BusAttachment& bus)
     : Thread("TCPTransport"), m_bus(bus), m_stopping(false), m_routerNameAdvertised(false),
-    m_listener(0), m_listenFdsLock(LOCK_LEVEL_TCPTRANSPORT_MLISTENFDSLOCK),
+    m_listener(0), m_authDispatch(NULL), m_listenFdsLock(LOCK_LEVEL_TCPTRANSPORT_MLISTENFDSLOCK),
     m_listenRequestsLock(LOCK_LEVEL_TCPTRANSPORT_MLISTENREQUESTSLOCK),
     m_foundCallback(m_listener), m_networkEventCallback(*this),
     m_isAdvertising(false), m_isDiscovering(false), m_isListening(false),
@@ -889,6 +885,7 @@ TCPTransport::~TCPTransport()
     QCC_DbgTrace(("TCPTransport::~TCPTransport()"));
     Stop();
     Join();
+    delete m_authDispatch;
 }
 
 void TCPTransport::Authenticated(TCPEndpoint& conn)
@@ -903,7 +900,7 @@ void TCPTransport::Authenticated(TCPEndpoint& conn)
     }
     /*
      * If Authenticated() is being called, it is as a result of the
-     * authentication thread telling us that it has succeeded.  What we need to
+     * authentication IODispatch telling us that it has succeeded.  What we need to
      * do here is to try and Start() the endpoint which will set up
      * Read and WriteCallbacks and register the endpoint with the daemon router.
      * As soon as we call Start(), we are transferring responsibility for error reporting
@@ -1042,6 +1039,25 @@ QStatus TCPTransport::Start()
     availRemoteClientsTcp = std::min(availRemoteClientsTcp, availConn);
     IpNameService::Instance().UpdateDynamicScore(TRANSPORT_TCP, availConn, maxConn, availRemoteClientsTcp, m_maxRemoteClientsTcp);
     m_dynamicScoreUpdater.Start();
+
+    /*
+     * Authenticating endpoints are driven by their own IODispatch so that a
+     * slow or malicious peer can only ever hold one of a fixed number of
+     * threads, and then only while it actually has bytes for us.
+     */
+    uint32_t authWorkers = config->GetLimit("tcp_auth_workers", ALLJOYN_TCP_AUTH_WORKERS_DEFAULT);
+    if (authWorkers == 0) {
+        QCC_LogError(ER_INVALID_CONFIG, ("TCPTransport::Start(): \"tcp_auth_workers\" must be at least 1, using %d", ALLJOYN_TCP_AUTH_WORKERS_DEFAULT));
+        authWorkers = ALLJOYN_TCP_AUTH_WORKERS_DEFAULT;
+    }
+    delete m_authDispatch;
+    m_authDispatch = new IODispatch("tcp-auth", authWorkers);
+    QStatus status = m_authDispatch->Start();
+    if (status != ER_OK) {
+        QCC_LogError(status, ("TCPTransport::Start(): Failed to start authentication IODispatch"));
+        return status;
+    }
+
     /*
      * Start the server accept loop through the thread base class.  This will
      * close or open the IsRunning() gate we use to control access to our
@@ -1116,11 +1132,11 @@ QStatus TCPTransport::Stop(void)
     }
 
     /*
-     * Ask any authenticating endpoints to shut down and exit their threads.  By its
-     * presence on the m_authList, we know that the endpoint is authenticating and
-     * the authentication thread has responsibility for dealing with the endpoint
-     * data structure.  We call Stop() to stop that thread from running.  The
-     * endpoint Read and WriteCallbacks will not be running yet.
+     * Ask any authenticating endpoints to shut down.  By its presence on the
+     * m_authList, we know that the endpoint is authenticating and the
+     * authentication IODispatch has responsibility for dealing with the
+     * endpoint data structure.  We call AuthStop() to have it let go of the
+     * stream.  The endpoint Read and WriteCallbacks will not be running yet.
      */
     for (set<TCPEndpoint>::iterator i = m_authList.begin(); i != m_authList.end(); ++i) {
         TCPEndpoint ep = *i;
@@ -1192,9 +1208,9 @@ QStatus TCPTransport::Join(void)
     m_endpointListLock.Lock(MUTEX_CONTEXT);
 
     /*
-     * Any authenticating endpoints have been asked to shut down and exit their
-     * authentication threads in a previously required Stop().  We need to
-     * Join() all of these auth threads here.
+     * Any authenticating endpoints have been asked to shut down and leave the
+     * authentication IODispatch in a previously required Stop().  We need to
+     * wait for all of them to be released here.
      */
     set<TCPEndpoint>::iterator it = m_authList.begin();
     while (it != m_authList.end()) {
@@ -1225,6 +1241,15 @@ QStatus TCPTransport::Join(void)
 
     m_endpointListLock.Unlock(MUTEX_CONTEXT);
 
+    /*
+     * No endpoint refers to the authentication IODispatch any more, so its
+     * threads can be shut down.  It is recreated by the next Start().
+     */
+    if (m_authDispatch) {
+        m_authDispatch->Stop();
+        m_authDispatch->Join();
+    }
+
     m_dynamicScoreUpdater.Join();
 
     m_stopping = false;
@@ -1543,10 +1568,10 @@ void TCPTransport::ManageEndpoints(uint32_t authTimeout, uint32_t sessionSetupTi
 
         if (authState == _TCPEndpoint::AUTH_FAILED) {
             /*
-             * The endpoint has failed authentication and the auth thread is
-             * gone or is going away.  Since it has failed there is no way this
-             * endpoint is going to be started so we can get rid of it as soon
-             * as we Join() the (failed) authentication thread.
+             * The endpoint has failed authentication and the authentication
+             * IODispatch is done or nearly done with it.  Since it has failed
+             * there is no way this endpoint is going to be started so we can
+             * get rid of it as soon as we AuthJoin() it.
              */
             QCC_DbgHLPrintf(("TCPTransport::ManageEndpoints(): Scavenging failed authenticator"));
             m_authList.erase(i);
@@ -1564,13 +1589,13 @@ void TCPTransport::ManageEndpoints(uint32_t authTimeout, uint32_t sessionSetupTi
         if (ep->GetStartTime() + authTimeout < tNow) {
             /*
              * This endpoint is taking too long to authenticate.  Stop the
-             * authentication process.  The auth thread is still running, so we
-             * can't just delete the connection, we need to let it stop in its
-             * own time.  What that thread will do is to set AUTH_FAILED and
-             * exit.  we will then clean it up the next time through this loop.
-             * In the hope that the thread can exit and we can catch its exit
-             * here and now, we take our thread off the OS ready list (Sleep)
-             * and let the other thread run before looping back.
+             * authentication process.  The authentication IODispatch may be in
+             * a callback for it, so we can't just delete the connection, we
+             * need to let it stop in its own time.  What the exit callback will
+             * do is to set AUTH_FAILED.  We will then clean it up the next time
+             * through this loop.  In the hope that the callback can run and we
+             * can catch it here and now, we take our thread off the OS ready
+             * list (Sleep) and let the other threads run before looping back.
              */
             QCC_DbgHLPrintf(("TCPTransport::ManageEndpoints(): Scavenging slow authenticator"));
             ep->AuthStop();
@@ -1581,8 +1606,8 @@ void TCPTransport::ManageEndpoints(uint32_t authTimeout, uint32_t sessionSetupTi
 
     /*
      * We've handled the authList, so now run through the list of connections on
-     * the endpointList and cleanup any that are no longer running or Join()
-     * authentication threads that have successfully completed.
+     * the endpointList and cleanup any that are no longer running or AuthJoin()
+     * authentications that have successfully completed.
      */
     i = m_endpointList.begin();
     while (i != m_endpointList.end()) {
@@ -1603,9 +1628,9 @@ void TCPTransport::ManageEndpoints(uint32_t authTimeout, uint32_t sessionSetupTi
 
         if (authState == _TCPEndpoint::AUTH_SUCCEEDED) {
             /*
-             * The endpoint has succeeded authentication and the auth thread is
-             * gone or is going away.  Take this opportunity to join the auth
-             * thread.  Since the auth thread promised not to touch the state
+             * The endpoint has succeeded authentication and the authentication
+             * IODispatch is done or nearly done with it.  Take this opportunity
+             * to AuthJoin() it.  Since the exit callback promised not to touch the state
              * after setting AUTH_SUCCEEEDED, we can safely change the state
              * here since we now own the conn.  We do this through a method call
              * to enable this single special case where we are allowed to set
@@ -1664,7 +1689,7 @@ void TCPTransport::ManageEndpoints(uint32_t authTimeout, uint32_t sessionSetupTi
          * the endpoint threads, remove the endpoint from the
          * endpoint list and delete it.  Note that we are calling
          * the endpoint Join() to join the TX and RX threads and not
-         * the endpoint AuthJoin() to join the auth thread.
+         * the endpoint AuthJoin() to wait for the authentication IODispatch.
          */
         if (endpointState == _TCPEndpoint::EP_STOPPING) {
             m_endpointList.erase(i);
@@ -1870,7 +1895,7 @@ void* TCPTransport::Run(void* arg)
                      * pitch the connection.
                      */
                     std::pair<std::set<TCPEndpoint>::iterator, bool> ins = m_authList.insert(conn);
-                    status = conn->Authenticate();
+                    status = conn->Authenticate(authTimeout);
                     if (status != ER_OK) {
                         m_authList.erase(ins.first);
                     }
@@ -35,6 +35,7 @@
 #include <qcc/String.h>
 #include <qcc/Mutex.h>
 #include <qcc/Thread.h>
+#include <qcc/IODispatch.h>
 #include <qcc/Socket.h>
 #include <qcc/SocketStream.h>
 #include <qcc/time.h>
@@ -327,6 +328,7 @@ class TCPTransport : public Transport, public _RemoteEndpoint::EndpointListener,
     bool m_routerNameAdvertised;                                   /**< True if routerName is advertised */
     TransportListener* m_listener;                                 /**< Registered TransportListener */
     std::set<TCPEndpoint> m_authList;                              /**< List of authenticating endpoints */
+    qcc::IODispatch* m_authDispatch;                               /**< Drives authentication of the endpoints on m_authList */
     std::set<TCPEndpoint> m_endpointList;                          /**< List of active endpoints */
     std::set<Thread*> m_activeEndpointsThreadList;                 /**< List of threads starting up active endpoints */
     qcc::Mutex m_endpointListLock;                                 /**< Mutex that protects the endpoint and auth lists */
@@ -572,6 +574,17 @@ class TCPTransport : public Transport, public _RemoteEndpoint::EndpointListener,
      */
     static const uint32_t ALLJOYN_MAX_INCOMPLETE_CONNECTIONS_TCP_DEFAULT = 48;
 
+    /**
+     * @brief The default value for the number of threads used to authenticate
+     * incoming connections.
+     *
+     * Authenticating connections do not get a thread of their own.  Their
+     * SASL and Hello exchanges are driven by a dedicated IODispatch, and this
+     * is the number of threads it uses to run them.  To override this value,
+     * change the limit, "tcp_auth_workers".
+     */
+    static const uint32_t ALLJOYN_TCP_AUTH_WORKERS_DEFAULT = 4;
+
     /**
      * @brief The default value for the maximum number of TCP connections
      * (remote endpoints).
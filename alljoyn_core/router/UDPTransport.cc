@@ -20,6 +20,7 @@
  ******************************************************************************/
 
 #include <algorithm>
+#include <cstddef>
 #include <qcc/platform.h>
 #include <qcc/IPAddress.h>
 #include <qcc/Socket.h>
@@ -469,6 +470,24 @@ const uint32_t UDP_TIMEWAIT = 1000;  /**< How long do we stay in TIMWAIT state b
 const uint32_t UDP_SEGBMAX = 4440;  /**< Maximum size of an ARDP segment (quantum of reliable transmission) */
 const uint32_t UDP_SEGMAX = 93;  /**< Maximum number of ARDP segment in-flight (bandwidth-delay product sizing) */
 
+/*
+ * Each ARDP shard is an independent protocol instance with its own sockets,
+ * lock and thread.  A single shard behaves exactly like the unsharded
+ * transport, which is what most devices want; routers serving many UDP peers
+ * can raise udp_shards in their configuration, up to UDP_MAX_SHARDS.
+ */
+const uint32_t UDP_SHARDS = 1;  /**< Number of ARDP shards sharing the listen ports (udp_shards) */
+const uint32_t UDP_MAX_SHARDS = 16;  /**< Upper bound on udp_shards */
+
+/*
+ * With batching enabled, ARDP reads up to this many datagrams with one system
+ * call and coalesces everything it sends during a pass into as few system
+ * calls as possible (recvmmsg() and sendmmsg() on Linux).  Each ARDP instance
+ * then needs a 64K receive buffer per datagram of the batch.
+ */
+const uint32_t UDP_BATCH = 1;  /**< Datagrams per system call (udp_batch), one disables batching */
+const uint32_t UDP_MAX_BATCH = 64;  /**< Upper bound on udp_batch */
+
 namespace ajn {
 
 /**
@@ -1124,17 +1143,14 @@ class _UDPEndpoint : public _RemoteEndpoint {
         RemoteEndpoint rep = RemoteEndpoint::wrap(this);
 
         /*
-         * If we are going to pass the Message off to be delivered, the act of
-         * delivering will change the write state of the message.  Since
-         * delivering to a multipoint session is done by taking a Message and
-         * sending it off to multiple endpoints for delivery, if we just use the
-         * Message we are given, we will eventually change the writeState of the
-         * message to MESSAGE_COMPLETE when we've pushed all of the bits.  That
-         * would cause any subsequent PushMessage calls to complete before
-         * actually writing any bits since they would think they are done.  This
-         * means we have to do a deep copy of every message before we send it.
+         * Delivering to a multipoint session is done by taking a Message and
+         * sending it off to multiple endpoints for delivery.  The write state
+         * lives in a cursor owned by this call so the Message can be shared
+         * with the other endpoints, unless it still has to be encrypted, in
+         * which case it is encrypted in place and we need our own copy.
          */
-        Message msgCopy = Message(msg, true);
+        Message msgCopy = msg->encrypt ? Message(msg, true) : msg;
+        MessageWriteCursor cursor;
 
         /*
          * We know we hold a reference, so now we can call out to the daemon
@@ -1145,7 +1161,7 @@ class _UDPEndpoint : public _RemoteEndpoint {
          */
         m_transport->m_endpointListLock.Unlock(MUTEX_CONTEXT);
         QCC_DbgPrintf(("_UDPEndpoint::PushMessage(): DeliverNonBlocking()"));
-        QStatus status = msgCopy->DeliverNonBlocking(rep);
+        QStatus status = msgCopy->DeliverNonBlocking(rep, cursor);
         QCC_DbgPrintf(("_UDPEndpoint::PushMessage(): DeliverNonBlocking() returns \"%s\"", QCC_StatusText(status)));
         DecrementAndFetch(&m_refCount);
         DecrementAndFetch(&m_pushCount);
@@ -1233,7 +1249,7 @@ class _UDPEndpoint : public _RemoteEndpoint {
             QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): Not accepting inbound messages"));
 
             QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): ARDP_RecvReady()"));
-            m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+            UDPTransport::GetArdpLock(handle).Lock(MUTEX_CONTEXT);
 
             /*
              * We got a receive callback that includes data destined for an
@@ -1266,7 +1282,7 @@ class _UDPEndpoint : public _RemoteEndpoint {
                 QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): ARDP_RecvReady() returns status==\"%s\"", QCC_StatusText(status)));
             }
 #endif
-            m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+            UDPTransport::GetArdpLock(handle).Unlock(MUTEX_CONTEXT);
 
             m_transport->m_endpointListLock.Unlock(MUTEX_CONTEXT);
             DecrementAndFetch(&m_refCount);
@@ -1283,14 +1299,14 @@ class _UDPEndpoint : public _RemoteEndpoint {
             QCC_LogError(ER_UDP_INVALID, ("_UDPEndpoint::RecvCb(): Unexpected rcv->fcnt==%d.", rcv->fcnt));
 
             QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): ARDP_RecvReady()"));
-            m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+            UDPTransport::GetArdpLock(handle).Lock(MUTEX_CONTEXT);
             /*
              * We got a bogus fragment count and so we will assert this is a
              * bogus condition below.  Don't bother printing an error if ARDP
              * also doesn't take the bogus buffers back.
              */
             ARDP_RecvReady(handle, conn, rcv);
-            m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+            UDPTransport::GetArdpLock(handle).Unlock(MUTEX_CONTEXT);
             m_transport->m_endpointListLock.Unlock(MUTEX_CONTEXT);
 
             DecrementAndFetch(&m_refCount);
@@ -1305,7 +1321,9 @@ class _UDPEndpoint : public _RemoteEndpoint {
          * ArdpRcvBuf* that we have to walk.  There is no cumulative length, so
          * we have to do two passes through the list: one pass to calculate the
          * length so we can allocate a contiguous buffer, and one to copy the
-         * data into the buffer.
+         * data into the buffer.  The buffer is allocated so that the Message
+         * can adopt it as its own backing buffer, so the reassembled bytes are
+         * never copied again.
          */
         uint8_t* msgbuf = NULL;
         uint32_t mlen = 0;
@@ -1320,14 +1338,14 @@ class _UDPEndpoint : public _RemoteEndpoint {
                     m_transport->m_endpointListLock.Unlock(MUTEX_CONTEXT);
 
                     QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): ARDP_RecvReady()"));
-                    m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+                    UDPTransport::GetArdpLock(handle).Lock(MUTEX_CONTEXT);
                     /*
                      * We got a bogus fragment count and so we will assert this
                      * is a bogus condition below.  Don't bother printing an
                      * error if ARDP also doesn't take the bogus buffers back.
                      */
                     ARDP_RecvReady(handle, conn, rcv);
-                    m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+                    UDPTransport::GetArdpLock(handle).Unlock(MUTEX_CONTEXT);
 
                     DecrementAndFetch(&m_refCount);
                     QCC_ASSERT(false && "_UDPEndpoint::RecvCb(): unexpected rcv->fcnt");
@@ -1339,33 +1357,31 @@ class _UDPEndpoint : public _RemoteEndpoint {
             }
 
             QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): Found Message of %d. bytes", mlen));
-#ifndef NDEBUG
-            msgbuf  = new uint8_t[mlen + SEAL_SIZE];
-            SealBuffer(msgbuf + mlen);
-#else
-            msgbuf = new uint8_t[mlen];
-#endif
+            uint8_t* data = NULL;
+            msgbuf = _Message::AllocAdoptableBuffer(mlen, data);
             uint32_t offset = 0;
             tmp = rcv;
             QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): Reassembling fragements"));
             for (uint32_t i = 0; i < rcv->fcnt; ++i) {
                 QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): Copying fragment of %d. bytes", tmp->datalen));
-                memcpy(msgbuf + offset, tmp->data, tmp->datalen);
+                memcpy(data + offset, tmp->data, tmp->datalen);
                 offset += tmp->datalen;
                 tmp = tmp->next;
             }
 
             QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): Message of %d. bytes reassembled", mlen));
-        }
-
-        uint8_t* messageBuf = msgbuf ? msgbuf : rcv->data;
-        uint32_t messageLen = mlen ? mlen : rcv->datalen;
-
 #ifndef NDEBUG
 #if BYTEDUMPS
-        DumpBytes(messageBuf, messageLen);
+            DumpBytes(data, mlen);
 #endif
 #endif
+        } else {
+#ifndef NDEBUG
+#if BYTEDUMPS
+            DumpBytes(rcv->data, rcv->datalen);
+#endif
+#endif
+        }
 
         /*
          * Since we know the callback dispatcher verified it could find an
@@ -1383,119 +1399,56 @@ class _UDPEndpoint : public _RemoteEndpoint {
         m_transport->m_endpointListLock.Unlock(MUTEX_CONTEXT);
 
         /*
-         * The point here is to create an AllJoyn Message from the
-         * inbound bytes which we know a priori to contain exactly one
-         * Message if present.  We have a back door in the Message code
-         * that lets us load our bytes directly into the message.  Note
-         * that this LoadBytes does a buffer copy, so we are free to
-         * release ownership of the incoming buffer at any time after
-         * that.
+         * The point here is to create an AllJoyn Message from the inbound
+         * bytes which we know a priori to contain exactly one Message if
+         * present.  We have a back door in the Message code that lets us load
+         * our bytes directly into the message.  A reassembled message hands
+         * its buffer over to the Message (AdoptBytes takes ownership even if
+         * it fails) so the fragments are only copied once.  A single fragment
+         * is loaded straight out of the ARDP receive buffer; that has to be a
+         * copy since the Message may outlive the buffer once it is queued on
+         * some endpoint.  We hold on to the ARDP buffers until we are done
+         * with the message, which is what applies backpressure to the sender.
          */
         Message msg(m_transport->m_bus);
         QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): LoadBytes()"));
-        status = msg->LoadBytes(messageBuf, messageLen);
-        if (status != ER_OK) {
-            QCC_LogError(status, ("_UDPEndpoint::RecvCb(): Cannot load bytes"));
-
-            /*
-             * If there's some kind of problem, we have to give the buffer
-             * back to the protocol now.
-             */
-            m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
-
-#ifndef NDEBUG
-            QStatus alternateStatus =
-#endif
-            ARDP_RecvReady(handle, conn, rcv);
-#ifndef NDEBUG
-            if (alternateStatus != ER_OK) {
-                QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): ARDP_RecvReady() returns status==\"%s\"", QCC_StatusText(alternateStatus)));
-            }
-#endif
-            m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
-
-            /*
-             * If we allocated a reassembly buffer, free it too.
-             */
-            if (msgbuf) {
-#ifndef NDEBUG
-                CheckSeal(msgbuf + mlen);
-#endif
-                delete[] msgbuf;
-                msgbuf = NULL;
-            }
-
-            /*
-             * If we do something that is going to bug the ARDP protocol, we
-             * need to call back into ARDP ASAP to get it moving.  This is done
-             * in the main thread, which we need to wake up.
-             */
-            m_transport->Alert();
-            DecrementAndFetch(&m_refCount);
-            return;
-        }
-
-        /*
-         * The bytes are now loaded into what amounts to a backing buffer for
-         * the Message.  With the exception of the Message header, these are
-         * still the raw bytes from the wire, so we have to Unmarshal() them
-         * before proceeding (remembering to free the reassembly buffer if it
-         * exists.
-         */
         if (msgbuf) {
-#ifndef NDEBUG
-            CheckSeal(msgbuf + mlen);
-#endif
-            delete[] msgbuf;
+            status = msg->AdoptBytes(msgbuf, mlen);
             msgbuf = NULL;
+        } else {
+            status = msg->LoadBytes(rcv->data, rcv->datalen);
         }
 
-        qcc::String endpointName(rep->GetUniqueName());
-        QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): Unmarshal()"));
-        status = msg->Unmarshal(endpointName, false, false, true, 0);
         if (status != ER_OK) {
-            QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): Can't Unmarhsal() Message.  Probably duplicate signal delivery"));
-
+            QCC_LogError(status, ("_UDPEndpoint::RecvCb(): Cannot load bytes"));
+        } else {
             /*
-             * If there's some kind of problem, we have to give the buffer
-             * back to the protocol now.
+             * The bytes are now loaded into what amounts to a backing buffer
+             * for the Message.  With the exception of the Message header,
+             * these are still the raw bytes from the wire, so we have to
+             * Unmarshal() them before proceeding.
              */
-            m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
-
-#ifndef NDEBUG
-            QStatus alternateStatus =
-#endif
-            ARDP_RecvReady(handle, conn, rcv);
-#ifndef NDEBUG
-            if (alternateStatus != ER_OK) {
-                QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): ARDP_RecvReady() returns status==\"%s\"", QCC_StatusText(alternateStatus)));
+            qcc::String endpointName(rep->GetUniqueName());
+            QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): Unmarshal()"));
+            status = msg->Unmarshal(endpointName, false, false, true, 0);
+            if (status != ER_OK) {
+                QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): Can't Unmarhsal() Message.  Probably duplicate signal delivery"));
+            } else {
+                QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): PushMessage()"));
+                status = m_transport->m_bus.GetInternal().GetRouter().PushMessage(msg, bep);
+                if (status != ER_OK) {
+                    QCC_LogError(status, ("_UDPEndpoint::RecvCb(): PushMessage failed"));
+                }
             }
-#endif
-
-            m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
-
-            /*
-             * If we do something that is going to bug the ARDP protocol, we
-             * need to call back into ARDP ASAP to get it moving.  This is done
-             * in the main thread, which we need to wake up.
-             */
-            m_transport->Alert();
-            DecrementAndFetch(&m_refCount);
-            return;
-        }
-
-        QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): PushMessage()"));
-        status = m_transport->m_bus.GetInternal().GetRouter().PushMessage(msg, bep);
-        if (status != ER_OK) {
-            QCC_LogError(status, ("_UDPEndpoint::RecvCb(): PushMessage failed"));
         }
 
         /*
-         * We're all done with the message we got from ARDP, so we need to let
-         * it know that it can reuse the buffer (and open its receive window).
+         * We're all done with the message we got from ARDP (or couldn't make
+         * sense of it), so we need to let it know that it can reuse the buffer
+         * (and open its receive window).
          */
         QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): ARDP_RecvReady()"));
-        m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+        UDPTransport::GetArdpLock(handle).Lock(MUTEX_CONTEXT);
 
 #ifndef NDEBUG
         QStatus alternateStatus =
@@ -1506,14 +1459,14 @@ class _UDPEndpoint : public _RemoteEndpoint {
             QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): ARDP_RecvReady() returns status==\"%s\"", QCC_StatusText(alternateStatus)));
         }
 #endif
-        m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+        UDPTransport::GetArdpLock(handle).Unlock(MUTEX_CONTEXT);
 
         /*
          * If we do something that is going to bug the ARDP protocol, we need to
-         * call back into ARDP ASAP to get it moving.  This is done in the main
-         * thread, which we need to wake up.
+         * call back into ARDP ASAP to get it moving.  This is done in the
+         * thread driving the connection's shard, which we need to wake up.
          */
-        m_transport->Alert();
+        m_transport->AlertArdp(handle);
         DecrementAndFetch(&m_refCount);
     }
 
@@ -1571,7 +1524,7 @@ class _UDPEndpoint : public _RemoteEndpoint {
     {
         QCC_DbgTrace(("_UDPEndpoint::SetConn(conn=%p)", conn));
         m_conn = conn;
-        m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+        UDPTransport::GetArdpLock(m_handle).Lock(MUTEX_CONTEXT);
         uint32_t cid = ARDP_GetConnId(m_handle, conn);
 
 #ifndef NDEBUG
@@ -1581,7 +1534,7 @@ class _UDPEndpoint : public _RemoteEndpoint {
 #endif
 
         SetConnId(cid);
-        m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+        UDPTransport::GetArdpLock(m_handle).Unlock(MUTEX_CONTEXT);
     }
 
     /**
@@ -1659,7 +1612,7 @@ class _UDPEndpoint : public _RemoteEndpoint {
             return ER_UDP_ENDPOINT_NOT_STARTED;
         }
 
-        m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+        UDPTransport::GetArdpLock(GetHandle()).Lock(MUTEX_CONTEXT);
 
         IPEndpoint endpoint;
         QStatus status = ARDP_GetLocalIPEndpointFromConn(GetHandle(), GetConn(), endpoint);
@@ -1667,7 +1620,7 @@ class _UDPEndpoint : public _RemoteEndpoint {
             ipAddrStr = endpoint.addr.ToString();
         }
 
-        m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+        UDPTransport::GetArdpLock(GetHandle()).Unlock(MUTEX_CONTEXT);
         return status;
     };
 
@@ -2460,9 +2413,9 @@ class ArdpStream : public qcc::Stream {
         uint32_t timeout;
         Timespec<MonotonicTime> tStart;
 
-        m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+        UDPTransport::GetArdpLock(m_handle).Lock(MUTEX_CONTEXT);
         timeout = 2 * ARDP_GetDataTimeout(m_handle, m_conn);
-        m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+        UDPTransport::GetArdpLock(m_handle).Unlock(MUTEX_CONTEXT);
 
         GetTimeNow(&tStart);
         QCC_DbgPrintf(("ArdpStream::PushBytes(): Start time is %" PRIu64 ".%03d.", tStart.seconds, tStart.mseconds));
@@ -2579,9 +2532,9 @@ class ArdpStream : public qcc::Stream {
                      * We think everything is up and ready in ARDP-land, so we
                      * can go ahead and start a send.
                      */
-                    m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+                    UDPTransport::GetArdpLock(m_handle).Lock(MUTEX_CONTEXT);
                     status = ARDP_Send(m_handle, m_conn, buffer, numBytes, ttl);
-                    m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+                    UDPTransport::GetArdpLock(m_handle).Unlock(MUTEX_CONTEXT);
                 }
             } else {
                 /*
@@ -2602,11 +2555,11 @@ class ArdpStream : public qcc::Stream {
             /*
              * If we do something that is going to bug the ARDP protocol, we need
              * to call back into ARDP ASAP to get it moving.  This is done in the
-             * main thread, which we need to wake up.  Note that we don't set
-             * m_manage so we don't trigger endpoint management, we just trigger
-             * ARDP_Run to happen.
+             * thread driving the connection's shard, which we need to wake up.
+             * Note that we don't set m_manage so we don't trigger endpoint
+             * management, we just trigger ARDP_Run to happen.
              */
-            m_transport->Alert();
+            m_transport->AlertArdp(m_handle);
 
             /*
              * If the send succeeded, then the bits are on their way off to the
@@ -2873,10 +2826,10 @@ class ArdpStream : public qcc::Stream {
                      */
                     QCC_ASSERT(status == ER_UDP_LOCAL_DISCONNECT && "ArdpStream::Disconnect(): Unexpected status");
 
-                    m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+                    UDPTransport::GetArdpLock(m_handle).Lock(MUTEX_CONTEXT);
                     QCC_DbgPrintf(("ArdpStream::Disconnect(): ARDP_Disconnect()"));
                     status = ARDP_Disconnect(m_handle, m_conn, m_connId);
-                    m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+                    UDPTransport::GetArdpLock(m_handle).Unlock(MUTEX_CONTEXT);
                     if (status == ER_OK) {
                         m_discSent = true;
                         m_discStatus = ER_UDP_LOCAL_DISCONNECT;
@@ -2894,6 +2847,7 @@ class ArdpStream : public qcc::Stream {
                      */
                     m_transport->m_manage = UDPTransport::STATE_MANAGE;
                     m_transport->Alert();
+                    m_transport->AlertArdp(m_handle);
                 } else {
                     /*
                      * sudden = false, m_disc = false, m_discSent == true
@@ -3176,9 +3130,9 @@ class MessagePump {
         while (m_queue.empty() == false) {
             QueueEntry entry = m_queue.front();
             m_queue.pop();
-            m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+            UDPTransport::GetArdpLock(entry.m_handle).Lock(MUTEX_CONTEXT);
             ARDP_RecvReady(entry.m_handle, entry.m_conn, entry.m_rcv);
-            m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+            UDPTransport::GetArdpLock(entry.m_handle).Unlock(MUTEX_CONTEXT);
         }
 
         QCC_ASSERT(m_queue.empty() && "MessagePump::~MessagePump(): Message queue must be empty here");
@@ -3965,7 +3919,7 @@ void _UDPEndpoint::CreateStream(ArdpHandle* handle, ArdpConnRecord* conn, uint32
     IncrementAndFetch(&m_refCount);
     QCC_DbgHLPrintf(("_UDPEndpoint::CreateStream(handle=%p, conn=%p)", handle, conn));
 
-    m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+    UDPTransport::GetArdpLock(handle).Lock(MUTEX_CONTEXT);
     QCC_ASSERT(m_stream == NULL && "_UDPEndpoint::CreateStream(): stream already exists");
 
     /*
@@ -3986,7 +3940,7 @@ void _UDPEndpoint::CreateStream(ArdpHandle* handle, ArdpConnRecord* conn, uint32
      * PushMessage() back into the ArdpStream PushBytes().
      */
     SetStream(m_stream);
-    m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+    UDPTransport::GetArdpLock(handle).Unlock(MUTEX_CONTEXT);
     DecrementAndFetch(&m_refCount);
 }
 
@@ -4341,9 +4295,10 @@ ThreadReturn STDCALL MessagePump::PumpThread::Run(void* arg)
 #if RETURN_ORPHAN_BUFS
 
                 QCC_DbgPrintf(("MessagePump::PumpThread::Run(): Unable to find endpoint with conn ID == %d. on m_endpointList", entry.m_connId));
-                m_pump->m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+                UDPTransport::GetArdpLock(entry.m_handle).Lock(MUTEX_CONTEXT);
                 ARDP_RecvReady(entry.m_handle, entry.m_conn, entry.m_rcv);
-                m_pump->m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+                UDPTransport::GetArdpLock(entry.m_handle).Unlock(MUTEX_CONTEXT);
+                m_pump->m_transport->AlertArdp(entry.m_handle);
 
 #else // not RETURN_ORPHAN_BUFS
 
@@ -4424,11 +4379,9 @@ UDPTransport::UDPTransport(BusAttachment& bus) :
     m_authTimeout(0), m_sessionSetupTimeout(0),
     m_maxAuth(0), m_maxConn(0), m_currAuth(0), m_currConn(0),
     m_connLock(LOCK_LEVEL_UDPTRANSPORT_CONNLOCK), m_dynamicScoreUpdater(*this),
-    /* Workaround for known deadlock prediction break ASACORE-2678 */
-    m_ardpLock(LOCK_LEVEL_CHECKING_DISABLED),
     /* Workaround for known deadlock ASACORE-2094 */
     m_cbLock(LOCK_LEVEL_CHECKING_DISABLED),
-    m_handle(NULL), m_dispatcher(NULL), m_exitDispatcher(NULL),
+    m_shards(), m_nextShard(0), m_dispatcher(NULL), m_exitDispatcher(NULL),
     m_workerCommandQueue(), m_workerCommandQueueLock(LOCK_LEVEL_UDPTRANSPORT_WORKERCOMMANDQUEUELOCK),
     m_exitWorkerCommandQueue(), m_exitWorkerCommandQueueLock(LOCK_LEVEL_UDPTRANSPORT_EXITWORKERCOMMANDQUEUELOCK)
 #if WORKAROUND_1298
@@ -4478,6 +4431,12 @@ UDPTransport::UDPTransport(BusAttachment& bus) :
     }
     memcpy(&m_ardpConfig, &ardpConfig, sizeof(ArdpGlobalConfig));
 
+    m_ardpBatch = config->GetLimit("udp_batch", UDP_BATCH);
+    if (m_ardpBatch < 1 || m_ardpBatch > UDP_MAX_BATCH) {
+        QCC_LogError(ER_INVALID_CONFIG, ("UDPTransport::UDPTransport(): udp_batch (%d) out of range, using %d", m_ardpBatch, UDP_BATCH));
+        m_ardpBatch = UDP_BATCH;
+    }
+
     for (uint32_t i = 0; i < N_PUMPS; ++i) {
         m_messagePumps[i] = new MessagePump(this);
     }
@@ -4490,13 +4449,43 @@ UDPTransport::UDPTransport(BusAttachment& bus) :
         m_authTimeout = m_sessionSetupTimeout = t;
     }
 
+    /*
+     * Create the ARDP shards.  If we cannot steer datagrams between sockets
+     * sharing a port on this platform, a listen spec ends up with a socket for
+     * shard zero only, so there is no point in having more than one.
+     */
+    uint32_t nShards = config->GetLimit("udp_shards", UDP_SHARDS);
+    if (nShards < 1 || nShards > UDP_MAX_SHARDS) {
+        QCC_LogError(ER_INVALID_CONFIG, ("UDPTransport::UDPTransport(): udp_shards (%d) out of range, using %d", nShards, UDP_SHARDS));
+        nShards = UDP_SHARDS;
+    }
+    for (uint32_t i = 0; i < nShards; ++i) {
+        m_shards.push_back(new ArdpShard(this, i, nShards));
+    }
+}
+
+/**
+ * Construct an ARDP shard.  Only shards other than zero ever run their own
+ * thread, but the handle of every shard is created here.
+ */
+UDPTransport::ArdpShard::ArdpShard(UDPTransport* transport, uint16_t index, uint16_t count) :
+    Thread(qcc::String("UDP ARDP Shard ") + U32ToString(index)),
+    m_transport(transport), m_index(index),
+    /* Workaround for known deadlock prediction break ASACORE-2678 */
+    m_lock(LOCK_LEVEL_CHECKING_DISABLED),
+    m_handle(NULL), m_reload(true)
+{
+    QCC_DbgTrace(("UDPTransport::ArdpShard::ArdpShard(index=%d.)", index));
+
     /*
      * Initialize the hooks to and from the ARDP protocol.  Note that
      * ARDP_AllocHandle is expected to "never fail."
      */
-    m_ardpLock.Lock(MUTEX_CONTEXT);
-    m_handle = ARDP_AllocHandle(&ardpConfig);
+    m_lock.Lock(MUTEX_CONTEXT);
+    m_handle = ARDP_AllocHandle(&transport->m_ardpConfig);
     ARDP_SetHandleContext(m_handle, this);
+    ARDP_SetPortPartition(m_handle, index, count);
+    ARDP_SetBatchSize(m_handle, transport->m_ardpBatch);
     ARDP_SetAcceptCb(m_handle, ArdpAcceptCb);
     ARDP_SetConnectCb(m_handle, ArdpConnectCb);
     ARDP_SetDisconnectCb(m_handle, ArdpDisconnectCb);
@@ -4525,11 +4514,21 @@ UDPTransport::UDPTransport(BusAttachment& bus) :
 
 #ifndef NDEBUG
     if (status != ER_OK) {
-        QCC_DbgPrintf(("UDPTransport::UDPTransport(): ARDP_StartPassive() returns status==\"%s\"", QCC_StatusText(status)));
+        QCC_DbgPrintf(("UDPTransport::ArdpShard::ArdpShard(): ARDP_StartPassive() returns status==\"%s\"", QCC_StatusText(status)));
     }
 #endif
 
-    m_ardpLock.Unlock(MUTEX_CONTEXT);
+    m_lock.Unlock(MUTEX_CONTEXT);
+}
+
+UDPTransport::ArdpShard::~ArdpShard()
+{
+    QCC_DbgTrace(("UDPTransport::ArdpShard::~ArdpShard(index=%d.)", m_index));
+    Stop();
+    Join();
+
+    ARDP_FreeHandle(m_handle);
+    m_handle = NULL;
 }
 
 /**
@@ -4548,8 +4547,10 @@ UDPTransport::~UDPTransport()
         m_messagePumps[i] = NULL;
     }
 
-    ARDP_FreeHandle(m_handle);
-    m_handle = NULL;
+    for (uint32_t i = 0; i < m_shards.size(); ++i) {
+        delete m_shards[i];
+    }
+    m_shards.clear();
 
     QCC_DbgPrintf(("UDPTransport::~UDPTransport(): m_mAuthList.size() == %d", m_authList.size()));
     QCC_DbgPrintf(("UDPTransport::~UDPTransport(): m_mEndpointList.size() == %d", m_endpointList.size()));
@@ -4845,7 +4846,7 @@ ThreadReturn STDCALL UDPTransport::DispatcherThread::Run(void* arg)
                                  * if that happens.
                                  */
                                 QCC_DbgPrintf(("UDPTransport::DispatcherThread::Run(): Orphaned RECV_CB: ARDP_RecvReady()"));
-                                m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+                                UDPTransport::GetArdpLock(entry.m_handle).Lock(MUTEX_CONTEXT);
 
 #ifndef NDEBUG
                                 QStatus alternateStatus =
@@ -4856,7 +4857,7 @@ ThreadReturn STDCALL UDPTransport::DispatcherThread::Run(void* arg)
                                     QCC_DbgPrintf(("UDPTransport::DispatcherThread::Run(): ARDP_RecvReady() returns status==\"%s\"", QCC_StatusText(alternateStatus)));
                                 }
 #endif
-                                m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+                                UDPTransport::GetArdpLock(entry.m_handle).Unlock(MUTEX_CONTEXT);
 #else // not RETURN_ORPHAN_BUFS
                                 /*
                                  * If we get here, we have a receive callback
@@ -5367,7 +5368,7 @@ QStatus UDPTransport::Join(void)
          * Stop()ped.
          */
         if (entry.m_command == WorkerCommandQueueEntry::RECV_CB) {
-            m_ardpLock.Lock(MUTEX_CONTEXT);
+            GetArdpLock(entry.m_handle).Lock(MUTEX_CONTEXT);
 
 #ifndef NDEBUG
             QStatus alternateStatus =
@@ -5378,7 +5379,7 @@ QStatus UDPTransport::Join(void)
                 QCC_DbgPrintf(("UDPTransport::Join(): ARDP_RecvReady() returns status==\"%s\"", QCC_StatusText(alternateStatus)));
             }
 #endif
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            GetArdpLock(entry.m_handle).Unlock(MUTEX_CONTEXT);
         }
 
         /*
@@ -5841,8 +5842,7 @@ void UDPTransport::EndpointDeletedHook()
      * reload its listen FDs and discard any that are no longer useful.
      */
     if (idle) {
-        m_reload = STATE_RELOADING;
-        Alert();
+        ReloadListenFds();
     }
 }
 
@@ -6610,7 +6610,7 @@ bool UDPTransport::ArdpAcceptCb(ArdpHandle* ardpHandle, qcc::IPAddress ipAddr, u
 {
     QCC_DbgTrace(("UDPTransport::ArdpAcceptCb(handle=%p, ipAddr=\"%s\", port=%d., conn=%p, buf =%p, len = %d)",
                   ardpHandle, ipAddr.ToString().c_str(), ipPort, conn, buf, len));
-    UDPTransport* const transport = static_cast<UDPTransport* const>(ARDP_GetHandleContext(ardpHandle));
+    UDPTransport* const transport = GetShard(ardpHandle)->m_transport;
     return transport->AcceptCb(ardpHandle, ipAddr, ipPort, conn, buf, len, status);
 }
 
@@ -6628,7 +6628,7 @@ void UDPTransport::ArdpConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, b
 {
     QCC_DbgTrace(("UDPTransport::ArdpConnectCb(handle=%p, conn=%p, passive=%s, buf = %p, len = %d, status=%s)",
                   ardpHandle, conn, passive ? "true" : "false", buf, len, QCC_StatusText(status)));
-    UDPTransport* const transport = static_cast<UDPTransport* const>(ARDP_GetHandleContext(ardpHandle));
+    UDPTransport* const transport = GetShard(ardpHandle)->m_transport;
     transport->ConnectCb(ardpHandle, conn, passive, buf, len, status);
 }
 
@@ -6645,7 +6645,7 @@ void UDPTransport::ArdpConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, b
 void UDPTransport::ArdpDisconnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, QStatus status)
 {
     QCC_DbgTrace(("UDPTransport::ArdpDisconnectCb(handle=%p, conn=%p, status=\"%s\")", ardpHandle, conn, QCC_StatusText(status)));
-    UDPTransport* const transport = static_cast<UDPTransport* const>(ARDP_GetHandleContext(ardpHandle));
+    UDPTransport* const transport = GetShard(ardpHandle)->m_transport;
     transport->DisconnectCb(ardpHandle, conn, status);
 }
 
@@ -6663,7 +6663,7 @@ void UDPTransport::ArdpRecvCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, Ardp
 {
     QCC_DbgTrace(("UDPTransport::ArdpRecvCb(handle=%p, conn=%p, buf=%p, status=%s)",
                   ardpHandle, conn, rcv, QCC_StatusText(status)));
-    UDPTransport* const transport = static_cast<UDPTransport* const>(ARDP_GetHandleContext(ardpHandle));
+    UDPTransport* const transport = GetShard(ardpHandle)->m_transport;
     transport->RecvCb(ardpHandle, conn, rcv, status);
 }
 
@@ -6680,7 +6680,7 @@ void UDPTransport::ArdpRecvCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, Ardp
 void UDPTransport::ArdpSendCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uint8_t* buf, uint32_t len, QStatus status)
 {
     QCC_DbgTrace(("UDPTransport::ArdpSendCb(handle=%p, conn=%p, buf=%p, len=%d.)", ardpHandle, conn, buf, len));
-    UDPTransport* const transport = static_cast<UDPTransport* const>(ARDP_GetHandleContext(ardpHandle));
+    UDPTransport* const transport = GetShard(ardpHandle)->m_transport;
     transport->SendCb(ardpHandle, conn, buf, len, status);
 }
 
@@ -6697,7 +6697,7 @@ void UDPTransport::ArdpSendCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uint
 void UDPTransport::ArdpSendWindowCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uint16_t window, QStatus status)
 {
     QCC_DbgTrace(("UDPTransport::ArdpSendWindowCb(handle=%p, conn=%p, window=%d.)", ardpHandle, conn, window));
-    UDPTransport* const transport = static_cast<UDPTransport* const>(ARDP_GetHandleContext(ardpHandle));
+    UDPTransport* const transport = GetShard(ardpHandle)->m_transport;
     transport->SendWindowCb(ardpHandle, conn, window, status);
 }
 
@@ -7411,9 +7411,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
          * return since it is pointless to continue to bring up something that
          * will be unusable.
          */
-        m_ardpLock.Lock(MUTEX_CONTEXT);
-        uint32_t cidFromConn = ARDP_GetConnId(m_handle, conn);
-        m_ardpLock.Unlock(MUTEX_CONTEXT);
+        GetArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
+        uint32_t cidFromConn = ARDP_GetConnId(ardpHandle, conn);
+        GetArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
         if (cidFromConn == ARDP_CONN_ID_INVALID) {
             DecrementAndFetch(&m_refCount);
             return;
@@ -7427,11 +7427,16 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
             /*
              * If cidFromEp is ARDP_CONN_ID_INVALID there's nothing we can do fo
              * this endpoint.  Ignore it.  If it was the one referred to by the
-             * now defunct conn, it will time out on its own.
+             * now defunct conn, it will time out on its own.  An endpoint
+             * whose connection lives on another ARDP shard cannot be the one
+             * referred to by conn, so we don't bother that shard's lock.
              */
-            m_ardpLock.Lock(MUTEX_CONTEXT);
-            uint32_t cidFromEp = ARDP_GetConnId(m_handle, ep->GetConn());
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            if (ep->GetHandle() != ardpHandle) {
+                continue;
+            }
+            GetArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
+            uint32_t cidFromEp = ARDP_GetConnId(ardpHandle, ep->GetConn());
+            GetArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
             if (cidFromEp == ARDP_CONN_ID_INVALID) {
                 continue;
             }
@@ -7508,9 +7513,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
                     m_endpointListLock.Unlock(MUTEX_CONTEXT);
                     haveLock = false;
 
-                    m_ardpLock.Lock(MUTEX_CONTEXT);
+                    GetArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
                     ARDP_ReleaseConnection(ardpHandle, conn);
-                    m_ardpLock.Unlock(MUTEX_CONTEXT);
+                    GetArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
                     m_manage = UDPTransport::STATE_MANAGE;
                     Alert();
                 }
@@ -7549,10 +7554,10 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
          * be valid.
          */
         QCC_DbgPrintf(("UDPTransport::DoConnectCb(): active connection callback with conn ID == %d.", connId));
-        m_ardpLock.Lock(MUTEX_CONTEXT);
-        bool connValid = ARDP_IsConnValid(m_handle, conn, connId);
-        qcc::Event* event = static_cast<qcc::Event*>(ARDP_GetConnContext(m_handle, conn));
-        m_ardpLock.Unlock(MUTEX_CONTEXT);
+        GetArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
+        bool connValid = ARDP_IsConnValid(ardpHandle, conn, connId);
+        qcc::Event* event = static_cast<qcc::Event*>(ARDP_GetConnContext(ardpHandle, conn));
+        GetArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
         /*
          * We need to remember in the following code that we have a contract
@@ -7624,9 +7629,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
         if (eventValid == false) {
             QCC_LogError(status, ("UDPTransport::DoConnectCb(): No thread waiting for Connect() to complete"));
             m_endpointListLock.Unlock(MUTEX_CONTEXT);
-            m_ardpLock.Lock(MUTEX_CONTEXT);
+            GetArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
             ARDP_ReleaseConnection(ardpHandle, conn);
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            GetArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
             m_connLock.Lock(MUTEX_CONTEXT);
             --m_currAuth;
@@ -7646,9 +7651,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
             QCC_LogError(status, ("UDPTransport::DoConnectCb(): Connect error"));
             event->SetEvent();
             m_endpointListLock.Unlock(MUTEX_CONTEXT);
-            m_ardpLock.Lock(MUTEX_CONTEXT);
+            GetArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
             ARDP_ReleaseConnection(ardpHandle, conn);
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            GetArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
             m_connLock.Lock(MUTEX_CONTEXT);
             --m_currAuth;
@@ -7668,9 +7673,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
             QCC_LogError(ER_UDP_INVALID, ("UDPTransport::DoConnectCb(): No BusHello reply with SYN + ACK"));
             event->SetEvent();
             m_endpointListLock.Unlock(MUTEX_CONTEXT);
-            m_ardpLock.Lock(MUTEX_CONTEXT);
+            GetArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
             ARDP_ReleaseConnection(ardpHandle, conn);
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            GetArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
             m_connLock.Lock(MUTEX_CONTEXT);
             --m_currAuth;
@@ -7691,9 +7696,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
             QCC_LogError(status, ("UDPTransport::DoConnectCb(): Can't Unmarhsal() BusHello Reply Message"));
             event->SetEvent();
             m_endpointListLock.Unlock(MUTEX_CONTEXT);
-            m_ardpLock.Lock(MUTEX_CONTEXT);
+            GetArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
             ARDP_ReleaseConnection(ardpHandle, conn);
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            GetArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
             m_connLock.Lock(MUTEX_CONTEXT);
             --m_currAuth;
@@ -7719,9 +7724,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
             QCC_LogError(status, ("UDPTransport::DoConnectCb(): Can't Unmarhsal() BusHello Message"));
             event->SetEvent();
             m_endpointListLock.Unlock(MUTEX_CONTEXT);
-            m_ardpLock.Lock(MUTEX_CONTEXT);
+            GetArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
             ARDP_ReleaseConnection(ardpHandle, conn);
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            GetArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
             m_connLock.Lock(MUTEX_CONTEXT);
             --m_currAuth;
@@ -7741,9 +7746,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
             QCC_LogError(status, ("UDPTransport::DoConnectCb(): Response was not a reply Message"));
             event->SetEvent();
             m_endpointListLock.Unlock(MUTEX_CONTEXT);
-            m_ardpLock.Lock(MUTEX_CONTEXT);
+            GetArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
             ARDP_ReleaseConnection(ardpHandle, conn);
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            GetArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
             m_connLock.Lock(MUTEX_CONTEXT);
             --m_currAuth;
@@ -7768,9 +7773,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
             QCC_LogError(status, ("UDPTransport::DoConnectCb(): Can't UnmarhsalArgs() BusHello Reply Message"));
             event->SetEvent();
             m_endpointListLock.Unlock(MUTEX_CONTEXT);
-            m_ardpLock.Lock(MUTEX_CONTEXT);
+            GetArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
             ARDP_ReleaseConnection(ardpHandle, conn);
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            GetArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
             m_connLock.Lock(MUTEX_CONTEXT);
             --m_currAuth;
@@ -7796,9 +7801,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
             QCC_LogError(status, ("UDPTransport::DoConnectCb(): Unexpected number or type of arguments in BusHello Reply Message"));
             event->SetEvent();
             m_endpointListLock.Unlock(MUTEX_CONTEXT);
-            m_ardpLock.Lock(MUTEX_CONTEXT);
+            GetArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
             ARDP_ReleaseConnection(ardpHandle, conn);
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            GetArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
             m_connLock.Lock(MUTEX_CONTEXT);
             --m_currAuth;
@@ -7822,10 +7827,10 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
          * We have everything we need to start up, so it is now time to create
          * our new endpoint.
          */
-        m_ardpLock.Lock(MUTEX_CONTEXT);
+        GetArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
         qcc::IPEndpoint endpoint;
         ARDP_GetRemoteIPEndpointFromConn(ardpHandle, conn, endpoint);
-        m_ardpLock.Unlock(MUTEX_CONTEXT);
+        GetArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
         static const bool truthiness = true;
         UDPTransport* ptr = this;
@@ -8213,9 +8218,9 @@ void UDPTransport::RecvCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, ArdpRcvB
 #if RETURN_ORPHAN_BUFS
 
         QCC_DbgPrintf(("UDPTransport::RecvCb(): ARDP_RecvReady()"));
-        m_ardpLock.Lock(MUTEX_CONTEXT);
+        GetArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
         ARDP_RecvReady(ardpHandle, conn, rcv);
-        m_ardpLock.Unlock(MUTEX_CONTEXT);
+        GetArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
 #else // not RETURN_ORPHAN_BUFS
 
@@ -8417,6 +8422,16 @@ void* UDPTransport::Run(void* arg)
     checkEvents.push_back(&ardpTimerEvent);
     checkEvents.push_back(&maintenanceTimerEvent);
 
+    /*
+     * Shard zero is driven by this thread; the others get their own.
+     */
+    for (uint32_t i = 1; i < m_shards.size(); ++i) {
+        QStatus shardStatus = m_shards[i]->Start();
+        if (shardStatus != ER_OK) {
+            QCC_LogError(shardStatus, ("UDPTransport::Run(): Failed to start ARDP shard %d.", i));
+        }
+    }
+
     Timespec<MonotonicTime> tLastManage;
     GetTimeNow(&tLastManage);
 
@@ -8489,6 +8504,11 @@ void* UDPTransport::Run(void* arg)
                  * be associated with an exited endpoint, while the live
                  * endpoint could be associated with another.
                  */
+                if (i->m_shard != 0) {
+                    ++i;
+                    continue;
+                }
+
                 if (i->m_remove) {
                     if (passive == true && m_connecting == 0) {
                         QCC_DbgPrintf(("UDPTransport::Run(): Closing socket %d., Removing listen spec \"%s\"",
@@ -8657,13 +8677,14 @@ void* UDPTransport::Run(void* arg)
 
             uint32_t ms;
             QStatus ardpStatus;
-            m_ardpLock.Lock(MUTEX_CONTEXT);
+            ArdpShard* shard = m_shards[0];
+            shard->m_lock.Lock(MUTEX_CONTEXT);
             if (socketReady) {
-                ardpStatus = ARDP_Run(m_handle, (*i)->GetFD(), readReady, writeReady, &ms);
+                ardpStatus = ARDP_Run(shard->m_handle, (*i)->GetFD(), readReady, writeReady, &ms);
             } else {
-                ardpStatus = ARDP_Run(m_handle, qcc::INVALID_SOCKET_FD, false, false, &ms);
+                ardpStatus = ARDP_Run(shard->m_handle, qcc::INVALID_SOCKET_FD, false, false, &ms);
             }
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            shard->m_lock.Unlock(MUTEX_CONTEXT);
 
             /*
              * Every time we call ARDP_Run(), it lets us know when its next
@@ -8719,6 +8740,15 @@ void* UDPTransport::Run(void* arg)
     }
     writeEvents.clear();
 
+    /*
+     * The other shards may still be waiting on their sockets, so they have to
+     * go away before we close anything.
+     */
+    for (uint32_t i = 1; i < m_shards.size(); ++i) {
+        m_shards[i]->Stop();
+        m_shards[i]->Join();
+    }
+
     /*
      * If we're stopping, it is our responsibility to clean up the list of FDs
      * we are listening to.  Since at this point we've Stop()ped and Join()ed
@@ -8740,6 +8770,181 @@ void* UDPTransport::Run(void* arg)
     return (void*) status;
 }
 
+/*
+ * The run loop of every ARDP shard other than shard zero.  This is the part of
+ * UDPTransport::Run() that drives ARDP, restricted to the sockets that belong
+ * to this shard.  Endpoint management stays with the transport's own thread.
+ */
+void* UDPTransport::ArdpShard::Run(void* arg)
+{
+    QCC_UNUSED(arg);
+
+    QCC_DbgTrace(("UDPTransport::ArdpShard::Run(): shard %d.", m_index));
+
+    vector<Event*> checkEvents, signaledEvents;
+    vector<WriteEntry> writeEvents;
+
+    qcc::Event ardpTimerEvent(qcc::Event::WAIT_FOREVER, 0);
+
+    QStatus status = ER_OK;
+    m_reload = true;
+
+    while (IsStopping() == false) {
+        /*
+         * Reload our listen FDs when the transport says so, closing the ones
+         * marked for removal under the same rules as UDPTransport::Run().  The
+         * transport-wide locks are only taken for a reload so that shards do
+         * not serialize on them; ReloadListenFds() alerts us after setting
+         * m_reload so a reload requested after this check is not missed.
+         */
+        if (m_reload) {
+            m_transport->m_endpointListLock.Lock(MUTEX_CONTEXT);
+            m_transport->m_preListLock.Lock(MUTEX_CONTEXT);
+            m_transport->m_listenFdsLock.Lock(MUTEX_CONTEXT);
+
+            bool passive = m_transport->m_preList.empty() && m_transport->m_authList.empty() && m_transport->m_endpointList.empty();
+
+            for (vector<Event*>::iterator i = checkEvents.begin(); i != checkEvents.end(); ++i) {
+                if (*i != &stopEvent && *i != &ardpTimerEvent && (*i)->GetEventType() != Event::IO_WRITE) {
+                    delete *i;
+                }
+            }
+
+            for (vector<WriteEntry>::iterator i = writeEvents.begin(); i != writeEvents.end(); ++i) {
+                delete i->m_event;
+            }
+
+            checkEvents.clear();
+            writeEvents.clear();
+
+            checkEvents.push_back(&stopEvent);
+            checkEvents.push_back(&ardpTimerEvent);
+
+            for (list<ListenFdEntry>::iterator i = m_transport->m_listenFds.begin(); i != m_transport->m_listenFds.end();) {
+                if (i->m_shard != m_index) {
+                    ++i;
+                    continue;
+                }
+
+                if (i->m_remove && passive == true && m_transport->m_connecting == 0) {
+                    QCC_DbgPrintf(("UDPTransport::ArdpShard::Run(): Closing socket %d., Removing listen spec \"%s\"",
+                                   i->m_sockFd, i->m_normSpec.c_str()));
+                    qcc::Close(i->m_sockFd);
+                    i = m_transport->m_listenFds.erase(i);
+                    continue;
+                }
+
+                checkEvents.push_back(new Event(i->m_sockFd, Event::IO_READ));
+                writeEvents.push_back(WriteEntry(false, i->m_sockFd, new Event(i->m_sockFd, Event::IO_WRITE)));
+                ++i;
+            }
+
+            m_reload = false;
+
+            m_transport->m_listenFdsLock.Unlock(MUTEX_CONTEXT);
+            m_transport->m_preListLock.Unlock(MUTEX_CONTEXT);
+            m_transport->m_endpointListLock.Unlock(MUTEX_CONTEXT);
+        }
+
+        for (vector<Event*>::iterator i = checkEvents.begin(); i != checkEvents.end();) {
+            if ((*i)->GetEventType() == Event::IO_WRITE) {
+                i = checkEvents.erase(i);
+            } else {
+                ++i;
+            }
+        }
+
+        for (vector<WriteEntry>::iterator i = writeEvents.begin(); i != writeEvents.end(); ++i) {
+            if (i->m_active) {
+                checkEvents.push_back(i->m_event);
+            }
+        }
+
+        signaledEvents.clear();
+
+        status = Event::Wait(checkEvents, signaledEvents);
+        if (status == ER_TIMEOUT) {
+            continue;
+        }
+
+        if (ER_OK != status) {
+            QCC_LogError(status, ("UDPTransport::ArdpShard::Run(): Event::Wait failed"));
+            break;
+        }
+
+        for (vector<Event*>::iterator i = signaledEvents.begin(); i != signaledEvents.end(); ++i) {
+            if (*i == &stopEvent) {
+                stopEvent.ResetEvent();
+            } else if (*i == &ardpTimerEvent) {
+                ardpTimerEvent.ResetEvent();
+            }
+
+            bool socketReady = (*i != &ardpTimerEvent && *i != &stopEvent);
+            bool readReady = (*i)->GetEventType() == Event::IO_READ;
+            bool writeReady = (*i)->GetEventType() == Event::IO_WRITE;
+
+            uint32_t ms;
+            QStatus ardpStatus;
+            m_lock.Lock(MUTEX_CONTEXT);
+            if (socketReady) {
+                ardpStatus = ARDP_Run(m_handle, (*i)->GetFD(), readReady, writeReady, &ms);
+            } else {
+                ardpStatus = ARDP_Run(m_handle, qcc::INVALID_SOCKET_FD, false, false, &ms);
+            }
+            m_lock.Unlock(MUTEX_CONTEXT);
+
+            ardpTimerEvent.ResetTime(ms, 0);
+
+            if (socketReady) {
+                for (vector<WriteEntry>::iterator j = writeEvents.begin(); j != writeEvents.end(); ++j) {
+                    if ((*i)->GetFD() == (*j).m_socket) {
+                        (*j).m_active = (ardpStatus == ER_ARDP_WRITE_BLOCKED);
+                    }
+                }
+            }
+        }
+    }
+
+    for (vector<Event*>::iterator i = checkEvents.begin(); i != checkEvents.end(); ++i) {
+        if (*i != &stopEvent && *i != &ardpTimerEvent && (*i)->GetEventType() != Event::IO_WRITE) {
+            delete *i;
+        }
+    }
+    checkEvents.clear();
+
+    for (vector<WriteEntry>::iterator i = writeEvents.begin(); i != writeEvents.end(); ++i) {
+        delete i->m_event;
+    }
+    writeEvents.clear();
+
+    QCC_DbgPrintf(("UDPTransport::ArdpShard::Run(): shard %d. is exiting status=%s", m_index, QCC_StatusText(status)));
+    return (void*) status;
+}
+
+void UDPTransport::AlertArdp(ArdpHandle* handle)
+{
+    ArdpShard* shard = GetShard(handle);
+    if (shard->m_index == 0) {
+        Alert();
+    } else {
+        shard->Alert();
+    }
+}
+
+/*
+ * Tell the run thread and every ARDP shard that the set of listen FDs has
+ * changed and needs to be reloaded.
+ */
+void UDPTransport::ReloadListenFds()
+{
+    m_reload = STATE_RELOADING;
+    for (uint32_t i = 1; i < m_shards.size(); ++i) {
+        m_shards[i]->m_reload = true;
+        m_shards[i]->Alert();
+    }
+    Alert();
+}
+
 /*
  * The purpose of this code is really to ensure that we don't have any listeners
  * active on Android systems if we have no ongoing advertisements.  This is to
@@ -9773,7 +9978,6 @@ QStatus UDPTransport::Connect(const char* connectSpec, const SessionOpts& opts,
         QCC_DbgPrintf(("UDPTransport::Connect(): EnableDiscoveryListen()"));
         IncrementAndFetch(&m_connecting);
         EnableDiscoveryListen();
-        m_reload = STATE_RELOADING;
 
         /*
          * We are trying to connect, but we don't have an endpoint on any list
@@ -9782,7 +9986,7 @@ QStatus UDPTransport::Connect(const char* connectSpec, const SessionOpts& opts,
          * count of in-process connections until we have an endpoint on a list
          * and then we decrement it.
          */
-        Alert();
+        ReloadListenFds();
     }
     m_listenFdsLock.Unlock(MUTEX_CONTEXT);
     m_listenRequestsLock.Unlock(MUTEX_CONTEXT);
@@ -9923,11 +10127,20 @@ QStatus UDPTransport::Connect(const char* connectSpec, const SessionOpts& opts,
      * to see if any of our sockets is bound to INADDR_ANY irrespective of port.
      */
     qcc::SocketFd sock = 0;
+    qcc::String sockSpec;
     bool foundSock = false;
 
     QCC_DbgPrintf(("UDPTransport::Connect(): Look for socket corresponding to destination network"));
     m_listenFdsLock.Lock(MUTEX_CONTEXT);
     for (list<ListenFdEntry>::iterator i = m_listenFds.begin(); i != m_listenFds.end(); ++i) {
+        /*
+         * Every listen spec has a socket on shard zero, so that is where we
+         * look.  The shard that will own the connection is picked below.
+         */
+        if (i->m_shard != 0) {
+            continue;
+        }
+
         /*
          * Get the local address of the socket in question.
          */
@@ -9942,6 +10155,7 @@ QStatus UDPTransport::Connect(const char* connectSpec, const SessionOpts& opts,
          */
         if (listenAddr.ToString() == "0.0.0.0") {
             sock = i->m_sockFd;
+            sockSpec = i->m_normSpec;
             foundSock = true;
             QCC_DbgPrintf(("UDPTransport::Connect(): Found socket (%d.) listening on INADDR_ANY", sock));
             break;
@@ -10001,6 +10215,7 @@ QStatus UDPTransport::Connect(const char* connectSpec, const SessionOpts& opts,
              * choice other specific choices.
              */
             sock = i->m_sockFd;
+            sockSpec = i->m_normSpec;
             foundSock = true;
         } else {
             QCC_DbgPrintf(("UDPTransport::Connect(): network \"%s\" does not match network \"%s\"",
@@ -10008,6 +10223,28 @@ QStatus UDPTransport::Connect(const char* connectSpec, const SessionOpts& opts,
         }
     }
 
+    /*
+     * Spread active connections over the ARDP shards.  The connection stays
+     * on the shard we pick for its whole life, so it must use that shard's
+     * socket for the listen spec we found.  If the spec could not be sharded,
+     * shard zero takes it.
+     */
+    uint32_t shardIndex = static_cast<uint32_t>(IncrementAndFetch(&m_nextShard)) % m_shards.size();
+    if (foundSock && shardIndex != 0) {
+        bool foundShardSock = false;
+        for (list<ListenFdEntry>::iterator i = m_listenFds.begin(); i != m_listenFds.end(); ++i) {
+            if (i->m_shard == shardIndex && i->m_normSpec == sockSpec && i->m_remove == false) {
+                sock = i->m_sockFd;
+                foundShardSock = true;
+                break;
+            }
+        }
+        if (foundShardSock == false) {
+            shardIndex = 0;
+        }
+    }
+    ArdpShard* shard = m_shards[shardIndex];
+
     m_listenFdsLock.Unlock(MUTEX_CONTEXT);
 
     if (foundSock == false) {
@@ -10117,9 +10354,9 @@ QStatus UDPTransport::Connect(const char* connectSpec, const SessionOpts& opts,
      * and   We'll keep that order.
      */
     m_endpointListLock.Lock(MUTEX_CONTEXT);
-    m_ardpLock.Lock(MUTEX_CONTEXT);
-    QCC_DbgPrintf(("UDPTransport::Connect(): ARDP_Connect()"));
-    status = ARDP_Connect(m_handle, sock, ipAddr, ipPort, m_ardpConfig.segmax, m_ardpConfig.segbmax, &conn, buf, buflen, &event);
+    shard->m_lock.Lock(MUTEX_CONTEXT);
+    QCC_DbgPrintf(("UDPTransport::Connect(): ARDP_Connect() on shard %d.", shardIndex));
+    status = ARDP_Connect(shard->m_handle, sock, ipAddr, ipPort, m_ardpConfig.segmax, m_ardpConfig.segbmax, &conn, buf, buflen, &event);
 
     /*
      * The ARDP code takes the hello buffer and copies it into its internal
@@ -10137,7 +10374,7 @@ QStatus UDPTransport::Connect(const char* connectSpec, const SessionOpts& opts,
     if (status != ER_OK) {
         QCC_ASSERT(conn == NULL && "UDPTransport::Connect(): ARDP_Connect() failed but returned ArdpConnRecord");
         QCC_LogError(status, ("UDPTransport::Connect(): ARDP_Connect() failed"));
-        m_ardpLock.Unlock(MUTEX_CONTEXT);
+        shard->m_lock.Unlock(MUTEX_CONTEXT);
         m_endpointListLock.Unlock(MUTEX_CONTEXT);
 
         m_connLock.Lock(MUTEX_CONTEXT);
@@ -10164,7 +10401,7 @@ QStatus UDPTransport::Connect(const char* connectSpec, const SessionOpts& opts,
     Thread* thread = GetThread();
     QCC_DbgPrintf(("UDPTransport::Connect(): Add thread=%p to m_connectThreads", thread));
     QCC_ASSERT(thread && "UDPTransport::Connect(): GetThread() returns NULL");
-    uint32_t cid = ARDP_GetConnId(m_handle, conn);
+    uint32_t cid = ARDP_GetConnId(shard->m_handle, conn);
     ConnectEntry entry(thread, conn, cid, &event);
 
     /*
@@ -10201,12 +10438,12 @@ QStatus UDPTransport::Connect(const char* connectSpec, const SessionOpts& opts,
      * start connect timers), we need to call back into ARDP ASAP to get it
      * moving.
      */
-    Alert();
+    AlertArdp(shard->m_handle);
 
     /*
      * All done with the tricky part, so release the locks in inverse order
      */
-    m_ardpLock.Unlock(MUTEX_CONTEXT);
+    shard->m_lock.Unlock(MUTEX_CONTEXT);
     m_endpointListLock.Unlock(MUTEX_CONTEXT);
 
     /*
@@ -10744,8 +10981,7 @@ void UDPTransport::DoStopListen(qcc::String& normSpec)
         }
     }
 
-    m_reload = STATE_RELOADING;
-    Alert();
+    ReloadListenFds();
 
     m_listenFdsLock.Unlock(MUTEX_CONTEXT);
     DecrementAndFetch(&m_refCount);
@@ -11206,6 +11442,56 @@ void UDPTransport::QueueHandleNetworkEvent(const std::map<qcc::String, qcc::IPAd
  * handler may also be invoked because another transport called the OpenInterface() method of the name
  * service and one or more of the interfaces requested by this transport has become IFF_UP.
  */
+/*
+ * Create the sockets for ARDP shards one and up, bound to the same address and
+ * port as listenFd (which belongs to shard zero and is already bound), and ask
+ * the kernel to steer each inbound datagram to the shard that owns its ARDP
+ * connection.  The destination ARDP port of a segment is a local port that
+ * ARDP_SetPortPartition() placed in exactly one shard; a SYN has no
+ * destination port yet, so it is steered by its source port and the accepting
+ * shard then picks a local port of its own.  Sockets join the group in the
+ * order they are bound, which is also the shard order.
+ */
+QStatus UDPTransport::CreateShardSockets(const qcc::IPAddress& listenAddr, uint16_t listenPort, qcc::SocketFd listenFd, std::vector<qcc::SocketFd>& shardFds)
+{
+    QCC_DbgTrace(("UDPTransport::CreateShardSockets(listenAddr=\"%s\", listenPort=%u.)", listenAddr.ToString().c_str(), listenPort));
+
+    QStatus status = ER_OK;
+    for (uint32_t i = 1; i < m_shards.size() && status == ER_OK; ++i) {
+        SocketFd sockFd = INVALID_SOCKET_FD;
+        status = Socket(QCC_AF_INET, QCC_SOCK_DGRAM, sockFd);
+        if (status != ER_OK) {
+            break;
+        }
+        shardFds.push_back(sockFd);
+
+        status = qcc::SetBlocking(sockFd, false);
+        if (status == ER_OK) {
+            /* Not fatal, just as for the socket of shard zero */
+            qcc::SetSndBuf(sockFd, m_ardpConfig.segmax * m_ardpConfig.segbmax);
+            qcc::SetRcvBuf(sockFd, m_ardpConfig.segmax * m_ardpConfig.segbmax);
+            status = qcc::SetReusePortGroup(sockFd);
+        }
+        if (status == ER_OK) {
+            status = Bind(sockFd, listenAddr, listenPort);
+        }
+    }
+
+    if (status == ER_OK) {
+        status = qcc::SetReusePortSteering(listenFd, static_cast<uint16_t>(m_shards.size()), offsetof(ArdpHeader, dst), offsetof(ArdpHeader, src));
+    }
+
+    if (status != ER_OK) {
+        QCC_LogError(status, ("UDPTransport::CreateShardSockets(): Cannot shard %s/%d, using a single ARDP shard",
+                              listenAddr.ToString().c_str(), listenPort));
+        for (uint32_t i = 0; i < shardFds.size(); ++i) {
+            qcc::Close(shardFds[i]);
+        }
+        shardFds.clear();
+    }
+    return status;
+}
+
 void UDPTransport::HandleNetworkEventInstance(ListenRequest& listenRequest)
 {
     QCC_DbgTrace(("UDPTransport::HandleNetworkEventInstance()"));
@@ -11215,6 +11501,7 @@ void UDPTransport::HandleNetworkEventInstance(ListenRequest& listenRequest)
     IncrementAndFetch(&m_refCount);
     list<String> replacedList;
     list<pair<qcc::String, SocketFd> > addedList;
+    list<ListenFdEntry> shardList;
     bool wildcardIfaceRequested = (m_requestedInterfaces.find("*") != m_requestedInterfaces.end());
     bool wildcardAddressRequested = (m_requestedAddresses.find("0.0.0.0") != m_requestedAddresses.end());
 
@@ -11421,6 +11708,17 @@ void UDPTransport::HandleNetworkEventInstance(ListenRequest& listenRequest)
         QCC_DbgPrintf(("UDPTransport::HandleNetworkEventInstance(): GetRcvBuf(listenFd=%d) <= %u. bytes)", listenFd, rcvSize));
 #endif
 
+        /*
+         * If there is more than one ARDP shard, this socket is the first member
+         * of a group of sockets sharing the address and port, one per shard.
+         * If the group cannot be formed, shard zero serves this listen spec
+         * alone.
+         */
+        bool sharded = false;
+        if (m_shards.size() > 1) {
+            sharded = (qcc::SetReusePortGroup(listenFd) == ER_OK);
+        }
+
         QCC_DbgPrintf(("UDPTransport::HandleNetworkEventInstance(): Bind(listenFd=%d., listenAddr=\"%s\", listenPort=%u.)",
                        listenFd, listenAddr.ToString().c_str(), listenPort));
         status = Bind(listenFd, listenAddr, listenPort);
@@ -11459,6 +11757,13 @@ void UDPTransport::HandleNetworkEventInstance(ListenRequest& listenRequest)
              * the list of network interfaces.
              */
             addedList.push_back(pair<qcc::String, SocketFd>(normSpec, listenFd));
+
+            std::vector<SocketFd> shardFds;
+            if (sharded && CreateShardSockets(listenAddr, listenPort, listenFd, shardFds) == ER_OK) {
+                for (uint32_t i = 0; i < shardFds.size(); ++i) {
+                    shardList.push_back(ListenFdEntry(normSpec, shardFds[i], i + 1));
+                }
+            }
         } else {
             QCC_LogError(status, ("UDPTransport::HandleNetworkEventInstance(): Failed to bind to %s/%d", listenAddr.ToString().c_str(), listenPort));
         }
@@ -11582,16 +11887,16 @@ void UDPTransport::HandleNetworkEventInstance(ListenRequest& listenRequest)
             QCC_DbgPrintf(("UDPTransport::HandleNetworkEventInstance(): Adding normalized listen spec \"%s\", sockFd %d. to m_listenFds",
                            it->first.c_str(), it->second));
             m_listenFds.push_back(entry);
-            m_reload = STATE_RELOADING;
         }
+        m_listenFds.insert(m_listenFds.end(), shardList.begin(), shardList.end());
 
         /*
-         * Signal the (probably) waiting run thread so it will wake up and add
-         * the new socket(s) to its list of sockets it is waiting for
-         * connections on.
+         * Signal the (probably) waiting run thread and shards so they will
+         * wake up and add the new socket(s) to their lists of sockets they are
+         * waiting for connections on.
          */
-        QCC_DbgPrintf(("UDPTransport::HandleNetworkEventInstance(): Alert()"));
-        Alert();
+        QCC_DbgPrintf(("UDPTransport::HandleNetworkEventInstance(): ReloadListenFds()"));
+        ReloadListenFds();
 
         m_listenFdsLock.Unlock(MUTEX_CONTEXT);
     }
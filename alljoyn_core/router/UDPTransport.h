@@ -29,6 +29,7 @@
 
 #include <list>
 #include <queue>
+#include <vector>
 #include <alljoyn/Status.h>
 
 #include <qcc/platform.h>
@@ -355,9 +356,10 @@ class UDPTransport : public Transport, public _RemoteEndpoint::EndpointListener,
 
     class ListenFdEntry {
       public:
-        ListenFdEntry(qcc::String normSpec, qcc::SocketFd sockFd) : m_normSpec(normSpec), m_sockFd(sockFd), m_remove(false) { }
+        ListenFdEntry(qcc::String normSpec, qcc::SocketFd sockFd, uint16_t shard = 0) : m_normSpec(normSpec), m_sockFd(sockFd), m_shard(shard), m_remove(false) { }
         qcc::String m_normSpec;  /**< The normalized listen spec for this entry */
         qcc::SocketFd m_sockFd;  /**< The socket associated with this entry */
+        uint16_t m_shard;        /**< The index of the ARDP shard that reads from this socket */
         bool m_remove;           /**< If true, a request to stop listening on this liste spec has been received */
     };
 
@@ -870,10 +872,46 @@ class UDPTransport : public Transport, public _RemoteEndpoint::EndpointListener,
      */
     ArdpGlobalConfig m_ardpConfig;
 
-    qcc::Mutex m_ardpLock;  /**< Since written for embedded as well as daemon environments, ARDP is not thread-safe */
+    /**
+     * The number of datagrams each ARDP instance moves per system call, from
+     * the udp_batch configuration limit.  One means no batching.
+     */
+    uint32_t m_ardpBatch;
+
     qcc::Mutex m_cbLock;    /**< Lock to synchronize interactions between callback contexts and other threads */
 
-    ArdpHandle* m_handle;
+    /**
+     * An ArdpShard is one instance of the ARDP protocol with its own handle,
+     * its own lock and its own sockets.  When more than one shard is
+     * configured, every listen spec gets one socket per shard, all bound to
+     * the same address and port with SO_REUSEPORT, and the kernel steers each
+     * datagram to the shard that owns the connection (see
+     * ARDP_SetPortPartition).  Shard zero is driven by the UDPTransport::Run
+     * thread; every other shard runs its own thread.
+     */
+    class ArdpShard : public qcc::Thread {
+      public:
+        ArdpShard(UDPTransport* transport, uint16_t index, uint16_t count);
+        ~ArdpShard();
+
+        UDPTransport* m_transport;  /**< The transport that owns this shard */
+        uint16_t m_index;           /**< The index of this shard in m_shards */
+        qcc::Mutex m_lock;          /**< Since written for embedded as well as daemon environments, ARDP is not thread-safe */
+        ArdpHandle* m_handle;       /**< The ARDP instance of this shard */
+        volatile bool m_reload;     /**< True if this shard must reload its listen FDs (written under m_listenFdsLock) */
+
+      protected:
+        qcc::ThreadReturn STDCALL Run(void* arg);
+    };
+
+    std::vector<ArdpShard*> m_shards;  /**< The ARDP shards, from the udp_shards configuration limit */
+    volatile int32_t m_nextShard;      /**< Round-robin counter used to pin active connections to a shard */
+
+    static ArdpShard* GetShard(ArdpHandle* handle) { return static_cast<ArdpShard*>(ARDP_GetHandleContext(handle)); }
+    static qcc::Mutex& GetArdpLock(ArdpHandle* handle) { return GetShard(handle)->m_lock; }
+    void AlertArdp(ArdpHandle* handle);
+    void ReloadListenFds();
+    QStatus CreateShardSockets(const qcc::IPAddress& listenAddr, uint16_t listenPort, qcc::SocketFd listenFd, std::vector<qcc::SocketFd>& shardFds);
 
     /**
      * MessageDispatcherThread handles AllJoyn messages that have been received
@@ -0,0 +1,358 @@
+/**
+ * @file
+ * WildcardTrie indexes bus names and wildcard name patterns so that
+ * advertisements and discovery requests can be matched without scanning
+ * every entry.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#ifndef _ALLJOYN_WILDCARDTRIE_H
+#define _ALLJOYN_WILDCARDTRIE_H
+
+#include <qcc/platform.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include <qcc/String.h>
+
+#include "BusUtil.h"
+
+namespace ajn {
+
+/**
+ * A WildcardTrie is a multimap from string keys to values that can be searched
+ * with the '*' and '?' wildcards understood by WildcardMatch().  Keys are stored
+ * in a prefix trie under their literal prefix, the characters that precede the
+ * first wildcard.  This lets both kinds of search used by name discovery run in
+ * time proportional to the length of the name or pattern being looked up rather
+ * than to the number of keys:
+ *
+ *   - MatchPattern() treats the keys as names, for example the advertised names
+ *     of the name service, and finds the keys matched by a pattern.
+ *   - MatchName() treats the keys as patterns, for example discovery prefixes,
+ *     and finds the keys that match a name.
+ *
+ * Only keys that share the literal prefix of the search are ever examined.  The
+ * common exact and "prefix*" forms are answered from the trie alone; any other
+ * candidate is confirmed with WildcardMatch() so results are always identical to
+ * comparing every key with WildcardMatch().  Empty keys can never be matched and
+ * are not stored.
+ *
+ * A WildcardTrie is not thread-safe; it is protected by the lock of its owner.
+ */
+template <typename T>
+class WildcardTrie {
+  public:
+
+    /**
+     * Constructor.
+     */
+    WildcardTrie() : root(new Node()) { }
+
+    /**
+     * Destructor.
+     */
+    ~WildcardTrie()
+    {
+        delete root;
+    }
+
+    /**
+     * Add a key/value pair.  A key may be added more than once with the same or
+     * different values.
+     *
+     * @param key    The name or pattern.
+     * @param value  The value to return when the key is matched.
+     */
+    void Insert(const qcc::String& key, const T& value)
+    {
+        if (key.empty()) {
+            return;
+        }
+        size_t prefixLen = LiteralPrefixLength(key);
+        Node* node = root;
+        ++node->count;
+        for (size_t i = 0; i < prefixLen; ++i) {
+            Node*& child = node->children[key[i]];
+            if (!child) {
+                child = new Node();
+            }
+            node = child;
+            ++node->count;
+        }
+        node->entries.insert(std::make_pair(key, value));
+    }
+
+    /**
+     * Remove one key/value pair added by Insert().
+     *
+     * @param key    The name or pattern.
+     * @param value  The value that was added with the key.
+     *
+     * @return true if the pair was found and removed.
+     */
+    bool Erase(const qcc::String& key, const T& value)
+    {
+        if (key.empty()) {
+            return false;
+        }
+        size_t prefixLen = LiteralPrefixLength(key);
+        std::vector<Node*> path;
+        path.reserve(prefixLen + 1);
+        Node* node = root;
+        path.push_back(node);
+        for (size_t i = 0; i < prefixLen; ++i) {
+            typename Node::ChildMap::iterator cit = node->children.find(key[i]);
+            if (cit == node->children.end()) {
+                return false;
+            }
+            node = cit->second;
+            path.push_back(node);
+        }
+
+        typename Node::EntryMap::iterator it = node->entries.lower_bound(key);
+        while ((it != node->entries.end()) && (it->first == key) && !(it->second == value)) {
+            ++it;
+        }
+        if ((it == node->entries.end()) || (it->first != key)) {
+            return false;
+        }
+        node->entries.erase(it);
+
+        /*
+         * Drop the count of every node on the path and prune the first subtree
+         * that no longer holds any entries.
+         */
+        for (size_t i = 0; i < path.size(); ++i) {
+            if ((--path[i]->count == 0) && (i > 0)) {
+                path[i - 1]->children.erase(key[i - 1]);
+                delete path[i];
+                break;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Test if there are no keys.
+     *
+     * @return true if the trie is empty.
+     */
+    bool Empty() const
+    {
+        return root->count == 0;
+    }
+
+    /**
+     * Test if a pattern matches any of the keys.
+     *
+     * @param pattern  The pattern, which may contain wildcards.
+     *
+     * @return true if WildcardMatch(key, pattern) finds a match for some key.
+     */
+    bool MatchPattern(const qcc::String& pattern) const
+    {
+        return MatchPattern(pattern, NULL);
+    }
+
+    /**
+     * Get the values of the keys that are matched by a pattern.
+     *
+     * @param pattern      The pattern, which may contain wildcards.
+     * @param[out] values  The values of the matching keys are added to this set.
+     */
+    void MatchPattern(const qcc::String& pattern, std::set<T>& values) const
+    {
+        MatchPattern(pattern, &values);
+    }
+
+    /**
+     * Test if any of the keys match a name.
+     *
+     * @param name  The name to look up.
+     *
+     * @return true if WildcardMatch(name, key) finds a match for some key.
+     */
+    bool MatchName(const qcc::String& name) const
+    {
+        return MatchName(name, NULL);
+    }
+
+    /**
+     * Get the values of the keys that match a name.
+     *
+     * @param name         The name to look up.
+     * @param[out] values  The values of the matching keys are added to this set.
+     */
+    void MatchName(const qcc::String& name, std::set<T>& values) const
+    {
+        MatchName(name, &values);
+    }
+
+  private:
+
+    /**
+     * A node of the trie.  Each node holds the keys whose literal prefix is the
+     * path to the node.
+     */
+    struct Node {
+        typedef std::map<char, Node*> ChildMap;
+        typedef std::multimap<qcc::String, T> EntryMap;
+
+        ChildMap children;      /**< Child nodes indexed by the next character */
+        EntryMap entries;       /**< Keys ending at this node and their values */
+        size_t count;           /**< Number of entries in this subtree */
+
+        Node() : count(0) { }
+
+        ~Node()
+        {
+            for (typename ChildMap::iterator it = children.begin(); it != children.end(); ++it) {
+                delete it->second;
+            }
+        }
+    };
+
+    /**
+     * Copying is not supported.
+     */
+    WildcardTrie(const WildcardTrie& other);
+
+    /**
+     * Assignment is not supported.
+     */
+    WildcardTrie& operator=(const WildcardTrie& other);
+
+    /**
+     * Get the length of the part of a key or pattern before the first wildcard.
+     */
+    static size_t LiteralPrefixLength(const qcc::String& str)
+    {
+        size_t len = 0;
+        while ((len < str.size()) && (str[len] != '*') && (str[len] != '?')) {
+            ++len;
+        }
+        return len;
+    }
+
+    /**
+     * Collect the values of the keys in a subtree that are matched by a
+     * pattern.  Stops at the first match if values is NULL.
+     */
+    static bool MatchSubtree(const Node* node, const qcc::String& pattern, bool matchAll, std::set<T>* values)
+    {
+        bool found = false;
+        for (typename Node::EntryMap::const_iterator it = node->entries.begin(); it != node->entries.end(); ++it) {
+            if (matchAll || !WildcardMatch(it->first, pattern)) {
+                found = true;
+                if (!values) {
+                    return true;
+                }
+                values->insert(it->second);
+            }
+        }
+        for (typename Node::ChildMap::const_iterator it = node->children.begin(); it != node->children.end(); ++it) {
+            if (MatchSubtree(it->second, pattern, matchAll, values)) {
+                found = true;
+                if (!values) {
+                    return true;
+                }
+            }
+        }
+        return found;
+    }
+
+    bool MatchPattern(const qcc::String& pattern, std::set<T>* values) const
+    {
+        if (pattern.empty()) {
+            return false;
+        }
+
+        /*
+         * Every key matched by the pattern starts with its literal prefix.
+         */
+        size_t prefixLen = LiteralPrefixLength(pattern);
+        const Node* node = root;
+        for (size_t i = 0; i < prefixLen; ++i) {
+            typename Node::ChildMap::const_iterator cit = node->children.find(pattern[i]);
+            if (cit == node->children.end()) {
+                return false;
+            }
+            node = cit->second;
+        }
+
+        if (prefixLen == pattern.size()) {
+            /* No wildcards so only an identical key matches */
+            bool found = false;
+            typename Node::EntryMap::const_iterator it = node->entries.lower_bound(pattern);
+            for (; (it != node->entries.end()) && (it->first == pattern); ++it) {
+                found = true;
+                if (!values) {
+                    break;
+                }
+                values->insert(it->second);
+            }
+            return found;
+        }
+
+        /* A single trailing '*' matches every key that starts with the prefix */
+        bool matchAll = (prefixLen == pattern.size() - 1) && (pattern[prefixLen] == '*');
+        if (matchAll && !values) {
+            return node->count > 0;
+        }
+        return MatchSubtree(node, pattern, matchAll, values);
+    }
+
+    bool MatchName(const qcc::String& name, std::set<T>* values) const
+    {
+        if (name.empty()) {
+            return false;
+        }
+
+        /*
+         * A key can only match the name if its literal prefix is a prefix of
+         * the name so just the nodes along the path of the name are examined.
+         */
+        bool found = false;
+        const Node* node = root;
+        for (size_t i = 0; node; ++i) {
+            for (typename Node::EntryMap::const_iterator it = node->entries.begin(); it != node->entries.end(); ++it) {
+                if (!WildcardMatch(name, it->first)) {
+                    found = true;
+                    if (!values) {
+                        return true;
+                    }
+                    values->insert(it->second);
+                }
+            }
+            if (i == name.size()) {
+                break;
+            }
+            typename Node::ChildMap::const_iterator cit = node->children.find(name[i]);
+            node = (cit == node->children.end()) ? NULL : cit->second;
+        }
+        return found;
+    }
+
+    Node* root;     /**< Root of the trie, holding keys that start with a wildcard */
+};
+
+}
+
+#endif
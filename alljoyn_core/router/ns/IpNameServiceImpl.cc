@@ -2530,9 +2530,10 @@ QStatus IpNameServiceImpl::AdvertiseName(TransportMask transportMask, vector<qcc
     //
     if (quietly) {
         for (uint32_t i = 0; i < wkn.size(); ++i) {
-            set<qcc::String>::iterator j = find(m_advertised_quietly[transportIndex].begin(), m_advertised_quietly[transportIndex].end(), wkn[i]);
+            set<qcc::String>::iterator j = m_advertised_quietly[transportIndex].find(wkn[i]);
             if (j == m_advertised_quietly[transportIndex].end()) {
                 m_advertised_quietly[transportIndex].insert(wkn[i]);
+                m_advertisedQuietlyIndex[transportIndex].Insert(wkn[i], wkn[i]);
             } else {
                 //
                 // Nothing has changed, so don't bother.
@@ -2552,9 +2553,10 @@ QStatus IpNameServiceImpl::AdvertiseName(TransportMask transportMask, vector<qcc
         return ER_OK;
     } else {
         for (uint32_t i = 0; i < wkn.size(); ++i) {
-            set<qcc::String>::iterator j = find(m_advertised[transportIndex].begin(), m_advertised[transportIndex].end(), wkn[i]);
+            set<qcc::String>::iterator j = m_advertised[transportIndex].find(wkn[i]);
             if (j == m_advertised[transportIndex].end()) {
                 m_advertised[transportIndex].insert(wkn[i]);
+                m_advertisedIndex[transportIndex].Insert(wkn[i], wkn[i]);
             } else {
                 //
                 // Nothing has changed, so don't bother.
@@ -2867,9 +2869,10 @@ QStatus IpNameServiceImpl::CancelAdvertiseName(TransportMask transportMask, vect
     // names that have changes in status reflected out on the network.
     if (quietly) {
         for (uint32_t i = 0; i < wkn.size(); ++i) {
-            set<qcc::String>::iterator k = find(m_advertised_quietly[transportIndex].begin(), m_advertised_quietly[transportIndex].end(), wkn[i]);
+            set<qcc::String>::iterator k = m_advertised_quietly[transportIndex].find(wkn[i]);
             if (k != m_advertised_quietly[transportIndex].end()) {
                 m_advertised_quietly[transportIndex].erase(k);
+                m_advertisedQuietlyIndex[transportIndex].Erase(wkn[i], wkn[i]);
             }
         }
         //
@@ -2881,9 +2884,10 @@ QStatus IpNameServiceImpl::CancelAdvertiseName(TransportMask transportMask, vect
     } else {
         bool changed = false;
         for (uint32_t i = 0; i < wkn.size(); ++i) {
-            set<qcc::String>::iterator j = find(m_advertised[transportIndex].begin(), m_advertised[transportIndex].end(), wkn[i]);
+            set<qcc::String>::iterator j = m_advertised[transportIndex].find(wkn[i]);
             if (j != m_advertised[transportIndex].end()) {
                 m_advertised[transportIndex].erase(j);
+                m_advertisedIndex[transportIndex].Erase(wkn[i], wkn[i]);
                 changed = true;
             }
         }
@@ -6342,6 +6346,16 @@ void IpNameServiceImpl::Retransmit(uint32_t transportIndex, bool exiting, bool q
         return;
     }
 
+    //
+    // When replying to a query we only send the names that match one of the
+    // names asked about.  Index the requested names so each advertisement can
+    // be checked against all of them at once.
+    //
+    WildcardTrie<qcc::String> wknIndex;
+    for (vector<String>::iterator itWkn = wkns.begin(); itWkn != wkns.end(); itWkn++) {
+        wknIndex.Insert(*itWkn, *itWkn);
+    }
+
     //
     // We are now at version one of the protocol.  There is a significant
     // difference between version zero and version one messages, so down-version
@@ -6632,15 +6646,7 @@ void IpNameServiceImpl::Retransmit(uint32_t transportIndex, bool exiting, bool q
 
             //Do not send non-matching names if replying quietly
             if (quietly) {
-                bool ignoreName = true;
-                for (vector<String>::iterator itWkn = wkns.begin(); itWkn != wkns.end(); itWkn++) {
-                    //Do not send non-matching names if replying quietly
-                    if (!(WildcardMatch((*i), (*itWkn)))) {
-                        ignoreName = false;
-                        break;
-                    }
-                }
-                if (ignoreName) {
+                if (!wknIndex.MatchName(*i)) {
                     continue;
                 }
             }
@@ -6729,15 +6735,7 @@ void IpNameServiceImpl::Retransmit(uint32_t transportIndex, bool exiting, bool q
         if (quietly) {
             for (set<qcc::String>::iterator i = m_advertised_quietly[transportIndex].begin(); i != m_advertised_quietly[transportIndex].end(); ++i) {
                 if (quietly) {
-                    bool ignoreName = true;
-                    for (vector<String>::iterator itWkn = wkns.begin(); itWkn != wkns.end(); itWkn++) {
-                        //Do not send non-matching names if replying quietly
-                        if (!(WildcardMatch((*i), (*itWkn)))) {
-                            ignoreName = false;
-                            break;
-                        }
-                    }
-                    if (ignoreName) {
+                    if (!wknIndex.MatchName(*i)) {
                         continue;
                     }
                 }
@@ -6918,15 +6916,7 @@ void IpNameServiceImpl::Retransmit(uint32_t transportIndex, bool exiting, bool q
 
                 //Do not send non-matching names if requestor has set send_matching_only i.e. wkns.size() > 0
                 if (wkns.size() > 0) {
-                    bool ignoreName = true;
-                    for (vector<String>::iterator itWkn = wkns.begin(); itWkn != wkns.end(); itWkn++) {
-                        //Do not send non-matching names if requestor has set send_matching_only i.e. wkns.size() > 0
-                        if (!(WildcardMatch((*it), (*itWkn)))) {
-                            ignoreName = false;
-                            break;
-                        }
-                    }
-                    if (ignoreName) {
+                    if (!wknIndex.MatchName(*it)) {
                         continue;
                     }
                 }
@@ -7017,15 +7007,7 @@ void IpNameServiceImpl::Retransmit(uint32_t transportIndex, bool exiting, bool q
                 for (set<qcc::String>::iterator it = advertising_quietly.begin(); it != advertising_quietly.end(); ++it) {
                     //Do not send non-matching names if requestor has set send_matching_only i.e. wkns.size() > 0
                     if (wkns.size() > 0) {
-                        bool ignoreName = true;
-                        for (vector<String>::iterator itWkn = wkns.begin(); itWkn != wkns.end(); itWkn++) {
-                            //Do not send non-matching names if requestor has set send_matching_only i.e. wkns.size() > 0
-                            if (!(WildcardMatch((*it), (*itWkn)))) {
-                                ignoreName = false;
-                                break;
-                            }
-                        }
-                        if (ignoreName) {
+                        if (!wknIndex.MatchName(*it)) {
                             continue;
                         }
                     }
@@ -7223,40 +7205,26 @@ void IpNameServiceImpl::HandleProtocolQuestion(WhoHas whoHas, const qcc::IPEndpo
             // from V1 to support legacy thin core leaf nodes looking for router
             // nodes.
             //
-            for (set<qcc::String>::iterator j = m_advertised[index].begin(); m_enableV1 && (j != m_advertised[index].end()); ++j) {
-
-                //
-                // The requested name comes in from the WhoHas message and we
-                // allow wildcards there.
-                //
-                if (WildcardMatch((*j), wkn)) {
-                    QCC_DbgPrintf(("IpNameServiceImpl::HandleProtocolQuestion(): request for %s does not match my %s",
-                                   wkn.c_str(), (*j).c_str()));
-                    continue;
-                } else {
-                    respond = true;
-                    break;
-                }
+            // The requested name comes in from the WhoHas message and we
+            // allow wildcards there.  The index only looks at the names that
+            // share the prefix of the request.
+            //
+            if (m_enableV1 && m_advertisedIndex[index].MatchPattern(wkn)) {
+                respond = true;
+            } else {
+                QCC_DbgPrintf(("IpNameServiceImpl::HandleProtocolQuestion(): request for %s does not match my advertisements",
+                               wkn.c_str()));
             }
 
             //
             // Check to see if this name on the list of names we quietly advertise.
             //
-            for (set<qcc::String>::iterator j = m_advertised_quietly[index].begin(); j != m_advertised_quietly[index].end(); ++j) {
-
-                //
-                // The requested name comes in from the WhoHas message and we
-                // allow wildcards there.
-                //
-                if (WildcardMatch((*j), wkn)) {
-                    QCC_DbgPrintf(("IpNameServiceImpl::HandleProtocolQuestion(): request for %s does not match my %s",
-                                   wkn.c_str(), (*j).c_str()));
-                    continue;
-                } else {
-                    respond = true;
-                    respondQuietly = true;
-                    break;
-                }
+            if (m_advertisedQuietlyIndex[index].MatchPattern(wkn)) {
+                respond = true;
+                respondQuietly = true;
+            } else {
+                QCC_DbgPrintf(("IpNameServiceImpl::HandleProtocolQuestion(): request for %s does not match my quiet advertisements",
+                               wkn.c_str()));
             }
         }
 
@@ -8359,40 +8327,26 @@ bool IpNameServiceImpl::HandleSearchQuery(TransportMask completeTransportMask, M
             //
             // Check to see if this name on the list of names we actively advertise.
             //
-            for (set<String>::iterator j = m_advertised[index].begin(); j != m_advertised[index].end(); ++j) {
-
-                //
-                // The requested name comes in from the WhoHas message and we
-                // allow wildcards there.
-                //
-                if (WildcardMatch((*j), wkn)) {
-                    QCC_DbgPrintf(("IpNameServiceImpl::HandleSearchQuery(): request for %s does not match my %s",
-                                   wkn.c_str(), (*j).c_str()));
-                    continue;
-                } else {
-                    respond = true;
-                    break;
-                }
+            // The requested name comes in from the WhoHas message and we
+            // allow wildcards there.  The index only looks at the names that
+            // share the prefix of the request.
+            //
+            if (m_advertisedIndex[index].MatchPattern(wkn)) {
+                respond = true;
+            } else {
+                QCC_DbgPrintf(("IpNameServiceImpl::HandleSearchQuery(): request for %s does not match my advertisements",
+                               wkn.c_str()));
             }
 
             //
             // Check to see if this name on the list of names we quietly advertise.
             //
-            for (set<String>::iterator j = m_advertised_quietly[index].begin(); j != m_advertised_quietly[index].end(); ++j) {
-
-                //
-                // The requested name comes in from the WhoHas message and we
-                // allow wildcards there.
-                //
-                if (WildcardMatch((*j), wkn)) {
-                    QCC_DbgPrintf(("IpNameServiceImpl::HandleSearchQuery(): request for %s does not match my %s",
-                                   wkn.c_str(), (*j).c_str()));
-                    continue;
-                } else {
-                    respond = true;
-                    respondQuietly = true;
-                    break;
-                }
+            if (m_advertisedQuietlyIndex[index].MatchPattern(wkn)) {
+                respond = true;
+                respondQuietly = true;
+            } else {
+                QCC_DbgPrintf(("IpNameServiceImpl::HandleSearchQuery(): request for %s does not match my quiet advertisements",
+                               wkn.c_str()));
             }
         }
         //
@@ -48,6 +48,7 @@
 #include "IpNsProtocol.h"
 #include "IpNameService.h"
 #include "ConfigDB.h"
+#include "WildcardTrie.h"
 
 namespace ajn {
 
@@ -1280,6 +1281,14 @@ class IpNameServiceImpl : public qcc::Thread {
      */
     std::set<qcc::String> m_advertised_quietly[N_TRANSPORTS];
 
+    /**
+     * @internal @brief Indices of the names in m_advertised and
+     * m_advertised_quietly used to match the names in received queries without
+     * scanning every advertisement.
+     */
+    WildcardTrie<qcc::String> m_advertisedIndex[N_TRANSPORTS];
+    WildcardTrie<qcc::String> m_advertisedQuietlyIndex[N_TRANSPORTS];
+
     /**
      * @internal
      * @brief The daemon GUID string of the daemon assoicated with this instance
@@ -39,9 +39,14 @@
 #if defined(QCC_OS_DARWIN)
 #include <sys/ucred.h>
 #endif
+#if defined(QCC_OS_LINUX)
+#include <linux/filter.h>
+#endif
 
 #include <qcc/IPAddress.h>
 #include "ScatterGatherList.h"
+#include <qcc/PerfCounters.h>
+#include <qcc/Socket.h>
 #include <qcc/Util.h>
 #include <qcc/Thread.h>
 
@@ -124,6 +129,7 @@ QStatus SendToSG(SocketFd sockfd, IPAddress& remoteAddr, uint16_t remotePort,
         return status;
     }
 
+    IncrementPerfCounter(PERF_COUNTER_SOCKET_SENDTO);
     return SendSGCommon(sockfd, &addr, addrLen, sg, sent, flags);
 }
 
@@ -195,6 +201,7 @@ QStatus RecvFromSG(SocketFd sockfd, IPAddress& remoteAddr, uint16_t& remotePort,
     struct sockaddr_storage addr;
     socklen_t addrLen = sizeof(addr);
 
+    IncrementPerfCounter(PERF_COUNTER_SOCKET_RECV_FROM);
     status = RecvSGCommon(sockfd, &addr, &addrLen, sg, received);
     if (ER_OK == status) {
         GetSockAddr(&addr, addrLen, remoteAddr, remotePort);
@@ -203,5 +210,180 @@ QStatus RecvFromSG(SocketFd sockfd, IPAddress& remoteAddr, uint16_t& remotePort,
     }
     return status;
 }
+
+QStatus SetReusePortGroup(SocketFd sockfd)
+{
+    QCC_DbgTrace(("SetReusePortGroup(sockfd = %d)", sockfd));
+#if defined(SO_REUSEPORT)
+    int arg = 1;
+    if (setsockopt(static_cast<int>(sockfd), SOL_SOCKET, SO_REUSEPORT, (void*)&arg, sizeof(arg)) < 0) {
+        QStatus status = ER_OS_ERROR;
+        QCC_LogError(status, ("SetReusePortGroup: setsockopt(SO_REUSEPORT) failed: %d - %s", errno, strerror(errno)));
+        return status;
+    }
+    return ER_OK;
+#else
+    QCC_UNUSED(sockfd);
+    return ER_NOT_IMPLEMENTED;
+#endif
+}
+
+QStatus SetReusePortSteering(SocketFd sockfd, uint16_t members, uint16_t keyOffset, uint16_t altKeyOffset)
+{
+    QCC_DbgTrace(("SetReusePortSteering(sockfd = %d, members = %u, keyOffset = %u, altKeyOffset = %u)",
+                  sockfd, members, keyOffset, altKeyOffset));
+#if defined(QCC_OS_LINUX) && defined(SO_ATTACH_REUSEPORT_CBPF)
+    if (members == 0) {
+        return ER_BAD_ARG_2;
+    }
+    /*
+     * The program sees the datagram payload (the UDP header has been pulled)
+     * and returns the index of the member socket that should receive it.
+     */
+    struct sock_filter code[] = {
+        BPF_STMT(BPF_LD | BPF_H | BPF_ABS, keyOffset),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0, 2, 0),
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, members),
+        BPF_STMT(BPF_RET | BPF_A, 0),
+        BPF_STMT(BPF_LD | BPF_H | BPF_ABS, altKeyOffset),
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, members),
+        BPF_STMT(BPF_RET | BPF_A, 0)
+    };
+    struct sock_fprog prog;
+    prog.len = ArraySize(code);
+    prog.filter = code;
+    if (setsockopt(static_cast<int>(sockfd), SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) < 0) {
+        QStatus status = ER_OS_ERROR;
+        QCC_LogError(status, ("SetReusePortSteering: setsockopt(SO_ATTACH_REUSEPORT_CBPF) failed: %d - %s", errno, strerror(errno)));
+        return status;
+    }
+    return ER_OK;
+#else
+    QCC_UNUSED(sockfd);
+    QCC_UNUSED(members);
+    QCC_UNUSED(keyOffset);
+    QCC_UNUSED(altKeyOffset);
+    return ER_NOT_IMPLEMENTED;
+#endif
+}
+QStatus RecvFromBatch(SocketFd sockfd, Datagram* dgrams, size_t count, size_t& received)
+{
+    QCC_DbgTrace(("RecvFromBatch(sockfd = %d, dgrams = <>, count = %u, received = <>)", sockfd, count));
+    received = 0;
+#if defined(QCC_OS_LINUX)
+    struct mmsghdr msgs[DATAGRAM_BATCH_MAX];
+    struct iovec iov[DATAGRAM_BATCH_MAX];
+    struct sockaddr_storage addrs[DATAGRAM_BATCH_MAX];
+
+    count = (std::min)(count, DATAGRAM_BATCH_MAX);
+    for (size_t i = 0; i < count; ++i) {
+        iov[i].iov_base = dgrams[i].buf;
+        iov[i].iov_len = dgrams[i].size;
+        memset(&msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr));
+        msgs[i].msg_hdr.msg_name = &addrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_len = 0;
+    }
+
+    IncrementPerfCounter(PERF_COUNTER_SOCKET_RECV_FROM);
+    int ret = recvmmsg(static_cast<int>(sockfd), msgs, static_cast<unsigned int>(count), 0, NULL);
+    if (ret == -1) {
+        if (errno == EAGAIN || errno == EINTR || errno == EWOULDBLOCK) {
+            return ER_WOULDBLOCK;
+        }
+        QCC_DbgHLPrintf(("RecvFromBatch (sockfd = %u): %d - %s", sockfd, errno, strerror(errno)));
+        return ER_OS_ERROR;
+    }
+
+    for (int i = 0; i < ret; ++i) {
+        /*
+         * A truncated datagram is useless to a datagram protocol, so report it
+         * as empty rather than hand over a partial payload.
+         */
+        dgrams[i].len = (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) ? 0 : msgs[i].msg_len;
+        GetSockAddr(&addrs[i], msgs[i].msg_hdr.msg_namelen, dgrams[i].addr, dgrams[i].port);
+        QCC_DbgRemoteData(dgrams[i].buf, dgrams[i].len);
+    }
+    received = static_cast<size_t>(ret);
+    return ER_OK;
+#else
+    if (count == 0) {
+        return ER_OK;
+    }
+    QStatus status = RecvFrom(sockfd, dgrams[0].addr, dgrams[0].port, dgrams[0].buf, dgrams[0].size, dgrams[0].len);
+    if (status == ER_OK) {
+        received = 1;
+    } else if (errno == EAGAIN || errno == EINTR || errno == EWOULDBLOCK) {
+        status = ER_WOULDBLOCK;
+    }
+    return status;
+#endif
+}
+
+QStatus SendToBatch(SocketFd sockfd, const Datagram* dgrams, size_t count, size_t& sent, SendMsgFlags flags)
+{
+    QCC_DbgTrace(("SendToBatch(sockfd = %d, dgrams = <>, count = %u, sent = <>, flags = 0x%x)", sockfd, count, (int)flags));
+    QStatus status = ER_OK;
+    sent = 0;
+#if defined(QCC_OS_LINUX)
+    struct mmsghdr msgs[DATAGRAM_BATCH_MAX];
+    struct iovec iov[DATAGRAM_BATCH_MAX];
+    struct sockaddr_storage addrs[DATAGRAM_BATCH_MAX];
+
+    size_t done = 0;
+    while (done < count) {
+        size_t n = (std::min)(count - done, DATAGRAM_BATCH_MAX);
+        for (size_t i = 0; i < n; ++i) {
+            const Datagram& dgram = dgrams[done + i];
+            socklen_t addrLen = sizeof(addrs[i]);
+            if (MakeSockAddr(dgram.addr, dgram.port, &addrs[i], addrLen) != ER_OK) {
+                /* Leave it to sendmmsg() to fail this one with EDESTADDRREQ */
+                addrLen = 0;
+            }
+            iov[i].iov_base = dgram.buf;
+            iov[i].iov_len = dgram.len;
+            memset(&msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr));
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = addrLen;
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_len = 0;
+            QCC_DbgLocalData(dgram.buf, dgram.len);
+        }
+
+        IncrementPerfCounter(PERF_COUNTER_SOCKET_SENDTO);
+        int ret = sendmmsg(static_cast<int>(sockfd), msgs, static_cast<unsigned int>(n), (int)flags | MSG_NOSIGNAL);
+        if (ret > 0) {
+            done += ret;
+            sent += ret;
+        } else if (errno == EAGAIN || errno == EINTR || errno == EWOULDBLOCK) {
+            return ER_WOULDBLOCK;
+        } else {
+            /*
+             * sendmmsg() only reports an error for the first datagram of the
+             * call, so skip that one and carry on with the rest.
+             */
+            status = ER_OS_ERROR;
+            QCC_LogError(status, ("SendToBatch (sockfd = %u): %d - %s", sockfd, errno, strerror(errno)));
+            ++done;
+        }
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        size_t bytes;
+        QStatus sendStatus = SendTo(sockfd, const_cast<IPAddress&>(dgrams[i].addr), dgrams[i].port, dgrams[i].buf, dgrams[i].len, bytes, flags);
+        if (sendStatus == ER_WOULDBLOCK) {
+            return sendStatus;
+        } else if (sendStatus == ER_OK) {
+            ++sent;
+        } else {
+            status = sendStatus;
+        }
+    }
+#endif
+    return status;
+}
 } // namespace qcc
 
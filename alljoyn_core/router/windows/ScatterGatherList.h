@@ -499,6 +499,83 @@ QStatus RecvSG(SocketFd sockfd, ScatterGatherList& sg, size_t& received);
  */
 QStatus RecvFromSG(SocketFd sockfd, IPAddress& remoteAddr, uint16_t& remotePort,
                    ScatterGatherList& sg, size_t& received);
+
+/**
+ * Allow a datagram socket to join a group of sockets bound to the same local
+ * address and port (SO_REUSEPORT).  Must be called before the socket is bound.
+ *
+ * @param sockfd        Socket descriptor.
+ *
+ * @return  ER_OK, or ER_NOT_IMPLEMENTED if the platform has no such option.
+ */
+QStatus SetReusePortGroup(SocketFd sockfd);
+
+/**
+ * Steer datagrams arriving at a SO_REUSEPORT group across its members by a
+ * 16-bit big-endian key found at a fixed offset in the datagram payload.  A
+ * datagram is delivered to member (key % members), where members are numbered
+ * in the order they were bound.  If the key is zero the 16-bit value at
+ * altKeyOffset is used instead.
+ *
+ * @param sockfd        Descriptor of any socket in the group.
+ * @param members       Number of sockets in the group.
+ * @param keyOffset     Payload offset of the steering key.
+ * @param altKeyOffset  Payload offset of the key used when the first is zero.
+ *
+ * @return  ER_OK, or ER_NOT_IMPLEMENTED if the platform cannot steer datagrams.
+ */
+QStatus SetReusePortSteering(SocketFd sockfd, uint16_t members, uint16_t keyOffset, uint16_t altKeyOffset);
+
+/**
+ * One datagram of a batch passed to RecvFromBatch() or SendToBatch().
+ */
+struct Datagram {
+    IPAddress addr;     /**< IP Address of the remote host. */
+    uint16_t port;      /**< IP Port on the remote host. */
+    void* buf;          /**< The datagram payload. */
+    size_t size;        /**< Size of buf; only used when receiving. */
+    size_t len;         /**< Length of the payload. */
+};
+
+/**
+ * Maximum number of datagrams moved by one call to RecvFromBatch() or
+ * SendToBatch().
+ */
+const size_t DATAGRAM_BATCH_MAX = 64;
+
+/**
+ * Receive up to count datagrams from a non-blocking socket using as few system
+ * calls as the platform allows (one recvmmsg() on Linux).  Platforms without
+ * such a call receive a single datagram.
+ *
+ * @param sockfd        Socket descriptor.
+ * @param dgrams        Datagrams to fill in.  The buf and size fields must be
+ *                      set by the caller.
+ * @param count         Number of entries in dgrams (at most DATAGRAM_BATCH_MAX
+ *                      are used).
+ * @param received      OUT: Number of datagrams received.
+ *
+ * @return  ER_OK if at least one datagram was received, ER_WOULDBLOCK if there
+ *          was nothing to receive, otherwise ER_OS_ERROR.
+ */
+QStatus RecvFromBatch(SocketFd sockfd, Datagram* dgrams, size_t count, size_t& received);
+
+/**
+ * Send a batch of datagrams on a socket using as few system calls as the
+ * platform allows (sendmmsg() on Linux).  A datagram that fails for reasons
+ * other than a full socket buffer is skipped.
+ *
+ * @param sockfd        Socket descriptor.
+ * @param dgrams        Datagrams to send.
+ * @param count         Number of entries in dgrams.
+ * @param sent          OUT: Number of datagrams sent.
+ * @param flags         SendMsgFlags to underlying sockets call (see sendmsg() in sockets API)
+ *
+ * @return  ER_OK if every datagram was sent, ER_WOULDBLOCK if the socket
+ *          buffer filled up (datagrams from index sent onwards were not sent),
+ *          otherwise ER_OS_ERROR.
+ */
+QStatus SendToBatch(SocketFd sockfd, const Datagram* dgrams, size_t count, size_t& sent, SendMsgFlags flags = QCC_MSG_NONE);
 }
 
 #undef QCC_MODULE
@@ -34,6 +34,7 @@
 #include <qcc/Thread.h>
 #include <qcc/StringUtil.h>
 #include <qcc/windows/utility.h>
+#include <qcc/PerfCounters.h>
 #include "ScatterGatherList.h"
 
 #include <alljoyn/Status.h>
@@ -120,6 +121,7 @@ QStatus SendToSG(SocketFd sockfd, IPAddress& remoteAddr, uint16_t remotePort,
                   sockfd, remoteAddr.ToString().c_str(), remotePort, flags));
 
     MakeSockAddr(remoteAddr, remotePort, &addr, addrLen);
+    IncrementPerfCounter(PERF_COUNTER_SOCKET_SENDTO);
     return SendSGCommon(sockfd, &addr, addrLen, sg, sent, flags);
 }
 
@@ -207,6 +209,7 @@ QStatus RecvFromSG(SocketFd sockfd, IPAddress& remoteAddr, uint16_t& remotePort,
     SOCKADDR_STORAGE addr;
     socklen_t addrLen = sizeof(addr);
 
+    IncrementPerfCounter(PERF_COUNTER_SOCKET_RECV_FROM);
     status = RecvSGCommon(sockfd, &addr, addrLen, sg, received);
     if (ER_OK == status) {
         GetSockAddr(&addr, addrLen, remoteAddr, remotePort);
@@ -216,4 +219,52 @@ QStatus RecvFromSG(SocketFd sockfd, IPAddress& remoteAddr, uint16_t& remotePort,
     return status;
 }
 
+QStatus SetReusePortGroup(SocketFd sockfd)
+{
+    QCC_UNUSED(sockfd);
+    return ER_NOT_IMPLEMENTED;
+}
+
+QStatus SetReusePortSteering(SocketFd sockfd, uint16_t members, uint16_t keyOffset, uint16_t altKeyOffset)
+{
+    QCC_UNUSED(sockfd);
+    QCC_UNUSED(members);
+    QCC_UNUSED(keyOffset);
+    QCC_UNUSED(altKeyOffset);
+    return ER_NOT_IMPLEMENTED;
+}
+
+
+QStatus RecvFromBatch(SocketFd sockfd, Datagram* dgrams, size_t count, size_t& received)
+{
+    /* Winsock has no recvmmsg(), so a batch is a single datagram */
+    received = 0;
+    if (count == 0) {
+        return ER_OK;
+    }
+    QStatus status = RecvFrom(sockfd, dgrams[0].addr, dgrams[0].port, dgrams[0].buf, dgrams[0].size, dgrams[0].len);
+    if (status == ER_OK) {
+        received = 1;
+    }
+    return status;
+}
+
+QStatus SendToBatch(SocketFd sockfd, const Datagram* dgrams, size_t count, size_t& sent, SendMsgFlags flags)
+{
+    QStatus status = ER_OK;
+    sent = 0;
+    for (size_t i = 0; i < count; ++i) {
+        size_t bytes;
+        QStatus sendStatus = SendTo(sockfd, const_cast<IPAddress&>(dgrams[i].addr), dgrams[i].port, dgrams[i].buf, dgrams[i].len, bytes, flags);
+        if (sendStatus == ER_WOULDBLOCK) {
+            return sendStatus;
+        } else if (sendStatus == ER_OK) {
+            ++sent;
+        } else {
+            status = sendStatus;
+        }
+    }
+    return status;
+}
+
 }
@@ -22,6 +22,7 @@
 #include <qcc/platform.h>
 
 #include <string.h>
+#include <memory>
 
 #include <qcc/Debug.h>
 #include <qcc/Crypto.h>
@@ -105,7 +106,7 @@ size_t Crypto::GetExtraNonceLength(const _Message& message) {
  * Note that the first 5 bytes of the second Nonce version is the same as the first Nonce version.
  */
 
-QStatus Crypto::Encrypt(const _Message& message, const KeyBlob& keyBlob, uint8_t* msgBuf, size_t hdrLen, size_t& bodyLen)
+QStatus Crypto::Encrypt(const _Message& message, const KeyBlob& keyBlob, uint8_t* msgBuf, size_t hdrLen, size_t& bodyLen, Crypto_AES* cipher)
 {
     QStatus status;
 
@@ -154,8 +155,12 @@ QStatus Crypto::Encrypt(const _Message& message, const KeyBlob& keyBlob, uint8_t
             QCC_DbgHLPrintf(("     Header: %s", BytesToHexString(msgBuf, sizeof(_Message::MessageHeader)).c_str()));
             QCC_DbgHLPrintf(("Encrypt key: %s", BytesToHexString(keyBlob.GetData(), keyBlob.GetSize()).c_str()));
             QCC_DbgHLPrintf(("      nonce: %s", BytesToHexString(nonce.GetData(), nonce.GetSize()).c_str()));
-            Crypto_AES aes(keyBlob, Crypto_AES::CCM);
-            status = aes.Encrypt_CCM(body, body, bodyLen, nonce, msgBuf, hdrLen, macLen);
+            unique_ptr<Crypto_AES> aes;
+            if (!cipher) {
+                aes.reset(new Crypto_AES(keyBlob, Crypto_AES::CCM));
+                cipher = aes.get();
+            }
+            status = cipher->Encrypt_CCM(body, body, bodyLen, nonce, msgBuf, hdrLen, macLen);
 
             bodyLen += extraNonceLen;
 
@@ -174,7 +179,7 @@ QStatus Crypto::Encrypt(const _Message& message, const KeyBlob& keyBlob, uint8_t
     return status;
 }
 
-QStatus Crypto::Decrypt(const _Message& message, const KeyBlob& keyBlob, uint8_t* msgBuf, size_t hdrLen, size_t& bodyLen)
+QStatus Crypto::Decrypt(const _Message& message, const KeyBlob& keyBlob, uint8_t* msgBuf, size_t hdrLen, size_t& bodyLen, Crypto_AES* cipher)
 {
     QStatus status;
     switch (keyBlob.GetType()) {
@@ -214,8 +219,12 @@ QStatus Crypto::Decrypt(const _Message& message, const KeyBlob& keyBlob, uint8_t
             QCC_DbgHLPrintf(("        MAC: %s", BytesToHexString(body + bodyLen - macLen, macLen).c_str()));
             QCC_DbgHLPrintf(("extra nonce: %s", BytesToHexString(body + bodyLen, extraNonceLen).c_str()));
 
-            Crypto_AES aes(keyBlob, Crypto_AES::CCM);
-            status = aes.Decrypt_CCM(body, body, bodyLen, nonce, msgBuf, hdrLen, macLen);
+            unique_ptr<Crypto_AES> aes;
+            if (!cipher) {
+                aes.reset(new Crypto_AES(keyBlob, Crypto_AES::CCM));
+                cipher = aes.get();
+            }
+            status = cipher->Decrypt_CCM(body, body, bodyLen, nonce, msgBuf, hdrLen, macLen);
             QCC_DbgHLPrintf(("bodyLen out %d", bodyLen));
         }
         break;
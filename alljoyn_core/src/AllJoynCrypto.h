@@ -26,6 +26,7 @@
 #endif
 
 #include <qcc/platform.h>
+#include <qcc/Crypto.h>
 #include <qcc/KeyBlob.h>
 
 #include <alljoyn/Message.h>
@@ -53,12 +54,14 @@ class Crypto {
      * @param hdrLen          The length of the header part of the message that will not be encrypted.
      * @param bodyLen[in/out] On input the size of the plaintext body, on output the size of the
      *                        encrypted body.
+     * @param cipher          Optional CCM cipher already keyed with the key in the key blob. If NULL
+     *                        a cipher is created for this message.
      *
      * @return - ER_OK if the data was succesfully encrypted.
      *         - ER_BUS_KEYBLOB_OP_INVALID if the key blob cannot be used for encryption.
      *         - Other errors if the arguments are invalid.
      */
-    static QStatus Encrypt(const _Message& message, const qcc::KeyBlob& keyBlob, uint8_t* msgBuf, size_t hdrLen, size_t& bodyLen);
+    static QStatus Encrypt(const _Message& message, const qcc::KeyBlob& keyBlob, uint8_t* msgBuf, size_t hdrLen, size_t& bodyLen, qcc::Crypto_AES* cipher = NULL);
 
     /**
      * Decrypt and authenticate marshaled message inplace using the key blob provided and the
@@ -70,12 +73,14 @@ class Crypto {
      * @param hdrLen          The length of the non-encrypted header part of the message.
      * @param bodyLen[in/out] On input the size of the crypttext body, on output the size of the
      *                        decrypted body.
+     * @param cipher          Optional CCM cipher already keyed with the key in the key blob. If NULL
+     *                        a cipher is created for this message.
      *
      * @return - ER_OK if the data was succesfully decrypted.
      *         - ER_BUS_KEYBLOB_OP_INVALID if the key blob cannot be used for decryption.
      *         - Other errors if the arguments are invalid.
      */
-    static QStatus Decrypt(const _Message& message, const qcc::KeyBlob& keyBlob, uint8_t* msgBuf, size_t hdrLen, size_t& bodyLen);
+    static QStatus Decrypt(const _Message& message, const qcc::KeyBlob& keyBlob, uint8_t* msgBuf, size_t hdrLen, size_t& bodyLen, qcc::Crypto_AES* cipher = NULL);
 
     /**
      * Compute a SHA1 hash over the header fields and return the result in a key blob.
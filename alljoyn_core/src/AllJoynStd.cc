@@ -209,6 +209,8 @@ QStatus org::alljoyn::CreateInterfaces(BusAttachment& bus)
             return status;
         }
         ifc->AddMethod("SetDebugLevel",  "su", NULL, "module,level", 0);
+        ifc->AddProperty("TxHeaderBytesSaved", "t", PROP_ACCESS_READ);
+        ifc->AddProperty("RxHeaderBytesSaved", "t", PROP_ACCESS_READ);
         ifc->Activate();
     }
     {
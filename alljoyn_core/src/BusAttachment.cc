@@ -193,7 +193,8 @@ BusAttachment::Internal::Internal(const char* appName,
     listenersLock(LOCK_LEVEL_BUSATTACHMENT_INTERNAL_LISTENERSLOCK),
     listeners(),
     m_ioDispatch("iodisp", 96),
-    transportList(bus, factories, &m_ioDispatch, concurrency),
+    m_ioDispatchers(1, &m_ioDispatch),
+    transportList(bus, factories, m_ioDispatchers, concurrency),
     keyStore(application),
     authManager(keyStore),
     globalGuid(qcc::GUID128()),
@@ -212,7 +213,8 @@ BusAttachment::Internal::Internal(const char* appName,
     applicationStateListenersLock(LOCK_LEVEL_BUSATTACHMENT_INTERNAL_APPLICATIONSTATELISTENERSLOCK),
     observerManager(NULL),
     permissionConfigurationListener(NULL),
-    permissionConfigurationListenerLock(LOCK_LEVEL_BUSATTACHMENT_INTERNAL_PERMISSIONCONFIGURATIONLISTENERLOCK)
+    permissionConfigurationListenerLock(LOCK_LEVEL_BUSATTACHMENT_INTERNAL_PERMISSIONCONFIGURATIONLISTENERLOCK),
+    introspectionCache(bus)
 {
 #ifndef NDEBUG
     for (uint32_t index = 0; index < ArraySize(sessionsLock); index++) {
@@ -264,11 +266,46 @@ BusAttachment::Internal::~Internal()
     delete router;
     router = NULL;
 
+    for (size_t i = 1; i < m_ioDispatchers.size(); ++i) {
+        delete m_ioDispatchers[i];
+    }
+    m_ioDispatchers.resize(1);
+
     if (s_allBusAttachments) {
         s_allBusAttachments->Delete(this);
     }
 }
 
+QStatus BusAttachment::Internal::SetIODispatchCount(uint32_t count)
+{
+    if (bus.IsStarted()) {
+        return ER_BUS_BUS_ALREADY_STARTED;
+    }
+    count = (count < 1) ? 1 : count;
+    while (m_ioDispatchers.size() > count) {
+        delete m_ioDispatchers.back();
+        m_ioDispatchers.pop_back();
+    }
+    while (m_ioDispatchers.size() < count) {
+        m_ioDispatchers.push_back(new IODispatch("iodisp", 96));
+    }
+    return ER_OK;
+}
+
+IODispatch& BusAttachment::Internal::GetLeastLoadedIODispatch(void)
+{
+    IODispatch* ioDispatch = m_ioDispatchers[0];
+    size_t fewest = ioDispatch->GetNumStreams();
+    for (size_t i = 1; i < m_ioDispatchers.size(); ++i) {
+        size_t numStreams = m_ioDispatchers[i]->GetNumStreams();
+        if (numStreams < fewest) {
+            ioDispatch = m_ioDispatchers[i];
+            fewest = numStreams;
+        }
+    }
+    return *ioDispatch;
+}
+
 /*
  * Transport factory container for transports this bus attachment uses to communicate with the daemon.
  */
@@ -2535,6 +2572,9 @@ void BusAttachment::Internal::AllJoynSignalHandler(const InterfaceDescription::M
                     QCC_DbgPrintf(("args[%d]=%s", i, args[i].ToString().c_str()));
                 }
 #endif
+                /* Let the proxy objects of the announcing peer skip introspection it has already done */
+                introspectionCache.SetPeerAnnouncement(msg->GetSender(), args[2], args[3]);
+
                 /* Call aboutListener */
                 aboutListenersLock.Lock(MUTEX_CONTEXT);
                 AboutListenerSet::iterator it = aboutListeners.begin();
@@ -2592,6 +2632,10 @@ void BusAttachment::Internal::AllJoynSignalHandler(const InterfaceDescription::M
                 }
             }
         } else if (0 == strcmp("NameOwnerChanged", msg->GetMemberName())) {
+            /* A unique name that has no owner is never used again */
+            if ((args[0].v_string.str[0] == ':') && (args[2].v_string.len == 0)) {
+                introspectionCache.RemovePeer(args[0].v_string.str);
+            }
             listenersLock.Lock(MUTEX_CONTEXT);
             ListenerSet::iterator it = listeners.begin();
             while (it != listeners.end()) {
@@ -2933,6 +2977,32 @@ QStatus BusAttachment::CreateInterfacesFromXml(const char* xml)
     return status;
 }
 
+void BusAttachment::EnableIntrospectionCache(bool enable)
+{
+    busInternal->GetIntrospectionCache().Enable(enable);
+}
+
+void BusAttachment::GetIntrospectionCacheStats(size_t& hits, size_t& misses) const
+{
+    busInternal->GetIntrospectionCache().GetStats(hits, misses);
+}
+
+QStatus BusAttachment::SaveIntrospectionCache(const char* fileName) const
+{
+    if (!fileName) {
+        return ER_BAD_ARG_1;
+    }
+    return busInternal->GetIntrospectionCache().Save(fileName);
+}
+
+QStatus BusAttachment::LoadIntrospectionCache(const char* fileName)
+{
+    if (!fileName) {
+        return ER_BAD_ARG_1;
+    }
+    return busInternal->GetIntrospectionCache().Load(fileName);
+}
+
 bool BusAttachment::Internal::CallAcceptListeners(SessionPort sessionPort, const char* joiner, const SessionOpts& opts)
 {
     bool isAccepted = false;
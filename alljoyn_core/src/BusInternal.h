@@ -38,6 +38,7 @@
 #include <alljoyn/PermissionConfigurator.h>
 
 #include "AuthManager.h"
+#include "IntrospectionCache.h"
 #include "ObserverManager.h"
 #include "ClientRouter.h"
 #include "KeyStore.h"
@@ -66,6 +67,13 @@ class BusAttachment::Internal : public MessageReceiver, public JoinSessionAsyncC
      */
     KeyStore& GetKeyStore() { return keyStore; }
 
+    /**
+     * Get a reference to the introspection cache.
+     *
+     * @return A reference to the cache of parsed introspection XML.
+     */
+    IntrospectionCache& GetIntrospectionCache() { return introspectionCache; }
+
     /**
      * Return the next available serial number. Note 0 is an invalid serial number.
      *
@@ -150,6 +158,34 @@ class BusAttachment::Internal : public MessageReceiver, public JoinSessionAsyncC
      */
     qcc::IODispatch& GetIODispatch(void) { return m_ioDispatch; }
 
+    /**
+     * Set the number of iodispatch reactors that remote endpoint streams are
+     * spread across. The iodispatch returned by GetIODispatch() is always the
+     * first reactor. Must be called before the bus is started.
+     *
+     * @param count   Number of reactors (values less than 1 are treated as 1).
+     *
+     * @return
+     *      - #ER_OK if successful
+     *      - #ER_BUS_BUS_ALREADY_STARTED if the bus has already been started
+     */
+    QStatus SetIODispatchCount(uint32_t count);
+
+    /**
+     * Get the number of iodispatch reactors.
+     *
+     * @return  The number of reactors
+     */
+    size_t GetIODispatchCount(void) const { return m_ioDispatchers.size(); }
+
+    /**
+     * Get the iodispatch reactor servicing the fewest streams. A stream must
+     * stay on the reactor it was started on until it is stopped.
+     *
+     * @return  The least loaded iodispatch
+     */
+    qcc::IODispatch& GetLeastLoadedIODispatch(void);
+
     /**
      * Get the Announced Object Description for the BusObjects registered on
      * the BusAttachment with interfaces marked as announced.
@@ -572,6 +608,7 @@ class BusAttachment::Internal : public MessageReceiver, public JoinSessionAsyncC
     typedef std::set<ProtectedBusListener> ListenerSet;
     ListenerSet listeners;               /* List of registered BusListeners */
     qcc::IODispatch m_ioDispatch;         /* iodispatch for this bus */
+    std::vector<qcc::IODispatch*> m_ioDispatchers; /* iodispatch reactors for this bus, m_ioDispatch is the first */
     std::map<std::string, InterfaceDescription> ifaceDescriptions;
     TransportList transportList;          /* List of active transports */
     KeyStore keyStore;                    /* The key store for the bus attachment */
@@ -633,6 +670,7 @@ class BusAttachment::Internal : public MessageReceiver, public JoinSessionAsyncC
     typedef qcc::ManagedObj<PermissionConfigurationListener*> ProtectedPermissionConfigurationListener;
     ProtectedPermissionConfigurationListener* permissionConfigurationListener;
     qcc::Mutex permissionConfigurationListenerLock;   /* Lock protecting permissionConfigurationListener */
+    IntrospectionCache introspectionCache;  /* Parsed introspection XML shared by the proxy objects */
 };
 
 }
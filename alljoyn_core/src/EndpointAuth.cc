@@ -37,6 +37,7 @@
 #include "RemoteEndpoint.h"
 #include "EndpointAuth.h"
 #include "BusUtil.h"
+#include "HeaderDictionary.h"
 #include "SASLEngine.h"
 #include "BusInternal.h"
 
@@ -126,6 +127,7 @@ QStatus EndpointAuth::Hello(qcc::String& redirection)
             remoteGUID = qcc::GUID128(response->GetArg(1)->v_string.str);
             uint32_t temp = response->GetArg(2)->v_uint32;
             remoteProtocolVersion = temp & 0x3FFFFFFF;
+            remoteHeaderCompression = (response->GetFlags() & HeaderDictionary::HEADER_COMPRESSED_FLAG) != 0;
             SessionOpts::NameTransferType tempNameTransfer = static_cast<SessionOpts::NameTransferType>(temp >> 30);
             if (remoteProtocolVersion < 12 || (tempNameTransfer == SessionOpts::SLS_NAMES)) {
                 /* If protocol version is less than 12, set the name transfer requested.
@@ -181,7 +183,33 @@ QStatus EndpointAuth::WaitHello(qcc::String& authUsed)
     if (status != ER_OK) {
         return status;
     }
-    status = hello->Unmarshal(endpoint, false);
+    status = ReplyHello(hello, authUsed, redirection);
+    if ((ER_OK == status) && !redirection.empty()) {
+        /*
+         * We expect the other end to shutdown the endpoint socket as soon as it receives the
+         * redirection error response. The only way we can tell if the socket is closed is by
+         * attempting to read or write to it. We do a read with a timeout. If we actually read data
+         * or the timeout expires it means the socket wasn't closed by the other end so we assume
+         * the the redirection failed.
+         */
+        uint8_t buf[1];
+        size_t sz;
+        Source& source = endpoint->GetSource();
+        status = source.PullBytes(buf, sizeof(buf), sz, REDIRECT_TIMEOUT);
+        if (status == ER_OK || status == ER_TIMEOUT) {
+            status = ER_BUS_ESTABLISH_FAILED;
+        } else {
+            status = ER_BUS_ENDPOINT_REDIRECTED;
+        }
+    }
+    return status;
+}
+
+QStatus EndpointAuth::ReplyHello(Message& hello, const qcc::String& authUsed, qcc::String& redirection)
+{
+    QCC_DbgTrace(("EndpointAuth::ReplyHello(authUsed=\"%s\")", authUsed.c_str()));
+
+    QStatus status = hello->Unmarshal(endpoint, false);
     if (ER_OK == status) {
         if (hello->GetType() != MESSAGE_METHOD_CALL) {
             QCC_DbgPrintf(("First message must be Hello/BusHello method call"));
@@ -253,6 +281,7 @@ QStatus EndpointAuth::WaitHello(qcc::String& authUsed)
                 remoteGUID = qcc::GUID128(args[0].v_string.str);
                 uint32_t temp = args[1].v_uint32;
                 remoteProtocolVersion = temp & 0x3FFFFFFF;
+                remoteHeaderCompression = (hello->GetFlags() & HeaderDictionary::HEADER_COMPRESSED_FLAG) != 0;
                 SessionOpts::NameTransferType tempNameTransfer = static_cast<SessionOpts::NameTransferType>(temp >> 30);
                 if (remoteProtocolVersion < 12 || (tempNameTransfer == SessionOpts::SLS_NAMES)) {
                     /* If protocol version is less than 12, set the name transfer requested.
@@ -298,24 +327,6 @@ QStatus EndpointAuth::WaitHello(qcc::String& authUsed)
             QCC_LogError(status, ("%s", __FUNCTION__));
         }
     }
-    if ((ER_OK == status) && !redirection.empty()) {
-        /*
-         * We expect the other end to shutdown the endpoint socket as soon as it receives the
-         * redirection error response. The only way we can tell if the socket is closed is by
-         * attempting to read or write to it. We do a read with a timeout. If we actually read data
-         * or the timeout expires it means the socket wasn't closed by the other end so we assume
-         * the the redirection failed.
-         */
-        uint8_t buf[1];
-        size_t sz;
-        Source& source = endpoint->GetSource();
-        status = source.PullBytes(buf, sizeof(buf), sz, REDIRECT_TIMEOUT);
-        if (status == ER_OK || status == ER_TIMEOUT) {
-            status = ER_BUS_ESTABLISH_FAILED;
-        } else {
-            status = ER_BUS_ENDPOINT_REDIRECTED;
-        }
-    }
     return status;
 }
 
@@ -532,4 +543,108 @@ ExitEstablish:
     return status;
 }
 
+QStatus EndpointAuth::EstablishNonBlocking(const qcc::String& authMechanisms,
+                                           qcc::String& authUsed,
+                                           qcc::String& redirection,
+                                           AuthListener* listener)
+{
+    QCC_DbgTrace(("EndpointAuth::EstablishNonBlocking(authMechanism=\"%s\", listener=0x%p)", authMechanisms.c_str(), listener));
+
+    if (!isAccepting) {
+        return ER_NOT_IMPLEMENTED;
+    }
+
+    QStatus status = ER_OK;
+
+    if (!sasl) {
+        endpoint->SetFlowType(_BusEndpoint::ENDPOINT_FLOW_CHARS);
+        if (listener) {
+            authListener.Set(listener);
+        }
+        sasl = new SASLEngine(bus, AuthMechanism::CHALLENGER, authMechanisms, NULL, authListener, this);
+        /*
+         * The server's GUID is sent to the client when the authentication succeeds
+         */
+        String guidStr = bus.GetInternal().GetGlobalGUID().ToString();
+        sasl->SetLocalId(guidStr);
+        establishState = ESTABLISH_SASL;
+    }
+
+    /*
+     * Each step below reads with a zero timeout so we only ever consume what
+     * has already arrived.  A partial SASL line is kept in saslLine and a
+     * partial Hello message in helloMsg until the next call.
+     */
+    while ((status == ER_OK) && (establishState == ESTABLISH_SASL)) {
+        status = endpoint->GetSource().GetLine(saslLine, 0);
+        if (status != ER_OK) {
+            if (status != ER_TIMEOUT) {
+                QCC_LogError(status, ("Failed to read from stream"));
+            }
+            break;
+        }
+        QCC_DbgPrintf(("EndpointAuth::EstablishNonBlocking(): Got \"%s\" from stream", saslLine.c_str()));
+        SASLEngine::AuthState state;
+        qcc::String outStr;
+        status = sasl->Advance(saslLine, outStr, state);
+        saslLine.clear();
+        if (status != ER_OK) {
+            QCC_DbgPrintf(("Server authentication failed %s", QCC_StatusText(status)));
+            break;
+        }
+        if (state == SASLEngine::ALLJOYN_AUTH_SUCCESS) {
+            mechanism = sasl->GetMechanism();
+            establishState = ESTABLISH_HELLO;
+            endpoint->SetFlowType(_BusEndpoint::ENDPOINT_FLOW_HELLO);
+            break;
+        }
+        size_t numPushed;
+        status = endpoint->GetSink().PushBytes((void*)(outStr.data()), outStr.length(), numPushed);
+        if (status != ER_OK) {
+            QCC_LogError(status, ("Failed to write to stream"));
+            /* ER_TIMEOUT tells the caller to wait for more data, a write that timed out is fatal */
+            if (status == ER_TIMEOUT) {
+                status = ER_BUS_ESTABLISH_FAILED;
+            }
+        }
+    }
+
+    if ((status == ER_OK) && (establishState == ESTABLISH_HELLO)) {
+        status = helloMsg->ReadNonBlocking(endpoint, false);
+        if (status == ER_OK) {
+            status = ReplyHello(helloMsg, mechanism, redirection);
+            if (status == ER_TIMEOUT) {
+                QCC_LogError(status, ("Failed to write Hello reply"));
+                status = ER_BUS_ESTABLISH_FAILED;
+            }
+            endpoint->SetFlowType(_BusEndpoint::ENDPOINT_FLOW_MSGS);
+            if ((status == ER_OK) && !redirection.empty()) {
+                establishState = ESTABLISH_REDIRECT;
+            }
+        }
+    }
+
+    if ((status == ER_OK) && (establishState == ESTABLISH_REDIRECT)) {
+        /*
+         * Same as WaitHello(): the redirection only worked if the other end
+         * closes the socket.  The caller decides how long to wait for that.
+         */
+        uint8_t buf[1];
+        size_t sz;
+        status = endpoint->GetSource().PullBytes(buf, sizeof(buf), sz, 0);
+        if (status == ER_OK) {
+            status = ER_BUS_ESTABLISH_FAILED;
+        } else if (status != ER_TIMEOUT) {
+            status = ER_BUS_ENDPOINT_REDIRECTED;
+        }
+    }
+
+    authUsed = mechanism;
+    if (status != ER_TIMEOUT) {
+        authListener.Set(NULL);
+        QCC_DbgPrintf(("Establish complete %s", QCC_StatusText(status)));
+    }
+    return status;
+}
+
 }
@@ -28,6 +28,8 @@
 #include <qcc/GUID.h>
 #include <qcc/Stream.h>
 
+#include <alljoyn/Message.h>
+
 #include "BusInternal.h"
 #include "SASLEngine.h"
 
@@ -60,13 +62,17 @@ class EndpointAuth : public SASLEngine::ExtensionHandler {
         uniqueName(bus.GetInternal().GetRouter().GenerateUniqueName()),
         isAccepting(isAcceptor),
         remoteProtocolVersion(0),
-        nameTransfer(SessionOpts::P2P_NAMES)
+        remoteHeaderCompression(false),
+        nameTransfer(SessionOpts::P2P_NAMES),
+        establishState(ESTABLISH_SASL),
+        sasl(NULL),
+        helloMsg(bus)
     { }
 
     /**
      * Destructor
      */
-    ~EndpointAuth() { };
+    ~EndpointAuth() { delete sasl; };
 
     /**
      * Establish a connection.
@@ -85,6 +91,27 @@ class EndpointAuth : public SASLEngine::ExtensionHandler {
      */
     QStatus Establish(const qcc::String& authMechanisms, qcc::String& authUsed, qcc::String& redirection, AuthListener* listener = NULL, uint32_t timeout = qcc::Event::WAIT_FOREVER);
 
+    /**
+     * Establish the accepting side of a connection without blocking.  Each
+     * call consumes whatever the remote side has sent so far and returns
+     * ER_TIMEOUT if the handshake needs more data, in which case it must be
+     * called again once the endpoint source has more bytes available.
+     *
+     * @param authMechanisms  The authentication mechanisms to try.
+     * @param authUsed        Returns the name of the authentication method that was used to establish the connection.
+     * @param redirection     Returns a redirection address for the endpoint. This value is only meaninful if the
+     *                        return status is ER_BUS_ENDPOINT_REDIRECTED.
+     * @param listener        Authentication credentials listener.
+     *
+     * @return
+     *      - ER_OK if successful
+     *      - ER_TIMEOUT if the handshake is waiting for more data
+     *      = ER_BUS_ENDPOINT_REDIRECTED if the endpoint is being redirected.
+     *      - ER_NOT_IMPLEMENTED if this is not the accepting side of the connection
+     *      - An error status otherwise
+     */
+    QStatus EstablishNonBlocking(const qcc::String& authMechanisms, qcc::String& authUsed, qcc::String& redirection, AuthListener* listener = NULL);
+
     /**
      * Get the unique bus name assigned by the bus for this endpoint.
      *
@@ -121,6 +148,13 @@ class EndpointAuth : public SASLEngine::ExtensionHandler {
      */
     uint32_t GetRemoteProtocolVersion() const { return remoteProtocolVersion; }
 
+    /**
+     * Test if the remote side of a bus-to-bus connection supports header compression.
+     *
+     * @return   true if the BusHello or BusHello reply from the remote side announced header compression.
+     */
+    bool IsHeaderCompressionSupported() const { return remoteHeaderCompression; }
+
     SessionOpts::NameTransferType GetNameTransfer() const { return nameTransfer; }
   private:
     /* Private assigment operator - does nothing */
@@ -144,14 +178,29 @@ class EndpointAuth : public SASLEngine::ExtensionHandler {
 
     qcc::GUID128 remoteGUID;            ///< GUID of the remote side (when applicable)
     uint32_t remoteProtocolVersion;     ///< ALLJOYN protocol version of the remote side
+    bool remoteHeaderCompression;       ///< True if the remote side supports header compression
 
     SessionOpts::NameTransferType nameTransfer;
     ProtectedAuthListener authListener;  ///< Authentication listener
 
+    /** Progress of EstablishNonBlocking() */
+    enum EstablishState {
+        ESTABLISH_SASL,      ///< Exchanging SASL lines
+        ESTABLISH_HELLO,     ///< Waiting for the Hello/BusHello message
+        ESTABLISH_REDIRECT   ///< Redirected, waiting for the remote side to close
+    };
+
+    EstablishState establishState;   ///< Where EstablishNonBlocking() is in the handshake
+    SASLEngine* sasl;                ///< SASL engine used by EstablishNonBlocking()
+    qcc::String saslLine;            ///< Partially received SASL line
+    qcc::String mechanism;           ///< Authentication mechanism agreed by EstablishNonBlocking()
+    Message helloMsg;                ///< Partially received Hello message
+
     /* Internal methods */
 
     QStatus Hello(qcc::String& redirection);
     QStatus WaitHello(qcc::String& authUsed);
+    QStatus ReplyHello(Message& hello, const qcc::String& authUsed, qcc::String& redirection);
 };
 
 }
@@ -0,0 +1,309 @@
+/**
+ * @file
+ * This class implements the per-connection dictionary used to compress the
+ * string header fields of messages sent between routing nodes.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+#include <qcc/Debug.h>
+#include <qcc/Util.h>
+
+#include <string.h>
+
+#include "HeaderDictionary.h"
+
+#define QCC_MODULE "ALLJOYN"
+
+using namespace qcc;
+using namespace std;
+
+namespace ajn {
+
+/*
+ * Same limit Message_Parse.cc applies to received headers
+ */
+#define MAX_HEADER_LEN  1024 * 64
+
+/*
+ * A reference is the field code, the signature "q" and the dictionary index
+ */
+#define REFERENCE_LEN  6
+
+/*
+ * Wire codes of the header fields that can be replaced by a reference
+ */
+static inline bool IsDictionaryField(uint8_t code)
+{
+    switch (code) {
+    case 1:  /* ALLJOYN_HDR_FIELD_PATH        */
+    case 2:  /* ALLJOYN_HDR_FIELD_INTERFACE   */
+    case 3:  /* ALLJOYN_HDR_FIELD_MEMBER      */
+    case 4:  /* ALLJOYN_HDR_FIELD_ERROR_NAME  */
+    case 6:  /* ALLJOYN_HDR_FIELD_DESTINATION */
+    case 7:  /* ALLJOYN_HDR_FIELD_SENDER      */
+    case 8:  /* ALLJOYN_HDR_FIELD_SIGNATURE   */
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+static inline bool IsStringType(uint8_t typeId)
+{
+    return (typeId == ALLJOYN_STRING) || (typeId == ALLJOYN_OBJECT_PATH) || (typeId == ALLJOYN_SIGNATURE);
+}
+
+/*
+ * Get the length of the header field at the start of buf not counting the pad
+ * that aligns the next field.  Returns 0 if the field is truncated or has a type
+ * that never appears in a standard header.
+ */
+static size_t FieldLength(const uint8_t* buf, const uint8_t* end, bool swap)
+{
+    size_t avail = end - buf;
+    size_t len;
+
+    if ((avail < 4) || (buf[1] != 1) || (buf[3] != 0)) {
+        return 0;
+    }
+    switch (buf[2]) {
+    case ALLJOYN_STRING:
+    case ALLJOYN_OBJECT_PATH:
+        {
+            if (avail < 8) {
+                return 0;
+            }
+            uint32_t strLen;
+            memcpy(&strLen, buf + 4, sizeof(strLen));
+            if (swap) {
+                strLen = EndianSwap32(strLen);
+            }
+            if (strLen >= avail) {
+                return 0;
+            }
+            len = 8 + strLen + 1;
+        }
+        break;
+
+    case ALLJOYN_SIGNATURE:
+        if (avail < 5) {
+            return 0;
+        }
+        len = 5 + buf[4] + 1;
+        break;
+
+    case ALLJOYN_UINT32:
+        len = 8;
+        break;
+
+    case ALLJOYN_UINT16:
+        len = REFERENCE_LEN;
+        break;
+
+    case ALLJOYN_BYTE:
+        len = 5;
+        break;
+
+    default:
+        return 0;
+    }
+    return (len <= avail) ? len : 0;
+}
+
+/*
+ * Header fields always start on an 8 byte boundary
+ */
+static inline void PadField(std::string& hdr)
+{
+    hdr.append(((hdr.size() + 7) & ~7) - hdr.size(), '\0');
+}
+
+HeaderDictionary::HeaderDictionary() : next(0), headerBytes(0), savedBytes(0)
+{
+}
+
+void HeaderDictionary::Add(const std::string& field)
+{
+    if (entries.size() < MAX_ENTRIES) {
+        entries.push_back(field);
+    } else {
+        index.erase(entries[next]);
+        entries[next] = field;
+    }
+    index[field] = next;
+    next = (next + 1) % MAX_ENTRIES;
+}
+
+bool HeaderDictionary::IsCompressed(const _Message& msg)
+{
+    const _Message::MessageHeader* hdr = reinterpret_cast<const _Message::MessageHeader*>(msg.msgBuf);
+    return hdr && (hdr->flags & HEADER_COMPRESSED_FLAG);
+}
+
+QStatus HeaderDictionary::Compress(_Message& msg)
+{
+    uint8_t* buf = reinterpret_cast<uint8_t*>(msg.msgBuf);
+    _Message::MessageHeader* hdr = reinterpret_cast<_Message::MessageHeader*>(buf);
+
+    if (!hdr || (hdr->endian != _Message::myEndian) || (hdr->flags & HEADER_COMPRESSED_FLAG)) {
+        return ER_OK;
+    }
+    uint8_t* fields = buf + sizeof(_Message::MessageHeader);
+    const uint8_t* end = fields + hdr->headerLen;
+    /*
+     * The dictionary can only be updated once we know the whole header can be
+     * compressed so check the fields first.  A reference in the original header
+     * would be ambiguous.
+     */
+    bool compressible = false;
+    for (const uint8_t* pos = fields; pos < end;) {
+        size_t len = FieldLength(pos, end, false);
+        if ((len == 0) || (IsDictionaryField(pos[0]) && (pos[2] == ALLJOYN_UINT16))) {
+            return ER_OK;
+        }
+        compressible |= IsDictionaryField(pos[0]) && IsStringType(pos[2]);
+        pos = fields + ((pos - fields + len + 7) & ~7);
+    }
+    if (!compressible) {
+        return ER_OK;
+    }
+
+    std::string out;
+    out.reserve(hdr->headerLen);
+    for (const uint8_t* pos = fields; pos < end;) {
+        size_t len = FieldLength(pos, end, false);
+        PadField(out);
+        if (IsDictionaryField(pos[0]) && IsStringType(pos[2])) {
+            std::string field(reinterpret_cast<const char*>(pos), len);
+            std::map<std::string, uint16_t>::const_iterator it = index.find(field);
+            if (it != index.end()) {
+                uint8_t ref[REFERENCE_LEN] = { pos[0], 1, ALLJOYN_UINT16, 0 };
+                memcpy(ref + 4, &it->second, sizeof(uint16_t));
+                out.append(reinterpret_cast<const char*>(ref), sizeof(ref));
+            } else {
+                out.append(field);
+                if (len <= MAX_ENTRY_LEN) {
+                    Add(field);
+                }
+            }
+        } else {
+            out.append(reinterpret_cast<const char*>(pos), len);
+        }
+        pos = fields + ((pos - fields + len + 7) & ~7);
+    }
+    /*
+     * The compressed header is never longer than the original so the header and
+     * body can be rewritten in place.
+     */
+    size_t oldPadded = (hdr->headerLen + 7) & ~7;
+    size_t newPadded = (out.size() + 7) & ~7;
+    QCC_ASSERT(newPadded <= oldPadded);
+    memcpy(fields, out.data(), out.size());
+    memset(fields + out.size(), 0, newPadded - out.size());
+    memmove(fields + newPadded, fields + oldPadded, hdr->bodyLen);
+
+    headerBytes += hdr->headerLen;
+    savedBytes += oldPadded - newPadded;
+
+    hdr->headerLen = static_cast<uint32_t>(out.size());
+    hdr->flags |= HEADER_COMPRESSED_FLAG;
+    msg.bodyPtr = fields + newPadded;
+    msg.bufEOD = msg.bodyPtr + hdr->bodyLen;
+    return ER_OK;
+}
+
+QStatus HeaderDictionary::Expand(_Message& msg)
+{
+    if (!(msg.msgHeader.flags & HEADER_COMPRESSED_FLAG)) {
+        return ER_OK;
+    }
+    const bool swap = msg.endianSwap;
+    const uint8_t* fields = reinterpret_cast<const uint8_t*>(msg.msgBuf) + sizeof(_Message::MessageHeader);
+    const uint8_t* end = fields + msg.msgHeader.headerLen;
+
+    std::string out;
+    out.reserve(4 * msg.msgHeader.headerLen);
+    for (const uint8_t* pos = fields; pos < end;) {
+        size_t len = FieldLength(pos, end, swap);
+        if (len == 0) {
+            QCC_LogError(ER_BUS_BAD_HEADER_FIELD, ("Compressed header has an invalid field"));
+            return ER_BUS_BAD_HEADER_FIELD;
+        }
+        PadField(out);
+        if (IsDictionaryField(pos[0]) && (pos[2] == ALLJOYN_UINT16)) {
+            uint16_t ref;
+            memcpy(&ref, pos + 4, sizeof(ref));
+            if (swap) {
+                ref = EndianSwap16(ref);
+            }
+            if ((ref >= entries.size()) || (static_cast<uint8_t>(entries[ref][0]) != pos[0])) {
+                QCC_LogError(ER_BUS_BAD_HEADER_FIELD, ("Compressed header refers to unknown entry %u", ref));
+                return ER_BUS_BAD_HEADER_FIELD;
+            }
+            out.append(entries[ref]);
+        } else {
+            std::string field(reinterpret_cast<const char*>(pos), len);
+            if (IsDictionaryField(pos[0]) && IsStringType(pos[2]) && (len <= MAX_ENTRY_LEN)) {
+                Add(field);
+            }
+            out.append(field);
+        }
+        pos = fields + ((pos - fields + len + 7) & ~7);
+    }
+    if (out.size() > MAX_HEADER_LEN) {
+        QCC_LogError(ER_BUS_BAD_HEADER_LEN, ("Expanded message header length %d is invalid", out.size()));
+        return ER_BUS_BAD_HEADER_LEN;
+    }
+
+    /*
+     * Build the message buffer InterpretHeader() would have allocated for the
+     * uncompressed message.
+     */
+    size_t oldPadded = (msg.msgHeader.headerLen + 7) & ~7;
+    size_t newPadded = (out.size() + 7) & ~7;
+    msg.pktSize = newPadded + msg.msgHeader.bodyLen;
+    msg.bufSize = sizeof(_Message::MessageHeader) + ((msg.pktSize + 7) & ~7) + sizeof(uint64_t);
+    uint8_t* _msgBuf = new uint8_t[msg.bufSize + 7];
+    uint64_t* msgBuf = (uint64_t*)((uintptr_t)(_msgBuf + 7) & ~7);
+
+    _Message::MessageHeader* hdr = reinterpret_cast<_Message::MessageHeader*>(msgBuf);
+    *hdr = *reinterpret_cast<const _Message::MessageHeader*>(msg.msgBuf);
+    hdr->flags &= ~HEADER_COMPRESSED_FLAG;
+    hdr->headerLen = swap ? EndianSwap32(static_cast<uint32_t>(out.size())) : static_cast<uint32_t>(out.size());
+    uint8_t* newFields = reinterpret_cast<uint8_t*>(hdr + 1);
+    memcpy(newFields, out.data(), out.size());
+    memset(newFields + out.size(), 0, newPadded - out.size());
+    memcpy(newFields + newPadded, fields + oldPadded, msg.msgHeader.bodyLen);
+
+    headerBytes += out.size();
+    savedBytes += newPadded - oldPadded;
+
+    delete [] msg._msgBuf;
+    msg._msgBuf = _msgBuf;
+    msg.msgBuf = msgBuf;
+    msg.bufPos = newFields;
+    msg.bufEOD = newFields + msg.pktSize;
+    memset(msg.bufEOD, 0, reinterpret_cast<uint8_t*>(msgBuf) + msg.bufSize - msg.bufEOD);
+    msg.msgHeader.flags &= ~HEADER_COMPRESSED_FLAG;
+    msg.msgHeader.headerLen = static_cast<uint32_t>(out.size());
+    return ER_OK;
+}
+
+}
@@ -0,0 +1,155 @@
+/**
+ * @file
+ * This class implements the per-connection dictionary used to compress the
+ * string header fields of messages sent between routing nodes.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _ALLJOYN_HEADERDICTIONARY_H
+#define _ALLJOYN_HEADERDICTIONARY_H
+
+#ifndef __cplusplus
+#error Only include HeaderDictionary.h in C++ code.
+#endif
+
+#include <qcc/platform.h>
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <alljoyn/Message.h>
+
+#include <alljoyn/Status.h>
+
+namespace ajn {
+
+/**
+ * A HeaderDictionary replaces the PATH, INTERFACE, MEMBER, ERROR_NAME,
+ * DESTINATION, SENDER and SIGNATURE header fields of a message with a small
+ * integer reference to an identical field sent earlier on the same connection.
+ *
+ * Each direction of a connection has its own dictionary and both ends update
+ * their copy in exactly the same way: every field that is sent in full in a
+ * compressed message is added to the dictionary, evicting the oldest entry
+ * when the dictionary is full.  Because a stream connection delivers messages
+ * in order the two copies stay identical without any further synchronization.
+ * This means that every message compressed with a transmit dictionary MUST be
+ * sent, and that every message received on the connection MUST be expanded.
+ *
+ * A compressed message has the HEADER_COMPRESSED_FLAG flag set.  A reference
+ * is encoded as a header field with the usual field code and a 'q' value
+ * holding the dictionary index.  Expanding a message restores the exact bytes
+ * of the original header so compression is transparent to message encryption.
+ *
+ * Support for header compression is negotiated with the same flag: a routing
+ * node sets HEADER_COMPRESSED_FLAG on its BusHello and on its reply to a
+ * BusHello, neither of which is ever compressed.  Routing nodes that predate
+ * header compression ignore the flag and do not set it, so the protocol
+ * version is left alone.
+ */
+class HeaderDictionary {
+  public:
+
+    /**
+     * Message flag set on a compressed message, or on a BusHello or BusHello
+     * reply from a routing node that supports header compression.  This reuses
+     * the bit of the deprecated ALLJOYN_FLAG_COMPRESSED token compression.
+     */
+    static const uint8_t HEADER_COMPRESSED_FLAG = 0x40;
+
+    /**
+     * Number of entries in a dictionary.
+     */
+    static const uint16_t MAX_ENTRIES = 512;
+
+    /**
+     * Fields longer than this are always sent in full and never added to the dictionary.
+     */
+    static const size_t MAX_ENTRY_LEN = 256;
+
+    /**
+     * Constructor.
+     */
+    HeaderDictionary();
+
+    /**
+     * Compress the header fields of a message.  The message is modified in place
+     * so it must not be shared with any other endpoint.  Messages that are
+     * already compressed or that are not in the native byte order are left alone.
+     *
+     * @param msg  The marshaled message to compress.
+     *
+     * @return ER_OK if the message was compressed or left alone.
+     */
+    QStatus Compress(_Message& msg);
+
+    /**
+     * Expand the header fields of a message read from the connection.  This must
+     * be called for every message read, in order, before it is unmarshaled.
+     * Messages that are not compressed are left alone.
+     *
+     * @param msg  The message that has been read.
+     *
+     * @return
+     *      - ER_OK if the message was expanded or was not compressed.
+     *      - ER_BUS_BAD_HEADER_FIELD if the message refers to an unknown entry.
+     *      - ER_BUS_BAD_HEADER_LEN if the expanded header is too long.
+     */
+    QStatus Expand(_Message& msg);
+
+    /**
+     * Test if a message has a compressed header.
+     *
+     * @param msg  The message to check.
+     *
+     * @return true if the header fields of the message have been compressed.
+     */
+    static bool IsCompressed(const _Message& msg);
+
+    /**
+     * Get the header compression statistics for this dictionary.  This may be
+     * called while another thread is compressing or expanding messages.
+     *
+     * @param[out] headerBytes  Total bytes of the uncompressed header fields.
+     * @param[out] savedBytes   Bytes saved on the connection by compression.
+     */
+    void GetStats(uint64_t& headerBytes, uint64_t& savedBytes) const
+    {
+        headerBytes = this->headerBytes;
+        savedBytes = this->savedBytes;
+    }
+
+  private:
+
+    /**
+     * Add a header field to the dictionary evicting the oldest entry if needed.
+     */
+    void Add(const std::string& field);
+
+    std::vector<std::string> entries;          /**< Header fields indexed by reference */
+    std::map<std::string, uint16_t> index;     /**< Reference for each header field */
+    uint16_t next;                             /**< Next entry to be replaced */
+    std::atomic<uint64_t> headerBytes;         /**< Total size of the original header fields */
+    std::atomic<uint64_t> savedBytes;          /**< Bytes saved by compression */
+};
+
+}
+
+#endif
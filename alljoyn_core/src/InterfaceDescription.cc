@@ -170,6 +170,7 @@ InterfaceDescription::Member::Member(const InterfaceDescription* iface,
     isSessionlessSignal(false),
     isUnicastSignal(false),
     isGlobalBroadcastSignal(false),
+    isArgView(false),
     argumentAnnotations(new ArgumentAnnotations())
 {
     if (annotation & MEMBER_ANNOTATE_DEPRECATED) {
@@ -195,6 +196,10 @@ InterfaceDescription::Member::Member(const InterfaceDescription* iface,
     if (annotation & MEMBER_ANNOTATE_GLOBAL_BROADCAST) {
         isGlobalBroadcastSignal = true;
     }
+
+    if (annotation & MEMBER_ANNOTATE_ARG_VIEW) {
+        isArgView = true;
+    }
 }
 
 InterfaceDescription::Member::Member(const Member& other)
@@ -212,6 +217,7 @@ InterfaceDescription::Member::Member(const Member& other)
     isSessionlessSignal(other.isSessionlessSignal),
     isUnicastSignal(other.isUnicastSignal),
     isGlobalBroadcastSignal(other.isGlobalBroadcastSignal),
+    isArgView(other.isArgView),
     argumentAnnotations(new ArgumentAnnotations(*(other.argumentAnnotations)))
 {
 }
@@ -237,6 +243,7 @@ InterfaceDescription::Member& InterfaceDescription::Member::operator=(const Memb
         isSessionlessSignal = other.isSessionlessSignal;
         isUnicastSignal = other.isUnicastSignal;
         isGlobalBroadcastSignal = other.isGlobalBroadcastSignal;
+        isArgView = other.isArgView;
     }
     return *this;
 }
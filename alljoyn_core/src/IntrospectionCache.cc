@@ -0,0 +1,597 @@
+/**
+ * @file
+ *
+ * This file implements a cache of parsed introspection XML shared by the proxy
+ * objects of a bus attachment.
+ *
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <set>
+
+#include <qcc/Crypto.h>
+#include <qcc/Debug.h>
+#include <qcc/FileStream.h>
+#include <qcc/LockLevel.h>
+
+#include <alljoyn/AboutKeys.h>
+#include <alljoyn/BusAttachment.h>
+#include <alljoyn/MsgArg.h>
+
+#include "IntrospectionCache.h"
+
+#include <alljoyn/Status.h>
+
+#define QCC_MODULE "ALLJOYN"
+
+using namespace qcc;
+using namespace std;
+
+namespace ajn {
+
+/*
+ * A saved cache starts with a marker and a version number followed by the
+ * number of interfaces, the name and XML of each interface, the number of
+ * entries and the digest, node tree and object keys of each entry.  A node
+ * tree is the secure flag, the interface names and the child nodes.  Numbers
+ * are 32 bits in host byte order and strings and lists are preceded by their
+ * length.
+ */
+static const uint32_t SavedCacheMarker = 0x4349414A;
+static const uint32_t SavedCacheVersion = 3;
+
+/*
+ * Nodes nested deeper than this in a saved cache are treated as corrupt.
+ */
+static const size_t MaxSavedNodeDepth = 64;
+
+static void PushUInt32(qcc::String& buf, uint32_t val)
+{
+    buf.append(reinterpret_cast<const char*>(&val), sizeof(val));
+}
+
+static void PushString(qcc::String& buf, const qcc::String& str)
+{
+    PushUInt32(buf, static_cast<uint32_t>(str.size()));
+    buf.append(str);
+}
+
+static void PushNode(qcc::String& buf, const IntrospectionCache::Node& node)
+{
+    PushString(buf, node.name);
+    PushUInt32(buf, node.secure ? 1 : 0);
+    PushUInt32(buf, static_cast<uint32_t>(node.interfaces.size()));
+    for (vector<qcc::String>::const_iterator it = node.interfaces.begin(); it != node.interfaces.end(); ++it) {
+        PushString(buf, *it);
+    }
+    PushUInt32(buf, static_cast<uint32_t>(node.children.size()));
+    for (vector<IntrospectionCache::Node>::const_iterator it = node.children.begin(); it != node.children.end(); ++it) {
+        PushNode(buf, *it);
+    }
+}
+
+/*
+ * Reads the values written by the Push functions, checking that each one is
+ * within the buffer.
+ */
+class SavedCacheReader {
+  public:
+    SavedCacheReader(const qcc::String& buf) : buf(buf), pos(0) { }
+
+    bool AtEnd() const { return pos == buf.size(); }
+
+    bool PullUInt32(uint32_t& val)
+    {
+        if ((buf.size() - pos) < sizeof(val)) {
+            return false;
+        }
+        memcpy(&val, buf.data() + pos, sizeof(val));
+        pos += sizeof(val);
+        return true;
+    }
+
+    bool PullBytes(std::string& str, size_t len)
+    {
+        if ((buf.size() - pos) < len) {
+            return false;
+        }
+        str.assign(buf.data() + pos, len);
+        pos += len;
+        return true;
+    }
+
+    bool PullString(qcc::String& str)
+    {
+        uint32_t len;
+        if (!PullUInt32(len) || ((buf.size() - pos) < len)) {
+            return false;
+        }
+        str = buf.substr(pos, len);
+        pos += len;
+        return true;
+    }
+
+    bool PullNode(IntrospectionCache::Node& node, size_t depth)
+    {
+        uint32_t secure;
+        uint32_t count;
+        if ((depth > MaxSavedNodeDepth) || !PullString(node.name) || !PullUInt32(secure) || !PullUInt32(count)) {
+            return false;
+        }
+        node.secure = (secure != 0);
+        for (uint32_t i = 0; i < count; ++i) {
+            qcc::String name;
+            if (!PullString(name)) {
+                return false;
+            }
+            node.interfaces.push_back(name);
+        }
+        if (!PullUInt32(count)) {
+            return false;
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            node.children.push_back(IntrospectionCache::Node());
+            if (!PullNode(node.children.back(), depth + 1)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+  private:
+    const qcc::String& buf;
+    size_t pos;
+};
+
+static void GetInterfaceNames(const IntrospectionCache::Node& node, set<qcc::String>& names)
+{
+    names.insert(node.interfaces.begin(), node.interfaces.end());
+    for (vector<IntrospectionCache::Node>::const_iterator it = node.children.begin(); it != node.children.end(); ++it) {
+        GetInterfaceNames(*it, names);
+    }
+}
+
+/*
+ * An object is keyed by the announcement digest of its peer followed by its
+ * path.  The digest has a fixed size so the key is unambiguous.
+ */
+static std::string GetObjectKey(const std::string& peerDigest, const qcc::String& path)
+{
+    return peerDigest + std::string(path.c_str(), path.size());
+}
+
+IntrospectionCache::IntrospectionCache(BusAttachment& bus) :
+    bus(bus),
+    lock(LOCK_LEVEL_INTROSPECTIONCACHE_LOCK),
+    enabled(true),
+    hits(0),
+    misses(0)
+{
+}
+
+void IntrospectionCache::Enable(bool enable)
+{
+    lock.Lock(MUTEX_CONTEXT);
+    enabled = enable;
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+bool IntrospectionCache::IsEnabled() const
+{
+    lock.Lock(MUTEX_CONTEXT);
+    bool isEnabled = enabled;
+    lock.Unlock(MUTEX_CONTEXT);
+    return isEnabled;
+}
+
+std::string IntrospectionCache::GetDigest(const char* xml)
+{
+    uint8_t digest[Crypto_SHA256::DIGEST_SIZE];
+    Crypto_SHA256 hash;
+    QStatus status = hash.Init();
+    if (status == ER_OK) {
+        status = hash.Update(reinterpret_cast<const uint8_t*>(xml), strlen(xml));
+    }
+    if (status == ER_OK) {
+        status = hash.GetDigest(digest);
+    }
+    if (status != ER_OK) {
+        /* An empty digest is never added so the XML is simply parsed */
+        return std::string();
+    }
+    return std::string(reinterpret_cast<const char*>(digest), sizeof(digest));
+}
+
+void IntrospectionCache::SetPeerAnnouncement(const qcc::String& busName, const MsgArg& objectDescription, const MsgArg& aboutData)
+{
+    /*
+     * Devices running the same application announce the same AppId, so the
+     * ModelNumber, SoftwareVersion and the announced objects are included to
+     * tell apart versions that implement different interfaces.
+     */
+    MsgArg* field;
+    if (aboutData.GetElement("{sv}", AboutKeys::APP_ID, &field) != ER_OK) {
+        return;
+    }
+    qcc::String announcement = field->ToString();
+    if (aboutData.GetElement("{sv}", AboutKeys::MODEL_NUMBER, &field) == ER_OK) {
+        announcement += field->ToString();
+    }
+    if (aboutData.GetElement("{sv}", AboutKeys::SOFTWARE_VERSION, &field) == ER_OK) {
+        announcement += field->ToString();
+    }
+    announcement += objectDescription.ToString();
+    std::string digest = GetDigest(announcement.c_str());
+    if (digest.empty()) {
+        return;
+    }
+    std::string name(busName.c_str(), busName.size());
+    lock.Lock(MUTEX_CONTEXT);
+    unordered_map<std::string, PeerList::iterator>::iterator it = peerIndex.find(name);
+    if (it != peerIndex.end()) {
+        PeerList::iterator peer = it->second;
+        peers.splice(peers.begin(), peers, peer);
+        if (peer->second != digest) {
+            std::string oldDigest = peer->second;
+            peer->second = digest;
+            /* The peer no longer runs the application it announced before */
+            bool announced = false;
+            for (PeerList::const_iterator pit = peers.begin(); !announced && (pit != peers.end()); ++pit) {
+                announced = (pit->second == oldDigest);
+            }
+            if (!announced) {
+                UnlinkObjects(oldDigest);
+            }
+        }
+    } else {
+        if (peers.size() >= MAX_PEERS) {
+            peerIndex.erase(peers.back().first);
+            peers.pop_back();
+        }
+        peers.push_front(make_pair(name, digest));
+        peerIndex[name] = peers.begin();
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+void IntrospectionCache::RemovePeer(const qcc::String& busName)
+{
+    lock.Lock(MUTEX_CONTEXT);
+    unordered_map<std::string, PeerList::iterator>::iterator it = peerIndex.find(std::string(busName.c_str(), busName.size()));
+    if (it != peerIndex.end()) {
+        peers.erase(it->second);
+        peerIndex.erase(it);
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+std::string IntrospectionCache::GetPeerDigest(const qcc::String& busName)
+{
+    std::string digest;
+    lock.Lock(MUTEX_CONTEXT);
+    unordered_map<std::string, PeerList::iterator>::iterator it = peerIndex.find(std::string(busName.c_str(), busName.size()));
+    if (it != peerIndex.end()) {
+        peers.splice(peers.begin(), peers, it->second);
+        digest = it->second->second;
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+    return digest;
+}
+
+shared_ptr<const IntrospectionCache::Node> IntrospectionCache::Find(const std::string& digest)
+{
+    shared_ptr<const Node> root;
+    lock.Lock(MUTEX_CONTEXT);
+    unordered_map<std::string, EntryList::iterator>::iterator it = index.find(digest);
+    if (it != index.end()) {
+        entries.splice(entries.begin(), entries, it->second);
+        root = it->second->root;
+        ++hits;
+    } else {
+        ++misses;
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+    return root;
+}
+
+shared_ptr<const IntrospectionCache::Node> IntrospectionCache::Find(const std::string& peerDigest, const qcc::String& path)
+{
+    shared_ptr<const Node> root;
+    if (peerDigest.empty()) {
+        return root;
+    }
+    lock.Lock(MUTEX_CONTEXT);
+    unordered_map<std::string, std::string>::iterator oit = objects.find(GetObjectKey(peerDigest, path));
+    if (oit != objects.end()) {
+        /* Objects are removed along with their entry so the entry is present */
+        EntryList::iterator entry = index[oit->second];
+        entries.splice(entries.begin(), entries, entry);
+        root = entry->root;
+        ++hits;
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+    return root;
+}
+
+void IntrospectionCache::Add(const std::string& digest, const Node& root, const map<qcc::String, qcc::String>& interfaces)
+{
+    if (digest.empty()) {
+        return;
+    }
+    shared_ptr<const Node> entry(new Node(root));
+    lock.Lock(MUTEX_CONTEXT);
+    Insert(digest, entry, interfaces);
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+void IntrospectionCache::AddObject(const std::string& peerDigest, const qcc::String& path, const std::string& digest)
+{
+    if (peerDigest.empty() || digest.empty()) {
+        return;
+    }
+    lock.Lock(MUTEX_CONTEXT);
+    LinkObject(GetObjectKey(peerDigest, path), digest);
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+void IntrospectionCache::LinkObject(const std::string& key, const std::string& digest)
+{
+    unordered_map<std::string, EntryList::iterator>::iterator it = index.find(digest);
+    if (it == index.end()) {
+        return;
+    }
+    unordered_map<std::string, std::string>::iterator oit = objects.find(key);
+    if (oit != objects.end()) {
+        /* The object returned different XML before */
+        index[oit->second]->objects.erase(key);
+        oit->second = digest;
+    } else {
+        objects[key] = digest;
+    }
+    it->second->objects.insert(key);
+}
+
+void IntrospectionCache::UnlinkObjects(const std::string& peerDigest)
+{
+    unordered_map<std::string, std::string>::iterator oit = objects.begin();
+    while (oit != objects.end()) {
+        if (oit->first.compare(0, peerDigest.size(), peerDigest) == 0) {
+            index[oit->second]->objects.erase(oit->first);
+            oit = objects.erase(oit);
+        } else {
+            ++oit;
+        }
+    }
+}
+
+void IntrospectionCache::Insert(const std::string& digest, const shared_ptr<const Node>& root, const map<qcc::String, qcc::String>& interfaces)
+{
+    unordered_map<std::string, EntryList::iterator>::iterator it = index.find(digest);
+    if (it != index.end()) {
+        it->second->root = root;
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+    if (index.size() >= MAX_ENTRIES) {
+        Erase(--entries.end());
+    }
+    entries.push_front(Entry());
+    Entry& entry = entries.front();
+    entry.digest = digest;
+    entry.root = root;
+    GetInterfaceNames(*root, entry.interfaces);
+    for (set<qcc::String>::const_iterator nit = entry.interfaces.begin(); nit != entry.interfaces.end(); ++nit) {
+        ++interfaceRefs[*nit];
+        map<qcc::String, qcc::String>::const_iterator xit = interfaces.find(*nit);
+        if (xit != interfaces.end()) {
+            interfaceXml.insert(*xit);
+        }
+    }
+    index[digest] = entries.begin();
+}
+
+void IntrospectionCache::Erase(EntryList::iterator entry)
+{
+    for (set<std::string>::const_iterator oit = entry->objects.begin(); oit != entry->objects.end(); ++oit) {
+        objects.erase(*oit);
+    }
+    /* The interfaces stay registered but their XML is only kept for saving entries that use them */
+    for (set<qcc::String>::const_iterator nit = entry->interfaces.begin(); nit != entry->interfaces.end(); ++nit) {
+        map<qcc::String, size_t>::iterator rit = interfaceRefs.find(*nit);
+        if (--rit->second == 0) {
+            interfaceRefs.erase(rit);
+            interfaceXml.erase(*nit);
+        }
+    }
+    index.erase(entry->digest);
+    entries.erase(entry);
+}
+
+void IntrospectionCache::Remove(const std::string& digest)
+{
+    lock.Lock(MUTEX_CONTEXT);
+    unordered_map<std::string, EntryList::iterator>::iterator it = index.find(digest);
+    if (it != index.end()) {
+        Erase(it->second);
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+void IntrospectionCache::GetStats(size_t& hits, size_t& misses) const
+{
+    lock.Lock(MUTEX_CONTEXT);
+    hits = this->hits;
+    misses = this->misses;
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+QStatus IntrospectionCache::Save(const qcc::String& fileName) const
+{
+    qcc::String buf;
+    qcc::String entryBuf;
+    set<qcc::String> names;
+    uint32_t numEntries = 0;
+
+    lock.Lock(MUTEX_CONTEXT);
+    for (EntryList::const_reverse_iterator it = entries.rbegin(); it != entries.rend(); ++it) {
+        entryBuf.append(it->digest.data(), it->digest.size());
+        PushNode(entryBuf, *it->root);
+        PushUInt32(entryBuf, static_cast<uint32_t>(it->objects.size()));
+        for (set<std::string>::const_iterator oit = it->objects.begin(); oit != it->objects.end(); ++oit) {
+            PushString(entryBuf, qcc::String(oit->data(), oit->size()));
+        }
+        names.insert(it->interfaces.begin(), it->interfaces.end());
+        ++numEntries;
+    }
+    PushUInt32(buf, SavedCacheMarker);
+    PushUInt32(buf, SavedCacheVersion);
+    PushUInt32(buf, static_cast<uint32_t>(names.size()));
+    for (set<qcc::String>::const_iterator it = names.begin(); it != names.end(); ++it) {
+        map<qcc::String, qcc::String>::const_iterator xit = interfaceXml.find(*it);
+        PushString(buf, *it);
+        PushString(buf, (xit == interfaceXml.end()) ? qcc::String::Empty : xit->second);
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+    PushUInt32(buf, numEntries);
+    buf.append(entryBuf);
+
+    FileSink sink(fileName, true, FileSink::PRIVATE);
+    if (!sink.IsValid()) {
+        QStatus status = ER_OS_ERROR;
+        QCC_LogError(status, ("Cannot write introspection cache %s", fileName.c_str()));
+        return status;
+    }
+    size_t pushed = 0;
+    QStatus status = sink.PushBytes(buf.data(), buf.size(), pushed);
+    if ((status == ER_OK) && (pushed != buf.size())) {
+        status = ER_WRITE_ERROR;
+    }
+    if (status != ER_OK) {
+        QCC_LogError(status, ("Failed to write introspection cache %s", fileName.c_str()));
+    }
+    return status;
+}
+
+QStatus IntrospectionCache::Load(const qcc::String& fileName)
+{
+    FileSource source(fileName);
+    if (!source.IsValid()) {
+        return ER_EOF;
+    }
+    int64_t fileSize = 0;
+    QStatus status = source.GetSize(fileSize);
+    if (status != ER_OK) {
+        return status;
+    }
+    qcc::String buf;
+    buf.resize(static_cast<size_t>(fileSize));
+    size_t total = 0;
+    while ((status == ER_OK) && (total < buf.size())) {
+        size_t pulled = 0;
+        status = source.PullBytes(&buf[total], buf.size() - total, pulled);
+        total += pulled;
+    }
+    if (status != ER_OK) {
+        return status;
+    }
+
+    SavedCacheReader reader(buf);
+    uint32_t marker;
+    uint32_t version;
+    uint32_t count;
+    if (!reader.PullUInt32(marker) || (marker != SavedCacheMarker) ||
+        !reader.PullUInt32(version) || (version != SavedCacheVersion) ||
+        !reader.PullUInt32(count)) {
+        status = ER_INVALID_DATA;
+        QCC_LogError(status, ("%s is not an introspection cache", fileName.c_str()));
+        return status;
+    }
+
+    /*
+     * Register the interfaces first.  An interface that is already registered
+     * with a different definition makes the entries that use it unusable.
+     */
+    map<qcc::String, qcc::String> interfaces;
+    set<qcc::String> unusable;
+    for (uint32_t i = 0; i < count; ++i) {
+        qcc::String name;
+        qcc::String xml;
+        if (!reader.PullString(name) || !reader.PullString(xml)) {
+            return ER_INVALID_DATA;
+        }
+        if (!xml.empty() && (bus.CreateInterfacesFromXml(xml.c_str()) == ER_OK) && bus.GetInterface(name.c_str())) {
+            interfaces[name] = xml;
+        } else {
+            QCC_DbgPrintf(("Not loading introspection cache entries that use %s", name.c_str()));
+            unusable.insert(name);
+        }
+    }
+
+    if (!reader.PullUInt32(count)) {
+        return ER_INVALID_DATA;
+    }
+    vector<Entry> loaded;
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string digest;
+        Node* root = new Node();
+        shared_ptr<const Node> entry(root);
+        uint32_t numObjects;
+        if (!reader.PullBytes(digest, Crypto_SHA256::DIGEST_SIZE) || !reader.PullNode(*root, 0) || !reader.PullUInt32(numObjects)) {
+            return ER_INVALID_DATA;
+        }
+        set<std::string> objectKeys;
+        for (uint32_t j = 0; j < numObjects; ++j) {
+            qcc::String key;
+            if (!reader.PullString(key)) {
+                return ER_INVALID_DATA;
+            }
+            objectKeys.insert(std::string(key.c_str(), key.size()));
+        }
+        set<qcc::String> names;
+        GetInterfaceNames(*root, names);
+        bool usable = true;
+        for (set<qcc::String>::const_iterator it = names.begin(); usable && (it != names.end()); ++it) {
+            usable = (interfaces.find(*it) != interfaces.end());
+        }
+        if (usable) {
+            loaded.push_back(Entry());
+            loaded.back().digest = digest;
+            loaded.back().root = entry;
+            loaded.back().objects.swap(objectKeys);
+        }
+    }
+    if (!reader.AtEnd()) {
+        return ER_INVALID_DATA;
+    }
+
+    lock.Lock(MUTEX_CONTEXT);
+    /* Entries were saved from least to most recently used */
+    for (vector<Entry>::const_iterator it = loaded.begin(); it != loaded.end(); ++it) {
+        Insert(it->digest, it->root, interfaces);
+        for (set<std::string>::const_iterator oit = it->objects.begin(); oit != it->objects.end(); ++oit) {
+            LinkObject(*oit, it->digest);
+        }
+    }
+    lock.Unlock(MUTEX_CONTEXT);
+    QCC_DbgPrintf(("Loaded %u introspection cache entries from %s", static_cast<uint32_t>(loaded.size()), fileName.c_str()));
+    return ER_OK;
+}
+
+}
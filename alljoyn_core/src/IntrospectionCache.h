@@ -0,0 +1,290 @@
+#ifndef _ALLJOYN_INTROSPECTIONCACHE_H
+#define _ALLJOYN_INTROSPECTIONCACHE_H
+/**
+ * @file
+ *
+ * This file defines a cache of parsed introspection XML shared by the proxy
+ * objects of a bus attachment.
+ *
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#error Only include IntrospectionCache.h in C++ code.
+#endif
+
+#include <qcc/platform.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <qcc/Mutex.h>
+#include <qcc/String.h>
+
+#include <alljoyn/Status.h>
+
+namespace ajn {
+
+class BusAttachment;
+class MsgArg;
+
+/**
+ * IntrospectionCache remembers the result of parsing introspection XML so that
+ * proxy objects for peers that return the same XML, for example many devices
+ * running the same application, are built without parsing it again.
+ *
+ * Entries are keyed by the SHA-256 digest of the XML.  An entry holds the
+ * names of the interfaces each node implements and its child nodes; the
+ * interfaces themselves are the activated interface descriptions registered
+ * on the bus attachment when the XML was first parsed.  The cache is bounded
+ * and evicts the least recently used entry along with the XML of the
+ * interfaces that no other entry uses.
+ *
+ * An entry also records the objects it was introspected from.  An object is
+ * identified by the digest of the About announcement of its application and
+ * its path, so a peer that announced the same application can be introspected
+ * without calling the peer at all.  When a peer announces a different
+ * application, for example after a software update, the objects recorded for
+ * its old announcement are forgotten unless another peer still announces it.
+ * The announcements of at most MAX_PEERS peers are remembered, the least
+ * recently used is forgotten first and a peer is forgotten when it leaves the
+ * bus.
+ *
+ * The cache can be saved to a file and loaded again after a restart.  The file
+ * holds the XML of each interface once and the node trees and objects of the
+ * entries.
+ */
+class IntrospectionCache {
+  public:
+
+    /**
+     * Maximum number of entries in the cache.
+     */
+    static const size_t MAX_ENTRIES = 1024;
+
+    /**
+     * Maximum number of peers whose About announcement is remembered.
+     */
+    static const size_t MAX_PEERS = 1024;
+
+    /**
+     * A parsed introspection <node> element.
+     */
+    struct Node {
+        qcc::String name;                     /**< Relative path of a child node, empty for the root */
+        bool secure;                          /**< The node has the org.alljoyn.Bus.Secure annotation */
+        std::vector<qcc::String> interfaces;  /**< Names of the interfaces implemented by the node */
+        std::vector<Node> children;           /**< Child nodes */
+
+        Node() : secure(false) { }
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param bus  The bus attachment that the interfaces are registered with.
+     */
+    IntrospectionCache(BusAttachment& bus);
+
+    /**
+     * Enable or disable the cache.  The cache is enabled by default.
+     *
+     * @param enable  true to enable the cache.
+     */
+    void Enable(bool enable);
+
+    /**
+     * Test if the cache is enabled.
+     *
+     * @return true if the cache is enabled.
+     */
+    bool IsEnabled() const;
+
+    /**
+     * Compute the key of some introspection XML.
+     *
+     * @param xml  The introspection XML.
+     *
+     * @return The SHA-256 digest of the XML.
+     */
+    static std::string GetDigest(const char* xml);
+
+    /**
+     * Remember the application a peer announced.  The application is
+     * identified by the AppId, ModelNumber and SoftwareVersion in the About
+     * data and the announced object description.
+     *
+     * @param busName            Unique name of the peer that sent the announcement.
+     * @param objectDescription  The announced object description.
+     * @param aboutData          The announced About data.
+     */
+    void SetPeerAnnouncement(const qcc::String& busName, const MsgArg& objectDescription, const MsgArg& aboutData);
+
+    /**
+     * Forget the announcement of a peer that has left the bus.
+     *
+     * @param busName  Unique name of the peer.
+     */
+    void RemovePeer(const qcc::String& busName);
+
+    /**
+     * Get the digest of the About announcement of a peer.
+     *
+     * @param busName  Unique name of the peer.
+     *
+     * @return The digest or an empty string if the peer has not announced.
+     */
+    std::string GetPeerDigest(const qcc::String& busName);
+
+    /**
+     * Look up the parsed form of some introspection XML and count a hit or a
+     * miss.
+     *
+     * @param digest  Digest of the XML.
+     *
+     * @return The root node or an empty pointer if it is not cached.
+     */
+    std::shared_ptr<const Node> Find(const std::string& digest);
+
+    /**
+     * Look up the parsed form of the introspection XML of an object of a peer
+     * that announced the same application as an object introspected before.
+     * Only a lookup that is found is counted, as a hit.
+     *
+     * @param peerDigest  Digest of the About announcement of the peer.
+     * @param path        Object path.
+     *
+     * @return The root node or an empty pointer if it is not cached.
+     */
+    std::shared_ptr<const Node> Find(const std::string& peerDigest, const qcc::String& path);
+
+    /**
+     * Record that an object was introspected and returned some XML.
+     *
+     * @param peerDigest  Digest of the About announcement of the peer.
+     * @param path        Object path.
+     * @param digest      Digest of the XML, which must already have been added.
+     */
+    void AddObject(const std::string& peerDigest, const qcc::String& path, const std::string& digest);
+
+    /**
+     * Add the parsed form of some introspection XML.
+     *
+     * @param digest      Digest of the XML.
+     * @param root        The root node.
+     * @param interfaces  The XML of each interface referenced by the nodes,
+     *                    indexed by interface name.
+     */
+    void Add(const std::string& digest, const Node& root, const std::map<qcc::String, qcc::String>& interfaces);
+
+    /**
+     * Remove an entry whose interfaces are no longer registered.
+     *
+     * @param digest  Digest of the XML.
+     */
+    void Remove(const std::string& digest);
+
+    /**
+     * Get the number of lookups that were and were not found in the cache.
+     *
+     * @param[out] hits    Number of lookups found in the cache.
+     * @param[out] misses  Number of lookups not found in the cache.
+     */
+    void GetStats(size_t& hits, size_t& misses) const;
+
+    /**
+     * Save the cache to a file.
+     *
+     * @param fileName  Name of the file.
+     *
+     * @return
+     *      - #ER_OK if the cache was saved.
+     *      - An error status otherwise.
+     */
+    QStatus Save(const qcc::String& fileName) const;
+
+    /**
+     * Load entries saved by Save() and register their interfaces with the bus
+     * attachment.  Entries that use an interface that is already registered
+     * with a different definition are skipped.
+     *
+     * @param fileName  Name of the file.
+     *
+     * @return
+     *      - #ER_OK if the cache was loaded.
+     *      - #ER_INVALID_DATA if the file is not a saved cache.
+     *      - An error status otherwise.
+     */
+    QStatus Load(const qcc::String& fileName);
+
+  private:
+
+    /**
+     * A cache entry.
+     */
+    struct Entry {
+        std::string digest;                   /**< Digest of the XML */
+        std::shared_ptr<const Node> root;     /**< The parsed XML */
+        std::set<qcc::String> interfaces;     /**< Names of the interfaces used by the nodes */
+        std::set<std::string> objects;        /**< Keys of the objects that returned the XML */
+    };
+
+    typedef std::list<Entry> EntryList;
+
+    /**
+     * A peer unique name and the digest of its announcement.
+     */
+    typedef std::list<std::pair<std::string, std::string> > PeerList;
+
+    /**
+     * Copying is not supported.
+     */
+    IntrospectionCache(const IntrospectionCache& other);
+
+    /**
+     * Assignment is not supported.
+     */
+    IntrospectionCache& operator=(const IntrospectionCache& other);
+
+    void Insert(const std::string& digest, const std::shared_ptr<const Node>& root, const std::map<qcc::String, qcc::String>& interfaces);
+    void Erase(EntryList::iterator entry);
+    void LinkObject(const std::string& key, const std::string& digest);
+    void UnlinkObjects(const std::string& peerDigest);
+
+    BusAttachment& bus;
+    mutable qcc::Mutex lock;
+    bool enabled;
+    size_t hits;
+    size_t misses;
+    EntryList entries;                                              /**< Entries from most to least recently used */
+    std::unordered_map<std::string, EntryList::iterator> index;     /**< Entries indexed by digest */
+    std::unordered_map<std::string, std::string> objects;           /**< Digests of the XML of objects indexed by object key */
+    PeerList peers;                                                 /**< Peers from most to least recently used */
+    std::unordered_map<std::string, PeerList::iterator> peerIndex;  /**< Peers indexed by unique name */
+    std::map<qcc::String, qcc::String> interfaceXml;                /**< XML of the interfaces used by the entries */
+    std::map<qcc::String, size_t> interfaceRefs;                    /**< Number of entries using each interface */
+};
+
+}
+
+#endif
@@ -72,10 +72,43 @@ static const uint16_t MixupGuidKeyStoreVersion = 0x0103;
  */
 static const uint16_t CompositeKeyKeyStoreVersion = 0x0104;
 
+/**
+ * the key store version where the snapshot of the keys may be followed by
+ * journal records.
+ */
+static const uint16_t JournalKeyStoreVersion = 0x0105;
+
 /*
  * Current key store version we will write
  */
-static const uint16_t KeyStoreVersion = 0x0104;
+static const uint16_t KeyStoreVersion = 0x0105;
+
+/*
+ * A journal record starts with a marker, the key store revision number after the
+ * record, a random salt that makes the nonce unique and the length of the
+ * encrypted entries that follow.
+ */
+static const uint32_t JournalRecordMarker = 0x4A4B4A41;
+static const size_t JournalSaltLen = 8;
+static const size_t JournalRecordHeaderLen = sizeof(uint32_t) + sizeof(uint32_t) + JournalSaltLen + sizeof(uint32_t);
+
+/*
+ * Upper bound on the encrypted entries of one journal record. A record only
+ * holds the keys changed by one store so anything larger is a damaged length.
+ */
+static const uint32_t JournalRecordMaxLen = 16 * 1024 * 1024;
+
+/*
+ * Each entry in a journal record adds or replaces a key or deletes a key
+ */
+static const uint8_t JournalAddKey = 1;
+static const uint8_t JournalDelKey = 2;
+
+/*
+ * The key store is compacted into a new snapshot when the journal is larger than
+ * both the snapshot and this size.
+ */
+static const size_t JournalCompactionMinSize = 64 * 1024;
 
 /*
  * This is a process-wide lock to protect keystore files. The current implementation has one
@@ -138,6 +171,11 @@ KeyStore::KeyStore(const qcc::String& application) :
     storeState(UNAVAILABLE),
     keys(new KeyMap),
     persistentKeys(new KeyMap),
+    journaled(false),
+    snapshotSize(0),
+    journalSize(0),
+    committer(NULL),
+    updateLock(LOCK_LEVEL_KEYSTORE_UPDATELOCK),
     defaultListener(NULL),
     listener(NULL),
     thisGuid(),
@@ -352,6 +390,15 @@ QStatus KeyStore::StoreInternal(std::vector<Key>& expiredKeys)
     QStatus status = listener->StoreRequest(*this);
     if (status == ER_OK) {
         status = Event::Wait(*stored);
+    } else {
+        /*
+         * The keys were pushed but may not have been written so the journal
+         * state no longer matches the file. Write a full snapshot next time.
+         */
+        QCC_VERIFY(ER_OK == lock.Lock(MUTEX_CONTEXT));
+        journaled = false;
+        storeState = MODIFIED;
+        QCC_VERIFY(ER_OK == lock.Unlock(MUTEX_CONTEXT));
     }
     storedRefCount--;
     if (storedRefCount == 0) {
@@ -523,6 +570,8 @@ QStatus KeyStore::Pull(Source& source, const qcc::String& password)
     size_t len = 0;
     uint16_t version = 0;
     KeyMap pulledKeyRecords;
+    size_t pulledSnapshotSize = 0;
+    size_t pulledJournalSize = 0;
 
     /* Pull and check the key store version */
     QStatus status = source.PullBytes(&version, sizeof(version), pulled);
@@ -556,6 +605,8 @@ QStatus KeyStore::Pull(Source& source, const qcc::String& password)
     if (status != ER_OK) {
         goto ExitPull;
     }
+    /* Decrypting the keys changes len so note where the journal starts now */
+    pulledSnapshotSize = sizeof(version) + sizeof(persistentRevisionLocalBuffer) + qcc::GUID128::SIZE + sizeof(len) + len;
     if (len > 0) {
         uint8_t* data = NULL;
         /*
@@ -644,10 +695,32 @@ QStatus KeyStore::Pull(Source& source, const qcc::String& password)
         goto ExitPull;
     }
 
+    if (version >= JournalKeyStoreVersion) {
+        /*
+         * Apply the journal records that follow the snapshot. Records are only
+         * appended under the exclusive lock so an incomplete or invalid record
+         * can only be left by a writer that failed. It and anything after it is
+         * ignored and will be overwritten by the next record that is stored.
+         */
+        std::set<Key> deletedKeys;
+        size_t recordLen;
+        QStatus recordStatus;
+        while ((recordStatus = PullJournalRecord(source, persistentRevisionLocalBuffer + 1, pulledKeyRecords, deletedKeys, recordLen)) == ER_OK) {
+            ++persistentRevisionLocalBuffer;
+            pulledJournalSize += recordLen;
+        }
+        if (recordStatus != ER_EOF) {
+            QCC_LogError(recordStatus, ("Ignoring key store journal after revision %u", persistentRevisionLocalBuffer));
+        }
+    }
+
 ExitPull:
 
     QCC_VERIFY(ER_OK == lock.Lock(MUTEX_CONTEXT));
     if (status == ER_OK) {
+        journaled = (version >= JournalKeyStoreVersion);
+        snapshotSize = pulledSnapshotSize;
+        journalSize = pulledJournalSize;
         persistentRevision = persistentRevisionLocalBuffer;
         /* Populate the keys we've just pulled */
         for (auto& pulledKeyRec : pulledKeyRecords) {
@@ -656,6 +729,9 @@ ExitPull:
         }
     } else {
         persistentKeys->clear();
+        journaled = false;
+        snapshotSize = 0;
+        journalSize = 0;
         /* Allow for an uninitialized (empty) key store */
         if (status == ER_EOF) {
             persistentRevision = 0;
@@ -683,6 +759,9 @@ void KeyStore::LoadFromEmptyFile(const qcc::String& password)
 
     persistentKeys->clear();
     persistentRevision = 0;
+    journaled = false;
+    snapshotSize = 0;
+    journalSize = 0;
     MarkGuidSet();  /* make thisGuid the keystore guid */
 
     if (loaded) {
@@ -712,6 +791,9 @@ QStatus KeyStore::Clear()
     keys->clear();
     storeState = MODIFIED;
     deletions.clear();
+    /* A journal record cannot express this so the next store writes a new snapshot */
+    journaled = false;
+    changedKeys.clear();
 
     ReleaseExclusiveLock(MUTEX_CONTEXT);
     return status;
@@ -850,6 +932,10 @@ QStatus KeyStore::Push(Sink& sink)
         goto ExitPush;
     }
     storeState = LOADED;
+    journaled = true;
+    snapshotSize = sizeof(KeyStoreVersion) + sizeof(revision) + qcc::GUID128::SIZE + sizeof(keysLen) + keysLen;
+    journalSize = 0;
+    changedKeys.clear();
 
 ExitPush:
 
@@ -860,6 +946,236 @@ ExitPush:
     return status;
 }
 
+QStatus KeyStore::PullJournalRecord(Source& source, uint32_t recordRevision, KeyMap& keyMap, std::set<Key>& deletedKeys, size_t& recordLen)
+{
+    uint8_t header[JournalRecordHeaderLen];
+    size_t pulled = 0;
+    QStatus status = source.PullBytes(header, sizeof(header), pulled);
+    if (status != ER_OK) {
+        return status;
+    }
+    if (pulled != sizeof(header)) {
+        return ER_BUS_CORRUPT_KEYSTORE;
+    }
+
+    uint32_t marker;
+    uint32_t rev;
+    uint32_t len;
+    memcpy(&marker, header, sizeof(marker));
+    memcpy(&rev, header + sizeof(marker), sizeof(rev));
+    memcpy(&len, header + sizeof(marker) + sizeof(rev) + JournalSaltLen, sizeof(len));
+    if ((marker != JournalRecordMarker) || (rev != recordRevision)) {
+        return ER_BUS_CORRUPT_KEYSTORE;
+    }
+    if (len > JournalRecordMaxLen) {
+        /* Don't trust the rest of the file, the journal ends here */
+        QCC_LogError(ER_BUS_CORRUPT_KEYSTORE, ("Journal record %u length %u is too large", rev, len));
+        return ER_EOF;
+    }
+
+    /*
+     * Pull and decrypt the entries. The nonce is the revision number followed
+     * by the salt.
+     */
+    uint8_t* data = new uint8_t[len];
+    status = source.PullBytes(data, len, pulled);
+    if ((status != ER_OK) || (pulled != len)) {
+        delete [] data;
+        return ER_BUS_CORRUPT_KEYSTORE;
+    }
+    size_t dataLen = len;
+    KeyBlob nonce(header + sizeof(marker), sizeof(rev) + JournalSaltLen, KeyBlob::GENERIC);
+    Crypto_AES aes(*keyStoreKey, Crypto_AES::CCM);
+    status = aes.Decrypt_CCM(data, data, dataLen, nonce, NULL, 0, 16);
+
+    StringSource strSource(data, dataLen);
+    while (status == ER_OK) {
+        uint8_t entry;
+        status = strSource.PullBytes(&entry, sizeof(entry), pulled);
+        Key::KeyType keyType = Key::REMOTE;
+        uint8_t guidBuf[qcc::GUID128::SIZE];
+        if (status == ER_OK) {
+            status = strSource.PullBytes(&keyType, sizeof(keyType), pulled);
+        }
+        if (status == ER_OK) {
+            status = strSource.PullBytes(guidBuf, qcc::GUID128::SIZE, pulled);
+        }
+        if (status != ER_OK) {
+            break;
+        }
+        qcc::GUID128 guid(0);
+        guid.SetBytes(guidBuf);
+        Key key(keyType, guid);
+        if (entry == JournalAddKey) {
+            KeyRecord& keyRec = keyMap[key];
+            keyRec.persisted = true;
+            status = strSource.PullBytes(&keyRec.revision, sizeof(keyRec.revision), pulled);
+            if (status == ER_OK) {
+                status = keyRec.keyBlob.Load(strSource);
+            }
+            if (status == ER_OK) {
+                status = strSource.PullBytes(&keyRec.accessRights, sizeof(keyRec.accessRights), pulled);
+            }
+            deletedKeys.erase(key);
+        } else if (entry == JournalDelKey) {
+            keyMap.erase(key);
+            deletedKeys.insert(key);
+        } else {
+            status = ER_BUS_CORRUPT_KEYSTORE;
+        }
+        QCC_DbgPrintf(("KeyStore::PullJournalRecord rev:%u %s %s", rev, (entry == JournalAddKey) ? "add" : "del", key.ToString().c_str()));
+    }
+    delete [] data;
+
+    if (status == ER_EOF) {
+        recordLen = sizeof(header) + len;
+        status = ER_OK;
+    } else {
+        status = ER_BUS_CORRUPT_KEYSTORE;
+    }
+    return status;
+}
+
+QStatus KeyStore::PullJournal(Source& source)
+{
+    QCC_VERIFY(ER_OK == lock.Lock(MUTEX_CONTEXT));
+    uint32_t pulledRevision = revision;
+    bool canPull = keyStoreKey && (snapshotSize > 0) && deletions.empty();
+    QCC_VERIFY(ER_OK == lock.Unlock(MUTEX_CONTEXT));
+    QCC_DbgPrintf(("KeyStore::PullJournal (revision %u)", pulledRevision));
+    if (!canPull) {
+        return ER_BUS_CORRUPT_KEYSTORE;
+    }
+
+    /*
+     * Pull all of the new records before changing the keys so that the keys are
+     * left untouched if the records do not follow on from them.
+     */
+    KeyMap pulledKeyRecords;
+    std::set<Key> deletedKeys;
+    size_t pulledJournalSize = 0;
+    size_t recordLen;
+    QStatus status;
+    while ((status = PullJournalRecord(source, pulledRevision + 1, pulledKeyRecords, deletedKeys, recordLen)) == ER_OK) {
+        ++pulledRevision;
+        pulledJournalSize += recordLen;
+    }
+    if (status != ER_EOF) {
+        return status;
+    }
+    status = ER_OK;
+
+    QCC_VERIFY(ER_OK == lock.Lock(MUTEX_CONTEXT));
+    if (pulledRevision != revision) {
+        if (storeState != LOADED) {
+            /* Only a full load can merge another writer's changes with ours */
+            status = ER_BUS_CORRUPT_KEYSTORE;
+        } else {
+            for (std::set<Key>::iterator it = deletedKeys.begin(); it != deletedKeys.end(); ++it) {
+                keys->erase(*it);
+            }
+            for (KeyMap::iterator it = pulledKeyRecords.begin(); it != pulledKeyRecords.end(); ++it) {
+                (*keys)[it->first] = it->second;
+            }
+            revision = pulledRevision;
+            journalSize += pulledJournalSize;
+        }
+    }
+    if (status == ER_OK) {
+        persistentRevision = revision;
+        if (loaded) {
+            loaded->SetEvent();
+        }
+    }
+    QCC_VERIFY(ER_OK == lock.Unlock(MUTEX_CONTEXT));
+    return status;
+}
+
+QStatus KeyStore::PushJournal(Sink& sink)
+{
+    QCC_DbgHLPrintf(("KeyStore::PushJournal (revision %u)", revision + 1));
+
+    /* Refresh the keystore. */
+    (void)Load();
+
+    QCC_VERIFY(ER_OK == lock.Lock(MUTEX_CONTEXT));
+
+    /*
+     * A new snapshot is needed if the journal cannot be appended to or has
+     * grown larger than the snapshot.
+     */
+    if (!journaled || !keyStoreKey || (snapshotSize == 0) ||
+        ((journalSize >= snapshotSize) && (journalSize >= JournalCompactionMinSize))) {
+        QCC_VERIFY(ER_OK == lock.Unlock(MUTEX_CONTEXT));
+        return ER_BUS_NOT_ALLOWED;
+    }
+
+    /*
+     * Pack the keys that have changed into an intermediate string sink.
+     */
+    size_t pushed;
+    StringSink strSink;
+    for (std::set<Key>::iterator it = changedKeys.begin(); it != changedKeys.end(); ++it) {
+        KeyMap::iterator kit = keys->find(*it);
+        uint8_t entry = (kit == keys->end()) ? JournalDelKey : JournalAddKey;
+        strSink.PushBytes(&entry, sizeof(entry), pushed);
+        Key::KeyType keyType = it->GetType();
+        strSink.PushBytes(&keyType, sizeof(keyType), pushed);
+        strSink.PushBytes(it->GetGUID().GetBytes(), qcc::GUID128::SIZE, pushed);
+        if (entry == JournalAddKey) {
+            strSink.PushBytes(&kit->second.revision, sizeof(kit->second.revision), pushed);
+            kit->second.keyBlob.Store(strSink);
+            strSink.PushBytes(&kit->second.accessRights, sizeof(kit->second.accessRights), pushed);
+        }
+        QCC_DbgPrintf(("KeyStore::PushJournal rev:%u %s %s", revision + 1, (entry == JournalAddKey) ? "add" : "del", it->ToString().c_str()));
+    }
+    size_t len = strSink.GetString().size();
+
+    /*
+     * The record header holds the new revision number and a random salt which
+     * together make up the nonce for encrypting the entries.
+     */
+    ++revision;
+    uint8_t header[JournalRecordHeaderLen];
+    memcpy(header, &JournalRecordMarker, sizeof(JournalRecordMarker));
+    memcpy(header + sizeof(JournalRecordMarker), &revision, sizeof(revision));
+    QStatus status = Crypto_GetRandomBytes(header + sizeof(JournalRecordMarker) + sizeof(revision), JournalSaltLen);
+    uint8_t* data = new uint8_t[len + 16];
+    if (status == ER_OK) {
+        KeyBlob nonce(header + sizeof(JournalRecordMarker), sizeof(revision) + JournalSaltLen, KeyBlob::GENERIC);
+        Crypto_AES aes(*keyStoreKey, Crypto_AES::CCM);
+        status = aes.Encrypt_CCM(strSink.GetString().data(), data, len, nonce, NULL, 0, 16);
+    }
+    if (status == ER_OK) {
+        uint32_t recordLen = static_cast<uint32_t>(len);
+        memcpy(header + sizeof(JournalRecordMarker) + sizeof(revision) + JournalSaltLen, &recordLen, sizeof(recordLen));
+        status = sink.PushBytes(header, sizeof(header), pushed);
+    }
+    if (status == ER_OK) {
+        status = sink.PushBytes(data, len, pushed);
+    }
+    delete [] data;
+    if (status == ER_OK) {
+        storeState = LOADED;
+        journalSize += sizeof(header) + len;
+        changedKeys.clear();
+    }
+
+    if (stored) {
+        stored->SetEvent();
+    }
+    QCC_VERIFY(ER_OK == lock.Unlock(MUTEX_CONTEXT));
+    return status;
+}
+
+size_t KeyStore::GetPersistentSize()
+{
+    QCC_VERIFY(ER_OK == lock.Lock(MUTEX_CONTEXT));
+    size_t size = snapshotSize + journalSize;
+    QCC_VERIFY(ER_OK == lock.Unlock(MUTEX_CONTEXT));
+    return size;
+}
+
 QStatus KeyStore::GetKey(const Key& key, KeyBlob& keyBlob, uint8_t accessRights[4])
 {
     QCC_DbgPrintf(("KeyStore::GetKey %s", key.ToString().c_str()));
@@ -940,23 +1256,8 @@ QStatus KeyStore::AddKey(const Key& key, const KeyBlob& keyBlob, const uint8_t a
         return status;
     }
 
-    status = AcquireExclusiveLock(MUTEX_CONTEXT);
-    if (status != ER_OK) {
-        return status;
-    }
-
-    /* Perform necessary work on the local copy. */
-    KeyRecord& keyRec = (*keys)[key];
-    keyRec.revision = revision + 1;
-    keyRec.keyBlob = keyBlob;
-    QCC_DbgPrintf(("AccessRights %1x%1x%1x%1x", accessRights[0], accessRights[1], accessRights[2], accessRights[3]));
-    memcpy(&keyRec.accessRights, accessRights, sizeof(uint8_t) * 4);
-    storeState = MODIFIED;
-    deletions.erase(key);
-
-    /* Release the lock, which also commits to the listener. */
-    ReleaseExclusiveLock(MUTEX_CONTEXT);
-    return status;
+    KeyUpdate update(KeyUpdate::ADD, key, &keyBlob, accessRights);
+    return CommitUpdate(update);
 }
 
 QStatus KeyStore::DelKey(const Key& key, bool includeAssociatedKeys, bool exclusiveLockAlreadyHeld)
@@ -975,6 +1276,11 @@ QStatus KeyStore::DelKey(const Key& key, bool includeAssociatedKeys, bool exclus
         return status;
     }
 
+    if (!includeAssociatedKeys && !exclusiveLockAlreadyHeld) {
+        KeyUpdate update(KeyUpdate::DEL, key);
+        return CommitUpdate(update);
+    }
+
     if (!exclusiveLockAlreadyHeld) {
         status = AcquireExclusiveLock(MUTEX_CONTEXT);
         if (status != ER_OK) {
@@ -1033,6 +1339,85 @@ void KeyStore::DelKeyInternal(const Key& key)
     keys->erase(key);
     storeState = MODIFIED;
     deletions.insert(keyCopy);
+    changedKeys.insert(keyCopy);
+}
+
+QStatus KeyStore::CommitUpdate(KeyUpdate& update)
+{
+    QCC_VERIFY(ER_OK == updateLock.Lock(MUTEX_CONTEXT));
+    if (committer == Thread::GetThread()) {
+        /* A key event listener called back while this thread is committing */
+        QCC_VERIFY(ER_OK == updateLock.Unlock(MUTEX_CONTEXT));
+        std::deque<KeyUpdate*> updates(1, &update);
+        ApplyUpdates(updates);
+        return update.status;
+    }
+
+    /*
+     * The first caller commits its update together with any updates queued by
+     * other callers while it waits for the exclusive lock. Updates queued while
+     * it stores are committed together by the next caller.
+     */
+    pendingUpdates.push_back(&update);
+    while (!update.done) {
+        if (committer) {
+            QCC_VERIFY(ER_OK == updated.Wait(updateLock));
+            continue;
+        }
+        committer = Thread::GetThread();
+        QCC_VERIFY(ER_OK == updateLock.Unlock(MUTEX_CONTEXT));
+
+        std::deque<KeyUpdate*> updates;
+        ApplyUpdates(updates);
+
+        QCC_VERIFY(ER_OK == updateLock.Lock(MUTEX_CONTEXT));
+        for (std::deque<KeyUpdate*>::iterator it = updates.begin(); it != updates.end(); ++it) {
+            (*it)->done = true;
+        }
+        committer = NULL;
+        updated.Broadcast();
+    }
+    QCC_VERIFY(ER_OK == updateLock.Unlock(MUTEX_CONTEXT));
+    return update.status;
+}
+
+void KeyStore::ApplyUpdates(std::deque<KeyUpdate*>& updates)
+{
+    QStatus status = AcquireExclusiveLock(MUTEX_CONTEXT);
+    if (updates.empty()) {
+        /* Take all of the updates that have been queued */
+        QCC_VERIFY(ER_OK == updateLock.Lock(MUTEX_CONTEXT));
+        updates.swap(pendingUpdates);
+        QCC_VERIFY(ER_OK == updateLock.Unlock(MUTEX_CONTEXT));
+    }
+    if (status != ER_OK) {
+        for (std::deque<KeyUpdate*>::iterator it = updates.begin(); it != updates.end(); ++it) {
+            (*it)->status = status;
+        }
+        return;
+    }
+
+    QCC_DbgPrintf(("KeyStore::ApplyUpdates %u updates", updates.size()));
+    for (std::deque<KeyUpdate*>::iterator it = updates.begin(); it != updates.end(); ++it) {
+        KeyUpdate& update = **it;
+        if (update.op == KeyUpdate::ADD) {
+            /* Perform necessary work on the local copy. */
+            KeyRecord& keyRec = (*keys)[update.key];
+            keyRec.revision = revision + 1;
+            keyRec.keyBlob = *update.keyBlob;
+            QCC_DbgPrintf(("AccessRights %1x%1x%1x%1x", update.accessRights[0], update.accessRights[1], update.accessRights[2], update.accessRights[3]));
+            memcpy(&keyRec.accessRights, update.accessRights, sizeof(keyRec.accessRights));
+            storeState = MODIFIED;
+            deletions.erase(update.key);
+            changedKeys.insert(update.key);
+        } else if (keys->find(update.key) != keys->end()) {
+            DelKeyInternal(update.key);
+        }
+        update.status = ER_OK;
+    }
+
+    /* Release the lock, which also commits to the listener. */
+    ReleaseExclusiveLock(MUTEX_CONTEXT);
 }
 
 QStatus KeyStore::SetKeyExpiration(const Key& key, const Timespec<qcc::EpochTime>& expiration)
@@ -1060,6 +1445,7 @@ QStatus KeyStore::SetKeyExpiration(const Key& key, const Timespec<qcc::EpochTime
     if (keys->count(key) != 0) {
         (*keys)[key].keyBlob.SetExpiration(expiration);
         storeState = MODIFIED;
+        changedKeys.insert(key);
     } else {
         ReleaseExclusiveLock(MUTEX_CONTEXT);
         return ER_BUS_KEY_UNAVAILABLE;
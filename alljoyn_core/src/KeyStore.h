@@ -25,17 +25,21 @@
 #error Only include KeyStore.h in C++ code.
 #endif
 
+#include <deque>
 #include <map>
 #include <set>
+#include <vector>
 
 #include <qcc/platform.h>
 
+#include <qcc/Condition.h>
 #include <qcc/GUID.h>
 #include <qcc/String.h>
 #include <qcc/KeyBlob.h>
 #include <qcc/Mutex.h>
 #include <qcc/Stream.h>
 #include <qcc/Event.h>
+#include <qcc/Thread.h>
 #include <qcc/time.h>
 
 #include <alljoyn/KeyStoreListener.h>
@@ -422,6 +426,48 @@ class KeyStore {
      */
     QStatus Push(qcc::Sink& sink);
 
+    /**
+     * Pull the journal records that were appended to the persistent key store
+     * since the keys were last loaded or stored and apply them to the keys. The
+     * source must be positioned at GetPersistentSize() bytes from the start of
+     * the persistent key store.
+     *
+     * @param source    The source to read the journal records from.
+     * @return
+     *      - ER_OK if successful
+     *      - ER_BUS_CORRUPT_KEYSTORE if the records do not follow on from the keys
+     *        or cannot be merged with changes to the keys, in which case the whole
+     *        key store must be pulled with Pull()
+     *      - An error status otherwise
+     */
+    QStatus PullJournal(qcc::Source& source);
+
+    /**
+     * Push the keys that were added, changed or deleted since the keys were
+     * last loaded or stored into a sink as a journal record. On success the
+     * record must be appended to the persistent key store at
+     * GetPersistentSize() minus the size of the record bytes from its start.
+     *
+     * @param sink    The sink to write the journal record to.
+     * @return
+     *      - ER_OK if successful
+     *      - ER_BUS_NOT_ALLOWED if the persistent key store was written by an
+     *        older version, after Clear() or when the journal has grown large
+     *        enough that it should be compacted, in which case the whole key
+     *        store must be pushed with Push()
+     *      - An error status otherwise
+     */
+    QStatus PushJournal(qcc::Sink& sink);
+
+    /**
+     * Get the number of bytes of the persistent key store, the snapshot and
+     * the journal records that follow it, that the keys were last loaded from
+     * or stored to.
+     *
+     * @return The size of the persistent key store.
+     */
+    size_t GetPersistentSize();
+
     /**
      * Search for associated keys with the given key
      * @param key  The header key
@@ -487,6 +533,32 @@ class KeyStore {
         qcc::String guidString;
     };
 
+    /**
+     * A key update waiting to be committed.
+     */
+    class KeyUpdate {
+      public:
+        /**
+         * The kind of update
+         */
+        typedef enum {
+            ADD,  /**< add or replace a key */
+            DEL   /**< delete a key */
+        } Op;
+
+        KeyUpdate(Op op, const Key& key, const qcc::KeyBlob* keyBlob = NULL, const uint8_t* accessRights = NULL) :
+            op(op), key(key), keyBlob(keyBlob), accessRights(accessRights), status(ER_OK), done(false)
+        {
+        }
+
+        Op op;                        ///< The kind of update
+        Key key;                      ///< The key to update
+        const qcc::KeyBlob* keyBlob;  ///< The key blob to add
+        const uint8_t* accessRights;  ///< The access rights of the key blob to add
+        QStatus status;               ///< Status of the update once done
+        bool done;                    ///< The update has been committed
+    };
+
     /**
      * Assignment not allowed
      */
@@ -532,6 +604,24 @@ class KeyStore {
      */
     QStatus StoreInternal(std::vector<Key>& expiredKeys);
 
+    /**
+     * Commit a key update. Updates from concurrent callers are applied together
+     * under a single exclusive lock and stored with a single store request.
+     *
+     * @param update  The update to commit.
+     * @return The status of the update.
+     */
+    QStatus CommitUpdate(KeyUpdate& update);
+
+    /**
+     * Apply and store a batch of key updates. The exclusive lock must not be held.
+     *
+     * @param updates  The updates to apply. If empty, the updates queued by
+     *                 CommitUpdate() are taken once the exclusive lock is held.
+     *                 The status of each update is set.
+     */
+    void ApplyUpdates(std::deque<KeyUpdate*>& updates);
+
     /**
      * Helper function for acquiring exclusive lock.
      *
@@ -599,6 +689,21 @@ class KeyStore {
      */
     QStatus LoadPersistentKeys();
 
+    /**
+     * Pull one journal record and apply it to a key map.
+     *
+     * @param source          The source to read the record from.
+     * @param recordRevision  The revision the record must have.
+     * @param keyMap          The key map to add the keys in the record to.
+     * @param deletedKeys     The keys deleted by the record are added to this set.
+     * @param[out] recordLen  The length of the record.
+     * @return
+     *      - ER_OK if successful
+     *      - ER_EOF if there are no more records
+     *      - ER_BUS_CORRUPT_KEYSTORE if the record is incomplete or invalid
+     */
+    QStatus PullJournalRecord(qcc::Source& source, uint32_t recordRevision, KeyMap& keyMap, std::set<Key>& deletedKeys, size_t& recordLen);
+
     /**
      * In memory copy of the key store
      */
@@ -616,6 +721,47 @@ class KeyStore {
      */
     std::set<Key> deletions;
 
+    /**
+     * Keys that have been added, changed or deleted since the keys were last stored
+     */
+    std::set<Key> changedKeys;
+
+    /**
+     * The persistent key store takes journal records and changedKeys holds all of
+     * the changes since it was last loaded or stored
+     */
+    bool journaled;
+
+    /**
+     * Size of the snapshot of the keys at the start of the persistent key store
+     */
+    size_t snapshotSize;
+
+    /**
+     * Size of the journal records that follow the snapshot
+     */
+    size_t journalSize;
+
+    /**
+     * Key updates waiting to be committed
+     */
+    std::deque<KeyUpdate*> pendingUpdates;
+
+    /**
+     * The thread committing key updates or NULL
+     */
+    qcc::Thread* committer;
+
+    /**
+     * Mutex to protect pendingUpdates and committer
+     */
+    qcc::Mutex updateLock;
+
+    /**
+     * Condition signaled when key updates have been committed
+     */
+    qcc::Condition updated;
+
     /**
      * Default listener for handling load/store requests
      */
@@ -22,7 +22,9 @@
  ******************************************************************************/
 #include <qcc/platform.h>
 
+#include <deque>
 #include <list>
+#include <vector>
 
 #include <qcc/Debug.h>
 #include <qcc/GUID.h>
@@ -30,6 +32,7 @@
 #include <qcc/StringUtil.h>
 #include <qcc/Thread.h>
 #include <qcc/atomic.h>
+#include <qcc/Condition.h>
 
 #include <alljoyn/DBusStd.h>
 #include <alljoyn/AllJoynStd.h>
@@ -64,19 +67,24 @@ static const uint32_t LOCAL_ENDPOINT_CONCURRENCY = 4;
 static const uint32_t LOCAL_ENDPOINT_MAXALARMS = 10;
 #endif
 
-class _LocalEndpoint::Dispatcher : public qcc::Timer, public qcc::AlarmListener {
+/*
+ * The dispatcher runs method, signal and reply handlers on a pool of worker threads. Each worker
+ * has its own queue of pending messages. Messages from one sender in one session always go to the
+ * same queue. An idle worker steals the oldest message from the other queues. Once a message has
+ * been taken from a queue no other message is taken from that queue until its handler has started,
+ * so the messages of one sender and session start in the order they arrived. Messages of different
+ * senders may start in a different order. Only one handler runs at a time unless the running
+ * handler calls EnableConcurrentCallbacks.
+ */
+class _LocalEndpoint::Dispatcher {
   public:
-    Dispatcher(_LocalEndpoint* endpoint, uint32_t concurrency = LOCAL_ENDPOINT_CONCURRENCY) :
-        Timer("lepDisp" + U32ToString(qcc::IncrementAndFetch(&dispatcherCnt)), true, concurrency, true, LOCAL_ENDPOINT_MAXALARMS),
-        AlarmListener(), endpoint(endpoint), pendingWork(),
-        needDeferredCallbacks(false), needObserverWork(false),
-        needCachedPropertyReplyWork(false),
-        workLock(LOCK_LEVEL_LOCALTRANSPORT_LOCALENDPOINT_DISPATCHER_WORKLOCK)
-    {
-        uint32_t zero = 0;
-        qcc::AlarmListener* listener = static_cast<qcc::AlarmListener*>(this);
-        pendingWork = Alarm(zero, listener);
-    }
+    Dispatcher(_LocalEndpoint* endpoint, uint32_t concurrency = LOCAL_ENDPOINT_CONCURRENCY);
+
+    ~Dispatcher();
+
+    QStatus Start();
+    QStatus Stop();
+    QStatus Join();
 
     QStatus DispatchMessage(Message& msg);
 
@@ -88,21 +96,306 @@ class _LocalEndpoint::Dispatcher : public qcc::Timer, public qcc::AlarmListener
     void PerformObserverWork();
     void PerformCachedPropertyReplyWork();
 
-    void AlarmTriggered(const qcc::Alarm& alarm, QStatus reason);
+    void EnableReentrancy();
+    bool IsHoldingReentrantLock() const;
+    bool IsDispatcherThread() const { return GetCurrentWorker() != NULL; }
 
   private:
+    class Worker;
+
+    /* A queued message, or a request to run the pending work if msg is NULL */
+    struct Task {
+        Task(Message* msg, bool limitable) : msg(msg), limitable(limitable) { }
+        Message* msg;
+        bool limitable;         /* Whether the task counts towards LOCAL_ENDPOINT_MAXALARMS */
+    };
+
+    /* Private copy constructor and assignment operator - do nothing */
+    Dispatcher(const Dispatcher&);
+    Dispatcher& operator=(const Dispatcher&);
+
+    Worker* GetCurrentWorker() const;
+    void Enqueue(size_t index, const Task& task);
+    Worker* Dequeue(size_t index, Task& task);
+    void TaskStarted(Worker* from);
+    void SignalWork();
+    bool WaitForWork();
+    void RunTask(const Task& task);
+    void TriggerPendingWork();
+    void ExpireTasks();
+
     _LocalEndpoint* endpoint;
     static volatile int32_t dispatcherCnt;
 
-    Alarm pendingWork;
+    std::vector<Worker*> workers;
+    volatile bool running;
+    volatile int32_t numReady;          /* Queues with a task that can be taken */
+    volatile int32_t numIdle;           /* Workers waiting for a task */
+    qcc::Mutex idleLock;
+    qcc::Condition workAvailable;
+    uint32_t numLimitable;              /* Queued tasks that count towards LOCAL_ENDPOINT_MAXALARMS */
+    qcc::Mutex limitLock;
+    qcc::Condition notFull;
+    qcc::Mutex reentrancyLock;          /* Held by the worker running a handler until it enables concurrent callbacks */
+    volatile int32_t nextWorker;
+
+    bool pendingWorkQueued;
     bool needDeferredCallbacks;
     bool needObserverWork;
     bool needCachedPropertyReplyWork;
     qcc::Mutex workLock;
 };
 
+class _LocalEndpoint::Dispatcher::Worker : public qcc::Thread {
+  public:
+    Worker(const qcc::String& name, Dispatcher* dispatcher, size_t index) :
+        Thread(name), dispatcher(dispatcher), index(index), hasReentrancyLock(false), starting(false),
+        queueLock(LOCK_LEVEL_LOCALTRANSPORT_LOCALENDPOINT_DISPATCHER_QUEUELOCK)
+    { }
+
+    Dispatcher* dispatcher;
+    const size_t index;
+    bool hasReentrancyLock;
+    bool starting;                      /* A task taken from the queue has not started yet */
+    std::deque<Task> queue;
+    qcc::Mutex queueLock;
+
+  protected:
+    qcc::ThreadReturn STDCALL Run(void* arg);
+
+  private:
+    /* Private assignment operator - does nothing */
+    Worker& operator=(const Worker&);
+};
+
 volatile int32_t _LocalEndpoint::Dispatcher::dispatcherCnt = 0;
 
+_LocalEndpoint::Dispatcher::Dispatcher(_LocalEndpoint* endpoint, uint32_t concurrency) :
+    endpoint(endpoint),
+    workers(concurrency ? concurrency : 1),
+    running(false),
+    numReady(0),
+    numIdle(0),
+    idleLock(LOCK_LEVEL_LOCALTRANSPORT_LOCALENDPOINT_DISPATCHER_IDLELOCK),
+    numLimitable(0),
+    limitLock(LOCK_LEVEL_LOCALTRANSPORT_LOCALENDPOINT_DISPATCHER_LIMITLOCK),
+    reentrancyLock(LOCK_LEVEL_LOCALTRANSPORT_LOCALENDPOINT_DISPATCHER_REENTRANCYLOCK),
+    nextWorker(0),
+    pendingWorkQueued(false),
+    needDeferredCallbacks(false), needObserverWork(false),
+    needCachedPropertyReplyWork(false),
+    workLock(LOCK_LEVEL_LOCALTRANSPORT_LOCALENDPOINT_DISPATCHER_WORKLOCK)
+{
+    String name = "lepDisp" + U32ToString(qcc::IncrementAndFetch(&dispatcherCnt));
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i] = new Worker(name + "_" + U32ToString(i), this, i);
+    }
+}
+
+_LocalEndpoint::Dispatcher::~Dispatcher()
+{
+    Stop();
+    Join();
+    for (size_t i = 0; i < workers.size(); ++i) {
+        delete workers[i];
+    }
+}
+
+QStatus _LocalEndpoint::Dispatcher::Start()
+{
+    if (running) {
+        return ER_OK;
+    }
+    running = true;
+    QStatus status = ER_OK;
+    for (size_t i = 0; (status == ER_OK) && (i < workers.size()); ++i) {
+        status = workers[i]->Start();
+        if (status != ER_OK) {
+            QCC_LogError(status, ("Error starting dispatcher thread %s", workers[i]->GetName()));
+        }
+    }
+    if (status != ER_OK) {
+        Stop();
+        Join();
+    }
+    return status;
+}
+
+QStatus _LocalEndpoint::Dispatcher::Stop()
+{
+    QStatus status = ER_OK;
+    running = false;
+    for (size_t i = 0; i < workers.size(); ++i) {
+        QStatus tStatus = workers[i]->Stop();
+        status = (status == ER_OK) ? tStatus : status;
+    }
+    idleLock.Lock(MUTEX_CONTEXT);
+    workAvailable.Broadcast();
+    idleLock.Unlock(MUTEX_CONTEXT);
+    limitLock.Lock(MUTEX_CONTEXT);
+    notFull.Broadcast();
+    limitLock.Unlock(MUTEX_CONTEXT);
+    return status;
+}
+
+QStatus _LocalEndpoint::Dispatcher::Join()
+{
+    QStatus status = ER_OK;
+    for (size_t i = 0; i < workers.size(); ++i) {
+        QStatus tStatus = workers[i]->Join();
+        status = (status == ER_OK) ? tStatus : status;
+    }
+    if (!running) {
+        ExpireTasks();
+    }
+    return status;
+}
+
+_LocalEndpoint::Dispatcher::Worker* _LocalEndpoint::Dispatcher::GetCurrentWorker() const
+{
+    Thread* thread = Thread::GetThread();
+    for (size_t i = 0; i < workers.size(); ++i) {
+        if (static_cast<Thread*>(workers[i]) == thread) {
+            return workers[i];
+        }
+    }
+    return NULL;
+}
+
+void _LocalEndpoint::Dispatcher::Enqueue(size_t index, const Task& task)
+{
+    Worker* worker = workers[index];
+    worker->queueLock.Lock(MUTEX_CONTEXT);
+    worker->queue.push_back(task);
+    bool ready = !worker->starting && (worker->queue.size() == 1);
+    if (ready) {
+        IncrementAndFetch(&numReady);
+    }
+    worker->queueLock.Unlock(MUTEX_CONTEXT);
+    if (ready) {
+        SignalWork();
+    }
+}
+
+_LocalEndpoint::Dispatcher::Worker* _LocalEndpoint::Dispatcher::Dequeue(size_t index, Task& task)
+{
+    /*
+     * Try our own queue first then steal from the others. Always take the oldest task and skip
+     * queues whose last task has not started yet, so tasks that share a queue start in order
+     * whichever worker runs them.
+     */
+    Worker* from = NULL;
+    for (size_t i = 0; !from && (i < workers.size()); ++i) {
+        Worker* worker = workers[(index + i) % workers.size()];
+        worker->queueLock.Lock(MUTEX_CONTEXT);
+        if (!worker->starting && !worker->queue.empty()) {
+            task = worker->queue.front();
+            worker->queue.pop_front();
+            worker->starting = true;
+            DecrementAndFetch(&numReady);
+            from = worker;
+        }
+        worker->queueLock.Unlock(MUTEX_CONTEXT);
+    }
+    if (from && task.limitable) {
+        limitLock.Lock(MUTEX_CONTEXT);
+        --numLimitable;
+        notFull.Signal();
+        limitLock.Unlock(MUTEX_CONTEXT);
+    }
+    return from;
+}
+
+void _LocalEndpoint::Dispatcher::TaskStarted(Worker* from)
+{
+    from->queueLock.Lock(MUTEX_CONTEXT);
+    from->starting = false;
+    bool ready = !from->queue.empty();
+    if (ready) {
+        IncrementAndFetch(&numReady);
+    }
+    from->queueLock.Unlock(MUTEX_CONTEXT);
+    if (ready) {
+        SignalWork();
+    }
+}
+
+void _LocalEndpoint::Dispatcher::SignalWork()
+{
+    /*
+     * An idle worker counts itself before checking numReady and we count the ready queue before
+     * checking numIdle, so at least one side sees the other and the wakeup cannot be lost.
+     */
+    if (numIdle > 0) {
+        idleLock.Lock(MUTEX_CONTEXT);
+        workAvailable.Signal();
+        idleLock.Unlock(MUTEX_CONTEXT);
+    }
+}
+
+bool _LocalEndpoint::Dispatcher::WaitForWork()
+{
+    if (numReady > 0) {
+        return running;
+    }
+    idleLock.Lock(MUTEX_CONTEXT);
+    IncrementAndFetch(&numIdle);
+    while (running && (numReady <= 0)) {
+        workAvailable.Wait(idleLock);
+    }
+    DecrementAndFetch(&numIdle);
+    idleLock.Unlock(MUTEX_CONTEXT);
+    return running;
+}
+
+void _LocalEndpoint::Dispatcher::ExpireTasks()
+{
+    for (size_t i = 0; i < workers.size(); ++i) {
+        Worker* worker = workers[i];
+        worker->queueLock.Lock(MUTEX_CONTEXT);
+        if (!worker->starting && !worker->queue.empty()) {
+            DecrementAndFetch(&numReady);
+        }
+        while (!worker->queue.empty()) {
+            Task task = worker->queue.front();
+            worker->queue.pop_front();
+            delete task.msg;
+        }
+        worker->queueLock.Unlock(MUTEX_CONTEXT);
+    }
+    workLock.Lock(MUTEX_CONTEXT);
+    pendingWorkQueued = false;
+    workLock.Unlock(MUTEX_CONTEXT);
+    limitLock.Lock(MUTEX_CONTEXT);
+    numLimitable = 0;
+    limitLock.Unlock(MUTEX_CONTEXT);
+}
+
+qcc::ThreadReturn STDCALL _LocalEndpoint::Dispatcher::Worker::Run(void* arg)
+{
+    QCC_UNUSED(arg);
+    while (!IsStopping() && dispatcher->WaitForWork()) {
+        Task task(NULL, false);
+        Worker* from = dispatcher->Dequeue(index, task);
+        if (!from) {
+            continue;
+        }
+        /*
+         * The queue the task came from stays blocked until we hold the reentrancy lock, so the
+         * next task from that queue cannot start before this one.
+         */
+        dispatcher->reentrancyLock.Lock(MUTEX_CONTEXT);
+        hasReentrancyLock = true;
+        dispatcher->TaskStarted(from);
+        dispatcher->RunTask(task);
+        if (hasReentrancyLock) {
+            hasReentrancyLock = false;
+            dispatcher->reentrancyLock.Unlock(MUTEX_CONTEXT);
+        }
+    }
+    return (qcc::ThreadReturn)0;
+}
+
 LocalTransport::~LocalTransport()
 {
     Stop();
@@ -204,7 +497,7 @@ _LocalEndpoint::_LocalEndpoint(BusAttachment& bus, uint32_t concurrency) :
     bus(&bus),
     objectsLock(LOCK_LEVEL_LOCALTRANSPORT_LOCALENDPOINT_OBJECTSLOCK),
     replyMapLock(LOCK_LEVEL_LOCALTRANSPORT_LOCALENDPOINT_REPLYMAPLOCK),
-    replyTimer("replyTimer", true),
+    replyTimer("replyTimer", true, 1, false, 0, Timer::ALARM_TIMING_WHEEL),
     dbusObj(NULL),
     alljoynObj(NULL),
     alljoynDebugObj(NULL),
@@ -434,20 +727,48 @@ QStatus _LocalEndpoint::PeerInterface(Message& message)
 
 QStatus _LocalEndpoint::Dispatcher::DispatchMessage(Message& msg)
 {
-    uint32_t zero = 0;
-    void* context = new Message(msg);
-    qcc::AlarmListener* localEndpointListener = this;
     bool limitable = (endpoint->GetUniqueName() != msg->GetSender());
-    Alarm alarm(zero, localEndpointListener, context, zero, limitable);
+    if (limitable) {
+        /* Don't allow an unbounded number of messages from other endpoints to queue up */
+        limitLock.Lock(MUTEX_CONTEXT);
+        while (running && (numLimitable >= LOCAL_ENDPOINT_MAXALARMS)) {
+            notFull.Wait(limitLock);
+        }
+        if (running) {
+            ++numLimitable;
+        }
+        limitLock.Unlock(MUTEX_CONTEXT);
+    }
+    if (!running) {
+        return ER_BUS_STOPPING;
+    }
 
-    QStatus status = AddAlarm(alarm);
-    if (status != ER_OK) {
-        Message* temp = static_cast<Message*>(context);
-        if (temp) {
-            delete temp;
+    /* Messages from the same sender in the same session share a queue */
+    uint32_t hash = msg->GetSessionId();
+    for (const char* sender = msg->GetSender(); *sender; ++sender) {
+        hash = (hash * 31) + static_cast<uint8_t>(*sender);
+    }
+    Enqueue(hash % workers.size(), Task(new Message(msg), limitable));
+    return ER_OK;
+}
+
+void _LocalEndpoint::Dispatcher::EnableReentrancy()
+{
+    Worker* worker = GetCurrentWorker();
+    if (worker) {
+        if (worker->hasReentrancyLock) {
+            worker->hasReentrancyLock = false;
+            reentrancyLock.Unlock(MUTEX_CONTEXT);
         }
+    } else {
+        QCC_LogError(ER_TIMER_NOT_ALLOWED, ("Invalid call to EnableReentrancy from thread %s", Thread::GetThreadName()));
     }
-    return status;
+}
+
+bool _LocalEndpoint::Dispatcher::IsHoldingReentrantLock() const
+{
+    Worker* worker = GetCurrentWorker();
+    return worker && worker->hasReentrancyLock;
 }
 
 void _LocalEndpoint::EnableReentrancy()
@@ -465,26 +786,33 @@ bool _LocalEndpoint::IsReentrantCall()
     return dispatcher->IsHoldingReentrantLock();
 }
 
-void _LocalEndpoint::Dispatcher::TriggerDeferredCallbacks()
+void _LocalEndpoint::Dispatcher::TriggerPendingWork()
 {
     workLock.Lock(MUTEX_CONTEXT);
-    if (needDeferredCallbacks) {
+    if (pendingWorkQueued) {
         workLock.Unlock(MUTEX_CONTEXT);
         return;
     }
-    needDeferredCallbacks = true;
+    pendingWorkQueued = true;
     workLock.Unlock(MUTEX_CONTEXT);
 
     /*
-     * Don't block while adding the alarm.
-     * First, we may be calling this method from within the context of a
-     * triggered Alarm. In this case a blocking AddAlarm is an instant
-     * deadlock.
-     * Second, AddAlarm would only block if the our alarm queue is already
-     * full. The work will be picked up by the first existing alarm that
-     * triggers anyway.
+     * Never block here. We may be on a dispatcher thread and the pending work does not count
+     * towards LOCAL_ENDPOINT_MAXALARMS. The work is also picked up by whichever task runs first.
      */
-    AddAlarmNonBlocking(pendingWork);
+    Enqueue(static_cast<uint32_t>(IncrementAndFetch(&nextWorker)) % workers.size(), Task(NULL, false));
+}
+
+void _LocalEndpoint::Dispatcher::TriggerDeferredCallbacks()
+{
+    workLock.Lock(MUTEX_CONTEXT);
+    if (needDeferredCallbacks) {
+        workLock.Unlock(MUTEX_CONTEXT);
+        return;
+    }
+    needDeferredCallbacks = true;
+    workLock.Unlock(MUTEX_CONTEXT);
+    TriggerPendingWork();
 }
 
 void _LocalEndpoint::Dispatcher::TriggerObserverWork()
@@ -496,17 +824,7 @@ void _LocalEndpoint::Dispatcher::TriggerObserverWork()
     }
     needObserverWork = true;
     workLock.Unlock(MUTEX_CONTEXT);
-
-    /*
-     * Don't block while adding the alarm.
-     * First, we may be calling this method from within the context of a
-     * triggered Alarm. In this case a blocking AddAlarm is an instant
-     * deadlock.
-     * Second, AddAlarm would only block if the our alarm queue is already
-     * full. The work will be picked up by the first existing alarm that
-     * triggers anyway.
-     */
-    AddAlarmNonBlocking(pendingWork);
+    TriggerPendingWork();
 }
 
 void _LocalEndpoint::Dispatcher::TriggerCachedPropertyReplyWork()
@@ -518,17 +836,7 @@ void _LocalEndpoint::Dispatcher::TriggerCachedPropertyReplyWork()
     }
     needCachedPropertyReplyWork = true;
     workLock.Unlock(MUTEX_CONTEXT);
-
-    /*
-     * Don't block while adding the alarm.
-     * First, we may be calling this method from within the context of a
-     * triggered Alarm. In this case a blocking AddAlarm is an instant
-     * deadlock.
-     * Second, AddAlarm would only block if the our alarm queue is already
-     * full. The work will be picked up by the first existing alarm that
-     * triggers anyway.
-     */
-    AddAlarmNonBlocking(pendingWork);
+    TriggerPendingWork();
 }
 
 void _LocalEndpoint::Dispatcher::PerformDeferredCallbacks()
@@ -585,27 +893,23 @@ void _LocalEndpoint::Dispatcher::PerformCachedPropertyReplyWork()
     endpoint->replyMapLock.Unlock(MUTEX_CONTEXT);
 }
 
-void _LocalEndpoint::Dispatcher::AlarmTriggered(const Alarm& alarm, QStatus reason)
+void _LocalEndpoint::Dispatcher::RunTask(const Task& task)
 {
     /* first deal with incoming messages */
-    Message* msg = static_cast<Message*>(alarm->GetContext());
-    if (msg) {
-        if (reason == ER_OK) {
-            QStatus status = endpoint->DoPushMessage(*msg);
-            // ER_BUS_STOPPING is a common shutdown error
-            if (status != ER_OK && status != ER_BUS_STOPPING) {
-                QCC_LogError(status, ("LocalEndpoint::DoPushMessage failed"));
-            }
+    if (task.msg) {
+        QStatus status = endpoint->DoPushMessage(*task.msg);
+        // ER_BUS_STOPPING is a common shutdown error
+        if (status != ER_OK && status != ER_BUS_STOPPING) {
+            QCC_LogError(status, ("LocalEndpoint::DoPushMessage failed"));
         }
-        delete msg;
+        delete task.msg;
     }
 
     /* next, deal with any pending work */
-    if (reason != ER_OK) {
-        return;
-    }
-
     workLock.Lock(MUTEX_CONTEXT);
+    if (!task.msg) {
+        pendingWorkQueued = false;
+    }
 
     if (needObserverWork) {
         needObserverWork = false;
@@ -641,7 +945,7 @@ QStatus _LocalEndpoint::PushMessage(Message& message)
     if (running) {
         BusEndpoint ep = bus->GetInternal().GetRouter().FindEndpoint(message->GetSender());
         /* Determine if the source of this message is local to the process */
-        if ((ep->GetEndpointType() == ENDPOINT_TYPE_LOCAL) && (dispatcher->IsTimerCallbackThread())) {
+        if ((ep->GetEndpointType() == ENDPOINT_TYPE_LOCAL) && (dispatcher->IsDispatcherThread())) {
             ret = DoPushMessage(message);
         } else {
             ret = dispatcher->DispatchMessage(message);
@@ -1230,7 +1534,7 @@ QStatus _LocalEndpoint::HandleMethodCall(Message& message)
             }
         }
         if (status == ER_OK) {
-            status = message->UnmarshalArgs(entry->member->signature, entry->member->returnSignature.c_str());
+            status = message->UnmarshalArgs(entry->member->signature, entry->member->returnSignature.c_str(), entry->member->isArgView);
         }
     }
     if (status == ER_OK) {
@@ -1345,7 +1649,7 @@ QStatus _LocalEndpoint::HandleSignal(Message& message)
         status = ER_BUS_MESSAGE_NOT_ENCRYPTED;
         QCC_LogError(status, ("Signal from secure interface was not encrypted"));
     } else {
-        status = message->UnmarshalArgs(signal->signature);
+        status = message->UnmarshalArgs(signal->signature, NULL, signal->isArgView);
     }
     if (status != ER_OK) {
         if ((status == ER_BUS_MESSAGE_DECRYPTION_FAILED) || (status == ER_BUS_MESSAGE_NOT_ENCRYPTED) || (status == ER_BUS_NOT_AUTHORIZED)) {
@@ -1397,7 +1701,7 @@ QStatus _LocalEndpoint::HandleMethodReply(Message& message)
         } else {
             QCC_DbgPrintf(("Matched reply for serial #%d", message->GetReplySerial()));
             if (message->GetType() == MESSAGE_METHOD_RET) {
-                status = message->UnmarshalArgs(rc->method->returnSignature);
+                status = message->UnmarshalArgs(rc->method->returnSignature, NULL, rc->method->isArgView);
             } else {
                 status = message->UnmarshalArgs("*");
             }
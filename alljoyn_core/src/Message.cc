@@ -57,7 +57,8 @@ const uint32_t _Message::AUTH_FALLBACK_VERSION = 2;
 
 qcc::String _Message::ToString() const
 {
-    return ToString(msgArgs, numMsgArgs);
+    const MsgArg* args = ParsedArgs();
+    return ToString(args, args ? numMsgArgs : 0);
 }
 
 HeaderFields::HeaderFields(const HeaderFields& other)
@@ -270,9 +271,10 @@ const char* _Message::GetErrorName(qcc::String* errorMessage) const
         if (hdrFields.field[ALLJOYN_HDR_FIELD_ERROR_NAME].typeId == ALLJOYN_STRING) {
             if (errorMessage != NULL) {
                 errorMessage->clear();
-                for (size_t i = 0; i < numMsgArgs; i++) {
-                    if (msgArgs[i].typeId == ALLJOYN_STRING) {
-                        errorMessage->append(msgArgs[i].v_string.str);
+                const MsgArg* args = ParsedArgs();
+                for (size_t i = 0; args && (i < numMsgArgs); i++) {
+                    if (args[i].typeId == ALLJOYN_STRING) {
+                        errorMessage->append(args[i].v_string.str);
                     }
                 }
             }
@@ -303,9 +305,10 @@ QStatus _Message::GetArgs(const char* signature, ...)
     if (sigLen == 0) {
         return ER_BAD_ARG_1;
     }
+    const MsgArg* args = ParsedArgs();
     va_list argp;
     va_start(argp, signature);
-    QStatus status = MsgArg::VParseArgs(signature, sigLen, msgArgs, numMsgArgs, &argp);
+    QStatus status = MsgArg::VParseArgs(signature, sigLen, args, args ? numMsgArgs : 0, &argp);
     va_end(argp);
     return status;
 }
@@ -329,6 +332,8 @@ void _Message::Init(BusAttachment& busAttachment)
     msgBuf = NULL;
     msgArgs = NULL;
     numMsgArgs = 0;
+    argsDeferred = false;
+    argsEndianSwap = false;
     refMsgArgs = NULL;
     numRefMsgArgs = 0;
     bufSize = 0;
@@ -339,8 +344,6 @@ void _Message::Init(BusAttachment& busAttachment)
     authVersion = -1;
     readState = MESSAGE_NEW;
     countRead = 0;
-    writeState = MESSAGE_NEW;
-    countWrite = 0;
     msgHeader.msgType = MESSAGE_INVALID;
     msgHeader.endian = myEndian;
     encryptionNotification = NULL;
@@ -363,6 +366,8 @@ _Message::_Message(const _Message& other) :
     endianSwap(other.endianSwap),
     msgHeader(other.msgHeader),
     numMsgArgs(other.numMsgArgs),
+    argsDeferred(other.argsDeferred),
+    argsEndianSwap(other.argsEndianSwap),
     numRefMsgArgs(other.numRefMsgArgs),
     bufSize(other.bufSize),
     ttl(other.ttl),
@@ -375,8 +380,6 @@ _Message::_Message(const _Message& other) :
     authVersion(other.authVersion),
     readState(other.readState),
     countRead(other.countRead),
-    writeState(other.writeState),
-    countWrite(other.countWrite),
     hdrFields(other.hdrFields),
     encryptionNotification(other.encryptionNotification),
     authorizationChecked(other.authorizationChecked)
@@ -401,10 +404,15 @@ _Message::_Message(const _Message& other) :
         bufPos = NULL;
         bodyPtr = NULL;
     }
-    if (numMsgArgs > 0) {
+    /*
+     * Deferred arguments may be built by another thread while we are copying them, if they have
+     * not been built yet this copy builds its own from the copied buffer when they are needed.
+     */
+    const MsgArg* otherArgs = other.msgArgs;
+    if (otherArgs && (numMsgArgs > 0)) {
         msgArgs =  new MsgArg[numMsgArgs];
         for (size_t i = 0; i < numMsgArgs; ++i) {
-            msgArgs[i] = other.msgArgs[i];
+            msgArgs[i] = otherArgs[i];
         }
     } else {
         msgArgs = NULL;
@@ -439,6 +447,7 @@ QStatus _Message::ReMarshal(const char* senderName)
     delete [] msgArgs;
     msgArgs = NULL;
     numMsgArgs = 0;
+    argsDeferred = false;
     delete [] refMsgArgs;
     refMsgArgs = NULL;
     numRefMsgArgs = 0;
@@ -534,6 +543,7 @@ void _Message::ClearHeader()
         delete [] msgArgs;
         msgArgs = NULL;
         numMsgArgs = 0;
+        argsDeferred = false;
         delete [] refMsgArgs;
         refMsgArgs = NULL;
         numRefMsgArgs = 0;
@@ -40,6 +40,7 @@
 #include "BusUtil.h"
 #include "AllJoynCrypto.h"
 #include "AllJoynPeerObj.h"
+#include "HeaderDictionary.h"
 #include "SignatureUtils.h"
 #include "BusInternal.h"
 
@@ -527,19 +528,19 @@ QStatus _Message::Deliver(RemoteEndpoint& endpoint)
     return status;
 }
 
-QStatus _Message::DeliverNonBlocking(RemoteEndpoint& endpoint)
+QStatus _Message::DeliverNonBlocking(RemoteEndpoint& endpoint, MessageWriteCursor& cursor)
 {
     size_t pushed;
     QStatus status = ER_OK;
     Sink& sink = endpoint->GetSink();
 
-    switch (writeState) {
+    switch (cursor.state) {
     case MESSAGE_NEW:
-        writePtr = reinterpret_cast<uint8_t*>(msgBuf);
-        countWrite = bufEOD - writePtr;
+        cursor.ptr = reinterpret_cast<const uint8_t*>(msgBuf);
+        cursor.count = bufEOD - cursor.ptr;
         pushed = 0;
 
-        if (countWrite == 0) {
+        if (cursor.count == 0) {
             status = ER_BUS_EMPTY_MESSAGE;
             QCC_LogError(status, ("Message is empty"));
             return status;
@@ -553,9 +554,10 @@ QStatus _Message::DeliverNonBlocking(RemoteEndpoint& endpoint)
             return status;
         }
         /*
-         * If the message has a TTL, check if it has expired
+         * If the message has a TTL, check if it has expired. A message that has
+         * already been compressed for this endpoint must be sent regardless.
          */
-        if (ttl && IsExpired()) {
+        if (ttl && IsExpired() && !HeaderDictionary::IsCompressed(*this)) {
             QCC_DbgHLPrintf(("TTL has expired - discarding message %s", Description().c_str()));
             return ER_OK;
         }
@@ -574,24 +576,32 @@ QStatus _Message::DeliverNonBlocking(RemoteEndpoint& endpoint)
                 return status;
             }
             /*
-             * Recompute because encryption increases the packet length
+             * The encrypted message is private to this endpoint so its header
+             * can be compressed in place.
              */
-            countWrite = bufEOD - writePtr;
+            HeaderDictionary* dictionary = endpoint->GetTxHeaderDictionary();
+            if ((status == ER_OK) && dictionary) {
+                dictionary->Compress(*this);
+            }
+            /*
+             * Recompute because encryption and compression change the packet length
+             */
+            cursor.count = bufEOD - cursor.ptr;
         }
-        writeState = MESSAGE_HEADERFIELDS;
+        cursor.state = MESSAGE_HEADERFIELDS;
     /* no break  FALLTHROUGH*/
 
     case MESSAGE_HEADERFIELDS:
         if (handles) {
-            status = sink.PushBytesAndFds(writePtr, countWrite, pushed, handles, numHandles, endpoint->GetProcessId());
+            status = sink.PushBytesAndFds(cursor.ptr, cursor.count, pushed, handles, numHandles, endpoint->GetProcessId());
         } else {
-            status = sink.PushBytes(writePtr, countWrite, pushed, (msgHeader.flags & ALLJOYN_FLAG_SESSIONLESS) ? (ttl * 1000) : ttl);
+            status = sink.PushBytes(cursor.ptr, cursor.count, pushed, (msgHeader.flags & ALLJOYN_FLAG_SESSIONLESS) ? (ttl * 1000) : ttl);
         }
 
         if (status == ER_OK) {
-            countWrite -= pushed;
-            writePtr += pushed;
-            writeState = MESSAGE_HEADER_BODY;
+            cursor.count -= pushed;
+            cursor.ptr += pushed;
+            cursor.state = MESSAGE_HEADER_BODY;
         } else {
             break;
         }
@@ -599,15 +609,15 @@ QStatus _Message::DeliverNonBlocking(RemoteEndpoint& endpoint)
 
     case MESSAGE_HEADER_BODY:
         status = ER_OK;
-        while (status == ER_OK && countWrite > 0) {
-            status = sink.PushBytes(writePtr, countWrite, pushed);
+        while (status == ER_OK && cursor.count > 0) {
+            status = sink.PushBytes(cursor.ptr, cursor.count, pushed);
             if (status == ER_OK) {
-                countWrite -= pushed;
-                writePtr += pushed;
+                cursor.count -= pushed;
+                cursor.ptr += pushed;
             }
         }
-        if (countWrite == 0) {
-            writeState = MESSAGE_COMPLETE;
+        if (cursor.count == 0) {
+            cursor.state = MESSAGE_COMPLETE;
         }
         break;
 
@@ -618,6 +628,33 @@ QStatus _Message::DeliverNonBlocking(RemoteEndpoint& endpoint)
     }
     return status;
 }
+
+bool _Message::GetUnwrittenBytes(const MessageWriteCursor& cursor, const uint8_t*& buf, size_t& len) const
+{
+    switch (cursor.state) {
+    case MESSAGE_NEW:
+    case MESSAGE_HEADERFIELDS:
+        if (handles || encrypt || ttl) {
+            return false;
+        }
+        if (cursor.state == MESSAGE_NEW) {
+            buf = reinterpret_cast<const uint8_t*>(msgBuf);
+            len = bufEOD - buf;
+        } else {
+            buf = cursor.ptr;
+            len = cursor.count;
+        }
+        return (len > 0);
+
+    case MESSAGE_HEADER_BODY:
+        buf = cursor.ptr;
+        len = cursor.count;
+        return true;
+
+    default:
+        return false;
+    }
+}
 /*
  * Map from our enumeration type to the wire protocol values
  */
@@ -750,8 +787,9 @@ size_t _Message::ComputeHeaderLen()
 QStatus _Message::EncryptMessage()
 {
     KeyBlob key;
+    shared_ptr<Crypto_AES> cipher;
     PeerState peerState = bus->GetInternal().GetPeerStateTable()->GetPeerState(GetDestination());
-    QStatus status = peerState->GetKey(key, PEER_SESSION_KEY);
+    QStatus status = peerState->GetKey(key, PEER_SESSION_KEY, cipher);
 
     if (status == ER_OK) {
         /*
@@ -792,7 +830,7 @@ QStatus _Message::EncryptMessage()
         size_t hdrLen = ROUNDUP8(sizeof(msgHeader) + msgHeader.headerLen);
         size_t bodyLen = msgHeader.bodyLen;
 
-        status = ajn::Crypto::Encrypt(*this, key, (uint8_t*)msgBuf, hdrLen, bodyLen);
+        status = ajn::Crypto::Encrypt(*this, key, (uint8_t*)msgBuf, hdrLen, bodyLen, cipher.get());
         if (status == ER_OK) {
             QCC_DbgHLPrintf(("EncryptMessage: %s", Description().c_str()));
             /*
@@ -1101,7 +1139,8 @@ QStatus _Message::HelloMessage(bool isBusToBus, const qcc::String& sender, bool
                                 MESSAGE_METHOD_CALL,
                                 args,
                                 ArraySize(args),
-                                ALLJOYN_FLAG_AUTO_START | (allowRemote ? ALLJOYN_FLAG_ALLOW_REMOTE_MSG : 0),
+                                ALLJOYN_FLAG_AUTO_START | (allowRemote ? ALLJOYN_FLAG_ALLOW_REMOTE_MSG : 0) |
+                                HeaderDictionary::HEADER_COMPRESSED_FLAG,
                                 0);
     } else {
         /* Standard org.freedesktop.DBus.Hello */
@@ -1149,7 +1188,7 @@ QStatus _Message::HelloReply(bool isBusToBus, const qcc::String& sender, const q
         args[0].Set("s", uniqueName.c_str());
         args[1].Set("s", guid.c_str());
         args[2].Set("u", nameType << 30 | ALLJOYN_PROTOCOL_VERSION);
-        status = MarshalMessage("ssu", sender, uniqueName, MESSAGE_METHOD_RET, args, ArraySize(args), 0, 0);
+        status = MarshalMessage("ssu", sender, uniqueName, MESSAGE_METHOD_RET, args, ArraySize(args), HeaderDictionary::HEADER_COMPRESSED_FLAG, 0);
         QCC_DbgPrintf(("\n%s", ToString(args, 2).c_str()));
     } else {
         /* Destination and argument are both the unique name passed in. */
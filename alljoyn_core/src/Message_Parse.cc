@@ -24,6 +24,7 @@
 
 #include <algorithm>
 
+#include <qcc/atomic.h>
 #include <qcc/String.h>
 #include <qcc/StringUtil.h>
 #include <qcc/Socket.h>
@@ -31,6 +32,7 @@
 
 #include <alljoyn/BusAttachment.h>
 #include <alljoyn/Message.h>
+#include <alljoyn/MsgArgView.h>
 
 #include "Router.h"
 #include "KeyStore.h"
@@ -64,7 +66,8 @@ namespace ajn {
 
 
 QStatus _Message::ParseArray(MsgArg* arg,
-                             const char*& sigPtr)
+                             const char*& sigPtr,
+                             uint8_t*& pos) const
 {
     QStatus status;
     uint32_t len;
@@ -82,23 +85,23 @@ QStatus _Message::ParseArray(MsgArg* arg,
     /*
      * Length is aligned on a 4 byte boundary
      */
-    bufPos = AlignPtr(bufPos, 4);
+    pos = AlignPtr(pos, 4);
     if (endianSwap) {
-        len = EndianSwap32(*((uint32_t*)bufPos));
+        len = EndianSwap32(*((uint32_t*)pos));
     } else {
-        len = *((uint32_t*)bufPos);
+        len = *((uint32_t*)pos);
     }
     /*
      * Check array length is valid and in bounds.
      */
-    bufPos += 4;
-    if ((len > ALLJOYN_MAX_ARRAY_LEN) || ((len + bufPos) > bufEOD)) {
+    pos += 4;
+    if ((len > ALLJOYN_MAX_ARRAY_LEN) || ((len + pos) > bufEOD)) {
         status = ER_BUS_BAD_LENGTH;
-        QCC_LogError(status, ("Array length %ld at pos:%ld is too big", len, bufPos - bodyPtr - 4));
+        QCC_LogError(status, ("Array length %ld at pos:%ld is too big", len, pos - bodyPtr - 4));
         arg->typeId = ALLJOYN_INVALID;
         return status;
     }
-    QCC_DbgPrintf(("ParseArray len %ld at pos:%ld", len, bufPos - bodyPtr));
+    QCC_DbgPrintf(("ParseArray len %ld at pos:%ld", len, pos - bodyPtr));
     /*
      * Note: at this point alignment is on a 4 bytes boundary so we only need to align values that
      * need 8 byte alignment.
@@ -107,8 +110,8 @@ QStatus _Message::ParseArray(MsgArg* arg,
     case ALLJOYN_BYTE:
         arg->typeId = (AllJoynTypeId)((elemTypeId << 8) | ALLJOYN_ARRAY);
         arg->v_scalarArray.numElements = (size_t)len;
-        arg->v_scalarArray.v_byte = bufPos;
-        bufPos += len;
+        arg->v_scalarArray.v_byte = pos;
+        pos += len;
         break;
 
     case ALLJOYN_INT16:
@@ -119,16 +122,16 @@ QStatus _Message::ParseArray(MsgArg* arg,
             if (endianSwap) {
                 arg->v_scalarArray.v_uint16 = new uint16_t[arg->v_scalarArray.numElements];
                 uint16_t* p = (uint16_t*)arg->v_scalarArray.v_uint16;
-                uint16_t* n = (uint16_t*)bufPos;
+                uint16_t* n = (uint16_t*)pos;
                 for (size_t i = 0; i < arg->v_scalarArray.numElements; i++) {
                     *p++ = EndianSwap16(*n);
                     n++;
                 }
                 arg->flags = MsgArg::OwnsData;
             } else {
-                arg->v_scalarArray.v_uint16 = (uint16_t*)bufPos;
+                arg->v_scalarArray.v_uint16 = (uint16_t*)pos;
             }
-            bufPos += len;
+            pos += len;
         } else {
             status = ER_BUS_BAD_LENGTH;
         }
@@ -139,7 +142,7 @@ QStatus _Message::ParseArray(MsgArg* arg,
             size_t num = (size_t)(len / 4);
             bool* bools = new bool[num];
             for (size_t i = 0; i < num; i++) {
-                uint32_t b = *(uint32_t*)bufPos;
+                uint32_t b = *(uint32_t*)pos;
                 if (endianSwap) {
                     b = EndianSwap32(b);
                 }
@@ -149,7 +152,7 @@ QStatus _Message::ParseArray(MsgArg* arg,
                     break;
                 }
                 bools[i] = (b == 1);
-                bufPos += 4;
+                pos += 4;
             }
             /*
              * if status is set to ER_BUS_BAD_VALUE it means the for loop above
@@ -177,16 +180,16 @@ QStatus _Message::ParseArray(MsgArg* arg,
             if (endianSwap) {
                 arg->v_scalarArray.v_uint32 = new uint32_t[arg->v_scalarArray.numElements];
                 uint32_t* p = (uint32_t*)arg->v_scalarArray.v_uint32;
-                uint32_t* n = (uint32_t*)bufPos;
+                uint32_t* n = (uint32_t*)pos;
                 for (size_t i = 0; i < arg->v_scalarArray.numElements; i++) {
                     *p++ = EndianSwap32(*n);
                     n++;
                 }
                 arg->flags = MsgArg::OwnsData;
             } else {
-                arg->v_scalarArray.v_uint32 = (uint32_t*)bufPos;
+                arg->v_scalarArray.v_uint32 = (uint32_t*)pos;
             }
-            bufPos += len;
+            pos += len;
         } else {
             status = ER_BUS_BAD_LENGTH;
         }
@@ -198,21 +201,21 @@ QStatus _Message::ParseArray(MsgArg* arg,
         if ((len & 7) == 0) {
             arg->typeId = (AllJoynTypeId)((elemTypeId << 8) | ALLJOYN_ARRAY);
             arg->v_scalarArray.numElements = (size_t)(len / 8);
-            bufPos = AlignPtr(bufPos, 8);
-            arg->v_scalarArray.v_uint64 = (uint64_t*)bufPos;
+            pos = AlignPtr(pos, 8);
+            arg->v_scalarArray.v_uint64 = (uint64_t*)pos;
             if (endianSwap) {
                 arg->v_scalarArray.v_uint64 = new uint64_t[arg->v_scalarArray.numElements];
                 uint64_t* p = (uint64_t*)arg->v_scalarArray.v_uint64;
-                uint64_t* n = (uint64_t*)bufPos;
+                uint64_t* n = (uint64_t*)pos;
                 for (size_t i = 0; i < arg->v_scalarArray.numElements; i++) {
                     *p++ = EndianSwap64(*n);
                     n++;
                 }
                 arg->flags = MsgArg::OwnsData;
             } else {
-                arg->v_scalarArray.v_uint64 = (uint64_t*)bufPos;
+                arg->v_scalarArray.v_uint64 = (uint64_t*)pos;
             }
-            bufPos += len;
+            pos += len;
         } else {
             status = ER_BUS_BAD_LENGTH;
         }
@@ -224,7 +227,7 @@ QStatus _Message::ParseArray(MsgArg* arg,
          * The array length in bytes does not include the pad bytes between the length and the start
          * of the first element.
          */
-        bufPos = AlignPtr(bufPos, 8);
+        pos = AlignPtr(pos, 8);
 
     /* Falling through */
     default:
@@ -237,14 +240,14 @@ QStatus _Message::ParseArray(MsgArg* arg,
                  * We know how many bytes there are in the array but not how many elements until we
                  * unmarshal them.
                  */
-                uint8_t* endOfArray = bufPos + len;
+                uint8_t* endOfArray = pos + len;
                 size_t capacity = 8;
                 numElements = 0;
                 elements = new MsgArg[capacity];
                 /*
                  * Loop until we have consumed all of the data bytes
                  */
-                while (bufPos < endOfArray) {
+                while (pos < endOfArray) {
                     if (numElements == capacity) {
                         capacity *= 2;
                         MsgArg* bigger = new MsgArg[capacity];
@@ -258,7 +261,7 @@ QStatus _Message::ParseArray(MsgArg* arg,
                         elements = bigger;
                     }
                     const char* esig = elemSig.c_str();
-                    status = ParseValue(&elements[numElements++], esig, true);
+                    status = ParseValue(&elements[numElements++], esig, pos, true);
                     if (status != ER_OK) {
                         break;
                     }
@@ -283,7 +286,7 @@ QStatus _Message::ParseArray(MsgArg* arg,
 /*
  * Parse a STRUCT
  */
-QStatus _Message::ParseStruct(MsgArg* arg, const char*& sigPtr)
+QStatus _Message::ParseStruct(MsgArg* arg, const char*& sigPtr, uint8_t*& pos) const
 {
     const char* memberSig = sigPtr;
     /*
@@ -298,14 +301,14 @@ QStatus _Message::ParseStruct(MsgArg* arg, const char*& sigPtr)
     /*
      * Structs are aligned on an 8 byte boundary
      */
-    bufPos = AlignPtr(bufPos, 8);
+    pos = AlignPtr(pos, 8);
 
-    QCC_DbgPrintf(("ParseStruct at pos:%d", bufPos - bodyPtr));
+    QCC_DbgPrintf(("ParseStruct at pos:%d", pos - bodyPtr));
 
     arg->v_struct.members = new MsgArg[arg->v_struct.numMembers];
     arg->flags |= MsgArg::OwnsArgs;
     for (uint32_t i = 0; i < arg->v_struct.numMembers; ++i) {
-        status = ParseValue(&arg->v_struct.members[i], memberSig);
+        status = ParseValue(&arg->v_struct.members[i], memberSig, pos);
         if (status != ER_OK) {
             arg->v_struct.numMembers = i;
             break;
@@ -319,7 +322,8 @@ QStatus _Message::ParseStruct(MsgArg* arg, const char*& sigPtr)
  * Parse a DICT ENTRY
  */
 QStatus _Message::ParseDictEntry(MsgArg* arg,
-                                 const char*& sigPtr)
+                                 const char*& sigPtr,
+                                 uint8_t*& pos) const
 {
     const char* memberSig = sigPtr;
     /*
@@ -333,42 +337,42 @@ QStatus _Message::ParseDictEntry(MsgArg* arg,
         /*
          * Dict entries are aligned on an 8 byte boundary
          */
-        bufPos = AlignPtr(bufPos, 8);
+        pos = AlignPtr(pos, 8);
 
-        QCC_DbgPrintf(("ParseDictEntry at pos:%d", bufPos - bodyPtr));
+        QCC_DbgPrintf(("ParseDictEntry at pos:%d", pos - bodyPtr));
 
         arg->v_dictEntry.key = new MsgArg();
         arg->v_dictEntry.val = new MsgArg();
         arg->flags |= MsgArg::OwnsArgs;
-        status = ParseValue(arg->v_dictEntry.key, memberSig);
+        status = ParseValue(arg->v_dictEntry.key, memberSig, pos);
         if (status == ER_OK) {
-            status = ParseValue(arg->v_dictEntry.val, memberSig);
+            status = ParseValue(arg->v_dictEntry.val, memberSig, pos);
         }
     }
     return status;
 }
 
 
-QStatus _Message::ParseVariant(MsgArg* arg)
+QStatus _Message::ParseVariant(MsgArg* arg, uint8_t*& pos) const
 {
     QStatus status;
 
     arg->typeId = ALLJOYN_VARIANT;
     arg->v_variant.val = NULL;
 
-    size_t len = (size_t)(*((uint8_t*)bufPos));
-    const char* sigPtr = (char*)(++bufPos);
+    size_t len = (size_t)(*((uint8_t*)pos));
+    const char* sigPtr = (char*)(++pos);
 
-    bufPos += len;
+    pos += len;
 
-    if (bufPos >= bufEOD) {
+    if (pos >= bufEOD) {
         status = ER_BUS_BAD_LENGTH;
-    } else if (*bufPos++ != 0) {
+    } else if (*pos++ != 0) {
         status = ER_BUS_BAD_SIGNATURE;
     } else {
         arg->v_variant.val = new MsgArg();
         arg->flags |= MsgArg::OwnsArgs;
-        status = ParseValue(arg->v_variant.val, sigPtr);
+        status = ParseValue(arg->v_variant.val, sigPtr, pos);
         if ((status == ER_OK) && (*sigPtr != 0)) {
             status = ER_BUS_BAD_SIGNATURE;
         }
@@ -381,15 +385,15 @@ QStatus _Message::ParseVariant(MsgArg* arg)
 }
 
 
-QStatus _Message::ParseSignature(MsgArg* arg)
+QStatus _Message::ParseSignature(MsgArg* arg, uint8_t*& pos) const
 {
     QStatus status = ER_OK;
-    arg->v_signature.len = (size_t)(*((uint8_t*)bufPos));
-    arg->v_signature.sig = (char*)(++bufPos);
-    bufPos += arg->v_signature.len;
-    if (bufPos >= bufEOD) {
+    arg->v_signature.len = (size_t)(*((uint8_t*)pos));
+    arg->v_signature.sig = (char*)(++pos);
+    pos += arg->v_signature.len;
+    if (pos >= bufEOD) {
         status = ER_BUS_BAD_LENGTH;
-    } else if (*bufPos++ != 0) {
+    } else if (*pos++ != 0) {
         status = ER_BUS_NOT_NUL_TERMINATED;
     } else {
         arg->typeId = ALLJOYN_SIGNATURE;
@@ -398,33 +402,33 @@ QStatus _Message::ParseSignature(MsgArg* arg)
 }
 
 
-QStatus _Message::ParseValue(MsgArg* arg, const char*& sigPtr, bool arrayElem)
+QStatus _Message::ParseValue(MsgArg* arg, const char*& sigPtr, uint8_t*& pos, bool arrayElem) const
 {
     QStatus status = ER_OK;
 
     arg->Clear();
     switch (AllJoynTypeId typeId = (AllJoynTypeId)(*sigPtr++)) {
     case ALLJOYN_BYTE:
-        arg->v_byte = *bufPos++;
+        arg->v_byte = *pos++;
         arg->typeId = typeId;
         break;
 
     case ALLJOYN_INT16:
     case ALLJOYN_UINT16:
-        bufPos = AlignPtr(bufPos, 2);
+        pos = AlignPtr(pos, 2);
         if (endianSwap) {
-            arg->v_uint16 = EndianSwap16(*((uint16_t*)bufPos));
+            arg->v_uint16 = EndianSwap16(*((uint16_t*)pos));
         } else {
-            arg->v_uint16 = *((uint16_t*)bufPos);
+            arg->v_uint16 = *((uint16_t*)pos);
         }
-        bufPos += 2;
+        pos += 2;
         arg->typeId = typeId;
         break;
 
     case ALLJOYN_BOOLEAN:
         {
-            bufPos = AlignPtr(bufPos, 4);
-            uint32_t v = *((uint32_t*)bufPos);
+            pos = AlignPtr(pos, 4);
+            uint32_t v = *((uint32_t*)pos);
             if (endianSwap) {
                 v = EndianSwap32(v);
             }
@@ -432,7 +436,7 @@ QStatus _Message::ParseValue(MsgArg* arg, const char*& sigPtr, bool arrayElem)
                 status = ER_BUS_BAD_VALUE;
             } else {
                 arg->v_bool = (v == 1);
-                bufPos += 4;
+                pos += 4;
                 arg->typeId = typeId;
             }
         }
@@ -440,48 +444,48 @@ QStatus _Message::ParseValue(MsgArg* arg, const char*& sigPtr, bool arrayElem)
 
     case ALLJOYN_INT32:
     case ALLJOYN_UINT32:
-        bufPos = AlignPtr(bufPos, 4);
+        pos = AlignPtr(pos, 4);
         if (endianSwap) {
-            arg->v_uint32 = EndianSwap32(*((uint32_t*)bufPos));
+            arg->v_uint32 = EndianSwap32(*((uint32_t*)pos));
         } else {
-            arg->v_uint32 = *((uint32_t*)bufPos);
+            arg->v_uint32 = *((uint32_t*)pos);
         }
-        bufPos += 4;
+        pos += 4;
         arg->typeId = typeId;
         break;
 
     case ALLJOYN_DOUBLE:
     case ALLJOYN_UINT64:
     case ALLJOYN_INT64:
-        bufPos = AlignPtr(bufPos, 8);
+        pos = AlignPtr(pos, 8);
         if (endianSwap) {
-            arg->v_uint64 = EndianSwap64(*((uint64_t*)bufPos));
+            arg->v_uint64 = EndianSwap64(*((uint64_t*)pos));
         } else {
-            arg->v_uint64 = *((uint64_t*)bufPos);
+            arg->v_uint64 = *((uint64_t*)pos);
         }
-        bufPos += 8;
+        pos += 8;
         arg->typeId = typeId;
         break;
 
     case ALLJOYN_OBJECT_PATH:
     case ALLJOYN_STRING:
-        bufPos = AlignPtr(bufPos, 4);
+        pos = AlignPtr(pos, 4);
         if (endianSwap) {
-            arg->v_string.len = (size_t)EndianSwap32(*((uint32_t*)bufPos));
+            arg->v_string.len = (size_t)EndianSwap32(*((uint32_t*)pos));
         } else {
-            arg->v_string.len = (size_t)(*((uint32_t*)bufPos));
+            arg->v_string.len = (size_t)(*((uint32_t*)pos));
         }
         if (arg->v_string.len > ALLJOYN_MAX_PACKET_LEN) {
-            QCC_LogError(status, ("String length %ld at pos:%ld is too big", arg->v_string.len, bufPos - bodyPtr));
+            QCC_LogError(status, ("String length %ld at pos:%ld is too big", arg->v_string.len, pos - bodyPtr));
             status = ER_BUS_BAD_LENGTH;
             break;
         }
-        bufPos += 4;
-        arg->v_string.str = (char*)bufPos;
-        bufPos += arg->v_string.len;
-        if (bufPos >= bufEOD) {
+        pos += 4;
+        arg->v_string.str = (char*)pos;
+        pos += arg->v_string.len;
+        if (pos >= bufEOD) {
             status = ER_BUS_BAD_LENGTH;
-        } else if (*bufPos++ != 0) {
+        } else if (*pos++ != 0) {
             status = ER_BUS_NOT_NUL_TERMINATED;
         } else {
             arg->typeId = typeId;
@@ -489,16 +493,16 @@ QStatus _Message::ParseValue(MsgArg* arg, const char*& sigPtr, bool arrayElem)
         break;
 
     case ALLJOYN_SIGNATURE:
-        status = ParseSignature(arg);
+        status = ParseSignature(arg, pos);
         break;
 
     case ALLJOYN_ARRAY:
-        status = ParseArray(arg, sigPtr);
+        status = ParseArray(arg, sigPtr, pos);
         break;
 
     case ALLJOYN_DICT_ENTRY_OPEN:
         if (arrayElem) {
-            status = ParseDictEntry(arg, sigPtr);
+            status = ParseDictEntry(arg, sigPtr, pos);
         } else {
             status = ER_BUS_BAD_SIGNATURE;
             QCC_LogError(status, ("Message arg parse error naked dicitionary element"));
@@ -506,17 +510,17 @@ QStatus _Message::ParseValue(MsgArg* arg, const char*& sigPtr, bool arrayElem)
         break;
 
     case ALLJOYN_STRUCT_OPEN:
-        status = ParseStruct(arg, sigPtr);
+        status = ParseStruct(arg, sigPtr, pos);
         break;
 
     case ALLJOYN_VARIANT:
-        status = ParseVariant(arg);
+        status = ParseVariant(arg, pos);
         break;
 
     case ALLJOYN_HANDLE:
         {
-            bufPos = AlignPtr(bufPos, 4);
-            uint32_t index = *((uint32_t*)bufPos);
+            pos = AlignPtr(pos, 4);
+            uint32_t index = *((uint32_t*)pos);
             if (endianSwap) {
                 index = EndianSwap32(index);
             }
@@ -526,7 +530,7 @@ QStatus _Message::ParseValue(MsgArg* arg, const char*& sigPtr, bool arrayElem)
             } else {
                 arg->typeId = typeId;
                 arg->v_handle.fd = handles[index];
-                bufPos += 4;
+                pos += 4;
             }
         }
         break;
@@ -538,11 +542,11 @@ QStatus _Message::ParseValue(MsgArg* arg, const char*& sigPtr, bool arrayElem)
     /*
      * Check we are not running of the end of the buffer
      */
-    if ((status == ER_OK) && (bufPos > bufEOD)) {
+    if ((status == ER_OK) && (pos > bufEOD)) {
         status = ER_BUS_BAD_SIGNATURE;
     }
     if (status != ER_OK) {
-        QCC_LogError(status, ("Message arg parse error at or near %ld", bufPos - bodyPtr));
+        QCC_LogError(status, ("Message arg parse error at or near %ld", pos - bodyPtr));
     } else {
         QCC_DbgPrintf(("Parse%s%s", SignatureUtils::IsBasicType(arg->typeId) ? " " : ":\n", arg->ToString().c_str()));
     }
@@ -554,16 +558,65 @@ QStatus _Message::ParseValue(MsgArg* arg, const char*& sigPtr, bool arrayElem)
  */
 static const char* WildCardSignature = "*";
 
-QStatus _Message::UnmarshalArgs(const qcc::String& expectedSignature, const char* expectedReplySignature)
+/*
+ * Number of handles that can be referenced by the message body.
+ */
+static size_t BodyHandles(const HeaderFields& hdrFields, size_t numHandles)
+{
+    const MsgArg& field = hdrFields.field[ALLJOYN_HDR_FIELD_HANDLES];
+    return (field.typeId == ALLJOYN_INVALID) ? 0 : std::min(numHandles, (size_t)field.v_uint32);
+}
+
+const MsgArg* _Message::ParseDeferredArgs() const
+{
+    QStatus status = ER_OK;
+    const char* sig = GetSignature();
+    MsgArg* args = new MsgArg[numMsgArgs];
+    uint8_t* pos = bodyPtr;
+
+    /*
+     * UnmarshalArgs has already checked the body so this is not expected to fail.
+     */
+    QCC_ASSERT(!argsEndianSwap);
+    for (uint8_t i = 0; (status == ER_OK) && (i < numMsgArgs); i++) {
+        status = ParseValue(&args[i], sig, pos);
+    }
+    if (status != ER_OK) {
+        QCC_LogError(status, ("Failed to parse deferred message arguments"));
+        delete [] args;
+    } else if (!CompareAndExchangePointer(reinterpret_cast<void* volatile*>(const_cast<MsgArg**>(&msgArgs)), NULL, args)) {
+        /*
+         * Another thread got there first
+         */
+        delete [] args;
+    }
+    return msgArgs;
+}
+
+QStatus _Message::GetArgView(MsgArgView& view) const
+{
+    if ((msgArgs == NULL) && !argsDeferred) {
+        return ER_FAIL;
+    }
+    view = MsgArgView(GetSignature(), bodyPtr, msgHeader.bodyLen, argsEndianSwap, handles, BodyHandles(hdrFields, numHandles));
+    /*
+     * UnmarshalArgs has already checked the signature and the body.
+     */
+    view.sigChecked = true;
+    return ER_OK;
+}
+
+QStatus _Message::UnmarshalArgs(const qcc::String& expectedSignature, const char* expectedReplySignature, bool deferArgs)
 {
     if (!bus->IsStarted()) {
         return ER_BUS_BUS_NOT_STARTED;
     }
-    return UnmarshalArgs(bus->GetInternal().GetPeerStateTable(), expectedSignature, expectedReplySignature);
+    return UnmarshalArgs(bus->GetInternal().GetPeerStateTable(), expectedSignature, expectedReplySignature, deferArgs);
 }
 
 QStatus _Message::UnmarshalArgs(PeerStateTable* peerStateTable,
-                                const qcc::String& expectedSignature, const char* expectedReplySignature)
+                                const qcc::String& expectedSignature, const char* expectedReplySignature,
+                                bool deferArgs)
 {
     const char* sig = GetSignature();
     QStatus status = ER_OK;
@@ -571,7 +624,7 @@ QStatus _Message::UnmarshalArgs(PeerStateTable* peerStateTable,
     MsgArg* _msgArgs = NULL;
 
     /* Check if message body is already unmarshaled */
-    if (msgArgs != NULL) {
+    if ((msgArgs != NULL) || argsDeferred) {
         return ER_OK;
     }
 
@@ -598,11 +651,12 @@ QStatus _Message::UnmarshalArgs(PeerStateTable* peerStateTable,
         size_t hdrLen = bodyPtr - (uint8_t*)msgBuf;
         PeerState peerState = peerStateTable->GetPeerState(GetSender());
         KeyBlob key;
+        shared_ptr<Crypto_AES> cipher;
         /* A broadcast message is encrypted but not authenticated since any
          * peer that connects with the sender has access to the same group key
          */
         authenticated = !broadcast;
-        status = peerState->GetKey(key, broadcast ? PEER_GROUP_KEY : PEER_SESSION_KEY);
+        status = peerState->GetKey(key, broadcast ? PEER_GROUP_KEY : PEER_SESSION_KEY, cipher);
         if (status != ER_OK) {
             QCC_LogError(status, ("Unable to decrypt (broadcast %d) message from sender %s", broadcast, GetSender()));
             /*
@@ -652,7 +706,7 @@ QStatus _Message::UnmarshalArgs(PeerStateTable* peerStateTable,
          * algorithm appends data to the end of the encrypted data.
          */
         size_t bodyLen = msgHeader.bodyLen;
-        status = ajn::Crypto::Decrypt(*this, key, (uint8_t*)msgBuf, hdrLen, bodyLen);
+        status = ajn::Crypto::Decrypt(*this, key, (uint8_t*)msgBuf, hdrLen, bodyLen, cipher.get());
         if (status != ER_OK) {
             goto ExitUnmarshalArgs;
         }
@@ -663,22 +717,46 @@ QStatus _Message::UnmarshalArgs(PeerStateTable* peerStateTable,
      * Calculate how many arguments there are
      */
     _numMsgArgs = SignatureUtils::CountCompleteTypes(sig);
-    _msgArgs = new MsgArg[_numMsgArgs];
 
     /*
-     * Unmarshal the body values
+     * A byte-swapped body is always parsed, the MsgArgs cannot refer to it in place.
      */
-    bufPos = bodyPtr;
-    for (uint8_t i = 0; i < _numMsgArgs; i++) {
-        status = ParseValue(&_msgArgs[i], sig);
-        if (status != ER_OK) {
-            _numMsgArgs = i;
-            goto ExitUnmarshalArgs;
+    deferArgs = deferArgs && (_numMsgArgs > 0) && !endianSwap;
+    if (deferArgs) {
+        /*
+         * Check the body values in place. The MsgArgs are only built if the arguments are
+         * accessed with GetArgs() rather than with a MsgArgView.
+         */
+        MsgArgView view(sig, bodyPtr, msgHeader.bodyLen, false, handles, BodyHandles(hdrFields, numHandles));
+        for (uint8_t i = 0; i < _numMsgArgs; i++) {
+            status = view.Next();
+            if (status != ER_OK) {
+                QCC_LogError(status, ("Message arg parse error at or near %ld", view.pos - bodyPtr));
+                goto ExitUnmarshalArgs;
+            }
+        }
+        if ((view.pos - bodyPtr) != static_cast<ptrdiff_t>(msgHeader.bodyLen)) {
+            QCC_DbgHLPrintf(("UnmarshalArgs expected argLen %d got %d", msgHeader.bodyLen, (view.pos - bodyPtr)));
+            status = ER_BUS_BAD_SIGNATURE;
+        }
+    } else {
+        _msgArgs = new MsgArg[_numMsgArgs];
+
+        /*
+         * Unmarshal the body values
+         */
+        bufPos = bodyPtr;
+        for (uint8_t i = 0; i < _numMsgArgs; i++) {
+            status = ParseValue(&_msgArgs[i], sig, bufPos);
+            if (status != ER_OK) {
+                _numMsgArgs = i;
+                goto ExitUnmarshalArgs;
+            }
+        }
+        if ((bufPos - bodyPtr) != static_cast<ptrdiff_t>(msgHeader.bodyLen)) {
+            QCC_DbgHLPrintf(("UnmarshalArgs expected argLen %d got %d", msgHeader.bodyLen, (bufPos - bodyPtr)));
+            status = ER_BUS_BAD_SIGNATURE;
         }
-    }
-    if ((bufPos - bodyPtr) != static_cast<ptrdiff_t>(msgHeader.bodyLen)) {
-        QCC_DbgHLPrintf(("UnmarshalArgs expected argLen %d got %d", msgHeader.bodyLen, (bufPos - bodyPtr)));
-        status = ER_BUS_BAD_SIGNATURE;
     }
 
 ExitUnmarshalArgs:
@@ -687,8 +765,9 @@ ExitUnmarshalArgs:
         QCC_DbgPrintf(("Unmarshaled\n%s", ToString().c_str()));
         /*
          * If the message arguments are ever unmarshalled we convert the entire message to the native
-         * endianess.
+         * endianess. The body itself is left as it is so views of the body need to know.
          */
+        argsEndianSwap = endianSwap;
         if (endianSwap) {
             QCC_DbgPrintf(("UnmarshalArgs converting to native endianess"));
             endianSwap = false;
@@ -707,6 +786,7 @@ ExitUnmarshalArgs:
          */
         msgArgs = _msgArgs;
         numMsgArgs = _numMsgArgs;
+        argsDeferred = deferArgs;
         if (!permissionCheckMet) {
             /* the permission check was delayed for property so it must be
                 performed now */
@@ -889,8 +969,17 @@ QStatus _Message::HeaderChecks(bool pedantic)
 
 }
 
+/*
+ * Usable size of a buffer from AllocAdoptableBuffer() for a message of buflen
+ * bytes.  This is what InterpretHeader() computes as bufSize for that message.
+ */
+static inline size_t AdoptableBufferSize(size_t hdrLen, size_t buflen)
+{
+    return hdrLen + ((buflen - hdrLen + 7) & ~7) + sizeof(uint64_t);
+}
+
 /* Check the first 16 bytes of the header */
-QStatus _Message::InterpretHeader()
+QStatus _Message::InterpretHeader(uint8_t* adopted, size_t adoptedSize)
 {
     readState = MESSAGE_HEADER_BODY;
     /*
@@ -940,7 +1029,15 @@ QStatus _Message::InterpretHeader()
      */
     bufSize = sizeof(msgHeader) + ((pktSize + 7) & ~7) + sizeof(uint64_t);
     QCC_ASSERT(_msgBuf == nullptr);
-    _msgBuf = new uint8_t[bufSize + 7];
+    if (adopted) {
+        if (bufSize > adoptedSize) {
+            QCC_LogError(ER_BUS_BAD_BODY_LEN, ("Message body length %d is invalid", msgHeader.bodyLen));
+            return ER_BUS_BAD_BODY_LEN;
+        }
+        _msgBuf = adopted;
+    } else {
+        _msgBuf = new uint8_t[bufSize + 7];
+    }
     msgBuf = (uint64_t*)((uintptr_t)(_msgBuf + 7) & ~7); /* Align to 8 byte boundary */
     /*
      * Copy header into the buffer
@@ -967,14 +1064,13 @@ QStatus _Message::InterpretHeader()
 
 }
 
-QStatus _Message::PullBytes(RemoteEndpoint& endpoint, bool checkSender, bool pedantic, uint32_t timeout)
+QStatus _Message::PullBytes(RemoteEndpoint& endpoint, Source& source, bool checkSender, bool pedantic, uint32_t timeout)
 {
     QCC_UNUSED(checkSender);
     QCC_UNUSED(pedantic);
 
     QStatus status;
     qcc::SocketFd fdList[qcc::SOCKET_MAX_FILE_DESCRIPTORS];
-    Source& source = endpoint->GetSource();
     size_t toRead;
     size_t read = 0;
 
@@ -1093,11 +1189,57 @@ QStatus _Message::LoadBytes(uint8_t* buf, size_t buflen)
     return ER_OK;
 }
 
+uint8_t* _Message::AllocAdoptableBuffer(size_t buflen, uint8_t*& data)
+{
+    uint8_t* buf = new uint8_t[AdoptableBufferSize(sizeof(MessageHeader), max(buflen, sizeof(MessageHeader))) + 7];
+    data = (uint8_t*)((uintptr_t)(buf + 7) & ~7); /* Align to 8 byte boundary, as InterpretHeader() does */
+    return buf;
+}
+
+QStatus _Message::AdoptBytes(uint8_t* buf, size_t buflen)
+{
+    QStatus status;
+
+    if (sizeof(msgHeader) > buflen) {
+        delete [] buf;
+        QCC_LogError(ER_BUS_BAD_BODY_LEN, ("Message buffer length %d is invalid", buflen));
+        return ER_BUS_BAD_BODY_LEN;
+    }
+    /*
+     * Copy in the message header.  The rest of the message is already where
+     * InterpretHeader() puts it once it adopts the buffer.
+     */
+    uint8_t* data = (uint8_t*)((uintptr_t)(buf + 7) & ~7);
+    memcpy(&msgHeader, data, sizeof(msgHeader));
+
+    status = InterpretHeader(buf, AdoptableBufferSize(sizeof(msgHeader), buflen));
+    if (status != ER_OK) {
+        if (_msgBuf != buf) {
+            delete [] buf;
+        }
+        QCC_LogError(status, ("_Message::AdoptBytes(): InterpretHeader() failed"));
+        return status;
+    }
+
+    if (bufSize < buflen) {
+        QCC_LogError(ER_BUS_BAD_BODY_LEN, ("Message buffer length %d is invalid", buflen));
+        return ER_BUS_BAD_BODY_LEN;
+    }
+
+    /*
+     * Mark the message as completely read in and point the buffer back to the start
+     */
+    readState = MESSAGE_COMPLETE;
+    bufPos = (uint8_t*)msgBuf + sizeof(msgHeader);
+    return ER_OK;
+}
+
 QStatus _Message::ReadNonBlocking(RemoteEndpoint& endpoint, bool checkSender, bool pedantic)
 {
     QStatus status = ER_OK;
+    Source& source = endpoint->GetRxSource();
     while ((status == ER_OK) && (readState != MESSAGE_COMPLETE)) {
-        status = PullBytes(endpoint, checkSender, pedantic, 0); /* timeout zero */
+        status = PullBytes(endpoint, source, checkSender, pedantic, 0); /* timeout zero */
     }
     if (status == ER_OK) {
         status = ((readState == MESSAGE_COMPLETE) ? ER_OK : ER_TIMEOUT);
@@ -1126,8 +1268,9 @@ QStatus _Message::Read(RemoteEndpoint& endpoint, bool checkSender, bool pedantic
     /* Keep pulling bytes until the message is incomplete and
      * no error has occured.
      */
+    Source& source = endpoint->GetSource();
     while (readState != MESSAGE_COMPLETE && status == ER_OK) {
-        status = PullBytes(endpoint, checkSender, pedantic, PULL_TIMEOUT(countRead));
+        status = PullBytes(endpoint, source, checkSender, pedantic, PULL_TIMEOUT(countRead));
     }
     if (status != ER_OK && (status != ER_SOCK_OTHER_END_CLOSED) && (status != ER_STOPPING_THREAD)) {
         QCC_LogError(status, ("Failed to read message on %s", endpoint->GetUniqueName().c_str()));
@@ -1193,7 +1336,7 @@ QStatus _Message::Unmarshal(PeerStateTable* peerStateTable, qcc::String& endpoin
             /*
              * Unknown fields are parsed but otherwise ignored
              */
-            status = ParseValue(&unknownHdr, sigPtr);
+            status = ParseValue(&unknownHdr, sigPtr, bufPos);
         } else {
             /*
              * Currently all header fields have a single character type code
@@ -1201,7 +1344,7 @@ QStatus _Message::Unmarshal(PeerStateTable* peerStateTable, qcc::String& endpoin
             if ((sigLen != 1) || (sigPtr[0] != HeaderFields::FieldType[fieldId]) || (sigPtr[1] != 0)) {
                 status = ER_BUS_BAD_HEADER_FIELD;
             } else {
-                status = ParseValue(&hdrFields.field[fieldId], sigPtr);
+                status = ParseValue(&hdrFields.field[fieldId], sigPtr, bufPos);
             }
         }
         if (*sigPtr != 0) {
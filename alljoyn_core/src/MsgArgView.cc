@@ -0,0 +1,724 @@
+/**
+ * @file
+ *
+ * This file implements the MsgArgView class
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <string.h>
+
+#include <qcc/Util.h>
+
+#include <alljoyn/Message.h>
+#include <alljoyn/MsgArgView.h>
+
+#include "SignatureUtils.h"
+
+#define QCC_MODULE "ALLJOYN"
+
+using namespace qcc;
+
+namespace ajn {
+
+static inline uint32_t Read32(const uint8_t* p, bool swap)
+{
+    uint32_t v = *reinterpret_cast<const uint32_t*>(p);
+    return swap ? EndianSwap32(v) : v;
+}
+
+static inline uint64_t Read64(const uint8_t* p, bool swap)
+{
+    uint64_t v = *reinterpret_cast<const uint64_t*>(p);
+    return swap ? EndianSwap64(v) : v;
+}
+
+/*
+ * Returns the end of a complete type in a signature that is known to be valid.
+ */
+static const char* EndOfType(const char* sigPtr)
+{
+    while (*sigPtr == ALLJOYN_ARRAY) {
+        ++sigPtr;
+    }
+    if ((*sigPtr == ALLJOYN_STRUCT_OPEN) || (*sigPtr == ALLJOYN_DICT_ENTRY_OPEN)) {
+        size_t depth = 0;
+        do {
+            if ((*sigPtr == ALLJOYN_STRUCT_OPEN) || (*sigPtr == ALLJOYN_DICT_ENTRY_OPEN)) {
+                ++depth;
+            } else if ((*sigPtr == ALLJOYN_STRUCT_CLOSE) || (*sigPtr == ALLJOYN_DICT_ENTRY_CLOSE)) {
+                --depth;
+            }
+            ++sigPtr;
+        } while (depth && *sigPtr);
+        return sigPtr;
+    }
+    return *sigPtr ? sigPtr + 1 : sigPtr;
+}
+
+MsgArgView::MsgArgView() :
+    sig(""),
+    base(NULL),
+    pos(NULL),
+    end(NULL),
+    handles(NULL),
+    numHandles(0),
+    endianSwap(false),
+    inArray(false),
+    sigChecked(true)
+{
+}
+
+MsgArgView::MsgArgView(const char* signature, const void* body, size_t bodyLen, bool endianSwap,
+                       const qcc::SocketFd* handles, size_t numHandles) :
+    sig(signature ? signature : ""),
+    base(static_cast<const uint8_t*>(body)),
+    pos(base),
+    end(base + bodyLen),
+    handles(handles),
+    numHandles(handles ? numHandles : 0),
+    endianSwap(endianSwap),
+    inArray(false),
+    sigChecked(false)
+{
+}
+
+bool MsgArgView::AtEnd() const
+{
+    if (inArray) {
+        return pos >= end;
+    } else {
+        return (*sig == 0) || (*sig == ALLJOYN_STRUCT_CLOSE) || (*sig == ALLJOYN_DICT_ENTRY_CLOSE);
+    }
+}
+
+AllJoynTypeId MsgArgView::GetTypeId() const
+{
+    if (AtEnd()) {
+        return ALLJOYN_INVALID;
+    }
+    switch (*sig) {
+    case ALLJOYN_STRUCT_OPEN:
+        return ALLJOYN_STRUCT;
+
+    case ALLJOYN_DICT_ENTRY_OPEN:
+        return ALLJOYN_DICT_ENTRY;
+
+    case ALLJOYN_ARRAY:
+        switch (sig[1]) {
+        case ALLJOYN_BOOLEAN:
+        case ALLJOYN_BYTE:
+        case ALLJOYN_DOUBLE:
+        case ALLJOYN_INT16:
+        case ALLJOYN_INT32:
+        case ALLJOYN_INT64:
+        case ALLJOYN_UINT16:
+        case ALLJOYN_UINT32:
+        case ALLJOYN_UINT64:
+            return (AllJoynTypeId)((sig[1] << 8) | ALLJOYN_ARRAY);
+
+        default:
+            return ALLJOYN_ARRAY;
+        }
+
+    default:
+        return (AllJoynTypeId)*sig;
+    }
+}
+
+/*
+ * This performs the same checks as _Message::ParseValue() so a body that can be visited by a view
+ * can also be unmarshaled into MsgArgs.
+ */
+QStatus MsgArgView::Skip(const char*& sigPtr, const uint8_t*& p, const uint8_t* limit, bool arrayElem, bool sigChecked) const
+{
+    QStatus status = ER_OK;
+    const char* s = sigPtr;
+    const uint8_t* q = p;
+
+    switch (*s++) {
+    case ALLJOYN_BYTE:
+        q += 1;
+        break;
+
+    case ALLJOYN_INT16:
+    case ALLJOYN_UINT16:
+        q = Align(q, 2) + 2;
+        break;
+
+    case ALLJOYN_BOOLEAN:
+        q = Align(q, 4);
+        if ((q + 4) > limit) {
+            status = ER_BUS_BAD_SIGNATURE;
+        } else if (Read32(q, endianSwap) > 1) {
+            status = ER_BUS_BAD_VALUE;
+        } else {
+            q += 4;
+        }
+        break;
+
+    case ALLJOYN_INT32:
+    case ALLJOYN_UINT32:
+        q = Align(q, 4) + 4;
+        break;
+
+    case ALLJOYN_DOUBLE:
+    case ALLJOYN_UINT64:
+    case ALLJOYN_INT64:
+        q = Align(q, 8) + 8;
+        break;
+
+    case ALLJOYN_OBJECT_PATH:
+    case ALLJOYN_STRING:
+        q = Align(q, 4);
+        if ((q + 4) > limit) {
+            status = ER_BUS_BAD_SIGNATURE;
+        } else {
+            size_t len = Read32(q, endianSwap);
+            q += 4;
+            if (len > ALLJOYN_MAX_PACKET_LEN) {
+                status = ER_BUS_BAD_LENGTH;
+            } else if (len >= (size_t)(limit - q)) {
+                status = ER_BUS_BAD_LENGTH;
+            } else if (q[len] != 0) {
+                status = ER_BUS_NOT_NUL_TERMINATED;
+            } else {
+                q += len + 1;
+            }
+        }
+        break;
+
+    case ALLJOYN_SIGNATURE:
+    case ALLJOYN_VARIANT:
+        if (q >= limit) {
+            status = ER_BUS_BAD_LENGTH;
+        } else {
+            size_t len = *q++;
+            const char* valueSig = reinterpret_cast<const char*>(q);
+            if (len >= (size_t)(limit - q)) {
+                status = ER_BUS_BAD_LENGTH;
+            } else if (q[len] != 0) {
+                status = (s[-1] == ALLJOYN_VARIANT) ? ER_BUS_BAD_SIGNATURE : ER_BUS_NOT_NUL_TERMINATED;
+            } else {
+                q += len + 1;
+                if (s[-1] == ALLJOYN_VARIANT) {
+                    status = Skip(valueSig, q, limit, false, false);
+                    if ((status == ER_OK) && (*valueSig != 0)) {
+                        status = ER_BUS_BAD_SIGNATURE;
+                    }
+                }
+            }
+        }
+        break;
+
+    case ALLJOYN_ARRAY:
+        {
+            const char* elemSig = s;
+            if (sigChecked) {
+                s = EndOfType(elemSig);
+            } else {
+                s = elemSig - 1;
+                status = SignatureUtils::ParseCompleteType(s);
+                if (status != ER_OK) {
+                    break;
+                }
+            }
+            q = Align(q, 4);
+            if ((q + 4) > limit) {
+                status = ER_BUS_BAD_LENGTH;
+                break;
+            }
+            size_t len = Read32(q, endianSwap);
+            q += 4;
+            if ((len > ALLJOYN_MAX_ARRAY_LEN) || (len > (size_t)(limit - q))) {
+                status = ER_BUS_BAD_LENGTH;
+                break;
+            }
+            switch (*elemSig) {
+            case ALLJOYN_BYTE:
+                q += len;
+                break;
+
+            case ALLJOYN_INT16:
+            case ALLJOYN_UINT16:
+                if (len & 1) {
+                    status = ER_BUS_BAD_LENGTH;
+                } else {
+                    q += len;
+                }
+                break;
+
+            case ALLJOYN_BOOLEAN:
+                if (len & 3) {
+                    status = ER_BUS_BAD_LENGTH;
+                } else {
+                    for (const uint8_t* arrayEnd = q + len; q < arrayEnd; q += 4) {
+                        if (Read32(q, endianSwap) > 1) {
+                            status = ER_BUS_BAD_VALUE;
+                            break;
+                        }
+                    }
+                }
+                break;
+
+            case ALLJOYN_INT32:
+            case ALLJOYN_UINT32:
+                if (len & 3) {
+                    status = ER_BUS_BAD_LENGTH;
+                } else {
+                    q += len;
+                }
+                break;
+
+            case ALLJOYN_DOUBLE:
+            case ALLJOYN_INT64:
+            case ALLJOYN_UINT64:
+                q = Align(q, 8);
+                if ((len & 7) || (len > (size_t)(limit - q))) {
+                    status = ER_BUS_BAD_LENGTH;
+                } else {
+                    q += len;
+                }
+                break;
+
+            case ALLJOYN_STRUCT_OPEN:
+            case ALLJOYN_DICT_ENTRY_OPEN:
+                /*
+                 * The array length does not include the pad bytes before the first element.
+                 */
+                q = Align(q, 8);
+                if (len > (size_t)(limit - q)) {
+                    status = ER_BUS_BAD_LENGTH;
+                    break;
+                }
+
+            /* Falling through */
+            default:
+                {
+                    /*
+                     * Like ParseArray() the last element is only checked against the end of the
+                     * data and not the end of the array.
+                     */
+                    const uint8_t* arrayEnd = q + len;
+                    while ((status == ER_OK) && (q < arrayEnd)) {
+                        const char* elem = elemSig;
+                        status = Skip(elem, q, limit, true, true);
+                    }
+                }
+                break;
+            }
+        }
+        break;
+
+    case ALLJOYN_DICT_ENTRY_OPEN:
+        if (!arrayElem) {
+            status = ER_BUS_BAD_SIGNATURE;
+            break;
+        }
+
+    /* Falling through */
+    case ALLJOYN_STRUCT_OPEN:
+        if (!sigChecked) {
+            const char* containerSig = s - 1;
+            status = SignatureUtils::ParseCompleteType(containerSig);
+            if (status != ER_OK) {
+                break;
+            }
+        }
+        q = Align(q, 8);
+        while ((status == ER_OK) && (*s != ALLJOYN_STRUCT_CLOSE) && (*s != ALLJOYN_DICT_ENTRY_CLOSE)) {
+            status = Skip(s, q, limit, false, true);
+        }
+        ++s;
+        break;
+
+    case ALLJOYN_HANDLE:
+        q = Align(q, 4);
+        if ((q + 4) > limit) {
+            status = ER_BUS_BAD_SIGNATURE;
+        } else if (Read32(q, endianSwap) >= numHandles) {
+            status = ER_BUS_NO_SUCH_HANDLE;
+        } else {
+            q += 4;
+        }
+        break;
+
+    default:
+        status = ER_BUS_BAD_VALUE_TYPE;
+        break;
+    }
+    /*
+     * Check we are not running of the end of the data
+     */
+    if ((status == ER_OK) && (q > limit)) {
+        status = ER_BUS_BAD_SIGNATURE;
+    }
+    if (status == ER_OK) {
+        sigPtr = s;
+        p = q;
+    }
+    return status;
+}
+
+QStatus MsgArgView::Next()
+{
+    if (AtEnd()) {
+        return ER_BUS_SIGNATURE_MISMATCH;
+    }
+    const char* s = sig;
+    const uint8_t* p = pos;
+    QStatus status = Skip(s, p, end, inArray, sigChecked);
+    if (status == ER_OK) {
+        Advance(s, p);
+    }
+    return status;
+}
+
+QStatus MsgArgView::Recurse(MsgArgView& sub)
+{
+    if (AtEnd()) {
+        return ER_BUS_SIGNATURE_MISMATCH;
+    }
+    QStatus status = ER_OK;
+    const char* s = sig;
+    const uint8_t* p = pos;
+
+    sub.base = base;
+    sub.handles = handles;
+    sub.numHandles = numHandles;
+    sub.endianSwap = endianSwap;
+    sub.sigChecked = true;
+
+    switch (*sig) {
+    case ALLJOYN_ARRAY:
+        {
+            /*
+             * The array length tells us where the array ends so the elements are only checked when
+             * they are visited by the sub-view.
+             */
+            if (sigChecked) {
+                s = EndOfType(sig);
+            } else {
+                status = SignatureUtils::ParseCompleteType(s);
+                if (status != ER_OK) {
+                    return status;
+                }
+            }
+            p = Align(p, 4);
+            if ((p + 4) > end) {
+                return ER_BUS_BAD_LENGTH;
+            }
+            size_t len = Read32(p, endianSwap);
+            p += 4;
+            switch (sig[1]) {
+            case ALLJOYN_DOUBLE:
+            case ALLJOYN_INT64:
+            case ALLJOYN_UINT64:
+            case ALLJOYN_STRUCT_OPEN:
+            case ALLJOYN_DICT_ENTRY_OPEN:
+                p = Align(p, 8);
+                break;
+            }
+            if ((len > ALLJOYN_MAX_ARRAY_LEN) || (p > end) || (len > (size_t)(end - p))) {
+                return ER_BUS_BAD_LENGTH;
+            }
+            sub.sig = sig + 1;
+            sub.pos = p;
+            sub.end = p + len;
+            sub.inArray = true;
+            p += len;
+        }
+        break;
+
+    case ALLJOYN_STRUCT_OPEN:
+    case ALLJOYN_DICT_ENTRY_OPEN:
+        status = Skip(s, p, end, inArray, sigChecked);
+        if (status == ER_OK) {
+            sub.sig = sig + 1;
+            sub.pos = Align(pos, 8);
+            sub.end = p;
+            sub.inArray = false;
+        }
+        break;
+
+    case ALLJOYN_VARIANT:
+        /*
+         * Skipping the variant also checks the signature of the value it contains.
+         */
+        status = Skip(s, p, end, inArray, sigChecked);
+        if (status == ER_OK) {
+            sub.sig = reinterpret_cast<const char*>(pos + 1);
+            sub.pos = pos + *pos + 2;
+            sub.end = p;
+            sub.inArray = false;
+        }
+        break;
+
+    default:
+        return ER_BUS_SIGNATURE_MISMATCH;
+    }
+    if (status == ER_OK) {
+        Advance(s, p);
+    }
+    return status;
+}
+
+QStatus MsgArgView::GetValue(char typeId, size_t alignment, const uint8_t*& val)
+{
+    if (AtEnd() || (*sig != typeId)) {
+        return ER_BUS_SIGNATURE_MISMATCH;
+    }
+    const char* s = sig;
+    const uint8_t* p = pos;
+    QStatus status = Skip(s, p, end, inArray, sigChecked);
+    if (status == ER_OK) {
+        val = Align(pos, alignment);
+        Advance(s, p);
+    }
+    return status;
+}
+
+QStatus MsgArgView::GetByte(uint8_t& val)
+{
+    const uint8_t* v;
+    QStatus status = GetValue(ALLJOYN_BYTE, 1, v);
+    if (status == ER_OK) {
+        val = *v;
+    }
+    return status;
+}
+
+QStatus MsgArgView::GetBool(bool& val)
+{
+    const uint8_t* v;
+    QStatus status = GetValue(ALLJOYN_BOOLEAN, 4, v);
+    if (status == ER_OK) {
+        val = (Read32(v, endianSwap) == 1);
+    }
+    return status;
+}
+
+QStatus MsgArgView::GetInt16(int16_t& val)
+{
+    const uint8_t* v;
+    QStatus status = GetValue(ALLJOYN_INT16, 2, v);
+    if (status == ER_OK) {
+        uint16_t n = *reinterpret_cast<const uint16_t*>(v);
+        val = (int16_t)(endianSwap ? EndianSwap16(n) : n);
+    }
+    return status;
+}
+
+QStatus MsgArgView::GetUint16(uint16_t& val)
+{
+    const uint8_t* v;
+    QStatus status = GetValue(ALLJOYN_UINT16, 2, v);
+    if (status == ER_OK) {
+        uint16_t n = *reinterpret_cast<const uint16_t*>(v);
+        val = endianSwap ? EndianSwap16(n) : n;
+    }
+    return status;
+}
+
+QStatus MsgArgView::GetInt32(int32_t& val)
+{
+    const uint8_t* v;
+    QStatus status = GetValue(ALLJOYN_INT32, 4, v);
+    if (status == ER_OK) {
+        val = (int32_t)Read32(v, endianSwap);
+    }
+    return status;
+}
+
+QStatus MsgArgView::GetUint32(uint32_t& val)
+{
+    const uint8_t* v;
+    QStatus status = GetValue(ALLJOYN_UINT32, 4, v);
+    if (status == ER_OK) {
+        val = Read32(v, endianSwap);
+    }
+    return status;
+}
+
+QStatus MsgArgView::GetInt64(int64_t& val)
+{
+    const uint8_t* v;
+    QStatus status = GetValue(ALLJOYN_INT64, 8, v);
+    if (status == ER_OK) {
+        val = (int64_t)Read64(v, endianSwap);
+    }
+    return status;
+}
+
+QStatus MsgArgView::GetUint64(uint64_t& val)
+{
+    const uint8_t* v;
+    QStatus status = GetValue(ALLJOYN_UINT64, 8, v);
+    if (status == ER_OK) {
+        val = Read64(v, endianSwap);
+    }
+    return status;
+}
+
+QStatus MsgArgView::GetDouble(double& val)
+{
+    const uint8_t* v;
+    QStatus status = GetValue(ALLJOYN_DOUBLE, 8, v);
+    if (status == ER_OK) {
+        uint64_t bits = Read64(v, endianSwap);
+        memcpy(&val, &bits, sizeof(val));
+    }
+    return status;
+}
+
+QStatus MsgArgView::GetHandle(qcc::SocketFd& val)
+{
+    const uint8_t* v;
+    QStatus status = GetValue(ALLJOYN_HANDLE, 4, v);
+    if (status == ER_OK) {
+        val = handles[Read32(v, endianSwap)];
+    }
+    return status;
+}
+
+QStatus MsgArgView::GetStringValue(char typeId, const char*& str, size_t* len)
+{
+    const uint8_t* v;
+    QStatus status = GetValue(typeId, (typeId == ALLJOYN_SIGNATURE) ? 1 : 4, v);
+    if (status == ER_OK) {
+        size_t n;
+        if (typeId == ALLJOYN_SIGNATURE) {
+            n = *v;
+            str = reinterpret_cast<const char*>(v + 1);
+        } else {
+            n = Read32(v, endianSwap);
+            str = reinterpret_cast<const char*>(v + 4);
+        }
+        if (len) {
+            *len = n;
+        }
+    }
+    return status;
+}
+
+QStatus MsgArgView::GetString(const char*& str, size_t* len)
+{
+    return GetStringValue(ALLJOYN_STRING, str, len);
+}
+
+QStatus MsgArgView::GetObjectPath(const char*& str, size_t* len)
+{
+    return GetStringValue(ALLJOYN_OBJECT_PATH, str, len);
+}
+
+QStatus MsgArgView::GetSignature(const char*& str, size_t* len)
+{
+    return GetStringValue(ALLJOYN_SIGNATURE, str, len);
+}
+
+QStatus MsgArgView::GetScalarArray(char elemTypeId, size_t elemSize, const void*& elements, size_t& numElements)
+{
+    if (AtEnd() || (sig[0] != ALLJOYN_ARRAY) || (sig[1] != elemTypeId)) {
+        return ER_BUS_SIGNATURE_MISMATCH;
+    }
+    if (endianSwap && (elemSize > 1)) {
+        return ER_NOT_IMPLEMENTED;
+    }
+    const char* s = sig;
+    const uint8_t* p = pos;
+    QStatus status = Skip(s, p, end, inArray, sigChecked);
+    if (status == ER_OK) {
+        const uint8_t* v = Align(pos, 4);
+        size_t len = Read32(v, endianSwap);
+        v += 4;
+        if (elemSize == 8) {
+            v = Align(v, 8);
+        }
+        elements = v;
+        numElements = len / elemSize;
+        Advance(s, p);
+    }
+    return status;
+}
+
+QStatus MsgArgView::GetArray(const uint8_t*& elements, size_t& numElements)
+{
+    const void* v = NULL;
+    QStatus status = GetScalarArray(ALLJOYN_BYTE, 1, v, numElements);
+    elements = static_cast<const uint8_t*>(v);
+    return status;
+}
+
+QStatus MsgArgView::GetArray(const int16_t*& elements, size_t& numElements)
+{
+    const void* v = NULL;
+    QStatus status = GetScalarArray(ALLJOYN_INT16, 2, v, numElements);
+    elements = static_cast<const int16_t*>(v);
+    return status;
+}
+
+QStatus MsgArgView::GetArray(const uint16_t*& elements, size_t& numElements)
+{
+    const void* v = NULL;
+    QStatus status = GetScalarArray(ALLJOYN_UINT16, 2, v, numElements);
+    elements = static_cast<const uint16_t*>(v);
+    return status;
+}
+
+QStatus MsgArgView::GetArray(const int32_t*& elements, size_t& numElements)
+{
+    const void* v = NULL;
+    QStatus status = GetScalarArray(ALLJOYN_INT32, 4, v, numElements);
+    elements = static_cast<const int32_t*>(v);
+    return status;
+}
+
+QStatus MsgArgView::GetArray(const uint32_t*& elements, size_t& numElements)
+{
+    const void* v = NULL;
+    QStatus status = GetScalarArray(ALLJOYN_UINT32, 4, v, numElements);
+    elements = static_cast<const uint32_t*>(v);
+    return status;
+}
+
+QStatus MsgArgView::GetArray(const int64_t*& elements, size_t& numElements)
+{
+    const void* v = NULL;
+    QStatus status = GetScalarArray(ALLJOYN_INT64, 8, v, numElements);
+    elements = static_cast<const int64_t*>(v);
+    return status;
+}
+
+QStatus MsgArgView::GetArray(const uint64_t*& elements, size_t& numElements)
+{
+    const void* v = NULL;
+    QStatus status = GetScalarArray(ALLJOYN_UINT64, 8, v, numElements);
+    elements = static_cast<const uint64_t*>(v);
+    return status;
+}
+
+QStatus MsgArgView::GetArray(const double*& elements, size_t& numElements)
+{
+    const void* v = NULL;
+    QStatus status = GetScalarArray(ALLJOYN_DOUBLE, 8, v, numElements);
+    elements = static_cast<const double*>(v);
+    return status;
+}
+
+}
@@ -164,6 +164,31 @@ bool _PeerState::IsValidSerial(uint32_t serial, bool secure, bool unreliable)
 
 }
 
+QStatus _PeerState::GetKey(qcc::KeyBlob& key, PeerKeyType keyType, std::shared_ptr<Crypto_AES>& cipher)
+{
+    QStatus status = GetKey(key, keyType);
+    if ((status == ER_OK) && (key.GetType() == KeyBlob::AES)) {
+        /*
+         * The cipher is created under the lock so it can't be installed for a key that was
+         * replaced while it was being created.
+         */
+        cipherLock.Lock(MUTEX_CONTEXT);
+        if (!ciphers[keyType]) {
+            ciphers[keyType] = std::make_shared<Crypto_AES>(keys[keyType], Crypto_AES::CCM);
+        }
+        cipher = ciphers[keyType];
+        cipherLock.Unlock(MUTEX_CONTEXT);
+    }
+    return status;
+}
+
+void _PeerState::ClearCipher(PeerKeyType keyType)
+{
+    cipherLock.Lock(MUTEX_CONTEXT);
+    ciphers[keyType].reset();
+    cipherLock.Unlock(MUTEX_CONTEXT);
+}
+
 bool _PeerState::IsConversationHashInitialized(bool initiator)
 {
     return GetConversationHash(initiator) != NULL;
@@ -413,6 +438,36 @@ void _PeerState::SetGuildMetadata(const qcc::String& serial, const qcc::String&
         guildMap.erase(key);
     }
     guildMap[key] = guild;
+    ClearAuthorizationCache();
+}
+
+uint64_t _PeerState::GetMembershipsValidUntil() const
+{
+    uint64_t validUntil = (std::numeric_limits<uint64_t>::max)();
+    uint64_t now = GetEpochTimestamp() / 1000;
+    for (GuildMap::const_iterator it = guildMap.begin(); it != guildMap.end(); ++it) {
+        const std::vector<CertificateX509*>& certChain = it->second->certChain;
+        if (certChain.empty()) {
+            continue;
+        }
+        /*
+         * A certificate changes authorization decisions when it becomes valid and when it expires.
+         * Certificate validity is in seconds and includes the validTo second.
+         */
+        const CertificateX509::ValidPeriod* validity = certChain[0]->GetValidity();
+        uint64_t change;
+        if (now < validity->validFrom) {
+            change = validity->validFrom;
+        } else if (now <= validity->validTo) {
+            change = validity->validTo + 1;
+        } else {
+            continue;
+        }
+        if (change < (validUntil / 1000)) {
+            validUntil = change * 1000;
+        }
+    }
+    return validUntil;
 }
 
 _PeerState::GuildMetadata* _PeerState::GetGuildMetadata(const qcc::String& serial, const String& issuerAki)
@@ -544,6 +599,7 @@ QStatus _PeerState::SetAuthSuite(const String& authSuite)
 QStatus _PeerState::StoreManifest(const Manifest& manifest)
 {
     m_manifests.push_back(manifest);
+    ClearAuthorizationCache();
 
     return ER_OK;
 }
@@ -551,6 +607,7 @@ QStatus _PeerState::StoreManifest(const Manifest& manifest)
 QStatus _PeerState::ClearManifests()
 {
     m_manifests.clear();
+    ClearAuthorizationCache();
 
     return ER_OK;
 }
@@ -560,6 +617,56 @@ const std::vector<Manifest> _PeerState::GetManifests() const
     return m_manifests;
 }
 
+/*
+ * Bound the number of distinct requests cached for a peer; the cache is simply flushed when full.
+ */
+static const size_t MAX_AUTHORIZATION_CACHE_SIZE = 256;
+
+bool _PeerState::GetCachedAuthorization(uint32_t generation, const std::string& key, bool& authorized, uint32_t& epoch)
+{
+    bool found = false;
+    m_authorizationCacheLock.Lock(MUTEX_CONTEXT);
+    epoch = m_authorizationCacheEpoch;
+    if (generation == m_authorizationCacheGeneration) {
+        std::unordered_map<std::string, CachedAuthorization>::iterator it = m_authorizationCache.find(key);
+        if (it != m_authorizationCache.end()) {
+            if (GetEpochTimestamp() < it->second.validUntil) {
+                authorized = it->second.authorized;
+                found = true;
+            } else {
+                m_authorizationCache.erase(it);
+            }
+        }
+    }
+    m_authorizationCacheLock.Unlock(MUTEX_CONTEXT);
+    return found;
+}
+
+void _PeerState::CacheAuthorization(uint32_t generation, uint32_t epoch, const std::string& key, bool authorized, uint64_t validUntil)
+{
+    m_authorizationCacheLock.Lock(MUTEX_CONTEXT);
+    if (epoch != m_authorizationCacheEpoch) {
+        m_authorizationCacheLock.Unlock(MUTEX_CONTEXT);
+        return;
+    }
+    if ((generation != m_authorizationCacheGeneration) || (m_authorizationCache.size() >= MAX_AUTHORIZATION_CACHE_SIZE)) {
+        m_authorizationCache.clear();
+        m_authorizationCacheGeneration = generation;
+    }
+    CachedAuthorization& entry = m_authorizationCache[key];
+    entry.authorized = authorized;
+    entry.validUntil = validUntil;
+    m_authorizationCacheLock.Unlock(MUTEX_CONTEXT);
+}
+
+void _PeerState::ClearAuthorizationCache()
+{
+    m_authorizationCacheLock.Lock(MUTEX_CONTEXT);
+    m_authorizationCache.clear();
+    ++m_authorizationCacheEpoch;
+    m_authorizationCacheLock.Unlock(MUTEX_CONTEXT);
+}
+
 /* Since we're using the signature as the key which has good randomness, we don't need to use
  * the entire signature as the key; this many bytes will do.
  */
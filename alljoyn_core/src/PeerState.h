@@ -28,6 +28,7 @@
 #include <qcc/platform.h>
 
 #include <map>
+#include <memory>
 #include <unordered_map>
 #include <limits>
 
@@ -157,6 +158,7 @@ class _PeerState {
         lastDriftAdjustTime(0),
         isSecure(false),
         authEvent(NULL),
+        cipherLock(qcc::LOCK_LEVEL_PEERSTATE_CIPHERLOCK),
         prevSerial(0),
         flagWindow(0),
         initiatorHash(NULL),
@@ -167,6 +169,9 @@ class _PeerState {
         keyExchangeMode(KEY_EXCHANGE_NONE),
         m_authSuite(0),
         m_manifests(),
+        m_authorizationCacheGeneration(0),
+        m_authorizationCacheEpoch(0),
+        m_authorizationCacheLock(qcc::LOCK_LEVEL_PEERSTATE_AUTHORIZATIONCACHELOCK),
         m_manifestsSent(),
         m_haveExchangedManifests(false)
     {
@@ -217,6 +222,7 @@ class _PeerState {
     void SetGuidAndAuthVersion(const qcc::GUID128& newGuid, uint32_t authenticationVersion) {
         this->guid = newGuid;
         this->authVersion = authenticationVersion;
+        ClearAuthorizationCache();
     }
 
     /**
@@ -228,6 +234,9 @@ class _PeerState {
     void SetKey(const qcc::KeyBlob& key, PeerKeyType keyType) {
         keys[keyType] = key;
         isSecure = key.IsValid();
+        ClearCipher(keyType);
+        /* a new key means the peer authenticated again, possibly with other credentials */
+        ClearAuthorizationCache();
     }
 
     /**
@@ -253,14 +262,32 @@ class _PeerState {
         }
     }
 
+    /**
+     * Gets the session key for this peer and a CCM cipher keyed with it. The cipher is created the
+     * first time it is needed and reused until the key is changed or cleared so messages don't pay
+     * for a key expansion each.
+     *
+     * @param[in] key     [out]Returns the session key.
+     * @param[in] keyType Indicate if this is the unicast or broadcast key.
+     * @param[in] cipher  [out]Returns the cipher for the session key.
+     *
+     * @return  - ER_OK if there is a session key set for this peer.
+     *          - ER_BUS_KEY_UNAVAILABLE if no session key has been set for this peer.
+     *          - ER_BUS_KEY_EXPIRED if there was a session key but the key has expired.
+     */
+    QStatus GetKey(qcc::KeyBlob& key, PeerKeyType keyType, std::shared_ptr<qcc::Crypto_AES>& cipher);
+
     /**
      * Clear the keys for this peer.
      */
     void ClearKeys() {
         keys[PEER_SESSION_KEY].Erase();
         keys[PEER_GROUP_KEY].Erase();
+        ClearCipher(PEER_SESSION_KEY);
+        ClearCipher(PEER_GROUP_KEY);
         isSecure = false;
         m_authSuite = 0;
+        ClearAuthorizationCache();
     }
 
     /**
@@ -361,6 +388,14 @@ class _PeerState {
      */
     GuildMetadata* GetGuildMetadata(const qcc::String& serial, const qcc::String& issuerAki);
 
+    /**
+     * Get the next time one of the peer's membership certificates becomes valid or expires.
+     *
+     * @return Epoch time in milliseconds or the maximum uint64_t value if none of the peer's
+     *         membership certificates will change validity.
+     */
+    uint64_t GetMembershipsValidUntil() const;
+
     /**
      * Mapping table for guild memberships
      */
@@ -600,6 +635,41 @@ class _PeerState {
      */
     const std::vector<Manifest> GetManifests() const;
 
+    /**
+     * Look up an authorization decision cached by the PermissionManager for this peer.
+     *
+     * Decisions are not returned once a credential they were made with has expired.
+     *
+     * @param[in] generation   Generation of the local policy the decision must have been made with.
+     * @param[in] key          Key describing the request.
+     * @param[out] authorized  Returns the cached decision.
+     * @param[out] epoch       Returns the cache epoch to pass to CacheAuthorization if no decision was found.
+     *
+     * @return true if a decision was found.
+     */
+    bool GetCachedAuthorization(uint32_t generation, const std::string& key, bool& authorized, uint32_t& epoch);
+
+    /**
+     * Cache an authorization decision for this peer. Decisions made with a different policy
+     * generation are discarded. The decision is not cached if the cache was cleared since the
+     * epoch was returned by GetCachedAuthorization.
+     *
+     * @param[in] generation  Generation of the local policy the decision was made with.
+     * @param[in] epoch       Cache epoch returned by GetCachedAuthorization.
+     * @param[in] key         Key describing the request.
+     * @param[in] authorized  The decision.
+     * @param[in] validUntil  Epoch time in milliseconds the first of the peer's credentials the
+     *                        decision was made with expires.
+     */
+    void CacheAuthorization(uint32_t generation, uint32_t epoch, const std::string& key, bool authorized,
+                            uint64_t validUntil = (std::numeric_limits<uint64_t>::max)());
+
+    /**
+     * Discard all cached authorization decisions for this peer. Called whenever the peer's keys,
+     * memberships or manifests change.
+     */
+    void ClearAuthorizationCache();
+
     /**
      * Store a manifest we sent to the remote peer.
      *
@@ -657,6 +727,13 @@ class _PeerState {
      */
     _PeerState(const _PeerState& other);
 
+    /**
+     * Drop the cached cipher for a session key.
+     *
+     * @param[in] keyType    Indicate if this is the unicast or broadcast key.
+     */
+    void ClearCipher(PeerKeyType keyType);
+
     /**
      * Get the conversation hash
      * @param[in] initiator key exchange started as initiator
@@ -720,6 +797,16 @@ class _PeerState {
      */
     qcc::KeyBlob keys[2];
 
+    /**
+     * CCM ciphers keyed with the session keys, created on first use.
+     */
+    std::shared_ptr<qcc::Crypto_AES> ciphers[2];
+
+    /**
+     * Lock protecting the ciphers.
+     */
+    qcc::Mutex cipherLock;
+
     /**
      * The previous serial number seen from this peer.
      * Used by IsValidSerial() to detect replay attacks.
@@ -771,6 +858,34 @@ class _PeerState {
      */
     std::vector<Manifest> m_manifests;
 
+    /**
+     * A cached authorization decision and the time it stops being valid.
+     */
+    struct CachedAuthorization {
+        bool authorized;
+        uint64_t validUntil;
+    };
+
+    /**
+     * Authorization decisions made for this peer, see PermissionManager::AuthorizeMessage.
+     */
+    std::unordered_map<std::string, CachedAuthorization> m_authorizationCache;
+
+    /**
+     * Policy generation the cached authorization decisions were made with.
+     */
+    uint32_t m_authorizationCacheGeneration;
+
+    /**
+     * Incremented whenever the authorization cache is cleared.
+     */
+    uint32_t m_authorizationCacheEpoch;
+
+    /**
+     * Lock protecting the authorization cache.
+     */
+    qcc::Mutex m_authorizationCacheLock;
+
     /**
      * Manifests we've sent to this peer.
      */
@@ -379,6 +379,10 @@ static bool IsPeerQualifiedForAcl(const PermissionPolicy::Acl& acl, PeerState& p
                     }
                     MembershipCertificate* membershipCert = (MembershipCertificate*) metadata->certChain[0];
                     QCC_DbgTrace(("%s: Membership certificate found:\n%s", __FUNCTION__, membershipCert->ToString().c_str()));
+                    if (membershipCert->VerifyValidity() != ER_OK) {
+                        QCC_DbgTrace(("%s: Membership certificate is not valid at this time.", __FUNCTION__));
+                        continue;
+                    }
                     if (peers[idx].GetSecurityGroupId() == membershipCert->GetGuild()) {
                         return true;
                     }
@@ -423,6 +427,28 @@ static bool IsPeerAuthorized(const Request& request, const PermissionPolicy* pol
     return allowed;
 }
 
+/**
+ * Build the key of a cached authorization decision.  Decisions are cached per
+ * peer and discarded when the peer's credentials, memberships or manifests
+ * change, so the key only has to describe the request.
+ */
+static std::string GenAuthorizationCacheKey(const Request& request, bool authenticated)
+{
+    std::string key;
+    uint8_t flags = (request.outgoing ? 0x01 : 0) |
+                    (request.propertyRequest ? 0x02 : 0) |
+                    (request.isSetProperty ? 0x04 : 0) |
+                    (authenticated ? 0x08 : 0);
+    key.push_back(static_cast<char>(flags));
+    key.push_back(static_cast<char>(request.mbrType));
+    key.append(request.objPath ? request.objPath : "");
+    key.push_back('\0');
+    key.append(request.iName ? request.iName : "");
+    key.push_back('\0');
+    key.append(request.mbrName ? request.mbrName : "");
+    return key;
+}
+
 /**
  * The search order through the Acls:
  * 1. peer public key
@@ -432,7 +458,7 @@ static bool IsPeerAuthorized(const Request& request, const PermissionPolicy* pol
  * 5. all peers
  */
 
-static bool IsAuthorized(const Request& request, const PermissionPolicy* policy, PeerState& peerState, PermissionMgmtObj* permissionMgmtObj, bool authenticated = true)
+static bool IsAuthorized(const Request& request, const PermissionPolicy* policy, uint32_t policyGeneration, PeerState& peerState, PermissionMgmtObj* permissionMgmtObj, bool authenticated = true)
 {
     Right right;
     GenRight(request, right);
@@ -449,12 +475,24 @@ static bool IsAuthorized(const Request& request, const PermissionPolicy* policy,
             QCC_DbgPrintf(("Not authorized because of missing policy"));
             return false;
         }
+        /*
+         * The decision only depends on the request, the policy and the peer's credentials
+         * so it can be reused until one of them changes or expires.  Look it up before
+         * fetching the peer's credentials from the key store.
+         */
+        std::string cacheKey = GenAuthorizationCacheKey(request, authenticated);
+        uint32_t cacheEpoch;
+        if (peerState->GetCachedAuthorization(policyGeneration, cacheKey, authorized, cacheEpoch)) {
+            QCC_DbgPrintf(("Cached decision: Authorized: %d", authorized));
+            return authorized;
+        }
         /* validate the remote peer auth data to make sure it was granted to perform such action */
         ECCPublicKey peerPublicKey;
         KeyInfoNISTP256 publicKeyInfo;
         std::vector<ECCPublicKey> issuerPublicKeys;
         const ECCPublicKey* trustedPeerPublicKey = NULL;
         bool trustedPeer = false;
+        uint64_t validUntil = peerState->GetMembershipsValidUntil();
         if (authenticated) {
             if (peerState->IsLocalPeer()) {
                 if (ER_OK == permissionMgmtObj->GetPublicKey(publicKeyInfo)) {
@@ -465,8 +503,10 @@ static bool IsAuthorized(const Request& request, const PermissionPolicy* policy,
             } else {
                 bool publicKeyFound = false;
                 qcc::String authMechanism;
-                QStatus status = permissionMgmtObj->GetConnectedPeerAuthMetadata(peerState->GetGuid(), authMechanism, publicKeyFound, &peerPublicKey, NULL, issuerPublicKeys);
+                uint64_t secretExpiration;
+                QStatus status = permissionMgmtObj->GetConnectedPeerAuthMetadata(peerState->GetGuid(), authMechanism, publicKeyFound, &peerPublicKey, NULL, issuerPublicKeys, &secretExpiration);
                 if (ER_OK == status) {
+                    validUntil = (std::min)(validUntil, secretExpiration);
                     /* trusted peer */
                     if (publicKeyFound) {
                         trustedPeerPublicKey = &peerPublicKey;
@@ -500,13 +540,14 @@ static bool IsAuthorized(const Request& request, const PermissionPolicy* policy,
 #endif
         QCC_DbgPrintf(("Peer's trusted peer: %d public key: %s Authorized: %d Denied: %d Manifest required: %d", trustedPeer, trustedPeerPublicKey ? trustedPeerPublicKey->ToString().c_str() : "N/A", authorized, denied, enforceManifest));
         if (denied || !authorized) {
+            peerState->CacheAuthorization(policyGeneration, cacheEpoch, cacheKey, false, validUntil);
             return false;
         }
-    }
-
-    if (authorized && enforceManifest) {
-        authorized = IsAuthorizedByPeerManifest(request, right, peerState);
-        QCC_DbgPrintf(("Enforce peer's manifest: Authorized: %d", authorized));
+        if (enforceManifest) {
+            authorized = IsAuthorizedByPeerManifest(request, right, peerState);
+            QCC_DbgPrintf(("Enforce peer's manifest: Authorized: %d", authorized));
+        }
+        peerState->CacheAuthorization(policyGeneration, cacheEpoch, cacheKey, authorized, validUntil);
     }
     return authorized;
 }
@@ -816,7 +857,8 @@ QStatus PermissionManager::AuthorizeMessage(bool outgoing, Message& msg, PeerSta
     QCC_DbgPrintf(("PermissionManager::AuthorizeMessage with outgoing: %d msg %s", outgoing, msg->ToString().c_str()));
     QCC_DbgPrintf(("PermissionManager::AuthorizeMessage: local policy %s", GetPolicy() ? GetPolicy()->ToString().c_str() : "NULL"));
 
-    authorized = IsAuthorized(request, GetPolicy(), peerState, permissionMgmtObj, authenticated);
+    uint32_t generation = static_cast<uint32_t>(policyGeneration);
+    authorized = IsAuthorized(request, GetPolicy(), generation, peerState, permissionMgmtObj, authenticated);
     if (!authorized) {
         QCC_DbgPrintf(("PermissionManager::AuthorizeMessage IsAuthorized returns ER_PERMISSION_DENIED\n"));
         return ER_PERMISSION_DENIED;
@@ -838,7 +880,8 @@ QStatus PermissionManager::AuthorizeGetProperty(const char* objPath, const char*
     QCC_DbgPrintf(("PermissionManager::AuthorizeGetProperty: ifc %s prop %s local policy %s", ifcName, propName, GetPolicy() ? GetPolicy()->ToString().c_str() : "NULL"));
 
     Request request(objPath, ifcName, propName, PermissionPolicy::Rule::Member::PROPERTY, false, true);
-    if (!IsAuthorized(request, GetPolicy(), peerState, permissionMgmtObj)) {
+    uint32_t generation = static_cast<uint32_t>(policyGeneration);
+    if (!IsAuthorized(request, GetPolicy(), generation, peerState, permissionMgmtObj)) {
         QCC_DbgPrintf(("PermissionManager::AuthorizeGetProperty IsAuthorized returns ER_PERMISSION_DENIED\n"));
         return ER_PERMISSION_DENIED;
     }
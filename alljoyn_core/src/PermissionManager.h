@@ -26,6 +26,7 @@
 #endif
 
 #include <alljoyn/PermissionPolicy.h>
+#include <qcc/atomic.h>
 #include "PermissionMgmtObj.h"
 
 namespace ajn {
@@ -38,7 +39,7 @@ class PermissionManager {
      * Constructor
      *
      */
-    PermissionManager() : policy(NULL), permissionMgmtObj(NULL)
+    PermissionManager() : policy(NULL), permissionMgmtObj(NULL), policyGeneration(0)
     {
     }
 
@@ -59,6 +60,8 @@ class PermissionManager {
     {
         delete this->policy;
         this->policy = policy;
+        /* authorization decisions cached by the peers were made with the old policy */
+        qcc::IncrementAndFetch(&policyGeneration);
     }
 
     /**
@@ -126,6 +129,7 @@ class PermissionManager {
 
     PermissionPolicy* policy;
     PermissionMgmtObj* permissionMgmtObj;
+    volatile int32_t policyGeneration;
 };
 
 }
@@ -357,6 +357,7 @@ static bool AddTrustAnchorIfNotDuplicate(std::shared_ptr<PermissionMgmtObj::Trus
 
     if (!duplicate) {
         trustAnchors.push_back(ta);
+        CertificateX509::ClearCache();
     }
 
     trustAnchors.Unlock(MUTEX_CONTEXT);
@@ -398,6 +399,7 @@ void PermissionMgmtObj::ClearTrustAnchors()
     trustAnchors.Lock(MUTEX_CONTEXT);
     trustAnchors.clear();
     trustAnchors.Unlock(MUTEX_CONTEXT);
+    CertificateX509::ClearCache();
 }
 
 QStatus PermissionMgmtObj::StoreDSAKeys(CredentialAccessor* ca, const ECCPrivateKey* privateKey, const ECCPublicKey* publicKey)
@@ -2146,6 +2148,7 @@ QStatus PermissionMgmtObj::ParseSendMemberships(Message& msg, bool& done)
         status = GetConnectedPeerPublicKey(peerState->GetGuid(), &peerPublicKey);
         if (ER_OK != status) {
             _PeerState::ClearGuildMap(peerState->guildMap);
+            peerState->ClearAuthorizationCache();
             done = true;
             return ER_OK;  /* could not validate */
         }
@@ -2189,6 +2192,8 @@ QStatus PermissionMgmtObj::ParseSendMemberships(Message& msg, bool& done)
                 break;  /* done */
             }
         }
+        /* authorization decisions made with the old memberships no longer apply */
+        peerState->ClearAuthorizationCache();
         done = true;
     }
     return ER_OK;
@@ -2366,7 +2371,7 @@ void PermissionMgmtObj::Reset(const InterfaceDescription::Member* member, Messag
     MethodReply(msg, Reset());
 }
 
-QStatus PermissionMgmtObj::GetConnectedPeerAuthMetadata(const GUID128& guid, qcc::String& authMechanism, bool& publicKeyFound, qcc::ECCPublicKey* publicKey, uint8_t* identityCertificateThumbprint, std::vector<ECCPublicKey>& issuerPublicKeys)
+QStatus PermissionMgmtObj::GetConnectedPeerAuthMetadata(const GUID128& guid, qcc::String& authMechanism, bool& publicKeyFound, qcc::ECCPublicKey* publicKey, uint8_t* identityCertificateThumbprint, std::vector<ECCPublicKey>& issuerPublicKeys, uint64_t* expiration)
 {
     CredentialAccessor ca(bus);
     KeyBlob kb;
@@ -2375,6 +2380,10 @@ QStatus PermissionMgmtObj::GetConnectedPeerAuthMetadata(const GUID128& guid, qcc
     if (ER_OK != status) {
         return status;
     }
+    if (expiration) {
+        Timespec<EpochTime> expires;
+        *expiration = kb.GetExpiration(expires) ? expires.GetMillis() : (std::numeric_limits<uint64_t>::max)();
+    }
     KeyBlob msBlob;
     publicKeyFound = false;
     status = KeyExchanger::ParsePeerSecretRecord(kb, msBlob, publicKey, identityCertificateThumbprint, issuerPublicKeys, publicKeyFound);
@@ -360,9 +360,12 @@ class PermissionMgmtObj : public BusObject {
      * @param[out] identityCertificateThumbprint buffer to receive the SHA-256 thumbprint of the identity certificate
      * @param[out] issuerPublicKeys the vector for the list of issuer public
      *                               keys.
+     * @param[out] expiration the epoch time in milliseconds the peer secret
+     *                        expires, or the maximum uint64_t value if it does
+     *                        not expire.  Pass NULL to skip.
      * @return ER_OK if successful; otherwise, error code.
      */
-    QStatus GetConnectedPeerAuthMetadata(const qcc::GUID128& guid, qcc::String& authMechanism, bool& publicKeyFound, qcc::ECCPublicKey* publicKey, uint8_t* identityCertificateThumbprint, std::vector<qcc::ECCPublicKey>& issuerPublicKeys);
+    QStatus GetConnectedPeerAuthMetadata(const qcc::GUID128& guid, qcc::String& authMechanism, bool& publicKeyFound, qcc::ECCPublicKey* publicKey, uint8_t* identityCertificateThumbprint, std::vector<qcc::ECCPublicKey>& issuerPublicKeys, uint64_t* expiration = NULL);
 
     /**
      * Get the connected peer ECC public key if the connection uses the
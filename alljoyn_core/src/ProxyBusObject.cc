@@ -46,6 +46,7 @@
 
 #include "AllJoynPeerObj.h"
 #include "BusInternal.h"
+#include "IntrospectionCache.h"
 #include "LocalTransport.h"
 #include "Router.h"
 #include "XmlHelper.h"
@@ -1840,6 +1841,10 @@ QStatus ProxyBusObject::IntrospectRemoteObject(uint32_t timeout)
         AddInterface(*introIntf);
     }
 
+    if (IntrospectFromCache()) {
+        return ER_OK;
+    }
+
     /* Attempt to retrieve introspection from the remote object using sync call */
     Message reply(*internal->bus);
     const InterfaceDescription::Member* introMember = introIntf->GetMember("Introspect");
@@ -1855,7 +1860,7 @@ QStatus ProxyBusObject::IntrospectRemoteObject(uint32_t timeout)
         }
         ident += " : ";
         ident += reply->GetObjectPath();
-        status = ParseXml(reply->GetArg(0)->v_string.str, ident.c_str());
+        status = ParseIntrospection(reply->GetArg(0)->v_string.str, reply->GetSender(), ident.c_str());
     }
     return status;
 }
@@ -1907,7 +1912,7 @@ void ProxyBusObject::IntrospectMethodCB(Message& msg, void* context)
             }
             ident += " : ";
             ident += msg->GetObjectPath();
-            status = ParseXml(xml, ident.c_str());
+            status = ParseIntrospection(xml, msg->GetSender(), ident.c_str());
         }
     } else if (msg->GetErrorName() != NULL && ::strcmp("org.freedesktop.DBus.Error.ServiceUnknown", msg->GetErrorName()) == 0) {
         status = ER_BUS_NO_SUCH_SERVICE;
@@ -1920,16 +1925,74 @@ void ProxyBusObject::IntrospectMethodCB(Message& msg, void* context)
     delete ctx;
 }
 
+bool ProxyBusObject::IntrospectFromCache()
+{
+    /*
+     * A peer that announced the same application as a peer whose object at
+     * this path was introspected before is assumed to return the same XML.
+     */
+    IntrospectionCache& cache = internal->bus->GetInternal().GetIntrospectionCache();
+    if (!cache.IsEnabled()) {
+        return false;
+    }
+    const qcc::String& peer = internal->uniqueName.empty() ? internal->serviceName : internal->uniqueName;
+    std::shared_ptr<const IntrospectionCache::Node> root = cache.Find(cache.GetPeerDigest(peer), internal->path);
+    if (!root) {
+        return false;
+    }
+    XmlHelper xmlHelper(internal->bus, internal->path.c_str());
+    return xmlHelper.AddProxyObjects(*this, *root) == ER_OK;
+}
+
 QStatus ProxyBusObject::ParseXml(const char* xml, const char* ident)
 {
+    return ParseIntrospection(xml, qcc::String::Empty, ident);
+}
+
+QStatus ProxyBusObject::ParseIntrospection(const char* xml, const qcc::String& sender, const char* ident)
+{
+    XmlHelper xmlHelper(internal->bus, ident ? ident : internal->path.c_str());
+    IntrospectionCache& cache = internal->bus->GetInternal().GetIntrospectionCache();
+    std::string digest;
+    std::string peerDigest;
+
+    /*
+     * Peers running the same application return the same XML so look for the
+     * result of parsing it before.  If any of the cached interfaces have gone
+     * away just parse the XML again.
+     */
+    if (cache.IsEnabled()) {
+        digest = IntrospectionCache::GetDigest(xml);
+        if (!sender.empty()) {
+            peerDigest = cache.GetPeerDigest(sender);
+        }
+        std::shared_ptr<const IntrospectionCache::Node> root = cache.Find(digest);
+        if (root) {
+            if (xmlHelper.AddProxyObjects(*this, *root) == ER_OK) {
+                cache.AddObject(peerDigest, internal->path, digest);
+                return ER_OK;
+            }
+            cache.Remove(digest);
+        }
+    }
+
     StringSource source(xml);
 
     /* Parse the XML to update this ProxyBusObject instance (plus any new children and interfaces) */
     XmlParseContext pc(source);
     QStatus status = XmlElement::Parse(pc);
     if (status == ER_OK) {
-        XmlHelper xmlHelper(internal->bus, ident ? ident : internal->path.c_str());
-        status = xmlHelper.AddProxyObjects(*this, pc.GetRoot());
+        if (digest.empty()) {
+            status = xmlHelper.AddProxyObjects(*this, pc.GetRoot());
+        } else {
+            IntrospectionCache::Node root;
+            std::map<qcc::String, qcc::String> interfaces;
+            status = xmlHelper.AddProxyObjects(*this, pc.GetRoot(), root, interfaces);
+            if (status == ER_OK) {
+                cache.Add(digest, root, interfaces);
+                cache.AddObject(peerDigest, internal->path, digest);
+            }
+        }
     }
     return status;
 }
@@ -38,6 +38,7 @@
 #include "LocalTransport.h"
 
 #include "AllJoynPeerObj.h"
+#include "HeaderDictionary.h"
 #include "BusInternal.h"
 
 #ifndef NDEBUG
@@ -53,6 +54,76 @@ namespace ajn {
 
 #define ENDPOINT_IS_DEAD_ALERTCODE  1
 
+/*
+ * Size of the per-connection receive buffer.
+ */
+static const size_t RX_BUFFER_SIZE = 16 * 1024;
+
+/*
+ * Maximum number of queued messages gathered into a single write.
+ */
+static const size_t MAX_GATHERED_WRITES = 16;
+
+/*
+ * Per-connection receive buffer. Each refill reads as many bytes as the
+ * stream has available so a burst of small messages is carved out of a
+ * single read rather than costing two reads per message.
+ */
+class RxBuffer : public qcc::Source {
+  public:
+
+    RxBuffer(qcc::Stream*& stream, volatile bool& noReadAhead) :
+        stream(stream), noReadAhead(noReadAhead), buffer(NULL), head(0), tail(0)
+    {
+    }
+
+    ~RxBuffer()
+    {
+        delete [] buffer;
+    }
+
+    QStatus PullBytes(void* buf, size_t reqBytes, size_t& actualBytes, uint32_t timeout = Event::WAIT_FOREVER)
+    {
+        if (head == tail) {
+            head = tail = 0;
+            /*
+             * Large reads go straight to the caller's buffer. Nothing is read
+             * ahead when Rx is about to pause since the bytes that follow may
+             * no longer belong to the message stream.
+             */
+            if (noReadAhead || (reqBytes >= RX_BUFFER_SIZE)) {
+                return stream->PullBytes(buf, reqBytes, actualBytes, timeout);
+            }
+            if (!buffer) {
+                buffer = new uint8_t[RX_BUFFER_SIZE];
+            }
+            QStatus status = stream->PullBytes(buffer, RX_BUFFER_SIZE, tail, timeout);
+            if (status != ER_OK) {
+                tail = 0;
+                actualBytes = 0;
+                return status;
+            }
+        }
+        actualBytes = (std::min)(reqBytes, tail - head);
+        memcpy(buf, buffer + head, actualBytes);
+        head += actualBytes;
+        return ER_OK;
+    }
+
+    Event& GetSourceEvent() { return stream->GetSourceEvent(); }
+
+  private:
+
+    RxBuffer(const RxBuffer& other);
+    RxBuffer& operator=(const RxBuffer& other);
+
+    qcc::Stream*& stream;
+    volatile bool& noReadAhead;
+    uint8_t* buffer;
+    size_t head;
+    size_t tail;
+};
+
 /*
  * SetState is defined as a macro so that the line number in the debug logs
  * corresponds to the location the state was changed at.
@@ -89,6 +160,7 @@ class _RemoteEndpoint::Internal {
     Internal(BusAttachment& bus, bool incoming, const qcc::String& connectSpec, Stream* stream, const char* threadName, bool isSocket) :
         bus(bus),
         stream(stream),
+        ioDispatch(&bus.GetInternal().GetIODispatch()),
         txQueue(),
         txWaitQueue(),
         lock(LOCK_LEVEL_REMOTEENDPOINT_INTERNAL_LOCK),
@@ -100,6 +172,7 @@ class _RemoteEndpoint::Internal {
         refCount(0),
         isSocket(isSocket),
         armRxPause(false),
+        rxBuffer(this->stream, armRxPause),
         idleTimeoutCount(0),
         maxIdleProbes(0),
         idleTimeout(0),
@@ -116,15 +189,19 @@ class _RemoteEndpoint::Internal {
         sendTimeout(0),
         maxControlMessages(30),
         numControlMessages(0),
-        numDataMessages(0)
+        numDataMessages(0),
+        auth(NULL),
+        headerCompression(false)
     {
     }
 
     ~Internal() {
+        delete auth;
     }
 
     BusAttachment& bus;                      /**< Message bus associated with this endpoint */
     qcc::Stream* stream;                     /**< Stream for this endpoint or NULL if uninitialized */
+    qcc::IODispatch* ioDispatch;             /**< IODispatch reactor servicing the stream */
 
     std::deque<Message> txQueue;             /**< Transmit message queue */
     std::deque<qcc::Thread*> txWaitQueue;    /**< Threads waiting for txQueue to become not-full */
@@ -141,6 +218,7 @@ class _RemoteEndpoint::Internal {
     volatile int32_t refCount;               /**< Number of active users of this remote endpoint */
     bool isSocket;                           /**< True iff this endpoint contains a SockStream as its 'stream' member */
     volatile bool armRxPause;                /**< Pause Rx after receiving next METHOD_REPLY message */
+    RxBuffer rxBuffer;                       /**< Buffers bytes read from the stream once the endpoint is started */
 
     uint32_t idleTimeoutCount;               /**< Number of consecutive idle timeouts */
     uint32_t maxIdleProbes;                  /**< Maximum number of missed idle probes before shutdown */
@@ -157,6 +235,7 @@ class _RemoteEndpoint::Internal {
     bool hasRxSessionMsg;                    /**< true iff this endpoint has previously processed a non-control message */
     bool getNextMsg;                         /**< If true, read the next message from the txQueue */
     Message currentWriteMsg;                 /**< The message currently being read for this endpoint */
+    MessageWriteCursor writeCursor;          /**< Write position of currentWriteMsg on this endpoint */
     State state;                             /**< The state of the stream, protected by lock */
     bool stopAfterTxEmpty;                   /**< True to StopStream() when txQueue is empty */
     set<SessionId> sessionIdSet;                    /**< Set of session Ids that this endpoint is a part of */
@@ -169,6 +248,10 @@ class _RemoteEndpoint::Internal {
                                                   - used on Routing nodes only */
     volatile size_t numControlMessages;      /**< Number of control messages in txQueue - used on Routing nodes only */
     volatile size_t numDataMessages;         /**< Number of data messages in txQueue - used on Routing nodes only */
+    EndpointAuth* auth;                      /**< Authentication in progress for EstablishNonBlocking() */
+    bool headerCompression;                  /**< True if header compression was negotiated with the remote side */
+    HeaderDictionary txDictionary;           /**< Dictionary for the headers of messages sent */
+    HeaderDictionary rxDictionary;           /**< Dictionary for the headers of messages received */
   private:
     Internal& operator=(const Internal&);
 };
@@ -240,6 +323,19 @@ void _RemoteEndpoint::SetRemoteGUID(const qcc::GUID128& remoteGUID)
     }
 }
 
+qcc::Source& _RemoteEndpoint::GetRxSource()
+{
+    /*
+     * Handles must be matched to the message they were sent with so reading
+     * ahead is not possible when handle passing has been negotiated.
+     */
+    if (internal && !GetFeatures().handlePassing) {
+        return internal->rxBuffer;
+    } else {
+        return GetStream();
+    }
+}
+
 qcc::Stream& _RemoteEndpoint::GetStream()
 {
     if (internal) {
@@ -295,6 +391,23 @@ const _RemoteEndpoint::Features&  _RemoteEndpoint::GetFeatures() const
     }
 }
 
+HeaderDictionary* _RemoteEndpoint::GetTxHeaderDictionary()
+{
+    return (internal && internal->headerCompression) ? &internal->txDictionary : NULL;
+}
+
+void _RemoteEndpoint::GetHeaderCompressionStats(uint64_t& txSaved, uint64_t& rxSaved) const
+{
+    uint64_t headerBytes;
+    txSaved = 0;
+    rxSaved = 0;
+    if (internal) {
+        /* The dictionary counters are atomic so no lock is needed */
+        internal->txDictionary.GetStats(headerBytes, txSaved);
+        internal->rxDictionary.GetStats(headerBytes, rxSaved);
+    }
+}
+
 QStatus _RemoteEndpoint::Establish(const qcc::String& authMechanisms, qcc::String& authUsed, qcc::String& redirection, AuthListener* listener, uint32_t timeout)
 {
     QStatus status = ER_OK;
@@ -313,11 +426,52 @@ QStatus _RemoteEndpoint::Establish(const qcc::String& authMechanisms, qcc::Strin
             internal->features.protocolVersion = auth.GetRemoteProtocolVersion();
             internal->features.trusted = (authUsed != "ANONYMOUS");
             internal->features.nameTransfer = (SessionOpts::NameTransferType)auth.GetNameTransfer();
+            internal->headerCompression = internal->features.isBusToBus && auth.IsHeaderCompressionSupported();
         }
     }
     return status;
 }
 
+QStatus _RemoteEndpoint::EstablishNonBlocking(const qcc::String& authMechanisms, qcc::String& authUsed, qcc::String& redirection, AuthListener* listener)
+{
+    if (!internal || minimalEndpoint) {
+        return ER_BUS_NO_ENDPOINT;
+    }
+    if (!internal->auth) {
+        RemoteEndpoint rep = RemoteEndpoint::wrap(this);
+        internal->auth = new EndpointAuth(internal->bus, rep, internal->incoming);
+    }
+
+    QStatus status = internal->auth->EstablishNonBlocking(authMechanisms, authUsed, redirection, listener);
+    if (status == ER_TIMEOUT) {
+        return status;
+    }
+    if (status == ER_OK) {
+        internal->uniqueName = internal->auth->GetUniqueName();
+        internal->remoteName = internal->auth->GetRemoteName();
+        internal->remoteGUID = internal->auth->GetRemoteGUID();
+        internal->features.protocolVersion = internal->auth->GetRemoteProtocolVersion();
+        internal->features.trusted = (authUsed != "ANONYMOUS");
+        internal->features.nameTransfer = (SessionOpts::NameTransferType)internal->auth->GetNameTransfer();
+        internal->headerCompression = internal->features.isBusToBus && internal->auth->IsHeaderCompressionSupported();
+    }
+    /*
+     * The authenticator holds a reference to this endpoint so it must not
+     * outlive the establishment.
+     */
+    AbortEstablish();
+    return status;
+}
+
+void _RemoteEndpoint::AbortEstablish()
+{
+    if (internal) {
+        EndpointAuth* auth = internal->auth;
+        internal->auth = NULL;
+        delete auth;
+    }
+}
+
 QStatus _RemoteEndpoint::SetLinkTimeout(uint32_t& idleTimeout)
 {
     QCC_UNUSED(idleTimeout);
@@ -381,7 +535,7 @@ QStatus _RemoteEndpoint::SetLinkTimeout(uint32_t idleTimeout, uint32_t probeTime
         internal->probeTimeout = probeTimeout;
         internal->maxIdleProbes = maxIdleProbes;
         uint32_t timeout = (internal->idleTimeoutCount == 0) ? internal->idleTimeout : internal->probeTimeout;
-        QStatus status = internal->bus.GetInternal().GetIODispatch().EnableTimeoutCallback(internal->stream, timeout);
+        QStatus status = internal->ioDispatch->EnableTimeoutCallback(internal->stream, timeout);
         internal->lock.Unlock(MUTEX_CONTEXT);
         return status;
     } else {
@@ -416,7 +570,7 @@ QStatus _RemoteEndpoint::SetIdleTimeouts(uint32_t idleTimeout, uint32_t probeTim
     internal->probeTimeout = probeTimeout;
     internal->maxIdleProbes = maxIdleProbes;
     internal->idleTimeoutCount = 0;
-    QStatus status = internal->bus.GetInternal().GetIODispatch().EnableTimeoutCallback(internal->stream, internal->idleTimeout);
+    QStatus status = internal->ioDispatch->EnableTimeoutCallback(internal->stream, internal->idleTimeout);
     internal->lock.Unlock(MUTEX_CONTEXT);
     return status;
 }
@@ -476,19 +630,24 @@ QStatus _RemoteEndpoint::Start(bool enableIdleTimeouts, uint32_t idleTimeout, ui
          */
         internal->stream->SetSendTimeout(0);
 
-        status = internal->bus.GetInternal().GetIODispatch().StartStream(internal->stream, this, this, this, false, true);
+        /*
+         * Spread the streams across the bus's iodispatch reactors. The stream
+         * stays on the chosen reactor until it is stopped.
+         */
+        internal->ioDispatch = &internal->bus.GetInternal().GetLeastLoadedIODispatch();
+        status = internal->ioDispatch->StartStream(internal->stream, this, this, this, false, true);
         if (status != ER_OK) {
             internal->stream->Abort();
             SetState(Internal::STOPPED);
             Invalidate();
         } else {
-            status = internal->bus.GetInternal().GetIODispatch().EnableReadCallback(internal->stream);
+            status = internal->ioDispatch->EnableReadCallback(internal->stream);
             if (status == ER_OK && enableIdleTimeouts) {
                 status = SetIdleTimeouts(idleTimeout, probeTimeout, numProbes);
             }
             if (status != ER_OK) {
                 internal->stream->Abort();
-                internal->bus.GetInternal().GetIODispatch().StopStream(internal->stream);
+                internal->ioDispatch->StopStream(internal->stream);
                 SetState(Internal::EXIT_WAIT);
                 Invalidate();
             }
@@ -552,7 +711,7 @@ QStatus _RemoteEndpoint::Stop(bool stopAfterTxEmpty)
         if (internal->txQueue.empty() && internal->txWaitQueue.empty()) {
             status = internal->stream->Shutdown();
             if ((ER_OK == status) && internal->stopAfterTxEmpty) {
-                internal->bus.GetInternal().GetIODispatch().StopStream(internal->stream);
+                internal->ioDispatch->StopStream(internal->stream);
                 SetState(Internal::EXIT_WAIT);
                 Invalidate();
             }
@@ -564,7 +723,7 @@ QStatus _RemoteEndpoint::Stop(bool stopAfterTxEmpty)
         if (internal->txQueue.empty() && internal->txWaitQueue.empty()) {
             status = internal->stream->Shutdown();
             if (ER_OK == status) {
-                internal->bus.GetInternal().GetIODispatch().StopStream(internal->stream);
+                internal->ioDispatch->StopStream(internal->stream);
                 SetState(Internal::EXIT_WAIT);
                 Invalidate();
             }
@@ -633,7 +792,7 @@ QStatus _RemoteEndpoint::Join(uint32_t maxWaitMs)
     /* Abortively release if we didn't exit before the timeout */
     if ((internal->state != Internal::STOPPED) && ((startTime + maxWaitMs) <= qcc::GetTimestamp())) {
         internal->stream->Abort();
-        internal->bus.GetInternal().GetIODispatch().StopStream(internal->stream);
+        internal->ioDispatch->StopStream(internal->stream);
         SetState(Internal::EXIT_WAIT);
         Invalidate();
         while (internal->state != Internal::STOPPED) {
@@ -796,7 +955,12 @@ QStatus _RemoteEndpoint::ReadCallback(qcc::Source& source, bool isTimedOut)
                 /* Message read complete.  Proceed to unmarshal it. */
                 internal->lock.Lock(MUTEX_CONTEXT);
                 Message msg = internal->currentReadMsg;
-                status = msg->Unmarshal(rep, (internal->validateSender && !bus2bus));
+                if (internal->headerCompression) {
+                    status = internal->rxDictionary.Expand(*msg);
+                }
+                if (status == ER_OK) {
+                    status = msg->Unmarshal(rep, (internal->validateSender && !bus2bus));
+                }
                 switch (status) {
                 case ER_OK:
                     internal->idleTimeoutCount = 0;
@@ -906,7 +1070,7 @@ QStatus _RemoteEndpoint::ReadCallback(qcc::Source& source, bool isTimedOut)
                 /* Check pause condition. */
                 if (internal->armRxPause && (internal->state != Internal::STOPPED) && (msg->GetType() == MESSAGE_METHOD_RET)) {
                     status = ER_BUS_ENDPOINT_CLOSING;
-                    internal->bus.GetInternal().GetIODispatch().DisableReadCallback(internal->stream);
+                    internal->ioDispatch->DisableReadCallback(internal->stream);
                     internal->lock.Unlock(MUTEX_CONTEXT);
                     return ER_OK;
                 }
@@ -919,7 +1083,7 @@ QStatus _RemoteEndpoint::ReadCallback(qcc::Source& source, bool isTimedOut)
 
         internal->lock.Lock(MUTEX_CONTEXT);
         if (status == ER_TIMEOUT) {
-            internal->bus.GetInternal().GetIODispatch().EnableReadCallback(internal->stream, internal->idleTimeout);
+            internal->ioDispatch->EnableReadCallback(internal->stream, internal->idleTimeout);
         } else {
             if ((status != ER_STOPPING_THREAD) && (status != ER_SOCK_OTHER_END_CLOSED) && (status != ER_BUS_STOPPING)) {
                 QCC_DbgPrintf(("Endpoint Rx failed (%s): %s", GetUniqueName().c_str(), QCC_StatusText(status)));
@@ -941,7 +1105,7 @@ QStatus _RemoteEndpoint::ReadCallback(qcc::Source& source, bool isTimedOut)
                  */
                 if (internal->txQueue.empty() && internal->txWaitQueue.empty()) {
                     internal->stream->Shutdown();
-                    internal->bus.GetInternal().GetIODispatch().StopStream(internal->stream);
+                    internal->ioDispatch->StopStream(internal->stream);
                     SetState(Internal::EXIT_WAIT);
                     Invalidate();
                 } else {
@@ -951,7 +1115,7 @@ QStatus _RemoteEndpoint::ReadCallback(qcc::Source& source, bool isTimedOut)
 
             case Internal::OTHER_END_STOP_WAIT:
                 if (internal->txQueue.empty() && internal->txWaitQueue.empty()) {
-                    internal->bus.GetInternal().GetIODispatch().StopStream(internal->stream);
+                    internal->ioDispatch->StopStream(internal->stream);
                     SetState(Internal::EXIT_WAIT);
                     Invalidate();
                 } else {
@@ -1005,7 +1169,7 @@ QStatus _RemoteEndpoint::ReadCallback(qcc::Source& source, bool isTimedOut)
             }
             internal->lock.Lock(MUTEX_CONTEXT);
             uint32_t timeout = (internal->idleTimeoutCount == 0) ? internal->idleTimeout : internal->probeTimeout;
-            internal->bus.GetInternal().GetIODispatch().EnableReadCallback(internal->stream, timeout);
+            internal->ioDispatch->EnableReadCallback(internal->stream, timeout);
             internal->lock.Unlock(MUTEX_CONTEXT);
 
         } else {
@@ -1018,7 +1182,7 @@ QStatus _RemoteEndpoint::ReadCallback(qcc::Source& source, bool isTimedOut)
             QCC_LogError(ER_TIMEOUT, ("Endpoint Rx timed out (%s)", GetUniqueName().c_str()));
             status = ER_BUS_ENDPOINT_CLOSING;
             internal->stream->Abort();
-            internal->bus.GetInternal().GetIODispatch().StopStream(internal->stream);
+            internal->ioDispatch->StopStream(internal->stream);
             SetState(Internal::EXIT_WAIT);
             Invalidate();
         }
@@ -1026,6 +1190,50 @@ QStatus _RemoteEndpoint::ReadCallback(qcc::Source& source, bool isTimedOut)
     return status;
 }
 
+/*
+ * Remove the message at the back of the txQueue once it has been completely
+ * written and wake the first thread waiting for space in the txQueue. Must be
+ * called with the lock held.
+ */
+QStatus _RemoteEndpoint::TxMessageDelivered()
+{
+    QStatus status = ER_OK;
+    if (internal->bus.GetInternal().GetRouter().IsDaemon()) {
+        if (IsControlMessage(internal->txQueue.back())) {
+            QCC_ASSERT(internal->numControlMessages > 0);
+            internal->numControlMessages--;
+        } else {
+            QCC_ASSERT(internal->numDataMessages > 0);
+            internal->numDataMessages--;
+        }
+    }
+    internal->txQueue.pop_back();
+    internal->getNextMsg = true;
+    /* Alert the first one in the txWaitQueue */
+    if (0 < internal->txWaitQueue.size()) {
+        Thread* wakeMe = internal->txWaitQueue.back();
+        status = wakeMe->Alert();
+        if (ER_OK != status) {
+            QCC_LogError(status, ("Failed to alert thread blocked on full tx queue"));
+        }
+    }
+    return status;
+}
+
+/*
+ * Replace a queued message by a private copy with its header compressed for
+ * this link.  The copy stays in the txQueue so a message is only compressed
+ * once however many times it is looked at before it is written.
+ */
+static void CompressQueuedMessage(HeaderDictionary& dictionary, Message& msg)
+{
+    if (!HeaderDictionary::IsCompressed(*msg)) {
+        Message copy(msg, true);
+        dictionary.Compress(*copy);
+        msg = copy;
+    }
+}
+
 /* Note: isTimedOut indicates that this is a timeout alarm. This is used to implement
  * the SendTimeout functionality.
  */
@@ -1046,7 +1254,7 @@ QStatus _RemoteEndpoint::WriteCallback(qcc::Sink& sink, bool isTimedOut)
         QCC_LogError(ER_TIMEOUT, ("Endpoint Tx timed out (%s)", GetUniqueName().c_str()));
         internal->lock.Lock(MUTEX_CONTEXT);
         internal->stream->Abort();
-        internal->bus.GetInternal().GetIODispatch().StopStream(internal->stream);
+        internal->ioDispatch->StopStream(internal->stream);
         SetState(Internal::EXIT_WAIT);
         Invalidate();
         internal->lock.Unlock(MUTEX_CONTEXT);
@@ -1065,14 +1273,22 @@ QStatus _RemoteEndpoint::WriteCallback(qcc::Sink& sink, bool isTimedOut)
         if (internal->getNextMsg) {
             if (!internal->txQueue.empty()) {
                 /*
-                 * Make a deep copy of the message since there is state
-                 * information inside the message.  Each copy of the message
-                 * could be in different write state.
+                 * The write state is kept in the endpoint so the queued
+                 * message can be shared with every other endpoint it was
+                 * pushed to.  A message that still has to be encrypted is
+                 * copied since it is encrypted in place with the keys of
+                 * this particular peer.  The same goes for header compression
+                 * which uses the dictionary of this particular link.
                  */
-                internal->currentWriteMsg = Message(internal->txQueue.back(), true);
+                Message& nextMsg = internal->txQueue.back();
+                if (internal->headerCompression && !nextMsg->encrypt) {
+                    CompressQueuedMessage(internal->txDictionary, nextMsg);
+                }
+                internal->currentWriteMsg = nextMsg->encrypt ? Message(nextMsg, true) : nextMsg;
+                internal->writeCursor = MessageWriteCursor();
                 internal->getNextMsg = false;
             } else {
-                internal->bus.GetInternal().GetIODispatch().DisableWriteCallback(internal->stream);
+                internal->ioDispatch->DisableWriteCallback(internal->stream);
                 if (internal->txWaitQueue.empty()) {
                     switch (internal->state) {
                     case Internal::STARTED:
@@ -1082,7 +1298,7 @@ QStatus _RemoteEndpoint::WriteCallback(qcc::Sink& sink, bool isTimedOut)
                     case Internal::STOP_WAIT:
                         if (internal->txWaitQueue.empty()) {
                             internal->stream->Shutdown();
-                            internal->bus.GetInternal().GetIODispatch().StopStream(internal->stream);
+                            internal->ioDispatch->StopStream(internal->stream);
                             SetState(Internal::EXIT_WAIT);
                             Invalidate();
                         }
@@ -1091,7 +1307,7 @@ QStatus _RemoteEndpoint::WriteCallback(qcc::Sink& sink, bool isTimedOut)
                     case Internal::OTHER_END_STOP_WAIT:
                         internal->stream->Shutdown();
                         if (internal->stopAfterTxEmpty) {
-                            internal->bus.GetInternal().GetIODispatch().StopStream(internal->stream);
+                            internal->ioDispatch->StopStream(internal->stream);
                             SetState(Internal::EXIT_WAIT);
                             Invalidate();
                         }
@@ -1099,7 +1315,7 @@ QStatus _RemoteEndpoint::WriteCallback(qcc::Sink& sink, bool isTimedOut)
 
                     case Internal::STOPPING:
                         internal->stream->Shutdown();
-                        internal->bus.GetInternal().GetIODispatch().StopStream(internal->stream);
+                        internal->ioDispatch->StopStream(internal->stream);
                         SetState(Internal::EXIT_WAIT);
                         Invalidate();
                         break;
@@ -1117,10 +1333,63 @@ QStatus _RemoteEndpoint::WriteCallback(qcc::Sink& sink, bool isTimedOut)
             }
         }
 
+        /*
+         * Plain messages queued behind the current message are gathered into
+         * a single write so a burst of small messages costs one system call.
+         */
+        IOVec iov[MAX_GATHERED_WRITES];
+        size_t numIov = 0;
+        const uint8_t* buf;
+        size_t len;
+        if ((internal->txQueue.size() > 1) && internal->currentWriteMsg->GetUnwrittenBytes(internal->writeCursor, buf, len)) {
+            iov[numIov].buf = reinterpret_cast<char*>(const_cast<uint8_t*>(buf));
+            iov[numIov++].len = len;
+            MessageWriteCursor cursor;
+            for (deque<Message>::reverse_iterator it = internal->txQueue.rbegin() + 1; (it != internal->txQueue.rend()) && (numIov < ArraySize(iov)); ++it) {
+                if (!(*it)->GetUnwrittenBytes(cursor, buf, len)) {
+                    break;
+                }
+                if (internal->headerCompression) {
+                    CompressQueuedMessage(internal->txDictionary, *it);
+                    (*it)->GetUnwrittenBytes(cursor, buf, len);
+                }
+                iov[numIov].buf = reinterpret_cast<char*>(const_cast<uint8_t*>(buf));
+                iov[numIov++].len = len;
+            }
+        }
+
         /* Deliver the message */
         internal->lock.Unlock(MUTEX_CONTEXT);
+        if (numIov > 1) {
+            size_t sent = 0;
+            status = internal->stream->PushBytesV(iov, numIov, sent);
+            internal->lock.Lock(MUTEX_CONTEXT);
+            if (status == ER_OK) {
+                /*
+                 * The gathered messages have no time to live so they stay at
+                 * the back of the txQueue, in order, until they are removed
+                 * here.
+                 */
+                size_t i = 0;
+                while ((status == ER_OK) && (i < numIov) && (sent >= iov[i].len)) {
+                    sent -= iov[i++].len;
+                    status = TxMessageDelivered();
+                }
+                if (i < numIov) {
+                    /* Resume the partially written message on the next write */
+                    if (i > 0) {
+                        internal->currentWriteMsg = internal->txQueue.back();
+                        internal->getNextMsg = false;
+                    }
+                    internal->writeCursor.state = MESSAGE_HEADER_BODY;
+                    internal->writeCursor.ptr = reinterpret_cast<const uint8_t*>(iov[i].buf) + sent;
+                    internal->writeCursor.count = iov[i].len - sent;
+                }
+            }
+            continue;
+        }
         RemoteEndpoint rep = RemoteEndpoint::wrap(this);
-        status = internal->currentWriteMsg->DeliverNonBlocking(rep);
+        status = internal->currentWriteMsg->DeliverNonBlocking(rep, internal->writeCursor);
         /* Report authorization failure as a security violation */
         if ((status == ER_BUS_NOT_AUTHORIZED) || (status == ER_PERMISSION_DENIED)) {
             internal->bus.GetInternal().GetLocalEndpoint()->GetPeerObj()->HandleSecurityViolation(internal->currentWriteMsg, status);
@@ -1136,25 +1405,7 @@ QStatus _RemoteEndpoint::WriteCallback(qcc::Sink& sink, bool isTimedOut)
         internal->lock.Lock(MUTEX_CONTEXT);
         if (status == ER_OK) {
             /* Message has been successfully delivered. i.e. PushBytes is complete */
-            internal->txQueue.pop_back();
-            internal->getNextMsg = true;
-            if (internal->bus.GetInternal().GetRouter().IsDaemon()) {
-                if (IsControlMessage(internal->currentWriteMsg)) {
-                    QCC_ASSERT(internal->numControlMessages > 0);
-                    internal->numControlMessages--;
-                } else {
-                    QCC_ASSERT(internal->numDataMessages > 0);
-                    internal->numDataMessages--;
-                }
-            }
-            /* Alert the first one in the txWaitQueue */
-            if (0 < internal->txWaitQueue.size()) {
-                Thread* wakeMe = internal->txWaitQueue.back();
-                status = wakeMe->Alert();
-                if (ER_OK != status) {
-                    QCC_LogError(status, ("Failed to alert thread blocked on full tx queue"));
-                }
-            }
+            status = TxMessageDelivered();
         }
     }
 
@@ -1163,7 +1414,7 @@ QStatus _RemoteEndpoint::WriteCallback(qcc::Sink& sink, bool isTimedOut)
          * Timed-out in the middle of a message write.  Re-enable the write
          * callback after a send timeout.
          */
-        internal->bus.GetInternal().GetIODispatch().EnableWriteCallback(internal->stream, internal->sendTimeout);
+        internal->ioDispatch->EnableWriteCallback(internal->stream, internal->sendTimeout);
     } else if (status != ER_OK) {
         /* On an unexpected disconnect save the status that cause the thread exit */
         if (disconnectStatus == ER_OK) {
@@ -1173,7 +1424,7 @@ QStatus _RemoteEndpoint::WriteCallback(qcc::Sink& sink, bool isTimedOut)
             QCC_LogError(status, ("Endpoint Tx failed (%s)", GetUniqueName().c_str()));
         }
         internal->stream->Abort();
-        internal->bus.GetInternal().GetIODispatch().StopStream(internal->stream);
+        internal->ioDispatch->StopStream(internal->stream);
         SetState(Internal::EXIT_WAIT);
         Invalidate();
     }
@@ -1195,12 +1446,12 @@ QStatus _RemoteEndpoint::PushMessageRouter(Message& msg, size_t& count)
             internal->txQueue.push_front(msg);
             internal->numControlMessages++;
             if (wasEmpty) {
-                internal->bus.GetInternal().GetIODispatch().EnableWriteCallbackNow(internal->stream);
+                internal->ioDispatch->EnableWriteCallbackNow(internal->stream);
             }
         } else {
             QCC_LogError(ER_BUS_ENDPOINT_CLOSING, ("Endpoint Tx failed (%s)", GetUniqueName().c_str()));
             internal->stream->Abort();
-            internal->bus.GetInternal().GetIODispatch().StopStream(internal->stream);
+            internal->ioDispatch->StopStream(internal->stream);
             SetState(Internal::EXIT_WAIT);
             Invalidate();
             status = ER_BUS_ENDPOINT_CLOSING;
@@ -1233,7 +1484,10 @@ QStatus _RemoteEndpoint::PushMessageRouter(Message& msg, size_t& count)
                     deque<Message>::iterator it = internal->txQueue.begin();
                     while (it != internal->txQueue.end()) {
                         uint32_t expMs;
-                        if ((*it)->IsExpired(&expMs)) {
+                        if (HeaderDictionary::IsCompressed(**it)) {
+                            /* A message compressed for this link has updated the dictionary so it must be sent */
+                            ++it;
+                        } else if ((*it)->IsExpired(&expMs)) {
                             if (IsControlMessage(*it)) {
                                 QCC_ASSERT(internal->numControlMessages > 0);
                                 internal->numControlMessages--;
@@ -1313,7 +1567,7 @@ QStatus _RemoteEndpoint::PushMessageRouter(Message& msg, size_t& count)
         }
 
         if (wasEmpty && (status == ER_OK)) {
-            internal->bus.GetInternal().GetIODispatch().EnableWriteCallbackNow(internal->stream);
+            internal->ioDispatch->EnableWriteCallbackNow(internal->stream);
         }
     }
     internal->lock.Unlock(MUTEX_CONTEXT);
@@ -1355,7 +1609,10 @@ QStatus _RemoteEndpoint::PushMessageLeaf(Message& msg, size_t& count)
                 deque<Message>::iterator it = internal->txQueue.begin();
                 while (it != internal->txQueue.end()) {
                     uint32_t expMs;
-                    if ((*it)->IsExpired(&expMs)) {
+                    if (HeaderDictionary::IsCompressed(**it)) {
+                        /* A message compressed for this link has updated the dictionary so it must be sent */
+                        ++it;
+                    } else if ((*it)->IsExpired(&expMs)) {
                         internal->txQueue.erase(it);
                         break;
                     } else {
@@ -1426,7 +1683,7 @@ QStatus _RemoteEndpoint::PushMessageLeaf(Message& msg, size_t& count)
     }
 
     if (wasEmpty && (status == ER_OK)) {
-        internal->bus.GetInternal().GetIODispatch().EnableWriteCallbackNow(internal->stream);
+        internal->ioDispatch->EnableWriteCallbackNow(internal->stream);
     }
     internal->lock.Unlock(MUTEX_CONTEXT);
     return status;
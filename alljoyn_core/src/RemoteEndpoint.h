@@ -40,6 +40,7 @@
 namespace ajn {
 
 class _RemoteEndpoint;
+class HeaderDictionary;
 
 /**
  * Managed object type that wraps a remote endpoint
@@ -299,6 +300,24 @@ class _RemoteEndpoint : public _BusEndpoint, public qcc::ThreadListener, public
      */
     uint32_t GetRemoteAllJoynVersion() const { return GetFeatures().ajVersion; }
 
+    /**
+     * Get the dictionary used to compress the header fields of messages sent on
+     * this endpoint.
+     *
+     * @return  - The transmit dictionary
+     *          - NULL if header compression was not negotiated with the remote side
+     */
+    HeaderDictionary* GetTxHeaderDictionary();
+
+    /**
+     * Get the header compression statistics for this endpoint.  This may be
+     * called with any lock held.
+     *
+     * @param[out] txSaved  Bytes saved by compressing the headers of messages sent.
+     * @param[out] rxSaved  Bytes saved by compressing the headers of messages received.
+     */
+    void GetHeaderCompressionStats(uint64_t& txSaved, uint64_t& rxSaved) const;
+
     /**
      * Establish a connection.
      *
@@ -317,6 +336,32 @@ class _RemoteEndpoint : public _BusEndpoint, public qcc::ThreadListener, public
      */
     QStatus Establish(const qcc::String& authMechanisms, qcc::String& authUsed, qcc::String& redirection, AuthListener* listener = NULL, uint32_t timeout = qcc::Event::WAIT_FOREVER);
 
+    /**
+     * Establish the accepting side of a connection without blocking.  Call
+     * this each time the endpoint's source has data available until it
+     * returns something other than ER_TIMEOUT.
+     *
+     * @param[in] authMechanisms  The authentication mechanism(s) to use.
+     * @param[out] authUsed    Returns the name of the authentication method
+     *                         that was used to establish the connection.
+     * @param[out] redirection Returns a redirection address for the endpoint. This value
+     *                         is only meaninful if the return status is ER_BUS_ENDPOINT_REDIRECT.
+     * @param[in] listener     Optional authentication listener
+     *
+     * @return
+     *      - ER_OK if successful.
+     *      - ER_TIMEOUT if more data is needed from the remote side.
+     *      = ER_BUS_ENDPOINT_REDIRECT if the endpoint is being redirected.
+     *      - An error status otherwise
+     */
+    QStatus EstablishNonBlocking(const qcc::String& authMechanisms, qcc::String& authUsed, qcc::String& redirection, AuthListener* listener = NULL);
+
+    /**
+     * Abandon an EstablishNonBlocking() that has not completed, releasing the
+     * state it holds.  Does nothing if no establishment is in progress.
+     */
+    void AbortEstablish();
+
     /**
      * Get the GUID of the remote side of a bus-to-bus endpoint.
      *
@@ -367,6 +412,15 @@ class _RemoteEndpoint : public _BusEndpoint, public qcc::ThreadListener, public
      */
     qcc::Source& GetSource() { return GetStream(); }
 
+    /**
+     * Get the data source that messages are read from once the endpoint has
+     * been started. Reads from this source are buffered so that several
+     * messages can be parsed from a single read of the underlying stream.
+     *
+     * @return  The receive source for this endpoint.
+     */
+    qcc::Source& GetRxSource();
+
     /**
      * Get the data sink for this endpoint
      *
@@ -571,6 +625,14 @@ class _RemoteEndpoint : public _BusEndpoint, public qcc::ThreadListener, public
      */
     _RemoteEndpoint& operator=(const _RemoteEndpoint& other);
 
+    /**
+     * Remove the completely written message at the back of the tx queue.
+     * Must be called with the internal lock held.
+     *
+     * @return ER_OK if successful.
+     */
+    QStatus TxMessageDelivered();
+
     /**
      * Helper for common behavior of Start() and Start(uint32_t, uint32_t, uint32_t, uint32_t).
      *
@@ -45,10 +45,10 @@ class TransportList : public TransportListener {
      *
      * @param bus               The bus associated with this transport list.
      * @param factory           TransportFactoryContainer telling the list how to create its Transports.
-     * @param m_ioDispatch      The IODispatch for this bus.
+     * @param ioDispatchers     The IODispatch reactors for this bus.
      * @param concurrency       The maximum number of concurrent method and signal handlers locally executing.
      */
-    TransportList(BusAttachment& bus, TransportFactoryContainer& factories, qcc::IODispatch* m_ioDispatch, uint32_t concurrency);
+    TransportList(BusAttachment& bus, TransportFactoryContainer& factories, std::vector<qcc::IODispatch*>& ioDispatchers, uint32_t concurrency);
 
     /** Destructor  */
     virtual ~TransportList();
@@ -166,7 +166,7 @@ class TransportList : public TransportListener {
     TransportFactoryContainer& m_factories;         /**< container for transport factories */
     bool isStarted;                                 /**< true iff transports are running */
     bool isInitialized;                             /**< true iff transportlist is initialized */
-    qcc::IODispatch* m_ioDispatch;                  /**< pointer to the iodispatch for this bus */
+    std::vector<qcc::IODispatch*>& m_ioDispatchers; /**< the iodispatch reactors for this bus */
 };
 
 }  /* namespace */
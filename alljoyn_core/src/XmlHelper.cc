@@ -61,7 +61,21 @@ const qcc::String& GetSecureAnnotation(const XmlElement* elem)
     return qcc::String::Empty;
 }
 
-QStatus XmlHelper::ParseInterface(const XmlElement* elem, ProxyBusObject* obj)
+/*
+ * Record an interface added to a proxy object for the introspection cache.
+ */
+void XmlHelper::RecordInterface(const XmlElement* elem, IntrospectionCache::Node* node)
+{
+    if (node) {
+        const qcc::String& ifName = elem->GetAttribute("name");
+        node->interfaces.push_back(ifName);
+        if (interfaceXml && (interfaceXml->find(ifName) == interfaceXml->end())) {
+            (*interfaceXml)[ifName] = elem->Generate();
+        }
+    }
+}
+
+QStatus XmlHelper::ParseInterface(const XmlElement* elem, ProxyBusObject* obj, IntrospectionCache::Node* node)
 {
     QStatus status = ER_OK;
     InterfaceSecurityPolicy secPolicy;
@@ -349,6 +363,7 @@ QStatus XmlHelper::ParseInterface(const XmlElement* elem, ProxyBusObject* obj)
             newIntf->Activate();
             if (obj) {
                 obj->AddInterface(*newIntf);
+                RecordInterface(elem, node);
             }
         } else if (ER_BUS_IFACE_ALREADY_EXISTS == status) {
             /* Make sure definition matches existing one */
@@ -357,6 +372,7 @@ QStatus XmlHelper::ParseInterface(const XmlElement* elem, ProxyBusObject* obj)
                 if (*existingIntf == intf) {
                     if (obj) {
                         obj->AddInterface(*existingIntf);
+                        RecordInterface(elem, node);
                     }
                     status = ER_OK;
                 } else {
@@ -374,7 +390,7 @@ QStatus XmlHelper::ParseInterface(const XmlElement* elem, ProxyBusObject* obj)
     return status;
 }
 
-QStatus XmlHelper::ParseNode(const XmlElement* root, ProxyBusObject* obj)
+QStatus XmlHelper::ParseNode(const XmlElement* root, ProxyBusObject* obj, IntrospectionCache::Node* node)
 {
     QStatus status = ER_OK;
 
@@ -384,6 +400,9 @@ QStatus XmlHelper::ParseNode(const XmlElement* root, ProxyBusObject* obj)
         if (obj) {
             obj->SetSecure(true);
         }
+        if (node) {
+            node->secure = true;
+        }
     }
     /* Iterate over <interface> and <node> elements */
     const vector<XmlElement*>& rootChildren = root->GetChildren();
@@ -392,7 +411,7 @@ QStatus XmlHelper::ParseNode(const XmlElement* root, ProxyBusObject* obj)
         const XmlElement* elem = *it++;
         const qcc::String& elemName = elem->GetName();
         if (elemName == "interface") {
-            status = ParseInterface(elem, obj);
+            status = ParseInterface(elem, obj, node);
         } else if (elemName == "node") {
             if (obj) {
                 const qcc::String& relativePath = elem->GetAttribute("name");
@@ -402,13 +421,19 @@ QStatus XmlHelper::ParseNode(const XmlElement* root, ProxyBusObject* obj)
                 }
                 childObjPath += relativePath;
                 if (!relativePath.empty() && IsLegalObjectPath(childObjPath.c_str())) {
+                    IntrospectionCache::Node* childNode = NULL;
+                    if (node) {
+                        node->children.push_back(IntrospectionCache::Node());
+                        childNode = &node->children.back();
+                        childNode->name = relativePath;
+                    }
                     /* Check for existing child with the same name. Use this child if found, otherwise create a new one */
                     ProxyBusObject* childObj = obj->GetChild(relativePath.c_str());
                     if (childObj) {
-                        status = ParseNode(elem, childObj);
+                        status = ParseNode(elem, childObj, childNode);
                     } else {
                         ProxyBusObject newChild(*bus, obj->GetServiceName().c_str(), obj->GetUniqueName().c_str(), childObjPath.c_str(), obj->GetSessionId(), obj->IsSecure());
-                        status = ParseNode(elem, &newChild);
+                        status = ParseNode(elem, &newChild, childNode);
                         if (ER_OK == status) {
                             obj->AddChild(newChild);
                         }
@@ -428,4 +453,43 @@ QStatus XmlHelper::ParseNode(const XmlElement* root, ProxyBusObject* obj)
     return status;
 }
 
+QStatus XmlHelper::ApplyNode(const IntrospectionCache::Node& node, ProxyBusObject* obj)
+{
+    QStatus status = ER_OK;
+
+    if (node.secure) {
+        obj->SetSecure(true);
+    }
+    for (vector<qcc::String>::const_iterator it = node.interfaces.begin(); it != node.interfaces.end(); ++it) {
+        const InterfaceDescription* intf = bus->GetInterface(it->c_str());
+        if (!intf) {
+            status = ER_BUS_NO_SUCH_INTERFACE;
+            QCC_DbgPrintf(("Cached interface \"%s\" for %s is no longer registered", it->c_str(), ident));
+            return status;
+        }
+        obj->AddInterface(*intf);
+    }
+    vector<IntrospectionCache::Node>::const_iterator it = node.children.begin();
+    while ((ER_OK == status) && (it != node.children.end())) {
+        const IntrospectionCache::Node& child = *it++;
+        qcc::String childObjPath = obj->GetPath();
+        if (childObjPath.size() > 1) {
+            childObjPath += '/';
+        }
+        childObjPath += child.name;
+        /* Check for existing child with the same name. Use this child if found, otherwise create a new one */
+        ProxyBusObject* childObj = obj->GetChild(child.name.c_str());
+        if (childObj) {
+            status = ApplyNode(child, childObj);
+        } else {
+            ProxyBusObject newChild(*bus, obj->GetServiceName().c_str(), obj->GetUniqueName().c_str(), childObjPath.c_str(), obj->GetSessionId(), obj->IsSecure());
+            status = ApplyNode(child, &newChild);
+            if (ER_OK == status) {
+                obj->AddChild(newChild);
+            }
+        }
+    }
+    return status;
+}
+
 } // ajn::
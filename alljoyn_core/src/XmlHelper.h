@@ -37,6 +37,8 @@
 
 #include <alljoyn/Status.h>
 
+#include "IntrospectionCache.h"
+
 namespace ajn {
 
 /**
@@ -45,7 +47,7 @@ namespace ajn {
 class XmlHelper {
   public:
 
-    XmlHelper(BusAttachment* bus, const char* ident) : bus(bus), ident(ident) { }
+    XmlHelper(BusAttachment* bus, const char* ident) : bus(bus), ident(ident), interfaceXml(NULL) { }
 
     /**
      * Traverse the XML tree adding all interfaces to the bus. Nodes are ignored.
@@ -85,13 +87,56 @@ class XmlHelper {
         }
     }
 
+    /**
+     * Same as AddProxyObjects() above but also record the parsed form of the
+     * XML so it can be added to the introspection cache.
+     *
+     * @param parent            The parent proxy object to add the children too.
+     * @param root              The root must be a <node> element.
+     * @param[out] node         Returns the interfaces and children of the root node.
+     * @param[out] interfaces   Returns the XML of the interfaces added to the proxy objects.
+     *
+     * @return #ER_OK if the XML was well formed and the children were added.
+     *         #ER_BUS_BAD_XML if the XML was not as expected.
+     *         #Other errors indicating the children were not succesfully added.
+     */
+    QStatus AddProxyObjects(ProxyBusObject& parent, const qcc::XmlElement* root, IntrospectionCache::Node& node, std::map<qcc::String, qcc::String>& interfaces) {
+        if (root && (root->GetName() == "node")) {
+            interfaceXml = &interfaces;
+            QStatus status = ParseNode(root, &parent, &node);
+            interfaceXml = NULL;
+            return status;
+        } else {
+            return ER_BUS_BAD_XML;
+        }
+    }
+
+    /**
+     * Add the interfaces and children of a node from the introspection cache
+     * to a proxy object.  The interfaces must already be registered with the
+     * bus attachment.
+     *
+     * @param parent  The parent proxy object to add the children too.
+     * @param node    The cached root node.
+     *
+     * @return #ER_OK if the children were added.
+     *         #ER_BUS_NO_SUCH_INTERFACE if an interface is not registered.
+     *         #Other errors indicating the children were not succesfully added.
+     */
+    QStatus AddProxyObjects(ProxyBusObject& parent, const IntrospectionCache::Node& node) {
+        return ApplyNode(node, &parent);
+    }
+
   private:
 
-    QStatus ParseNode(const qcc::XmlElement* elem, ProxyBusObject* obj);
-    QStatus ParseInterface(const qcc::XmlElement* elem, ProxyBusObject* obj);
+    QStatus ParseNode(const qcc::XmlElement* elem, ProxyBusObject* obj, IntrospectionCache::Node* node = NULL);
+    QStatus ParseInterface(const qcc::XmlElement* elem, ProxyBusObject* obj, IntrospectionCache::Node* node = NULL);
+    QStatus ApplyNode(const IntrospectionCache::Node& node, ProxyBusObject* obj);
+    void RecordInterface(const qcc::XmlElement* elem, IntrospectionCache::Node* node);
 
     BusAttachment* bus;
     const char* ident;
+    std::map<qcc::String, qcc::String>* interfaceXml;
 };
 }
 
@@ -76,7 +76,7 @@ class DefaultKeyStoreListener : public KeyStoreListener {
 
   public:
 
-    DefaultKeyStoreListener(const qcc::String& application, const char* fname) : fileName(GetDefaultKeyStoreFileName(application.c_str(), fname)), fileLocker(fileName.c_str())
+    DefaultKeyStoreListener(const qcc::String& application, const char* fname) : fileName(GetDefaultKeyStoreFileName(application.c_str(), fname)), fileLocker(fileName.c_str()), haveSnapshotHeader(false)
     {
         FileLock readLock;
         /* 'readLock' is released when goes out of scope. */
@@ -121,9 +121,30 @@ class DefaultKeyStoreListener : public KeyStoreListener {
             FileSource* source = readLock.GetSource();
             QCC_ASSERT(source != nullptr);
             if (source != nullptr) {
-                status = keyStore.Pull(*source, fileLocker.GetFileName());
+                /*
+                 * If the snapshot at the start of the file is the one the keys
+                 * were last loaded from or stored to only the journal records
+                 * that have been appended since then need to be read.
+                 */
+                if (IsSnapshotUnchanged(*source, keyStore) && (source->Seek(keyStore.GetPersistentSize()) == ER_OK)) {
+                    status = keyStore.PullJournal(*source);
+                    if (status == ER_OK) {
+                        QCC_DbgHLPrintf(("Read key store journal from %s", fileLocker.GetFileName()));
+                        return status;
+                    }
+                }
+                haveSnapshotHeader = false;
+                status = source->Seek(0);
+                if (status == ER_OK) {
+                    status = keyStore.Pull(*source, fileLocker.GetFileName());
+                }
                 if (status == ER_OK) {
                     QCC_DbgHLPrintf(("Read key store from %s", fileLocker.GetFileName()));
+                    if (source->Seek(0) == ER_OK) {
+                        size_t pulled = 0;
+                        haveSnapshotHeader = (source->PullBytes(snapshotHeader, sizeof(snapshotHeader), pulled) == ER_OK) &&
+                                             (pulled == sizeof(snapshotHeader));
+                    }
                 }
             } else {
                 status = ER_OS_ERROR;
@@ -160,12 +181,29 @@ class DefaultKeyStoreListener : public KeyStoreListener {
         FileLock writeLock;
         QStatus status = fileLocker.GetFileLockForWrite(&writeLock);
         if (status == ER_OK) {
+            /*
+             * Append the changes to the file as a journal record unless the
+             * key store asks for a new snapshot of all of the keys.
+             */
             BufferSink buffer;
-            status = keyStore.Push(buffer);
+            bool append = true;
+            status = keyStore.PushJournal(buffer);
+            if (status == ER_BUS_NOT_ALLOWED) {
+                append = false;
+                status = keyStore.Push(buffer);
+            }
             if (status != ER_OK) {
                 QCC_LogError(status, ("StoreRequest error during data buffering"));
                 return status;
             }
+            haveSnapshotHeader = false;
+            if (append) {
+                status = writeLock.GetSource()->Seek(keyStore.GetPersistentSize() - buffer.GetBuffer().size());
+                if (status != ER_OK) {
+                    QCC_LogError(status, ("StoreRequest error during seek to end of journal"));
+                    return status;
+                }
+            }
             size_t pushed = 0;
             status = writeLock.GetSink()->PushBytes(buffer.GetBuffer().data(), buffer.GetBuffer().size(), pushed);
             if (status != ER_OK) {
@@ -180,6 +218,12 @@ class DefaultKeyStoreListener : public KeyStoreListener {
             if (!writeLock.GetSink()->Truncate()) {
                 QCC_LogError(ER_WARNING, ("FileSink::Truncate failed"));
             }
+            if (append) {
+                haveSnapshotHeader = true;
+            } else if (buffer.GetBuffer().size() >= sizeof(snapshotHeader)) {
+                memcpy(snapshotHeader, buffer.GetBuffer().data(), sizeof(snapshotHeader));
+                haveSnapshotHeader = true;
+            }
             QCC_DbgHLPrintf(("Wrote key store to %s", fileLocker.GetFileName()));
         } else {
             QCC_LogError(status, ("Failed to store request - write lock has not been taken, status=(%#x)", status));
@@ -190,8 +234,32 @@ class DefaultKeyStoreListener : public KeyStoreListener {
 
   private:
 
+    /**
+     * Check if the snapshot at the start of the key store file is still the one
+     * the keys were last loaded from or stored to and that the file holds all of
+     * the journal records the keys were loaded from or stored to since then.
+     */
+    bool IsSnapshotUnchanged(FileSource& source, KeyStore& keyStore)
+    {
+        if (!haveSnapshotHeader) {
+            return false;
+        }
+        int64_t fileSize = 0;
+        if ((source.GetSize(fileSize) != ER_OK) || (fileSize < static_cast<int64_t>(keyStore.GetPersistentSize()))) {
+            return false;
+        }
+        uint8_t header[sizeof(snapshotHeader)];
+        size_t pulled = 0;
+        if ((source.Seek(0) != ER_OK) || (source.PullBytes(header, sizeof(header), pulled) != ER_OK) || (pulled != sizeof(header))) {
+            return false;
+        }
+        return memcmp(header, snapshotHeader, sizeof(header)) == 0;
+    }
+
     qcc::String fileName;
     FileLocker fileLocker;
+    uint8_t snapshotHeader[22];     /**< Version, revision and GUID at the start of the last snapshot read or written */
+    bool haveSnapshotHeader;        /**< True if snapshotHeader is valid */
 };
 
 KeyStoreListener* KeyStoreListenerFactory::CreateInstance(const qcc::String& application, const char* fname)
@@ -0,0 +1,106 @@
+/**
+ * @file
+ *
+ * Convert a binary trace file written when ER_DEBUG_TRACEFILE is set to text.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <qcc/Debug.h>
+#include <qcc/StaticGlobals.h>
+#include <qcc/String.h>
+#include <qcc/TraceRing.h>
+
+#include <Status.h>
+
+using namespace qcc;
+
+struct DumpContext {
+    const char* module;
+    size_t count;
+};
+
+static void DumpMessage(DbgMsgType type, const char* module, const char* msg, void* context)
+{
+    QCC_UNUSED(type);
+    DumpContext* dump = reinterpret_cast<DumpContext*>(context);
+    if (!dump->module || (strcmp(dump->module, module) == 0)) {
+        fputs(msg, stdout);
+        ++dump->count;
+    }
+}
+
+static void Usage()
+{
+    printf("Usage: ajtracedump [-h] [-m <module>] <trace file>\n\n");
+    printf("Options:\n");
+    printf("   -h          = Print this help message\n");
+    printf("   -m <module> = Only print messages from <module>\n");
+}
+
+int CDECL_CALL main(int argc, char** argv)
+{
+    DumpContext dump = { NULL, 0 };
+    const char* fileName = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        if (0 == strcmp("-h", argv[i])) {
+            Usage();
+            return 0;
+        } else if (0 == strcmp("-m", argv[i])) {
+            if (++i == argc) {
+                printf("option %s requires a parameter\n", argv[i - 1]);
+                Usage();
+                return 1;
+            }
+            dump.module = argv[i];
+        } else if (!fileName) {
+            fileName = argv[i];
+        } else {
+            Usage();
+            return 1;
+        }
+    }
+    if (!fileName) {
+        Usage();
+        return 1;
+    }
+
+    /* Initializing with ER_DEBUG_TRACEFILE set would overwrite the trace file */
+    if (getenv("ER_DEBUG_TRACEFILE")) {
+        printf("Unset ER_DEBUG_TRACEFILE before running ajtracedump\n");
+        return 1;
+    }
+    QStatus status = qcc::Init();
+    if (status != ER_OK) {
+        printf("qcc::Init failed (%s)\n", QCC_StatusText(status));
+        return 1;
+    }
+
+    status = TraceRing::Decode(fileName, DumpMessage, &dump);
+    if (status != ER_OK) {
+        fprintf(stderr, "Failed to decode %s after %u messages (%s)\n", fileName, static_cast<unsigned int>(dump.count), QCC_StatusText(status));
+    }
+
+    qcc::Shutdown();
+    return (status == ER_OK) ? 0 : 1;
+}
@@ -0,0 +1,418 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+/*
+ * Reports how many received messages per second can be read with the MsgArgs
+ * built by Message::GetArgs() and with a MsgArgView, for a few common
+ * signatures.  Both paths unmarshal the same message body and read every value.
+ * The view is read from a body unmarshaled with the MsgArgs deferred, as it is
+ * for members added with MEMBER_ANNOTATE_ARG_VIEW.  The cost of unmarshaling
+ * alone is reported too, so the GetArgs() figures of two builds can be compared
+ * to see what a change to unmarshaling costs.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <queue>
+#include <vector>
+
+#include <qcc/Pipe.h>
+#include <qcc/String.h>
+#include <qcc/StringUtil.h>
+#include <qcc/time.h>
+#include <alljoyn/BusAttachment.h>
+#include <alljoyn/Init.h>
+#include <alljoyn/Message.h>
+#include <alljoyn/MsgArgView.h>
+#include <alljoyn/Status.h>
+
+/* Private files included for access to the wire format */
+#include <RemoteEndpoint.h>
+
+using namespace qcc;
+using namespace ajn;
+
+static uint32_t duration = 1000;
+
+static void CHECK(QStatus status, const char* what)
+{
+    if (status != ER_OK) {
+        printf("%s failed: %s\n", what, QCC_StatusText(status));
+        exit(1);
+    }
+}
+
+static void Report(const char* name, uint32_t ops, uint64_t elapsed)
+{
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+    printf("%-36s %8u ops in %5u ms  %10.1f ops/sec\n", name, ops, (uint32_t)elapsed, (ops * 1000.0) / elapsed);
+}
+
+/* Run op until the configured duration has elapsed. */
+#define BENCH(name, op)                                        \
+    do {                                                       \
+        uint32_t ops = 0;                                      \
+        uint64_t start = GetTimestamp64();                     \
+        uint64_t elapsed;                                      \
+        do {                                                   \
+            op;                                                \
+            ++ops;                                             \
+            elapsed = GetTimestamp64() - start;                \
+        } while (elapsed < duration);                          \
+        Report(name, ops, elapsed);                            \
+    } while (0)
+
+class TestPipe : public qcc::Pipe {
+  public:
+    TestPipe() : qcc::Pipe() { }
+
+    QStatus PullBytesAndFds(void* buf, size_t reqBytes, size_t& actualBytes, SocketFd* fdList, size_t& numFds, uint32_t timeout = Event::WAIT_FOREVER)
+    {
+        QCC_UNUSED(fdList);
+        QCC_UNUSED(timeout);
+        numFds = 0;
+        return PullBytes(buf, reqBytes, actualBytes);
+    }
+
+    QStatus PushBytesAndFds(const void* buf, size_t numBytes, size_t& numSent, SocketFd* fdList, size_t numFds, uint32_t pid = (uint32_t)-1)
+    {
+        QCC_UNUSED(fdList);
+        QCC_UNUSED(numFds);
+        QCC_UNUSED(pid);
+        return PushBytes(buf, numBytes, numSent);
+    }
+};
+
+class BenchMessage : public _Message {
+  public:
+    BenchMessage(BusAttachment& bus) : _Message(bus) { }
+
+    BenchMessage(const BenchMessage& other) : _Message(other) { }
+
+    QStatus MethodCall(const MsgArg* argList, size_t numArgs)
+    {
+        qcc::String sig = MsgArg::Signature(argList, numArgs);
+        return CallMsg(sig, ":1.1", 0, "/org/alljoyn/bench", "org.alljoyn.Bench", "Method", argList, numArgs, 0);
+    }
+
+    QStatus Receive(BusAttachment& bus, BenchMessage& msg)
+    {
+        TestPipe stream;
+        TestPipe* pStream = &stream;
+        static const bool falsiness = false;
+        RemoteEndpoint ep(bus, falsiness, String::Empty, pStream);
+        QStatus status = msg.Deliver(ep);
+        if (status == ER_OK) {
+            status = Read(ep, true);
+        }
+        if (status == ER_OK) {
+            status = Unmarshal(ep, true);
+        }
+        return status;
+    }
+
+    QStatus UnmarshalBody(bool deferArgs = false) { return UnmarshalArgs("*", NULL, deferArgs); }
+};
+
+static uint64_t sum;
+
+/*
+ * Readers for the MsgArgs built by GetArgs()
+ */
+static void SumArg(const MsgArg& arg)
+{
+    switch (arg.typeId) {
+    case ALLJOYN_BOOLEAN:
+        sum += arg.v_bool;
+        break;
+
+    case ALLJOYN_INT32:
+        sum += arg.v_int32;
+        break;
+
+    case ALLJOYN_UINT32:
+        sum += arg.v_uint32;
+        break;
+
+    case ALLJOYN_DOUBLE:
+        sum += (uint64_t)arg.v_double;
+        break;
+
+    case ALLJOYN_STRING:
+        sum += arg.v_string.len;
+        break;
+
+    case ALLJOYN_INT32_ARRAY:
+        for (size_t i = 0; i < arg.v_scalarArray.numElements; ++i) {
+            sum += arg.v_scalarArray.v_int32[i];
+        }
+        break;
+
+    case ALLJOYN_VARIANT:
+        SumArg(*arg.v_variant.val);
+        break;
+
+    case ALLJOYN_DICT_ENTRY:
+        SumArg(*arg.v_dictEntry.key);
+        SumArg(*arg.v_dictEntry.val);
+        break;
+
+    case ALLJOYN_STRUCT:
+        for (size_t i = 0; i < arg.v_struct.numMembers; ++i) {
+            SumArg(arg.v_struct.members[i]);
+        }
+        break;
+
+    case ALLJOYN_ARRAY:
+        for (size_t i = 0; i < arg.v_array.GetNumElements(); ++i) {
+            SumArg(arg.v_array.GetElements()[i]);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void ReadMsgArgs(const BenchMessage& rcv)
+{
+    BenchMessage msg(rcv);
+    CHECK(msg.UnmarshalBody(), "UnmarshalArgs");
+    size_t numArgs;
+    const MsgArg* args;
+    msg.GetArgs(numArgs, args);
+    for (size_t i = 0; i < numArgs; ++i) {
+        SumArg(args[i]);
+    }
+}
+
+/*
+ * Readers for a MsgArgView
+ */
+static void SumView(MsgArgView& view)
+{
+    while (!view.AtEnd()) {
+        switch (view.GetTypeId()) {
+        case ALLJOYN_BOOLEAN:
+            {
+                bool b;
+                CHECK(view.GetBool(b), "GetBool");
+                sum += b;
+            }
+            break;
+
+        case ALLJOYN_INT32:
+            {
+                int32_t i;
+                CHECK(view.GetInt32(i), "GetInt32");
+                sum += i;
+            }
+            break;
+
+        case ALLJOYN_UINT32:
+            {
+                uint32_t u;
+                CHECK(view.GetUint32(u), "GetUint32");
+                sum += u;
+            }
+            break;
+
+        case ALLJOYN_DOUBLE:
+            {
+                double d;
+                CHECK(view.GetDouble(d), "GetDouble");
+                sum += (uint64_t)d;
+            }
+            break;
+
+        case ALLJOYN_STRING:
+            {
+                const char* str;
+                size_t len;
+                CHECK(view.GetString(str, &len), "GetString");
+                sum += len;
+            }
+            break;
+
+        case ALLJOYN_INT32_ARRAY:
+            {
+                const int32_t* elements;
+                size_t numElements;
+                CHECK(view.GetArray(elements, numElements), "GetArray");
+                for (size_t i = 0; i < numElements; ++i) {
+                    sum += elements[i];
+                }
+            }
+            break;
+
+        case ALLJOYN_ARRAY:
+        case ALLJOYN_STRUCT:
+        case ALLJOYN_DICT_ENTRY:
+        case ALLJOYN_VARIANT:
+            {
+                MsgArgView sub;
+                CHECK(view.Recurse(sub), "Recurse");
+                SumView(sub);
+            }
+            break;
+
+        default:
+            CHECK(view.Next(), "Next");
+            break;
+        }
+    }
+}
+
+static void Unmarshal(const BenchMessage& rcv)
+{
+    BenchMessage msg(rcv);
+    CHECK(msg.UnmarshalBody(), "UnmarshalArgs");
+}
+
+static void UnmarshalDeferred(const BenchMessage& rcv)
+{
+    BenchMessage msg(rcv);
+    CHECK(msg.UnmarshalBody(true), "UnmarshalArgs");
+}
+
+static void ReadView(const BenchMessage& rcv)
+{
+    BenchMessage msg(rcv);
+    CHECK(msg.UnmarshalBody(true), "UnmarshalArgs");
+    MsgArgView view;
+    CHECK(msg.GetArgView(view), "GetArgView");
+    SumView(view);
+}
+
+static void BenchSignature(BusAttachment& bus, const char* name, const MsgArg* args, size_t numArgs)
+{
+    BenchMessage msg(bus);
+    BenchMessage rcv(bus);
+    CHECK(msg.MethodCall(args, numArgs), "MethodCall");
+    CHECK(rcv.Receive(bus, msg), "Receive");
+
+    /* Both readers must see the same values */
+    uint64_t expected;
+    sum = 0;
+    ReadMsgArgs(rcv);
+    expected = sum;
+    sum = 0;
+    ReadView(rcv);
+    if (sum != expected) {
+        printf("%s: MsgArgView read %llu expected %llu\n", name, (unsigned long long)sum, (unsigned long long)expected);
+        exit(1);
+    }
+
+    printf("\n%s\n", name);
+    BENCH("UnmarshalArgs only", Unmarshal(rcv));
+    BENCH("UnmarshalArgs only (deferred)", UnmarshalDeferred(rcv));
+    BENCH("MsgArg (GetArgs)", ReadMsgArgs(rcv));
+    BENCH("MsgArgView (GetArgView)", ReadView(rcv));
+}
+
+static void Usage()
+{
+    printf("Usage: argviewbench [-h] [-t <ms>] [-n <count>]\n\n");
+    printf("Options:\n");
+    printf("   -h          = Print this help message\n");
+    printf("   -t <ms>     = Time to spend on each operation (default %u)\n", duration);
+    printf("   -n <count>  = Number of array elements in each message (default 64)\n");
+}
+
+int CDECL_CALL main(int argc, char** argv)
+{
+    size_t count = 64;
+
+    for (int i = 1; i < argc; ++i) {
+        if (0 == strcmp("-h", argv[i])) {
+            Usage();
+            exit(0);
+        } else if ((0 == strcmp("-t", argv[i])) || (0 == strcmp("-n", argv[i]))) {
+            ++i;
+            if (i == argc) {
+                printf("option %s requires a parameter\n", argv[i - 1]);
+                Usage();
+                exit(1);
+            }
+            if (argv[i - 1][1] == 't') {
+                duration = (uint32_t)strtoul(argv[i], NULL, 10);
+            } else {
+                count = (size_t)strtoul(argv[i], NULL, 10);
+            }
+        } else {
+            printf("Unknown option %s\n", argv[i]);
+            Usage();
+            exit(1);
+        }
+    }
+    if (count == 0) {
+        count = 1;
+    }
+
+    if (AllJoynInit() != ER_OK) {
+        return 1;
+    }
+    {
+        BusAttachment bus("argviewbench", false);
+        CHECK(bus.Start(), "Start");
+
+        std::vector<qcc::String> names(count);
+        std::vector<MsgArg> values(count);
+        std::vector<MsgArg> entries(count);
+        std::vector<MsgArg> structs(count);
+        std::vector<int32_t> ints(count * 16);
+        for (size_t i = 0; i < count; ++i) {
+            names[i] = "Property" + U32ToString((uint32_t)i);
+            switch (i % 4) {
+            case 0:
+                values[i].Set("u", (uint32_t)i);
+                break;
+
+            case 1:
+                values[i].Set("s", names[i].c_str());
+                break;
+
+            case 2:
+                values[i].Set("d", i * 1.5);
+                break;
+
+            default:
+                values[i].Set("b", (i & 4) != 0);
+                break;
+            }
+            entries[i].Set("{sv}", names[i].c_str(), &values[i]);
+            structs[i].Set("(sii)", names[i].c_str(), (int32_t)i, -(int32_t)i);
+        }
+        for (size_t i = 0; i < ints.size(); ++i) {
+            ints[i] = (int32_t)i;
+        }
+
+        MsgArg arg;
+        CHECK(arg.Set("a{sv}", count, &entries[0]), "Set a{sv}");
+        BenchSignature(bus, "a{sv}", &arg, 1);
+        CHECK(arg.Set("ai", ints.size(), &ints[0]), "Set ai");
+        BenchSignature(bus, "ai", &arg, 1);
+        CHECK(arg.Set("a(sii)", count, &structs[0]), "Set a(sii)");
+        BenchSignature(bus, "a(sii)", &arg, 1);
+        BenchSignature(bus, "(sii)", &structs[0], 1);
+    }
+    AllJoynShutdown();
+    return 0;
+}
@@ -0,0 +1,162 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+/*
+ * Reports operations per second for the P-256 primitives used by the ECDHE
+ * and ECDSA auth mechanisms.  Generator multiplies and signature verification
+ * are timed on both the fixed-base/interleaved paths and the generic
+ * variable-base path they replaced.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <qcc/Crypto.h>
+#include <qcc/CryptoECC.h>
+#include <qcc/CryptoECCp256.h>
+#include <qcc/time.h>
+#include <alljoyn/Init.h>
+#include <alljoyn/Status.h>
+
+using namespace qcc;
+
+static uint32_t duration = 1000;
+
+static void CHECK(QStatus status, const char* what)
+{
+    if (status != ER_OK) {
+        printf("%s failed: %s\n", what, QCC_StatusText(status));
+        exit(1);
+    }
+}
+
+static void Report(const char* name, uint32_t ops, uint64_t elapsed)
+{
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+    printf("%-36s %8u ops in %5u ms  %10.1f ops/sec\n", name, ops, (uint32_t)elapsed, (ops * 1000.0) / elapsed);
+}
+
+/* Run op until the configured duration has elapsed. */
+#define BENCH(name, op)                                        \
+    do {                                                       \
+        uint32_t ops = 0;                                      \
+        uint64_t start = GetTimestamp64();                     \
+        uint64_t elapsed;                                      \
+        do {                                                   \
+            op;                                                \
+            ++ops;                                             \
+            elapsed = GetTimestamp64() - start;                \
+        } while (elapsed < duration);                          \
+        Report(name, ops, elapsed);                            \
+    } while (0)
+
+static void RandomScalar(digit256_t k)
+{
+    do {
+        CHECK(Crypto_GetRandomBytes((uint8_t*)k, sizeof(digit256_t)), "Crypto_GetRandomBytes");
+        k[P256_DIGITS - 1] &= ((digit_t)-1) >> 1;
+    } while ((k[0] | k[1] | k[2] | k[3]) == 0);
+}
+
+static void Usage()
+{
+    printf("Usage: eccbench [-h] [-t <ms>]\n\n");
+    printf("Options:\n");
+    printf("   -h        = Print this help message\n");
+    printf("   -t <ms>   = Time to spend on each operation (default %u)\n", duration);
+}
+
+static void BenchCurve()
+{
+    ec_t curve;
+    ecpoint_t G, P, Q, R;
+    digit256_t k, l;
+
+    CHECK(ec_getcurve(&curve, NISTP256r1), "ec_getcurve");
+    ec_get_generator(&G, &curve);
+    RandomScalar(k);
+    RandomScalar(l);
+
+    /* Build the fixed-base table outside the timed loop. */
+    CHECK(ec_scalarmul_base(k, &P, &curve), "ec_scalarmul_base");
+
+    printf("P-256 point arithmetic\n");
+    BENCH("k*G (generic ec_scalarmul)", CHECK(ec_scalarmul(&G, k, &Q, &curve), "ec_scalarmul"));
+    BENCH("k*G (fixed-base ec_scalarmul_base)", CHECK(ec_scalarmul_base(k, &Q, &curve), "ec_scalarmul_base"));
+    BENCH("k*P (ec_scalarmul)", CHECK(ec_scalarmul(&P, k, &Q, &curve), "ec_scalarmul"));
+    BENCH("k*G+l*P (two ec_scalarmul)",
+          CHECK(ec_scalarmul(&G, k, &Q, &curve), "ec_scalarmul");
+          CHECK(ec_scalarmul(&P, l, &R, &curve), "ec_scalarmul");
+          ec_add(&Q, &R, &curve));
+    BENCH("k*G+l*P (ec_doublescalarmul)", CHECK(ec_doublescalarmul(k, &P, l, &Q, &curve), "ec_doublescalarmul"));
+
+    ec_freecurve(&curve);
+}
+
+static void BenchApi()
+{
+    Crypto_ECC alice;
+    Crypto_ECC bob;
+    ECCSecret secret;
+    ECCSignature sig;
+    uint8_t digest[Crypto_SHA256::DIGEST_SIZE];
+
+    CHECK(Crypto_GetRandomBytes(digest, sizeof(digest)), "Crypto_GetRandomBytes");
+    CHECK(bob.GenerateDHKeyPair(), "GenerateDHKeyPair");
+    CHECK(alice.GenerateDSAKeyPair(), "GenerateDSAKeyPair");
+    CHECK(alice.DSASignDigest(digest, sizeof(digest), &sig), "DSASignDigest");
+
+    printf("\nCrypto_ECC\n");
+    BENCH("keygen (GenerateDHKeyPair)", CHECK(alice.GenerateDHKeyPair(), "GenerateDHKeyPair"));
+    BENCH("ECDH (GenerateSharedSecret)", CHECK(alice.GenerateSharedSecret(bob.GetDHPublicKey(), &secret), "GenerateSharedSecret"));
+    BENCH("sign (DSASignDigest)", CHECK(alice.DSASignDigest(digest, sizeof(digest), &sig), "DSASignDigest"));
+    BENCH("verify (DSAVerifyDigest)", CHECK(alice.DSAVerifyDigest(digest, sizeof(digest), &sig), "DSAVerifyDigest"));
+}
+
+int CDECL_CALL main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (0 == strcmp("-h", argv[i])) {
+            Usage();
+            exit(0);
+        } else if (0 == strcmp("-t", argv[i])) {
+            ++i;
+            if (i == argc) {
+                printf("option %s requires a parameter\n", argv[i - 1]);
+                Usage();
+                exit(1);
+            }
+            duration = (uint32_t)strtoul(argv[i], NULL, 10);
+        } else {
+            printf("Unknown option %s\n", argv[i]);
+            Usage();
+            exit(1);
+        }
+    }
+
+    if (AllJoynInit() != ER_OK) {
+        return 1;
+    }
+
+    BenchCurve();
+    BenchApi();
+
+    AllJoynShutdown();
+    return 0;
+}
@@ -0,0 +1,373 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+/*
+ * Replays a sessionless signal catch-up storm against a routing node.  An
+ * emitter fills the sessionless cache of the routing node, then a number of
+ * peers join the sessionless session of the routing node at the same time and
+ * request a range of the cache with RequestRangeMatch, as remote routing nodes
+ * do when they catch up.  Reports how long it takes to answer all of the peers
+ * when they request the whole cache and when they request a range that holds
+ * no signals, as peers that are already up to date do.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <limits>
+#include <vector>
+
+#include <qcc/Environ.h>
+#include <qcc/Event.h>
+#include <qcc/String.h>
+#include <qcc/StringUtil.h>
+#include <qcc/Thread.h>
+#include <qcc/Util.h>
+#include <qcc/atomic.h>
+#include <qcc/time.h>
+#include <alljoyn/BusAttachment.h>
+#include <alljoyn/BusObject.h>
+#include <alljoyn/Init.h>
+#include <alljoyn/Session.h>
+#include <alljoyn/SessionListener.h>
+#include <alljoyn/Status.h>
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+static const char* BENCH_INTERFACE = "org.alljoyn.bench.sls";
+static const char* SL_INTERFACE = "org.alljoyn.sl";
+static const SessionPort SL_PORT = 100;
+
+static uint32_t numRules = 8;
+static String connectArgs;
+
+static void CHECK(QStatus status, const char* what)
+{
+    if (status != ER_OK) {
+        printf("%s failed: %s\n", what, QCC_StatusText(status));
+        exit(1);
+    }
+}
+
+static QStatus Connect(BusAttachment& bus)
+{
+    return connectArgs.empty() ? bus.Connect() : bus.Connect(connectArgs.c_str());
+}
+
+/*
+ * Emits one sessionless signal.  Each signal comes from a different object
+ * path so that it gets its own entry in the cache of the routing node.
+ */
+class TickObject : public BusObject {
+  public:
+    TickObject(BusAttachment& bus, const char* path) : BusObject(path)
+    {
+        const InterfaceDescription* intf = bus.GetInterface(BENCH_INTERFACE);
+        AddInterface(*intf);
+        tick = intf->GetMember("Tick");
+    }
+
+    QStatus Tick(uint32_t val)
+    {
+        MsgArg arg("u", val);
+        return Signal(NULL, 0, *tick, &arg, 1, 0, ALLJOYN_FLAG_SESSIONLESS);
+    }
+
+  private:
+    const InterfaceDescription::Member* tick;
+};
+
+/*
+ * Sends the org.alljoyn.sl signals a remote routing node would send.
+ */
+class RequestObject : public BusObject {
+  public:
+    RequestObject(BusAttachment& bus) : BusObject("/org/alljoyn/sl")
+    {
+        const InterfaceDescription* intf = bus.GetInterface(SL_INTERFACE);
+        AddInterface(*intf);
+        requestRangeMatch = intf->GetMember("RequestRangeMatch");
+    }
+
+    QStatus RequestRangeMatch(const char* dest, SessionId sid, uint32_t fromId, uint32_t toId, const vector<const char*>& rules)
+    {
+        MsgArg args[3];
+        args[0].Set("u", fromId);
+        args[1].Set("u", toId);
+        args[2].Set("as", rules.size(), rules.empty() ? NULL : &rules[0]);
+        return Signal(dest, sid, *requestRangeMatch, args, ArraySize(args));
+    }
+
+  private:
+    const InterfaceDescription::Member* requestRangeMatch;
+};
+
+/*
+ * A peer catching up with the cache of the routing node.
+ */
+class Peer : public Thread, public SessionListener, public MessageReceiver {
+  public:
+    Peer(uint32_t id) :
+        Thread("Peer"),
+        bus(("slsbench.peer" + U32ToString(id)).c_str(), true),
+        obj(NULL),
+        fromId(0), toId(0), expected(0), received(0)
+    {
+    }
+
+    ~Peer()
+    {
+        bus.Stop();
+        bus.Join();
+        delete obj;
+    }
+
+    void Setup(const char* routerName)
+    {
+        this->routerName = routerName;
+        CHECK(bus.Start(), "BusAttachment::Start");
+        CHECK(Connect(bus), "BusAttachment::Connect");
+        CreateInterfaces(bus);
+        obj = new RequestObject(bus);
+        CHECK(bus.RegisterBusObject(*obj), "RegisterBusObject");
+        CHECK(bus.RegisterSignalHandler(this,
+                                        static_cast<MessageReceiver::SignalHandler>(&Peer::TickHandler),
+                                        bus.GetInterface(BENCH_INTERFACE)->GetMember("Tick"),
+                                        NULL), "RegisterSignalHandler");
+    }
+
+    void Request(uint32_t fromId, uint32_t toId, uint32_t expected)
+    {
+        this->fromId = fromId;
+        this->toId = toId;
+        this->expected = expected;
+        received = 0;
+        lost.ResetEvent();
+    }
+
+    bool Succeeded() const
+    {
+        return status == ER_OK;
+    }
+
+    static void CreateInterfaces(BusAttachment& bus)
+    {
+        InterfaceDescription* intf = NULL;
+        CHECK(bus.CreateInterface(BENCH_INTERFACE, intf), "CreateInterface");
+        intf->AddSignal("Tick", "u", NULL, 0);
+        intf->Activate();
+        CHECK(bus.CreateInterface(SL_INTERFACE, intf), "CreateInterface");
+        intf->AddSignal("RequestSignals", "u", NULL, 0);
+        intf->AddSignal("RequestRange", "uu", NULL, 0);
+        intf->AddSignal("RequestRangeMatch", "uuas", NULL, 0);
+        intf->Activate();
+    }
+
+  private:
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+
+        /*
+         * Only the last rule matches the signals so the routing node has to
+         * check all of them.
+         */
+        vector<String> ruleStrs;
+        for (uint32_t i = 1; i < numRules; ++i) {
+            ruleStrs.push_back("type='signal',interface='org.alljoyn.bench.other" + U32ToString(i) + "'");
+        }
+        ruleStrs.push_back("type='signal',interface='org.alljoyn.bench.sls'");
+        vector<const char*> rules;
+        for (size_t i = 0; i < ruleStrs.size(); ++i) {
+            rules.push_back(ruleStrs[i].c_str());
+        }
+
+        SessionId sid;
+        SessionOpts opts(SessionOpts::TRAFFIC_MESSAGES, false, SessionOpts::PROXIMITY_ANY, TRANSPORT_ANY);
+        status = bus.JoinSession(routerName.c_str(), SL_PORT, this, sid, opts);
+        if (status == ER_OK) {
+            status = obj->RequestRangeMatch(routerName.c_str(), sid, fromId, toId, rules);
+        }
+        if (status == ER_OK) {
+            /* The routing node leaves the session once it has sent the range */
+            status = Event::Wait(lost, 30000);
+        }
+        for (uint32_t i = 0; (status == ER_OK) && (received != expected) && (i < 100); ++i) {
+            qcc::Sleep(10);
+        }
+        if ((status == ER_OK) && (received != expected)) {
+            printf("Peer %s received %u signals, expected %u\n", bus.GetUniqueName().c_str(), received, expected);
+            status = ER_FAIL;
+        }
+        return 0;
+    }
+
+    void SessionLost(SessionId sessionId, SessionLostReason reason)
+    {
+        QCC_UNUSED(sessionId);
+        QCC_UNUSED(reason);
+        lost.SetEvent();
+    }
+
+    void TickHandler(const InterfaceDescription::Member* member, const char* srcPath, Message& msg)
+    {
+        QCC_UNUSED(member);
+        QCC_UNUSED(srcPath);
+        QCC_UNUSED(msg);
+        IncrementAndFetch((volatile int32_t*)&received);
+    }
+
+    BusAttachment bus;
+    RequestObject* obj;
+    String routerName;
+    Event lost;
+    uint32_t fromId;
+    uint32_t toId;
+    uint32_t expected;
+    volatile uint32_t received;
+    QStatus status;
+};
+
+static void Storm(const char* name, vector<Peer*>& peers, uint32_t fromId, uint32_t toId, uint32_t expected)
+{
+    for (size_t i = 0; i < peers.size(); ++i) {
+        peers[i]->Request(fromId, toId, expected);
+    }
+    uint64_t start = GetTimestamp64();
+    for (size_t i = 0; i < peers.size(); ++i) {
+        CHECK(peers[i]->Start(), "Thread::Start");
+    }
+    for (size_t i = 0; i < peers.size(); ++i) {
+        peers[i]->Join();
+        if (!peers[i]->Succeeded()) {
+            exit(1);
+        }
+    }
+    uint64_t elapsed = GetTimestamp64() - start;
+    printf("%-36s %4u peers in %6u ms  %8.1f ms/peer\n", name, (uint32_t)peers.size(), (uint32_t)elapsed, (double)elapsed / peers.size());
+}
+
+static void Usage()
+{
+    printf("Usage: slsbench [-h] [-n <signals>] [-p <peers>] [-r <rules>] [-i <iterations>]\n\n");
+    printf("Options:\n");
+    printf("   -h               = Print this help message\n");
+    printf("   -n <signals>     = Number of signals in the sessionless cache (default 1000)\n");
+    printf("   -p <peers>       = Number of peers catching up at the same time (default 16)\n");
+    printf("   -r <rules>       = Number of match rules sent by each peer (default %u)\n", numRules);
+    printf("   -i <iterations>  = Number of storms of each kind (default 3)\n");
+}
+
+int CDECL_CALL main(int argc, char** argv)
+{
+    uint32_t numSignals = 1000;
+    uint32_t numPeers = 16;
+    uint32_t iterations = 3;
+
+    for (int i = 1; i < argc; ++i) {
+        if (0 == strcmp("-h", argv[i])) {
+            Usage();
+            exit(0);
+        } else if ((0 == strcmp("-n", argv[i])) || (0 == strcmp("-p", argv[i])) ||
+                   (0 == strcmp("-r", argv[i])) || (0 == strcmp("-i", argv[i]))) {
+            ++i;
+            if (i == argc) {
+                printf("option %s requires a parameter\n", argv[i - 1]);
+                Usage();
+                exit(1);
+            }
+            uint32_t val = (uint32_t)strtoul(argv[i], NULL, 10);
+            switch (argv[i - 1][1]) {
+            case 'n':
+                numSignals = val;
+                break;
+
+            case 'p':
+                numPeers = val;
+                break;
+
+            case 'r':
+                numRules = val;
+                break;
+
+            default:
+                iterations = val;
+                break;
+            }
+        } else {
+            printf("Unknown option %s\n", argv[i]);
+            Usage();
+            exit(1);
+        }
+    }
+    if ((numPeers == 0) || (numRules == 0)) {
+        Usage();
+        exit(1);
+    }
+
+    if (AllJoynInit() != ER_OK) {
+        return 1;
+    }
+    connectArgs = Environ::GetAppEnviron()->Find("BUS_ADDRESS");
+    {
+        BusAttachment emitter("slsbench.emitter", true);
+        CHECK(emitter.Start(), "BusAttachment::Start");
+        CHECK(Connect(emitter), "BusAttachment::Connect");
+        Peer::CreateInterfaces(emitter);
+        vector<TickObject*> objs;
+        for (uint32_t i = 0; i < numSignals; ++i) {
+            objs.push_back(new TickObject(emitter, ("/bench/tick" + U32ToString(i)).c_str()));
+            CHECK(emitter.RegisterBusObject(*objs.back()), "RegisterBusObject");
+        }
+
+        /* The routing node hosts the sessionless session with the first unique name of the bus */
+        String uniqueName = emitter.GetUniqueName();
+        String routerName = uniqueName.substr(0, uniqueName.find_first_of('.')) + ".1";
+
+        vector<Peer*> peers;
+        for (uint32_t i = 0; i < numPeers; ++i) {
+            peers.push_back(new Peer(i));
+            peers.back()->Setup(routerName.c_str());
+        }
+
+        /* Fill the sessionless cache of the routing node once all of the peers are connected */
+        for (uint32_t i = 0; i < numSignals; ++i) {
+            CHECK(objs[i]->Tick(i), "Signal");
+        }
+
+        printf("%u cached signals, %u rules per request\n", numSignals, numRules);
+        for (uint32_t i = 0; i < iterations; ++i) {
+            Storm("Catch up with whole cache", peers, 0, numeric_limits<uint32_t>::max(), numSignals);
+        }
+        for (uint32_t i = 0; i < iterations; ++i) {
+            Storm("Catch up with empty range", peers, 0x40000000, 0x40000001, 0);
+        }
+
+        for (size_t i = 0; i < peers.size(); ++i) {
+            delete peers[i];
+        }
+        emitter.Stop();
+        emitter.Join();
+        for (size_t i = 0; i < objs.size(); ++i) {
+            delete objs[i];
+        }
+    }
+    AllJoynShutdown();
+    return 0;
+}
@@ -0,0 +1,339 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include "ajTestCommon.h"
+#include <qcc/FileStream.h>
+#include <qcc/StringUtil.h>
+#include <qcc/Util.h>
+#include <alljoyn/BusAttachment.h>
+#include <alljoyn/InterfaceDescription.h>
+#include <alljoyn/ProxyBusObject.h>
+
+#include "BusInternal.h"
+#include "IntrospectionCache.h"
+
+using namespace ajn;
+using namespace qcc;
+
+static const char* deviceXML =
+    "<node>\n"
+    "  <interface name=\"org.alljoyn.test.IntrospectionCache.Light\">\n"
+    "    <method name=\"Toggle\">\n"
+    "      <arg name=\"on\" type=\"b\" direction=\"out\"/>\n"
+    "    </method>\n"
+    "    <property name=\"Level\" type=\"u\" access=\"readwrite\"/>\n"
+    "  </interface>\n"
+    "  <node name=\"lamp\">\n"
+    "    <annotation name=\"org.alljoyn.Bus.Secure\" value=\"true\"/>\n"
+    "    <interface name=\"org.alljoyn.test.IntrospectionCache.Lamp\">\n"
+    "      <signal name=\"Burnout\">\n"
+    "        <arg name=\"hours\" type=\"u\"/>\n"
+    "      </signal>\n"
+    "    </interface>\n"
+    "    <node name=\"bulb\">\n"
+    "      <interface name=\"org.alljoyn.test.IntrospectionCache.Light\">\n"
+    "        <method name=\"Toggle\">\n"
+    "          <arg name=\"on\" type=\"b\" direction=\"out\"/>\n"
+    "        </method>\n"
+    "        <property name=\"Level\" type=\"u\" access=\"readwrite\"/>\n"
+    "      </interface>\n"
+    "    </node>\n"
+    "  </node>\n"
+    "</node>\n";
+
+static void CheckDeviceProxy(BusAttachment& bus, ProxyBusObject& proxy)
+{
+    EXPECT_TRUE(proxy.ImplementsInterface("org.alljoyn.test.IntrospectionCache.Light"));
+    EXPECT_FALSE(proxy.IsSecure());
+    ProxyBusObject* lamp = proxy.GetChild("lamp");
+    ASSERT_TRUE(lamp != NULL);
+    EXPECT_STREQ("/device/lamp", lamp->GetPath().c_str());
+    EXPECT_TRUE(lamp->IsSecure());
+    EXPECT_TRUE(lamp->ImplementsInterface("org.alljoyn.test.IntrospectionCache.Lamp"));
+    ProxyBusObject* bulb = proxy.GetChild("lamp/bulb");
+    ASSERT_TRUE(bulb != NULL);
+    EXPECT_STREQ("/device/lamp/bulb", bulb->GetPath().c_str());
+    EXPECT_TRUE(bulb->ImplementsInterface("org.alljoyn.test.IntrospectionCache.Light"));
+    EXPECT_TRUE(bus.GetInterface("org.alljoyn.test.IntrospectionCache.Lamp")->GetMember("Burnout") != NULL);
+}
+
+TEST(IntrospectionCacheTest, SharedBetweenProxies)
+{
+    BusAttachment bus("IntrospectionCacheTest", false);
+    size_t hits;
+    size_t misses;
+
+    ProxyBusObject first(bus, ":device.1", "/device", 0);
+    EXPECT_EQ(ER_OK, first.ParseXml(deviceXML));
+    bus.GetIntrospectionCacheStats(hits, misses);
+    EXPECT_EQ((size_t)0, hits);
+    EXPECT_EQ((size_t)1, misses);
+    CheckDeviceProxy(bus, first);
+
+    ProxyBusObject second(bus, ":device.2", "/device", 0);
+    EXPECT_EQ(ER_OK, second.ParseXml(deviceXML));
+    bus.GetIntrospectionCacheStats(hits, misses);
+    EXPECT_EQ((size_t)1, hits);
+    EXPECT_EQ((size_t)1, misses);
+    CheckDeviceProxy(bus, second);
+    EXPECT_STREQ(":device.2", second.GetChild("lamp/bulb")->GetServiceName().c_str());
+
+    /* Different XML is parsed */
+    ProxyBusObject third(bus, ":device.3", "/device", 0);
+    EXPECT_EQ(ER_OK, third.ParseXml("<node><node name=\"lamp\"/></node>"));
+    bus.GetIntrospectionCacheStats(hits, misses);
+    EXPECT_EQ((size_t)1, hits);
+    EXPECT_EQ((size_t)2, misses);
+    EXPECT_TRUE(third.GetChild("lamp") != NULL);
+}
+
+static void Announce(BusAttachment& bus, const char* busName, uint8_t app, const char* version = "1.0")
+{
+    uint8_t appId[16] = { app };
+    MsgArg appIdArg("ay", sizeof(appId), appId);
+    MsgArg modelArg("s", "model");
+    MsgArg versionArg("s", version);
+    MsgArg fields[3];
+    fields[0].Set("{sv}", "AppId", &appIdArg);
+    fields[1].Set("{sv}", "ModelNumber", &modelArg);
+    fields[2].Set("{sv}", "SoftwareVersion", &versionArg);
+    MsgArg aboutData("a{sv}", 3, fields);
+    const char* interfaces[] = { "org.alljoyn.test.IntrospectionCache.Light" };
+    MsgArg objects[1];
+    objects[0].Set("(oas)", "/device", 1, interfaces);
+    MsgArg objectDescription("a(oas)", 1, objects);
+    bus.GetInternal().GetIntrospectionCache().SetPeerAnnouncement(busName, objectDescription, aboutData);
+}
+
+TEST(IntrospectionCacheTest, AnnouncedPeerNotIntrospected)
+{
+    BusAttachment bus("IntrospectionCacheTest", false);
+    IntrospectionCache& cache = bus.GetInternal().GetIntrospectionCache();
+    size_t hits;
+    size_t misses;
+
+    Announce(bus, ":device.1", 1);
+    Announce(bus, ":device.2", 1);
+    Announce(bus, ":device.3", 2);
+    EXPECT_EQ(cache.GetPeerDigest(":device.1"), cache.GetPeerDigest(":device.2"));
+    EXPECT_NE(cache.GetPeerDigest(":device.1"), cache.GetPeerDigest(":device.3"));
+
+    /* Record the XML as if :device.1 had been introspected */
+    ProxyBusObject first(bus, ":device.1", "/device", 0);
+    EXPECT_EQ(ER_OK, first.ParseXml(deviceXML));
+    cache.AddObject(cache.GetPeerDigest(":device.1"), "/device", IntrospectionCache::GetDigest(deviceXML));
+
+    /* The bus is not connected so only a cached result can succeed */
+    ProxyBusObject second(bus, ":device.2", "/device", 0);
+    EXPECT_EQ(ER_OK, second.IntrospectRemoteObject());
+    CheckDeviceProxy(bus, second);
+    bus.GetIntrospectionCacheStats(hits, misses);
+    EXPECT_EQ((size_t)1, hits);
+    EXPECT_EQ((size_t)1, misses);
+
+    ProxyBusObject other(bus, ":device.2", "/other", 0);
+    EXPECT_NE(ER_OK, other.IntrospectRemoteObject());
+    ProxyBusObject third(bus, ":device.3", "/device", 0);
+    EXPECT_NE(ER_OK, third.IntrospectRemoteObject());
+
+    /* Objects go away with their entry */
+    cache.Remove(IntrospectionCache::GetDigest(deviceXML));
+    ProxyBusObject fourth(bus, ":device.2", "/device", 0);
+    EXPECT_NE(ER_OK, fourth.IntrospectRemoteObject());
+}
+
+TEST(IntrospectionCacheTest, SoftwareVersionNotShared)
+{
+    BusAttachment bus("IntrospectionCacheTest", false);
+    IntrospectionCache& cache = bus.GetInternal().GetIntrospectionCache();
+
+    Announce(bus, ":device.1", 1, "1.0");
+    Announce(bus, ":device.2", 1, "2.0");
+    EXPECT_NE(cache.GetPeerDigest(":device.1"), cache.GetPeerDigest(":device.2"));
+
+    ProxyBusObject first(bus, ":device.1", "/device", 0);
+    EXPECT_EQ(ER_OK, first.ParseXml(deviceXML));
+    cache.AddObject(cache.GetPeerDigest(":device.1"), "/device", IntrospectionCache::GetDigest(deviceXML));
+    ProxyBusObject second(bus, ":device.2", "/device", 0);
+    EXPECT_NE(ER_OK, second.IntrospectRemoteObject());
+
+    /* Objects stay while another peer still announces the old version */
+    Announce(bus, ":device.3", 1, "1.0");
+    Announce(bus, ":device.1", 1, "2.0");
+    ProxyBusObject third(bus, ":device.3", "/device", 0);
+    EXPECT_EQ(ER_OK, third.IntrospectRemoteObject());
+
+    /* and are forgotten when the last one is updated */
+    Announce(bus, ":device.3", 1, "2.0");
+    Announce(bus, ":device.4", 1, "1.0");
+    ProxyBusObject fourth(bus, ":device.4", "/device", 0);
+    EXPECT_NE(ER_OK, fourth.IntrospectRemoteObject());
+}
+
+TEST(IntrospectionCacheTest, PeersForgotten)
+{
+    BusAttachment bus("IntrospectionCacheTest", false);
+    IntrospectionCache& cache = bus.GetInternal().GetIntrospectionCache();
+
+    Announce(bus, ":device.1", 1);
+    EXPECT_FALSE(cache.GetPeerDigest(":device.1").empty());
+    cache.RemovePeer(":device.1");
+    EXPECT_TRUE(cache.GetPeerDigest(":device.1").empty());
+
+    /* The least recently used peer is forgotten first */
+    for (size_t i = 0; i < IntrospectionCache::MAX_PEERS; ++i) {
+        Announce(bus, (":device." + U32ToString(static_cast<uint32_t>(i))).c_str(), 1);
+    }
+    EXPECT_FALSE(cache.GetPeerDigest(":device.0").empty());
+    Announce(bus, ":device.new", 1);
+    EXPECT_FALSE(cache.GetPeerDigest(":device.0").empty());
+    EXPECT_TRUE(cache.GetPeerDigest(":device.1").empty());
+    EXPECT_FALSE(cache.GetPeerDigest(":device.new").empty());
+}
+
+TEST(IntrospectionCacheTest, EvictionDropsInterfaceXml)
+{
+    const char* fileName = "introspection_cache_test";
+    BusAttachment bus("IntrospectionCacheTest", false);
+    IntrospectionCache& cache = bus.GetInternal().GetIntrospectionCache();
+
+    IntrospectionCache::Node root;
+    root.interfaces.push_back("org.alljoyn.test.IntrospectionCache.Evicted");
+    std::map<qcc::String, qcc::String> interfaces;
+    interfaces["org.alljoyn.test.IntrospectionCache.Evicted"] = "<interface name=\"org.alljoyn.test.IntrospectionCache.Evicted\"/>";
+    cache.Add(IntrospectionCache::GetDigest("evicted"), root, interfaces);
+
+    IntrospectionCache::Node empty;
+    for (size_t i = 0; i < IntrospectionCache::MAX_ENTRIES; ++i) {
+        cache.Add(IntrospectionCache::GetDigest(U32ToString(static_cast<uint32_t>(i)).c_str()), empty, std::map<qcc::String, qcc::String>());
+    }
+    EXPECT_TRUE(!cache.Find(IntrospectionCache::GetDigest("evicted")));
+
+    /* An entry using the interface again without its XML saves no XML for it */
+    cache.Add(IntrospectionCache::GetDigest("again"), root, std::map<qcc::String, qcc::String>());
+    ASSERT_EQ(ER_OK, cache.Save(fileName));
+    FileSource source(fileName);
+    int64_t fileSize = 0;
+    ASSERT_EQ(ER_OK, source.GetSize(fileSize));
+    qcc::String buf(static_cast<size_t>(fileSize), ' ');
+    size_t pulled = 0;
+    ASSERT_EQ(ER_OK, source.PullBytes(&buf[0], buf.size(), pulled));
+    EXPECT_EQ(qcc::String::npos, buf.find("<interface"));
+
+    EXPECT_EQ(ER_OK, DeleteFile(fileName));
+}
+
+TEST(IntrospectionCacheTest, Disabled)
+{
+    BusAttachment bus("IntrospectionCacheTest", false);
+    size_t hits;
+    size_t misses;
+
+    bus.EnableIntrospectionCache(false);
+    for (int i = 0; i < 2; ++i) {
+        ProxyBusObject proxy(bus, ":device.1", "/device", 0);
+        EXPECT_EQ(ER_OK, proxy.ParseXml(deviceXML));
+        CheckDeviceProxy(bus, proxy);
+    }
+    bus.GetIntrospectionCacheStats(hits, misses);
+    EXPECT_EQ((size_t)0, hits);
+    EXPECT_EQ((size_t)0, misses);
+}
+
+TEST(IntrospectionCacheTest, BadXmlNotCached)
+{
+    BusAttachment bus("IntrospectionCacheTest", false);
+    const char* badXML = "<node><node name=\"\"/></node>";
+    size_t hits;
+    size_t misses;
+
+    for (int i = 0; i < 2; ++i) {
+        ProxyBusObject proxy(bus, ":device.1", "/device", 0);
+        EXPECT_NE(ER_OK, proxy.ParseXml(badXML));
+    }
+    bus.GetIntrospectionCacheStats(hits, misses);
+    EXPECT_EQ((size_t)0, hits);
+    EXPECT_EQ((size_t)2, misses);
+}
+
+TEST(IntrospectionCacheTest, SaveAndLoad)
+{
+    const char* fileName = "introspection_cache_test";
+    size_t hits;
+    size_t misses;
+
+    {
+        BusAttachment bus("IntrospectionCacheTest", false);
+        ProxyBusObject proxy(bus, ":device.1", "/device", 0);
+        EXPECT_EQ(ER_OK, proxy.ParseXml(deviceXML));
+        ASSERT_EQ(ER_OK, bus.SaveIntrospectionCache(fileName));
+    }
+
+    /* The interfaces are registered when the cache is loaded */
+    BusAttachment bus("IntrospectionCacheTest", false);
+    EXPECT_TRUE(bus.GetInterface("org.alljoyn.test.IntrospectionCache.Lamp") == NULL);
+    EXPECT_EQ(ER_OK, bus.LoadIntrospectionCache(fileName));
+    EXPECT_TRUE(bus.GetInterface("org.alljoyn.test.IntrospectionCache.Lamp") != NULL);
+
+    ProxyBusObject proxy(bus, ":device.2", "/device", 0);
+    EXPECT_EQ(ER_OK, proxy.ParseXml(deviceXML));
+    bus.GetIntrospectionCacheStats(hits, misses);
+    EXPECT_EQ((size_t)1, hits);
+    EXPECT_EQ((size_t)0, misses);
+    CheckDeviceProxy(bus, proxy);
+
+    EXPECT_EQ(ER_OK, DeleteFile(fileName));
+}
+
+TEST(IntrospectionCacheTest, LoadConflictingInterface)
+{
+    const char* fileName = "introspection_cache_test";
+    size_t hits;
+    size_t misses;
+
+    {
+        BusAttachment bus("IntrospectionCacheTest", false);
+        ProxyBusObject proxy(bus, ":device.1", "/device", 0);
+        EXPECT_EQ(ER_OK, proxy.ParseXml(deviceXML));
+        ASSERT_EQ(ER_OK, bus.SaveIntrospectionCache(fileName));
+    }
+
+    /* An entry using an interface with a different definition is not loaded */
+    BusAttachment bus("IntrospectionCacheTest", false);
+    EXPECT_EQ(ER_OK, bus.CreateInterfacesFromXml("<interface name=\"org.alljoyn.test.IntrospectionCache.Lamp\"/>"));
+    EXPECT_EQ(ER_OK, bus.LoadIntrospectionCache(fileName));
+    ProxyBusObject proxy(bus, ":device.2", "/device", 0);
+    EXPECT_EQ(ER_BUS_INTERFACE_MISMATCH, proxy.ParseXml(deviceXML));
+    bus.GetIntrospectionCacheStats(hits, misses);
+    EXPECT_EQ((size_t)0, hits);
+    EXPECT_EQ((size_t)1, misses);
+
+    EXPECT_EQ(ER_OK, DeleteFile(fileName));
+}
+
+TEST(IntrospectionCacheTest, LoadCorruptFile)
+{
+    const char* fileName = "introspection_cache_test";
+    {
+        FileSink sink(fileName);
+        size_t pushed;
+        ASSERT_EQ(ER_OK, sink.PushBytes("not a cache", 11, pushed));
+    }
+    BusAttachment bus("IntrospectionCacheTest", false);
+    EXPECT_EQ(ER_INVALID_DATA, bus.LoadIntrospectionCache(fileName));
+    EXPECT_EQ(ER_OK, DeleteFile(fileName));
+    EXPECT_NE(ER_OK, bus.LoadIntrospectionCache(fileName));
+}
@@ -253,6 +253,179 @@ TEST(KeyStoreTest, keystore_store_load_merge) {
     }
 }
 
+TEST(KeyStoreTest, keystore_journal_compaction) {
+    qcc::GUID128 guid1;
+    qcc::GUID128 guid2;
+    KeyStore::Key idx1(KeyStore::Key::LOCAL, guid1);
+    KeyStore::Key idx2(KeyStore::Key::LOCAL, guid2);
+    KeyBlob key;
+    KeyBlob lastKey;
+    const char* fileName = "keystore_test";
+
+    {
+        KeyStore keyStore(fileName);
+        ASSERT_EQ(ER_OK, DeleteDefaultKeyStoreFile(fileName));
+        keyStore.Init(NULL, true);
+        keyStore.Clear();
+
+        key.Rand(620, KeyBlob::GENERIC);
+        ASSERT_EQ(ER_OK, keyStore.AddKey(idx2, key)) << " Failed to add key";
+
+        /* Each replacement appends a journal record until the journal is compacted */
+        for (int i = 0; i < 300; ++i) {
+            lastKey.Rand(620, KeyBlob::GENERIC);
+            ASSERT_EQ(ER_OK, keyStore.AddKey(idx1, lastKey)) << " Failed to replace key";
+        }
+    }
+
+    FileSource source(GetHomeDir() + "/.alljoyn_keystore/" + fileName);
+    int64_t fileSize = 0;
+    ASSERT_EQ(ER_OK, source.GetSize(fileSize));
+    EXPECT_LT(fileSize, 100 * 1024) << " Journal was not compacted";
+
+    {
+        KeyStore keyStore(fileName);
+        keyStore.Init(NULL, true);
+
+        ASSERT_EQ(ER_OK, keyStore.GetKey(idx1, key)) << " Failed to load idx1";
+        ASSERT_EQ(lastKey.GetSize(), key.GetSize());
+        EXPECT_EQ(0, memcmp(lastKey.GetData(), key.GetData(), key.GetSize())) << " idx1 is not the last replacement";
+        EXPECT_EQ(ER_OK, keyStore.GetKey(idx2, key)) << " Failed to load idx2";
+    }
+}
+
+TEST(KeyStoreTest, keystore_journal_torn_record) {
+    qcc::GUID128 guid1;
+    qcc::GUID128 guid2;
+    qcc::GUID128 guid3;
+    KeyStore::Key idx1(KeyStore::Key::LOCAL, guid1);
+    KeyStore::Key idx2(KeyStore::Key::LOCAL, guid2);
+    KeyStore::Key idx3(KeyStore::Key::LOCAL, guid3);
+    KeyBlob key;
+    const char* fileName = "keystore_test";
+    qcc::String path = GetHomeDir() + "/.alljoyn_keystore/" + fileName;
+
+    {
+        KeyStore keyStore(fileName);
+        ASSERT_EQ(ER_OK, DeleteDefaultKeyStoreFile(fileName));
+        keyStore.Init(NULL, true);
+        keyStore.Clear();
+
+        key.Rand(620, KeyBlob::GENERIC);
+        ASSERT_EQ(ER_OK, keyStore.AddKey(idx1, key)) << " Failed to add key";
+        key.Rand(620, KeyBlob::GENERIC);
+        ASSERT_EQ(ER_OK, keyStore.AddKey(idx2, key)) << " Failed to add key";
+    }
+
+    /* Append the start of a record as left by a writer that failed */
+    {
+        FileSource source(path);
+        int64_t fileSize = 0;
+        ASSERT_EQ(ER_OK, source.GetSize(fileSize));
+        vector<uint8_t> data(static_cast<size_t>(fileSize) + 30, 0x41);
+        size_t pulled = 0;
+        ASSERT_EQ(ER_OK, source.PullBytes(&data[0], static_cast<size_t>(fileSize), pulled));
+        ASSERT_EQ(static_cast<size_t>(fileSize), pulled);
+        FileSink sink(path, true, FileSink::PRIVATE);
+        size_t pushed = 0;
+        ASSERT_EQ(ER_OK, sink.PushBytes(&data[0], data.size(), pushed));
+    }
+
+    {
+        KeyStore keyStore(fileName);
+        keyStore.Init(NULL, true);
+
+        EXPECT_EQ(ER_OK, keyStore.GetKey(idx1, key)) << " Failed to load idx1";
+        EXPECT_EQ(ER_OK, keyStore.GetKey(idx2, key)) << " Failed to load idx2";
+        key.Rand(620, KeyBlob::GENERIC);
+        ASSERT_EQ(ER_OK, keyStore.AddKey(idx3, key)) << " Failed to add key";
+        ASSERT_EQ(ER_OK, keyStore.DelKey(idx1)) << " Failed to delete key";
+    }
+
+    {
+        KeyStore keyStore(fileName);
+        keyStore.Init(NULL, true);
+
+        EXPECT_EQ(ER_BUS_KEY_UNAVAILABLE, keyStore.GetKey(idx1, key)) << " idx1 was not deleted";
+        EXPECT_EQ(ER_OK, keyStore.GetKey(idx2, key)) << " Failed to load idx2";
+        EXPECT_EQ(ER_OK, keyStore.GetKey(idx3, key)) << " Failed to load idx3";
+    }
+}
+
+TEST(KeyStoreTest, keystore_journal_oversized_record) {
+    qcc::GUID128 guid1;
+    qcc::GUID128 guid2;
+    qcc::GUID128 guid3;
+    KeyStore::Key idx1(KeyStore::Key::LOCAL, guid1);
+    KeyStore::Key idx2(KeyStore::Key::LOCAL, guid2);
+    KeyStore::Key idx3(KeyStore::Key::LOCAL, guid3);
+    KeyBlob key;
+    const char* fileName = "keystore_test";
+    qcc::String path = GetHomeDir() + "/.alljoyn_keystore/" + fileName;
+
+    {
+        KeyStore keyStore(fileName);
+        ASSERT_EQ(ER_OK, DeleteDefaultKeyStoreFile(fileName));
+        keyStore.Init(NULL, true);
+        keyStore.Clear();
+
+        key.Rand(620, KeyBlob::GENERIC);
+        ASSERT_EQ(ER_OK, keyStore.AddKey(idx1, key)) << " Failed to add key";
+        key.Rand(620, KeyBlob::GENERIC);
+        ASSERT_EQ(ER_OK, keyStore.AddKey(idx2, key)) << " Failed to add key";
+    }
+
+    /* Append a record header that follows on from the last record but claims an enormous length */
+    {
+        FileSource source(path);
+        int64_t fileSize = 0;
+        ASSERT_EQ(ER_OK, source.GetSize(fileSize));
+        vector<uint8_t> data(static_cast<size_t>(fileSize));
+        size_t pulled = 0;
+        ASSERT_EQ(ER_OK, source.PullBytes(&data[0], data.size(), pulled));
+        ASSERT_EQ(data.size(), pulled);
+        const uint8_t marker[] = { 0x41, 0x4A, 0x4B, 0x4A };
+        size_t last = data.size();
+        for (size_t i = 0; i + 20 <= data.size(); ++i) {
+            if (memcmp(&data[i], marker, sizeof(marker)) == 0) {
+                last = i;
+            }
+        }
+        ASSERT_NE(data.size(), last) << " No journal record found";
+        uint32_t rev;
+        memcpy(&rev, &data[last + 4], sizeof(rev));
+        ++rev;
+        uint8_t header[20] = { };
+        uint32_t len = 0xFFFFFFF0;
+        memcpy(header, marker, sizeof(marker));
+        memcpy(header + 4, &rev, sizeof(rev));
+        memcpy(header + 16, &len, sizeof(len));
+        data.insert(data.end(), header, header + sizeof(header));
+        FileSink sink(path, true, FileSink::PRIVATE);
+        size_t pushed = 0;
+        ASSERT_EQ(ER_OK, sink.PushBytes(&data[0], data.size(), pushed));
+    }
+
+    {
+        KeyStore keyStore(fileName);
+        keyStore.Init(NULL, true);
+
+        EXPECT_EQ(ER_OK, keyStore.GetKey(idx1, key)) << " Failed to load idx1";
+        EXPECT_EQ(ER_OK, keyStore.GetKey(idx2, key)) << " Failed to load idx2";
+        key.Rand(620, KeyBlob::GENERIC);
+        ASSERT_EQ(ER_OK, keyStore.AddKey(idx3, key)) << " Failed to add key";
+    }
+
+    {
+        KeyStore keyStore(fileName);
+        keyStore.Init(NULL, true);
+
+        EXPECT_EQ(ER_OK, keyStore.GetKey(idx1, key)) << " Failed to load idx1";
+        EXPECT_EQ(ER_OK, keyStore.GetKey(idx2, key)) << " Failed to load idx2";
+        EXPECT_EQ(ER_OK, keyStore.GetKey(idx3, key)) << " Failed to load idx3";
+    }
+}
+
 class KeyStoreThread : public Thread {
   public:
     KeyStoreThread(String name, KeyStore* keyStore, vector<KeyStore::Key> workList, vector<KeyStore::Key> deleteList) :
@@ -17,14 +17,17 @@
 #include <qcc/platform.h>
 #include <queue>
 #include <algorithm>
+#include <vector>
 
 #include <qcc/Util.h>
 #include <qcc/Pipe.h>
 #include <qcc/String.h>
 #include <qcc/StringUtil.h>
+#include <qcc/Thread.h>
 
 #include <alljoyn/BusAttachment.h>
 #include <alljoyn/Message.h>
+#include <alljoyn/MsgArgView.h>
 #include <alljoyn/version.h>
 
 #include <alljoyn/Status.h>
@@ -33,6 +36,7 @@
 #include <PeerState.h>
 #include <SignatureUtils.h>
 #include <RemoteEndpoint.h>
+#include <HeaderDictionary.h>
 
 /* Header files included for Google Test Framework */
 #include <gtest/gtest.h>
@@ -123,7 +127,7 @@ class MyMessage : public _Message {
         return SignalMsg(sig, destination, 0, objPath, iface, signalName, argList, numArgs, 0, 0);
     }
 
-    QStatus UnmarshalBody() { return UnmarshalArgs("*"); }
+    QStatus UnmarshalBody(bool deferArgs = false) { return UnmarshalArgs("*", NULL, deferArgs); }
 
     QStatus Read(RemoteEndpoint& ep, const qcc::String& endpointName, bool pedantic = true)
     {
@@ -348,6 +352,394 @@ TEST(MarshalTest, ReplayProtection) {
     delete bus;
 }
 
+/* Get the bytes a message puts on the wire */
+static String WireBytes(BusAttachment& bus, MyMessage& msg)
+{
+    TestPipe stream;
+    TestPipe* pStream = &stream;
+    static const bool falsiness = false;
+    RemoteEndpoint ep(bus, falsiness, String::Empty, pStream);
+
+    EXPECT_EQ(ER_OK, msg.Deliver(ep));
+    std::vector<char> bytes(stream.AvailBytes());
+    size_t actual = 0;
+    EXPECT_EQ(ER_OK, stream.PullBytes(&bytes[0], bytes.size(), actual, 0));
+    return String(&bytes[0], actual);
+}
+
+TEST(MarshalTest, HeaderDictionaryRoundTrip) {
+    QStatus status = ER_OK;
+
+    BusAttachment* bus = new BusAttachment("HeaderDictionaryRoundTrip", false);
+    bus->Start();
+
+    TestPipe stream;
+    TestPipe* pStream = &stream;
+    static const bool falsiness = false;
+    RemoteEndpoint ep(*bus, falsiness, String::Empty, pStream);
+
+    HeaderDictionary txDictionary;
+    HeaderDictionary rxDictionary;
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        MyMessage msg(*bus);
+        MsgArg args[2];
+        size_t numArgs = ArraySize(args);
+        MsgArg::Set(args, numArgs, "us", i, "hello");
+        status = msg.Signal(":1.1", "/org/alljoyn/test/object", "org.alljoyn.test.Interface", "Changed", args, numArgs);
+        ASSERT_EQ(ER_OK, status);
+
+        /* Keep the uncompressed message to compare with the expanded one */
+        String original = WireBytes(*bus, msg);
+
+        status = txDictionary.Compress(msg);
+        ASSERT_EQ(ER_OK, status);
+        ASSERT_TRUE(HeaderDictionary::IsCompressed(msg));
+        if (i > 0) {
+            /* Every string field after the first message is a reference */
+            ASSERT_GT(original.size(), WireBytes(*bus, msg).size());
+        }
+
+        status = msg.Deliver(ep);
+        ASSERT_EQ(ER_OK, status);
+
+        MyMessage rcv(*bus);
+        status = rcv.Read(ep, ":88.88");
+        ASSERT_EQ(ER_OK, status);
+
+        status = rxDictionary.Expand(rcv);
+        ASSERT_EQ(ER_OK, status);
+        ASSERT_FALSE(HeaderDictionary::IsCompressed(rcv));
+        ASSERT_TRUE(original == WireBytes(*bus, rcv));
+
+        status = rcv.Unmarshal(ep, ":88.88");
+        ASSERT_EQ(ER_OK, status);
+        status = rcv.UnmarshalBody();
+        ASSERT_EQ(ER_OK, status);
+
+        uint32_t u;
+        const char* str;
+        status = rcv.GetArgs("us", &u, &str);
+        ASSERT_EQ(ER_OK, status);
+        EXPECT_EQ(i, u);
+        EXPECT_STREQ("hello", str);
+        EXPECT_STREQ("/org/alljoyn/test/object", rcv.GetObjectPath());
+        EXPECT_STREQ("org.alljoyn.test.Interface", rcv.GetInterface());
+        EXPECT_STREQ("Changed", rcv.GetMemberName());
+    }
+
+    uint64_t txHeaderBytes, txSaved, rxHeaderBytes, rxSaved;
+    txDictionary.GetStats(txHeaderBytes, txSaved);
+    rxDictionary.GetStats(rxHeaderBytes, rxSaved);
+    EXPECT_EQ(txHeaderBytes, rxHeaderBytes);
+    EXPECT_EQ(txSaved, rxSaved);
+    EXPECT_LT(static_cast<uint64_t>(0), txSaved);
+
+    delete bus;
+}
+
+TEST(MarshalTest, HeaderDictionaryUnknownReference) {
+    QStatus status = ER_OK;
+
+    BusAttachment* bus = new BusAttachment("HeaderDictionaryUnknownReference", false);
+    bus->Start();
+
+    TestPipe stream;
+    TestPipe* pStream = &stream;
+    static const bool falsiness = false;
+    RemoteEndpoint ep(*bus, falsiness, String::Empty, pStream);
+
+    HeaderDictionary txDictionary;
+    HeaderDictionary rxDictionary;
+
+    /* The first message primes the transmit dictionary but is never received */
+    for (uint32_t i = 0; i < 2; ++i) {
+        MyMessage msg(*bus);
+        status = msg.Signal(":1.1", "/org/alljoyn/test/object", "org.alljoyn.test.Interface", "Changed", NULL, 0);
+        ASSERT_EQ(ER_OK, status);
+        status = txDictionary.Compress(msg);
+        ASSERT_EQ(ER_OK, status);
+        if (i > 0) {
+            status = msg.Deliver(ep);
+            ASSERT_EQ(ER_OK, status);
+        }
+    }
+
+    MyMessage rcv(*bus);
+    status = rcv.Read(ep, ":88.88");
+    ASSERT_EQ(ER_OK, status);
+    EXPECT_EQ(ER_BUS_BAD_HEADER_FIELD, rxDictionary.Expand(rcv));
+
+    delete bus;
+}
+
+TEST(MarshalTest, MsgArgViewMatchesMsgArgs) {
+    QStatus status = ER_OK;
+
+    BusAttachment* bus = new BusAttachment("MsgArgViewMatchesMsgArgs", false);
+    bus->Start();
+
+    TestPipe stream;
+    TestPipe* pStream = &stream;
+    static const bool falsiness = false;
+    RemoteEndpoint ep(*bus, falsiness, String::Empty, pStream);
+
+    MsgArg vals[2];
+    vals[0].Set("u", 0x12345678);
+    vals[1].Set("(sd)", "pi", 3.14159);
+    MsgArg dict[2];
+    dict[0].Set("{sv}", "first", &vals[0]);
+    dict[1].Set("{sv}", "second", &vals[1]);
+    int32_t ai[] = { -1, 2, -3, 4 };
+    bool ab[] = { true, false, true };
+
+    MsgArg args[5];
+    args[0].Set("a{sv}", ArraySize(dict), dict);
+    args[1].Set("ai", ArraySize(ai), ai);
+    args[2].Set("ab", ArraySize(ab), ab);
+    args[3].Set("(sii)", "struct", 5, -6);
+    args[4].Set("t", 0x0102030405060708ULL);
+
+    MyMessage msg(*bus);
+    status = msg.MethodCall(":1.1", "/org/alljoyn/test/object", "org.alljoyn.test.Interface", "Method", args, ArraySize(args));
+    ASSERT_EQ(ER_OK, status);
+    status = msg.Deliver(ep);
+    ASSERT_EQ(ER_OK, status);
+
+    MyMessage rcv(*bus);
+    MsgArgView view;
+    EXPECT_EQ(ER_FAIL, rcv.GetArgView(view));
+    status = rcv.Read(ep, ":88.88");
+    ASSERT_EQ(ER_OK, status);
+    status = rcv.Unmarshal(ep, ":88.88");
+    ASSERT_EQ(ER_OK, status);
+    status = rcv.UnmarshalBody();
+    ASSERT_EQ(ER_OK, status);
+    ASSERT_EQ(ER_OK, rcv.GetArgView(view));
+
+    /* a{sv} */
+    MsgArgView dictView;
+    EXPECT_EQ(ALLJOYN_ARRAY, view.GetTypeId());
+    ASSERT_EQ(ER_OK, view.Recurse(dictView));
+    for (size_t i = 0; i < ArraySize(dict); ++i) {
+        MsgArgView entry, val;
+        const char* key;
+        ASSERT_FALSE(dictView.AtEnd());
+        EXPECT_EQ(ALLJOYN_DICT_ENTRY, dictView.GetTypeId());
+        ASSERT_EQ(ER_OK, dictView.Recurse(entry));
+        ASSERT_EQ(ER_OK, entry.GetString(key));
+        EXPECT_STREQ(dict[i].v_dictEntry.key->v_string.str, key);
+        EXPECT_EQ(ALLJOYN_VARIANT, entry.GetTypeId());
+        ASSERT_EQ(ER_OK, entry.Recurse(val));
+        EXPECT_TRUE(entry.AtEnd());
+        if (i == 0) {
+            int32_t n;
+            uint32_t u;
+            EXPECT_EQ(ER_BUS_SIGNATURE_MISMATCH, val.GetInt32(n));
+            ASSERT_EQ(ER_OK, val.GetUint32(u));
+            EXPECT_EQ(0x12345678U, u);
+        } else {
+            MsgArgView member;
+            const char* str;
+            size_t len;
+            double d;
+            ASSERT_EQ(ER_OK, val.Recurse(member));
+            ASSERT_EQ(ER_OK, member.GetString(str, &len));
+            EXPECT_STREQ("pi", str);
+            EXPECT_EQ(static_cast<size_t>(2), len);
+            ASSERT_EQ(ER_OK, member.GetDouble(d));
+            EXPECT_EQ(3.14159, d);
+            EXPECT_TRUE(member.AtEnd());
+        }
+        EXPECT_TRUE(val.AtEnd());
+    }
+    EXPECT_TRUE(dictView.AtEnd());
+
+    /* ai is returned in place */
+    const int32_t* elements;
+    size_t numElements;
+    EXPECT_EQ(ALLJOYN_INT32_ARRAY, view.GetTypeId());
+    ASSERT_EQ(ER_OK, view.GetArray(elements, numElements));
+    ASSERT_EQ(ArraySize(ai), numElements);
+    for (size_t i = 0; i < numElements; ++i) {
+        EXPECT_EQ(ai[i], elements[i]);
+    }
+
+    /* ab must be visited element by element */
+    MsgArgView boolView;
+    EXPECT_EQ(ALLJOYN_BOOLEAN_ARRAY, view.GetTypeId());
+    ASSERT_EQ(ER_OK, view.Recurse(boolView));
+    for (size_t i = 0; i < ArraySize(ab); ++i) {
+        bool b;
+        ASSERT_EQ(ER_OK, boolView.GetBool(b));
+        EXPECT_EQ(ab[i], b);
+    }
+    EXPECT_TRUE(boolView.AtEnd());
+
+    /* (sii) is skipped */
+    EXPECT_EQ(ALLJOYN_STRUCT, view.GetTypeId());
+    ASSERT_EQ(ER_OK, view.Next());
+
+    uint64_t t;
+    ASSERT_EQ(ER_OK, view.GetUint64(t));
+    EXPECT_EQ(0x0102030405060708ULL, t);
+    EXPECT_TRUE(view.AtEnd());
+    EXPECT_EQ(ER_BUS_SIGNATURE_MISMATCH, view.Next());
+
+    /* The MsgArgs are still available */
+    const char* str;
+    int32_t i1, i2;
+    status = rcv.GetArg(3)->Get("(sii)", &str, &i1, &i2);
+    ASSERT_EQ(ER_OK, status);
+    EXPECT_STREQ("struct", str);
+    EXPECT_EQ(5, i1);
+    EXPECT_EQ(-6, i2);
+    size_t numArgs;
+    const MsgArg* rcvArgs;
+    rcv.GetArgs(numArgs, rcvArgs);
+    ASSERT_EQ(ArraySize(args), numArgs);
+    EXPECT_TRUE(args[0] == rcvArgs[0]);
+    EXPECT_TRUE(args[1] == rcvArgs[1]);
+
+    delete bus;
+}
+
+class GetArgsThread : public Thread {
+  public:
+    GetArgsThread(MyMessage& msg) : Thread("GetArgsThread"), args(NULL), msg(msg) { }
+
+    const MsgArg* args;
+
+  private:
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        size_t numArgs;
+        msg.GetArgs(numArgs, args);
+        return 0;
+    }
+
+    MyMessage& msg;
+};
+
+TEST(MarshalTest, DeferredArgsAreBuiltOnce) {
+    QStatus status = ER_OK;
+
+    BusAttachment* bus = new BusAttachment("DeferredArgsAreBuiltOnce", false);
+    bus->Start();
+
+    TestPipe stream;
+    TestPipe* pStream = &stream;
+    static const bool falsiness = false;
+    RemoteEndpoint ep(*bus, falsiness, String::Empty, pStream);
+
+    int32_t ai[] = { -1, 2, -3, 4 };
+    MsgArg args[2];
+    args[0].Set("ai", ArraySize(ai), ai);
+    args[1].Set("(sii)", "struct", 5, -6);
+
+    MyMessage msg(*bus);
+    status = msg.Signal(":1.1", "/org/alljoyn/test/object", "org.alljoyn.test.Interface", "Changed", args, ArraySize(args));
+    ASSERT_EQ(ER_OK, status);
+    status = msg.Deliver(ep);
+    ASSERT_EQ(ER_OK, status);
+
+    MyMessage rcv(*bus);
+    status = rcv.Read(ep, ":88.88");
+    ASSERT_EQ(ER_OK, status);
+    status = rcv.Unmarshal(ep, ":88.88");
+    ASSERT_EQ(ER_OK, status);
+    status = rcv.UnmarshalBody(true);
+    ASSERT_EQ(ER_OK, status);
+
+    /* The view reads the body without the MsgArgs */
+    MsgArgView view;
+    const int32_t* elements;
+    size_t numElements;
+    ASSERT_EQ(ER_OK, rcv.GetArgView(view));
+    ASSERT_EQ(ER_OK, view.GetArray(elements, numElements));
+    ASSERT_EQ(ArraySize(ai), numElements);
+    EXPECT_EQ(ai[3], elements[3]);
+
+    /* A copy made before the MsgArgs are built builds its own */
+    MyMessage copy(rcv);
+    const char* str;
+    int32_t i1, i2;
+    status = copy.GetArg(1)->Get("(sii)", &str, &i1, &i2);
+    ASSERT_EQ(ER_OK, status);
+    EXPECT_STREQ("struct", str);
+    EXPECT_EQ(-6, i2);
+
+    /* Threads that ask for the MsgArgs at the same time all get the same ones */
+    GetArgsThread* threads[8];
+    for (size_t i = 0; i < ArraySize(threads); ++i) {
+        threads[i] = new GetArgsThread(rcv);
+    }
+    for (size_t i = 0; i < ArraySize(threads); ++i) {
+        ASSERT_EQ(ER_OK, threads[i]->Start());
+    }
+    for (size_t i = 0; i < ArraySize(threads); ++i) {
+        threads[i]->Join();
+    }
+    size_t numArgs;
+    const MsgArg* rcvArgs;
+    rcv.GetArgs(numArgs, rcvArgs);
+    ASSERT_EQ(ArraySize(args), numArgs);
+    ASSERT_TRUE(rcvArgs != NULL);
+    EXPECT_TRUE(args[0] == rcvArgs[0]);
+    EXPECT_TRUE(args[1] == rcvArgs[1]);
+    for (size_t i = 0; i < ArraySize(threads); ++i) {
+        EXPECT_EQ(rcvArgs, threads[i]->args);
+        delete threads[i];
+    }
+    EXPECT_TRUE(rcvArgs != copy.GetArg(0));
+
+    delete bus;
+}
+
+TEST(MarshalTest, MsgArgViewChecksValues) {
+    /* Signature "bsu": a boolean that is not 0 or 1, then an unterminated string */
+    uint64_t body[4] = { 0 };
+    uint8_t* p = reinterpret_cast<uint8_t*>(body);
+    *reinterpret_cast<uint32_t*>(p) = 2;
+    *reinterpret_cast<uint32_t*>(p + 4) = 3;
+    memcpy(p + 8, "abcd", 4);
+
+    bool b;
+    const char* str;
+    MsgArgView view("bsu", body, 16);
+    EXPECT_EQ(ALLJOYN_BOOLEAN, view.GetTypeId());
+    EXPECT_EQ(ER_BUS_BAD_VALUE, view.GetBool(b));
+
+    *reinterpret_cast<uint32_t*>(p) = 1;
+    view = MsgArgView("bsu", body, 16);
+    ASSERT_EQ(ER_OK, view.GetBool(b));
+    EXPECT_TRUE(b);
+    EXPECT_EQ(ER_BUS_NOT_NUL_TERMINATED, view.GetString(str));
+
+    /* Terminate the string but the body is too short for the uint32 */
+    p[11] = 0;
+    view = MsgArgView("bsu", body, 12);
+    ASSERT_EQ(ER_OK, view.Next());
+    ASSERT_EQ(ER_OK, view.GetString(str));
+    EXPECT_STREQ("abc", str);
+    EXPECT_EQ(ER_BUS_BAD_SIGNATURE, view.Next());
+
+    /* Values that are not in the native byte order */
+    *reinterpret_cast<uint32_t*>(p + 12) = EndianSwap32(0xA1B2C3D4);
+    uint32_t u;
+    view = MsgArgView("bsu", body, 16, true);
+    ASSERT_EQ(ER_BUS_BAD_VALUE, view.Next());
+    *reinterpret_cast<uint32_t*>(p) = EndianSwap32(1);
+    *reinterpret_cast<uint32_t*>(p + 4) = EndianSwap32(3);
+    view = MsgArgView("bsu", body, 16, true);
+    ASSERT_EQ(ER_OK, view.Next());
+    ASSERT_EQ(ER_OK, view.Next());
+    ASSERT_EQ(ER_OK, view.GetUint32(u));
+    EXPECT_EQ(0xA1B2C3D4, u);
+    EXPECT_TRUE(view.AtEnd());
+}
+
 
 /*--------------------------FUZZING TEST CODE---------------------------------*/
 static bool fuzzing = false;
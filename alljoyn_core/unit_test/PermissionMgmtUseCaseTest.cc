@@ -17,6 +17,7 @@
 #include "PermissionMgmtTest.h"
 #include "KeyInfoHelper.h"
 #include "KeyExchanger.h"
+#include "PeerState.h"
 #include <qcc/Crypto.h>
 #include <qcc/Util.h>
 #include <string>
@@ -3955,3 +3956,97 @@ TEST_F(PermissionMgmtUseCaseTest, InstallUnsignedManifestFails)
     /* Note that we don't call SignManifests on newManifests[0]. */
     EXPECT_EQ(ER_DIGEST_MISMATCH, saProxy.InstallManifests(newManifests, ArraySize(newManifests)));
 }
+
+TEST(PermissionMgmtAuthorizationCacheTest, HitAndMiss)
+{
+    PeerState peerState;
+    bool authorized = false;
+    uint32_t epoch;
+
+    EXPECT_FALSE(peerState->GetCachedAuthorization(1, "request", authorized, epoch));
+    peerState->CacheAuthorization(1, epoch, "request", true);
+    EXPECT_TRUE(peerState->GetCachedAuthorization(1, "request", authorized, epoch));
+    EXPECT_TRUE(authorized);
+
+    /* A different request or policy generation misses */
+    EXPECT_FALSE(peerState->GetCachedAuthorization(1, "other request", authorized, epoch));
+    EXPECT_FALSE(peerState->GetCachedAuthorization(2, "request", authorized, epoch));
+
+    /* A decision made with a newer policy replaces the old ones */
+    peerState->CacheAuthorization(2, epoch, "other request", false);
+    EXPECT_TRUE(peerState->GetCachedAuthorization(2, "other request", authorized, epoch));
+    EXPECT_FALSE(authorized);
+    EXPECT_FALSE(peerState->GetCachedAuthorization(1, "request", authorized, epoch));
+}
+
+TEST(PermissionMgmtAuthorizationCacheTest, InvalidatedByPeerChanges)
+{
+    PeerState peerState;
+    bool authorized;
+    uint32_t epoch;
+    uint8_t keyBytes[16] = { 0 };
+    KeyBlob key(keyBytes, sizeof(keyBytes), KeyBlob::AES);
+
+    peerState->GetCachedAuthorization(1, "request", authorized, epoch);
+    peerState->CacheAuthorization(1, epoch, "request", true);
+    peerState->SetKey(key, PEER_SESSION_KEY);
+    EXPECT_FALSE(peerState->GetCachedAuthorization(1, "request", authorized, epoch));
+
+    peerState->CacheAuthorization(1, epoch, "request", true);
+    peerState->SetGuildMetadata("1", "issuer", new _PeerState::GuildMetadata());
+    EXPECT_FALSE(peerState->GetCachedAuthorization(1, "request", authorized, epoch));
+
+    peerState->CacheAuthorization(1, epoch, "request", true);
+    peerState->ClearManifests();
+    EXPECT_FALSE(peerState->GetCachedAuthorization(1, "request", authorized, epoch));
+
+    peerState->CacheAuthorization(1, epoch, "request", true);
+    peerState->ClearKeys();
+    EXPECT_FALSE(peerState->GetCachedAuthorization(1, "request", authorized, epoch));
+
+    /* A decision made before the cache was cleared is not stored */
+    peerState->SetGuidAndAuthVersion(GUID128(), 0);
+    peerState->CacheAuthorization(1, epoch, "request", true);
+    EXPECT_FALSE(peerState->GetCachedAuthorization(1, "request", authorized, epoch));
+}
+
+TEST(PermissionMgmtAuthorizationCacheTest, ExpiresWithMembership)
+{
+    PeerState peerState;
+    bool authorized;
+    uint32_t epoch;
+    uint64_t now = GetEpochTimestamp() / 1000;
+
+    /* A membership certificate that expires in a second and one that is not valid yet */
+    CertificateX509::ValidPeriod validity;
+    validity.validFrom = now - 10;
+    validity.validTo = now + 1;
+    MembershipCertificate* expiring = new MembershipCertificate();
+    expiring->SetValidity(&validity);
+    _PeerState::GuildMetadata* guild = new _PeerState::GuildMetadata();
+    guild->certChain.push_back(expiring);
+    peerState->SetGuildMetadata("1", "issuer", guild);
+
+    validity.validFrom = now + 3600;
+    validity.validTo = now + 7200;
+    MembershipCertificate* future = new MembershipCertificate();
+    future->SetValidity(&validity);
+    guild = new _PeerState::GuildMetadata();
+    guild->certChain.push_back(future);
+    peerState->SetGuildMetadata("2", "issuer", guild);
+
+    uint64_t validUntil = peerState->GetMembershipsValidUntil();
+    EXPECT_EQ((now + 2) * 1000, validUntil);
+    EXPECT_FALSE(peerState->GetCachedAuthorization(1, "request", authorized, epoch));
+    peerState->CacheAuthorization(1, epoch, "request", true, validUntil);
+    EXPECT_TRUE(peerState->GetCachedAuthorization(1, "request", authorized, epoch));
+    EXPECT_TRUE(authorized);
+
+    while (GetEpochTimestamp() < validUntil) {
+        qcc::Sleep(100);
+    }
+    EXPECT_FALSE(peerState->GetCachedAuthorization(1, "request", authorized, epoch));
+
+    /* The expired certificate no longer changes decisions, the other one still will */
+    EXPECT_EQ((now + 3600) * 1000, peerState->GetMembershipsValidUntil());
+}
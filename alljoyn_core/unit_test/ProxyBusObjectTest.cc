@@ -20,6 +20,7 @@
 #include <qcc/Mutex.h>
 #include <qcc/Util.h>
 #include <alljoyn/Message.h>
+#include <alljoyn/MsgArgView.h>
 #include <alljoyn/BusAttachment.h>
 #include <alljoyn/BusObject.h>
 #include <alljoyn/DBusStd.h>
@@ -337,6 +338,79 @@ TEST_F(ProxyBusObjectTest, SecureConnection) {
     EXPECT_EQ(ER_OK, status);
 }
 
+class ArgViewBusObject : public BusObject {
+  public:
+    ArgViewBusObject(const InterfaceDescription& intf) : BusObject(OBJECT_PATH)
+    {
+        EXPECT_EQ(ER_OK, AddInterface(intf));
+        EXPECT_EQ(ER_OK, AddMethodHandler(intf.GetMember("sum"), static_cast<MessageReceiver::MethodHandler>(&ArgViewBusObject::Sum)));
+    }
+
+    void Sum(const InterfaceDescription::Member* member, Message& msg)
+    {
+        QCC_UNUSED(member);
+        MsgArgView view;
+        const int32_t* elements;
+        size_t numElements;
+        int32_t sum = 0;
+        QStatus status = msg->GetArgView(view);
+        if (status == ER_OK) {
+            status = view.GetArray(elements, numElements);
+        }
+        if (status == ER_OK) {
+            for (size_t i = 0; i < numElements; ++i) {
+                sum += elements[i];
+            }
+            MsgArg reply("i", sum);
+            MethodReply(msg, &reply, 1);
+        } else {
+            MethodReply(msg, status);
+        }
+    }
+};
+
+TEST_F(ProxyBusObjectTest, ArgViewMember) {
+    /* Both sides read the arguments of sum with a MsgArgView */
+    InterfaceDescription* serviceIntf = NULL;
+    QStatus status = servicebus.CreateInterface(INTERFACE_NAME, serviceIntf, false);
+    ASSERT_EQ(ER_OK, status);
+    ASSERT_EQ(ER_OK, serviceIntf->AddMember(MESSAGE_METHOD_CALL, "sum", "ai", "i", "in,out", MEMBER_ANNOTATE_ARG_VIEW));
+    serviceIntf->Activate();
+    ASSERT_TRUE(serviceIntf->GetMember("sum")->isArgView);
+
+    InterfaceDescription* clientIntf = NULL;
+    status = bus.CreateInterface(INTERFACE_NAME, clientIntf, false);
+    ASSERT_EQ(ER_OK, status);
+    ASSERT_EQ(ER_OK, clientIntf->AddMember(MESSAGE_METHOD_CALL, "sum", "ai", "i", "in,out", MEMBER_ANNOTATE_ARG_VIEW));
+    clientIntf->Activate();
+
+    ArgViewBusObject testObj(*serviceIntf);
+    ASSERT_EQ(ER_OK, servicebus.Start());
+    ASSERT_EQ(ER_OK, servicebus.Connect(ajn::getConnectArg().c_str()));
+    ASSERT_EQ(ER_OK, servicebus.RegisterBusObject(testObj));
+
+    ProxyBusObject proxy(bus, servicebus.GetUniqueName().c_str(), OBJECT_PATH, 0);
+    ASSERT_EQ(ER_OK, proxy.AddInterface(*clientIntf));
+
+    int32_t ai[] = { 1, -2, 3, 40 };
+    MsgArg arg("ai", ArraySize(ai), ai);
+    Message reply(bus);
+    status = proxy.MethodCall(INTERFACE_NAME, "sum", &arg, 1, reply);
+    ASSERT_EQ(ER_OK, status) << reply->GetErrorDescription().c_str();
+
+    MsgArgView view;
+    int32_t sum;
+    ASSERT_EQ(ER_OK, reply->GetArgView(view));
+    ASSERT_EQ(ER_OK, view.GetInt32(sum));
+    EXPECT_EQ(42, sum);
+
+    /* The MsgArgs are still built when they are asked for */
+    ASSERT_EQ(ER_OK, reply->GetArgs("i", &sum));
+    EXPECT_EQ(42, sum);
+
+    servicebus.UnregisterBusObject(testObj);
+}
+
 TEST_F(ProxyBusObjectTest, SecureConnectionAsync) {
     auth_complete_listener1_flag = false;
     auth_complete_listener2_flag = false;
@@ -15,6 +15,10 @@
  ******************************************************************************/
 #include <qcc/platform.h>
 
+#include <qcc/Socket.h>
+#include <qcc/SocketStream.h>
+
+#include "BusInternal.h"
 #include "RemoteEndpoint.h"
 
 /* Header files included for Google Test Framework */
@@ -198,6 +202,98 @@ TEST_F(RemoteEndpointTest, TxFail)
     EXPECT_TRUE(tts.closed);
 }
 
+/*
+ * Accepts a few bytes at a time so that writes of the same message to several
+ * endpoints are interleaved.
+ */
+class RecordingTestStream : public TestStream {
+  public:
+    Mutex lock;
+    vector<uint8_t> pushed;
+    RecordingTestStream() { sinkEvent.SetEvent(); }
+
+    virtual QStatus PushBytes(const void* buf, size_t numBytes, size_t& numSent) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(buf);
+        numSent = (numBytes < 7) ? numBytes : 7;
+        lock.Lock();
+        pushed.insert(pushed.end(), bytes, bytes + numSent);
+        lock.Unlock();
+        return ER_OK;
+    }
+
+    /* True once the pushed bytes hold the complete message described by the 16 byte fixed header */
+    bool IsComplete() {
+        bool complete = false;
+        lock.Lock();
+        if (pushed.size() >= 16) {
+            uint32_t bodyLen;
+            uint32_t headerLen;
+            memcpy(&bodyLen, &pushed[4], sizeof(bodyLen));
+            memcpy(&headerLen, &pushed[12], sizeof(headerLen));
+            complete = (pushed.size() == 16 + ((headerLen + 7) & ~7) + bodyLen);
+        }
+        lock.Unlock();
+        return complete;
+    }
+};
+
+TEST_F(RemoteEndpointTest, SharedMessageIsDeliveredToEachEndpoint)
+{
+    RecordingTestStream rts1;
+    RecordingTestStream rts2;
+    Stream* s1 = &rts1;
+    Stream* s2 = &rts2;
+    TestRemoteEndpoint trep1(":test.3", bus, incoming, connectSpec, s1);
+    TestRemoteEndpoint trep2(":test.4", bus, incoming, connectSpec, s2);
+    EXPECT_EQ(ER_OK, trep1->Start());
+    EXPECT_EQ(ER_OK, trep2->Start());
+
+    TestMessage tm(bus);
+    Message m = Message::cast(tm);
+    EXPECT_EQ(ER_OK, trep1->PushMessage(m));
+    EXPECT_EQ(ER_OK, trep2->PushMessage(m));
+    for (int i = 0; (i < 1000) && !(rts1.IsComplete() && rts2.IsComplete()); ++i) {
+        qcc::Sleep(10);
+    }
+    EXPECT_TRUE(rts1.IsComplete());
+    EXPECT_TRUE(rts2.IsComplete());
+    EXPECT_TRUE(rts1.pushed == rts2.pushed);
+
+    EXPECT_EQ(ER_OK, trep1->Stop());
+    EXPECT_EQ(ER_OK, trep2->Stop());
+    rts1.sourceEvent.SetEvent();
+    rts2.sourceEvent.SetEvent();
+    EXPECT_EQ(ER_OK, trep1->Join(40 * 1000));
+    EXPECT_EQ(ER_OK, trep2->Join(40 * 1000));
+}
+
+TEST_F(RemoteEndpointTest, StreamsAreSpreadAcrossIODispatchReactors)
+{
+    BusAttachment rb("RemoteEndpointTest.reactors");
+    EXPECT_EQ(ER_OK, rb.GetInternal().SetIODispatchCount(2));
+    EXPECT_EQ(ER_OK, rb.Start());
+    EXPECT_EQ(ER_BUS_BUS_ALREADY_STARTED, rb.GetInternal().SetIODispatchCount(3));
+    EXPECT_EQ(2U, rb.GetInternal().GetIODispatchCount());
+
+    TestStream ts1;
+    TestStream ts2;
+    Stream* s1 = &ts1;
+    Stream* s2 = &ts2;
+    TestRemoteEndpoint trep1(":test.3", rb, incoming, connectSpec, s1);
+    TestRemoteEndpoint trep2(":test.4", rb, incoming, connectSpec, s2);
+    EXPECT_EQ(ER_OK, trep1->Start());
+    EXPECT_EQ(ER_OK, trep2->Start());
+    /* Only one of the two streams is on the first reactor */
+    EXPECT_EQ(1U, rb.GetInternal().GetIODispatch().GetNumStreams());
+
+    EXPECT_EQ(ER_OK, trep1->Stop());
+    EXPECT_EQ(ER_OK, trep2->Stop());
+    ts1.sourceEvent.SetEvent();
+    ts2.sourceEvent.SetEvent();
+    EXPECT_EQ(ER_OK, trep1->Join(40 * 1000));
+    EXPECT_EQ(ER_OK, trep2->Join(40 * 1000));
+}
+
 #ifdef ROUTER
 #include "DaemonRouter.h"
 
@@ -228,6 +324,274 @@ TEST_F(RemoteEndpointTest, TxMaxControlMessages)
     EXPECT_TRUE(tts.aborted);
     EXPECT_TRUE(tts.closed);
 }
+
+/*
+ * Serves a fixed byte sequence, counting the number of reads made of it.
+ */
+class RxTestStream : public TestStream {
+  public:
+    vector<uint8_t> bytes;
+    size_t pos;
+    size_t numPulls;
+    RxTestStream(const vector<uint8_t>& bytes) : bytes(bytes), pos(0), numPulls(0) { }
+
+    virtual QStatus PullBytes(void* buf, size_t reqBytes, size_t& actualBytes, uint32_t) {
+        ++numPulls;
+        if (pos == bytes.size()) {
+            actualBytes = 0;
+            return ER_TIMEOUT;
+        }
+        actualBytes = (std::min)(reqBytes, bytes.size() - pos);
+        memcpy(buf, &bytes[pos], actualBytes);
+        pos += actualBytes;
+        if (pos == bytes.size()) {
+            sourceEvent.ResetEvent();
+        }
+        return ER_OK;
+    }
+};
+
+TEST_F(RemoteEndpointTest, RxBurstIsReadInOnePull)
+{
+    TestBusAttachment tb;
+    EXPECT_EQ(ER_OK, tb.Start());
+
+    /* Capture the wire format of a signal */
+    RecordingTestStream rts;
+    Stream* s1 = &rts;
+    TestRemoteEndpoint txrep(":test.3", tb, incoming, connectSpec, s1);
+    EXPECT_EQ(ER_OK, txrep->Start());
+    TestMessage tm(tb, "sender.1");
+    Message m = Message::cast(tm);
+    EXPECT_EQ(ER_OK, txrep->PushMessage(m));
+    for (int i = 0; (i < 1000) && !rts.IsComplete(); ++i) {
+        qcc::Sleep(10);
+    }
+    ASSERT_TRUE(rts.IsComplete());
+    EXPECT_EQ(ER_OK, txrep->Stop());
+    rts.sourceEvent.SetEvent();
+    EXPECT_EQ(ER_OK, txrep->Join(40 * 1000));
+
+    const size_t numMsgs = 20;
+    vector<uint8_t> burst;
+    for (size_t i = 0; i < numMsgs; ++i) {
+        burst.insert(burst.end(), rts.pushed.begin(), rts.pushed.end());
+    }
+    RxTestStream rxts(burst);
+    rxts.sourceEvent.SetEvent();
+    Stream* s2 = &rxts;
+    TestRemoteEndpoint rxrep(":test.4", tb, incoming, connectSpec, s2);
+    EXPECT_EQ(ER_OK, rxrep->Start());
+    for (int i = 0; (i < 1000) && (rxts.pos != burst.size()); ++i) {
+        qcc::Sleep(10);
+    }
+    EXPECT_EQ(burst.size(), rxts.pos);
+    /* One read for the whole burst plus one that finds no more data */
+    EXPECT_GE(2U, rxts.numPulls);
+    EXPECT_FALSE(rxts.aborted);
+
+    EXPECT_EQ(ER_OK, rxrep->Stop());
+    rxts.sourceEvent.SetEvent();
+    EXPECT_EQ(ER_OK, rxrep->Join(40 * 1000));
+}
+
+/*
+ * Accepts at most maxPush bytes per write once unblocked and records the
+ * number of writes made.
+ */
+class GatherTestStream : public TestStream {
+  public:
+    Mutex lock;
+    vector<uint8_t> pushed;
+    size_t maxPush;
+    size_t numWrites;
+    volatile bool blocked;
+    GatherTestStream(size_t maxPush) : maxPush(maxPush), numWrites(0), blocked(true) { }
+
+    virtual QStatus PushBytes(const void* buf, size_t numBytes, size_t& numSent) {
+        IOVec iov;
+        iov.buf = reinterpret_cast<char*>(const_cast<void*>(buf));
+        iov.len = numBytes;
+        return PushBytesV(&iov, 1, numSent);
+    }
+
+    virtual QStatus PushBytesV(const IOVec* iov, size_t numIov, size_t& numSent) {
+        numSent = 0;
+        if (blocked) {
+            sinkEvent.ResetEvent();
+            return ER_TIMEOUT;
+        }
+        lock.Lock();
+        ++numWrites;
+        for (size_t i = 0; (i < numIov) && (numSent < maxPush); ++i) {
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(iov[i].buf);
+            size_t n = (std::min)(static_cast<size_t>(iov[i].len), maxPush - numSent);
+            pushed.insert(pushed.end(), bytes, bytes + n);
+            numSent += n;
+        }
+        lock.Unlock();
+        return ER_OK;
+    }
+
+    /* Number of complete messages in the pushed bytes, 0 if the bytes do not end on a message boundary */
+    size_t NumMessages() {
+        size_t numMsgs = 0;
+        size_t pos = 0;
+        lock.Lock();
+        while ((pos + 16) <= pushed.size()) {
+            uint32_t bodyLen;
+            uint32_t headerLen;
+            memcpy(&bodyLen, &pushed[pos + 4], sizeof(bodyLen));
+            memcpy(&headerLen, &pushed[pos + 12], sizeof(headerLen));
+            pos += 16 + ((headerLen + 7) & ~7) + bodyLen;
+            ++numMsgs;
+        }
+        if (pos != pushed.size()) {
+            numMsgs = 0;
+        }
+        lock.Unlock();
+        return numMsgs;
+    }
+};
+
+/*
+ * Routers queue up to maxControlMessages control messages on an endpoint so
+ * those are the messages that can be gathered.
+ */
+static void DeliverQueuedMessages(BusAttachment& bus, GatherTestStream& gts, size_t numMsgs)
+{
+    Stream* s = &gts;
+    bool incoming = false;
+    String connectSpec;
+    TestRemoteEndpoint trep(":test.3", bus, incoming, connectSpec, s);
+    EXPECT_EQ(ER_OK, trep->Start());
+    for (size_t i = 0; i < numMsgs; ++i) {
+        TestMessage tm(bus, "sender.1");
+        Message m = Message::cast(tm);
+        EXPECT_EQ(ER_OK, trep->PushMessage(m));
+    }
+    gts.blocked = false;
+    gts.sinkEvent.SetEvent();
+    for (int i = 0; (i < 1000) && (gts.NumMessages() != numMsgs); ++i) {
+        qcc::Sleep(10);
+    }
+    EXPECT_EQ(numMsgs, gts.NumMessages());
+
+    EXPECT_EQ(ER_OK, trep->Stop());
+    gts.sourceEvent.SetEvent();
+    EXPECT_EQ(ER_OK, trep->Join(40 * 1000));
+}
+
+TEST_F(RemoteEndpointTest, QueuedMessagesAreGatheredIntoOneWrite)
+{
+    TestBusAttachment tb;
+    EXPECT_EQ(ER_OK, tb.Start());
+    GatherTestStream gts(static_cast<size_t>(-1));
+    DeliverQueuedMessages(tb, gts, 8);
+    EXPECT_EQ(1U, gts.numWrites);
+}
+
+TEST_F(RemoteEndpointTest, PartiallyGatheredWriteIsResumed)
+{
+    TestBusAttachment tb;
+    EXPECT_EQ(ER_OK, tb.Start());
+    GatherTestStream gts(50);
+    DeliverQueuedMessages(tb, gts, 8);
+}
+class EstablishThread : public Thread {
+  public:
+    EstablishThread(RemoteEndpoint& ep) : Thread("EstablishThread"), ep(ep), result(ER_FAIL) { }
+    QStatus GetResult() const { return result; }
+  protected:
+    ThreadReturn STDCALL Run(void* arg) {
+        QCC_UNUSED(arg);
+        String authUsed;
+        String redirection;
+        result = ep->Establish("ANONYMOUS", authUsed, redirection, NULL, 5000);
+        return static_cast<ThreadReturn>(0);
+    }
+  private:
+    RemoteEndpoint& ep;
+    QStatus result;
+};
+
+/*
+ * Two bus-to-bus endpoints negotiate header compression in the BusHello
+ * exchange and both ends count the header bytes saved on the link.
+ */
+TEST(RemoteEndpointHeaderCompressionTest, StatsCountCompressedHeaders)
+{
+    BusAttachment clientBus("HeaderCompressionClient");
+    TestBusAttachment serverBus;
+    ASSERT_EQ(ER_OK, clientBus.Start());
+    ASSERT_EQ(ER_OK, serverBus.Start());
+    SocketFd fds[2];
+    ASSERT_EQ(ER_OK, SocketPair(fds));
+    ASSERT_EQ(ER_OK, SetBlocking(fds[0], false));
+    ASSERT_EQ(ER_OK, SetBlocking(fds[1], false));
+    SocketStream clientStream(fds[0]);
+    SocketStream serverStream(fds[1]);
+
+    bool outgoing = false;
+    bool incoming = true;
+    String connectSpec;
+    Stream* cs = &clientStream;
+    Stream* ss = &serverStream;
+    RemoteEndpoint client(clientBus, outgoing, connectSpec, cs);
+    RemoteEndpoint server(serverBus, incoming, connectSpec, ss);
+    client->GetFeatures().isBusToBus = true;
+    client->GetFeatures().allowRemote = true;
+
+    EstablishThread serverThread(server);
+    ASSERT_EQ(ER_OK, serverThread.Start());
+    String authUsed;
+    String redirection;
+    EXPECT_EQ(ER_OK, client->Establish("ANONYMOUS", authUsed, redirection, NULL, 5000));
+    serverThread.Join();
+    ASSERT_EQ(ER_OK, serverThread.GetResult());
+    ASSERT_TRUE(server->GetFeatures().isBusToBus);
+    EXPECT_EQ(static_cast<uint32_t>(ALLJOYN_PROTOCOL_VERSION), client->GetRemoteProtocolVersion());
+    EXPECT_EQ(static_cast<uint32_t>(ALLJOYN_PROTOCOL_VERSION), server->GetRemoteProtocolVersion());
+    /*
+     * The test bus has no AllJoynObj to manage bus-to-bus endpoints so the
+     * accepting endpoint is registered as a trusted client connection.
+     * Header compression was negotiated by Establish() and stays on.
+     */
+    server->GetFeatures().isBusToBus = false;
+    server->GetFeatures().trusted = true;
+    ASSERT_EQ(ER_OK, client->Start());
+    ASSERT_EQ(ER_OK, server->Start());
+
+    /* Identical header fields after the first message are sent as references */
+    for (int i = 0; i < 10; ++i) {
+        TestMessage tm(clientBus, client->GetUniqueName().c_str());
+        Message m = Message::cast(tm);
+        EXPECT_EQ(ER_OK, client->PushMessage(m));
+    }
+    uint64_t txSaved = 0;
+    uint64_t rxSaved = 0;
+    uint64_t unused;
+    for (int i = 0; i < 500; ++i) {
+        client->GetHeaderCompressionStats(txSaved, unused);
+        server->GetHeaderCompressionStats(unused, rxSaved);
+        if ((rxSaved > 0) && (rxSaved == txSaved)) {
+            break;
+        }
+        qcc::Sleep(10);
+    }
+    EXPECT_GT(txSaved, 0U);
+    EXPECT_EQ(txSaved, rxSaved);
+
+    client->Stop();
+    server->Stop();
+    client->Join();
+    server->Join();
+    clientBus.Stop();
+    serverBus.Stop();
+    clientBus.Join();
+    serverBus.Join();
+}
+
 #endif /* ROUTER */
 
 static ThreadReturn STDCALL PushMessages(void* arg)
@@ -259,3 +623,48 @@ TEST_F(RemoteEndpointTest, CreateDestroy)
         TestRemoteEndpoint trep(":test.3", bus, incoming, connectSpec, s);
     }
 }
+
+/*
+ * A peer that sends its SASL commands but never reads its replies must not
+ * block authentication for longer than the send timeout of the stream.
+ */
+TEST(RemoteEndpointAuthTest, EstablishNonBlockingFailsWhenPeerNeverReads)
+{
+    BusAttachment bus("RemoteEndpointAuthTest");
+    ASSERT_EQ(ER_OK, bus.Start());
+    SocketFd fds[2];
+    ASSERT_EQ(ER_OK, SocketPair(fds));
+    ASSERT_EQ(ER_OK, SetBlocking(fds[0], false));
+    SocketStream stream(fds[0]);
+
+    /* Fill the socket buffers, the peer never reads any of it */
+    uint8_t junk[1024] = { 0 };
+    size_t sent;
+    stream.SetSendTimeout(0);
+    while (stream.PushBytes(junk, sizeof(junk), sent) == ER_OK) {
+    }
+    stream.SetSendTimeout(500);
+
+    const char* auth = "AUTH ANONYMOUS\r\n";
+    ASSERT_EQ(ER_OK, Send(fds[1], auth, strlen(auth), sent));
+
+    bool incoming = true;
+    String connectSpec;
+    Stream* s = &stream;
+    RemoteEndpoint rep(bus, incoming, connectSpec, s);
+    String authUsed;
+    String redirection;
+    uint64_t start = GetTimestamp64();
+    QStatus status = rep->EstablishNonBlocking("ANONYMOUS", authUsed, redirection);
+    uint64_t elapsed = GetTimestamp64() - start;
+    EXPECT_NE(ER_OK, status);
+    EXPECT_NE(ER_TIMEOUT, status);
+    EXPECT_GE(elapsed, 400U);
+    EXPECT_LT(elapsed, 10000U);
+    rep->AbortEstablish();
+
+    Close(fds[1]);
+    bus.Stop();
+    bus.Join();
+}
+
@@ -789,6 +789,156 @@ TEST_F(SignalTest, BackPressure) {
 }
 #endif
 
+/*
+ * Records the order signals arrive from each sender. The handler enables concurrent callbacks
+ * so later signals can be dispatched while earlier ones are still being handled.
+ */
+class OrderedReceiver : public SignalReceiver {
+  public:
+    OrderedReceiver(uint32_t workTime = 20) : workTime(workTime), active(0), maxActive(0), outOfOrder(0) { }
+
+    virtual void RegisterSignalHandler(const InterfaceDescription::Member* member) {
+        QStatus status = participant->bus.RegisterSignalHandler(this,
+                                                                static_cast<MessageReceiver::SignalHandler>(&OrderedReceiver::SignalHandler),
+                                                                member,
+                                                                NULL);
+        EXPECT_EQ(ER_OK, status);
+    }
+
+    void SignalHandler(const InterfaceDescription::Member* member, const char* sourcePath, Message& msg) {
+        QCC_UNUSED(member);
+        QCC_UNUSED(sourcePath);
+
+        lock.Lock();
+        uint32_t& last = lastSerial[msg->GetSender()];
+        if (msg->GetCallSerial() <= last) {
+            ++outOfOrder;
+        }
+        last = msg->GetCallSerial();
+        maxActive = max(maxActive, ++active);
+        lock.Unlock();
+
+        participant->bus.EnableConcurrentCallbacks();
+        if (workTime) {
+            qcc::Sleep(workTime);
+        }
+
+        lock.Lock();
+        --active;
+        ++signalReceived;
+        lock.Unlock();
+    }
+
+    int Received() {
+        lock.Lock();
+        int received = signalReceived;
+        lock.Unlock();
+        return received;
+    }
+
+    uint32_t workTime;
+    qcc::Mutex lock;
+    std::map<qcc::String, uint32_t> lastSerial;
+    int active;
+    int maxActive;
+    int outOfOrder;
+};
+
+TEST_F(SignalTest, ConcurrentCallbacksKeepSenderOrder) {
+    Participant A("null:");
+    Participant B("null:");
+    Participant C("null:");
+
+    if (A.inited && B.inited && C.inited) {
+        OrderedReceiver recvA;
+        recvA.Register(&A);
+
+        for (uint32_t i = 0; i < BACKPRESSURE_TEST_NUM_SIGNALS; i++) {
+            EXPECT_EQ(ER_OK, B.busobj->SendSignal(A.name.c_str(), 0, 0));
+            EXPECT_EQ(ER_OK, C.busobj->SendSignal(A.name.c_str(), 0, 0));
+        }
+        wait_for_signal();
+
+        EXPECT_EQ(0, recvA.outOfOrder);
+        EXPECT_LT(1, recvA.maxActive);
+        recvA.verify_recv(2 * BACKPRESSURE_TEST_NUM_SIGNALS);
+    }
+}
+
+class SignalSender : public Thread {
+  public:
+    SignalSender(Participant& sender, const qcc::String& dest, uint32_t count) :
+        Thread("SignalSender"), sender(sender), dest(dest), count(count), failed(0) { }
+
+    Participant& sender;
+    qcc::String dest;
+    uint32_t count;
+    uint32_t failed;
+
+  protected:
+    qcc::ThreadReturn STDCALL Run(void* arg) {
+        QCC_UNUSED(arg);
+        for (uint32_t i = 0; i < count; i++) {
+            if (sender.busobj->SendSignal(dest.c_str(), 0, 0) != ER_OK) {
+                ++failed;
+            }
+        }
+        return 0;
+    }
+};
+
+/*
+ * Many senders sending at once to one receiver, with handlers that return at once and with
+ * handlers that run concurrently for a millisecond. Checks that the signals of each sender are
+ * dispatched in order and prints the dispatch times.
+ */
+TEST_F(SignalTest, ManySendersKeepSenderOrder) {
+    const uint32_t numSenders = 4;
+    const uint32_t numSignals = 1000;
+    const uint32_t workTimes[] = { 0, 1 };
+
+    for (size_t w = 0; w < sizeof(workTimes) / sizeof(workTimes[0]); w++) {
+        Participant A("null:");
+        std::vector<Participant*> senders;
+        bool inited = A.inited;
+        for (uint32_t i = 0; i < numSenders; i++) {
+            senders.push_back(new Participant("null:"));
+            inited = inited && senders[i]->inited;
+        }
+
+        if (inited) {
+            OrderedReceiver recvA(workTimes[w]);
+            recvA.Register(&A);
+
+            std::vector<SignalSender*> threads;
+            for (uint32_t i = 0; i < numSenders; i++) {
+                threads.push_back(new SignalSender(*senders[i], A.name, numSignals));
+            }
+            uint64_t start = GetTimestamp64();
+            for (uint32_t i = 0; i < numSenders; i++) {
+                EXPECT_EQ(ER_OK, threads[i]->Start());
+            }
+            for (uint32_t i = 0; (recvA.Received() < static_cast<int>(numSenders * numSignals)) && (i < 3000); i++) {
+                qcc::Sleep(10);
+            }
+            uint64_t elapsed = GetTimestamp64() - start;
+            for (uint32_t i = 0; i < numSenders; i++) {
+                threads[i]->Join();
+                EXPECT_EQ(0U, threads[i]->failed);
+                delete threads[i];
+            }
+            printf("Dispatched %u signals from %u senders with %u ms handlers in %" PRIu64 " ms\n",
+                   numSenders * numSignals, numSenders, workTimes[w], elapsed);
+
+            EXPECT_EQ(0, recvA.outOfOrder);
+            recvA.verify_recv(numSenders * numSignals);
+        }
+        for (uint32_t i = 0; i < numSenders; i++) {
+            delete senders[i];
+        }
+    }
+}
+
 QStatus SetMemberDescription(InterfaceDescription* intf)
 {
     return intf->SetMemberDescription("my_signal", "my_signal description");
@@ -0,0 +1,129 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+
+#include <alljoyn/DBusStd.h>
+#include "NameTable.h"
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "../ajTestCommon.h"
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+namespace {
+
+class _TestEndpoint : public _BusEndpoint {
+  public:
+    _TestEndpoint(const char* uniqueName) : _BusEndpoint(ENDPOINT_TYPE_NULL), uniqueName(uniqueName) { }
+    QStatus PushMessage(Message& msg) { QCC_UNUSED(msg); return ER_OK; }
+    const qcc::String& GetUniqueName() const { return uniqueName; }
+  private:
+    qcc::String uniqueName;
+};
+typedef ManagedObj<_TestEndpoint> TestEndpoint;
+
+}
+
+class NameTableTest : public testing::Test {
+  public:
+    virtual void SetUp()
+    {
+        TestEndpoint tep1(":a.1");
+        TestEndpoint tep2(":a.2");
+        ep1 = BusEndpoint::cast(tep1);
+        ep2 = BusEndpoint::cast(tep2);
+        nameTable.AddUniqueName(ep1);
+        nameTable.AddUniqueName(ep2);
+    }
+
+    virtual void TearDown()
+    {
+        nameTable.RemoveUniqueName(ep1->GetUniqueName());
+        nameTable.RemoveUniqueName(ep2->GetUniqueName());
+    }
+
+    NameTable nameTable;
+    BusEndpoint ep1;
+    BusEndpoint ep2;
+};
+
+TEST_F(NameTableTest, FindEndpoint)
+{
+    EXPECT_EQ(ep1, nameTable.FindEndpoint(":a.1"));
+    EXPECT_EQ(ep2, nameTable.FindEndpoint(":a.2"));
+    EXPECT_FALSE(nameTable.FindEndpoint(":a.3")->IsValid());
+    EXPECT_FALSE(nameTable.FindEndpoint("org.example.alias")->IsValid());
+
+    uint32_t disposition;
+    EXPECT_EQ(ER_OK, nameTable.AddAlias("org.example.alias", ":a.1", 0, disposition));
+    EXPECT_EQ((uint32_t)DBUS_REQUEST_NAME_REPLY_PRIMARY_OWNER, disposition);
+    EXPECT_EQ(ep1, nameTable.FindEndpoint("org.example.alias"));
+
+    vector<BusEndpoint> eps;
+    nameTable.GetAllBusEndpoints(eps);
+    EXPECT_EQ(2U, eps.size());
+}
+
+TEST_F(NameTableTest, IsAlias)
+{
+    uint32_t disposition;
+    EXPECT_EQ(ER_OK, nameTable.AddAlias("org.example.alias", ":a.1", 0, disposition));
+
+    EXPECT_TRUE(nameTable.IsAlias(":a.1", "org.example.alias"));
+    EXPECT_TRUE(nameTable.IsAlias("org.example.alias", ":a.1"));
+    EXPECT_TRUE(nameTable.IsAlias(":a.2", ":a.2"));
+    EXPECT_FALSE(nameTable.IsAlias(":a.2", "org.example.alias"));
+    EXPECT_FALSE(nameTable.IsAlias("org.example.none", "org.example.none"));
+}
+
+TEST_F(NameTableTest, QueuedOwnerTakesOverAlias)
+{
+    uint32_t disposition;
+    EXPECT_EQ(ER_OK, nameTable.AddAlias("org.example.alias", ":a.1", 0, disposition));
+    EXPECT_EQ(ER_OK, nameTable.AddAlias("org.example.alias", ":a.2", 0, disposition));
+    EXPECT_EQ((uint32_t)DBUS_REQUEST_NAME_REPLY_IN_QUEUE, disposition);
+    EXPECT_EQ(ep1, nameTable.FindEndpoint("org.example.alias"));
+
+    nameTable.RemoveAlias("org.example.alias", ":a.1", disposition);
+    EXPECT_EQ((uint32_t)DBUS_RELEASE_NAME_REPLY_RELEASED, disposition);
+    EXPECT_EQ(ep2, nameTable.FindEndpoint("org.example.alias"));
+    EXPECT_TRUE(nameTable.IsAlias(":a.2", "org.example.alias"));
+
+    nameTable.RemoveUniqueName(":a.2");
+    EXPECT_FALSE(nameTable.FindEndpoint(":a.2")->IsValid());
+    EXPECT_FALSE(nameTable.FindEndpoint("org.example.alias")->IsValid());
+}
+
+TEST_F(NameTableTest, SnapshotIsNotChangedByLaterUpdates)
+{
+    std::shared_ptr<const NameTable::Snapshot> before = nameTable.GetSnapshot();
+
+    uint32_t disposition;
+    EXPECT_EQ(ER_OK, nameTable.AddAlias("org.example.alias", ":a.1", 0, disposition));
+    nameTable.RemoveUniqueName(":a.2");
+
+    EXPECT_FALSE(before->FindEndpoint("org.example.alias")->IsValid());
+    EXPECT_EQ(ep2, before->FindEndpoint(":a.2"));
+    EXPECT_EQ(2U, before->GetAllBusEndpoints().size());
+
+    std::shared_ptr<const NameTable::Snapshot> after = nameTable.GetSnapshot();
+    EXPECT_EQ(ep1, after->FindEndpoint("org.example.alias"));
+    EXPECT_FALSE(after->FindEndpoint(":a.2")->IsValid());
+    EXPECT_EQ(1U, after->GetAllBusEndpoints().size());
+}
@@ -0,0 +1,144 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+
+#include <set>
+
+#include <qcc/Util.h>
+#include <alljoyn/Message.h>
+#include "RuleTable.h"
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "../ajTestCommon.h"
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+namespace {
+
+class _TestMessage : public _Message {
+  public:
+    _TestMessage(BusAttachment& bus, const HeaderFields& hdrFields) : _Message(bus, hdrFields) { }
+};
+typedef ManagedObj<_TestMessage> TestMessage;
+
+class _TestEndpoint : public _BusEndpoint {
+  public:
+    _TestEndpoint() : _BusEndpoint(ENDPOINT_TYPE_NULL) { }
+    QStatus PushMessage(Message& msg) { QCC_UNUSED(msg); return ER_OK; }
+};
+typedef ManagedObj<_TestEndpoint> TestEndpoint;
+
+}
+
+class RuleTableTest : public testing::Test {
+  public:
+    RuleTableTest() : bus(NULL) { }
+
+    virtual void SetUp()
+    {
+        for (size_t i = 0; i < ArraySize(eps); ++i) {
+            TestEndpoint tep;
+            eps[i] = BusEndpoint::cast(tep);
+        }
+    }
+
+    Message GenSignal(const char* path, const char* iface, const char* member, const char* sender)
+    {
+        HeaderFields hdrFields;
+        hdrFields.field[ALLJOYN_HDR_FIELD_PATH].Set("o", path);
+        hdrFields.field[ALLJOYN_HDR_FIELD_INTERFACE].Set("s", iface);
+        hdrFields.field[ALLJOYN_HDR_FIELD_MEMBER].Set("s", member);
+        hdrFields.field[ALLJOYN_HDR_FIELD_SENDER].Set("s", sender);
+        TestMessage msg(bus, hdrFields);
+        return Message::cast(msg);
+    }
+
+    set<BusEndpoint> Candidates(const Message& msg)
+    {
+        set<BusEndpoint> candidates;
+        ruleTable.GetCandidateEndpoints(msg, candidates);
+        return candidates;
+    }
+
+    BusAttachment bus;
+    RuleTable ruleTable;
+    BusEndpoint eps[5];
+};
+
+TEST_F(RuleTableTest, CandidatesAreFoundThroughTheMostSelectiveField)
+{
+    ruleTable.AddRule(eps[0], Rule("type='signal',interface='org.test.A',member='Changed'"));
+    ruleTable.AddRule(eps[1], Rule("type='signal',member='Changed'"));
+    ruleTable.AddRule(eps[2], Rule("type='signal',path='/a'"));
+    ruleTable.AddRule(eps[3], Rule("type='signal',sender=':1.1'"));
+    ruleTable.AddRule(eps[4], Rule("type='signal',interface='org.test.B'"));
+
+    set<BusEndpoint> c = Candidates(GenSignal("/a", "org.test.A", "Changed", ":1.2"));
+    EXPECT_EQ(3U, c.size());
+    EXPECT_EQ(1U, c.count(eps[0]));
+    EXPECT_EQ(1U, c.count(eps[1]));
+    EXPECT_EQ(1U, c.count(eps[2]));
+
+    c = Candidates(GenSignal("/b", "org.test.B", "Other", ":1.1"));
+    EXPECT_EQ(2U, c.size());
+    EXPECT_EQ(1U, c.count(eps[3]));
+    EXPECT_EQ(1U, c.count(eps[4]));
+
+    EXPECT_TRUE(Candidates(GenSignal("/b", "org.test.C", "Other", ":1.2")).empty());
+}
+
+TEST_F(RuleTableTest, WildcardRulesAreAlwaysCandidates)
+{
+    ruleTable.AddRule(eps[0], Rule("type='signal'"));
+    ruleTable.AddRule(eps[1], Rule("type='signal',interface='org.test.A'"));
+
+    set<BusEndpoint> c = Candidates(GenSignal("/b", "org.test.B", "Other", ":1.2"));
+    EXPECT_EQ(1U, c.size());
+    EXPECT_EQ(1U, c.count(eps[0]));
+}
+
+TEST_F(RuleTableTest, SessionlessRulesAreNotCandidates)
+{
+    ruleTable.AddRule(eps[0], Rule("type='signal',interface='org.test.A',sessionless='t'"));
+
+    EXPECT_TRUE(Candidates(GenSignal("/a", "org.test.A", "Changed", ":1.2")).empty());
+
+    Rule rule("type='signal',interface='org.test.A'");
+    EXPECT_EQ(ER_OK, ruleTable.RemoveRule(eps[0], rule));
+    EXPECT_TRUE(Candidates(GenSignal("/a", "org.test.A", "Changed", ":1.2")).empty());
+}
+
+TEST_F(RuleTableTest, RemovedRulesAreNotCandidates)
+{
+    Rule rule("type='signal',interface='org.test.A'");
+    ruleTable.AddRule(eps[0], rule);
+    ruleTable.AddRule(eps[0], rule);
+    ruleTable.AddRule(eps[1], rule);
+    ruleTable.AddRule(eps[2], Rule("type='signal'"));
+    Message msg = GenSignal("/a", "org.test.A", "Changed", ":1.2");
+
+    EXPECT_EQ(ER_OK, ruleTable.RemoveRule(eps[0], rule));
+    EXPECT_EQ(3U, Candidates(msg).size());
+    EXPECT_EQ(ER_OK, ruleTable.RemoveRule(eps[0], rule));
+    EXPECT_EQ(0U, Candidates(msg).count(eps[0]));
+
+    ruleTable.RemoveAllRules(eps[1]);
+    ruleTable.RemoveAllRules(eps[2]);
+    EXPECT_TRUE(Candidates(msg).empty());
+}
@@ -0,0 +1,162 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+
+#include <set>
+#include <vector>
+
+#include <qcc/String.h>
+#include <qcc/Util.h>
+#include "BusUtil.h"
+#include "WildcardTrie.h"
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "../ajTestCommon.h"
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+TEST(WildcardTrieTest, MatchPattern)
+{
+    WildcardTrie<String> trie;
+    trie.Insert("org.alljoyn.About", "a");
+    trie.Insert("org.alljoyn.Bus", "b");
+    trie.Insert("org.example.Bus", "c");
+    trie.Insert("org.alljoyn", "d");
+
+    EXPECT_TRUE(trie.MatchPattern("org.alljoyn.Bus"));
+    EXPECT_FALSE(trie.MatchPattern("org.alljoyn.Bu"));
+    EXPECT_TRUE(trie.MatchPattern("org.alljoyn.*"));
+    EXPECT_FALSE(trie.MatchPattern("org.alljoyn.Z*"));
+    EXPECT_TRUE(trie.MatchPattern("*"));
+    EXPECT_FALSE(trie.MatchPattern(""));
+
+    set<String> values;
+    trie.MatchPattern("org.alljoyn*", values);
+    EXPECT_EQ((size_t)3, values.size());
+    EXPECT_TRUE(values.find("d") != values.end());
+
+    values.clear();
+    trie.MatchPattern("org.*.Bus", values);
+    EXPECT_EQ((size_t)2, values.size());
+    EXPECT_TRUE(values.find("b") != values.end());
+    EXPECT_TRUE(values.find("c") != values.end());
+
+    values.clear();
+    trie.MatchPattern("org.alljoyn.?us", values);
+    EXPECT_EQ((size_t)1, values.size());
+    EXPECT_TRUE(values.find("b") != values.end());
+}
+
+TEST(WildcardTrieTest, MatchName)
+{
+    WildcardTrie<String> trie;
+    trie.Insert("org.alljoyn.*", "a");
+    trie.Insert("org.alljoyn.Bus", "b");
+    trie.Insert("*", "c");
+    trie.Insert("org.?lljoyn.Bus", "d");
+    trie.Insert("com.*", "e");
+
+    set<String> values;
+    trie.MatchName("org.alljoyn.Bus", values);
+    EXPECT_EQ((size_t)4, values.size());
+    EXPECT_TRUE(values.find("e") == values.end());
+
+    values.clear();
+    trie.MatchName("org.alljoyn.Bus.Peer", values);
+    EXPECT_EQ((size_t)2, values.size());
+    EXPECT_TRUE(values.find("a") != values.end());
+    EXPECT_TRUE(values.find("c") != values.end());
+
+    EXPECT_TRUE(trie.MatchName("com.example"));
+    EXPECT_FALSE(trie.MatchName(""));
+
+    EXPECT_TRUE(trie.Erase("*", "c"));
+    EXPECT_FALSE(trie.Erase("*", "c"));
+    EXPECT_FALSE(trie.MatchName("net.example"));
+}
+
+TEST(WildcardTrieTest, Erase)
+{
+    WildcardTrie<String> trie;
+    EXPECT_TRUE(trie.Empty());
+    trie.Insert("org.alljoyn.Bus", "a");
+    trie.Insert("org.alljoyn.Bus", "b");
+    trie.Insert("org.alljoyn.Bus.Peer", "a");
+    trie.Insert("", "a");
+
+    EXPECT_FALSE(trie.Erase("org.alljoyn.Bus", "c"));
+    EXPECT_FALSE(trie.Erase("org.alljoyn", "a"));
+    EXPECT_TRUE(trie.Erase("org.alljoyn.Bus", "a"));
+    EXPECT_TRUE(trie.MatchPattern("org.alljoyn.Bus"));
+    EXPECT_TRUE(trie.Erase("org.alljoyn.Bus", "b"));
+    EXPECT_FALSE(trie.MatchPattern("org.alljoyn.Bus"));
+    EXPECT_TRUE(trie.MatchPattern("org.alljoyn.Bus*"));
+    EXPECT_TRUE(trie.Erase("org.alljoyn.Bus.Peer", "a"));
+    EXPECT_FALSE(trie.MatchPattern("*"));
+    EXPECT_TRUE(trie.Empty());
+}
+
+/*
+ * The trie must give exactly the same answers as checking every key with
+ * WildcardMatch, including for patterns WildcardMatch handles oddly.
+ */
+TEST(WildcardTrieTest, SameAsWildcardMatch)
+{
+    const char* names[] = {
+        "a", "ab", "abc", "abd", "a.b", "a.b.c", "b", "ba", "bab", "a*", "a?c", "ca.b"
+    };
+    const char* patterns[] = {
+        "a", "a*", "ab*", "*", "?", "a?", "a?c", "*b", "a*c", "a.*", "**", "*?", "a*b*", "b?b", "?*", "a**", "ab", "c*"
+    };
+
+    WildcardTrie<String> nameTrie;
+    WildcardTrie<String> patternTrie;
+    for (size_t i = 0; i < ArraySize(names); ++i) {
+        nameTrie.Insert(names[i], names[i]);
+    }
+    for (size_t i = 0; i < ArraySize(patterns); ++i) {
+        patternTrie.Insert(patterns[i], patterns[i]);
+    }
+
+    for (size_t i = 0; i < ArraySize(patterns); ++i) {
+        set<String> expected;
+        for (size_t j = 0; j < ArraySize(names); ++j) {
+            if (!WildcardMatch(names[j], patterns[i])) {
+                expected.insert(names[j]);
+            }
+        }
+        set<String> values;
+        nameTrie.MatchPattern(patterns[i], values);
+        EXPECT_TRUE(expected == values) << "pattern " << patterns[i];
+        EXPECT_EQ(!expected.empty(), nameTrie.MatchPattern(patterns[i])) << "pattern " << patterns[i];
+    }
+
+    for (size_t j = 0; j < ArraySize(names); ++j) {
+        set<String> expected;
+        for (size_t i = 0; i < ArraySize(patterns); ++i) {
+            if (!WildcardMatch(names[j], patterns[i])) {
+                expected.insert(patterns[i]);
+            }
+        }
+        set<String> values;
+        patternTrie.MatchName(names[j], values);
+        EXPECT_TRUE(expected == values) << "name " << names[j];
+        EXPECT_EQ(!expected.empty(), patternTrie.MatchName(names[j])) << "name " << names[j];
+    }
+}
@@ -176,9 +176,6 @@ static verify_res_t ECDSA_verify_inner(bigval_t const* msgdgst,
     digit256_t digU1;
     digit256_t digU2;
     ecpoint_t Q;
-    ecpoint_t P1;
-    ecpoint_t P2;
-    ecpoint_t G;
     ecpoint_t X;
     ec_t curve;
 
@@ -192,8 +189,6 @@ static verify_res_t ECDSA_verify_inner(bigval_t const* msgdgst,
         goto Exit;
     }
 
-    ec_get_generator(&G, &curve);
-
     status = bigval_to_digit256(&(pubkey->x), Q.x);
     status = status && bigval_to_digit256(&(pubkey->y), Q.y);
     status = status && ecpoint_validation(&Q, &curve);
@@ -232,14 +227,12 @@ static verify_res_t ECDSA_verify_inner(bigval_t const* msgdgst,
         goto Exit;
     }
 
-    ec_scalarmul(&(curve.generator), digU1, &P1, &curve);
-    ec_scalarmul(&Q, digU2, &P2, &curve);
-
-    // copy P1 to X
-    fpcopy_p256(P1.x, X.x);
-    fpcopy_p256(P1.y, X.y);
-
-    ec_add(&X, &P2, &curve);
+    /* X = u1*G + u2*Q; both scalars are public so the interleaved, variable-time method is safe */
+    ajstatus = ec_doublescalarmul(digU1, &Q, digU2, &X, &curve);
+    if (ajstatus != ER_OK) {
+        res = V_INTERNAL;
+        goto Exit;
+    }
 
     if (ec_is_infinity(&X, &curve)) {
         res = V_INFINITY;
@@ -34,6 +34,11 @@
 
 #include <Status.h>
 
+#if defined(__x86_64__) && defined(__GNUC__)
+#define AES_NI
+#include <wmmintrin.h>
+#endif
+
 using namespace std;
 using namespace qcc;
 
@@ -219,8 +224,116 @@ static void EncryptRounds(uint32_t* out, uint32_t* in, const uint32_t* key)
     out[3] = x3;
 }
 
+#ifdef AES_NI
+
+/*
+ * On little-endian targets the packed key schedule has the same layout as the AES round keys so
+ * the AES-NI instructions can use it directly.
+ */
+static bool HasAESNI()
+{
+    static const bool aesni = (__builtin_cpu_init(), __builtin_cpu_supports("aes"));
+    return aesni;
+}
+
+__attribute__((target("aes")))
+static inline void LoadSchedule(__m128i* rk, const uint32_t* fkey)
+{
+    for (int i = 0; i <= 10; ++i) {
+        rk[i] = _mm_loadu_si128((const __m128i*)(fkey + 4 * i));
+    }
+}
+
+__attribute__((target("aes")))
+static inline __m128i AESNI_EncryptBlock(const __m128i* rk, __m128i b)
+{
+    b = _mm_xor_si128(b, rk[0]);
+    for (int i = 1; i < 10; ++i) {
+        b = _mm_aesenc_si128(b, rk[i]);
+    }
+    return _mm_aesenclast_si128(b, rk[10]);
+}
+
+__attribute__((target("aes")))
+static void AESNI_CTR_128(const uint32_t* fkey, const uint8_t* in, uint8_t* out, uint32_t len, uint8_t* ctr)
+{
+    __m128i rk[11];
+    LoadSchedule(rk, fkey);
+    uint8_t block[4][16];
+    uint32_t counter;
+    memcpy(&counter, ctr + 12, sizeof(counter));
+    counter = betoh32(counter);
+
+    while (len) {
+        /*
+         * Encrypt four counter blocks at a time so the AES rounds for each block are pipelined.
+         */
+        uint32_t numBlocks = min((len + 15) / 16, 4);
+        __m128i ks[4];
+        for (uint32_t i = 0; i < numBlocks; ++i) {
+            uint32_t be = htobe32(counter + i);
+            memcpy(block[i], ctr, 12);
+            memcpy(block[i] + 12, &be, sizeof(be));
+            ks[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i*)block[i]), rk[0]);
+        }
+        for (int r = 1; r < 10; ++r) {
+            for (uint32_t i = 0; i < numBlocks; ++i) {
+                ks[i] = _mm_aesenc_si128(ks[i], rk[r]);
+            }
+        }
+        for (uint32_t i = 0; i < numBlocks; ++i) {
+            ks[i] = _mm_aesenclast_si128(ks[i], rk[10]);
+            uint32_t n = min(len, 16);
+            if (n == 16) {
+                _mm_storeu_si128((__m128i*)out, _mm_xor_si128(ks[i], _mm_loadu_si128((const __m128i*)in)));
+            } else {
+                _mm_storeu_si128((__m128i*)block[i], ks[i]);
+                for (uint32_t j = 0; j < n; ++j) {
+                    out[j] = block[i][j] ^ in[j];
+                }
+            }
+            in += n;
+            out += n;
+            len -= n;
+        }
+        counter += numBlocks;
+    }
+
+    counter = htobe32(counter);
+    memcpy(ctr + 12, &counter, sizeof(counter));
+    ClearMemory(block, sizeof(block));
+}
+
+__attribute__((target("aes")))
+static void AESNI_CBC_MAC_128(const uint32_t* fkey, const uint8_t* in, uint32_t len, uint8_t* mac)
+{
+    __m128i rk[11];
+    LoadSchedule(rk, fkey);
+    __m128i x = _mm_loadu_si128((const __m128i*)mac);
+    for (; len; len -= 16, in += 16) {
+        x = AESNI_EncryptBlock(rk, _mm_xor_si128(x, _mm_loadu_si128((const __m128i*)in)));
+    }
+    _mm_storeu_si128((__m128i*)mac, x);
+}
+
+__attribute__((target("aes")))
+static void AESNI_ECB_128_ENCRYPT(const uint32_t* fkey, const uint8_t* in, uint8_t* out)
+{
+    __m128i rk[11];
+    LoadSchedule(rk, fkey);
+    _mm_storeu_si128((__m128i*)out, AESNI_EncryptBlock(rk, _mm_loadu_si128((const __m128i*)in)));
+}
+
+#endif
+
 static void AJ_AES_CTR_128(const uint32_t* fkey, const uint8_t* in, uint8_t* out, uint32_t len, uint8_t* ctr)
 {
+#ifdef AES_NI
+    if (HasAESNI()) {
+        AESNI_CTR_128(fkey, in, out, len, ctr);
+        return;
+    }
+#endif
     uint32_t counter[4];
 
     Pack32(counter, ctr);
@@ -244,14 +357,22 @@ static void AJ_AES_CTR_128(const uint32_t* fkey, const uint8_t* in, uint8_t* out
     Unpack32(ctr, counter);
 }
 
-static void AJ_AES_CBC_128_ENCRYPT(const uint32_t* fkey, const uint8_t* in, uint8_t* out, uint32_t len, uint8_t* iv)
+/*
+ * Continue a CBC-MAC over one or more whole blocks. Only the final chaining value is kept.
+ */
+static void AJ_AES_CBC_MAC_128(const uint32_t* fkey, const uint8_t* in, uint32_t len, uint8_t* mac)
 {
+    QCC_ASSERT((len % 16) == 0);
+#ifdef AES_NI
+    if (HasAESNI()) {
+        AESNI_CBC_MAC_128(fkey, in, len, mac);
+        return;
+    }
+#endif
     uint32_t xorbuf[4];
     uint32_t ivt[4];
 
-    QCC_ASSERT((len % 16) == 0);
-
-    Pack32(ivt, iv);
+    Pack32(ivt, mac);
     while (len) {
         int i;
         Pack32(xorbuf, in);
@@ -259,16 +380,20 @@ static void AJ_AES_CBC_128_ENCRYPT(const uint32_t* fkey, const uint8_t* in, uint
             xorbuf[i] ^= ivt[i];
         }
         EncryptRounds(ivt, xorbuf, fkey);
-        Unpack32(out, ivt);
-        out += 16;
         in += 16;
         len -= 16;
     }
-    Unpack32(iv, ivt);
+    Unpack32(mac, ivt);
 }
 
 static void AJ_AES_ECB_128_ENCRYPT(const uint32_t* fkey, const uint8_t* in, uint8_t* out)
 {
+#ifdef AES_NI
+    if (HasAESNI()) {
+        AESNI_ECB_128_ENCRYPT(fkey, in, out);
+        return;
+    }
+#endif
     uint32_t in32[4];
     uint32_t out32[4];
 
@@ -363,9 +488,9 @@ static void Compute_CCM_AuthField(const uint32_t* fkey, Crypto_AES::Block& T, ui
     /*
      * Initialize CBC-MAC with B_0 initialization vector is 0.
      */
-    Crypto_AES::Block ivec(0);
+    memset(T.data, 0, sizeof(T.data));
     Trace("CBC IV in: ", B_0.data, sizeof(B_0.data));
-    AJ_AES_CBC_128_ENCRYPT(fkey, B_0.data, T.data, sizeof(T.data), ivec.data);
+    AJ_AES_CBC_MAC_128(fkey, B_0.data, sizeof(B_0.data), T.data);
     Trace("CBC IV out:", T.data, sizeof(T.data));
     /*
      * Compute CBC-MAC for the add data.
@@ -397,18 +522,19 @@ static void Compute_CCM_AuthField(const uint32_t* fkey, Crypto_AES::Block& T, ui
         /*
          * Continue computing the CBC-MAC
          */
-        AJ_AES_CBC_128_ENCRYPT(fkey, A.data, T.data, sizeof(T.data), ivec.data);
+        AJ_AES_CBC_MAC_128(fkey, A.data, sizeof(A.data), T.data);
         Trace("After AES 1: ", T.data, sizeof(T.data));
-        while (addLen >= sizeof(Crypto_AES::Block)) {
-            AJ_AES_CBC_128_ENCRYPT(fkey, addData, T.data, sizeof(T.data), ivec.data);
+        size_t wholeLen = addLen & ~(sizeof(Crypto_AES::Block) - 1);
+        if (wholeLen) {
+            AJ_AES_CBC_MAC_128(fkey, addData, wholeLen, T.data);
             Trace("After AES 2: ", T.data, sizeof(T.data));
-            addData += sizeof(Crypto_AES::Block);
-            addLen -= sizeof(Crypto_AES::Block);
+            addData += wholeLen;
+            addLen -= wholeLen;
         }
         if (addLen) {
             memcpy(A.data, addData, addLen);
             A.Pad(16 - addLen);
-            AJ_AES_CBC_128_ENCRYPT(fkey, A.data, T.data, sizeof(T.data), ivec.data);
+            AJ_AES_CBC_MAC_128(fkey, A.data, sizeof(A.data), T.data);
             Trace("After AES 3: ", T.data, sizeof(T.data));
         }
 
@@ -417,17 +543,18 @@ static void Compute_CCM_AuthField(const uint32_t* fkey, Crypto_AES::Block& T, ui
      * Continue computing CBC-MAC over the message data.
      */
     if (mLen) {
-        while (mLen >= sizeof(Crypto_AES::Block)) {
-            AJ_AES_CBC_128_ENCRYPT(fkey, mData, T.data, sizeof(T.data), ivec.data);
+        size_t wholeLen = mLen & ~(sizeof(Crypto_AES::Block) - 1);
+        if (wholeLen) {
+            AJ_AES_CBC_MAC_128(fkey, mData, wholeLen, T.data);
             Trace("After AES 4: ", T.data, sizeof(T.data));
-            mData += sizeof(Crypto_AES::Block);
-            mLen -= sizeof(Crypto_AES::Block);
+            mData += wholeLen;
+            mLen -= wholeLen;
         }
         if (mLen) {
             Crypto_AES::Block final;
             memcpy(final.data, mData, mLen);
             final.Pad(16 - mLen);
-            AJ_AES_CBC_128_ENCRYPT(fkey, final.data, T.data, sizeof(T.data), ivec.data);
+            AJ_AES_CBC_MAC_128(fkey, final.data, sizeof(final.data), T.data);
             Trace("After AES 5: ", T.data, sizeof(T.data));
         }
     }
@@ -290,6 +290,8 @@ class CertificateX509 {
 
     /**
      * Verify the certificate.
+     * Successful verifications are cached for the validity period of the
+     * certificate, see ClearCache().
      * @param key the ECDSA public key.
      * @return ER_OK for success; otherwise, error code.
      */
@@ -646,6 +648,13 @@ class CertificateX509 {
      */
     QStatus GetSHA256Thumbprint(uint8_t* thumbprint) const;
 
+    /**
+     * Discard the decoded certificates and successful signature verifications
+     * cached by DecodeCertificateDER() and Verify().  Called whenever the set
+     * of trusted issuers changes.
+     */
+    static void AJ_CALL ClearCache();
+
     /**
      * Destructor
      */
@@ -166,6 +166,38 @@ void ec_affine_tojacobian(const ecpoint_t* Q, ecpoint_jacobian_t* P);
  */
 QStatus ec_scalarmul(const ecpoint_t* P, digit256_t k, ecpoint_t* Q, ec_t* curve);
 
+/**
+ * Multiply the generator of the curve by a scalar, in constant time.
+ *
+ * Uses a table of precomputed multiples of the generator, so no doublings are
+ * needed.  The table is built on first use; callers that race with the build
+ * fall back to ec_scalarmul().  Use for key generation and signing.
+ *
+ * @param[in]  k     The scalar.
+ * @param[out] Q     The output point Q = k*G.
+ * @param[in]  curve The curve.
+ *
+ * @return ER_OK if successful
+ */
+QStatus ec_scalarmul_base(digit256_t k, ecpoint_t* Q, ec_t* curve);
+
+/**
+ * Compute Q = k*G + l*P by interleaving the two scalar multiplications so
+ * that they share one chain of doublings.
+ *
+ * This is NOT constant time.  It must only be used with public scalars, as in
+ * signature verification.
+ *
+ * @param[in]  k     The scalar for the generator, in [0,r-1].
+ * @param[in]  P     The second point, which must be validated by the caller.
+ * @param[in]  l     The scalar for P, in [0,r-1].
+ * @param[out] Q     The output point.  It is (0,0) if the sum is the point at infinity.
+ * @param[in]  curve The curve.
+ *
+ * @return ER_OK if successful
+ */
+QStatus ec_doublescalarmul(digit256_tc k, const ecpoint_t* P, digit256_tc l, ecpoint_t* Q, ec_t* curve);
+
 /**
  * Check that a point is on the given curve.
  *
@@ -288,6 +288,19 @@ void AJ_CALL QCC_RegisterOutputCallback(QCC_DbgMsgCallback cb, void* context);
  */
 void AJ_CALL QCC_RegisterOutputFile(FILE* file);
 
+/**
+ * Record debug messages, other than errors, in a binary trace file instead of
+ * formatting and writing them as they are generated.  The calling thread only
+ * copies the format string address and the arguments to a ring buffer; a
+ * background thread writes them to the file.  Use ajtracedump to turn the
+ * file into text.  Setting the ER_DEBUG_TRACEFILE environment variable has the
+ * same effect when AllJoyn is initialized.
+ *
+ * @param fileName  Name of the trace file or NULL to close the trace file and
+ *                  go back to formatting debug messages as they are generated.
+ */
+void AJ_CALL QCC_SetTraceFile(const char* fileName);
+
 /**
  * @cond ALLJOYN_DEV
  * @internal
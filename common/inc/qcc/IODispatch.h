@@ -29,6 +29,8 @@
 #include <qcc/Timer.h>
 #include <Status.h>
 #include <map>
+#include <set>
+#include <vector>
 namespace qcc {
 
 /* Forward References */
@@ -121,6 +123,16 @@ struct CallbackContext {
     CallbackContext(Stream* stream, CallbackType type) : stream(stream), type(type) { }
 };
 
+/**
+ * Registration of a source or sink event in the persistent poll set of an IODispatch
+ */
+struct IOPollRegistration {
+    bool active;        /* Whether the event is currently in the poll set */
+    int fds[2];         /* Descriptors registered for the event, or -1 */
+    Event* timedEvent;  /* TIMED event that is checked on every wakeup instead of polled, or NULL */
+
+    IOPollRegistration() : active(false), timedEvent(NULL) { fds[0] = fds[1] = -1; }
+};
 
 struct IODispatchEntry {
     /* Contexts for different callbacks associated with this stream
@@ -153,6 +165,9 @@ struct IODispatchEntry {
 
     StoppingState stopping_state;          /* Whether this stream is in the process of being stopped*/
 
+    IOPollRegistration sourcePoll;         /* Poll set registration of the source event */
+    IOPollRegistration sinkPoll;           /* Poll set registration of the sink event */
+
     /**
      * Default Unusable entry
      *
@@ -265,6 +280,13 @@ class IODispatch : public Thread, public AlarmListener {
      */
     QStatus JoinStream(Stream* stream);
 
+    /**
+     * Get the number of streams currently managed by this IODispatch.
+     *
+     * @return The number of streams.
+     */
+    size_t GetNumStreams();
+
     /**
      * Enable read callbacks to be triggered for a particular source.
      * @param source           The stream for which callbacks are to be enabled.
@@ -343,6 +365,69 @@ class IODispatch : public Thread, public AlarmListener {
      */
     virtual ThreadReturn STDCALL Run(void* arg);
 
+    /**
+     * Add a read or write alarm for a stream whose source or sink event has fired.
+     * Must be called with lock held, the lock may be released while waiting for the timer.
+     *
+     * @param stream    The stream whose event fired.
+     * @param isSource  true if the source event fired, false if the sink event fired.
+     */
+    void DispatchStreamEvent(Stream* stream, bool isSource);
+
+    /**
+     * Add exit alarms for all streams that are being stopped. Must be called with lock held.
+     */
+    void AddExitAlarms();
+
+    /**
+     * Bring the poll set in line with the read and write state of a stream.
+     * Must be called with lock held whenever that state changes.
+     */
+    void UpdatePollSet(Stream* stream, IODispatchEntry& entry);
+
+    /**
+     * Whether the source and sink events are waited on through a persistent poll set
+     * rather than by reloading the set of events on each wakeup of the main thread.
+     */
+    bool UsesPollSet() const;
+
+#if defined(QCC_OS_LINUX)
+    /**
+     * Main loop of the IODispatch thread when the poll set is in use.
+     */
+    ThreadReturn RunPollSet();
+
+    /**
+     * Add the source or sink event of a stream to the poll set. Must be called with lock held.
+     */
+    void PollAdd(Stream* stream, bool isSource, Event& evt, IOPollRegistration& reg);
+
+    /**
+     * Remove the source or sink event of a stream from the poll set. Must be called with lock held.
+     */
+    void PollRemove(Stream* stream, bool isSource, IOPollRegistration& reg);
+
+    /* Stream waiting on a descriptor of the poll set */
+    struct PollWatcher {
+        Stream* stream;
+        bool isSource;
+        uint32_t events;
+        PollWatcher(Stream* stream, bool isSource, uint32_t events) : stream(stream), isSource(isSource), events(events) { }
+    };
+
+    /* Descriptor of the poll set with the streams waiting on it */
+    struct PollFd {
+        uint32_t events;
+        std::vector<PollWatcher> watchers;
+        PollFd() : events(0) { }
+    };
+
+    /**
+     * Update the events the epoll instance waits for on a descriptor. Must be called with lock held.
+     */
+    void PollApply(int fd, PollFd& pollFd);
+#endif
+
     Timer timer;                                /* The timer used to add and process callbacks */
     Mutex lock;                                 /* Lock for mutual exclusion of dispatchEntries */
     std::map<Stream*, IODispatchEntry> dispatchEntries; /* map holding details of various streams registered with this IODispatch */
@@ -355,6 +440,12 @@ class IODispatch : public Thread, public AlarmListener {
      */
     volatile bool crit;
     static volatile int32_t iodispatchCnt;
+#if defined(QCC_OS_LINUX)
+    int epollFd;                                /* epoll instance holding the poll set, or -1 */
+    std::map<int, PollFd> pollFds;              /* Descriptors in the poll set */
+    std::set<int> readyFds;                     /* Descriptors epoll refused (regular files), always ready */
+    std::map<std::pair<Stream*, bool>, Event*> timedPolls; /* TIMED source (true) or sink (false) events of streams */
+#endif
 };
 
 
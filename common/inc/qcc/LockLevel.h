@@ -73,6 +73,9 @@ typedef enum {
     /* Timer.cc */
     LOCK_LEVEL_TIMERIMPL_REENTRANCYLOCK = 500,
 
+    /* LocalTransport.cc */
+    LOCK_LEVEL_LOCALTRANSPORT_LOCALENDPOINT_DISPATCHER_REENTRANCYLOCK = 600,
+
     /* Bus.cc */
     LOCK_LEVEL_BUS_LISTENERSLOCK = 1000,
 
@@ -152,6 +155,7 @@ typedef enum {
     /* KeyStore.cc */
     LOCK_LEVEL_KEYSTORE_EXCLUSIVELOCK = 21100,
     LOCK_LEVEL_KEYSTORE_GUIDSETEVENTLOCK = 21200,
+    LOCK_LEVEL_KEYSTORE_UPDATELOCK = 21300,
     LOCK_LEVEL_KEYSTORE_LOCK = 21400,
 
     /* ProtectedKeyStoreListener.cc */
@@ -198,6 +202,21 @@ typedef enum {
     /* Timer.cc */
     LOCK_LEVEL_TIMERIMPL_LOCK = 36000,
 
+    /* LocalTransport.cc */
+    LOCK_LEVEL_LOCALTRANSPORT_LOCALENDPOINT_DISPATCHER_QUEUELOCK = 36100,
+    LOCK_LEVEL_LOCALTRANSPORT_LOCALENDPOINT_DISPATCHER_IDLELOCK = 36200,
+    LOCK_LEVEL_LOCALTRANSPORT_LOCALENDPOINT_DISPATCHER_LIMITLOCK = 36300,
+
+    /* PeerState.cc */
+    LOCK_LEVEL_PEERSTATE_CIPHERLOCK = 36900,
+    LOCK_LEVEL_PEERSTATE_AUTHORIZATIONCACHELOCK = 36950,
+
+    /* CertificateCache.cc */
+    LOCK_LEVEL_CERTIFICATECACHE_LOCK = 36975,
+
+    /* IntrospectionCache.cc */
+    LOCK_LEVEL_INTROSPECTIONCACHE_LOCK = 36980,
+
     /* OpenSsl.cc */
     LOCK_LEVEL_OPENSSL_LOCK = 37000,
 
@@ -339,6 +339,21 @@ QStatus RecvWithFds(SocketFd sockfd, void* buf, size_t len, size_t& received, So
  */
 QStatus SendWithFds(SocketFd sockfd, const void* buf, size_t len, size_t& sent, SocketFd* fdList, size_t numFds, uint32_t pid);
 
+/**
+ * Send the data in a list of buffers over a socket in a single operation.
+ *
+ * @param sockfd    Socket descriptor.
+ * @param iov       Array of buffers containing the data to send.
+ * @param numIov    Number of buffers in iov. This must not exceed the platform's scatter-gather limit.
+ * @param[out] sent Number of octets sent.
+ *
+ * @return
+ * - #ER_OK the send succeeded.
+ * - #ER_OS_ERROR the underlying send failed.
+ * - #ER_WOULDBLOCK sockfd is non-blocking and the underlying send would block.
+ */
+QStatus SendV(SocketFd sockfd, const IOVec* iov, size_t numIov, size_t& sent);
+
 /**
  * Set a socket to blocking or not blocking.
  *
@@ -221,6 +221,20 @@ class SocketStream : public Stream {
      */
     QStatus PushBytesAndFds(const void* buf, size_t numBytes, size_t& numSent, SocketFd* fdList, size_t numFds, uint32_t pid = -1);
 
+    /**
+     * Push the bytes of several buffers to the stream with a single send.
+     *
+     * @param iov           Array of buffers containing the bytes to push.
+     * @param numIov        Number of buffers in iov.
+     * @param[out] numSent  Number of bytes actually consumed by sink.
+     *
+     * @return
+     * - #ER_OK if the push succeeds.
+     * - #ER_OS_ERROR if the underlying socket request fails.
+     * - #ER_WRITE_ERROR if the socket is not connected.
+     */
+    QStatus PushBytesV(const IOVec* iov, size_t numIov, size_t& numSent);
+
     /**
      * Get the Event indicating that data is available.
      *
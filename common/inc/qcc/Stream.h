@@ -170,6 +170,19 @@ class Sink {
         return ER_NOT_IMPLEMENTED;
     }
 
+    /**
+     * Push the bytes of several buffers, in order, to a sink. Sinks that support it push all
+     * of the buffers in a single operation. As with PushBytes() fewer bytes than requested may
+     * be consumed.
+     *
+     * @param iov       Array of buffers containing the bytes to push.
+     * @param numIov    Number of buffers in iov.
+     * @param numSent   [OUT] Number of bytes actually consumed by sink.
+     *
+     * @return  ER_OK or an error.
+     */
+    virtual QStatus PushBytesV(const IOVec* iov, size_t numIov, size_t& numSent);
+
     /**
      * Get the Event that indicates when data can be pushed to sink.
      *
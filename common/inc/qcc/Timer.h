@@ -46,6 +46,14 @@ class Timer {
 
   public:
 
+    /**
+     * Container used to hold the pending alarms of a timer.
+     */
+    typedef enum {
+        ALARM_SET,              /**< Ordered set. Suits timers that hold a small number of alarms. */
+        ALARM_TIMING_WHEEL      /**< Hierarchical timing wheel. Adding and removing alarms take constant time. */
+    } AlarmStoreType;
+
     /**
      * Constructor
      *
@@ -54,8 +62,10 @@ class Timer {
      * @param concurrency         Dispatch up to this number of alarms concurently (using multiple threads).
      * @param prevenReentrancy   Prevent re-entrant call of AlarmTriggered.
      * @param maxAlarms          Maximum number of outstanding alarms allowed before blocking calls to AddAlarm or 0 for infinite.
+     * @param storeType          Container used to hold the pending alarms.
      */
-    Timer(qcc::String name, bool expireOnExit = false, uint32_t concurrency = 1, bool preventReentrancy = false, uint32_t maxAlarms = 0);
+    Timer(qcc::String name, bool expireOnExit = false, uint32_t concurrency = 1, bool preventReentrancy = false, uint32_t maxAlarms = 0,
+          AlarmStoreType storeType = ALARM_SET);
 
     /**
      * Destructor.
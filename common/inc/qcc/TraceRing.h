@@ -0,0 +1,157 @@
+/**
+ * @file
+ *
+ * Binary trace log written by a background thread.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#ifndef _QCC_TRACERING_H
+#define _QCC_TRACERING_H
+
+#include <qcc/platform.h>
+
+#include <stdarg.h>
+
+#include <qcc/Debug.h>
+#include <qcc/String.h>
+
+#include <Status.h>
+
+namespace qcc {
+
+/**
+ * TraceRing takes the formatting and writing of debug messages off the
+ * threads that generate them.
+ *
+ * While a trace file is open, debug messages other than errors are not
+ * formatted.  Each message is recorded as the address of its format string
+ * followed by the raw values of its arguments in a ring buffer owned by the
+ * calling thread.  Recording takes no locks; if the ring is full the message is
+ * counted as dropped rather than making the caller wait.  A background thread
+ * periodically copies the records to the trace file, writing the text of each
+ * format string, module and file name the first time it is seen.  Decode()
+ * turns a trace file back into the same lines the debug output would have
+ * contained.
+ *
+ * Format strings must be string literals, which is how the debug macros are
+ * used.  String arguments are copied into the record.
+ */
+class TraceRing {
+  public:
+
+    /**
+     * Size in bytes of the ring buffer of each thread.
+     */
+    static const size_t BUFFER_SIZE = 64 * 1024;
+
+    /**
+     * Interval in milliseconds at which the ring buffers are copied to the trace file.
+     */
+    static const uint32_t DRAIN_INTERVAL = 100;
+
+    /**
+     * Open the trace file named by the ER_DEBUG_TRACEFILE environment variable if
+     * it is set.
+     */
+    static void Init();
+
+    /**
+     * Close the trace file.
+     */
+    static void Shutdown();
+
+    /**
+     * Open a trace file and start recording debug messages to it.  An existing
+     * trace file is closed first.
+     *
+     * @param fileName     Name of the trace file.
+     * @param useEpoch     Record timestamps as milliseconds since the epoch.
+     * @param printThread  Include thread names when the file is decoded.
+     *
+     * @return
+     *      - #ER_OK if the trace file was opened.
+     *      - An error status otherwise.
+     */
+    static QStatus Start(const qcc::String& fileName, bool useEpoch, bool printThread);
+
+    /**
+     * Write the remaining records and close the trace file.  Waits for threads
+     * that are adding a record so that no recorded message is lost.
+     */
+    static void Stop();
+
+    /**
+     * Test if debug messages are being recorded.
+     *
+     * @return true if a trace file is open.
+     */
+    static bool IsRunning();
+
+    /**
+     * Capture the format string and raw argument values of a message.  Captured
+     * segments can be appended one after another in the same buffer.
+     *
+     * @param buf   Buffer to capture the segment in.
+     * @param size  Space available in the buffer.
+     * @param fmt   A printf() style format string literal.
+     * @param ap    Arguments for the format string.
+     *
+     * @return The number of bytes used, 0 if the buffer is too small.
+     */
+    static size_t Capture(uint8_t* buf, size_t size, const char* fmt, va_list ap);
+
+    /**
+     * Format captured segments as text.
+     *
+     * @param[out] out  Receives the formatted message.
+     * @param buf       Segments captured by Capture().
+     * @param len       Length of the captured segments.
+     */
+    static void Format(qcc::String& out, const uint8_t* buf, size_t len);
+
+    /**
+     * Add a captured message to the calling thread's ring buffer.
+     *
+     * @param type      The debug type.
+     * @param module    The module name.
+     * @param filename  Filename where the debug message is.
+     * @param lineno    Line number where the debug message is.
+     * @param buf       Segments captured by Capture().
+     * @param len       Length of the captured segments.
+     *
+     * @return false if the message was not recorded because no trace file is open.
+     */
+    static bool Record(DbgMsgType type, const char* module, const char* filename, int lineno, const uint8_t* buf, size_t len);
+
+    /**
+     * Decode a trace file.
+     *
+     * @param fileName  Name of the trace file.
+     * @param cb        Called with each decoded message in the same form as debug output.
+     * @param context   Passed to the callback.
+     *
+     * @return
+     *      - #ER_OK if the whole file was decoded.
+     *      - #ER_INVALID_DATA if the file is not a trace file or is corrupt.
+     *      - An error status otherwise.
+     */
+    static QStatus Decode(const qcc::String& fileName, QCC_DbgMsgCallback cb, void* context);
+};
+
+}
+
+#endif
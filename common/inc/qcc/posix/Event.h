@@ -211,6 +211,7 @@ class Event {
     static void Init();
     static void Shutdown();
     friend class StaticGlobals;
+    friend class IODispatch;
 
     int fd;                 /**< File descriptor linked to general purpose event or -1 */
     int signalFd;           /**< File descriptor used by GEN_PURPOSE events to manually set/reset event */
@@ -106,6 +106,15 @@ class FileSource : public Source {
      */
     QStatus GetSize(int64_t& fileSize);
 
+    /**
+     * Set the position in the file of the next byte to pull. A FileSource
+     * returned by a FileLock shares its position with the FileSink of the lock
+     * so this also sets where the next bytes pushed to the sink are written.
+     *
+     * @param offset The offset in bytes from the start of the file
+     */
+    QStatus Seek(int64_t offset);
+
     /**
      * Pull bytes from the source.
      * The source is exhausted when ER_EOF is returned.
@@ -123,6 +123,19 @@ QStatus FileSource::GetSize(int64_t& fileSize)
     return ER_OK;
 }
 
+QStatus FileSource::Seek(int64_t offset)
+{
+    if (0 > fd) {
+        return ER_INIT_FAILED;
+    }
+
+    if (0 > lseek(fd, offset, SEEK_SET)) {
+        QCC_LogError(ER_OS_ERROR, ("Lseek fd %d failed with '%s'", fd, strerror(errno)));
+        return ER_OS_ERROR;
+    }
+    return ER_OK;
+}
+
 QStatus FileSource::PullBytes(void* buf, size_t reqBytes, size_t& actualBytes, uint32_t timeout)
 {
     QCC_UNUSED(timeout);
@@ -809,6 +809,34 @@ QStatus RecvWithFds(SocketFd sockfd, void* buf, size_t len, size_t& received, So
     return status;
 }
 
+QStatus SendV(SocketFd sockfd, const IOVec* iov, size_t numIov, size_t& sent)
+{
+    QStatus status = ER_OK;
+    struct msghdr msg;
+    ssize_t ret;
+
+    QCC_DbgTrace(("SendV(sockfd = %d, *iov = <>, numIov = %lu, sent = <>)", sockfd, numIov));
+    IncrementPerfCounter(PERF_COUNTER_SOCKET_SEND);
+    QCC_ASSERT(iov != NULL);
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = reinterpret_cast<struct iovec*>(const_cast<IOVec*>(iov));
+    msg.msg_iovlen = numIov;
+
+    ret = sendmsg(static_cast<int>(sockfd), &msg, MSG_NOSIGNAL);
+    if (ret == -1) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            status = ER_WOULDBLOCK;
+        } else {
+            status = ER_OS_ERROR;
+            QCC_DbgHLPrintf(("SendV (sockfd = %u): %d - %s", sockfd, errno, strerror(errno)));
+        }
+    } else {
+        sent = static_cast<size_t>(ret);
+    }
+    return status;
+}
+
 QStatus SendWithFds(SocketFd sockfd, const void* buf, size_t len, size_t& sent, SocketFd* fdList, size_t numFds, uint32_t pid)
 {
     QCC_UNUSED(pid);
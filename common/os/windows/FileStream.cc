@@ -164,6 +164,22 @@ QStatus FileSource::GetSize(int64_t& fileSize)
     return status;
 }
 
+QStatus FileSource::Seek(int64_t offset)
+{
+    if (INVALID_HANDLE_VALUE == handle) {
+        return ER_INIT_FAILED;
+    }
+
+    LARGE_INTEGER offsetLargeInt;
+    offsetLargeInt.QuadPart = offset;
+    if (!::SetFilePointerEx(handle, offsetLargeInt, nullptr, FILE_BEGIN)) {
+        QStatus status = ER_OS_ERROR;
+        QCC_LogError(status, ("SetFilePointerEx failed. error=%d", ::GetLastError()));
+        return status;
+    }
+    return ER_OK;
+}
+
 QStatus FileSource::PullBytes(void* buf, size_t reqBytes, size_t& actualBytes, uint32_t timeout)
 {
     QCC_UNUSED(timeout);
@@ -0,0 +1,394 @@
+/**
+ * @file
+ *
+ * Containers used by TimerImpl to hold pending alarms.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <qcc/Debug.h>
+
+#include "AlarmStore.h"
+
+#define QCC_MODULE  "TIMER"
+
+using namespace std;
+using namespace qcc;
+
+AlarmStore* AlarmStore::Create(Timer::AlarmStoreType type)
+{
+    if (type == Timer::ALARM_TIMING_WHEEL) {
+        return new AlarmWheel();
+    }
+    return new AlarmSet();
+}
+
+bool AlarmSet::Remove(const Alarm& alarm, Alarm& removed)
+{
+    set<Alarm>::iterator it = alarms.find(alarm);
+    if (it != alarms.end()) {
+        removed = *it;
+        alarms.erase(it);
+        return true;
+    }
+    return false;
+}
+
+bool AlarmSet::RemoveId(const Alarm& alarm, Alarm& removed)
+{
+    for (set<Alarm>::iterator it = alarms.begin(); it != alarms.end(); ++it) {
+        if (GetId(*it) == GetId(alarm)) {
+            removed = *it;
+            alarms.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AlarmSet::RemoveListener(const AlarmListener& listener, Alarm& removed)
+{
+    for (set<Alarm>::iterator it = alarms.begin(); it != alarms.end(); ++it) {
+        if (GetListener(*it) == &listener) {
+            removed = *it;
+            alarms.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+AlarmWheel::AlarmWheel() : front(NULL)
+{
+    Timespec<MonotonicTime> now;
+    GetTimeNow(&now);
+    base = now.GetMillis();
+    for (uint32_t i = 0; i < LEVEL0_SLOTS; ++i) {
+        level0[i].level = 0;
+    }
+    for (uint32_t level = 1; level < NUM_LEVELS; ++level) {
+        for (uint32_t i = 0; i < LEVEL_SLOTS; ++i) {
+            upper[level - 1][i].level = level;
+        }
+    }
+    for (uint32_t level = 0; level < NUM_LEVELS; ++level) {
+        levelCount[level] = 0;
+    }
+}
+
+AlarmWheel::~AlarmWheel()
+{
+    for (unordered_map<int32_t, Entry*>::iterator it = ids.begin(); it != ids.end(); ++it) {
+        delete it->second;
+    }
+}
+
+AlarmWheel::Slot& AlarmWheel::GetSlot(uint32_t level, uint64_t when)
+{
+    if (level == 0) {
+        return level0[when & (LEVEL0_SLOTS - 1)];
+    }
+    return upper[level - 1][(when >> Shift(level)) & (LEVEL_SLOTS - 1)];
+}
+
+void AlarmWheel::Heap::Push(Entry* entry)
+{
+    entry->heap = this;
+    items.push_back(entry);
+    Set(items.size() - 1, entry);
+    SiftUp(items.size() - 1);
+}
+
+void AlarmWheel::Heap::Erase(Entry* entry)
+{
+    size_t index = entry->heapIndex;
+    Entry* last = items.back();
+    items.pop_back();
+    entry->heap = NULL;
+    if (last != entry) {
+        Set(index, last);
+        SiftUp(index);
+        SiftDown(last->heapIndex);
+    }
+}
+
+void AlarmWheel::Heap::SiftUp(size_t index)
+{
+    Entry* entry = items[index];
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!Before(entry, items[parent])) {
+            break;
+        }
+        Set(index, items[parent]);
+        index = parent;
+    }
+    Set(index, entry);
+}
+
+void AlarmWheel::Heap::SiftDown(size_t index)
+{
+    Entry* entry = items[index];
+    size_t count = items.size();
+    while (true) {
+        size_t child = 2 * index + 1;
+        if (child >= count) {
+            break;
+        }
+        if (((child + 1) < count) && Before(items[child + 1], items[child])) {
+            ++child;
+        }
+        if (!Before(items[child], entry)) {
+            break;
+        }
+        Set(index, items[child]);
+        index = child;
+    }
+    Set(index, entry);
+}
+
+void AlarmWheel::LinkSorted(Slot& slot, Entry* entry)
+{
+    /*
+     * Alarms in a level 0 slot all have the same alarm time and ids are mostly
+     * added in increasing order so search back from the tail.
+     */
+    Entry* after = slot.tail;
+    while (after && (GetId(after->alarm) > GetId(entry->alarm))) {
+        after = after->prev;
+    }
+    entry->slot = &slot;
+    entry->prev = after;
+    entry->next = after ? after->next : slot.head;
+    if (entry->next) {
+        entry->next->prev = entry;
+    } else {
+        slot.tail = entry;
+    }
+    if (after) {
+        after->next = entry;
+    } else {
+        slot.head = entry;
+    }
+    ++levelCount[slot.level];
+}
+
+void AlarmWheel::LinkTail(Slot& slot, Entry* entry)
+{
+    entry->slot = &slot;
+    entry->prev = slot.tail;
+    entry->next = NULL;
+    if (slot.tail) {
+        slot.tail->next = entry;
+    } else {
+        slot.head = entry;
+    }
+    slot.tail = entry;
+    ++levelCount[slot.level];
+}
+
+void AlarmWheel::Unlink(Entry* entry)
+{
+    if (entry->heap) {
+        entry->heap->Erase(entry);
+        return;
+    }
+    Slot& slot = *entry->slot;
+    if (entry->prev) {
+        entry->prev->next = entry->next;
+    } else {
+        slot.head = entry->next;
+    }
+    if (entry->next) {
+        entry->next->prev = entry->prev;
+    } else {
+        slot.tail = entry->prev;
+    }
+    --levelCount[slot.level];
+    entry->slot = NULL;
+}
+
+void AlarmWheel::Place(Entry* entry)
+{
+    if (entry->when < base) {
+        due.Push(entry);
+        return;
+    }
+    uint64_t delta = entry->when - base;
+    if (delta < LEVEL0_SLOTS) {
+        /* All alarms in a level 0 slot have the same alarm time so only the ids need ordering */
+        LinkSorted(GetSlot(0, entry->when), entry);
+        return;
+    }
+    for (uint32_t level = 1; level < NUM_LEVELS; ++level) {
+        if (delta < (static_cast<uint64_t>(1) << Shift(level + 1))) {
+            LinkTail(GetSlot(level, entry->when), entry);
+            return;
+        }
+    }
+    overflow.Push(entry);
+}
+
+void AlarmWheel::Advance(uint64_t newBase)
+{
+    base = newBase;
+    /*
+     * Cascade the slots the wheel has just turned onto down to the levels below, starting at the
+     * top so alarms can fall through more than one level.
+     */
+    for (uint32_t level = NUM_LEVELS - 1; level > 0; --level) {
+        uint64_t granularity = static_cast<uint64_t>(1) << Shift(level);
+        if ((base & (granularity - 1)) == 0) {
+            Slot& slot = GetSlot(level, base);
+            Entry* entry = slot.head;
+            slot.head = slot.tail = NULL;
+            while (entry) {
+                Entry* next = entry->next;
+                --levelCount[level];
+                Place(entry);
+                entry = next;
+            }
+        }
+    }
+    while (overflow.Top() && (overflow.Top()->when < (base + WHEEL_SPAN))) {
+        Entry* entry = overflow.Top();
+        overflow.Erase(entry);
+        Place(entry);
+    }
+}
+
+Alarm AlarmWheel::Front()
+{
+    QCC_ASSERT(!Empty());
+    if (!front) {
+        front = due.Top();
+    }
+    while (!front) {
+        if (levelCount[0]) {
+            for (uint64_t i = base & (LEVEL0_SLOTS - 1); i < LEVEL0_SLOTS; ++i) {
+                if (level0[i].head) {
+                    front = level0[i].head;
+                    break;
+                }
+            }
+            if (front) {
+                break;
+            }
+        }
+        /*
+         * Nothing is left in the current turn of level 0. Every alarm that remains is at or after
+         * the start of the next slot on the lowest occupied level so the wheel can jump straight there.
+         */
+        uint32_t level = 0;
+        while ((level < NUM_LEVELS) && (levelCount[level] == 0)) {
+            ++level;
+        }
+        if (level == NUM_LEVELS) {
+            front = overflow.Top();
+            break;
+        }
+        uint64_t granularity = static_cast<uint64_t>(1) << Shift((level == 0) ? 1 : level);
+        Advance((base | (granularity - 1)) + 1);
+    }
+    return front->alarm;
+}
+
+void AlarmWheel::Insert(const Alarm& alarm)
+{
+    pair<unordered_map<int32_t, Entry*>::iterator, bool> ins = ids.insert(pair<int32_t, Entry*>(GetId(alarm), NULL));
+    if (!ins.second) {
+        return;
+    }
+    Entry* entry = new Entry();
+    entry->alarm = alarm;
+    entry->when = alarm->GetAlarmTime();
+    ins.first->second = entry;
+
+    Entry*& first = listeners[GetListener(alarm)];
+    entry->listenerPrev = NULL;
+    entry->listenerNext = first;
+    if (first) {
+        first->listenerPrev = entry;
+    }
+    first = entry;
+
+    Place(entry);
+    if (front && Before(entry, front)) {
+        front = entry;
+    }
+}
+
+void AlarmWheel::Erase(Entry* entry)
+{
+    Unlink(entry);
+    if (front == entry) {
+        front = NULL;
+    }
+    if (entry->listenerNext) {
+        entry->listenerNext->listenerPrev = entry->listenerPrev;
+    }
+    if (entry->listenerPrev) {
+        entry->listenerPrev->listenerNext = entry->listenerNext;
+    } else if (entry->listenerNext) {
+        listeners[GetListener(entry->alarm)] = entry->listenerNext;
+    } else {
+        listeners.erase(GetListener(entry->alarm));
+    }
+    ids.erase(GetId(entry->alarm));
+    delete entry;
+}
+
+bool AlarmWheel::Remove(const Alarm& alarm, Alarm& removed)
+{
+    unordered_map<int32_t, Entry*>::iterator it = ids.find(GetId(alarm));
+    if ((it == ids.end()) || !(it->second->alarm == alarm)) {
+        return false;
+    }
+    removed = it->second->alarm;
+    Erase(it->second);
+    return true;
+}
+
+bool AlarmWheel::RemoveId(const Alarm& alarm, Alarm& removed)
+{
+    unordered_map<int32_t, Entry*>::iterator it = ids.find(GetId(alarm));
+    if (it == ids.end()) {
+        return false;
+    }
+    removed = it->second->alarm;
+    Erase(it->second);
+    return true;
+}
+
+bool AlarmWheel::RemoveListener(const AlarmListener& listener, Alarm& removed)
+{
+    unordered_map<const AlarmListener*, Entry*>::iterator it = listeners.find(&listener);
+    if (it == listeners.end()) {
+        return false;
+    }
+    removed = it->second->alarm;
+    Erase(it->second);
+    return true;
+}
+
+bool AlarmWheel::Contains(const Alarm& alarm) const
+{
+    unordered_map<int32_t, Entry*>::const_iterator it = ids.find(GetId(alarm));
+    return (it != ids.end()) && (it->second->alarm == alarm);
+}
@@ -0,0 +1,255 @@
+/**
+ * @file
+ *
+ * Containers used by TimerImpl to hold pending alarms.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#ifndef _QCC_ALARMSTORE_H
+#define _QCC_ALARMSTORE_H
+
+#include <qcc/platform.h>
+#include <qcc/Alarm.h>
+#include <qcc/Timer.h>
+
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace qcc {
+
+/**
+ * Interface to the container of pending alarms for a timer. Alarms are ordered by
+ * alarm time and then by alarm id. The caller is responsible for serializing access.
+ */
+class AlarmStore {
+  public:
+
+    /**
+     * Create an alarm store of the requested type.
+     *
+     * @param type  The type of alarm store.
+     *
+     * @return  A new alarm store that must be freed by the caller.
+     */
+    static AlarmStore* Create(Timer::AlarmStoreType type);
+
+    /**
+     * Destructor.
+     */
+    virtual ~AlarmStore() { }
+
+    /**
+     * @return  true iff the store holds no alarms.
+     */
+    virtual bool Empty() const = 0;
+
+    /**
+     * Get the earliest alarm. Must not be called on an empty store.
+     *
+     * @return  The earliest alarm.
+     */
+    virtual Alarm Front() = 0;
+
+    /**
+     * Add an alarm. Adding an alarm that is already in the store has no effect.
+     *
+     * @param alarm  Alarm to add.
+     */
+    virtual void Insert(const Alarm& alarm) = 0;
+
+    /**
+     * Remove an alarm with the same alarm time and id as the given alarm.
+     *
+     * @param alarm    Alarm to remove.
+     * @param removed  Returns the alarm that was removed.
+     *
+     * @return  true iff an alarm was removed.
+     */
+    virtual bool Remove(const Alarm& alarm, Alarm& removed) = 0;
+
+    /**
+     * Remove an alarm with the same id as the given alarm regardless of its alarm time.
+     *
+     * @param alarm    Alarm to remove.
+     * @param removed  Returns the alarm that was removed.
+     *
+     * @return  true iff an alarm was removed.
+     */
+    virtual bool RemoveId(const Alarm& alarm, Alarm& removed) = 0;
+
+    /**
+     * Remove one alarm for a specific listener.
+     *
+     * @param listener  The listener.
+     * @param removed   Returns the alarm that was removed.
+     *
+     * @return  true iff an alarm was removed.
+     */
+    virtual bool RemoveListener(const AlarmListener& listener, Alarm& removed) = 0;
+
+    /**
+     * Test if an alarm with the same alarm time and id as the given alarm is in the store.
+     *
+     * @param alarm  Alarm to look for.
+     *
+     * @return  true iff the alarm is in the store.
+     */
+    virtual bool Contains(const Alarm& alarm) const = 0;
+
+  protected:
+
+    static int32_t GetId(const Alarm& alarm) { return alarm->id; }
+
+    static const AlarmListener* GetListener(const Alarm& alarm) { return alarm->listener; }
+};
+
+/**
+ * Alarm store backed by an ordered set. Lookups by id or listener are linear scans.
+ */
+class AlarmSet : public AlarmStore {
+  public:
+
+    bool Empty() const { return alarms.empty(); }
+
+    Alarm Front() { return *alarms.begin(); }
+
+    void Insert(const Alarm& alarm) { alarms.insert(alarm); }
+
+    bool Remove(const Alarm& alarm, Alarm& removed);
+
+    bool RemoveId(const Alarm& alarm, Alarm& removed);
+
+    bool RemoveListener(const AlarmListener& listener, Alarm& removed);
+
+    bool Contains(const Alarm& alarm) const { return alarms.count(alarm) != 0; }
+
+  private:
+    std::set<Alarm, std::less<Alarm> > alarms;
+};
+
+/**
+ * Alarm store backed by a hierarchical timing wheel.
+ *
+ * Level 0 has one slot per millisecond for the next 256ms. Each of the four levels above has
+ * 64 slots that are each as wide as the whole level below. An alarm is placed in the lowest level
+ * whose span reaches its alarm time and is moved down a level when the wheel turns past the start
+ * of its slot. Alarms more than 2^32ms out are kept in an overflow heap and alarms before the time
+ * the wheel has turned to are kept in a due heap. Alarms are indexed by id and by listener.
+ *
+ * Adding and removing an alarm on the wheel is a constant time operation. Alarms in the due and
+ * overflow heaps take logarithmic time. An alarm lands in the due heap when the wheel has turned
+ * past the current time to reach a later alarm, which is common for zero timeout alarms.
+ */
+class AlarmWheel : public AlarmStore {
+  public:
+
+    AlarmWheel();
+
+    ~AlarmWheel();
+
+    bool Empty() const { return ids.empty(); }
+
+    Alarm Front();
+
+    void Insert(const Alarm& alarm);
+
+    bool Remove(const Alarm& alarm, Alarm& removed);
+
+    bool RemoveId(const Alarm& alarm, Alarm& removed);
+
+    bool RemoveListener(const AlarmListener& listener, Alarm& removed);
+
+    bool Contains(const Alarm& alarm) const;
+
+  private:
+
+    static const uint32_t LEVEL0_BITS = 8;
+    static const uint32_t LEVEL_BITS = 6;
+    static const uint32_t NUM_LEVELS = 5;
+    static const uint32_t LEVEL0_SLOTS = 1 << LEVEL0_BITS;
+    static const uint32_t LEVEL_SLOTS = 1 << LEVEL_BITS;
+    static const uint64_t WHEEL_SPAN = static_cast<uint64_t>(1) << (LEVEL0_BITS + (NUM_LEVELS - 1) * LEVEL_BITS);
+
+    struct Slot;
+    struct Heap;
+
+    struct Entry {
+        Alarm alarm;
+        uint64_t when;          /**< Alarm time in milliseconds */
+        Slot* slot;             /**< Slot that holds this entry or NULL if it is in a heap */
+        Heap* heap;             /**< Heap that holds this entry or NULL if it is in a slot */
+        size_t heapIndex;       /**< Position of this entry in its heap */
+        Entry* prev;
+        Entry* next;
+        Entry* listenerPrev;    /**< Previous alarm for the same listener */
+        Entry* listenerNext;    /**< Next alarm for the same listener */
+    };
+
+    struct Slot {
+        Slot() : head(NULL), tail(NULL), level(NUM_LEVELS) { }
+        Entry* head;
+        Entry* tail;
+        uint32_t level;         /**< Wheel level of this slot */
+    };
+
+    /**
+     * Binary heap of entries ordered by alarm time and then by alarm id.
+     */
+    struct Heap {
+        Entry* Top() const { return items.empty() ? NULL : items[0]; }
+        void Push(Entry* entry);
+        void Erase(Entry* entry);
+
+      private:
+        void Set(size_t index, Entry* entry) { items[index] = entry; entry->heapIndex = index; }
+        void SiftUp(size_t index);
+        void SiftDown(size_t index);
+
+        std::vector<Entry*> items;
+    };
+
+    static bool Before(const Entry* a, const Entry* b) { return (a->when < b->when) || ((a->when == b->when) && (GetId(a->alarm) < GetId(b->alarm))); }
+
+    /* Private copy constructor and assignment operator - do nothing */
+    AlarmWheel(const AlarmWheel&);
+    AlarmWheel& operator=(const AlarmWheel&);
+
+    static uint32_t Shift(uint32_t level) { return (level == 0) ? 0 : LEVEL0_BITS + (level - 1) * LEVEL_BITS; }
+
+    Slot& GetSlot(uint32_t level, uint64_t when);
+    void Place(Entry* entry);
+    void LinkSorted(Slot& slot, Entry* entry);
+    void LinkTail(Slot& slot, Entry* entry);
+    void Unlink(Entry* entry);
+    void Erase(Entry* entry);
+    void Advance(uint64_t newBase);
+
+    uint64_t base;                              /**< Wheel time in milliseconds. Alarms before this time are due. */
+    Slot level0[LEVEL0_SLOTS];                  /**< One millisecond slots */
+    Slot upper[NUM_LEVELS - 1][LEVEL_SLOTS];    /**< Slots of levels 1 and above */
+    size_t levelCount[NUM_LEVELS];              /**< Number of alarms held on each level */
+    Heap due;                                   /**< Alarms before base */
+    Heap overflow;                              /**< Alarms beyond the span of the wheel */
+    Entry* front;                               /**< Cached earliest alarm or NULL if unknown */
+    std::unordered_map<int32_t, Entry*> ids;
+    std::unordered_map<const AlarmListener*, Entry*> listeners;
+};
+
+}
+
+#endif
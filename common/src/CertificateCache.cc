@@ -0,0 +1,177 @@
+/**
+ * @file
+ *
+ * Implementation of the cache of decoded certificates and certificate signature
+ * verification results.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+#include <qcc/LockLevel.h>
+#include <qcc/time.h>
+
+#include "CertificateCache.h"
+
+#define QCC_MODULE "CRYPTO"
+
+using namespace std;
+
+namespace qcc {
+
+static CertificateCache* certificateCache = NULL;
+
+template <typename V>
+V* CertificateCache::LruTable<V>::Find(const string& key)
+{
+    typename unordered_map<string, typename List::iterator>::iterator it = index.find(key);
+    if (it == index.end()) {
+        return NULL;
+    }
+    entries.splice(entries.begin(), entries, it->second);
+    return &it->second->second;
+}
+
+template <typename V>
+void CertificateCache::LruTable<V>::Insert(const string& key, const V& value)
+{
+    V* existing = Find(key);
+    if (existing) {
+        *existing = value;
+        return;
+    }
+    if (index.size() >= MAX_ENTRIES) {
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+    entries.push_front(make_pair(key, value));
+    index[key] = entries.begin();
+}
+
+template <typename V>
+void CertificateCache::LruTable<V>::Erase(const string& key)
+{
+    typename unordered_map<string, typename List::iterator>::iterator it = index.find(key);
+    if (it != index.end()) {
+        entries.erase(it->second);
+        index.erase(it);
+    }
+}
+
+template <typename V>
+void CertificateCache::LruTable<V>::Clear()
+{
+    index.clear();
+    entries.clear();
+}
+
+CertificateCache::CertificateCache() : lock(LOCK_LEVEL_CERTIFICATECACHE_LOCK), epoch(0)
+{
+}
+
+void CertificateCache::Init()
+{
+    if (!certificateCache) {
+        certificateCache = new CertificateCache();
+    }
+}
+
+void CertificateCache::Shutdown()
+{
+    delete certificateCache;
+    certificateCache = NULL;
+}
+
+bool CertificateCache::GetDecoded(const string& key, CertificateX509& cert)
+{
+    if (!certificateCache) {
+        return false;
+    }
+    bool found = false;
+    certificateCache->lock.Lock(MUTEX_CONTEXT);
+    CertificateX509* cached = certificateCache->decoded.Find(key);
+    if (cached) {
+        cert = *cached;
+        found = true;
+    }
+    certificateCache->lock.Unlock(MUTEX_CONTEXT);
+    return found;
+}
+
+void CertificateCache::AddDecoded(const string& key, const CertificateX509& cert)
+{
+    if (!certificateCache) {
+        return;
+    }
+    certificateCache->lock.Lock(MUTEX_CONTEXT);
+    certificateCache->decoded.Insert(key, cert);
+    certificateCache->lock.Unlock(MUTEX_CONTEXT);
+}
+
+bool CertificateCache::IsVerified(const string& key, const ECCPublicKey& issuer, uint32_t& epoch)
+{
+    if (!certificateCache) {
+        return false;
+    }
+    uint64_t currentTime = GetEpochTimestamp() / 1000;
+    bool found = false;
+    certificateCache->lock.Lock(MUTEX_CONTEXT);
+    epoch = certificateCache->epoch;
+    Verified* cached = certificateCache->verified.Find(key);
+    if (cached) {
+        if (currentTime > cached->validity.validTo) {
+            /* Expired certificates must be checked again by the caller. */
+            certificateCache->verified.Erase(key);
+        } else {
+            found = (currentTime >= cached->validity.validFrom) && (cached->issuer == issuer);
+        }
+    }
+    certificateCache->lock.Unlock(MUTEX_CONTEXT);
+    return found;
+}
+
+void CertificateCache::AddVerified(const string& key, const ECCPublicKey& issuer, const CertificateX509::ValidPeriod& validity, uint32_t epoch)
+{
+    if (!certificateCache) {
+        return;
+    }
+    uint64_t currentTime = GetEpochTimestamp() / 1000;
+    if ((validity.validFrom > currentTime) || (validity.validTo < currentTime)) {
+        return;
+    }
+    Verified entry;
+    entry.issuer = issuer;
+    entry.validity = validity;
+    certificateCache->lock.Lock(MUTEX_CONTEXT);
+    if (epoch == certificateCache->epoch) {
+        certificateCache->verified.Insert(key, entry);
+    }
+    certificateCache->lock.Unlock(MUTEX_CONTEXT);
+}
+
+void CertificateCache::Clear()
+{
+    if (!certificateCache) {
+        return;
+    }
+    certificateCache->lock.Lock(MUTEX_CONTEXT);
+    ++certificateCache->epoch;
+    certificateCache->decoded.Clear();
+    certificateCache->verified.Clear();
+    certificateCache->lock.Unlock(MUTEX_CONTEXT);
+}
+
+}
@@ -0,0 +1,136 @@
+/**
+ * @file
+ *
+ * Cache of decoded certificates and certificate signature verification results.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#ifndef _QCC_CERTIFICATECACHE_H
+#define _QCC_CERTIFICATECACHE_H
+
+#include <qcc/platform.h>
+#include <qcc/CertificateECC.h>
+#include <qcc/CryptoECC.h>
+#include <qcc/Mutex.h>
+
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace qcc {
+
+/**
+ * Process-wide cache of certificate decode and signature verification results.
+ *
+ * Peers present the same identity and membership certificates every time they
+ * reconnect.  Decoded certificates are remembered by the digest of their DER
+ * encoding, and successful signature checks by the digest of the signed data
+ * and signature together with the issuer public key they were checked against.
+ * Failures are never cached.  A verification result is only returned while the
+ * certificate is within its validity period.  Both tables are bounded and
+ * evict the least recently used entry.
+ */
+class CertificateCache {
+  public:
+
+    /**
+     * Maximum number of entries in each of the decode and verification tables.
+     */
+    static const size_t MAX_ENTRIES = 256;
+
+    static void Init();
+    static void Shutdown();
+
+    /**
+     * Look up a previously decoded certificate.
+     *
+     * @param[in] key     Digest of the DER encoding and the initial certificate type.
+     * @param[out] cert   Receives the decoded certificate on a hit.
+     *
+     * @return true if the certificate was found.
+     */
+    static bool GetDecoded(const std::string& key, CertificateX509& cert);
+
+    /**
+     * Remember a successfully decoded certificate.
+     *
+     * @param[in] key     Digest of the DER encoding and the initial certificate type.
+     * @param[in] cert    The decoded certificate.
+     */
+    static void AddDecoded(const std::string& key, const CertificateX509& cert);
+
+    /**
+     * Check whether a certificate signature was previously verified.
+     *
+     * @param[in] key     Digest of the signed data and the signature.
+     * @param[in] issuer  The public key the signature is being verified against.
+     * @param[out] epoch  Returns the cache epoch to pass to AddVerified on a miss.
+     *
+     * @return true if the signature was verified with the same issuer key and the
+     *         certificate is still within its validity period.
+     */
+    static bool IsVerified(const std::string& key, const ECCPublicKey& issuer, uint32_t& epoch);
+
+    /**
+     * Remember a successful signature verification.  The result is dropped if the
+     * cache was cleared since the epoch was returned by IsVerified.
+     *
+     * @param[in] key       Digest of the signed data and the signature.
+     * @param[in] issuer    The public key the signature was verified against.
+     * @param[in] validity  Validity period of the certificate.
+     * @param[in] epoch     Cache epoch returned by IsVerified.
+     */
+    static void AddVerified(const std::string& key, const ECCPublicKey& issuer, const CertificateX509::ValidPeriod& validity, uint32_t epoch);
+
+    /**
+     * Discard all cached decode and verification results.
+     */
+    static void Clear();
+
+  private:
+
+    struct Verified {
+        ECCPublicKey issuer;
+        CertificateX509::ValidPeriod validity;
+    };
+
+    /* A table of values ordered from most to least recently used. */
+    template <typename V>
+    class LruTable {
+      public:
+        V* Find(const std::string& key);
+        void Insert(const std::string& key, const V& value);
+        void Erase(const std::string& key);
+        void Clear();
+
+      private:
+        typedef std::list<std::pair<std::string, V> > List;
+        List entries;
+        std::unordered_map<std::string, typename List::iterator> index;
+    };
+
+    CertificateCache();
+
+    Mutex lock;
+    uint32_t epoch;
+    LruTable<CertificateX509> decoded;
+    LruTable<Verified> verified;
+};
+
+}
+
+#endif
@@ -29,6 +29,8 @@
 
 #include <Status.h>
 
+#include "CertificateCache.h"
+
 using namespace std;
 using namespace qcc;
 
@@ -983,6 +985,28 @@ QStatus CertificateX509::EncodeCertificateSig(qcc::String& sig) const
     return status;
 }
 
+/*
+ * Key for the CertificateCache: the SHA-256 digest of the data, followed by
+ * the signature or initial certificate type the result also depends on.
+ */
+static QStatus GetCacheKey(const qcc::String& data, const void* extra, size_t extraLen, std::string& key)
+{
+    uint8_t digest[Crypto_SHA256::DIGEST_SIZE];
+    Crypto_SHA256 hash;
+    QStatus status = hash.Init();
+    if (ER_OK == status) {
+        status = hash.Update((const uint8_t*) data.data(), data.size());
+    }
+    if (ER_OK == status) {
+        status = hash.GetDigest(digest);
+    }
+    if (ER_OK == status) {
+        key.assign((const char*) digest, sizeof(digest));
+        key.append((const char*) extra, extraLen);
+    }
+    return status;
+}
+
 QStatus CertificateX509::DecodeCertificateDER(const qcc::String& der)
 {
     QStatus status;
@@ -991,6 +1015,14 @@ QStatus CertificateX509::DecodeCertificateDER(const qcc::String& der)
     qcc::String tmp;
     size_t siglen = 0;
 
+    /* The decoded type depends on the initial type if there is no extended key usage */
+    std::string cacheKey;
+    if (ER_OK != GetCacheKey(der, &type, sizeof(type), cacheKey)) {
+        cacheKey.clear();
+    } else if (CertificateCache::GetDecoded(cacheKey, *this)) {
+        return ER_OK;
+    }
+
     status = Crypto_ASN1::Decode(der, "((.)(o)b)", &tmp, &oid, &sig, &siglen);
     if (ER_OK != status) {
         return status;
@@ -1011,6 +1043,8 @@ QStatus CertificateX509::DecodeCertificateDER(const qcc::String& der)
     status = DecodeCertificateSig(sig);
     if (ER_OK != status) {
         QCC_LogError(status, ("Error decoding certificate signature"));
+    } else if (!cacheKey.empty()) {
+        CertificateCache::AddDecoded(cacheKey, *this);
     }
 
     return status;
@@ -1167,9 +1201,20 @@ QStatus CertificateX509::Verify(const ECCPublicKey* key) const
     if (key->empty()) {
         return ER_FAIL;
     }
+    std::string cacheKey;
+    uint32_t epoch = 0;
+    if (ER_OK != GetCacheKey(tbs, &signature, sizeof(signature), cacheKey)) {
+        cacheKey.clear();
+    } else if (CertificateCache::IsVerified(cacheKey, *key, epoch)) {
+        return ER_OK;
+    }
     Crypto_ECC ecc;
     ecc.SetDSAPublicKey(key);
-    return ecc.DSAVerify((const uint8_t*) tbs.data(), tbs.size(), &signature);
+    QStatus status = ecc.DSAVerify((const uint8_t*) tbs.data(), tbs.size(), &signature);
+    if ((ER_OK == status) && !cacheKey.empty()) {
+        CertificateCache::AddVerified(cacheKey, *key, validity, epoch);
+    }
+    return status;
 }
 
 QStatus CertificateX509::Verify(const KeyInfoNISTP256& ta) const
@@ -1415,6 +1460,11 @@ bool CertificateX509::ValidateCertificateTypeInCertChain(const CertificateX509*
     return true;
 }
 
+void AJ_CALL CertificateX509::ClearCache()
+{
+    CertificateCache::Clear();
+}
+
 QStatus CertificateX509::GetSHA256Thumbprint(uint8_t* thumbprint) const
 {
     String encodedPem;
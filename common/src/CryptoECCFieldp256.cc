@@ -235,11 +235,22 @@ uint64_t software_umul128(uint64_t u, uint64_t v, uint64_t* high)
 
 /* 64 x 64 --> 128-bit multiplication
  * (c1,c0) = a * b
+ * GCC and Clang expose the full product through unsigned __int128 on 64-bit
+ * targets, which compiles to a single multiply instruction.
  */
+#if defined(__SIZEOF_INT128__)
+#define mul(c0, c1, a, b) \
+    { \
+        unsigned __int128 _p = (unsigned __int128)(a) * (b); \
+        c0 = (digit_t)_p; \
+        c1 = (digit_t)(_p >> 64); \
+    }
+#else
 #define mul(c0, c1, a, b) \
     { \
         c0 = _umul128(a, b, &c1); \
     }
+#endif
 
 /* Multiply-and-accumulate
  * (c1,c0) = a*b+c0
@@ -1384,7 +1384,7 @@ QStatus ECDH_generate(affine_point_t* P1, bigval_t* k)
 {
     /* Compute a key pair (r, Q) then re-encode and output as (k, P1). */
     digit256_t r;
-    ecpoint_t g, Q;
+    ecpoint_t Q;
     ec_t curve;
     QStatus status;
 
@@ -1401,8 +1401,7 @@ QStatus ECDH_generate(affine_point_t* P1, bigval_t* k)
         }
     } while (!validate_256(r, curve.order));
 
-    ec_get_generator(&g, &curve);
-    status = ec_scalarmul(&g, r, &Q, &curve);        /* Q = g^r */
+    status = ec_scalarmul_base(r, &Q, &curve);       /* Q = g^r */
 
     /* Convert out of internal representation. */
     digit256_to_bigval(r, k);
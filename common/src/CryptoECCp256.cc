@@ -19,12 +19,15 @@
 
 #include <stdlib.h>
 #include <qcc/Util.h>
+#include <qcc/atomic.h>
 #include <qcc/CryptoECC.h>
 #include <qcc/CryptoECCp256.h>
 
 namespace qcc {
 
 #define W_VARBASE 6     /* Parameter for scalar multiplication.  Should use 2-2.5 KB.  Must be >= 2. */
+#define W_FIXEDBASE 5   /* Parameter for fixed-base scalar multiplication.  The table uses 33 KB. */
+#define W_DOUBLE 5      /* wNAF window for double-scalar multiplication.  Must be <= W_FIXEDBASE. */
 
 /*
  * Parameters for the NIST curve P-256.  P256_A and P256_B are the constants
@@ -846,4 +849,311 @@ QStatus ec_scalarmul(const ecpoint_t* P, digit256_t k, ecpoint_t* Q, ec_t* curve
     return status;
 }
 
+
+/* Number of points in each row of the fixed-base table: the odd multiples 1,3,...,2^(W_FIXEDBASE-1)-1. */
+#define BASE_TABLE_POINTS (1 << (W_FIXEDBASE - 2))
+
+/* Number of rows of the fixed-base table, one per digit of the fixed window representation. */
+#define BASE_TABLE_ROWS (((sizeof(digit256_t) * 8) + W_FIXEDBASE - 2) / (W_FIXEDBASE - 1) + 1)
+
+/*
+ * Row i holds the affine points (2j+1) * 2^((W_FIXEDBASE-1)*i) * G for j = 0..BASE_TABLE_POINTS-1.
+ * The table is public data.  ec_base_table_state is 0 before the table is built, 1 while a thread
+ * is building it and 2 once it can be used.
+ */
+static ecpoint_t ec_base_table[BASE_TABLE_ROWS][BASE_TABLE_POINTS];
+static volatile int32_t ec_base_table_state = 0;
+
+/* Build the fixed-base table.  This runs once, in whichever thread needs the table first. */
+static void ec_base_table_build(ec_t* curve)
+{
+    ecpoint_t B;
+    ecpoint_jacobian_t J;
+    ecpoint_chudnovsky_t T[BASE_TABLE_POINTS];
+    size_t i, j;
+
+    ec_get_generator(&B, curve);
+    for (i = 0; i < BASE_TABLE_ROWS; i++) {
+        ec_precomp(&B, T, BASE_TABLE_POINTS, curve);    /* T[j] = (2j+1)B  */
+        for (j = 0; j < BASE_TABLE_POINTS; j++) {
+            fpcopy_p256(T[j].X, J.X);
+            fpcopy_p256(T[j].Y, J.Y);
+            fpcopy_p256(T[j].Z, J.Z);
+            ec_toaffine(&J, &ec_base_table[i][j], curve);
+        }
+        ec_affine_tojacobian(&B, &J);
+        for (j = 0; j < (W_FIXEDBASE - 1); j++) {
+            ec_double_jacobian(&J);
+        }
+        ec_toaffine(&J, &B, curve);                     /* B = 2^(W_FIXEDBASE-1)B  */
+    }
+}
+
+/* Returns true if the fixed-base table can be used, building it if no other thread is doing so. */
+static bool ec_base_table_ready(ec_t* curve)
+{
+    /* The compare-and-exchange calls double as the memory barriers that publish the table. */
+    if (CompareAndExchange(&ec_base_table_state, 2, 2)) {
+        return true;
+    }
+    if (!CompareAndExchange(&ec_base_table_state, 0, 1)) {
+        return false;
+    }
+    ec_base_table_build(curve);
+    CompareAndExchange(&ec_base_table_state, 1, 2);
+    return true;
+}
+
+/* Constant-time table lookup to extract an affine point from a row of the fixed-base table
+ * Operation: P = sign * row[(|digit|-1)/2], where sign=1 if digit>0 and sign=-1 if digit<0
+ */
+static void lut_affine(const ecpoint_t* row, ecpoint_jacobian_t* P, int digit)
+{
+    unsigned int i, j;
+    digit_t sign, mask, pos;
+    digit256_t x, y, negy;
+
+    sign = ((digit_t)digit >> (RADIX_BITS - 1)) - 1;                            /* if digit<0 then sign = 0x00...0 else sign = 0xFF...F */
+    pos = ((sign & ((digit_t)digit ^ (digit_t)-digit)) ^ (digit_t)-digit) >> 1; /* position = (|digit|-1)/2  */
+    fpcopy_p256(row[0].x, x);
+    fpcopy_p256(row[0].y, y);
+
+    for (i = 1; i < BASE_TABLE_POINTS; i++) {
+        pos--;
+        /* If match then mask = 0xFF...F else mask = 0x00...0 */
+        mask = (digit_t)is_digit_nonzero_ct(pos) - 1;
+        for (j = 0; j < P256_DIGITS; j++) {
+            x[j] = (mask & (x[j] ^ row[i].x[j])) ^ x[j];
+            y[j] = (mask & (y[j] ^ row[i].y[j])) ^ y[j];
+        }
+    }
+
+    fpcopy_p256(y, negy);
+    fpneg_p256(negy);
+    for (j = 0; j < P256_DIGITS; j++) {                                 /* if sign = 0x00...0 then choose negative of the point  */
+        y[j] = (sign & (y[j] ^ negy[j])) ^ negy[j];
+    }
+    fpcopy_p256(x, P->X);
+    fpcopy_p256(y, P->Y);
+    fpzero_p256(P->Z);
+    P->Z[0] = 1;
+
+    /* cleanup */
+    fpzero_p256(x);
+    fpzero_p256(y);
+    fpzero_p256(negy);
+}
+
+/*
+ * Fixed-base scalar multiplication Q = k.G using the precomputed table
+ * Weierstrass a=-3 curve
+ */
+QStatus ec_scalarmul_base(digit256_t k, ecpoint_t* Q, ec_t* curve)
+{
+    int digits[BASE_TABLE_ROWS] = { 0 };
+    size_t i = 0;
+    size_t j = 0;
+    sdigit_t odd = 0;
+    ecpoint_jacobian_t T;
+    ecpoint_jacobian_t R;
+    digit256_t temp;
+
+    /* SECURITY NOTE: the crypto sensitive part of this function is protected against timing attacks and runs in constant-time on prime-order Weierstrass curves.
+     *                Table lookups touch every entry of a row, and the complete addition has no exceptional cases.
+     *                Conditional if-statements evaluate public data only and the number of iterations for all loops is public.
+     */
+
+    if (k == NULL || Q == NULL || curve == NULL) {
+        return ER_INVALID_ADDRESS;
+    }
+    /* Is scalar k in [1,r-1]?  */
+    if ((fpiszero_p256(k) == true) || (validate_256(k, curve->order) == false)) {
+        return ER_INVALID_DATA;
+    }
+    if (!ec_base_table_ready(curve)) {
+        return ec_scalarmul(&(curve->generator), k, Q, curve);
+    }
+
+    odd = -((sdigit_t)k[0] & 1);
+    fpsub_p256(curve->order, k, temp);                  /* Converting scalar to odd (r-k if even)  */
+    for (j = 0; j < P256_DIGITS; j++) {                 /* If (even) then k = k_temp else k = k   */
+        temp[j] = (odd & (k[j] ^ temp[j])) ^ temp[j];
+    }
+
+    fixed_window_recode(temp, (unsigned int)curve->rbits, W_FIXEDBASE, digits);
+
+    lut_affine(ec_base_table[0], &T, digits[0]);
+    for (i = 1; i < BASE_TABLE_ROWS; i++) {
+        lut_affine(ec_base_table[i], &R, digits[i]);
+        ec_add_jacobian(&R, &T, curve);                 /* Complete addition T = T + R  */
+    }
+
+    fpcopy_p256(T.Y, temp);
+    fpneg_p256(temp);                                   /* Correcting scalar (-Ty if even)  */
+    for (j = 0; j < P256_DIGITS; j++) {                 /* If (even) then Ty = -Ty   */
+        T.Y[j] = (odd & (T.Y[j] ^ temp[j])) ^ temp[j];
+    }
+
+    ec_toaffine(&T, Q, curve);                          /* Output Q = (x,y)  */
+
+    ClearMemory(digits, sizeof(digits));
+    ecpoint_jacobian_zero(&T);
+    ecpoint_jacobian_zero(&R);
+    fpzero_p256(temp);
+
+    return ER_OK;
+}
+
+/* k = k + d for a small d, returning the carry. */
+static digit_t digit256_add_small(digit256_t k, digit_t d)
+{
+    size_t i;
+    for (i = 0; i < P256_DIGITS; i++) {
+        k[i] += d;
+        d = (k[i] < d) ? 1 : 0;
+    }
+    return d;
+}
+
+/* k = k - d for a small d, returning the borrow. */
+static digit_t digit256_sub_small(digit256_t k, digit_t d)
+{
+    size_t i;
+    for (i = 0; i < P256_DIGITS; i++) {
+        digit_t borrow = (k[i] < d) ? 1 : 0;
+        k[i] -= d;
+        d = borrow;
+    }
+    return d;
+}
+
+/*
+ * Computes the width-w non-adjacent form of k, where nonzero digits are odd and in the set {+-1,+-3,...,+-(2^(w-1)-1)}.
+ * naf must have room for 257 digits.  Returns the number of digits.
+ * This is NOT constant time.
+ */
+static size_t wnaf_recode(digit256_tc k, unsigned int w, int* naf)
+{
+    digit256_t t;
+    size_t i = 0;
+    size_t j;
+    int window = 1 << w;
+
+    fpcopy_p256(k, t);
+    while (!fpiszero_p256(t)) {
+        int d = 0;
+        if (t[0] & 1) {
+            d = (int)(t[0] & (window - 1));
+            if (d >= (window >> 1)) {
+                d -= window;
+                digit256_add_small(t, (digit_t)-d);
+            } else {
+                digit256_sub_small(t, (digit_t)d);
+            }
+        }
+        naf[i++] = d;
+        for (j = 0; j < P256_DIGITS - 1; j++) {
+            SHIFTR(t[j + 1], t[j], 1, t[j]);
+        }
+        t[P256_DIGITS - 1] >>= 1;
+    }
+    return i;
+}
+
+/*
+ * Double-scalar multiplication Q = k.G + l.P using interleaved wNAF (Shamir's trick)
+ * Weierstrass a=-3 curve
+ */
+QStatus ec_doublescalarmul(digit256_tc k, const ecpoint_t* P, digit256_tc l, ecpoint_t* Q, ec_t* curve)
+{
+    const unsigned int npoints = 1 << (W_DOUBLE - 2);
+    int nafK[sizeof(digit256_t) * 8 + 1];
+    int nafL[sizeof(digit256_t) * 8 + 1];
+    ecpoint_chudnovsky_t tableP[1 << (W_DOUBLE - 2)];
+    ecpoint_chudnovsky_t tableG[1 << (W_DOUBLE - 2)];
+    ecpoint_jacobian_t pointsP[1 << (W_DOUBLE - 2)];
+    ecpoint_jacobian_t pointsG[1 << (W_DOUBLE - 2)];
+    ecpoint_jacobian_t T;
+    ecpoint_jacobian_t R;
+    bool infinity = true;
+    size_t lenK, lenL, i;
+    unsigned int j;
+
+    /* SECURITY NOTE: this function branches on the scalars and must only be used when they are public. */
+
+    if (k == NULL || P == NULL || l == NULL || Q == NULL || curve == NULL) {
+        return ER_INVALID_ADDRESS;
+    }
+    if ((validate_256(k, curve->order) == false) || (validate_256(l, curve->order) == false)) {
+        return ER_INVALID_DATA;
+    }
+    if (ec_is_infinity(P, curve) == B_TRUE) {
+        return ER_INVALID_DATA;
+    }
+    if (fpvalidate_p256(P->x) == false || fpvalidate_p256(P->y) == false) {
+        return ER_INVALID_DATA;
+    }
+
+    /* The odd multiples of G are the first row of the fixed-base table, if it is there. */
+    if (ec_base_table_ready(curve)) {
+        for (j = 0; j < npoints; j++) {
+            ec_affine_tojacobian(&ec_base_table[0][j], &pointsG[j]);
+        }
+    } else {
+        ec_precomp(&(curve->generator), tableG, npoints, curve);
+        for (j = 0; j < npoints; j++) {
+            fpcopy_p256(tableG[j].X, pointsG[j].X);
+            fpcopy_p256(tableG[j].Y, pointsG[j].Y);
+            fpcopy_p256(tableG[j].Z, pointsG[j].Z);
+        }
+    }
+    ec_precomp(P, tableP, npoints, curve);
+    for (j = 0; j < npoints; j++) {
+        fpcopy_p256(tableP[j].X, pointsP[j].X);
+        fpcopy_p256(tableP[j].Y, pointsP[j].Y);
+        fpcopy_p256(tableP[j].Z, pointsP[j].Z);
+    }
+
+    lenK = wnaf_recode(k, W_DOUBLE, nafK);
+    lenL = wnaf_recode(l, W_DOUBLE, nafL);
+
+    for (i = (lenK > lenL) ? lenK : lenL; i-- > 0;) {
+        if (!infinity) {
+            ec_double_jacobian(&T);
+        }
+        for (j = 0; j < 2; j++) {
+            int d;
+            ecpoint_jacobian_t* points;
+            if (j == 0) {
+                d = (i < lenK) ? nafK[i] : 0;
+                points = pointsG;
+            } else {
+                d = (i < lenL) ? nafL[i] : 0;
+                points = pointsP;
+            }
+            if (d == 0) {
+                continue;
+            }
+            R = points[((d < 0) ? -d : d) >> 1];
+            if (d < 0) {
+                fpneg_p256(R.Y);
+            }
+            if (infinity) {
+                T = R;
+                infinity = false;
+            } else {
+                ec_add_jacobian(&R, &T, curve);         /* Complete addition T = T + R  */
+            }
+        }
+    }
+
+    if (infinity) {
+        fpzero_p256(Q->x);
+        fpzero_p256(Q->y);
+    } else {
+        ec_toaffine(&T, Q, curve);                      /* Output Q = (x,y), or (0,0) if T is the point at infinity  */
+    }
+    return ER_OK;
+}
+
 }
@@ -35,6 +35,7 @@
 #include <qcc/String.h>
 #include <qcc/StringUtil.h>
 #include <qcc/Thread.h>
+#include <qcc/TraceRing.h>
 #include <qcc/time.h>
 #include <qcc/OSLogger.h>
 #include <qcc/LockLevel.h>
@@ -133,7 +134,9 @@ DebugControl::DebugControl(void)
         if (var.compare("ER_DEBUG_EPOCH") == 0) {
             dbgUseEpoch = true;
         }
-        if (var.compare("ER_DEBUG_THREADNAME") == 0) {
+        if (var.compare("ER_DEBUG_TRACEFILE") == 0) {
+            // Opened by TraceRing::Init() once threads can be started
+        } else if (var.compare("ER_DEBUG_THREADNAME") == 0) {
             printThread = ((iter->second.compare("0") != 0) &&
                            (iter->second.compare("off") != 0) &&
                            (iter->second.compare("OFF") != 0));
@@ -258,7 +261,8 @@ static const char* Type2Str(DbgMsgType type)
 }
 
 
-static void GenPrefix(qcc::String& oss, DbgMsgType type, const char* module, const char* filename, int lineno, bool printThread, bool useEpoch)
+void qcc::DebugPrefix(qcc::String& oss, DbgMsgType type, const char* module, const char* filename, int lineno,
+                      const char* threadName, bool useEpoch, uint64_t timestamp)
 {
     static const size_t timeTypeWidth = 18;
     static const size_t moduleWidth = 12;
@@ -271,13 +275,11 @@ static void GenPrefix(qcc::String& oss, DbgMsgType type, const char* module, con
 
     if (useEpoch) {
         colStop = 24;
-        uint64_t timestamp = GetEpochTimestamp();
         logTimeSecond = U64ToString(timestamp / 1000, 10, 10, ' ');
         logTimeMS = U64ToString(timestamp % 1000, 10, 3, '0');
     } else {
-        uint32_t timestamp = GetTimestamp();
-        logTimeSecond = U32ToString((timestamp / 1000) % 10000, 10, 4, ' ');
-        logTimeMS = U32ToString(timestamp % 1000, 10, 3, '0');
+        logTimeSecond = U32ToString(static_cast<uint32_t>((timestamp / 1000) % 10000), 10, 4, ' ');
+        logTimeMS = U32ToString(static_cast<uint32_t>(timestamp % 1000), 10, 3, '0');
     }
 
     oss.reserve(colStop + moduleWidth + threadWidth + fileLineWidth + oss.capacity());
@@ -301,10 +303,10 @@ static void GenPrefix(qcc::String& oss, DbgMsgType type, const char* module, con
         oss.push_back(' ');
     } while (oss.size() < colStop);
 
-    if (printThread) {
+    if (threadName) {
         // Thread name - col 30
         colStop += threadWidth;
-        oss.append(Thread::GetThreadName());
+        oss.append(threadName);
         do {
             oss.push_back(' ');
         } while (oss.size() < colStop);
@@ -336,14 +338,26 @@ static void GenPrefix(qcc::String& oss, DbgMsgType type, const char* module, con
     // Msg at col 70 or 80
 }
 
+static void GenPrefix(qcc::String& oss, DbgMsgType type, const char* module, const char* filename, int lineno, bool printThread, bool useEpoch)
+{
+    uint64_t timestamp = useEpoch ? GetEpochTimestamp() : GetTimestamp();
+    DebugPrefix(oss, type, module, filename, lineno, printThread ? Thread::GetThreadName() : NULL, useEpoch, timestamp);
+}
+
 
+/*
+ * While a trace file is open messages are captured rather than formatted.  msg
+ * then holds the format strings and raw arguments for TraceRing.
+ */
 class DebugContext {
   private:
     char msg[2000];  // Just allocate a buffer that's 'big enough'.
     size_t msgLen;
+    bool captured;
+    qcc::String capturedMsg;
 
   public:
-    DebugContext(void) : msgLen(0)
+    DebugContext(bool capture = false) : msgLen(0), captured(capture)
     {
         msg[0] = '\0';
     }
@@ -352,25 +366,72 @@ class DebugContext {
     {
     }
 
+    static DebugContext* Create();
+    static void Destroy(DebugContext* context);
+
     void Process(DbgMsgType type, const char* module, const char* filename, int lineno);
     void Vprintf(const char* fmt, va_list ap);
 
     const char* GetMsg()
     {
+        if (captured) {
+            capturedMsg.clear();
+            TraceRing::Format(capturedMsg, reinterpret_cast<const uint8_t*>(msg), msgLen);
+            return capturedMsg.c_str();
+        }
         return (const char*)&msg[0];
     }
 };
 
+/*
+ * Messages are captured far more often than a thread has two in progress at
+ * once so each thread keeps a context for capturing.
+ */
+static thread_local DebugContext threadContext(true);
+static thread_local bool threadContextInUse = false;
+
+DebugContext* DebugContext::Create()
+{
+    if (!TraceRing::IsRunning()) {
+        return new DebugContext();
+    }
+    if (threadContextInUse) {
+        return new DebugContext(true);
+    }
+    threadContextInUse = true;
+    threadContext.msgLen = 0;
+    return &threadContext;
+}
+
+void DebugContext::Destroy(DebugContext* context)
+{
+    if (context == &threadContext) {
+        threadContextInUse = false;
+    } else {
+        delete context;
+    }
+}
+
 void DebugContext::Process(DbgMsgType type, const char* module, const char* filename, int lineno)
 {
     qcc::String oss;
 
-    oss.reserve(sizeof(msg));
+    if (captured) {
+        /* Errors are always written immediately */
+        if ((type != DBG_LOCAL_ERROR) && (type != DBG_REMOTE_ERROR) &&
+            TraceRing::Record(type, module, filename, lineno, reinterpret_cast<const uint8_t*>(msg), msgLen)) {
+            return;
+        }
+        GenPrefix(oss, type, module, filename, lineno, dbgControl->PrintThread(), dbgUseEpoch);
+        TraceRing::Format(oss, reinterpret_cast<const uint8_t*>(msg), msgLen);
+    } else {
+        oss.reserve(sizeof(msg));
 
-    GenPrefix(oss, type, module, filename, lineno, dbgControl->PrintThread(), dbgUseEpoch);
+        GenPrefix(oss, type, module, filename, lineno, dbgControl->PrintThread(), dbgUseEpoch);
 
-    if (msg != NULL) {
-        oss.append(msg);
+        if (msg != NULL) {
+            oss.append(msg);
+        }
     }
 
     oss.push_back('\n');
@@ -382,6 +443,11 @@ void DebugContext::Vprintf(const char* fmt, va_list ap)
 {
     int mlen;
 
+    if (captured) {
+        msgLen += TraceRing::Capture(reinterpret_cast<uint8_t*>(msg) + msgLen, sizeof(msg) - msgLen, fmt, ap);
+        return;
+    }
+
     if (ER_OK == stdoutLock->Lock()) {
         if (msgLen < sizeof(msg)) {
 
@@ -412,7 +478,7 @@ void QCC_InitializeDebugControl(void)
 
 void* AJ_CALL _QCC_DbgPrintContext(const char* fmt, ...)
 {
-    DebugContext* context = new DebugContext();
+    DebugContext* context = DebugContext::Create();
     va_list ap;
 
     va_start(ap, fmt);
@@ -437,7 +503,7 @@ void AJ_CALL _QCC_DbgPrintProcess(void* ctx, DbgMsgType type, const char* module
 {
     DebugContext* context = reinterpret_cast<DebugContext*>(ctx);
     context->Process(type, module, filename, lineno);
-    delete context;
+    DebugContext::Destroy(context);
 }
 
 void AJ_CALL QCC_RegisterOutputCallback(QCC_DbgMsgCallback cb, void* context)
@@ -568,6 +634,15 @@ void AJ_CALL QCC_UseOSLogging(bool useOSLog)
     QCC_RegisterOutputCallback(cb, context);
 }
 
+void AJ_CALL QCC_SetTraceFile(const char* fileName)
+{
+    if (fileName && *fileName) {
+        TraceRing::Start(fileName, dbgUseEpoch, dbgControl->PrintThread());
+    } else {
+        TraceRing::Stop();
+    }
+}
+
 const char* AJ_CALL _QCC_DbgGetMsg(void* ctx)
 {
     DebugContext* context = reinterpret_cast<DebugContext*>(ctx);
@@ -577,7 +652,7 @@ const char* AJ_CALL _QCC_DbgGetMsg(void* ctx)
 void AJ_CALL _QCC_DbgDeleteCtx(void* ctx)
 {
     DebugContext* context = reinterpret_cast<DebugContext*>(ctx);
-    delete context;
+    DebugContext::Destroy(context);
 }
 
 extern "C" bool AJ_CALL _QCC_DbgModulesSpecified()
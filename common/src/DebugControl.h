@@ -22,11 +22,28 @@
 #ifndef _QCC_DEBUGCONTROL_H
 #define _QCC_DEBUGCONTROL_H
 
+#include <qcc/Debug.h>
 #include <qcc/Mutex.h>
+#include <qcc/String.h>
 #include <map>
 
 namespace qcc {
 
+/**
+ * Generate the prefix of a debug message.
+ *
+ * @param[out] oss     Receives the prefix.
+ * @param type         The debug type.
+ * @param module       The module name.
+ * @param filename     Filename where the debug message is.
+ * @param lineno       Line number where the debug message is.
+ * @param threadName   Name of the thread that generated the message or NULL to omit it.
+ * @param useEpoch     The timestamp is in milliseconds since the epoch.
+ * @param timestamp    When the message was generated.
+ */
+void DebugPrefix(qcc::String& oss, DbgMsgType type, const char* module, const char* filename, int lineno,
+                 const char* threadName, bool useEpoch, uint64_t timestamp);
+
 class DebugControl {
   public:
 
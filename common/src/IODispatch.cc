@@ -22,6 +22,16 @@
 #include <qcc/IODispatch.h>
 #include <qcc/StringUtil.h>
 #include <qcc/LockLevel.h>
+#include <qcc/Util.h>
+
+#if defined(QCC_OS_LINUX)
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
 #define QCC_MODULE "IODISPATCH"
 
 using namespace qcc;
@@ -36,7 +46,30 @@ IODispatch::IODispatch(const char* name, uint32_t concurrency) :
     isRunning(false),
     numAlarmsInProgress(0),
     crit(false)
+#if defined(QCC_OS_LINUX)
+    , epollFd(epoll_create1(EPOLL_CLOEXEC))
+#endif
 {
+#if defined(QCC_OS_LINUX)
+    /*
+     * The stop event is the only descriptor that is always in the poll set,
+     * source and sink events are added and removed as streams are enabled
+     * and disabled.  If epoll is not usable fall back to Event::Wait().
+     */
+    if (epollFd < 0) {
+        QCC_LogError(ER_OS_ERROR, ("epoll_create1 failed with %d (%s)", errno, strerror(errno)));
+    } else {
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.fd = stopEvent.fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, stopEvent.fd, &ev) < 0) {
+            QCC_LogError(ER_OS_ERROR, ("epoll_ctl failed for stop event with %d (%s)", errno, strerror(errno)));
+            close(epollFd);
+            epollFd = -1;
+        }
+    }
+#endif
 }
 
 IODispatch::~IODispatch()
@@ -50,6 +83,11 @@ IODispatch::~IODispatch()
      * Just a sanity check.
      */
     QCC_ASSERT(dispatchEntries.size() == 0);
+#if defined(QCC_OS_LINUX)
+    if (epollFd >= 0) {
+        close(epollFd);
+    }
+#endif
 }
 
 QStatus IODispatch::Start(void* arg, ThreadListener* listener)
@@ -127,6 +165,12 @@ QStatus IODispatch::StartStream(Stream* stream, IOReadListener* readListener, IO
     dispatchEntries[stream].writeTimeoutCtxt = new CallbackContext(stream, IO_WRITE_TIMEOUT);
     dispatchEntries[stream].readTimeoutCtxt = new CallbackContext(stream, IO_READ_TIMEOUT);
     dispatchEntries[stream].exitCtxt = new CallbackContext(stream, IO_EXIT);
+    UpdatePollSet(stream, dispatchEntries[stream]);
+
+    if (UsesPollSet()) {
+        lock.Unlock();
+        return ER_OK;
+    }
 
     /* Set reload to false and alert the IODispatch::Run thread */
     reload = false;
@@ -158,6 +202,7 @@ QStatus IODispatch::StopStream(Stream* stream)
 
     /* Disable further read and writes on this stream */
     it->second.stopping_state = IO_STOPPING;
+    UpdatePollSet(stream, it->second);
 
     /* Set reload to false and alert the IODispatch::Run thread */
     reload = false;
@@ -219,6 +264,15 @@ QStatus IODispatch::JoinStream(Stream* stream)
     lock.Unlock();
     return ER_OK;
 }
+
+size_t IODispatch::GetNumStreams()
+{
+    lock.Lock();
+    size_t numStreams = dispatchEntries.size();
+    lock.Unlock();
+    return numStreams;
+}
+
 void IODispatch::AlarmTriggered(const Alarm& alarm, QStatus reason)
 {
     QCC_UNUSED(reason);
@@ -272,6 +326,7 @@ void IODispatch::AlarmTriggered(const Alarm& alarm, QStatus reason)
          * of descriptors.
          */
         it->second.readInProgress = true;
+        UpdatePollSet(stream, it->second);
         while (!reload && crit && isRunning) {
             lock.Unlock();
             Sleep(1);
@@ -297,6 +352,7 @@ void IODispatch::AlarmTriggered(const Alarm& alarm, QStatus reason)
          * of descriptors.
          */
         it->second.writeInProgress = true;
+        UpdatePollSet(stream, it->second);
         while (!reload && crit && isRunning) {
             lock.Unlock();
             Sleep(1);
@@ -383,12 +439,143 @@ void IODispatch::AlarmTriggered(const Alarm& alarm, QStatus reason)
     }
 }
 
+void IODispatch::DispatchStreamEvent(Stream* stream, bool isSource)
+{
+    int32_t when =  0;
+    AlarmListener* listener = this;
+
+    map<Stream*, IODispatchEntry>::iterator it = dispatchEntries.find(stream);
+    if (it == dispatchEntries.end() || it->second.stopping_state != IO_RUNNING) {
+        return;
+    }
+    if (isSource) {
+        if (it->second.readEnable && !it->second.readInProgress) {
+            /* If the source event for a particular stream has been signalled,
+             * add a readAlarm to fire now, and set readInProgress to true.
+             */
+            Alarm prevAlarm = it->second.readAlarm;
+            Alarm readAlarm = Alarm(when, listener, it->second.readCtxt);
+            it->second.readInProgress = true;
+            it->second.mainAddingRead = true;
+            UpdatePollSet(stream, it->second);
+            lock.Unlock();
+            /* Remove the read timeout alarm if any first */
+            timer.RemoveAlarm(prevAlarm, true);
+            lock.Lock();
+            it = dispatchEntries.find(stream);
+            if (it != dispatchEntries.end()) {
+                it->second.mainAddingRead = false;
+            }
+
+            QStatus status = ER_TIMER_FULL;
+            while (isRunning && status == ER_TIMER_FULL && it != dispatchEntries.end() && it->second.stopping_state == IO_RUNNING) {
+                /* Call the non-blocking version of AddAlarm, while holding the
+                 * locks to ensure that the state of the dispatchEntry is valid.
+                 */
+                status = timer.AddAlarmNonBlocking(readAlarm);
+
+                if (status == ER_TIMER_FULL) {
+                    lock.Unlock();
+                    qcc::Sleep(2);
+                    lock.Lock();
+                }
+
+                it = dispatchEntries.find(stream);
+            }
+            if (status == ER_OK && it != dispatchEntries.end()) {
+                it->second.readAlarm = readAlarm;
+            }
+        }
+    } else {
+        if (it->second.writeEnable && !it->second.writeInProgress) {
+            /* If the sink event for a particular stream has been signalled,
+             * add a writeAlarm to fire now, and set writeInProgress to true.
+             */
+            Alarm prevAlarm = it->second.writeAlarm;
+            Alarm writeAlarm = Alarm(when, listener, it->second.writeCtxt);
+            it->second.writeInProgress = true;
+            it->second.mainAddingWrite = true;
+            UpdatePollSet(stream, it->second);
+            lock.Unlock();
+            /* Remove the write timeout alarm if any first */
+            timer.RemoveAlarm(prevAlarm, true);
+            lock.Lock();
+            it = dispatchEntries.find(stream);
+            if (it != dispatchEntries.end()) {
+                it->second.mainAddingWrite = false;
+            }
+
+            QStatus status = ER_TIMER_FULL;
+            while (isRunning && status == ER_TIMER_FULL && it != dispatchEntries.end() && it->second.stopping_state == IO_RUNNING) {
+                /* Call the non-blocking version of AddAlarm, while holding the
+                 * locks to ensure that the state of the dispatchEntry is valid.
+                 */
+                status = timer.AddAlarmNonBlocking(writeAlarm);
+
+                if (status == ER_TIMER_FULL) {
+                    lock.Unlock();
+                    qcc::Sleep(2);
+                    lock.Lock();
+                }
+
+                it = dispatchEntries.find(stream);
+            }
+            if (status == ER_OK && it != dispatchEntries.end()) {
+                it->second.writeAlarm = writeAlarm;
+            }
+        }
+    }
+}
+
+void IODispatch::AddExitAlarms()
+{
+    int32_t when =  0;
+    AlarmListener* listener = this;
+
+    map<Stream*, IODispatchEntry>::iterator it = dispatchEntries.begin();
+    /* Add exit alarms for any streams that are being stopped.
+     * We dont need to keep track of the exit alarm, since we never remove
+     * the exit alarm. Hence it is not a part of IODispatchEntry.
+     */
+    while (it != dispatchEntries.end() && isRunning) {
+        if (it->second.stopping_state == IO_STOPPING) {
+            Alarm exitAlarm = Alarm(when, listener, it->second.exitCtxt);
+            Stream* lookup = it->first;
+            QStatus status = ER_TIMER_FULL;
+            while (isRunning && status == ER_TIMER_FULL && it != dispatchEntries.end() && it->second.stopping_state != IO_STOPPED) {
+                /* Call the non-blocking version of AddAlarm, while holding the
+                 * locks to ensure that the state of the dispatchEntry is valid.
+                 */
+                status = timer.AddAlarmNonBlocking(exitAlarm);
+
+                if (status == ER_TIMER_FULL) {
+                    lock.Unlock();
+                    qcc::Sleep(2);
+                    lock.Lock();
+                }
+                it = dispatchEntries.find(lookup);
+            }
+            if (status == ER_OK && it != dispatchEntries.end()) {
+                it->second.stopping_state = IO_STOPPED;
+                it++;
+            }
+
+        } else {
+            it++;
+        }
+    }
+}
+
 ThreadReturn STDCALL IODispatch::Run(void* arg) {
     QCC_UNUSED(arg);
 
+#if defined(QCC_OS_LINUX)
+    if (UsesPollSet()) {
+        return RunPollSet();
+    }
+#endif
+
     vector<qcc::Event*> checkEvents, signaledEvents;
-    int32_t when =  0;
-    AlarmListener* listener = this;
 
     while (!IsStopping()) {
         checkEvents.clear();
@@ -441,39 +628,7 @@ ThreadReturn STDCALL IODispatch::Run(void* arg) {
                  */
                 lock.Lock();
                 stopEvent.ResetEvent();
-
-                it = dispatchEntries.begin();
-                /* Add exit alarms for any streams that are being stopped.
-                 * We dont need to keep track of the exit alarm, since we never remove
-                 * the exit alarm. Hence it is not a part of IODispatchEntry.
-                 */
-                while (it != dispatchEntries.end() && isRunning) {
-                    if (it->second.stopping_state == IO_STOPPING) {
-                        Alarm exitAlarm = Alarm(when, listener, it->second.exitCtxt);
-                        Stream* lookup = it->first;
-                        QStatus status = ER_TIMER_FULL;
-                        while (isRunning && status == ER_TIMER_FULL && it != dispatchEntries.end() && it->second.stopping_state != IO_STOPPED) {
-                            /* Call the non-blocking version of AddAlarm, while holding the
-                             * locks to ensure that the state of the dispatchEntry is valid.
-                             */
-                            status = timer.AddAlarmNonBlocking(exitAlarm);
-
-                            if (status == ER_TIMER_FULL) {
-                                lock.Unlock();
-                                qcc::Sleep(2);
-                                lock.Lock();
-                            }
-                            it = dispatchEntries.find(lookup);
-                        }
-                        if (status == ER_OK && it != dispatchEntries.end()) {
-                            it->second.stopping_state = IO_STOPPED;
-                            it++;
-                        }
-
-                    } else {
-                        it++;
-                    }
-                }
+                AddExitAlarms();
                 lock.Unlock();
                 continue;
             } else {
@@ -485,83 +640,13 @@ ThreadReturn STDCALL IODispatch::Run(void* arg) {
 
                     if (it->second.stopping_state == IO_RUNNING) {
                         if (&stream->GetSourceEvent() == *i) {
-
                             if (it->second.readEnable && !it->second.readInProgress) {
-                                /* If the source event for a particular stream has been signalled,
-                                 * add a readAlarm to fire now, and set readInProgress to true.
-                                 */
-                                Alarm prevAlarm = it->second.readAlarm;
-                                Alarm readAlarm = Alarm(when, listener, it->second.readCtxt);
-                                it->second.readInProgress = true;
-                                it->second.mainAddingRead = true;
-                                lock.Unlock();
-                                /* Remove the read timeout alarm if any first */
-                                timer.RemoveAlarm(prevAlarm, true);
-                                lock.Lock();
-                                it = dispatchEntries.find(stream);
-                                if (it != dispatchEntries.end()) {
-                                    it->second.mainAddingRead = false;
-                                }
-
-                                QStatus status = ER_TIMER_FULL;
-                                while (isRunning && status == ER_TIMER_FULL && it != dispatchEntries.end() && it->second.stopping_state == IO_RUNNING) {
-                                    /* Call the non-blocking version of AddAlarm, while holding the
-                                     * locks to ensure that the state of the dispatchEntry is valid.
-                                     */
-                                    status = timer.AddAlarmNonBlocking(readAlarm);
-
-                                    if (status == ER_TIMER_FULL) {
-                                        lock.Unlock();
-                                        qcc::Sleep(2);
-                                        lock.Lock();
-                                    }
-
-                                    it = dispatchEntries.find(stream);
-                                }
-                                if (status == ER_OK && it != dispatchEntries.end()) {
-                                    it->second.readAlarm = readAlarm;
-                                }
-
+                                DispatchStreamEvent(stream, true);
                                 break;
                             }
-
                         } else if (&stream->GetSinkEvent() == *i) {
                             if (it->second.writeEnable && !it->second.writeInProgress) {
-                                /* If the sink event for a particular stream has been signalled,
-                                 * add a writeAlarm to fire now, and set writeInProgress to true.
-                                 */
-                                Alarm prevAlarm = it->second.writeAlarm;
-                                Alarm writeAlarm = Alarm(when, listener, it->second.writeCtxt);
-                                it->second.writeInProgress = true;
-                                it->second.mainAddingWrite = true;
-                                lock.Unlock();
-                                /* Remove the write timeout alarm if any first */
-                                timer.RemoveAlarm(prevAlarm, true);
-                                lock.Lock();
-                                it = dispatchEntries.find(stream);
-                                if (it != dispatchEntries.end()) {
-                                    it->second.mainAddingWrite = false;
-                                }
-
-                                QStatus status = ER_TIMER_FULL;
-                                while (isRunning && status == ER_TIMER_FULL && it != dispatchEntries.end() && it->second.stopping_state == IO_RUNNING) {
-                                    /* Call the non-blocking version of AddAlarm, while holding the
-                                     * locks to ensure that the state of the dispatchEntry is valid.
-                                     */
-                                    status = timer.AddAlarmNonBlocking(writeAlarm);
-
-                                    if (status == ER_TIMER_FULL) {
-                                        lock.Unlock();
-                                        qcc::Sleep(2);
-                                        lock.Lock();
-                                    }
-
-                                    it = dispatchEntries.find(stream);
-                                }
-                                if (status == ER_OK && it != dispatchEntries.end()) {
-                                    it->second.writeAlarm = writeAlarm;
-                                }
-
+                                DispatchStreamEvent(stream, false);
                                 break;
                             }
                         }
@@ -581,6 +666,210 @@ ThreadReturn STDCALL IODispatch::Run(void* arg) {
     return (ThreadReturn) 0;
 }
 
+#if defined(QCC_OS_LINUX)
+ThreadReturn IODispatch::RunPollSet()
+{
+    struct epoll_event events[64];
+    vector<pair<Stream*, bool> > signaled;
+
+    while (!IsStopping()) {
+        signaled.clear();
+
+        /* Only TIMED events and descriptors that cannot be polled limit how long we wait,
+         * everything else is already in the poll set.
+         */
+        lock.Lock();
+        reload = true;
+        int timeout = readyFds.empty() ? -1 : 0;
+        uint32_t now = GetTimestamp();
+        for (map<pair<Stream*, bool>, Event*>::iterator t = timedPolls.begin(); t != timedPolls.end() && timeout != 0; ++t) {
+            uint32_t timestamp = t->second->timestamp;
+            if (timestamp <= now) {
+                timeout = 0;
+            } else if (timestamp != Event::WAIT_FOREVER) {
+                int remaining = static_cast<int>(min<uint32_t>(timestamp - now, INT32_MAX));
+                timeout = (timeout < 0) ? remaining : min(timeout, remaining);
+            }
+        }
+        crit = true;
+        lock.Unlock();
+
+        int ret = epoll_wait(epollFd, events, ArraySize(events), timeout);
+
+        lock.Lock();
+        crit = false;
+        reload = true;
+
+        if (ret < 0 && errno != EINTR) {
+            QCC_LogError(ER_OS_ERROR, ("epoll_wait failed with %d (%s)", errno, strerror(errno)));
+        }
+        bool stopSignaled = false;
+        for (int n = 0; n < ret; ++n) {
+            if (events[n].data.fd == stopEvent.fd) {
+                stopSignaled = true;
+                continue;
+            }
+            map<int, PollFd>::iterator pit = pollFds.find(events[n].data.fd);
+            if (pit != pollFds.end()) {
+                for (vector<PollWatcher>::iterator w = pit->second.watchers.begin(); w != pit->second.watchers.end(); ++w) {
+                    if (events[n].events & (w->events | EPOLLERR | EPOLLHUP)) {
+                        signaled.push_back(make_pair(w->stream, w->isSource));
+                    }
+                }
+            }
+        }
+        for (set<int>::iterator r = readyFds.begin(); r != readyFds.end(); ++r) {
+            map<int, PollFd>::iterator pit = pollFds.find(*r);
+            if (pit != pollFds.end()) {
+                for (vector<PollWatcher>::iterator w = pit->second.watchers.begin(); w != pit->second.watchers.end(); ++w) {
+                    signaled.push_back(make_pair(w->stream, w->isSource));
+                }
+            }
+        }
+        now = GetTimestamp();
+        for (map<pair<Stream*, bool>, Event*>::iterator t = timedPolls.begin(); t != timedPolls.end(); ++t) {
+            Event* evt = t->second;
+            if (evt->timestamp <= now) {
+                signaled.push_back(t->first);
+                if (0 < evt->period) {
+                    evt->timestamp += (((now - evt->timestamp) / evt->period) + 1) * evt->period;
+                }
+            }
+        }
+
+        if (stopSignaled) {
+            /* See Run() for why the stop event is reset before adding the exit alarms */
+            stopEvent.ResetEvent();
+            AddExitAlarms();
+        }
+        for (vector<pair<Stream*, bool> >::iterator i = signaled.begin(); i != signaled.end(); ++i) {
+            DispatchStreamEvent(i->first, i->second);
+        }
+        lock.Unlock();
+    }
+    lock.Lock();
+    reload = true;
+    QCC_DbgPrintf(("IODispatch::RunPollSet exiting"));
+    lock.Unlock();
+
+    return (ThreadReturn) 0;
+}
+
+void IODispatch::PollAdd(Stream* stream, bool isSource, Event& evt, IOPollRegistration& reg)
+{
+    reg.active = true;
+    if (evt.eventType == Event::TIMED) {
+        reg.timedEvent = &evt;
+        timedPolls[make_pair(stream, isSource)] = &evt;
+        return;
+    }
+    uint32_t events = (evt.eventType == Event::IO_WRITE) ? EPOLLOUT : EPOLLIN;
+    reg.fds[0] = evt.fd;
+    reg.fds[1] = evt.ioFd;
+    for (size_t i = 0; i < ArraySize(reg.fds); ++i) {
+        if (reg.fds[i] >= 0) {
+            PollFd& pollFd = pollFds[reg.fds[i]];
+            pollFd.watchers.push_back(PollWatcher(stream, isSource, events));
+            PollApply(reg.fds[i], pollFd);
+        }
+    }
+}
+
+void IODispatch::PollRemove(Stream* stream, bool isSource, IOPollRegistration& reg)
+{
+    if (reg.timedEvent) {
+        timedPolls.erase(make_pair(stream, isSource));
+    }
+    for (size_t i = 0; i < ArraySize(reg.fds); ++i) {
+        map<int, PollFd>::iterator pit = pollFds.find(reg.fds[i]);
+        if (pit == pollFds.end()) {
+            continue;
+        }
+        vector<PollWatcher>& watchers = pit->second.watchers;
+        for (vector<PollWatcher>::iterator w = watchers.begin(); w != watchers.end(); ++w) {
+            if (w->stream == stream && w->isSource == isSource) {
+                watchers.erase(w);
+                break;
+            }
+        }
+        if (watchers.empty()) {
+            /* The descriptor may already have been closed, which removes it from the poll set */
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, pit->first, NULL);
+            readyFds.erase(pit->first);
+            pollFds.erase(pit);
+        } else {
+            PollApply(pit->first, pit->second);
+        }
+    }
+    reg = IOPollRegistration();
+}
+
+void IODispatch::PollApply(int fd, PollFd& pollFd)
+{
+    uint32_t events = 0;
+    for (vector<PollWatcher>::iterator w = pollFd.watchers.begin(); w != pollFd.watchers.end(); ++w) {
+        events |= w->events;
+    }
+    if (events == pollFd.events) {
+        return;
+    }
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.fd = fd;
+    /*
+     * A descriptor that was closed and reused behind our back is no longer (or
+     * already) in the poll set, so retry with the other operation.
+     */
+    int ret = epoll_ctl(epollFd, pollFd.events ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &ev);
+    if (ret < 0 && errno == ENOENT) {
+        ret = epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    } else if (ret < 0 && errno == EEXIST) {
+        ret = epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+    }
+    if (ret < 0 && errno == EPERM) {
+        /* Regular files cannot be polled, select() always reports them as ready */
+        readyFds.insert(fd);
+    } else if (ret < 0) {
+        QCC_LogError(ER_OS_ERROR, ("epoll_ctl failed for fd %d with %d (%s)", fd, errno, strerror(errno)));
+    }
+    pollFd.events = events;
+}
+#endif
+
+bool IODispatch::UsesPollSet() const
+{
+#if defined(QCC_OS_LINUX)
+    return epollFd >= 0;
+#else
+    return false;
+#endif
+}
+
+void IODispatch::UpdatePollSet(Stream* stream, IODispatchEntry& entry)
+{
+#if defined(QCC_OS_LINUX)
+    if (epollFd < 0) {
+        return;
+    }
+    bool running = (entry.stopping_state == IO_RUNNING);
+    bool wantSource = running && entry.readEnable && !entry.readInProgress;
+    bool wantSink = running && entry.writeEnable && !entry.writeInProgress;
+    if (wantSource && !entry.sourcePoll.active) {
+        PollAdd(stream, true, stream->GetSourceEvent(), entry.sourcePoll);
+    } else if (!wantSource && entry.sourcePoll.active) {
+        PollRemove(stream, true, entry.sourcePoll);
+    }
+    if (wantSink && !entry.sinkPoll.active) {
+        PollAdd(stream, false, stream->GetSinkEvent(), entry.sinkPoll);
+    } else if (!wantSink && entry.sinkPoll.active) {
+        PollRemove(stream, false, entry.sinkPoll);
+    }
+#else
+    QCC_UNUSED(stream);
+    QCC_UNUSED(entry);
+#endif
+}
 
 QStatus IODispatch::EnableReadCallback(const Source* source, uint32_t timeout)
 {
@@ -633,14 +922,18 @@ QStatus IODispatch::EnableReadCallback(const Source* source, uint32_t timeout)
              * it was successful
              */
             it->second.readInProgress = false;
+            UpdatePollSet(lookup, it->second);
         }
     } else {
         /* Timeout = 0 indicates that no timeout alarm is required for this stream */
         it->second.readInProgress = false;
+        UpdatePollSet(lookup, it->second);
     }
     lock.Unlock();
 
-    Thread::Alert();
+    if (!UsesPollSet()) {
+        Thread::Alert();
+    }
     /* Dont need to wait for the IODispatch::Run thread to reload
      * the set of file descriptors since we're enabling read.
      */
@@ -727,7 +1020,12 @@ QStatus IODispatch::DisableReadCallback(const Source* source)
         return ER_INVALID_STREAM;
     }
     it->second.readEnable = false;
+    UpdatePollSet(lookup, it->second);
     lock.Unlock();
+    if (UsesPollSet()) {
+        /* The source event has already been removed from the poll set */
+        return ER_OK;
+    }
     Thread::Alert();
     /* Wait until the IODispatch::Run thread reloads the set of check events
      * since we are disabling read.
@@ -760,6 +1058,7 @@ QStatus IODispatch::EnableWriteCallbackNow(Sink* sink)
     }
     it->second.writeEnable = true;
     it->second.writeInProgress = true;
+    UpdatePollSet(lookup, it->second);
 
     int32_t when = 0;
     AlarmListener* listener = this;
@@ -774,6 +1073,7 @@ QStatus IODispatch::EnableWriteCallbackNow(Sink* sink)
          * Do not block here, since it can create deadlocks.
          */
         it->second.writeInProgress = false;
+        UpdatePollSet(lookup, it->second);
         Thread::Alert();
     }
     lock.Unlock();
@@ -829,12 +1129,16 @@ QStatus IODispatch::EnableWriteCallback(Sink* sink, uint32_t timeout)
 
             dispatchEntriesIt->second.writeAlarm = writeAlarm;
             dispatchEntriesIt->second.writeInProgress = false;
+            UpdatePollSet(lookup, dispatchEntriesIt->second);
         }
     } else {
         it->second.writeInProgress = false;
+        UpdatePollSet(lookup, it->second);
     }
     lock.Unlock();
-    Thread::Alert();
+    if (!UsesPollSet()) {
+        Thread::Alert();
+    }
 
     /* Dont need to wait for the IODispatch::Run thread to reload
      * the set of file descriptors, since we are enabling write callback.
@@ -857,8 +1161,13 @@ QStatus IODispatch::DisableWriteCallback(const Sink* sink)
         return ER_INVALID_STREAM;
     }
     it->second.writeEnable = false;
+    UpdatePollSet(lookup, it->second);
 
     lock.Unlock();
+    if (UsesPollSet()) {
+        /* The sink event has already been removed from the poll set */
+        return ER_OK;
+    }
     Thread::Alert();
     /* Wait until the IODispatch::Run thread reloads the set of check events
      * since we are disabling write.
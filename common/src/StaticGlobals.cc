@@ -26,12 +26,14 @@
 #include <qcc/Logger.h>
 #include <qcc/String.h>
 #include <qcc/Thread.h>
+#include <qcc/TraceRing.h>
 #include <qcc/Util.h>
 #include <qcc/PerfCounters.h>
 #ifdef QCC_OS_GROUP_WINDOWS
 #include <qcc/windows/utility.h>
 #include <qcc/windows/NamedPipeWrapper.h>
 #endif
+#include "CertificateCache.h"
 #include "Crypto.h"
 #include "DebugControl.h"
 
@@ -72,11 +74,15 @@ class StaticGlobals {
             Shutdown();
             return status;
         }
+        CertificateCache::Init();
+        TraceRing::Init();
         return ER_OK;
     }
 
     static QStatus Shutdown()
     {
+        TraceRing::Shutdown();
+        CertificateCache::Shutdown();
         Crypto::Shutdown();
         Thread::StaticShutdown();
         LoggerSetting::Shutdown();
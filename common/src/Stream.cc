@@ -62,6 +62,32 @@ QStatus Source::GetLine(qcc::String& outStr, uint32_t timeout)
     return ((status == ER_EOF) && hasBytes) ? ER_OK : status;
 }
 
+QStatus Sink::PushBytesV(const IOVec* iov, size_t numIov, size_t& numSent)
+{
+    QStatus status = ER_OK;
+    numSent = 0;
+    /*
+     * Push the buffers one at a time stopping at the first buffer that is not
+     * completely consumed. An error is only reported if nothing was pushed,
+     * otherwise it will be reported by the next push.
+     */
+    for (size_t i = 0; i < numIov; ++i) {
+        size_t sent = 0;
+        status = PushBytes(iov[i].buf, iov[i].len, sent);
+        if (status != ER_OK) {
+            if (numSent > 0) {
+                status = ER_OK;
+            }
+            break;
+        }
+        numSent += sent;
+        if (sent < iov[i].len) {
+            break;
+        }
+    }
+    return status;
+}
+
 void Stream::UpdateIdleInformation(bool isStarting)
 {
     QCC_DbgPrintf(("UpdateIdleInformation(%u)", (uint32_t)isStarting));
@@ -31,6 +31,8 @@
 #include <Status.h>
 #include <algorithm>
 
+#include "AlarmStore.h"
+
 #define QCC_MODULE  "TIMER"
 
 #define WORKER_IDLE_TIMEOUT_MS  20
@@ -97,8 +99,9 @@ class TimerImpl : public ThreadListener {
      * @param concurrency        Dispatch up to this number of alarms concurrently (using multiple threads).
      * @param prevenReentrancy   Prevent re-entrant call of AlarmTriggered.
      * @param maxAlarms          Maximum number of outstanding alarms allowed before blocking calls to AddAlarm or 0 for infinite.
+     * @param storeType          Container used to hold the pending alarms.
      */
-    TimerImpl(qcc::String name, bool expireOnExit, uint32_t concurrency, bool preventReentrancy, uint32_t maxAlarms);
+    TimerImpl(qcc::String name, bool expireOnExit, uint32_t concurrency, bool preventReentrancy, uint32_t maxAlarms, Timer::AlarmStoreType storeType);
 
     /**
      * Destructor.
@@ -261,7 +264,7 @@ class TimerImpl : public ThreadListener {
     TimerImpl& operator=(const TimerImpl&);
 
     mutable Mutex lock;
-    std::set<Alarm, std::less<Alarm> >  alarms;
+    AlarmStore* alarms;
     Alarm* currentAlarm;
     bool expireOnExit;
     std::vector<TimerThread*> timerThreads;
@@ -279,8 +282,9 @@ class TimerImpl : public ThreadListener {
 
 }
 
-TimerImpl::TimerImpl(String name, bool expireOnExit, uint32_t concurrency, bool preventReentrancy, uint32_t maxAlarms) :
+TimerImpl::TimerImpl(String name, bool expireOnExit, uint32_t concurrency, bool preventReentrancy, uint32_t maxAlarms, Timer::AlarmStoreType storeType) :
     lock(LOCK_LEVEL_TIMERIMPL_LOCK),
+    alarms(AlarmStore::Create(storeType)),
     currentAlarm(NULL),
     expireOnExit(expireOnExit),
     timerThreads(concurrency),
@@ -305,6 +309,7 @@ TimerImpl::~TimerImpl()
             timerThreads[i] = NULL;
         }
     }
+    delete alarms;
 }
 
 QStatus TimerImpl::Start()
@@ -409,8 +414,8 @@ QStatus TimerImpl::AddAlarm(const Alarm& alarm)
         /* Ensure timer is still running */
         if (isRunning) {
             /* Insert the alarm and alert the TimerImpl thread if necessary */
-            bool alertThread = alarms.empty() || (alarm < *alarms.begin());
-            alarms.insert(alarm);
+            bool alertThread = alarms->Empty() || (alarm < alarms->Front());
+            alarms->Insert(alarm);
             if (alarm->limitable) {
                 numLimitableAlarms++;
             }
@@ -444,8 +449,8 @@ QStatus TimerImpl::AddAlarmNonBlocking(const Alarm& alarm)
         }
 
         /* Insert the alarm and alert the TimerImpl thread if necessary */
-        bool alertThread = alarms.empty() || (alarm < *alarms.begin());
-        alarms.insert(alarm);
+        bool alertThread = alarms->Empty() || (alarm < alarms->Front());
+        alarms->Insert(alarm);
         if (alarm->limitable) {
             numLimitableAlarms++;
         }
@@ -468,28 +473,14 @@ bool TimerImpl::RemoveAlarm(const Alarm& alarm, bool blockIfTriggered)
     bool foundAlarm = false;
     lock.Lock(MUTEX_CONTEXT);
     if (isRunning || expireOnExit) {
+        Alarm removed = alarm;
         if (alarm->periodMs) {
-            set<Alarm>::iterator it = alarms.begin();
-            while (it != alarms.end()) {
-                if ((*it)->id == alarm->id) {
-                    foundAlarm = true;
-                    if ((*it)->limitable) {
-                        numLimitableAlarms--;
-                    }
-                    alarms.erase(it);
-                    break;
-                }
-                ++it;
-            }
+            foundAlarm = alarms->RemoveId(alarm, removed);
         } else {
-            set<Alarm>::iterator it = alarms.find(alarm);
-            if (it != alarms.end()) {
-                foundAlarm = true;
-                if ((*it)->limitable) {
-                    numLimitableAlarms--;
-                }
-                alarms.erase(it);
-            }
+            foundAlarm = alarms->Remove(alarm, removed);
+        }
+        if (foundAlarm && removed->limitable) {
+            numLimitableAlarms--;
         }
         if (blockIfTriggered && !foundAlarm) {
             /*
@@ -522,28 +513,14 @@ bool TimerImpl::ForceRemoveAlarm(const Alarm& alarm, bool blockIfTriggered)
     bool foundAlarm = false;
     lock.Lock(MUTEX_CONTEXT);
     if (isRunning || expireOnExit) {
+        Alarm removed = alarm;
         if (alarm->periodMs) {
-            set<Alarm>::iterator it = alarms.begin();
-            while (it != alarms.end()) {
-                if ((*it)->id == alarm->id) {
-                    foundAlarm = true;
-                    if ((*it)->limitable) {
-                        numLimitableAlarms--;
-                    }
-                    alarms.erase(it);
-                    break;
-                }
-                ++it;
-            }
+            foundAlarm = alarms->RemoveId(alarm, removed);
         } else {
-            set<Alarm>::iterator it = alarms.find(alarm);
-            if (it != alarms.end()) {
-                foundAlarm = true;
-                if ((*it)->limitable) {
-                    numLimitableAlarms--;
-                }
-                alarms.erase(it);
-            }
+            foundAlarm = alarms->Remove(alarm, removed);
+        }
+        if (foundAlarm && removed->limitable) {
+            numLimitableAlarms--;
         }
         if (blockIfTriggered && !foundAlarm) {
             /*
@@ -577,12 +554,11 @@ QStatus TimerImpl::ReplaceAlarm(const Alarm& origAlarm, const Alarm& newAlarm, b
     QStatus status = ER_NO_SUCH_ALARM;
     lock.Lock(MUTEX_CONTEXT);
     if (isRunning) {
-        set<Alarm>::iterator it = alarms.find(origAlarm);
-        if (it != alarms.end()) {
-            if ((*it)->limitable) {
+        Alarm removed = origAlarm;
+        if (alarms->Remove(origAlarm, removed)) {
+            if (removed->limitable) {
                 numLimitableAlarms--;
             }
-            alarms.erase(it);
             status = AddAlarm(newAlarm);
         } else if (blockIfTriggered) {
             /*
@@ -615,16 +591,9 @@ bool TimerImpl::RemoveAlarm(const AlarmListener& listener, Alarm& alarm)
     bool removedOne = false;
     lock.Lock(MUTEX_CONTEXT);
     if (isRunning || expireOnExit) {
-        for (set<Alarm>::iterator it = alarms.begin(); it != alarms.end(); ++it) {
-            if ((*it)->listener == &listener) {
-                alarm = *it;
-                if ((*it)->limitable) {
-                    numLimitableAlarms--;
-                }
-                alarms.erase(it);
-                removedOne = true;
-                break;
-            }
+        removedOne = alarms->RemoveListener(listener, alarm);
+        if (removedOne && alarm->limitable) {
+            numLimitableAlarms--;
         }
         /*
          * This function is most likely being called because the listener is about to be freed. If there
@@ -665,7 +634,7 @@ bool TimerImpl::HasAlarm(const Alarm& alarm) const
     bool ret = false;
     lock.Lock(MUTEX_CONTEXT);
     if (isRunning) {
-        ret = alarms.count(alarm) != 0;
+        ret = alarms->Contains(alarm);
     }
     lock.Unlock(MUTEX_CONTEXT);
     return ret;
@@ -735,9 +704,9 @@ ThreadReturn STDCALL TimerThread::Run(void* arg)
          * Check for something to do, either now or at some (alarm) time in the
          * future.
          */
-        if (!timer->alarms.empty()) {
+        if (!timer->alarms->Empty()) {
             QCC_DbgPrintf(("TimerThread::Run(): Alarms pending"));
-            const Alarm topAlarm = *(timer->alarms.begin());
+            const Alarm topAlarm = timer->alarms->Front();
             int64_t delay = topAlarm->alarmTime - now;
 
             /*
@@ -949,13 +918,11 @@ ThreadReturn STDCALL TimerThread::Run(void* arg)
                  * If it has already been serviced by another thread, just ignore
                  * and go back to the top of the loop.
                  */
-                set<Alarm>::iterator it = timer->alarms.find(topAlarm);
-                if (it != timer->alarms.end()) {
-                    Alarm top = *it;
+                Alarm top = topAlarm;
+                if (timer->alarms->Remove(topAlarm, top)) {
                     if (top->limitable) {
                         timer->numLimitableAlarms--;
                     }
-                    timer->alarms.erase(it);
                     currentAlarm = &top;
                     if (0 < timer->addWaitQueue.size()) {
                         Thread* wakeMe = timer->addWaitQueue.back();
@@ -1093,16 +1060,16 @@ void TimerImpl::ThreadExit(Thread* thread)
     lock.Lock(MUTEX_CONTEXT);
     if ((!isRunning) && expireOnExit) {
         /* Call all alarms */
-        while (!alarms.empty()) {
+        while (!alarms->Empty()) {
             /*
              * Note it is possible that the callback will call RemoveAlarm()
              */
-            set<Alarm>::iterator it = alarms.begin();
-            Alarm alarm = *it;
+            const Alarm front = alarms->Front();
+            Alarm alarm = front;
+            alarms->Remove(front, alarm);
             if (alarm->limitable) {
                 numLimitableAlarms--;
             }
-            alarms.erase(it);
             tt->SetCurrentAlarm(&alarm);
             lock.Unlock(MUTEX_CONTEXT);
             tt->hasTimerLock = preventReentrancy;
@@ -1181,8 +1148,8 @@ bool TimerImpl::ThreadHoldsLock() const
     return false;
 }
 
-Timer::Timer(String name, bool expireOnExit, uint32_t concurrency, bool preventReentrancy, uint32_t maxAlarms) :
-    timerImpl(new TimerImpl(name, expireOnExit, concurrency, preventReentrancy, maxAlarms))
+Timer::Timer(String name, bool expireOnExit, uint32_t concurrency, bool preventReentrancy, uint32_t maxAlarms, AlarmStoreType storeType) :
+    timerImpl(new TimerImpl(name, expireOnExit, concurrency, preventReentrancy, maxAlarms, storeType))
 {
     /* Timer thread objects will be created when required */
 }
@@ -1222,6 +1189,11 @@ bool Timer::RemoveAlarm(const Alarm& alarm, bool blockIfTriggered)
     return timerImpl->RemoveAlarm(alarm, blockIfTriggered);
 }
 
+bool Timer::RemoveAlarm(const AlarmListener& listener, Alarm& alarm)
+{
+    return timerImpl->RemoveAlarm(listener, alarm);
+}
+
 void Timer::RemoveAlarmsWithListener(const AlarmListener& listener)
 {
     timerImpl->RemoveAlarmsWithListener(listener);
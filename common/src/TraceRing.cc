@@ -0,0 +1,1164 @@
+/**
+ * @file
+ *
+ * This file implements the binary trace log used in place of synchronous debug output.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <algorithm>
+#include <atomic>
+#include <ctype.h>
+#include <map>
+#include <memory>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include <qcc/Debug.h>
+#include <qcc/Environ.h>
+#include <qcc/Event.h>
+#include <qcc/FileStream.h>
+#include <qcc/LockLevel.h>
+#include <qcc/Mutex.h>
+#include <qcc/StringUtil.h>
+#include <qcc/Thread.h>
+#include <qcc/TraceRing.h>
+#include <qcc/time.h>
+
+#include "DebugControl.h"
+
+#include <Status.h>
+
+/*
+ * Nothing in this file may use the debug print macros while holding the
+ * trace lock since they could end up back here.
+ */
+#define QCC_MODULE "DEBUG"
+
+using namespace std;
+
+namespace qcc {
+
+/*
+ * A captured segment is the address of the format string and the length of
+ * the captured arguments followed by the arguments.  Integers, pointers,
+ * floating point values and the width or precision given by '*' take 8 bytes,
+ * strings take their length followed by their characters.
+ */
+static const size_t SEGMENT_HEADER_SIZE = sizeof(uint64_t) + sizeof(uint32_t);
+static const uint32_t NULL_STRING = 0xFFFFFFFF;
+
+/*
+ * Longest conversion specification that is handled.
+ */
+static const size_t MAX_SPEC_LEN = 32;
+
+/*
+ * A trace file starts with a marker, a version number and flags followed by
+ * records.  Each record starts with its kind.  Numbers are in host byte order.
+ *
+ *   TRACE_STRING   string id, length, characters
+ *   TRACE_THREAD   thread id, length, name
+ *   TRACE_MESSAGE  thread id, type, timestamp, module id, file id, line number,
+ *                  length of segments, segments with the format string address
+ *                  replaced by a 4 byte string id
+ *   TRACE_DROPPED  thread id, number of messages dropped because the ring was full
+ */
+static const uint32_t TRACE_FILE_MARKER = 0x5254414A;
+static const uint32_t TRACE_FILE_VERSION = 1;
+static const uint32_t TRACE_FLAG_EPOCH = 0x1;
+static const uint32_t TRACE_FLAG_THREAD = 0x2;
+
+enum {
+    TRACE_STRING = 1,
+    TRACE_THREAD = 2,
+    TRACE_MESSAGE = 3,
+    TRACE_DROPPED = 4
+};
+
+enum {
+    LEN_NONE,
+    LEN_CHAR,
+    LEN_SHORT,
+    LEN_LONG,
+    LEN_LONGLONG,
+    LEN_SIZE,
+    LEN_INTMAX,
+    LEN_PTRDIFF,
+    LEN_LONGDOUBLE
+};
+
+struct ConversionSpec {
+    size_t len;         /* Length of the specification including the '%' */
+    char conversion;
+    int length;         /* Length modifier */
+    int stars;          /* Number of '*' for the width and precision */
+    int precision;      /* Precision given in the format, -1 if none or '*' */
+    bool starPrecision; /* The precision is given by '*' */
+};
+
+/*
+ * Parse the conversion specification at fmt, which points to a '%'.  Returns
+ * false for conversions that are not handled, in which case neither the
+ * argument nor any that follow are captured.
+ */
+static bool ParseSpec(const char* fmt, ConversionSpec& spec)
+{
+    const char* p = fmt + 1;
+
+    spec.length = LEN_NONE;
+    spec.stars = 0;
+    spec.precision = -1;
+    spec.starPrecision = false;
+
+    while (*p && strchr("-+ #0'", *p)) {
+        ++p;
+    }
+    if (*p == '*') {
+        ++spec.stars;
+        ++p;
+    } else {
+        while (isdigit(*p)) {
+            ++p;
+        }
+    }
+    if (*p == '.') {
+        ++p;
+        if (*p == '*') {
+            ++spec.stars;
+            spec.starPrecision = true;
+            ++p;
+        } else {
+            spec.precision = 0;
+            while (isdigit(*p)) {
+                spec.precision = spec.precision * 10 + (*p++ - '0');
+            }
+        }
+    }
+    switch (*p) {
+    case 'h':
+        ++p;
+        if (*p == 'h') {
+            ++p;
+            spec.length = LEN_CHAR;
+        } else {
+            spec.length = LEN_SHORT;
+        }
+        break;
+
+    case 'l':
+        ++p;
+        if (*p == 'l') {
+            ++p;
+            spec.length = LEN_LONGLONG;
+        } else {
+            spec.length = LEN_LONG;
+        }
+        break;
+
+    case 'q':
+        ++p;
+        spec.length = LEN_LONGLONG;
+        break;
+
+    case 'z':
+        ++p;
+        spec.length = LEN_SIZE;
+        break;
+
+    case 'j':
+        ++p;
+        spec.length = LEN_INTMAX;
+        break;
+
+    case 't':
+        ++p;
+        spec.length = LEN_PTRDIFF;
+        break;
+
+    case 'L':
+        ++p;
+        spec.length = LEN_LONGDOUBLE;
+        break;
+
+    case 'I':
+        /* Windows length modifiers */
+        ++p;
+        if ((p[0] == '6') && (p[1] == '4')) {
+            p += 2;
+            spec.length = LEN_LONGLONG;
+        } else if ((p[0] == '3') && (p[1] == '2')) {
+            p += 2;
+        } else {
+            spec.length = LEN_SIZE;
+        }
+        break;
+    }
+
+    spec.conversion = *p;
+    spec.len = p + 1 - fmt;
+    if (!*p || !strchr("diouxXcspfFeEgGaA%", *p) || (spec.len >= MAX_SPEC_LEN)) {
+        return false;
+    }
+    /* Wide characters and strings are not handled */
+    if ((spec.length == LEN_LONG) && ((*p == 's') || (*p == 'c'))) {
+        return false;
+    }
+    if ((spec.length == LEN_LONGDOUBLE) && !strchr("fFeEgGaA", *p)) {
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Appends captured arguments to a buffer.  Once an argument does not fit no
+ * more are added so the captured arguments are always a prefix of the real ones.
+ */
+class ArgWriter {
+  public:
+    ArgWriter(uint8_t* buf, size_t size) : buf(buf), size(size), pos(0), full(false) { }
+
+    void PutU64(uint64_t val)
+    {
+        if (!full && ((size - pos) >= sizeof(val))) {
+            memcpy(buf + pos, &val, sizeof(val));
+            pos += sizeof(val);
+        } else {
+            full = true;
+        }
+    }
+
+    void PutDouble(double val)
+    {
+        uint64_t bits;
+        memcpy(&bits, &val, sizeof(bits));
+        PutU64(bits);
+    }
+
+    /*
+     * A string that does not fit is truncated like vsnprintf() would.
+     */
+    void PutString(const char* str, uint32_t len)
+    {
+        if (full || ((size - pos) < sizeof(len))) {
+            full = true;
+            return;
+        }
+        if ((len != NULL_STRING) && ((size - pos - sizeof(len)) < len)) {
+            len = static_cast<uint32_t>(size - pos - sizeof(len));
+            full = true;
+        }
+        memcpy(buf + pos, &len, sizeof(len));
+        pos += sizeof(len);
+        if (len != NULL_STRING) {
+            memcpy(buf + pos, str, len);
+            pos += len;
+        }
+    }
+
+    bool IsFull() const { return full; }
+    size_t GetLength() const { return pos; }
+
+  private:
+    uint8_t* buf;
+    size_t size;
+    size_t pos;
+    bool full;
+};
+
+/*
+ * Reads arguments appended by ArgWriter.
+ */
+class ArgReader {
+  public:
+    ArgReader(const uint8_t* buf, size_t len) : buf(buf), len(len), pos(0) { }
+
+    bool GetU64(uint64_t& val)
+    {
+        if ((len - pos) < sizeof(val)) {
+            return false;
+        }
+        memcpy(&val, buf + pos, sizeof(val));
+        pos += sizeof(val);
+        return true;
+    }
+
+    bool GetDouble(double& val)
+    {
+        uint64_t bits;
+        if (!GetU64(bits)) {
+            return false;
+        }
+        memcpy(&val, &bits, sizeof(val));
+        return true;
+    }
+
+    bool GetString(qcc::String& str, bool& isNull)
+    {
+        uint32_t strLen;
+        if ((len - pos) < sizeof(strLen)) {
+            return false;
+        }
+        memcpy(&strLen, buf + pos, sizeof(strLen));
+        pos += sizeof(strLen);
+        isNull = (strLen == NULL_STRING);
+        if (isNull) {
+            return true;
+        }
+        if ((len - pos) < strLen) {
+            return false;
+        }
+        str.resize(strLen);
+        if (strLen > 0) {
+            memcpy(&str[0], buf + pos, strLen);
+        }
+        pos += strLen;
+        return true;
+    }
+
+  private:
+    const uint8_t* buf;
+    size_t len;
+    size_t pos;
+};
+
+size_t TraceRing::Capture(uint8_t* buf, size_t size, const char* fmt, va_list ap)
+{
+    if (size < SEGMENT_HEADER_SIZE) {
+        return 0;
+    }
+    ArgWriter args(buf + SEGMENT_HEADER_SIZE, size - SEGMENT_HEADER_SIZE);
+    const char* p = fmt;
+    while (!args.IsFull() && ((p = strchr(p, '%')) != NULL)) {
+        ConversionSpec spec;
+        if (!ParseSpec(p, spec)) {
+            break;
+        }
+        p += spec.len;
+        int precision = spec.precision;
+        for (int i = 0; i < spec.stars; ++i) {
+            int star = va_arg(ap, int);
+            args.PutU64(static_cast<int64_t>(star));
+            if (spec.starPrecision && (i == (spec.stars - 1))) {
+                precision = star;
+            }
+        }
+        switch (spec.conversion) {
+        case '%':
+            break;
+
+        case 'd':
+        case 'i':
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'c':
+            {
+                int64_t val;
+                switch (spec.length) {
+                case LEN_LONG:
+                    val = va_arg(ap, long);
+                    break;
+
+                case LEN_LONGLONG:
+                    val = va_arg(ap, long long);
+                    break;
+
+                case LEN_SIZE:
+                    val = static_cast<int64_t>(va_arg(ap, size_t));
+                    break;
+
+                case LEN_INTMAX:
+                    val = va_arg(ap, intmax_t);
+                    break;
+
+                case LEN_PTRDIFF:
+                    val = va_arg(ap, ptrdiff_t);
+                    break;
+
+                default:
+                    val = va_arg(ap, int);
+                    break;
+                }
+                args.PutU64(static_cast<uint64_t>(val));
+            }
+            break;
+
+        case 'p':
+            args.PutU64(reinterpret_cast<uintptr_t>(va_arg(ap, void*)));
+            break;
+
+        case 's':
+            {
+                const char* str = va_arg(ap, const char*);
+                if (str == NULL) {
+                    args.PutString(NULL, NULL_STRING);
+                } else {
+                    size_t len = 0;
+                    if (precision >= 0) {
+                        while ((len < static_cast<size_t>(precision)) && str[len]) {
+                            ++len;
+                        }
+                    } else {
+                        len = strlen(str);
+                    }
+                    args.PutString(str, static_cast<uint32_t>(std::min(len, static_cast<size_t>(NULL_STRING - 1))));
+                }
+            }
+            break;
+
+        default:
+            if (spec.length == LEN_LONGDOUBLE) {
+                args.PutDouble(static_cast<double>(va_arg(ap, long double)));
+            } else {
+                args.PutDouble(va_arg(ap, double));
+            }
+            break;
+        }
+    }
+
+    uint64_t fmtAddr = reinterpret_cast<uintptr_t>(fmt);
+    uint32_t argLen = static_cast<uint32_t>(args.GetLength());
+    memcpy(buf, &fmtAddr, sizeof(fmtAddr));
+    memcpy(buf + sizeof(fmtAddr), &argLen, sizeof(argLen));
+    return SEGMENT_HEADER_SIZE + argLen;
+}
+
+template <typename T>
+static void AppendFormatted(qcc::String& out, const char* spec, int stars, const int* star, T value)
+{
+    char buf[256];
+    vector<char> bigBuf;
+    char* dest = buf;
+    size_t size = sizeof(buf);
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        int n;
+        if (stars == 0) {
+            n = snprintf(dest, size, spec, value);
+        } else if (stars == 1) {
+            n = snprintf(dest, size, spec, star[0], value);
+        } else {
+            n = snprintf(dest, size, spec, star[0], star[1], value);
+        }
+        if (n <= 0) {
+            return;
+        }
+        if (static_cast<size_t>(n) < size) {
+            out.append(dest, n);
+            return;
+        }
+        bigBuf.resize(n + 1);
+        dest = &bigBuf[0];
+        size = bigBuf.size();
+    }
+}
+
+/*
+ * Format one captured segment.  The text of any conversions whose arguments
+ * were not captured is copied unchanged.
+ */
+static void FormatSegment(qcc::String& out, const char* fmt, const uint8_t* buf, size_t len)
+{
+    ArgReader args(buf, len);
+    const char* p = fmt;
+    while (*p) {
+        const char* pct = strchr(p, '%');
+        if (pct == NULL) {
+            out.append(p);
+            return;
+        }
+        out.append(p, pct - p);
+        ConversionSpec spec;
+        if (!ParseSpec(pct, spec)) {
+            out.append(pct);
+            return;
+        }
+        p = pct + spec.len;
+        if (spec.conversion == '%') {
+            out.push_back('%');
+            continue;
+        }
+
+        char specStr[MAX_SPEC_LEN];
+        memcpy(specStr, pct, spec.len);
+        specStr[spec.len] = '\0';
+        int star[2] = { 0, 0 };
+        bool ok = true;
+        for (int i = 0; ok && (i < spec.stars); ++i) {
+            uint64_t val;
+            ok = args.GetU64(val);
+            star[i] = static_cast<int>(static_cast<int64_t>(val));
+        }
+
+        switch (spec.conversion) {
+        case 'd':
+        case 'i':
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'c':
+            {
+                uint64_t val = 0;
+                ok = ok && args.GetU64(val);
+                if (ok) {
+                    int64_t sval = static_cast<int64_t>(val);
+                    switch (spec.length) {
+                    case LEN_LONG:
+                        AppendFormatted(out, specStr, spec.stars, star, static_cast<long>(sval));
+                        break;
+
+                    case LEN_LONGLONG:
+                        AppendFormatted(out, specStr, spec.stars, star, static_cast<long long>(sval));
+                        break;
+
+                    case LEN_SIZE:
+                        AppendFormatted(out, specStr, spec.stars, star, static_cast<size_t>(sval));
+                        break;
+
+                    case LEN_INTMAX:
+                        AppendFormatted(out, specStr, spec.stars, star, static_cast<intmax_t>(sval));
+                        break;
+
+                    case LEN_PTRDIFF:
+                        AppendFormatted(out, specStr, spec.stars, star, static_cast<ptrdiff_t>(sval));
+                        break;
+
+                    default:
+                        AppendFormatted(out, specStr, spec.stars, star, static_cast<int>(sval));
+                        break;
+                    }
+                }
+            }
+            break;
+
+        case 'p':
+            {
+                uint64_t val = 0;
+                ok = ok && args.GetU64(val);
+                if (ok) {
+                    AppendFormatted(out, specStr, spec.stars, star, reinterpret_cast<void*>(static_cast<uintptr_t>(val)));
+                }
+            }
+            break;
+
+        case 's':
+            {
+                qcc::String str;
+                bool isNull = false;
+                ok = ok && args.GetString(str, isNull);
+                if (ok) {
+                    AppendFormatted(out, specStr, spec.stars, star, isNull ? "(null)" : str.c_str());
+                }
+            }
+            break;
+
+        default:
+            {
+                double val = 0;
+                ok = ok && args.GetDouble(val);
+                if (ok) {
+                    if (spec.length == LEN_LONGDOUBLE) {
+                        AppendFormatted(out, specStr, spec.stars, star, static_cast<long double>(val));
+                    } else {
+                        AppendFormatted(out, specStr, spec.stars, star, val);
+                    }
+                }
+            }
+            break;
+        }
+        if (!ok) {
+            out.append(pct);
+            return;
+        }
+    }
+}
+
+void TraceRing::Format(qcc::String& out, const uint8_t* buf, size_t len)
+{
+    size_t pos = 0;
+    while ((len - pos) >= SEGMENT_HEADER_SIZE) {
+        uint64_t fmtAddr;
+        uint32_t argLen;
+        memcpy(&fmtAddr, buf + pos, sizeof(fmtAddr));
+        memcpy(&argLen, buf + pos + sizeof(fmtAddr), sizeof(argLen));
+        pos += SEGMENT_HEADER_SIZE;
+        if ((len - pos) < argLen) {
+            break;
+        }
+        FormatSegment(out, reinterpret_cast<const char*>(static_cast<uintptr_t>(fmtAddr)), buf + pos, argLen);
+        pos += argLen;
+    }
+}
+
+/*
+ * Header of a message in a ring buffer.  The captured segments follow it.
+ */
+struct RecordHeader {
+    uint32_t size;          /* Size of the record including this header */
+    uint32_t type;
+    uint64_t timestamp;
+    const char* module;
+    const char* filename;
+    uint32_t lineno;
+};
+
+/*
+ * The ring buffer of one thread.  The thread adds records at the head and the
+ * drainer removes them from the tail.
+ */
+class TraceBuffer {
+  public:
+    TraceBuffer(uint32_t id, const char* threadName) : id(id), threadName(threadName), named(false), writing(false), head(0), tail(0), dropped(0) { }
+
+    bool Write(const RecordHeader& hdr, const uint8_t* buf, size_t len)
+    {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        uint64_t t = tail.load(std::memory_order_acquire);
+        if ((TraceRing::BUFFER_SIZE - (h - t)) < hdr.size) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        CopyIn(h, &hdr, sizeof(hdr));
+        CopyIn(h + sizeof(hdr), buf, len);
+        head.store(h + hdr.size, std::memory_order_release);
+        return true;
+    }
+
+    void CopyIn(uint64_t pos, const void* src, size_t len)
+    {
+        size_t offset = static_cast<size_t>(pos & (TraceRing::BUFFER_SIZE - 1));
+        size_t first = std::min(len, TraceRing::BUFFER_SIZE - offset);
+        memcpy(data + offset, src, first);
+        memcpy(data, static_cast<const uint8_t*>(src) + first, len - first);
+    }
+
+    void CopyOut(uint64_t pos, void* dest, size_t len) const
+    {
+        size_t offset = static_cast<size_t>(pos & (TraceRing::BUFFER_SIZE - 1));
+        size_t first = std::min(len, TraceRing::BUFFER_SIZE - offset);
+        memcpy(dest, data + offset, first);
+        memcpy(static_cast<uint8_t*>(dest) + first, data, len - first);
+    }
+
+    const uint32_t id;
+    const qcc::String threadName;
+    bool named;                         /* The thread name has been written to the trace file */
+    std::atomic<bool> writing;          /* The thread is adding a record, Stop() waits for it */
+    std::atomic<uint64_t> head;
+    std::atomic<uint64_t> tail;
+    std::atomic<uint32_t> dropped;
+    uint8_t data[TraceRing::BUFFER_SIZE];
+};
+
+class TraceDrainer : public Thread {
+  public:
+    TraceDrainer() : Thread("TraceDrainer") { }
+
+  protected:
+    ThreadReturn STDCALL Run(void* arg);
+};
+
+struct TraceState {
+    TraceState() : lock(LOCK_LEVEL_CHECKING_DISABLED), sink(NULL), drainer(NULL), nextId(0) { }
+
+    Mutex lock;                                         /* Protects all the members */
+    vector<std::shared_ptr<TraceBuffer> > buffers;      /* Ring buffers of the threads that have recorded messages */
+    map<const char*, uint32_t> strings;                 /* Ids of the strings written to the trace file */
+    FileSink* sink;
+    TraceDrainer* drainer;
+    uint32_t nextId;
+};
+
+/*
+ * The ring buffer of the calling thread is only replaced when a new trace file
+ * is opened.  The buffer is released when the thread exits and freed once the
+ * drainer has emptied it.
+ */
+struct ThreadTrace {
+    ThreadTrace() : generation(0), registering(false) { }
+
+    std::shared_ptr<TraceBuffer> buffer;
+    uint32_t generation;
+    bool registering;
+};
+
+static TraceState* traceState = NULL;
+static std::atomic<bool> traceRunning(false);
+static std::atomic<uint32_t> traceGeneration(0);
+static bool traceUseEpoch = false;
+static thread_local ThreadTrace threadTrace;
+
+static void PushU32(qcc::String& out, uint32_t val)
+{
+    out.append(reinterpret_cast<const char*>(&val), sizeof(val));
+}
+
+static void PushU64(qcc::String& out, uint64_t val)
+{
+    out.append(reinterpret_cast<const char*>(&val), sizeof(val));
+}
+
+static void PushString(qcc::String& out, uint8_t kind, uint32_t id, const char* str, size_t len)
+{
+    out.push_back(static_cast<char>(kind));
+    PushU32(out, id);
+    PushU32(out, static_cast<uint32_t>(len));
+    out.append(str, len);
+}
+
+static uint32_t GetStringId(qcc::String& out, const char* str)
+{
+    map<const char*, uint32_t>::iterator it = traceState->strings.find(str);
+    if (it != traceState->strings.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(traceState->strings.size());
+    traceState->strings[str] = id;
+    PushString(out, TRACE_STRING, id, str, strlen(str));
+    return id;
+}
+
+static void WriteMessage(qcc::String& out, uint32_t threadId, const RecordHeader& hdr, const uint8_t* buf, size_t len)
+{
+    uint32_t moduleId = GetStringId(out, hdr.module);
+    uint32_t fileId = GetStringId(out, hdr.filename);
+
+    /* Replace the format string addresses with ids */
+    qcc::String segs;
+    size_t pos = 0;
+    while ((len - pos) >= SEGMENT_HEADER_SIZE) {
+        uint64_t fmtAddr;
+        uint32_t argLen;
+        memcpy(&fmtAddr, buf + pos, sizeof(fmtAddr));
+        memcpy(&argLen, buf + pos + sizeof(fmtAddr), sizeof(argLen));
+        pos += SEGMENT_HEADER_SIZE;
+        PushU32(segs, GetStringId(out, reinterpret_cast<const char*>(static_cast<uintptr_t>(fmtAddr))));
+        PushU32(segs, argLen);
+        segs.append(reinterpret_cast<const char*>(buf + pos), argLen);
+        pos += argLen;
+    }
+
+    out.push_back(static_cast<char>(TRACE_MESSAGE));
+    PushU32(out, threadId);
+    PushU32(out, hdr.type);
+    PushU64(out, hdr.timestamp);
+    PushU32(out, moduleId);
+    PushU32(out, fileId);
+    PushU32(out, hdr.lineno);
+    PushU32(out, static_cast<uint32_t>(segs.size()));
+    out.append(segs);
+}
+
+/*
+ * Copy the records in all the ring buffers to the trace file.
+ */
+static void Drain()
+{
+    qcc::String out;
+    vector<uint8_t> record;
+
+    traceState->lock.Lock();
+    vector<std::shared_ptr<TraceBuffer> >::iterator it = traceState->buffers.begin();
+    while (it != traceState->buffers.end()) {
+        TraceBuffer& buffer = **it;
+        /*
+         * The thread has exited if this is the only reference to its buffer.
+         * Check before reading the head so that its last records are drained.
+         */
+        bool exited = (it->use_count() == 1);
+        if (exited) {
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        if (!buffer.named) {
+            PushString(out, TRACE_THREAD, buffer.id, buffer.threadName.data(), buffer.threadName.size());
+            buffer.named = true;
+        }
+        uint32_t dropped = buffer.dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped) {
+            out.push_back(static_cast<char>(TRACE_DROPPED));
+            PushU32(out, buffer.id);
+            PushU32(out, dropped);
+        }
+        uint64_t head = buffer.head.load(std::memory_order_acquire);
+        uint64_t tail = buffer.tail.load(std::memory_order_relaxed);
+        while (tail < head) {
+            RecordHeader hdr;
+            buffer.CopyOut(tail, &hdr, sizeof(hdr));
+            record.resize(hdr.size - sizeof(hdr) + 1);
+            buffer.CopyOut(tail + sizeof(hdr), &record[0], hdr.size - sizeof(hdr));
+            WriteMessage(out, buffer.id, hdr, &record[0], hdr.size - sizeof(hdr));
+            tail += hdr.size;
+        }
+        buffer.tail.store(tail, std::memory_order_release);
+        if (exited) {
+            it = traceState->buffers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (!out.empty() && traceState->sink) {
+        size_t pushed;
+        traceState->sink->PushBytes(out.data(), out.size(), pushed);
+    }
+    traceState->lock.Unlock();
+}
+
+ThreadReturn STDCALL TraceDrainer::Run(void* arg)
+{
+    QCC_UNUSED(arg);
+    while (!IsStopping()) {
+        Event::Wait(Event::neverSet, TraceRing::DRAIN_INTERVAL);
+        Drain();
+    }
+    return 0;
+}
+
+void TraceRing::Init()
+{
+    traceState = new TraceState();
+    qcc::String fileName = Environ::GetAppEnviron()->Find("ER_DEBUG_TRACEFILE");
+    if (!fileName.empty()) {
+        QCC_SetTraceFile(fileName.c_str());
+    }
+}
+
+void TraceRing::Shutdown()
+{
+    if (traceState) {
+        Stop();
+        delete traceState;
+        traceState = NULL;
+    }
+}
+
+QStatus TraceRing::Start(const qcc::String& fileName, bool useEpoch, bool printThread)
+{
+    QStatus status = ER_OK;
+
+    if (!traceState) {
+        return ER_INIT_FAILED;
+    }
+    Stop();
+
+    FileSink* sink = new FileSink(fileName, true, FileSink::PRIVATE);
+    if (!sink->IsValid()) {
+        delete sink;
+        status = ER_OPEN_FAILED;
+        QCC_LogError(status, ("Cannot open trace file %s", fileName.c_str()));
+        return status;
+    }
+    qcc::String header;
+    PushU32(header, TRACE_FILE_MARKER);
+    PushU32(header, TRACE_FILE_VERSION);
+    PushU32(header, (useEpoch ? TRACE_FLAG_EPOCH : 0) | (printThread ? TRACE_FLAG_THREAD : 0));
+    size_t pushed;
+    status = sink->PushBytes(header.data(), header.size(), pushed);
+    if (status != ER_OK) {
+        delete sink;
+        QCC_LogError(status, ("Cannot write trace file %s", fileName.c_str()));
+        return status;
+    }
+
+    TraceDrainer* drainer = new TraceDrainer();
+    traceState->lock.Lock();
+    traceState->sink = sink;
+    traceState->strings.clear();
+    traceState->drainer = drainer;
+    traceUseEpoch = useEpoch;
+    traceGeneration.fetch_add(1);
+    traceRunning.store(true, std::memory_order_release);
+    traceState->lock.Unlock();
+
+    status = drainer->Start();
+    if (status != ER_OK) {
+        QCC_LogError(status, ("Failed to start trace drainer"));
+        Stop();
+    }
+    return status;
+}
+
+void TraceRing::Stop()
+{
+    if (!traceState) {
+        return;
+    }
+    traceState->lock.Lock();
+    if (!traceRunning.load()) {
+        traceState->lock.Unlock();
+        return;
+    }
+    traceRunning.store(false);
+    TraceDrainer* drainer = traceState->drainer;
+    traceState->drainer = NULL;
+    traceState->lock.Unlock();
+
+    drainer->Stop();
+    drainer->Join();
+    delete drainer;
+
+    /*
+     * Threads that saw the trace running before it was stopped may still be
+     * adding records.  No buffers are registered once it is stopped.
+     */
+    traceState->lock.Lock();
+    vector<std::shared_ptr<TraceBuffer> > buffers = traceState->buffers;
+    traceState->lock.Unlock();
+    for (vector<std::shared_ptr<TraceBuffer> >::iterator it = buffers.begin(); it != buffers.end(); ++it) {
+        while ((*it)->writing.load()) {
+            qcc::Sleep(0);
+        }
+    }
+
+    Drain();
+
+    traceState->lock.Lock();
+    traceState->buffers.clear();
+    delete traceState->sink;
+    traceState->sink = NULL;
+    traceState->lock.Unlock();
+}
+
+bool TraceRing::IsRunning()
+{
+    return traceRunning.load(std::memory_order_relaxed);
+}
+
+bool TraceRing::Record(DbgMsgType type, const char* module, const char* filename, int lineno, const uint8_t* buf, size_t len)
+{
+    if (!traceRunning.load(std::memory_order_acquire)) {
+        return false;
+    }
+    ThreadTrace& trace = threadTrace;
+    uint32_t generation = traceGeneration.load();
+    if (!trace.buffer || (trace.generation != generation)) {
+        /* Messages logged while the buffer is being created are written directly */
+        if (trace.registering) {
+            return false;
+        }
+        trace.registering = true;
+        trace.buffer.reset();
+        const char* threadName = Thread::GetThreadName();
+        traceState->lock.Lock();
+        if (traceRunning.load() && (traceGeneration.load() == generation)) {
+            trace.buffer = std::make_shared<TraceBuffer>(traceState->nextId++, threadName);
+            traceState->buffers.push_back(trace.buffer);
+        }
+        traceState->lock.Unlock();
+        trace.generation = generation;
+        trace.registering = false;
+        if (!trace.buffer) {
+            return false;
+        }
+    }
+
+    /*
+     * Mark the buffer before checking again that the trace is running so
+     * that either Stop() waits for this record or the record is not added.
+     */
+    TraceBuffer& buffer = *trace.buffer;
+    buffer.writing.store(true);
+    if (!traceRunning.load()) {
+        buffer.writing.store(false, std::memory_order_release);
+        return false;
+    }
+
+    RecordHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.size = static_cast<uint32_t>(sizeof(hdr) + len);
+    hdr.type = static_cast<uint32_t>(type);
+    hdr.timestamp = traceUseEpoch ? GetEpochTimestamp() : GetTimestamp();
+    hdr.module = module;
+    hdr.filename = filename;
+    hdr.lineno = static_cast<uint32_t>(lineno);
+    buffer.Write(hdr, buf, len);
+    buffer.writing.store(false, std::memory_order_release);
+    return true;
+}
+
+/*
+ * Buffered reads from a trace file.
+ */
+class TraceFileReader {
+  public:
+    TraceFileReader(FileSource& source) : source(source), pos(0), status(ER_OK) { }
+
+    /*
+     * Returns ER_EOF if the file ends before any of the bytes are read and
+     * ER_INVALID_DATA if it ends part way through.
+     */
+    QStatus Read(void* dest, size_t len)
+    {
+        uint8_t* out = static_cast<uint8_t*>(dest);
+        size_t total = 0;
+        while (total < len) {
+            if (pos == buf.size()) {
+                if (status != ER_OK) {
+                    return (total == 0) ? status : ER_INVALID_DATA;
+                }
+                buf.resize(64 * 1024);
+                size_t pulled = 0;
+                status = source.PullBytes(&buf[0], buf.size(), pulled);
+                buf.resize(pulled);
+                pos = 0;
+                if ((status == ER_OK) && (pulled == 0)) {
+                    status = ER_EOF;
+                }
+                continue;
+            }
+            size_t n = std::min(len - total, buf.size() - pos);
+            memcpy(out + total, &buf[pos], n);
+            pos += n;
+            total += n;
+        }
+        return ER_OK;
+    }
+
+    QStatus ReadString(qcc::String& str)
+    {
+        uint32_t len;
+        QStatus status = Read(&len, sizeof(len));
+        if (status == ER_OK) {
+            str.resize(len);
+            status = (len == 0) ? ER_OK : Read(&str[0], len);
+        }
+        return (status == ER_EOF) ? ER_INVALID_DATA : status;
+    }
+
+  private:
+    FileSource& source;
+    vector<uint8_t> buf;
+    size_t pos;
+    QStatus status;
+};
+
+QStatus TraceRing::Decode(const qcc::String& fileName, QCC_DbgMsgCallback cb, void* context)
+{
+    FileSource source(fileName);
+    if (!source.IsValid()) {
+        return ER_OPEN_FAILED;
+    }
+    TraceFileReader reader(source);
+    uint32_t header[3];
+    QStatus status = reader.Read(header, sizeof(header));
+    if ((status != ER_OK) || (header[0] != TRACE_FILE_MARKER) || (header[1] != TRACE_FILE_VERSION)) {
+        return ER_INVALID_DATA;
+    }
+    bool useEpoch = (header[2] & TRACE_FLAG_EPOCH) != 0;
+    bool printThread = (header[2] & TRACE_FLAG_THREAD) != 0;
+
+    map<uint32_t, qcc::String> strings;
+    map<uint32_t, qcc::String> threads;
+    vector<uint8_t> segs;
+    while (true) {
+        uint8_t kind;
+        status = reader.Read(&kind, sizeof(kind));
+        if (status == ER_EOF) {
+            return ER_OK;
+        }
+        uint32_t id = 0;
+        if (status == ER_OK) {
+            status = reader.Read(&id, sizeof(id));
+        }
+        if (status != ER_OK) {
+            return ER_INVALID_DATA;
+        }
+        switch (kind) {
+        case TRACE_STRING:
+            status = reader.ReadString(strings[id]);
+            break;
+
+        case TRACE_THREAD:
+            status = reader.ReadString(threads[id]);
+            break;
+
+        case TRACE_DROPPED:
+            {
+                uint32_t count;
+                status = reader.Read(&count, sizeof(count));
+                if (status == ER_OK) {
+                    qcc::String msg("*** ");
+                    msg.append(U32ToString(count));
+                    msg.append(" trace messages from thread ");
+                    msg.append(threads[id]);
+                    msg.append(" were dropped\n");
+                    cb(DBG_HIGH_LEVEL, QCC_MODULE, msg.c_str(), context);
+                }
+            }
+            break;
+
+        case TRACE_MESSAGE:
+            {
+                uint32_t type;
+                uint64_t timestamp;
+                uint32_t fields[4];
+                status = reader.Read(&type, sizeof(type));
+                if (status == ER_OK) {
+                    status = reader.Read(&timestamp, sizeof(timestamp));
+                }
+                if (status == ER_OK) {
+                    status = reader.Read(fields, sizeof(fields));
+                }
+                if (status == ER_OK) {
+                    segs.resize(fields[3] + 1);
+                    status = reader.Read(&segs[0], fields[3]);
+                }
+                if (status != ER_OK) {
+                    break;
+                }
+                map<uint32_t, qcc::String>::const_iterator module = strings.find(fields[0]);
+                map<uint32_t, qcc::String>::const_iterator filename = strings.find(fields[1]);
+                if ((module == strings.end()) || (filename == strings.end())) {
+                    return ER_INVALID_DATA;
+                }
+                qcc::String msg;
+                DebugPrefix(msg, static_cast<DbgMsgType>(type), module->second.c_str(), filename->second.c_str(), fields[2],
+                            printThread ? threads[id].c_str() : NULL, useEpoch, timestamp);
+                size_t pos = 0;
+                while ((fields[3] - pos) >= (2 * sizeof(uint32_t))) {
+                    uint32_t fmtId;
+                    uint32_t argLen;
+                    memcpy(&fmtId, &segs[pos], sizeof(fmtId));
+                    memcpy(&argLen, &segs[pos + sizeof(fmtId)], sizeof(argLen));
+                    pos += 2 * sizeof(uint32_t);
+                    map<uint32_t, qcc::String>::const_iterator fmt = strings.find(fmtId);
+                    if ((fmt == strings.end()) || ((fields[3] - pos) < argLen)) {
+                        return ER_INVALID_DATA;
+                    }
+                    FormatSegment(msg, fmt->second.c_str(), &segs[pos], argLen);
+                    pos += argLen;
+                }
+                msg.push_back('\n');
+                cb(static_cast<DbgMsgType>(type), module->second.c_str(), msg.c_str(), context);
+            }
+            break;
+
+        default:
+            return ER_INVALID_DATA;
+        }
+        if (status != ER_OK) {
+            return ER_INVALID_DATA;
+        }
+    }
+}
+
+}
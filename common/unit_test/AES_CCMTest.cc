@@ -22,6 +22,9 @@
 
 #include <qcc/platform.h>
 
+#include <algorithm>
+#include <vector>
+
 #include <qcc/Crypto.h>
 #include <qcc/Debug.h>
 #include <qcc/KeyBlob.h>
@@ -320,3 +323,98 @@ TEST(AES_CCMTest, AES_CCM_Test_Vecter) {
     }
 }
 
+
+/*
+ * Straightforward AES-CCM built from single block encryptions, used to check the bulk CTR and
+ * CBC-MAC paths on messages that span many blocks. Only supports the 13 octet nonces AllJoyn uses.
+ */
+static void ReferenceCCM(Crypto_AES& ecb, const uint8_t* in, size_t len, const uint8_t* nonce, const uint8_t* addData, size_t addLen, uint8_t authLen, uint8_t* out)
+{
+    const uint8_t L = 2;
+    Crypto_AES::Block X(0);
+    Crypto_AES::Block B(0);
+
+    B.data[0] = (addLen ? 0x40 : 0) | (((authLen - 2) / 2) << 3) | (L - 1);
+    memcpy(&B.data[1], nonce, 13);
+    B.data[14] = (uint8_t)(len >> 8);
+    B.data[15] = (uint8_t)len;
+    ecb.Encrypt(&B, &X, 1);
+
+    std::vector<uint8_t> macData;
+    if (addLen) {
+        macData.push_back((uint8_t)(addLen >> 8));
+        macData.push_back((uint8_t)addLen);
+        macData.insert(macData.end(), addData, addData + addLen);
+        macData.resize(Crypto_AES::NumBlocks(macData.size()) * sizeof(Crypto_AES::Block), 0);
+    }
+    size_t addEnd = macData.size();
+    macData.insert(macData.end(), in, in + len);
+    macData.resize(addEnd + Crypto_AES::NumBlocks(len) * sizeof(Crypto_AES::Block), 0);
+    for (size_t i = 0; i < macData.size(); i += sizeof(Crypto_AES::Block)) {
+        for (size_t j = 0; j < sizeof(B.data); ++j) {
+            B.data[j] = X.data[j] ^ macData[i + j];
+        }
+        ecb.Encrypt(&B, &X, 1);
+    }
+
+    Crypto_AES::Block A(0);
+    Crypto_AES::Block S;
+    A.data[0] = L - 1;
+    memcpy(&A.data[1], nonce, 13);
+    for (size_t i = 0; i < Crypto_AES::NumBlocks(len) + 1; ++i) {
+        A.data[14] = (uint8_t)(i >> 8);
+        A.data[15] = (uint8_t)i;
+        ecb.Encrypt(&A, &S, 1);
+        if (i == 0) {
+            for (size_t j = 0; j < authLen; ++j) {
+                out[len + j] = X.data[j] ^ S.data[j];
+            }
+        } else {
+            size_t off = (i - 1) * sizeof(Crypto_AES::Block);
+            for (size_t j = 0; (j < sizeof(S.data)) && (off + j < len); ++j) {
+                out[off + j] = in[off + j] ^ S.data[j];
+            }
+        }
+    }
+}
+
+TEST(AES_CCMTest, AES_CCM_Long_Messages) {
+    uint8_t key[16];
+    uint8_t nonce[13];
+    uint8_t addData[37];
+    Crypto_GetRandomBytes(key, sizeof(key));
+    Crypto_GetRandomBytes(nonce, sizeof(nonce));
+    Crypto_GetRandomBytes(addData, sizeof(addData));
+
+    KeyBlob kb(key, sizeof(key), KeyBlob::AES);
+    KeyBlob nb(nonce, sizeof(nonce), KeyBlob::GENERIC);
+    Crypto_AES ccm(kb, Crypto_AES::CCM);
+    Crypto_AES ecb(kb, Crypto_AES::ECB_ENCRYPT);
+
+    const size_t lengths[] = { 0, 1, 15, 16, 17, 63, 64, 65, 100, 1000, 4099 };
+    for (size_t i = 0; i < ArraySize(lengths); ++i) {
+        size_t len = lengths[i];
+        std::vector<uint8_t> msg(len + 16);
+        std::vector<uint8_t> expected(len + 16);
+        if (len) {
+            Crypto_GetRandomBytes(&msg[0], len);
+        }
+        std::vector<uint8_t> plain(msg.begin(), msg.begin() + len);
+        ReferenceCCM(ecb, &msg[0], len, nonce, addData, sizeof(addData), 16, &expected[0]);
+
+        size_t outLen = len;
+        EXPECT_EQ(ER_OK, ccm.Encrypt_CCM(&msg[0], &msg[0], outLen, nb, addData, sizeof(addData), 16));
+        ASSERT_EQ(len + 16, outLen);
+        EXPECT_TRUE(msg == expected) << "Encrypt mismatch for length " << len;
+
+        EXPECT_EQ(ER_OK, ccm.Decrypt_CCM(&msg[0], &msg[0], outLen, nb, addData, sizeof(addData), 16));
+        ASSERT_EQ(len, outLen);
+        EXPECT_TRUE(std::equal(plain.begin(), plain.end(), msg.begin())) << "Decrypt mismatch for length " << len;
+
+        /* A corrupted authentication field must be rejected */
+        ReferenceCCM(ecb, plain.data(), len, nonce, addData, sizeof(addData), 16, &msg[0]);
+        msg[len + 15] ^= 1;
+        outLen = len + 16;
+        EXPECT_EQ(ER_AUTH_FAIL, ccm.Decrypt_CCM(&msg[0], &msg[0], outLen, nb, addData, sizeof(addData), 16));
+    }
+}
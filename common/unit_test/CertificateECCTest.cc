@@ -1713,4 +1713,51 @@ TEST_F(CertificateECCTest, InvalidASN1Test4)
     };
     String pemStr(invalidASN1);
     EXPECT_EQ(ER_FAIL, cert.LoadPEM(pemStr)) << " invalid certificate (invalid ASN.1) accepted.";
-}
\ No newline at end of file
+}
+
+/**
+ * Decode and verification results served from the certificate cache must
+ * match an uncached decode and verification.
+ */
+TEST_F(CertificateECCTest, CachedDecodeAndVerify)
+{
+    qcc::GUID128 issuer;
+    ECCPrivateKey dsaPrivateKey;
+    ECCPublicKey dsaPublicKey;
+    ECCPrivateKey subjectPrivateKey;
+    ECCPublicKey subjectPublicKey;
+    CertificateX509 x509;
+    qcc::String noOrg;
+
+    ASSERT_EQ(ER_OK, GenKeyAndCreateCert(issuer, "1010101", noOrg, &dsaPrivateKey, &dsaPublicKey, &subjectPrivateKey, &subjectPublicKey, false, 3600, x509));
+    String der;
+    ASSERT_EQ(ER_OK, x509.EncodeCertificateDER(der));
+
+    CertificateX509::ClearCache();
+    CertificateX509 uncached;
+    ASSERT_EQ(ER_OK, uncached.DecodeCertificateDER(der));
+    EXPECT_EQ(ER_OK, uncached.Verify(&dsaPublicKey));
+
+    for (int i = 0; i < 2; i++) {
+        IdentityCertificate cert;
+        ASSERT_EQ(ER_OK, cert.DecodeCertificateDER(der)) << " decode " << i;
+        EXPECT_EQ(uncached.ToString(), cert.ToString()) << " decode " << i;
+        EXPECT_EQ(uncached.GetType(), cert.GetType()) << " decode " << i;
+        EXPECT_EQ(ER_OK, cert.Verify(&dsaPublicKey)) << " verify " << i;
+        EXPECT_NE(ER_OK, cert.Verify(&subjectPublicKey)) << " verify with the wrong key " << i;
+    }
+
+    /* A certificate with a different signature is verified again */
+    String tampered = der;
+    tampered[tampered.size() - 1] ^= 1;
+    CertificateX509 bad;
+    if (ER_OK == bad.DecodeCertificateDER(tampered)) {
+        EXPECT_NE(ER_OK, bad.Verify(&dsaPublicKey));
+    }
+
+    CertificateX509::ClearCache();
+    CertificateX509 cert;
+    ASSERT_EQ(ER_OK, cert.DecodeCertificateDER(der));
+    EXPECT_EQ(ER_OK, cert.Verify(&dsaPublicKey));
+    EXPECT_NE(ER_OK, cert.Verify(&subjectPublicKey));
+}
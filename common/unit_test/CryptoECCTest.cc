@@ -20,6 +20,7 @@
 #include <qcc/Crypto.h>
 #include <qcc/CryptoECC.h>
 #include <qcc/CryptoECCMath.h>
+#include <qcc/CryptoECCp256.h>
 
 /* For ECCPublicKeyImportInitializeHandles test, which only applies to Windows CNG. */
 #ifdef CRYPTO_CNG
@@ -383,6 +384,99 @@ TEST_F(CryptoECCTest, EC_SPEKETest)
 }
 
 
+/* Random scalar in [1, 2^255), which is always less than the order of P-256. */
+static void RandomScalar(digit256_t k)
+{
+    do {
+        ASSERT_EQ(ER_OK, Crypto_GetRandomBytes((uint8_t*)k, sizeof(digit256_t)));
+        k[P256_DIGITS - 1] &= ((digit_t)-1) >> 1;
+    } while ((k[0] | k[1] | k[2] | k[3]) == 0);
+}
+
+static bool PointsEqual(const ecpoint_t& P, const ecpoint_t& Q)
+{
+    return fpequal_p256(P.x, Q.x) && fpequal_p256(P.y, Q.y);
+}
+
+TEST_F(CryptoECCTest, FixedBaseMatchesVariableBase)
+{
+    ec_t curve;
+    ecpoint_t G, Q1, Q2;
+    digit256_t k;
+
+    ASSERT_EQ(ER_OK, ec_getcurve(&curve, NISTP256r1));
+    ec_get_generator(&G, &curve);
+
+    /* Both parities of k, since even scalars take a different path. */
+    for (int i = 0; i < 64; i++) {
+        RandomScalar(k);
+        k[0] = (k[0] & ~(digit_t)1) | (digit_t)(i & 1);
+        if ((k[0] | k[1] | k[2] | k[3]) == 0) {
+            k[0] = 2;
+        }
+        ASSERT_EQ(ER_OK, ec_scalarmul(&G, k, &Q1, &curve));
+        ASSERT_EQ(ER_OK, ec_scalarmul_base(k, &Q2, &curve));
+        EXPECT_TRUE(PointsEqual(Q1, Q2)) << "Fixed-base result differs for iteration " << i;
+    }
+
+    /* The smallest and largest valid scalars. */
+    memset(k, 0, sizeof(k));
+    k[0] = 1;
+    ASSERT_EQ(ER_OK, ec_scalarmul_base(k, &Q2, &curve));
+    EXPECT_TRUE(PointsEqual(G, Q2));
+
+    fpcopy_p256(curve.order, k);
+    k[0] -= 1;
+    ASSERT_EQ(ER_OK, ec_scalarmul(&G, k, &Q1, &curve));
+    ASSERT_EQ(ER_OK, ec_scalarmul_base(k, &Q2, &curve));
+    EXPECT_TRUE(PointsEqual(Q1, Q2));
+
+    /* Zero is rejected. */
+    memset(k, 0, sizeof(k));
+    EXPECT_NE(ER_OK, ec_scalarmul_base(k, &Q2, &curve));
+
+    ec_freecurve(&curve);
+}
+
+TEST_F(CryptoECCTest, DoubleScalarMatchesSeparate)
+{
+    ec_t curve;
+    ecpoint_t G, P, kG, lP, Q;
+    digit256_t k, l, m;
+
+    ASSERT_EQ(ER_OK, ec_getcurve(&curve, NISTP256r1));
+    ec_get_generator(&G, &curve);
+
+    for (int i = 0; i < 32; i++) {
+        RandomScalar(k);
+        RandomScalar(l);
+        RandomScalar(m);
+        ASSERT_EQ(ER_OK, ec_scalarmul_base(m, &P, &curve));
+
+        ASSERT_EQ(ER_OK, ec_scalarmul(&G, k, &kG, &curve));
+        ASSERT_EQ(ER_OK, ec_scalarmul(&P, l, &lP, &curve));
+        ec_add(&kG, &lP, &curve);
+
+        ASSERT_EQ(ER_OK, ec_doublescalarmul(k, &P, l, &Q, &curve));
+        EXPECT_TRUE(PointsEqual(kG, Q)) << "Double-scalar result differs for iteration " << i;
+    }
+
+    /* k*G + (r-k)*G is the point at infinity. */
+    RandomScalar(k);
+    fpcopy_p256(curve.order, l);
+    digit_t borrow = 0;
+    for (int i = 0; i < P256_DIGITS; i++) {
+        digit_t d = l[i] - k[i] - borrow;
+        borrow = (l[i] < k[i]) || ((l[i] == k[i]) && borrow);
+        l[i] = d;
+    }
+    ASSERT_EQ(ER_OK, ec_doublescalarmul(k, &G, l, &Q, &curve));
+    EXPECT_TRUE(ec_is_infinity(&Q, &curve));
+
+    ec_freecurve(&curve);
+}
+
+
 /**
  * Test detection of invalid public keys on import.
  */
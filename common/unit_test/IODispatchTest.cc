@@ -18,6 +18,11 @@
 
 #include <qcc/Condition.h>
 #include <qcc/IODispatch.h>
+#include <qcc/Socket.h>
+#include <qcc/SocketStream.h>
+#include <qcc/Util.h>
+
+#include <set>
 
 using namespace qcc;
 
@@ -114,3 +119,131 @@ TEST_F(IODispatchStopStreamTest, WhenStreamIsStarted_Stop)
     l.WaitForExitCallback();
     l.ReturnFromExitCallback();
 }
+
+class IODispatchReadTest : public testing::Test {
+  public:
+    class Listener : public IOReadListener, public IOWriteListener, public IOExitListener {
+      public:
+        IODispatch& io;
+        Mutex mutex;
+        Condition condition;
+        std::multiset<Source*> reads;
+        int exits;
+
+        Listener(IODispatch& io) : io(io), exits(0) { }
+        virtual ~Listener() { }
+        virtual QStatus ReadCallback(Source& source, bool) {
+            char buf[8];
+            size_t actual;
+            source.PullBytes(buf, sizeof(buf), actual, 0);
+            mutex.Lock();
+            reads.insert(&source);
+            condition.Signal();
+            mutex.Unlock();
+            return ER_OK;
+        }
+        virtual QStatus WriteCallback(Sink&, bool) { return ER_OK; }
+        virtual void ExitCallback() {
+            mutex.Lock();
+            ++exits;
+            condition.Signal();
+            mutex.Unlock();
+        }
+        bool WaitForReads(size_t count) {
+            mutex.Lock();
+            while (reads.size() < count) {
+                if (condition.TimedWait(mutex, 5000) != ER_OK) {
+                    break;
+                }
+            }
+            bool done = (reads.size() >= count);
+            mutex.Unlock();
+            return done;
+        }
+        size_t ReadCount(Source* source) {
+            mutex.Lock();
+            size_t count = reads.count(source);
+            mutex.Unlock();
+            return count;
+        }
+        void WaitForExits(int count) {
+            mutex.Lock();
+            while (exits < count) {
+                condition.Wait(mutex);
+            }
+            mutex.Unlock();
+        }
+    };
+
+    IODispatch io;
+    Listener l;
+    SocketStream* streams[16];
+    SocketFd peers[16];
+
+    IODispatchReadTest() : io("IODispatchReadTest", 4), l(io) { }
+
+    virtual void SetUp() {
+        EXPECT_EQ(ER_OK, io.Start());
+        for (size_t i = 0; i < ArraySize(streams); ++i) {
+            SocketFd sockets[2];
+            EXPECT_EQ(ER_OK, SocketPair(sockets));
+            streams[i] = new SocketStream(sockets[0]);
+            peers[i] = sockets[1];
+            EXPECT_EQ(ER_OK, io.StartStream(streams[i], &l, &l, &l, true, false));
+        }
+    }
+
+    virtual void TearDown() {
+        for (size_t i = 0; i < ArraySize(streams); ++i) {
+            io.StopStream(streams[i]);
+        }
+        l.WaitForExits(ArraySize(streams));
+        for (size_t i = 0; i < ArraySize(streams); ++i) {
+            io.JoinStream(streams[i]);
+            delete streams[i];
+            Close(peers[i]);
+        }
+        io.Stop();
+        io.Join();
+    }
+
+    void Send(size_t i) {
+        size_t sent;
+        EXPECT_EQ(ER_OK, qcc::Send(peers[i], "x", 1, sent));
+    }
+};
+
+TEST_F(IODispatchReadTest, ReadCallbackIsMadeForEachReadyStream)
+{
+    for (size_t i = 0; i < ArraySize(streams); i += 2) {
+        Send(i);
+    }
+    EXPECT_TRUE(l.WaitForReads(ArraySize(streams) / 2));
+    for (size_t i = 0; i < ArraySize(streams); ++i) {
+        EXPECT_EQ((i % 2) ? 0U : 1U, l.ReadCount(streams[i]));
+    }
+}
+
+TEST_F(IODispatchReadTest, ReadCallbackIsMadeAgainOnlyOnceReenabled)
+{
+    Send(0);
+    EXPECT_TRUE(l.WaitForReads(1));
+    Send(0);
+    qcc::Sleep(100);
+    EXPECT_EQ(1U, l.ReadCount(streams[0]));
+
+    EXPECT_EQ(ER_OK, io.EnableReadCallback(streams[0]));
+    EXPECT_TRUE(l.WaitForReads(2));
+    EXPECT_EQ(2U, l.ReadCount(streams[0]));
+}
+
+TEST_F(IODispatchReadTest, NoReadCallbackWhenDisabled)
+{
+    EXPECT_EQ(ER_OK, io.DisableReadCallback(streams[1]));
+    Send(1);
+    Send(2);
+    EXPECT_TRUE(l.WaitForReads(1));
+    qcc::Sleep(100);
+    EXPECT_EQ(0U, l.ReadCount(streams[1]));
+    EXPECT_EQ(1U, l.ReadCount(streams[2]));
+}
@@ -15,10 +15,13 @@
  ******************************************************************************/
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <deque>
+#include <vector>
 
 #include <qcc/Thread.h>
 #include <qcc/Timer.h>
+#include <qcc/Util.h>
 #include <Status.h>
 
 using namespace std;
@@ -488,3 +491,161 @@ TEST(TimerTest, TestMaxAlarms) {
     ASSERT_EQ(triggeredAlarms.size(), (size_t)3);
     triggeredAlarmsLock.Unlock();
 }
+
+class OrderedAlarmListener : public AlarmListener {
+  public:
+    void AlarmTriggered(const Alarm& alarm, QStatus reason)
+    {
+        if (reason == ER_OK) {
+            lock.Lock();
+            triggered.push_back(alarm);
+            lock.Unlock();
+        }
+    }
+    Mutex lock;
+    std::vector<Alarm> triggered;
+};
+
+/*
+ * This test verifies that a timing wheel timer fires alarms on different wheel levels in order
+ * and supports removing alarms by alarm and by listener.
+ */
+TEST(TimerTest, TimingWheelFiresAlarmsInOrder) {
+    const uint32_t timeouts[] = { 300, 5, 5, 20, 0, 700, 260, 20 };
+    const size_t numAlarms = ArraySize(timeouts);
+    OrderedAlarmListener listener;
+    AlarmListener* al = &listener;
+    OrderedAlarmListener otherListener;
+    AlarmListener* otherAl = &otherListener;
+
+    Timer timer("wheelTimer", false, 1, false, 0, Timer::ALARM_TIMING_WHEEL);
+    ASSERT_EQ(ER_OK, timer.Start());
+
+    /* Alarms far enough out to sit on the upper levels and in the overflow heap */
+    uint32_t farTimeout = 60000;
+    Alarm farAlarm(farTimeout, otherAl);
+    ASSERT_EQ(ER_OK, timer.AddAlarm(farAlarm));
+    Timespec<MonotonicTime> farFuture;
+    GetTimeNow(&farFuture);
+    farFuture.seconds += 100 * 24 * 3600;
+    Alarm overflowAlarm(farFuture, otherAl);
+    ASSERT_EQ(ER_OK, timer.AddAlarm(overflowAlarm));
+
+    std::vector<Alarm> expected;
+    for (size_t i = 0; i < numAlarms; ++i) {
+        uint32_t timeout = timeouts[i];
+        Alarm alarm(timeout, al);
+        expected.push_back(alarm);
+        ASSERT_EQ(ER_OK, timer.AddAlarm(alarm));
+    }
+    uint32_t removedTimeout = 10;
+    Alarm removedAlarm(removedTimeout, al);
+    ASSERT_EQ(ER_OK, timer.AddAlarm(removedAlarm));
+    EXPECT_TRUE(timer.HasAlarm(removedAlarm));
+    EXPECT_TRUE(timer.RemoveAlarm(removedAlarm));
+    EXPECT_FALSE(timer.HasAlarm(removedAlarm));
+    std::sort(expected.begin(), expected.end());
+
+    uint64_t startTime = GetTimestamp64();
+    listener.lock.Lock();
+    while ((listener.triggered.size() < numAlarms) && (GetTimestamp64() < (startTime + 5000))) {
+        listener.lock.Unlock();
+        qcc::Sleep(10);
+        listener.lock.Lock();
+    }
+    std::vector<Alarm> triggered = listener.triggered;
+    listener.lock.Unlock();
+
+    ASSERT_EQ(numAlarms, triggered.size());
+    for (size_t i = 0; i < numAlarms; ++i) {
+        EXPECT_TRUE(triggered[i].iden(expected[i])) << "Alarm " << i << " fired out of order";
+    }
+
+    EXPECT_TRUE(timer.HasAlarm(farAlarm));
+    EXPECT_TRUE(timer.HasAlarm(overflowAlarm));
+    Alarm alarm;
+    EXPECT_TRUE(timer.RemoveAlarm(*otherAl, alarm));
+    EXPECT_TRUE(timer.RemoveAlarm(*otherAl, alarm));
+    EXPECT_FALSE(timer.RemoveAlarm(*otherAl, alarm));
+    EXPECT_FALSE(timer.HasAlarm(farAlarm));
+    EXPECT_FALSE(timer.HasAlarm(overflowAlarm));
+    EXPECT_EQ((size_t)0, otherListener.triggered.size());
+
+    ASSERT_EQ(ER_OK, timer.Stop());
+    ASSERT_EQ(ER_OK, timer.Join());
+}
+
+/*
+ * Microbenchmark comparing the alarm stores under the load a reply timer sees with many
+ * outstanding method calls: add many alarms, cancel them all and clear the alarms of one
+ * listener among them.
+ */
+TEST(TimerTest, AlarmStoreBenchmark) {
+    const uint32_t numAlarms = 50000;
+    const uint32_t numListeners = 64;
+    const Timer::AlarmStoreType types[] = { Timer::ALARM_SET, Timer::ALARM_TIMING_WHEEL };
+    const char* names[] = { "set", "timing wheel" };
+    OrderedAlarmListener listeners[numListeners];
+
+    for (size_t t = 0; t < ArraySize(types); ++t) {
+        Timer timer("benchTimer", false, 1, false, 0, types[t]);
+        ASSERT_EQ(ER_OK, timer.Start());
+
+        std::vector<Alarm> alarms;
+        alarms.reserve(numAlarms);
+        for (uint32_t i = 0; i < numAlarms; ++i) {
+            uint32_t timeout = 30000 + (i * 7919) % 30000;
+            AlarmListener* al = &listeners[i % numListeners];
+            alarms.push_back(Alarm(timeout, al));
+        }
+
+        uint64_t start = GetTimestamp64();
+        for (uint32_t i = 0; i < numAlarms; ++i) {
+            ASSERT_EQ(ER_OK, timer.AddAlarm(alarms[i]));
+        }
+        uint64_t added = GetTimestamp64();
+        for (uint32_t i = 0; i < numAlarms; ++i) {
+            ASSERT_TRUE(timer.RemoveAlarm(alarms[i], false));
+        }
+        uint64_t removed = GetTimestamp64();
+
+        for (uint32_t i = 0; i < numAlarms; ++i) {
+            ASSERT_EQ(ER_OK, timer.AddAlarm(alarms[i]));
+        }
+        uint64_t readded = GetTimestamp64();
+        timer.RemoveAlarmsWithListener(listeners[0]);
+        uint64_t cleared = GetTimestamp64();
+        EXPECT_FALSE(timer.HasAlarm(alarms[0]));
+        EXPECT_TRUE(timer.HasAlarm(alarms[numAlarms - 1]));
+
+        printf("%s: add %u alarms %" PRIu64 " ms, remove %" PRIu64 " ms, remove alarms of one listener %" PRIu64 " ms\n",
+               names[t], numAlarms, added - start, removed - added, cleared - readded);
+
+        /* Alarms months out land in the overflow store of the timing wheel */
+        timer.RemoveAlarmsWithListener(listeners[1]);
+        Timespec<MonotonicTime> now;
+        GetTimeNow(&now);
+        std::vector<Alarm> farAlarms;
+        farAlarms.reserve(numAlarms);
+        for (uint32_t i = 0; i < numAlarms; ++i) {
+            Timespec<MonotonicTime> when = now;
+            when.seconds += 100 * 24 * 3600 + (i * 7919) % 30000;
+            AlarmListener* al = &listeners[i % numListeners];
+            farAlarms.push_back(Alarm(when, al));
+        }
+        uint64_t farStart = GetTimestamp64();
+        for (uint32_t i = 0; i < numAlarms; ++i) {
+            ASSERT_EQ(ER_OK, timer.AddAlarm(farAlarms[i]));
+        }
+        uint64_t farAdded = GetTimestamp64();
+        for (uint32_t i = 0; i < numAlarms; ++i) {
+            ASSERT_TRUE(timer.RemoveAlarm(farAlarms[i], false));
+        }
+        uint64_t farRemoved = GetTimestamp64();
+        printf("%s: add %u far alarms %" PRIu64 " ms, remove %" PRIu64 " ms\n",
+               names[t], numAlarms, farAdded - farStart, farRemoved - farAdded);
+
+        ASSERT_EQ(ER_OK, timer.Stop());
+        ASSERT_EQ(ER_OK, timer.Join());
+    }
+}
@@ -0,0 +1,265 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <vector>
+
+#include <qcc/Debug.h>
+#include <qcc/FileStream.h>
+#include <qcc/Log.h>
+#include <qcc/String.h>
+#include <qcc/StringUtil.h>
+#include <qcc/Thread.h>
+#include <qcc/TraceRing.h>
+#include <qcc/Util.h>
+#include <Status.h>
+
+#define QCC_MODULE "TRACERINGTEST"
+
+using namespace qcc;
+
+static size_t Capture(uint8_t* buf, size_t size, const char* fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    size_t len = TraceRing::Capture(buf, size, fmt, ap);
+    va_end(ap);
+    return len;
+}
+
+static qcc::String CaptureAndFormat(const char* fmt, ...)
+{
+    uint8_t buf[2000];
+    va_list ap;
+    va_start(ap, fmt);
+    size_t len = TraceRing::Capture(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    qcc::String out;
+    TraceRing::Format(out, buf, len);
+    return out;
+}
+
+static qcc::String Printf(const char* fmt, ...)
+{
+    char buf[2000];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    return buf;
+}
+
+#define EXPECT_SAME_FORMAT(...) EXPECT_STREQ(Printf(__VA_ARGS__).c_str(), CaptureAndFormat(__VA_ARGS__).c_str())
+
+TEST(TraceRingTest, CaptureAndFormat)
+{
+    const char* str = "text";
+    const char* nullStr = NULL;
+    EXPECT_SAME_FORMAT("no arguments 100%%");
+    EXPECT_SAME_FORMAT("%d %i %u %x %X %o %c", -5, 7, 4000000000u, 0xbeef, 0xBEEF, 8, 'z');
+    EXPECT_SAME_FORMAT("%hd %hhu %ld %lu %lld %llx", (short)-3, (unsigned char)200, -123456789L, 123456789UL, -1234567890123LL, 0x123456789abcULL);
+    EXPECT_SAME_FORMAT("%zu %zd %jd %td", (size_t)12345, (ssize_t)-4, (intmax_t)-99, (ptrdiff_t)17);
+    EXPECT_SAME_FORMAT("%-8s|%8s|%.2s|%.*s|%*d|%-*.*s|", str, str, str, 3, str, 6, 42, 7, 2, str);
+    EXPECT_SAME_FORMAT("%s %p [%s]", nullStr, (void*)&str, "");
+    EXPECT_SAME_FORMAT("%f %.3e %g %10.4f %Lf", 3.25, 12345.678, 0.0001, -2.5, (long double)1.5);
+    EXPECT_SAME_FORMAT("%08x %+d % d %#o %#x", 0x1234, 5, 6, 8, 255);
+    EXPECT_SAME_FORMAT("%" PRIu64 " %" PRIi64, (uint64_t)18446744073709551615ULL, (int64_t)-9223372036854775807LL);
+}
+
+TEST(TraceRingTest, CaptureTruncated)
+{
+    uint8_t buf[64];
+    qcc::String longStr(200, 'x');
+
+    /* A string that does not fit is truncated and later arguments are left unformatted */
+    size_t len = Capture(buf, sizeof(buf), "%d %s %d", 1, longStr.c_str(), 2);
+    EXPECT_EQ(sizeof(buf), len);
+    qcc::String out;
+    TraceRing::Format(out, buf, len);
+    EXPECT_EQ(0u, out.find("1 xxxx"));
+    EXPECT_EQ(out.size() - 3, out.find(" %d"));
+
+    EXPECT_EQ(0u, Capture(buf, 4, "%d", 1));
+}
+
+namespace {
+
+class TraceThread : public Thread {
+  public:
+    TraceThread(const char* name, int count) : Thread(name), count(count) { }
+
+  protected:
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        for (int i = 0; i < count; ++i) {
+            QCC_LogMsg(("message %d from %s", i, GetName()));
+        }
+        return 0;
+    }
+
+  private:
+    int count;
+};
+
+/*
+ * Records messages until the trace is stopped and counts the ones recorded.
+ */
+class RecordThread : public Thread {
+  public:
+    RecordThread(const char* name) : Thread(name), recorded(0) { }
+
+    int recorded;
+
+  protected:
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        uint8_t buf[64];
+        while (true) {
+            size_t len = Capture(buf, sizeof(buf), "record %d", recorded);
+            if (!TraceRing::Record(DBG_GEN_MESSAGE, QCC_MODULE, __FILE__, __LINE__, buf, len)) {
+                break;
+            }
+            ++recorded;
+        }
+        return 0;
+    }
+};
+
+struct DecodeContext {
+    std::vector<qcc::String> msgs;
+};
+
+void CollectMessage(DbgMsgType type, const char* module, const char* msg, void* context)
+{
+    QCC_UNUSED(type);
+    if (strcmp(module, QCC_MODULE) == 0) {
+        reinterpret_cast<DecodeContext*>(context)->msgs.push_back(msg);
+    }
+}
+
+/*
+ * Counts the messages that were recorded, whether or not the ring had room
+ * for them.
+ */
+void CountMessage(DbgMsgType type, const char* module, const char* msg, void* context)
+{
+    QCC_UNUSED(type);
+    size_t& count = *reinterpret_cast<size_t*>(context);
+    if (strcmp(module, QCC_MODULE) == 0) {
+        ++count;
+    } else if (strncmp(msg, "*** ", 4) == 0) {
+        count += StringToU32(qcc::String(msg + 4).substr(0, strcspn(msg + 4, " ")));
+    }
+}
+
+}
+
+TEST(TraceRingTest, RecordAndDecode)
+{
+    const char* fileName = "trace_ring_test";
+    const int count = 100;
+
+    QCC_SetDebugLevel(QCC_MODULE, 1);
+    QCC_SetTraceFile(fileName);
+    ASSERT_TRUE(TraceRing::IsRunning());
+
+    QCC_LogMsg(("value %d name %s", 42, "abc"));
+    QCC_LogError(ER_FAIL, ("errors are not traced"));
+    TraceThread first("first", count);
+    TraceThread second("second", count);
+    ASSERT_EQ(ER_OK, first.Start());
+    ASSERT_EQ(ER_OK, second.Start());
+    first.Join();
+    second.Join();
+
+    QCC_SetTraceFile(NULL);
+    QCC_SetDebugLevel(QCC_MODULE, 0);
+    EXPECT_FALSE(TraceRing::IsRunning());
+
+    DecodeContext context;
+    ASSERT_EQ(ER_OK, TraceRing::Decode(fileName, CollectMessage, &context));
+    ASSERT_EQ(static_cast<size_t>(1 + 2 * count), context.msgs.size());
+
+    const qcc::String& msg = context.msgs[0];
+    EXPECT_NE(qcc::String::npos, msg.find(QCC_MODULE));
+    EXPECT_NE(qcc::String::npos, msg.find("TraceRingTest.cc:"));
+    EXPECT_EQ(msg.size() - 20, msg.find("| value 42 name abc\n"));
+
+    int firstCount = 0;
+    int secondCount = 0;
+    for (size_t i = 1; i < context.msgs.size(); ++i) {
+        EXPECT_EQ(qcc::String::npos, context.msgs[i].find("errors are not traced"));
+        if (context.msgs[i].find(qcc::String("| message ") + U32ToString(firstCount) + " from first\n") != qcc::String::npos) {
+            ++firstCount;
+        } else if (context.msgs[i].find(qcc::String("| message ") + U32ToString(secondCount) + " from second\n") != qcc::String::npos) {
+            ++secondCount;
+        }
+    }
+    EXPECT_EQ(count, firstCount);
+    EXPECT_EQ(count, secondCount);
+
+    EXPECT_EQ(ER_OK, DeleteFile(fileName));
+}
+
+TEST(TraceRingTest, StopKeepsRecordedMessages)
+{
+    const char* fileName = "trace_ring_test";
+    const int numThreads = 4;
+
+    for (int round = 0; round < 10; ++round) {
+        ASSERT_EQ(ER_OK, TraceRing::Start(fileName, false, false));
+        std::vector<RecordThread*> threads;
+        for (int i = 0; i < numThreads; ++i) {
+            threads.push_back(new RecordThread("recorder"));
+            ASSERT_EQ(ER_OK, threads.back()->Start());
+        }
+        qcc::Sleep(20);
+        TraceRing::Stop();
+
+        int recorded = 0;
+        for (int i = 0; i < numThreads; ++i) {
+            threads[i]->Join();
+            recorded += threads[i]->recorded;
+            delete threads[i];
+        }
+
+        /* Every message that Record() accepted is in the file or counted as dropped */
+        size_t count = 0;
+        ASSERT_EQ(ER_OK, TraceRing::Decode(fileName, CountMessage, &count));
+        EXPECT_EQ(static_cast<size_t>(recorded), count);
+        EXPECT_EQ(ER_OK, DeleteFile(fileName));
+    }
+}
+
+TEST(TraceRingTest, DecodeInvalidFile)
+{
+    const char* fileName = "trace_ring_test";
+    DecodeContext context;
+
+    EXPECT_EQ(ER_OPEN_FAILED, TraceRing::Decode(fileName, CollectMessage, &context));
+    {
+        FileSink sink(fileName);
+        size_t pushed;
+        ASSERT_EQ(ER_OK, sink.PushBytes("not a trace file", 16, pushed));
+    }
+    EXPECT_EQ(ER_INVALID_DATA, TraceRing::Decode(fileName, CollectMessage, &context));
+    EXPECT_EQ(ER_OK, DeleteFile(fileName));
+}